@@ -17,6 +17,9 @@
 #define GRAPH_UNIT_TESTS_RACKNODE          1
 #define GRAPH_UNIT_TESTS_EDITNODE          1
 #define ENGINE_UNIT_TESTS_LOOPINGMIDINODE  1
+// BEATCONNECT MODIFICATION START
+#define ENGINE_UNIT_TESTS_COMBININGNODE    1
+// BEATCONNECT MODIFICATION END
 
 // Defined in tracktion_graph
 #define GRAPH_UNIT_TESTS_PLAYHEAD          1
@@ -25,7 +28,13 @@
 #define GRAPH_UNIT_TESTS_NODEVISITING      1
 #define GRAPH_UNIT_TESTS_SAMPLECONVERSION  1
 #define GRAPH_UNIT_TESTS_CONNECTEDNODE     1
+// BEATCONNECT MODIFICATION START
+#define GRAPH_UNIT_TESTS_LOCKFREEMULTITHREADEDNODEPLAYER 1
+// BEATCONNECT MODIFICATION END
 
 #define GRAPH_UNIT_TESTS_AUDIOBUFFERPOOL   1
 #define GRAPH_UNIT_TESTS_SEMAPHORE         1
 #define GRAPH_UNIT_TESTS_ALLOCATION        1
+// BEATCONNECT MODIFICATION START
+#define GRAPH_UNIT_TESTS_SUMMINGKERNEL     1
+// BEATCONNECT MODIFICATION END
@@ -34,6 +34,17 @@ inline BenchmarkDescription createBenchmarkDescription (std::string category, st
              category, name, description };
 }
 
+/** Creates a description for a benchmark run by a UnitTest.
+    The test's name and category are used as the benchmark's category.
+*/
+inline BenchmarkDescription createBenchmarkDescription (const juce::UnitTest& ut, std::string name)
+{
+    const auto category = (ut.getName() + "/" + ut.getCategory()).toStdString();
+
+    return { std::hash<std::string>{} (name + category + name),
+             category, name, name };
+}
+
 //==============================================================================
 /** Holds the duration a benchmark took to run. */
 struct BenchmarkResult
@@ -490,6 +490,9 @@ public:
     void run()
     {
         juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+        // BEATCONNECT MODIFICATION START
+        owner.engine.getThreadPlacementPolicy().applyToCurrentThread (ThreadPlacementPolicy::ThreadRole::housekeeping, getThreadName());
+        // BEATCONNECT MODIFICATION END
 
         uint32_t lastOldFlePurge = 0;
 
@@ -532,6 +535,9 @@ public:
     void run()
     {
         juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+        // BEATCONNECT MODIFICATION START
+        owner.engine.getThreadPlacementPolicy().applyToCurrentThread (ThreadPlacementPolicy::ThreadRole::housekeeping, getThreadName());
+        // BEATCONNECT MODIFICATION END
 
         while (! threadShouldExit())
         {
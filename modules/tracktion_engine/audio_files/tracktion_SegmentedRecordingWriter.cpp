@@ -0,0 +1,344 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+juce::String RecordingSegment::getStateName (State s)
+{
+    switch (s)
+    {
+        case State::recording:  return "recording";
+        case State::encoding:   return "encoding";
+        case State::complete:   return "complete";
+        case State::failed:     return "failed";
+        default:                break;
+    }
+
+    jassertfalse;
+    return {};
+}
+
+//==============================================================================
+LocalDirectorySegmentSink::LocalDirectorySegmentSink (const juce::File& dir, const juce::String& name)
+    : directory (dir), manifestName (name)
+{
+    directory.createDirectory();
+}
+
+juce::File LocalDirectorySegmentSink::getManifestFile() const
+{
+    return directory.getChildFile (juce::File::createLegalFileName (manifestName) + ".json");
+}
+
+std::unique_ptr<juce::OutputStream> LocalDirectorySegmentSink::createOutputStream (const RecordingSegment& segment)
+{
+    auto file = directory.getChildFile (segment.fileName);
+
+    if (! file.deleteFile())
+        return {};
+
+    auto os = file.createOutputStream();
+
+    if (os == nullptr || os->failedToOpen())
+        return {};
+
+    return os;
+}
+
+void LocalDirectorySegmentSink::manifestChanged (const juce::String& manifestJSON)
+{
+    // Replace the manifest in one go so readers never see a partially written one
+    juce::TemporaryFile tempFile (getManifestFile());
+
+    if (tempFile.getFile().replaceWithText (manifestJSON, false, false, nullptr))
+        tempFile.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+SegmentedRecordingWriter::SegmentedRecordingWriter (std::unique_ptr<RecordingSegmentSink> s, juce::ThreadPool& p,
+                                                    double sr, int numChans, Options o)
+    : sink (std::move (s)), pool (p), sampleRate (sr), numChannels (std::max (1, numChans)), options (std::move (o)),
+      segmentLength (std::max (1, juce::roundToInt (options.segmentLengthSeconds * sr)))
+{
+    jassert (sink != nullptr);
+    jassert (sampleRate > 0);
+    jassert (options.bitDepth == 16 || options.bitDepth == 24);
+
+    sendManifest();
+}
+
+SegmentedRecordingWriter::~SegmentedRecordingWriter()
+{
+    finish();
+}
+
+//==============================================================================
+void SegmentedRecordingWriter::addBlock (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    jassert (startSample + numSamples <= buffer.getNumSamples());
+
+    {
+        const std::lock_guard<std::mutex> sl (stateMutex);
+
+        if (state != State::recording)
+            return;
+    }
+
+    if (buffer.getNumChannels() == 0)
+        return;
+
+    while (numSamples > 0)
+    {
+        if (currentBuffer == nullptr)
+            startNextSegment();
+
+        const int numThisTime = std::min (numSamples, segmentLength - numSamplesInCurrentBuffer);
+
+        for (int i = 0; i < numChannels; ++i)
+            currentBuffer->copyFrom (i, numSamplesInCurrentBuffer,
+                                     buffer, std::min (i, buffer.getNumChannels() - 1),
+                                     startSample, numThisTime);
+
+        numSamplesInCurrentBuffer += numThisTime;
+        totalNumSamples += numThisTime;
+        startSample += numThisTime;
+        numSamples -= numThisTime;
+
+        if (numSamplesInCurrentBuffer == segmentLength)
+            encodeCurrentSegment();
+    }
+}
+
+bool SegmentedRecordingWriter::finish()
+{
+    auto allSegmentsComplete = [this]
+    {
+        return std::all_of (segments.begin(), segments.end(),
+                            [] (auto& s) { return s.state == RecordingSegment::State::complete; });
+    };
+
+    {
+        const std::lock_guard<std::mutex> sl (stateMutex);
+
+        if (state != State::recording)
+            return state == State::finished && allSegmentsComplete();
+
+        state = State::finished;
+    }
+
+    if (currentBuffer != nullptr && numSamplesInCurrentBuffer > 0)
+        encodeCurrentSegment();
+
+    currentBuffer = nullptr;
+    waitForEncodes();
+    sendManifest();
+
+    const std::lock_guard<std::mutex> sl (stateMutex);
+    return allSegmentsComplete();
+}
+
+void SegmentedRecordingWriter::cancel()
+{
+    {
+        const std::lock_guard<std::mutex> sl (stateMutex);
+
+        if (state != State::recording)
+            return;
+
+        state = State::cancelled;
+
+        if (! segments.empty() && segments.back().state == RecordingSegment::State::recording)
+            segments.pop_back();
+    }
+
+    currentBuffer = nullptr;
+    numSamplesInCurrentBuffer = 0;
+    waitForEncodes();
+    sendManifest();
+}
+
+//==============================================================================
+std::vector<RecordingSegment> SegmentedRecordingWriter::getSegments() const
+{
+    const std::lock_guard<std::mutex> sl (stateMutex);
+    return segments;
+}
+
+juce::String SegmentedRecordingWriter::getManifest() const
+{
+    const std::lock_guard<std::mutex> sl (stateMutex);
+    return createManifest();
+}
+
+juce::String SegmentedRecordingWriter::getSegmentFileName (const juce::String& name, int index)
+{
+    return juce::File::createLegalFileName (name) + "_" + juce::String (index).paddedLeft ('0', 5) + ".flac";
+}
+
+//==============================================================================
+void SegmentedRecordingWriter::startNextSegment()
+{
+    currentBuffer = std::make_shared<juce::AudioBuffer<float>> (numChannels, segmentLength);
+    numSamplesInCurrentBuffer = 0;
+
+    {
+        const std::lock_guard<std::mutex> sl (stateMutex);
+
+        RecordingSegment segment;
+        segment.index = (int) segments.size() + 1;
+        segment.fileName = getSegmentFileName (options.name, segment.index);
+        segment.startSample = totalNumSamples;
+        segments.push_back (segment);
+    }
+
+    sendManifest();
+}
+
+void SegmentedRecordingWriter::encodeCurrentSegment()
+{
+    auto buffer = std::move (currentBuffer);
+    buffer->setSize (numChannels, numSamplesInCurrentBuffer, true, false, true);
+    int index = 0;
+
+    {
+        const std::lock_guard<std::mutex> sl (stateMutex);
+        auto& segment = segments.back();
+        segment.numSamples = numSamplesInCurrentBuffer;
+        segment.state = RecordingSegment::State::encoding;
+        index = segment.index;
+        ++numEncodesRunning;
+    }
+
+    numSamplesInCurrentBuffer = 0;
+    sendManifest();
+
+    pool.addJob ([this, index, buffer]
+                 {
+                     encodeSegment (index, *buffer);
+
+                     // Notify whilst holding the lock so the writer can't be deleted before this returns
+                     const std::lock_guard<std::mutex> sl (stateMutex);
+                     --numEncodesRunning;
+                     encodesFinished.notify_all();
+                 });
+}
+
+void SegmentedRecordingWriter::encodeSegment (int index, const juce::AudioBuffer<float>& buffer)
+{
+    RecordingSegment segment;
+
+    {
+        const std::lock_guard<std::mutex> sl (stateMutex);
+        segment = segments[(size_t) index - 1];
+    }
+
+    bool wasWritten = false;
+
+    if (auto os = sink->createOutputStream (segment))
+    {
+        juce::FlacAudioFormat flac;
+        std::unique_ptr<juce::AudioFormatWriter> writer (flac.createWriterFor (os.get(), sampleRate,
+                                                                               (unsigned int) numChannels,
+                                                                               options.bitDepth, {},
+                                                                               options.qualityOptionIndex));
+
+        if (writer != nullptr)
+        {
+            os.release();
+            wasWritten = writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+        }
+    }
+
+    if (! wasWritten)
+        TRACKTION_LOG_ERROR ("Failed to write recording segment: " + segment.fileName);
+
+    segment.state = wasWritten ? RecordingSegment::State::complete : RecordingSegment::State::failed;
+    setSegmentState (index, segment.state);
+
+    if (wasWritten)
+        sink->segmentFinished (segment);
+}
+
+void SegmentedRecordingWriter::setSegmentState (int index, RecordingSegment::State newState)
+{
+    {
+        const std::lock_guard<std::mutex> sl (stateMutex);
+        segments[(size_t) index - 1].state = newState;
+    }
+
+    sendManifest();
+}
+
+void SegmentedRecordingWriter::waitForEncodes()
+{
+    std::unique_lock<std::mutex> sl (stateMutex);
+    encodesFinished.wait (sl, [this] { return numEncodesRunning == 0; });
+}
+
+void SegmentedRecordingWriter::sendManifest()
+{
+    // Building the manifest inside this lock means the sink always gets the
+    // latest state last, even when encoders finish at the same time
+    const std::lock_guard<std::mutex> ml (manifestMutex);
+
+    juce::String manifest;
+
+    {
+        const std::lock_guard<std::mutex> sl (stateMutex);
+        manifest = createManifest();
+    }
+
+    sink->manifestChanged (manifest);
+}
+
+juce::String SegmentedRecordingWriter::createManifest() const
+{
+    auto getStateName = [this]() -> juce::String
+    {
+        switch (state)
+        {
+            case State::recording:  return "recording";
+            case State::finished:   return numEncodesRunning > 0 ? "finishing" : "finished";
+            case State::cancelled:  return "cancelled";
+            default:                break;
+        }
+
+        return {};
+    };
+
+    juce::Array<juce::var> segmentList;
+
+    for (auto& s : segments)
+    {
+        auto o = new juce::DynamicObject();
+        o->setProperty ("index", s.index);
+        o->setProperty ("file", s.fileName);
+        o->setProperty ("start", (juce::int64) s.startSample);
+        o->setProperty ("length", s.numSamples);
+        o->setProperty ("state", RecordingSegment::getStateName (s.state));
+        segmentList.add (juce::var (o));
+    }
+
+    auto manifest = new juce::DynamicObject();
+    manifest->setProperty ("version", 1);
+    manifest->setProperty ("name", options.name);
+    manifest->setProperty ("format", "flac");
+    manifest->setProperty ("sampleRate", sampleRate);
+    manifest->setProperty ("numChannels", numChannels);
+    manifest->setProperty ("bitDepth", options.bitDepth);
+    manifest->setProperty ("segmentLength", segmentLength);
+    manifest->setProperty ("state", getStateName());
+    manifest->setProperty ("segments", segmentList);
+
+    return juce::JSON::toString (juce::var (manifest));
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,202 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/** Describes one of the FLAC files written by a SegmentedRecordingWriter. */
+struct RecordingSegment
+{
+    /** The stages a segment goes through. */
+    enum class State
+    {
+        recording,      /**< Audio is still being added to the segment. */
+        encoding,       /**< The segment is full and is being encoded. */
+        complete,       /**< The file has been written and closed. */
+        failed          /**< The file couldn't be written. */
+    };
+
+    int index = 0;              /**< The segment's number, starting at 1. */
+    juce::String fileName;      /**< The name of the segment's file. */
+    SampleCount startSample = 0;/**< The position of the segment's first sample in the recording. */
+    int numSamples = 0;         /**< The number of samples in the segment. */
+    State state = State::recording;
+
+    /** Returns a name for a State, as used in the manifest. */
+    static juce::String getStateName (State);
+};
+
+//==============================================================================
+/**
+    Receives the files and manifest written by a SegmentedRecordingWriter.
+
+    Subclass this to send the segments somewhere, e.g. to upload them to object
+    storage as they're recorded.
+*/
+class RecordingSegmentSink
+{
+public:
+    virtual ~RecordingSegmentSink() = default;
+
+    /** Should return a stream to write a segment's FLAC data to, or nullptr if it
+        can't be written. This is called on one of the encoder threads.
+    */
+    virtual std::unique_ptr<juce::OutputStream> createOutputStream (const RecordingSegment&) = 0;
+
+    /** Called on an encoder thread once a segment's stream has been closed. */
+    virtual void segmentFinished (const RecordingSegment&) {}
+
+    /** Called with the JSON manifest whenever it changes.
+        These calls can come from different threads but are never concurrent and
+        always arrive in order.
+    */
+    virtual void manifestChanged (const juce::String& manifestJSON) = 0;
+};
+
+//==============================================================================
+/**
+    A RecordingSegmentSink that writes the segments and the manifest to a folder.
+*/
+class LocalDirectorySegmentSink  : public RecordingSegmentSink
+{
+public:
+    /** Creates a sink that writes to a folder, which will be created if needed.
+        The manifest is called "<manifestName>.json".
+    */
+    LocalDirectorySegmentSink (const juce::File& directory, const juce::String& manifestName);
+
+    /** Returns the folder the files are written to. */
+    const juce::File& getDirectory() const noexcept     { return directory; }
+
+    /** Returns the manifest file. */
+    juce::File getManifestFile() const;
+
+    /** @internal */
+    std::unique_ptr<juce::OutputStream> createOutputStream (const RecordingSegment&) override;
+    /** @internal */
+    void manifestChanged (const juce::String&) override;
+
+private:
+    const juce::File directory;
+    const juce::String manifestName;
+};
+
+//==============================================================================
+/**
+    Writes a recording as a sequence of self-contained FLAC files, so each one can
+    be uploaded whilst the next is still being recorded.
+
+    Audio is collected until a segment is full, then the segment is encoded on a
+    thread pool so the thread adding the audio never waits for the encoder.
+    Segments can finish encoding in any order so a JSON manifest is kept up to date
+    describing each one and its state, e.g.
+
+    @code
+    {
+      "version": 1, "name": "Take 1", "format": "flac", "sampleRate": 48000.0,
+      "numChannels": 2, "bitDepth": 24, "segmentLength": 480000, "state": "recording",
+      "segments": [ { "index": 1, "file": "Take 1_00001.flac", "start": 0,
+                      "length": 480000, "state": "complete" }, ... ]
+    }
+    @endcode
+
+    Once a segment is "complete" its file won't change again. The manifest's state
+    is "recording" until finish() is called, then "finishing" until all the
+    segments have been written and "finished" after that. If the recording is
+    cancelled it becomes "cancelled".
+*/
+class SegmentedRecordingWriter
+{
+public:
+    /** Configures the segments. */
+    struct Options
+    {
+        double segmentLengthSeconds = 10.0; /**< The length of each segment. */
+        int bitDepth = 24;                  /**< The bit depth of the FLAC files, 16 or 24. */
+        int qualityOptionIndex = 5;         /**< The FLAC compression level, 0 (fastest) to 8 (smallest). */
+        juce::String name;                  /**< The name the files and manifest start with. */
+    };
+
+    /** Creates a writer.
+        @param sink         where the segments and manifest are sent
+        @param encoderPool  the pool used to encode the segments
+    */
+    SegmentedRecordingWriter (std::unique_ptr<RecordingSegmentSink> sink, juce::ThreadPool& encoderPool,
+                              double sampleRate, int numChannels, Options);
+
+    /** Destructor. If finish() or cancel() haven't been called, this finishes the recording. */
+    ~SegmentedRecordingWriter();
+
+    //==============================================================================
+    /** Adds some audio to the recording.
+        This should only be called by one thread at a time, usually the
+        WaveInputRecordingThread.
+    */
+    void addBlock (const juce::AudioBuffer<float>&, int startSample, int numSamples);
+
+    /** Encodes the last partial segment and waits for all the segments to be written.
+        Nothing else should be adding audio when this is called.
+        @returns true if all the segments were written successfully
+    */
+    bool finish();
+
+    /** Stops the recording, discarding any audio that hasn't been encoded yet, and
+        marks the manifest as cancelled.
+    */
+    void cancel();
+
+    //==============================================================================
+    /** Returns the segments that have been started so far. */
+    std::vector<RecordingSegment> getSegments() const;
+
+    /** Returns the current manifest. */
+    juce::String getManifest() const;
+
+    /** Returns the sink the segments are being written to. */
+    RecordingSegmentSink& getSink() const noexcept      { return *sink; }
+
+    /** Returns the file name used for a segment. */
+    static juce::String getSegmentFileName (const juce::String& name, int index);
+
+private:
+    //==============================================================================
+    enum class State { recording, finished, cancelled };
+
+    std::unique_ptr<RecordingSegmentSink> sink;
+    juce::ThreadPool& pool;
+    const double sampleRate;
+    const int numChannels;
+    const Options options;
+    const int segmentLength;
+
+    std::shared_ptr<juce::AudioBuffer<float>> currentBuffer;
+    int numSamplesInCurrentBuffer = 0;
+    SampleCount totalNumSamples = 0;
+
+    mutable std::mutex stateMutex;
+    std::mutex manifestMutex;
+    std::condition_variable encodesFinished;
+    std::vector<RecordingSegment> segments;
+    State state = State::recording;
+    int numEncodesRunning = 0;
+
+    void startNextSegment();
+    void encodeCurrentSegment();
+    void encodeSegment (int index, const juce::AudioBuffer<float>&);
+    void setSegmentState (int index, RecordingSegment::State);
+    void waitForEncodes();
+    void sendManifest();
+    juce::String createManifest() const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SegmentedRecordingWriter)
+};
+
+}} // namespace tracktion { inline namespace engine
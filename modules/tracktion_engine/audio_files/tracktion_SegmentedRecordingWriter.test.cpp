@@ -0,0 +1,297 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class SegmentedRecordingWriterTests  : public juce::UnitTest
+{
+public:
+    SegmentedRecordingWriterTests()
+        : juce::UnitTest ("SegmentedRecordingWriter", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runSegmentTests();
+        runManifestTests();
+        runCancelTests();
+        runFailureTests();
+    }
+
+private:
+    static constexpr double sampleRate = 44100.0;
+    static constexpr int blockSize = 512;
+
+    /** Keeps every manifest it's sent, as well as writing to a folder. */
+    struct RecordingSink  : public LocalDirectorySegmentSink
+    {
+        using LocalDirectorySegmentSink::LocalDirectorySegmentSink;
+
+        void manifestChanged (const juce::String& manifest) override
+        {
+            LocalDirectorySegmentSink::manifestChanged (manifest);
+
+            const juce::ScopedLock sl (lock);
+            manifests.add (manifest);
+        }
+
+        juce::var getLastManifest() const
+        {
+            const juce::ScopedLock sl (lock);
+            return juce::JSON::parse (manifests.strings.getLast());
+        }
+
+        juce::CriticalSection lock;
+        juce::StringArray manifests;
+    };
+
+    static juce::AudioBuffer<float> createTestSignal (int numChannels, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, numSamples);
+        juce::Random r (42);
+
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (c, i, 0.5f * std::sin ((float) i * 0.01f * (float) (c + 1)) + 0.1f * (r.nextFloat() - 0.5f));
+
+        return buffer;
+    }
+
+    static void addInBlocks (SegmentedRecordingWriter& writer, const juce::AudioBuffer<float>& buffer,
+                             int start, int numSamples)
+    {
+        for (int i = 0; i < numSamples; i += blockSize)
+            writer.addBlock (buffer, start + i, std::min (blockSize, numSamples - i));
+    }
+
+    static juce::var getSegment (const juce::var& manifest, int index)
+    {
+        if (auto segments = manifest["segments"].getArray())
+            if (juce::isPositiveAndBelow (index, segments->size()))
+                return segments->getReference (index);
+
+        return {};
+    }
+
+    static juce::File createTempDirectory()
+    {
+        return juce::File::getSpecialLocation (juce::File::tempDirectory)
+                .getNonexistentChildFile ("SegmentedRecordingWriterTest", {}, false);
+    }
+
+    void runSegmentTests()
+    {
+        beginTest ("Segmenting");
+
+        auto dir = createTempDirectory();
+        juce::ThreadPool pool (2);
+        const int segmentLength = juce::roundToInt (sampleRate * 0.5);
+        const int numSamples = segmentLength * 5 / 2;
+        auto signal = createTestSignal (2, numSamples);
+
+        SegmentedRecordingWriter::Options options;
+        options.segmentLengthSeconds = 0.5;
+        options.name = "Take";
+
+        {
+            SegmentedRecordingWriter writer (std::make_unique<LocalDirectorySegmentSink> (dir, "Take"),
+                                             pool, sampleRate, 2, options);
+            addInBlocks (writer, signal, 0, numSamples);
+            expect (writer.finish());
+
+            auto segments = writer.getSegments();
+            expectEquals ((int) segments.size(), 3);
+
+            for (size_t i = 0; i < segments.size(); ++i)
+            {
+                expectEquals (segments[i].index, (int) i + 1);
+                expectEquals (segments[i].fileName, SegmentedRecordingWriter::getSegmentFileName ("Take", (int) i + 1));
+                expectEquals (segments[i].startSample, (SampleCount) (segmentLength * (int) i));
+                expectEquals (segments[i].numSamples, i < 2 ? segmentLength : segmentLength / 2);
+                expect (segments[i].state == RecordingSegment::State::complete);
+            }
+        }
+
+        // Each segment should be a complete FLAC file and together they should be the original audio
+        juce::FlacAudioFormat flac;
+        int position = 0;
+        float maxError = 0.0f;
+
+        for (int i = 1; i <= 3; ++i)
+        {
+            auto file = dir.getChildFile (SegmentedRecordingWriter::getSegmentFileName ("Take", i));
+            std::unique_ptr<juce::AudioFormatReader> reader (flac.createReaderFor (file.createInputStream().release(), true));
+            expect (reader != nullptr, "Segment should be readable");
+
+            if (reader == nullptr)
+                continue;
+
+            expectEquals (reader->sampleRate, sampleRate);
+            expectEquals ((int) reader->numChannels, 2);
+            expectEquals ((int) reader->bitsPerSample, 24);
+
+            juce::AudioBuffer<float> decoded (2, (int) reader->lengthInSamples);
+            reader->read (&decoded, 0, decoded.getNumSamples(), 0, true, true);
+
+            for (int c = 0; c < 2; ++c)
+                for (int j = 0; j < decoded.getNumSamples(); ++j)
+                    maxError = std::max (maxError, std::abs (decoded.getSample (c, j) - signal.getSample (c, position + j)));
+
+            position += decoded.getNumSamples();
+        }
+
+        expectEquals (position, numSamples);
+        expectLessThan (maxError, 1.0e-6f);
+
+        auto manifest = juce::JSON::parse (dir.getChildFile ("Take.json"));
+        expectEquals (manifest["state"].toString(), juce::String ("finished"));
+        expectEquals (manifest["segments"].size(), 3);
+        expectEquals ((int) manifest["segmentLength"], segmentLength);
+        expectEquals (getSegment (manifest, 2)["length"].toString(), juce::String (segmentLength / 2));
+
+        dir.deleteRecursively();
+    }
+
+    void runManifestTests()
+    {
+        beginTest ("Manifest whilst recording");
+
+        auto dir = createTempDirectory();
+        juce::ThreadPool pool (2);
+        auto signal = createTestSignal (1, juce::roundToInt (sampleRate * 3.0));
+
+        SegmentedRecordingWriter::Options options;
+        options.segmentLengthSeconds = 1.0;
+        options.name = "Mono";
+
+        auto sinkOwner = std::make_unique<RecordingSink> (dir, "Mono");
+        auto& sink = *sinkOwner;
+        SegmentedRecordingWriter writer (std::move (sinkOwner), pool, sampleRate, 1, options);
+
+        // Fill the first segment and start the second
+        addInBlocks (writer, signal, 0, juce::roundToInt (sampleRate * 1.5));
+
+        // The first segment should become available whilst the second is still recording
+        const auto timeout = juce::Time::getMillisecondCounter() + 10000;
+
+        while (getSegment (sink.getLastManifest(), 0)["state"].toString() != "complete"
+               && juce::Time::getMillisecondCounter() < timeout)
+            juce::Thread::sleep (5);
+
+        auto manifest = sink.getLastManifest();
+        expectEquals (manifest["state"].toString(), juce::String ("recording"));
+        expectEquals (getSegment (manifest, 0)["state"].toString(), juce::String ("complete"));
+        expectEquals (getSegment (manifest, 1)["state"].toString(), juce::String ("recording"));
+        expectEquals (getSegment (manifest, 1)["file"].toString(), SegmentedRecordingWriter::getSegmentFileName ("Mono", 2));
+        expect (dir.getChildFile (getSegment (manifest, 0)["file"].toString()).existsAsFile());
+
+        addInBlocks (writer, signal, juce::roundToInt (sampleRate * 1.5), juce::roundToInt (sampleRate * 1.5));
+        expect (writer.finish());
+
+        // A segment's state should never go backwards in later manifests
+        const juce::StringArray order { "recording", "encoding", "complete" };
+        std::map<int, int> lastStates;
+        bool wentBackwards = false;
+
+        for (auto& m : sink.manifests)
+        {
+            auto parsed = juce::JSON::parse (m);
+
+            for (int i = 0; i < parsed["segments"].size(); ++i)
+            {
+                const auto state = order.indexOf (getSegment (parsed, i)["state"].toString());
+                wentBackwards = wentBackwards || state < lastStates[i];
+                lastStates[i] = state;
+            }
+        }
+
+        expect (! wentBackwards);
+        expectEquals (sink.getLastManifest()["state"].toString(), juce::String ("finished"));
+        expectEquals (sink.getLastManifest()["segments"].size(), 3);
+        expectEquals (sink.getManifestFile().loadFileAsString(), sink.manifests.strings.getLast());
+
+        dir.deleteRecursively();
+    }
+
+    void runCancelTests()
+    {
+        beginTest ("Cancelling");
+
+        auto dir = createTempDirectory();
+        juce::ThreadPool pool (1);
+        auto signal = createTestSignal (2, juce::roundToInt (sampleRate * 1.5));
+
+        SegmentedRecordingWriter::Options options;
+        options.segmentLengthSeconds = 1.0;
+        options.name = "Cancelled";
+
+        SegmentedRecordingWriter writer (std::make_unique<LocalDirectorySegmentSink> (dir, "Cancelled"),
+                                         pool, sampleRate, 2, options);
+        addInBlocks (writer, signal, 0, signal.getNumSamples());
+        writer.cancel();
+
+        // The partial segment should be dropped and nothing more accepted
+        writer.addBlock (signal, 0, blockSize);
+        expectEquals ((int) writer.getSegments().size(), 1);
+        expect (! writer.finish());
+
+        auto manifest = juce::JSON::parse (dir.getChildFile ("Cancelled.json"));
+        expectEquals (manifest["state"].toString(), juce::String ("cancelled"));
+        expectEquals (manifest["segments"].size(), 1);
+
+        dir.deleteRecursively();
+    }
+
+    void runFailureTests()
+    {
+        beginTest ("Failed segments");
+
+        struct FailingSink  : public RecordingSegmentSink
+        {
+            std::unique_ptr<juce::OutputStream> createOutputStream (const RecordingSegment&) override    { return {}; }
+            void segmentFinished (const RecordingSegment&) override     { ++numFinished; }
+            void manifestChanged (const juce::String& m) override       { lastManifest = m; }
+
+            std::atomic<int> numFinished { 0 };
+            juce::String lastManifest;
+        };
+
+        juce::ThreadPool pool (1);
+        auto signal = createTestSignal (1, blockSize * 4);
+
+        SegmentedRecordingWriter::Options options;
+        options.segmentLengthSeconds = blockSize / sampleRate;
+
+        auto sinkOwner = std::make_unique<FailingSink>();
+        auto& sink = *sinkOwner;
+        SegmentedRecordingWriter writer (std::move (sinkOwner), pool, sampleRate, 1, options);
+        addInBlocks (writer, signal, 0, signal.getNumSamples());
+
+        expect (! writer.finish());
+        expectEquals (sink.numFinished.load(), 0);
+
+        for (auto& s : writer.getSegments())
+            expect (s.state == RecordingSegment::State::failed);
+
+        expectEquals (getSegment (juce::JSON::parse (sink.lastManifest), 3)["state"].toString(), juce::String ("failed"));
+    }
+};
+
+static SegmentedRecordingWriterTests segmentedRecordingWriterTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
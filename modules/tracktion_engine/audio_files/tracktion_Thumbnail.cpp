@@ -560,7 +560,10 @@ TracktionThumbnail::TracktionThumbnail (int originalSamplesPerThumbnailSample,
     : formatManagerToUse (formatManager),
       cache (cacheToUse),
       window (new CachedWindow()),
-      samplesPerThumbSample (originalSamplesPerThumbnailSample)
+      samplesPerThumbSample (originalSamplesPerThumbnailSample),
+      /*BEATCONNECT MODIFICATION START*/
+      stream (originalSamplesPerThumbnailSample)
+      /*BEATCONNECT MODIFICATION END*/
 {
 }
 
@@ -588,6 +591,10 @@ void TracktionThumbnail::clearChannelData()
     numChannels = 0;
     sampleRate = 0;
 
+    /*BEATCONNECT MODIFICATION START*/
+    stream.reset (0, 0.0);
+    /*BEATCONNECT MODIFICATION END*/
+
     sendChangeMessage();
 }
 
@@ -602,6 +609,10 @@ void TracktionThumbnail::reset (int newNumChannels, double newSampleRate,
     totalSamples = totalSamplesInSource;
 
     createChannels (1 + (int) (totalSamplesInSource / samplesPerThumbSample));
+
+    /*BEATCONNECT MODIFICATION START*/
+    stream.reset (newNumChannels, newSampleRate);
+    /*BEATCONNECT MODIFICATION END*/
 }
 
 void TracktionThumbnail::createChannels (int length)
@@ -728,6 +739,10 @@ void TracktionThumbnail::addBlock (juce::int64 startSample, const juce::AudioBuf
 {
     jassert (startSample >= 0);
 
+    /*BEATCONNECT MODIFICATION START*/
+    stream.addBlock (startSample, incoming, startOffsetInBuffer, numSamples);
+    /*BEATCONNECT MODIFICATION END*/
+
     auto firstThumbIndex = (int) (startSample / samplesPerThumbSample);
     auto lastThumbIndex  = (int) ((startSample + numSamples + (samplesPerThumbSample - 1)) / samplesPerThumbSample);
     auto numToDo = lastThumbIndex - firstThumbIndex;
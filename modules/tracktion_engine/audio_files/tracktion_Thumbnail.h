@@ -58,8 +58,16 @@ public:
                        TimeRange time, float verticalZoomFactor);
 
     /*BEATCONNECT MODIFICATION START*/
+    /** These copy the whole thumbnail under the lock each time they're called.
+        To poll a thumbnail that's being recorded, use getStream() instead.
+    */
     void getPacketDetails(float& startTime, float& endTime, int& sizeInBytes, int& numberOfThumbSamplesPerChannel);
     bool getThumbnailMinMaxValues(int8_t* minValues, int8_t* maxValues, uint32_t length);
+
+    /** Returns a stream of the levels passed to addBlock() that clients can read
+        the changes from without locking.
+    */
+    ThumbnailStream& getStream() noexcept                   { return stream; }
     /*BEATCONNECT MODIFICATION END*/
 
 private:
@@ -85,6 +93,7 @@ private:
     /*BEATCONNECT MODIFICATION START*/
     int numberOfThumbSamplesPerChannelToRead = 0;
     int startThumbSampleIndex = 0;
+    ThumbnailStream stream;
     /*BEATCONNECT MODIFICATION END*/
 
     bool setDataSource (LevelDataSource*);
@@ -0,0 +1,270 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+struct ThumbnailStream::Chunk
+{
+    Chunk (int numChannels)
+        : minValues ((size_t) (thumbSamplesPerChunk * numChannels)),
+          maxValues ((size_t) (thumbSamplesPerChunk * numChannels))
+    {
+    }
+
+    juce::HeapBlock<int8_t> minValues, maxValues;
+};
+
+//==============================================================================
+/** The data for one generation. Chunks are never moved or freed until the whole
+    generation is, so once a reader has seen a published count it can copy up to it.
+*/
+struct ThumbnailStream::Generation
+{
+    Generation (uint32_t g, int numChans, double sr)
+        : generation (g), numChannels (numChans), sampleRate (sr)
+    {
+        for (auto& c : chunks)
+            c.store (nullptr, std::memory_order_relaxed);
+    }
+
+    const uint32_t generation;
+    const int numChannels;
+    const double sampleRate;
+
+    std::atomic<Chunk*> chunks[maxNumChunks];
+    std::atomic<SampleCount> numPublished { 0 };
+    std::vector<std::unique_ptr<Chunk>> ownedChunks;
+};
+
+//==============================================================================
+/** Marks a reader as active so the generation it's using won't be freed. */
+struct ThumbnailStream::ScopedReader
+{
+    ScopedReader (const ThumbnailStream& s) noexcept
+        : stream (s)
+    {
+        ++stream.numActiveReaders;
+        generation = stream.current.load();
+    }
+
+    ~ScopedReader() noexcept
+    {
+        --stream.numActiveReaders;
+    }
+
+    const ThumbnailStream& stream;
+    const Generation* generation = nullptr;
+};
+
+//==============================================================================
+ThumbnailStream::ThumbnailStream (int spt)
+    : samplesPerThumbSample (std::max (1, spt))
+{
+    current = new Generation (nextGeneration++, 0, 0.0);
+}
+
+ThumbnailStream::~ThumbnailStream()
+{
+    jassert (numActiveReaders == 0);
+    delete current.load();
+}
+
+//==============================================================================
+ThumbnailStream::ReadResult ThumbnailStream::read (Cursor& cursor, int8_t* minValues, int8_t* maxValues,
+                                                   int maxNumThumbSamples) const noexcept
+{
+    const ScopedReader reader (*this);
+    auto& g = *reader.generation;
+
+    ReadResult result;
+    result.generation = g.generation;
+    result.numChannels = g.numChannels;
+    result.sampleRate = g.sampleRate;
+
+    if (cursor.generation != g.generation)
+    {
+        cursor = { g.generation, 0 };
+        result.wasReset = true;
+    }
+
+    const auto numPublished = g.numPublished.load (std::memory_order_acquire);
+    const auto start = juce::jlimit ((SampleCount) 0, numPublished, cursor.position);
+    const auto numToRead = (int) std::min ((SampleCount) std::max (0, maxNumThumbSamples), numPublished - start);
+
+    for (int done = 0; done < numToRead;)
+    {
+        const auto index = start + done;
+        const auto chunkIndex = (int) (index / thumbSamplesPerChunk);
+        const auto offset = (int) (index % thumbSamplesPerChunk);
+        const auto numThisTime = std::min (numToRead - done, thumbSamplesPerChunk - offset);
+        const auto numValues = (size_t) (numThisTime * g.numChannels);
+
+        // The chunk pointer was stored before the count that was acquired above
+        auto* chunk = g.chunks[chunkIndex].load (std::memory_order_relaxed);
+        jassert (chunk != nullptr);
+
+        std::memcpy (minValues + done * g.numChannels, chunk->minValues + offset * g.numChannels, numValues);
+        std::memcpy (maxValues + done * g.numChannels, chunk->maxValues + offset * g.numChannels, numValues);
+
+        done += numThisTime;
+    }
+
+    cursor.position = start + numToRead;
+    result.startIndex = start;
+    result.numThumbSamples = numToRead;
+
+    return result;
+}
+
+SampleCount ThumbnailStream::getNumAvailable (const Cursor& cursor) const noexcept
+{
+    const ScopedReader reader (*this);
+    const auto numPublished = reader.generation->numPublished.load (std::memory_order_acquire);
+
+    if (cursor.generation != reader.generation->generation)
+        return numPublished;
+
+    return numPublished - juce::jlimit ((SampleCount) 0, numPublished, cursor.position);
+}
+
+SampleCount ThumbnailStream::getNumThumbSamples() const noexcept
+{
+    const ScopedReader reader (*this);
+    return reader.generation->numPublished.load (std::memory_order_acquire);
+}
+
+uint32_t ThumbnailStream::getGeneration() const noexcept
+{
+    const ScopedReader reader (*this);
+    return reader.generation->generation;
+}
+
+int ThumbnailStream::getNumChannels() const noexcept
+{
+    const ScopedReader reader (*this);
+    return reader.generation->numChannels;
+}
+
+//==============================================================================
+void ThumbnailStream::reset (int numChannels, double sampleRate)
+{
+    const juce::ScopedLock sl (writeLock);
+
+    numChannels = std::max (0, numChannels);
+    auto* oldGeneration = current.exchange (new Generation (nextGeneration++, numChannels, sampleRate));
+    retiredGenerations.emplace_back (oldGeneration);
+
+    pendingMin.assign ((size_t) numChannels, 0.0f);
+    pendingMax.assign ((size_t) numChannels, 0.0f);
+    numSamplesInPending = 0;
+    numSamplesAdded = 0;
+    isFinished = false;
+
+    freeRetiredGenerations();
+}
+
+void ThumbnailStream::addBlock (SampleCount startSample, const juce::AudioBuffer<float>& incoming,
+                                int startOffsetInBuffer, int numSamples)
+{
+    const juce::ScopedLock sl (writeLock);
+
+    if (! retiredGenerations.empty())
+        freeRetiredGenerations();
+
+    const auto numChannels = (int) pendingMin.size();
+
+    if (isFinished || numChannels == 0 || startSample != numSamplesAdded)
+        return;
+
+    const auto numChansToRead = std::min (numChannels, incoming.getNumChannels());
+
+    for (int done = 0; done < numSamples;)
+    {
+        const auto numThisTime = std::min (numSamples - done, samplesPerThumbSample - numSamplesInPending);
+
+        for (int chan = 0; chan < numChansToRead; ++chan)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax (incoming.getReadPointer (chan, startOffsetInBuffer + done),
+                                                                     numThisTime);
+
+            if (numSamplesInPending > 0)
+                range = range.getUnionWith ({ pendingMin[(size_t) chan], pendingMax[(size_t) chan] });
+
+            pendingMin[(size_t) chan] = range.getStart();
+            pendingMax[(size_t) chan] = range.getEnd();
+        }
+
+        numSamplesInPending += numThisTime;
+        done += numThisTime;
+
+        if (numSamplesInPending == samplesPerThumbSample)
+            publishPending();
+    }
+
+    numSamplesAdded += numSamples;
+}
+
+void ThumbnailStream::finish()
+{
+    const juce::ScopedLock sl (writeLock);
+
+    if (numSamplesInPending > 0)
+        publishPending();
+
+    isFinished = true;
+}
+
+//==============================================================================
+void ThumbnailStream::publishPending()
+{
+    auto toInt8 = [] (float v) { return (int8_t) juce::jlimit (-128, 127, juce::roundToInt (v * 127.0f)); };
+
+    auto& g = *current.load (std::memory_order_relaxed);
+    const auto index = g.numPublished.load (std::memory_order_relaxed);
+    const auto chunkIndex = (int) (index / thumbSamplesPerChunk);
+
+    // If the stream is full anything more is dropped
+    if (chunkIndex < maxNumChunks)
+    {
+        auto* chunk = g.chunks[chunkIndex].load (std::memory_order_relaxed);
+
+        if (chunk == nullptr)
+        {
+            g.ownedChunks.push_back (std::make_unique<Chunk> (g.numChannels));
+            chunk = g.ownedChunks.back().get();
+            g.chunks[chunkIndex].store (chunk, std::memory_order_relaxed);
+        }
+
+        const auto offset = (int) (index % thumbSamplesPerChunk) * g.numChannels;
+
+        for (int chan = 0; chan < g.numChannels; ++chan)
+        {
+            chunk->minValues[offset + chan] = toInt8 (pendingMin[(size_t) chan]);
+            chunk->maxValues[offset + chan] = toInt8 (pendingMax[(size_t) chan]);
+        }
+
+        g.numPublished.store (index + 1, std::memory_order_release);
+    }
+
+    std::fill (pendingMin.begin(), pendingMin.end(), 0.0f);
+    std::fill (pendingMax.begin(), pendingMax.end(), 0.0f);
+    numSamplesInPending = 0;
+}
+
+void ThumbnailStream::freeRetiredGenerations()
+{
+    // The new generation is swapped in before this is checked, so if there are no
+    // readers now, any that start later can only see the new one
+    if (numActiveReaders == 0)
+        retiredGenerations.clear();
+}
+
+}} // namespace tracktion { inline namespace engine
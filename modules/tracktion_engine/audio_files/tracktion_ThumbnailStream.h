@@ -0,0 +1,132 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    An append-only stream of thumbnail min/max levels that can be read without
+    locking whilst a recording is being added to it.
+
+    This is intended for sending a growing thumbnail to remote clients. Each client
+    keeps its own Cursor and each call to read() returns only the thumb samples that
+    have been added since that cursor's last read, so polling it costs the size of
+    the change rather than the size of the whole recording.
+
+    Thumb samples are only published once all of their source samples have been
+    added, after which they never change. Calling reset() starts a new generation
+    of the stream; the next read with a cursor from an earlier generation will have
+    ReadResult::wasReset set and will start again from the beginning.
+
+    Adding and resetting are serialised by a lock but reading never locks, so any
+    number of threads can read the stream whilst the recording thread adds to it.
+*/
+class ThumbnailStream
+{
+public:
+    /** Creates an empty stream. */
+    explicit ThumbnailStream (int samplesPerThumbSample);
+
+    /** Destructor. Nothing must be reading the stream when this is called. */
+    ~ThumbnailStream();
+
+    //==============================================================================
+    /** Holds a client's position in the stream. */
+    struct Cursor
+    {
+        uint32_t generation = 0;    /**< The generation this position refers to. */
+        SampleCount position = 0;   /**< The index of the next thumb sample to read. */
+    };
+
+    /** Describes the thumb samples returned by a read(). */
+    struct ReadResult
+    {
+        uint32_t generation = 0;    /**< The generation that was read. */
+        SampleCount startIndex = 0; /**< The index of the first thumb sample returned. */
+        int numThumbSamples = 0;    /**< The number of thumb samples copied. */
+        int numChannels = 0;        /**< The number of values per thumb sample. */
+        double sampleRate = 0;      /**< The sample rate of the source. */
+        bool wasReset = false;      /**< True if the cursor was from an earlier generation. */
+    };
+
+    /** Copies the thumb samples published since the cursor's position and moves the
+        cursor on past them.
+
+        The values are interleaved by channel in the same way as
+        TracktionThumbnail::getThumbnailMinMaxValues(), so each array must have
+        space for maxNumThumbSamples * getNumChannels() values.
+        This doesn't lock or allocate so can be called from any thread.
+    */
+    ReadResult read (Cursor&, int8_t* minValues, int8_t* maxValues, int maxNumThumbSamples) const noexcept;
+
+    /** Returns the number of thumb samples that a read() with this cursor would
+        return, or the total number available if the cursor is from an earlier
+        generation.
+    */
+    SampleCount getNumAvailable (const Cursor&) const noexcept;
+
+    /** Returns the number of thumb samples published in the current generation. */
+    SampleCount getNumThumbSamples() const noexcept;
+
+    /** Returns the current generation. */
+    uint32_t getGeneration() const noexcept;
+
+    /** Returns the number of channels in the current generation. */
+    int getNumChannels() const noexcept;
+
+    /** Returns the number of source samples in each thumb sample. */
+    int getSamplesPerThumbSample() const noexcept      { return samplesPerThumbSample; }
+
+    //==============================================================================
+    /** Starts a new, empty generation of the stream. */
+    void reset (int numChannels, double sampleRate);
+
+    /** Adds some audio to the stream.
+        The blocks must follow on from each other, starting at 0 after a reset. A
+        block that doesn't is ignored.
+    */
+    void addBlock (SampleCount startSample, const juce::AudioBuffer<float>&,
+                   int startOffsetInBuffer, int numSamples);
+
+    /** Publishes the last thumb sample even if it isn't full yet.
+        Nothing more can be added until the stream is reset.
+    */
+    void finish();
+
+private:
+    //==============================================================================
+    struct Chunk;
+    struct Generation;
+    struct ScopedReader;
+
+    static constexpr int thumbSamplesPerChunk = 4096;
+    static constexpr int maxNumChunks = 1024;
+
+    const int samplesPerThumbSample;
+    std::atomic<Generation*> current { nullptr };
+    mutable std::atomic<int> numActiveReaders { 0 };
+    uint32_t nextGeneration = 1;
+
+    // Only used by the thread adding to the stream
+    juce::CriticalSection writeLock;
+    std::vector<std::unique_ptr<Generation>> retiredGenerations;
+    std::vector<float> pendingMin, pendingMax;
+    int numSamplesInPending = 0;
+    SampleCount numSamplesAdded = 0;
+    bool isFinished = false;
+
+    void publishPending();
+    void freeRetiredGenerations();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThumbnailStream)
+};
+
+}} // namespace tracktion { inline namespace engine
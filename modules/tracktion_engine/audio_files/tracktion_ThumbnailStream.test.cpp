@@ -0,0 +1,281 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class ThumbnailStreamTests  : public juce::UnitTest
+{
+public:
+    ThumbnailStreamTests()
+        : juce::UnitTest ("ThumbnailStream", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runAppendTests();
+        runCursorTests();
+        runResetTests();
+        runThreadTests();
+    }
+
+private:
+    static constexpr int samplesPerThumbSample = 64;
+
+    /** Each thumb sample of this signal is a constant level, so its expected
+        values can be worked out from its index alone.
+    */
+    static int getExpectedLevel (SampleCount thumbIndex, int channel)
+    {
+        const auto level = (int) (thumbIndex % 200) - 100;
+        return channel == 0 ? level : -level;
+    }
+
+    static juce::AudioBuffer<float> createTestSignal (SampleCount startSample, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer (2, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto thumbIndex = (startSample + i) / samplesPerThumbSample;
+
+            for (int c = 0; c < 2; ++c)
+                buffer.setSample (c, i, getExpectedLevel (thumbIndex, c) / 127.0f);
+        }
+
+        return buffer;
+    }
+
+    static void addSignal (ThumbnailStream& stream, SampleCount startSample, int numSamples)
+    {
+        stream.addBlock (startSample, createTestSignal (startSample, numSamples), 0, numSamples);
+    }
+
+    /** Reads everything available, checking it follows on from the cursor. */
+    int readAndCheck (const ThumbnailStream& stream, ThumbnailStream::Cursor& cursor)
+    {
+        const auto numAvailable = (int) stream.getNumAvailable (cursor);
+        std::vector<int8_t> mins ((size_t) std::max (1, numAvailable * 2)), maxs (mins.size());
+
+        const auto previousPosition = cursor.position;
+        const auto result = stream.read (cursor, mins.data(), maxs.data(), numAvailable);
+
+        expect (result.wasReset || result.startIndex == previousPosition);
+        expectEquals (result.numThumbSamples, numAvailable);
+        expectEquals (cursor.position, result.startIndex + result.numThumbSamples);
+
+        int numWrong = 0;
+
+        for (int i = 0; i < result.numThumbSamples; ++i)
+            for (int c = 0; c < result.numChannels; ++c)
+                if (mins[(size_t) (i * 2 + c)] != getExpectedLevel (result.startIndex + i, c)
+                     || maxs[(size_t) (i * 2 + c)] != getExpectedLevel (result.startIndex + i, c))
+                    ++numWrong;
+
+        expectEquals (numWrong, 0);
+        return result.numThumbSamples;
+    }
+
+    void runAppendTests()
+    {
+        beginTest ("Appending");
+
+        ThumbnailStream stream (samplesPerThumbSample);
+        stream.reset (2, 44100.0);
+        ThumbnailStream::Cursor cursor;
+
+        // Blocks that don't line up with the thumb samples
+        SampleCount position = 0;
+
+        for (int blockSize : { 10, 100, 54, 300, 1, 63 })
+        {
+            addSignal (stream, position, blockSize);
+            position += blockSize;
+
+            expectEquals (stream.getNumThumbSamples(), position / samplesPerThumbSample);
+        }
+
+        expectEquals (readAndCheck (stream, cursor), 8);
+        expectEquals (readAndCheck (stream, cursor), 0);
+
+        // Partial thumb samples are only published when finished
+        addSignal (stream, position, 20);
+        position += 20;
+        expectEquals (stream.getNumAvailable (cursor), (SampleCount) 0);
+
+        stream.finish();
+        expectEquals (readAndCheck (stream, cursor), 1);
+
+        addSignal (stream, position, 1000);
+        expectEquals (stream.getNumThumbSamples(), (SampleCount) 9);
+
+        beginTest ("Non-contiguous blocks");
+
+        stream.reset (2, 44100.0);
+        addSignal (stream, 100, samplesPerThumbSample);
+        expectEquals (stream.getNumThumbSamples(), (SampleCount) 0);
+
+        addSignal (stream, 0, samplesPerThumbSample);
+        expectEquals (stream.getNumThumbSamples(), (SampleCount) 1);
+    }
+
+    void runCursorTests()
+    {
+        beginTest ("Multiple cursors");
+
+        ThumbnailStream stream (samplesPerThumbSample);
+        stream.reset (2, 48000.0);
+
+        ThumbnailStream::Cursor fastCursor, slowCursor;
+        int numFast = 0, numSlow = 0;
+        SampleCount position = 0;
+
+        // Enough to cross several chunks
+        for (int i = 0; i < 200; ++i)
+        {
+            addSignal (stream, position, 3000);
+            position += 3000;
+
+            numFast += readAndCheck (stream, fastCursor);
+
+            if (i % 7 == 0)
+                numSlow += readAndCheck (stream, slowCursor);
+        }
+
+        numSlow += readAndCheck (stream, slowCursor);
+
+        const auto total = (int) (position / samplesPerThumbSample);
+        expectEquals (numFast, total);
+        expectEquals (numSlow, total);
+        expectEquals (fastCursor.position, slowCursor.position);
+
+        // Reads can be limited and picked up again
+        ThumbnailStream::Cursor limitedCursor;
+        std::vector<int8_t> mins (2000), maxs (2000);
+        int numLimited = 0;
+
+        for (;;)
+        {
+            auto result = stream.read (limitedCursor, mins.data(), maxs.data(), 1000);
+
+            if (result.numThumbSamples == 0)
+                break;
+
+            expectEquals (result.startIndex, (SampleCount) numLimited);
+            expectEquals (maxs[0], (int8_t) getExpectedLevel (result.startIndex, 0));
+            numLimited += result.numThumbSamples;
+        }
+
+        expectEquals (numLimited, total);
+    }
+
+    void runResetTests()
+    {
+        beginTest ("Reset");
+
+        ThumbnailStream stream (samplesPerThumbSample);
+        stream.reset (2, 44100.0);
+        addSignal (stream, 0, samplesPerThumbSample * 10);
+
+        ThumbnailStream::Cursor cursor;
+        std::vector<int8_t> mins (64), maxs (64);
+        auto result = stream.read (cursor, mins.data(), maxs.data(), 32);
+        expect (result.wasReset, "A new cursor should start from the beginning");
+        expectEquals (result.numThumbSamples, 10);
+
+        const auto firstGeneration = cursor.generation;
+        stream.reset (1, 48000.0);
+        addSignal (stream, 0, samplesPerThumbSample * 3);
+
+        expectEquals (stream.getNumAvailable (cursor), (SampleCount) 3);
+        result = stream.read (cursor, mins.data(), maxs.data(), 32);
+        expect (result.wasReset);
+        expect (cursor.generation != firstGeneration);
+        expectEquals (result.startIndex, (SampleCount) 0);
+        expectEquals (result.numThumbSamples, 3);
+        expectEquals (result.numChannels, 1);
+        expectEquals (result.sampleRate, 48000.0);
+
+        result = stream.read (cursor, mins.data(), maxs.data(), 32);
+        expect (! result.wasReset);
+        expectEquals (result.numThumbSamples, 0);
+    }
+
+    void runThreadTests()
+    {
+        beginTest ("Reading whilst recording");
+
+        ThumbnailStream stream (samplesPerThumbSample);
+        stream.reset (2, 44100.0);
+
+        const int numThumbSamples = 20000;
+        std::atomic<bool> finished { false };
+        std::atomic<int> numErrors { 0 };
+
+        auto readerFunction = [&]
+        {
+            ThumbnailStream::Cursor cursor;
+            std::vector<int8_t> mins (512), maxs (512);
+            SampleCount expectedPosition = 0;
+
+            for (;;)
+            {
+                const bool wasFinished = finished;
+                const auto result = stream.read (cursor, mins.data(), maxs.data(), 256);
+
+                if (result.startIndex != expectedPosition && ! result.wasReset)
+                    ++numErrors;
+
+                for (int i = 0; i < result.numThumbSamples; ++i)
+                    for (int c = 0; c < 2; ++c)
+                        if (mins[(size_t) (i * 2 + c)] != getExpectedLevel (result.startIndex + i, c))
+                            ++numErrors;
+
+                expectedPosition = cursor.position;
+
+                if (wasFinished && result.numThumbSamples == 0)
+                    break;
+            }
+
+            if (expectedPosition != numThumbSamples)
+                ++numErrors;
+        };
+
+        std::vector<std::thread> readers;
+
+        for (int i = 0; i < 3; ++i)
+            readers.emplace_back (readerFunction);
+
+        for (SampleCount position = 0; position < numThumbSamples * samplesPerThumbSample; position += 500)
+        {
+            const auto numSamples = (int) std::min ((SampleCount) 500, numThumbSamples * samplesPerThumbSample - position);
+            addSignal (stream, position, numSamples);
+        }
+
+        finished = true;
+
+        for (auto& t : readers)
+            t.join();
+
+        expectEquals (numErrors.load(), 0);
+        expectEquals (stream.getNumThumbSamples(), (SampleCount) numThumbSamples);
+    }
+};
+
+static ThumbnailStreamTests thumbnailStreamTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
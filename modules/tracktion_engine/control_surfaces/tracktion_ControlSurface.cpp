@@ -39,12 +39,24 @@ void MarkerSetting::clear() noexcept
 ControlSurface::ControlSurface (ExternalControllerManager& ecm)
     : engine (ecm.engine), externalControllerManager (ecm)
 {
+    // BEATCONNECT MODIFICATION START
+    outputQueue = std::make_unique<ControlSurfaceOutputQueue> ([this] (int idx, const juce::MidiBuffer& buffer)
+                                                               {
+                                                                   if (owner != nullptr)
+                                                                       if (auto dev = owner->outputDevices[idx])
+                                                                           dev->fireMessages (buffer);
+                                                               });
+    // BEATCONNECT MODIFICATION END
 }
 
 ControlSurface::~ControlSurface()
 {
     jassert (owner != nullptr);
 
+    // BEATCONNECT MODIFICATION START
+    outputQueue.reset();
+    // BEATCONNECT MODIFICATION END
+
     notifyListenersOfDeletion();
 }
 
@@ -68,9 +80,10 @@ void ControlSurface::sendMidiCommandToController (int idx, const void* midiData,
 
 void ControlSurface::sendMidiCommandToController (int idx, const juce::MidiMessage& m)
 {
-    if (owner != nullptr)
-        if (auto dev = owner->outputDevices[idx])
-            dev->fireMessage (m);
+    // BEATCONNECT MODIFICATION START
+    if (owner != nullptr && owner->outputDevices[idx] != nullptr)
+        outputQueue->addMessage (idx, m);
+    // BEATCONNECT MODIFICATION END
 }
 
 bool ControlSurface::isSafeRecording() const
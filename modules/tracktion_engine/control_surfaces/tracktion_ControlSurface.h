@@ -218,6 +218,12 @@ public:
     template <size_t size>
     void sendMidiArray (int idx, const uint8_t (&rawData)[size])   { sendMidiCommandToController (idx, rawData, (int) size); }
 
+    // BEATCONNECT MODIFICATION START
+    // Messages sent to the device are batched and coalesced by this queue. Use it to
+    // change the rate limits, disable batching or flush the messages straight away.
+    ControlSurfaceOutputQueue& getOutputQueue() noexcept            { return *outputQueue; }
+    // BEATCONNECT MODIFICATION END
+
     // tells tracktion that the user has moved a fader.
     // the channel number is the physical channel on the device, regardless of bank selection
     // range 0 to 1.0 or -1.0 to 1.0
@@ -404,6 +410,10 @@ public:
     ExternalController* owner = nullptr;
 
 private:
+    // BEATCONNECT MODIFICATION START
+    std::unique_ptr<ControlSurfaceOutputQueue> outputQueue;
+    // BEATCONNECT MODIFICATION END
+
     enum ControlType
     {
         ctrlFader,
@@ -0,0 +1,264 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+ControlSurfaceOutputQueue::ControlSurfaceOutputQueue (Sink s)
+    : sink (std::move (s))
+{
+    jassert (sink);
+}
+
+ControlSurfaceOutputQueue::~ControlSurfaceOutputQueue()
+{
+    stopTimer();
+    flush();
+}
+
+void ControlSurfaceOutputQueue::setOptions (const Options& newOptions)
+{
+    const juce::ScopedLock sl (lock);
+    options = newOptions;
+
+    if (isTimerRunning())
+        startTimer (std::max (1, juce::roundToInt (options.frameIntervalMs)));
+}
+
+ControlSurfaceOutputQueue::Options ControlSurfaceOutputQueue::getOptions() const
+{
+    const juce::ScopedLock sl (lock);
+    return options;
+}
+
+void ControlSurfaceOutputQueue::setBatchingEnabled (bool shouldBatch)
+{
+    if (batchingEnabled.exchange (shouldBatch) && ! shouldBatch)
+        flush();
+}
+
+//==============================================================================
+void ControlSurfaceOutputQueue::addMessage (int deviceIndex, const juce::MidiMessage& m)
+{
+    if (! isBatchingEnabled())
+    {
+        {
+            const juce::ScopedLock sl (lock);
+            ++stats.numMessagesAdded;
+        }
+
+        juce::MidiBuffer buffer;
+        buffer.addEvent (m, 0);
+        sendBlock (deviceIndex, buffer);
+        return;
+    }
+
+    const auto key = getCoalescingKey (m);
+    bool needsTimer = false;
+
+    {
+        const juce::ScopedLock sl (lock);
+        ++stats.numMessagesAdded;
+
+        auto& device = devices[deviceIndex];
+
+        if (key != 0)
+        {
+            auto found = device.liveEntries.find (key);
+
+            if (found != device.liveEntries.end())
+            {
+                device.entries[found->second].isLive = false;
+                device.liveEntries.erase (found);
+                --device.numLiveEntries;
+                ++stats.numMessagesCoalesced;
+            }
+
+            device.liveEntries[key] = device.entries.size();
+        }
+
+        device.entries.push_back ({ m, key, getControlType (m), true });
+        ++device.numLiveEntries;
+        needsTimer = ! isTimerRunning();
+    }
+
+    if (needsTimer)
+        startTimer (std::max (1, juce::roundToInt (getOptions().frameIntervalMs)));
+}
+
+void ControlSurfaceOutputQueue::flush()
+{
+    sendFrame (juce::Time::getMillisecondCounterHiRes(), true);
+}
+
+void ControlSurfaceOutputQueue::processFrame (double timeNowMs)
+{
+    sendFrame (timeNowMs, false);
+}
+
+ControlSurfaceOutputQueue::Stats ControlSurfaceOutputQueue::getStats() const
+{
+    const juce::ScopedLock sl (lock);
+    return stats;
+}
+
+void ControlSurfaceOutputQueue::resetStats()
+{
+    const juce::ScopedLock sl (lock);
+    stats = {};
+}
+
+//==============================================================================
+ControlSurfaceOutputQueue::ControlType ControlSurfaceOutputQueue::getControlType (const juce::MidiMessage& m) noexcept
+{
+    if (m.isSysEx())
+        return ControlType::display;
+
+    switch (m.getRawData()[0] & 0xf0)
+    {
+        case 0x80:
+        case 0x90:  return ControlType::button;
+        case 0xa0:
+        case 0xb0:
+        case 0xe0:  return ControlType::continuous;
+        case 0xd0:  return ControlType::meter;
+        default:    return ControlType::other;
+    }
+}
+
+uint32_t ControlSurfaceOutputQueue::getCoalescingKey (const juce::MidiMessage& m) noexcept
+{
+    if (m.isSysEx() || m.getRawDataSize() < 2)
+        return 0;
+
+    auto data = m.getRawData();
+    const auto status = (uint32_t) data[0];
+    auto makeKey = [] (uint32_t s, uint32_t d) { return 0x10000u | (s << 8) | d; };
+
+    switch (status & 0xf0)
+    {
+        case 0x80:
+        case 0x90:  return makeKey (0x90 | (status & 0x0f), data[1]);   // Note-offs replace note-ons
+        case 0xa0:
+        case 0xb0:  return makeKey (status, data[1]);
+        case 0xd0:  return makeKey (status, (uint32_t) data[1] >> 4);   // Mackie meters put the strip in the top nibble
+        case 0xe0:  return makeKey (status, 0);
+        default:    return 0;
+    }
+}
+
+//==============================================================================
+ControlSurfaceOutputQueue::ScopedUnbatchedOutput::ScopedUnbatchedOutput (ControlSurfaceOutputQueue& q)
+    : queue (q), wasBatching (q.isBatchingEnabled())
+{
+    queue.setBatchingEnabled (false);
+}
+
+ControlSurfaceOutputQueue::ScopedUnbatchedOutput::~ScopedUnbatchedOutput()
+{
+    queue.setBatchingEnabled (wasBatching);
+}
+
+//==============================================================================
+void ControlSurfaceOutputQueue::sendFrame (double timeNowMs, bool ignoreRateLimits)
+{
+    std::vector<std::pair<int, juce::MidiBuffer>> blocks;
+    bool anyWaiting = false;
+
+    {
+        const juce::ScopedLock sl (lock);
+
+        for (auto& [deviceIndex, device] : devices)
+        {
+            if (device.numLiveEntries == 0)
+                continue;
+
+            bool canSend[numControlTypes];
+
+            for (int i = 0; i < numControlTypes; ++i)
+                canSend[i] = ignoreRateLimits || timeNowMs - device.lastFrameTimeMs[i] >= options.minIntervalMs[i];
+
+            juce::MidiBuffer buffer;
+            bool sentType[numControlTypes] = {};
+            std::vector<Entry> waiting;
+
+            for (auto& e : device.entries)
+            {
+                if (! e.isLive)
+                    continue;
+
+                const auto typeIndex = (size_t) e.type;
+
+                if (canSend[typeIndex])
+                {
+                    buffer.addEvent (e.message, 0);
+                    sentType[typeIndex] = true;
+                    ++stats.numMessagesSent;
+                    stats.numBytesSent += (uint64_t) e.message.getRawDataSize();
+                }
+                else
+                {
+                    waiting.push_back (std::move (e));
+                }
+            }
+
+            for (int i = 0; i < numControlTypes; ++i)
+                if (sentType[i])
+                    device.lastFrameTimeMs[i] = timeNowMs;
+
+            // Anything held back by its rate limit is kept in order for the next frame
+            device.entries = std::move (waiting);
+            device.liveEntries.clear();
+            device.numLiveEntries = (int) device.entries.size();
+
+            for (size_t i = 0; i < device.entries.size(); ++i)
+                if (device.entries[i].key != 0)
+                    device.liveEntries[device.entries[i].key] = i;
+
+            anyWaiting = anyWaiting || device.numLiveEntries > 0;
+
+            if (! buffer.isEmpty())
+            {
+                ++stats.numBatchesSent;
+                blocks.emplace_back (deviceIndex, std::move (buffer));
+            }
+        }
+    }
+
+    for (auto& [deviceIndex, buffer] : blocks)
+        sink (deviceIndex, buffer);
+
+    if (! anyWaiting && ! ignoreRateLimits)
+        stopTimer();
+}
+
+void ControlSurfaceOutputQueue::sendBlock (int deviceIndex, const juce::MidiBuffer& buffer)
+{
+    {
+        const juce::ScopedLock sl (lock);
+
+        for (auto m : buffer)
+        {
+            ++stats.numMessagesSent;
+            stats.numBytesSent += (uint64_t) m.numBytes;
+        }
+
+        ++stats.numBatchesSent;
+    }
+
+    sink (deviceIndex, buffer);
+}
+
+void ControlSurfaceOutputQueue::timerCallback()
+{
+    processFrame (juce::Time::getMillisecondCounterHiRes());
+}
+
+}} // namespace tracktion { inline namespace engine
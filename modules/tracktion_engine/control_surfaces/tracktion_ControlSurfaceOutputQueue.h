@@ -0,0 +1,164 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    Collects the MIDI a ControlSurface sends to its devices and sends it in
+    batches, once per frame.
+
+    Whilst a message is waiting to be sent, any newer message that sets the same
+    control (e.g. the same CC, note or meter) replaces it, so a fader or meter that
+    moves several times in a frame only sends its last value. Each type of control
+    can also be given a minimum interval between frames so things like meters and
+    displays can't flood a slow MIDI port.
+
+    Messages for each device are sent in the order their controls were last
+    changed, which means the device always ends up in the latest state. Surfaces
+    that rely on sequences of controllers, like NRPNs, should disable batching.
+*/
+class ControlSurfaceOutputQueue  : private juce::Timer
+{
+public:
+    //==============================================================================
+    /** The types of control the rate limits are applied to. */
+    enum class ControlType
+    {
+        button,         /**< Note on/off messages, usually lights. */
+        continuous,     /**< Controllers and pitch-bend, e.g. motor faders, pots and timecode digits. */
+        meter,          /**< Channel pressure, used by Mackie devices for the level meters. */
+        display,        /**< SysEx, used for displays and device settings. */
+        other           /**< Anything else, which is never coalesced. */
+    };
+
+    static constexpr int numControlTypes = 5;
+
+    /** How often the queue sends frames and the minimum intervals for each type of control. */
+    struct Options
+    {
+        double frameIntervalMs = 10.0;
+        double minIntervalMs[numControlTypes] = { 0.0, 10.0, 40.0, 20.0, 0.0 };
+    };
+
+    /** Some statistics about the messages that have been through the queue. */
+    struct Stats
+    {
+        uint64_t numMessagesAdded = 0;      /**< The number of messages the surface has sent. */
+        uint64_t numMessagesSent = 0;       /**< The number of messages sent to the devices. */
+        uint64_t numMessagesCoalesced = 0;  /**< The number of messages replaced by newer ones. */
+        uint64_t numBatchesSent = 0;        /**< The number of blocks sent to the devices. */
+        uint64_t numBytesSent = 0;          /**< The total size of the messages sent. */
+    };
+
+    /** Called to send a block of messages to one of the surface's devices. */
+    using Sink = std::function<void (int deviceIndex, const juce::MidiBuffer&)>;
+
+    //==============================================================================
+    /** Creates a queue that sends its messages to a Sink. */
+    ControlSurfaceOutputQueue (Sink);
+
+    /** Destructor. Any waiting messages are sent first. */
+    ~ControlSurfaceOutputQueue() override;
+
+    /** Changes the frame rate and the rate limits. */
+    void setOptions (const Options&);
+
+    /** Returns the current frame rate and rate limits. */
+    Options getOptions() const;
+
+    /** Enables or disables batching.
+        When disabled, any waiting messages are sent and new ones are sent straight away.
+    */
+    void setBatchingEnabled (bool);
+
+    /** Returns true if messages are being batched. */
+    bool isBatchingEnabled() const noexcept             { return batchingEnabled.load (std::memory_order_relaxed); }
+
+    //==============================================================================
+    /** Queues a message for one of the devices. This can be called from any thread. */
+    void addMessage (int deviceIndex, const juce::MidiMessage&);
+
+    /** Sends all the waiting messages now, ignoring the rate limits. */
+    void flush();
+
+    /** Sends any waiting messages whose rate limits have passed, given the current
+        time in milliseconds. This is called by the queue's timer but can also be
+        called directly, e.g. to run the queue on a simulated clock.
+    */
+    void processFrame (double timeNowMs);
+
+    /** Returns the statistics since the queue was created or the stats were reset. */
+    Stats getStats() const;
+
+    /** Resets the statistics. */
+    void resetStats();
+
+    //==============================================================================
+    /** Returns the type of control a message changes. */
+    static ControlType getControlType (const juce::MidiMessage&) noexcept;
+
+    /** Returns a key identifying the control a message changes so newer messages
+        can replace older ones, or 0 if the message should never be replaced.
+    */
+    static uint32_t getCoalescingKey (const juce::MidiMessage&) noexcept;
+
+    //==============================================================================
+    /** Sends messages straight away whilst it's in scope, e.g. whilst a surface
+        initialises its device and may need to pause between messages.
+    */
+    struct ScopedUnbatchedOutput
+    {
+        ScopedUnbatchedOutput (ControlSurfaceOutputQueue&);
+        ~ScopedUnbatchedOutput();
+
+        ControlSurfaceOutputQueue& queue;
+        const bool wasBatching;
+    };
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        juce::MidiMessage message;
+        uint32_t key = 0;
+        ControlType type = ControlType::other;
+        bool isLive = true;
+    };
+
+    struct DeviceQueue
+    {
+        DeviceQueue()
+        {
+            std::fill (std::begin (lastFrameTimeMs), std::end (lastFrameTimeMs), std::numeric_limits<double>::lowest());
+        }
+
+        std::vector<Entry> entries;
+        std::unordered_map<uint32_t, size_t> liveEntries;
+        double lastFrameTimeMs[numControlTypes];
+        int numLiveEntries = 0;
+    };
+
+    Sink sink;
+    Options options;
+    std::map<int, DeviceQueue> devices;
+    Stats stats;
+    std::atomic<bool> batchingEnabled { true };
+    juce::CriticalSection lock;
+
+    void sendFrame (double timeNowMs, bool ignoreRateLimits);
+    void sendBlock (int deviceIndex, const juce::MidiBuffer&);
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ControlSurfaceOutputQueue)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,352 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
+
+namespace tracktion { inline namespace engine
+{
+
+#if TRACKTION_UNIT_TESTS
+
+//==============================================================================
+//==============================================================================
+class ControlSurfaceOutputQueueTests  : public juce::UnitTest
+{
+public:
+    ControlSurfaceOutputQueueTests()
+        : juce::UnitTest ("ControlSurfaceOutputQueue", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runCoalescingTests();
+        runRateLimitTests();
+        runUnbatchedTests();
+    }
+
+private:
+    struct Sent
+    {
+        int device;
+        juce::MidiMessage message;
+    };
+
+    struct TestQueue
+    {
+        TestQueue()
+        {
+            // Frames are run by hand so the timer shouldn't get a chance
+            auto options = queue.getOptions();
+            options.frameIntervalMs = 100000.0;
+            queue.setOptions (options);
+        }
+
+        std::vector<Sent> sent;
+        int numBlocks = 0;
+        ControlSurfaceOutputQueue queue { [this] (int device, const juce::MidiBuffer& buffer)
+                                          {
+                                              ++numBlocks;
+
+                                              for (auto m : buffer)
+                                                  sent.push_back ({ device, m.getMessage() });
+                                          } };
+    };
+
+    static juce::MidiMessage sysEx (uint8_t value)
+    {
+        const uint8_t data[] = { 0x00, 0x00, 0x66, 0x14, 0x12, value };
+        return juce::MidiMessage::createSysExMessage (data, (int) sizeof (data));
+    }
+
+    void runCoalescingTests()
+    {
+        beginTest ("Coalescing");
+
+        TestQueue t;
+
+        for (int i = 0; i < 100; ++i)
+        {
+            t.queue.addMessage (0, juce::MidiMessage::controllerEvent (1, 7, i));
+            t.queue.addMessage (0, juce::MidiMessage::pitchWheel (1, i * 100));
+        }
+
+        t.queue.processFrame (0.0);
+        expectEquals ((int) t.sent.size(), 2);
+        expectEquals (t.sent[0].message.getControllerValue(), 99);
+        expectEquals (t.sent[1].message.getPitchWheelValue(), 9900);
+        expectEquals (t.numBlocks, 1, "Each frame should be sent as one block");
+
+        auto stats = t.queue.getStats();
+        expectEquals ((int) stats.numMessagesAdded, 200);
+        expectEquals ((int) stats.numMessagesSent, 2);
+        expectEquals ((int) stats.numMessagesCoalesced, 198);
+
+        // Messages are sent in the order their controls last changed
+        t.sent.clear();
+        t.queue.addMessage (0, juce::MidiMessage::noteOn (1, 60, (uint8_t) 127));
+        t.queue.addMessage (0, juce::MidiMessage::controllerEvent (1, 10, 64));
+        t.queue.addMessage (0, juce::MidiMessage::noteOff (1, 60));
+        t.queue.addMessage (0, sysEx (1));
+        t.queue.addMessage (0, sysEx (1));
+        t.queue.processFrame (1000.0);
+
+        expectEquals ((int) t.sent.size(), 4);
+        expect (t.sent[0].message.isController());
+        expect (t.sent[1].message.isNoteOff());
+        expect (t.sent[2].message.isSysEx() && t.sent[3].message.isSysEx(), "SysEx should never be coalesced");
+
+        // Mackie meters for different strips are separate controls
+        t.sent.clear();
+
+        for (int strip = 0; strip < 8; ++strip)
+            for (int level = 0; level < 12; ++level)
+                t.queue.addMessage (0, juce::MidiMessage::channelPressureChange (1, (strip << 4) | level));
+
+        t.queue.processFrame (2000.0);
+        expectEquals ((int) t.sent.size(), 8);
+
+        for (int strip = 0; strip < 8; ++strip)
+            expectEquals (t.sent[(size_t) strip].message.getChannelPressureValue(), (strip << 4) | 11);
+
+        // Each device has its own queue
+        t.sent.clear();
+        t.queue.addMessage (0, juce::MidiMessage::controllerEvent (1, 7, 1));
+        t.queue.addMessage (1, juce::MidiMessage::controllerEvent (1, 7, 2));
+        t.queue.processFrame (3000.0);
+        expectEquals ((int) t.sent.size(), 2);
+        expect (t.sent[0].device != t.sent[1].device);
+    }
+
+    void runRateLimitTests()
+    {
+        beginTest ("Rate limits");
+
+        TestQueue t;
+        auto options = t.queue.getOptions();
+        options.minIntervalMs[(size_t) ControlSurfaceOutputQueue::ControlType::meter] = 40.0;
+        options.minIntervalMs[(size_t) ControlSurfaceOutputQueue::ControlType::button] = 0.0;
+        t.queue.setOptions (options);
+
+        auto meter = [] (int level) { return juce::MidiMessage::channelPressureChange (1, level); };
+
+        t.queue.addMessage (0, meter (1));
+        t.queue.processFrame (0.0);
+        expectEquals ((int) t.sent.size(), 1);
+
+        // The meter is held back but the button isn't
+        t.queue.addMessage (0, meter (2));
+        t.queue.addMessage (0, juce::MidiMessage::noteOn (1, 60, (uint8_t) 127));
+        t.queue.processFrame (10.0);
+        expectEquals ((int) t.sent.size(), 2);
+        expect (t.sent.back().message.isNoteOn());
+
+        // Newer levels replace the held one and it's sent once the interval has passed
+        t.queue.addMessage (0, meter (3));
+        t.queue.processFrame (20.0);
+        expectEquals ((int) t.sent.size(), 2);
+        t.queue.processFrame (40.0);
+        expectEquals ((int) t.sent.size(), 3);
+        expectEquals (t.sent.back().message.getChannelPressureValue(), 3);
+
+        // Flushing ignores the limits
+        t.queue.addMessage (0, meter (4));
+        t.queue.flush();
+        expectEquals ((int) t.sent.size(), 4);
+    }
+
+    void runUnbatchedTests()
+    {
+        beginTest ("Unbatched output");
+
+        TestQueue t;
+        t.queue.addMessage (0, juce::MidiMessage::controllerEvent (1, 7, 1));
+
+        {
+            const ControlSurfaceOutputQueue::ScopedUnbatchedOutput suo (t.queue);
+            expectEquals ((int) t.sent.size(), 1, "Waiting messages should be sent first");
+
+            t.queue.addMessage (0, juce::MidiMessage::controllerEvent (1, 7, 2));
+            t.queue.addMessage (0, juce::MidiMessage::controllerEvent (1, 7, 3));
+            expectEquals ((int) t.sent.size(), 3);
+        }
+
+        expect (t.queue.isBatchingEnabled());
+        t.queue.addMessage (0, juce::MidiMessage::controllerEvent (1, 7, 4));
+        expectEquals ((int) t.sent.size(), 3);
+    }
+};
+
+static ControlSurfaceOutputQueueTests controlSurfaceOutputQueueTests;
+
+#endif // TRACKTION_UNIT_TESTS
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+/**
+    Simulates the output of a Mackie MCU with three extenders during fast playback
+    and measures how much MIDI reaches the devices with and without batching.
+    Where virtual MIDI ports are available the output is sent through one so the
+    cost of the driver is included.
+*/
+class ControlSurfaceOutputQueueBenchmarks  : public juce::UnitTest
+{
+public:
+    ControlSurfaceOutputQueueBenchmarks()
+        : juce::UnitTest ("ControlSurfaceOutputQueue", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        for (bool batched : { false, true })
+            runMackieWorkload (batched, 4, 5000);
+    }
+
+private:
+    struct VirtualPort  : public juce::MidiInputCallback
+    {
+        VirtualPort()
+        {
+           #if JUCE_LINUX || JUCE_MAC
+            const auto name = "Tracktion Control Surface Benchmark";
+            output = juce::MidiOutput::createNewDevice (name);
+
+            if (output != nullptr)
+                for (auto& d : juce::MidiInput::getAvailableDevices())
+                    if (d.name.contains (name))
+                        if ((input = juce::MidiInput::openDevice (d.identifier, this)))
+                            break;
+
+            if (input != nullptr)
+                input->start();
+           #endif
+        }
+
+        ~VirtualPort() override
+        {
+            if (input != nullptr)
+                input->stop();
+        }
+
+        void handleIncomingMidiMessage (juce::MidiInput*, const juce::MidiMessage& m) override
+        {
+            ++numMessagesReceived;
+            numBytesReceived += m.getRawDataSize();
+        }
+
+        bool isOpen() const     { return output != nullptr && input != nullptr; }
+
+        std::unique_ptr<juce::MidiOutput> output;
+        std::unique_ptr<juce::MidiInput> input;
+        std::atomic<int> numMessagesReceived { 0 }, numBytesReceived { 0 };
+    };
+
+    void runMackieWorkload (bool batched, int numDevices, int numMilliseconds)
+    {
+        const auto name = std::to_string (numDevices) + " devices, " + std::to_string (numMilliseconds) + "ms, "
+                            + (batched ? "batched" : "unbatched");
+        beginTest (name);
+
+        VirtualPort port;
+        int numBlocks = 0;
+
+        ControlSurfaceOutputQueue queue ([&] (int, const juce::MidiBuffer& buffer)
+                                         {
+                                             ++numBlocks;
+
+                                             if (port.output != nullptr)
+                                                 port.output->sendBlockOfMessagesNow (buffer);
+                                         });
+        queue.setBatchingEnabled (batched);
+
+        auto options = queue.getOptions();
+        options.frameIntervalMs = 100000.0; // Frames are run on the simulated clock
+        queue.setOptions (options);
+
+        juce::Random r (42);
+
+        {
+            ScopedBenchmark sb (createBenchmarkDescription (*this, name));
+
+            for (int ms = 0; ms < numMilliseconds; ++ms)
+            {
+                for (int dev = 0; dev < numDevices; ++dev)
+                {
+                    // Meters and faders are updated every tick during playback
+                    for (int strip = 0; strip < 8; ++strip)
+                    {
+                        queue.addMessage (dev, juce::MidiMessage::channelPressureChange (1, (strip << 4) | r.nextInt (14)));
+
+                        if (ms % 2 == 0)
+                            queue.addMessage (dev, juce::MidiMessage::pitchWheel (strip + 1, r.nextInt (16384)));
+                    }
+
+                    // Track names and values are shown on the scribble strips
+                    if (ms % 50 == 0)
+                    {
+                        uint8_t data[62] = { 0x00, 0x00, 0x66, (uint8_t) (dev == 0 ? 0x14 : 0x15), 0x12, 0x00 };
+
+                        for (size_t i = 6; i < sizeof (data); ++i)
+                            data[i] = (uint8_t) (0x20 + r.nextInt (0x5e));
+
+                        queue.addMessage (dev, juce::MidiMessage::createSysExMessage (data, (int) sizeof (data)));
+                    }
+
+                    if (ms % 100 == 0)
+                        queue.addMessage (dev, juce::MidiMessage::noteOn (1, 0x18 + r.nextInt (8), (uint8_t) (r.nextBool() ? 0x7f : 0)));
+                }
+
+                // The timecode display only exists on the main unit
+                for (int digit = 0; digit < 10; ++digit)
+                    queue.addMessage (0, juce::MidiMessage::controllerEvent (1, 0x40 + digit, 0x30 + (ms / (digit + 1)) % 10));
+
+                if (batched && ms % 10 == 0)
+                    queue.processFrame ((double) ms);
+            }
+
+            queue.flush();
+        }
+
+        // Give the virtual port a chance to deliver everything
+        if (port.isOpen())
+            for (int i = 0; i < 20 && port.numMessagesReceived < (int) queue.getStats().numMessagesSent; ++i)
+                juce::Thread::sleep (50);
+
+        const auto stats = queue.getStats();
+        logMessage ("Messages added: " + juce::String (stats.numMessagesAdded)
+                    + ", sent: " + juce::String (stats.numMessagesSent)
+                    + ", coalesced: " + juce::String (stats.numMessagesCoalesced)
+                    + ", blocks: " + juce::String (numBlocks)
+                    + ", bytes: " + juce::String (stats.numBytesSent)
+                    + ", bytes per second: " + juce::String (stats.numBytesSent * 1000 / (uint64_t) numMilliseconds));
+
+        if (port.isOpen())
+            logMessage ("Received through virtual port: " + juce::String (port.numMessagesReceived.load())
+                        + " messages, " + juce::String (port.numBytesReceived.load()) + " bytes");
+        else
+            logMessage ("Virtual MIDI ports aren't available so only the queue was measured");
+
+        if (batched)
+            expect (stats.numMessagesSent < stats.numMessagesAdded / 4, "Batching should remove most of the redundant updates");
+        else
+            expectEquals ((int) stats.numMessagesSent, (int) stats.numMessagesAdded);
+    }
+};
+
+static ControlSurfaceOutputQueueBenchmarks controlSurfaceOutputQueueBenchmarks;
+
+#endif // TRACKTION_BENCHMARKS
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
@@ -53,7 +53,9 @@ ExternalController::ExternalController (Engine& e, ControlSurface* c)  : engine
     midiInOutDevicesChanged();
     oscSettingsChanged();
 
-    cs.initialiseDevice (isEnabled());
+    // BEATCONNECT MODIFICATION START
+    initialiseControlSurface();
+    // BEATCONNECT MODIFICATION END
     if (numDevices != 1)
         cs.numExtendersChanged (numDevices - 1, mainDevice);
 
@@ -69,7 +71,12 @@ ExternalController::~ExternalController()
         for (auto p : af->getAutomatableParameters())
             p->removeListener (this);
 
-    getControlSurface().shutDownDevice();
+    // BEATCONNECT MODIFICATION START
+    {
+        const ControlSurfaceOutputQueue::ScopedUnbatchedOutput suo (getControlSurface().getOutputQueue());
+        getControlSurface().shutDownDevice();
+    }
+    // BEATCONNECT MODIFICATION END
     controlSurface = nullptr;
 
     auto& dm = engine.getDeviceManager();
@@ -132,6 +139,19 @@ bool ExternalController::isEnabled() const
     return enabled;
 }
 
+// BEATCONNECT MODIFICATION START
+void ExternalController::initialiseControlSurface()
+{
+    if (controlSurface == nullptr)
+        return;
+
+    // Surfaces may wait for the device between messages whilst initialising
+    // so these need to be sent straight away rather than batched
+    const ControlSurfaceOutputQueue::ScopedUnbatchedOutput suo (getControlSurface().getOutputQueue());
+    getControlSurface().initialiseDevice (isEnabled());
+}
+// BEATCONNECT MODIFICATION END
+
 void ExternalController::setEnabled (bool e)
 {
     if (controlSurface != nullptr && ! needsChannel)
@@ -141,7 +161,9 @@ void ExternalController::setEnabled (bool e)
 
         engine.getPropertyStorage().setPropertyItem (SettingID::externControlEnable, getName(), e);
 
-        getControlSurface().initialiseDevice (isEnabled());
+        // BEATCONNECT MODIFICATION START
+        initialiseControlSurface();
+        // BEATCONNECT MODIFICATION END
         updateDeviceState();
         changeParamBank (0);
     }
@@ -306,8 +328,9 @@ void ExternalController::timerCallback()
     stopTimer();
     
     CRASH_TRACER
-    if (controlSurface != nullptr)
-        getControlSurface().initialiseDevice (isEnabled());
+    // BEATCONNECT MODIFICATION START
+    initialiseControlSurface();
+    // BEATCONNECT MODIFICATION END
 
     updateDeviceState();
     changeParamBank (0);
@@ -319,8 +342,9 @@ void ExternalController::oscSettingsChanged()
         return;
 
     CRASH_TRACER
-    if (controlSurface != nullptr)
-        getControlSurface().initialiseDevice (isEnabled());
+    // BEATCONNECT MODIFICATION START
+    initialiseControlSurface();
+    // BEATCONNECT MODIFICATION END
 
     getControlSurface().updateOSCSettings (oscInputPort, oscOutputPort, oscOutputAddr);
 
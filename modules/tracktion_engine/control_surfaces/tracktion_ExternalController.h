@@ -161,6 +161,10 @@ public:
 private:
     void timerCallback() override;
 
+    // BEATCONNECT MODIFICATION START
+    void initialiseControlSurface();
+    // BEATCONNECT MODIFICATION END
+
     static constexpr int maxDevices = 4;
     friend class ExternalControllerManager;
     friend class ControlSurface;
@@ -1237,6 +1237,42 @@ const juce::Array<MidiSysexEvent*>& MidiList::getSysexEvents() const
     return getEventsChecked (sysexList->getSortedList());
 }
 
+// BEATCONNECT MODIFICATION START
+juce::Array<MidiNote*> MidiList::getNotesInRange (BeatRange range) const
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    juce::Array<MidiNote*> notes;
+    noteList->index.visitOverlapping (range, [&notes] (MidiNote* n) { notes.add (n); });
+    return notes;
+}
+
+juce::Array<MidiNote*> MidiList::getNotesAt (BeatPosition beat) const
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    juce::Array<MidiNote*> notes;
+    noteList->index.visitContaining (beat, [&notes] (MidiNote* n) { notes.add (n); });
+    return notes;
+}
+
+std::optional<BeatPosition> MidiList::getNextNoteEdgeAfter (BeatPosition beat) const
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    return noteList->index.getNextEdgeAfter (beat);
+}
+
+std::optional<BeatPosition> MidiList::getPreviousNoteEdgeBefore (BeatPosition beat) const
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    return noteList->index.getPreviousEdgeBefore (beat);
+}
+
+bool MidiList::containsNote (const MidiNote& note) const
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    return noteList->index.contains (const_cast<MidiNote*> (&note));
+}
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 void MidiList::moveAllBeatPositions (BeatDuration delta, juce::UndoManager* um)
 {
@@ -69,6 +69,23 @@ public:
     MidiNote* getNote (int index) const                             { return getNotes()[index]; }
     MidiNote* getNoteFor (const juce::ValueTree&);
 
+    // BEATCONNECT MODIFICATION START
+    /** Returns the notes that overlap a range of beats, in order of their start beats. */
+    juce::Array<MidiNote*> getNotesInRange (BeatRange) const;
+
+    /** Returns the notes playing at a beat, in order of their start beats. */
+    juce::Array<MidiNote*> getNotesAt (BeatPosition) const;
+
+    /** Returns the first note start or end after a beat, if there is one. */
+    std::optional<BeatPosition> getNextNoteEdgeAfter (BeatPosition) const;
+
+    /** Returns the last note start or end before a beat, if there is one. */
+    std::optional<BeatPosition> getPreviousNoteEdgeBefore (BeatPosition) const;
+
+    /** Returns true if the note belongs to this list. */
+    bool containsNote (const MidiNote&) const;
+    // BEATCONNECT MODIFICATION END
+
     juce::Range<int> getNoteNumberRange() const;
 
     /** Beat number of first event in the list */
@@ -209,6 +226,11 @@ private:
             : ValueTreeObjectList<EventType> (v)
         {
             ValueTreeObjectList<EventType>::rebuildObjects();
+
+            // BEATCONNECT MODIFICATION START
+            for (auto e : ValueTreeObjectList<EventType>::objects)
+                updateIndex (*e);
+            // BEATCONNECT MODIFICATION END
         }
 
         ~EventList() override
@@ -228,17 +250,36 @@ private:
         bool isSuitableType (const juce::ValueTree& v) const override   { return EventDelegate<EventType>::isSuitableType (v); }
         EventType* createNewObject (const juce::ValueTree& v) override  { return new EventType (v); }
         void deleteObject (EventType* m) override                       { delete m; }
-        void newObjectAdded (EventType*) override                       { triggerSort(); }
-        void objectRemoved (EventType* m) override                      { EventDelegate<EventType>::removeFromSelection (m); triggerSort(); }
+        // BEATCONNECT MODIFICATION START
+        void newObjectAdded (EventType* m) override                     { updateIndex (*m); triggerSort(); }
+        void objectRemoved (EventType* m) override                      { index.remove (m); EventDelegate<EventType>::removeFromSelection (m); triggerSort(); }
+        // BEATCONNECT MODIFICATION END
         void objectOrderChanged() override                              { triggerSort(); }
 
         void valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& i) override
         {
             if (auto e = getEventFor (v))
+            {
                 if (EventDelegate<EventType>::updateObject (*e, i))
                     triggerSort();
+
+                // BEATCONNECT MODIFICATION START
+                updateIndex (*e);
+                // BEATCONNECT MODIFICATION END
+            }
+        }
+
+        // BEATCONNECT MODIFICATION START
+        /** Only notes have a length so they're the only events that get indexed by range. */
+        void updateIndex (EventType& e)
+        {
+            if constexpr (std::is_same_v<EventType, MidiNote>)
+                index.insert (e.getRangeBeats(), &e);
         }
 
+        IntervalTree<BeatRange, EventType*> index;
+        // BEATCONNECT MODIFICATION END
+
         void triggerSort()
         {
             const juce::ScopedLock sl (lock);
@@ -0,0 +1,71 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class MidiListRangeQueryTests  : public juce::UnitTest
+{
+public:
+    MidiListRangeQueryTests()
+        : juce::UnitTest ("MidiList range queries", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runNoteTests();
+    }
+
+private:
+    void runNoteTests()
+    {
+        beginTest ("Note queries");
+
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+        auto clip = track->insertMIDIClip ({ 0_tp, TimePosition::fromSeconds (8.0) }, nullptr);
+        auto& seq = clip->getSequence();
+
+        auto n1 = seq.addNote (60, 0_bp, 2_bd, 100, 0, nullptr);
+        auto n2 = seq.addNote (62, 1_bp, 2_bd, 100, 0, nullptr);
+        auto n3 = seq.addNote (64, 4_bp, 1_bd, 100, 0, nullptr);
+
+        expect (seq.getNotesInRange ({ 1.5_bp, 2.5_bp }) == juce::Array<MidiNote*> { n1, n2 });
+        expect (seq.getNotesAt (4_bp) == juce::Array<MidiNote*> { n3 });
+        expect (seq.getNextNoteEdgeAfter (3_bp) == 4_bp);
+        expect (seq.getPreviousNoteEdgeBefore (4_bp) == 3_bp);
+        expect (seq.containsNote (*n2));
+
+        n3->setStartAndLength (2_bp, 1_bd, nullptr);
+        expect (seq.getNotesAt (2.5_bp) == juce::Array<MidiNote*> { n2, n3 });
+        expect (seq.getNotesAt (4_bp).isEmpty());
+
+        seq.removeNote (*n2, nullptr);
+        expect (seq.getNotesAt (2.5_bp) == juce::Array<MidiNote*> { n3 });
+        expectEquals (seq.getNotesInRange ({ 0_bp, 8_bp }).size(), seq.getNumNotes());
+
+        // Notes that start together are returned in the order they were added
+        auto n4 = seq.addNote (67, 2_bp, 2_bd, 100, 0, nullptr);
+        auto n5 = seq.addNote (60, 2_bp, 1_bd, 100, 0, nullptr);
+        expect (seq.getNotesAt (2.5_bp) == juce::Array<MidiNote*> { n3, n4, n5 });
+    }
+};
+
+static MidiListRangeQueryTests midiListRangeQueryTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
@@ -951,10 +951,11 @@ void PatternGenerator::valueTreePropertyChanged (juce::ValueTree&, const juce::I
 
 ChordClip* PatternGenerator::getChordClipAt (TimePosition t) const
 {
-    for (auto c : clip.edit.getChordTrack()->getClips())
-        if (c->getPosition().time.contains (t))
-            if (auto cc = dynamic_cast<ChordClip*> (c))
-                return cc;
+    // BEATCONNECT MODIFICATION START
+    for (auto c : clip.edit.getChordTrack()->getClipsAt (t))
+        if (auto cc = dynamic_cast<ChordClip*> (c))
+            return cc;
+    // BEATCONNECT MODIFICATION END
 
     return {};
 }
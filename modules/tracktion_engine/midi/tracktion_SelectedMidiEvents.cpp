@@ -40,9 +40,11 @@ Edit& SelectedMidiEvents::getEdit()
 //==============================================================================
 MidiClip* SelectedMidiEvents::clipForEvent (MidiNote* note) const
 {
+    // BEATCONNECT MODIFICATION START
     for (auto* c : clips)
-        if (c->getSequence().getNotes().contains (note))
+        if (note != nullptr && c->getSequence().containsNote (*note))
             return c;
+    // BEATCONNECT MODIFICATION END
 
     // SelectedMidiEvents must never have events without the parent clip
     jassertfalse;
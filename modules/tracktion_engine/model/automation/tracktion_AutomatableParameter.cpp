@@ -662,8 +662,15 @@ AutomatableParameter::AutomatableParameter (const juce::String& paramID_,
 AutomatableParameter::~AutomatableParameter()
 {
     if (auto edit = dynamic_cast<Edit*> (editRef.get()))
+    {
         edit->getAutomationRecordManager().parameterBeingDeleted (*this);
 
+        // BEATCONNECT MODIFICATION START
+        if (hasBeenQueued)
+            edit->getParameterChangeQueue().removeParameter (*this);
+        // BEATCONNECT MODIFICATION END
+    }
+
     notifyListenersOfDeletion();
 
     automationSourceList.reset();
@@ -994,7 +1001,6 @@ void AutomatableParameter::resetRecordingStatus()
 //==============================================================================
 void AutomatableParameter::setParameterValue (float value, bool isFollowingCurve)
 {
-    auto& curve = getCurve();
     value = snapToState (getValueRange().clipValue (value));
     currentBaseValue = value;
 
@@ -1021,34 +1027,9 @@ void AutomatableParameter::setParameterValue (float value, bool isFollowingCurve
             if (! getEdit().isLoading())
                 jassert (juce::MessageManager::getInstance()->currentThreadHasLockedMessageManager());
 
-            curveHasChanged();
-
-            if (auto epc = ed.getTransport().getCurrentPlaybackContext())
-            {
-                if (! epc->isDragging())
-                {
-                    auto numPoints = curve.getNumPoints();
-                    auto& arm = ed.getAutomationRecordManager();
-
-                    if (epc->isPlaying() && arm.isWritingAutomation())
-                    {
-                        auto time = epc->getPosition();
-
-                        if (! isRecording)
-                        {
-                            isRecording = true;
-                            arm.postFirstAutomationChange (*this, currentValue);
-                        }
-
-                        arm.postAutomationChange (*this, time, value);
-                    }
-                    else
-                    {
-                        if (numPoints == 1)
-                            curve.movePoint (0, curve.getPointTime (0), value, false);
-                    }
-                }
-            }
+            // BEATCONNECT MODIFICATION START
+            updateCurveForExplicitChange (value, currentValue);
+            // BEATCONNECT MODIFICATION END
 
             currentValue = value;
 
@@ -1089,6 +1070,70 @@ void AutomatableParameter::setNormalisedParameter (float value, juce::Notificati
     setParameter (valueRange.convertFrom0to1 (juce::jlimit (0.0f, 1.0f, value)), nt);
 }
 
+// BEATCONNECT MODIFICATION START
+void AutomatableParameter::updateCurveForExplicitChange (float value, float previousValue)
+{
+    auto& ed = getEdit();
+    curveHasChanged();
+
+    if (auto epc = ed.getTransport().getCurrentPlaybackContext())
+    {
+        if (! epc->isDragging())
+        {
+            auto& curve = getCurve();
+            auto numPoints = curve.getNumPoints();
+            auto& arm = ed.getAutomationRecordManager();
+
+            if (epc->isPlaying() && arm.isWritingAutomation())
+            {
+                auto time = epc->getPosition();
+
+                if (! isRecording)
+                {
+                    isRecording = true;
+                    arm.postFirstAutomationChange (*this, previousValue);
+                }
+
+                arm.postAutomationChange (*this, time, value);
+            }
+            else
+            {
+                if (numPoints == 1)
+                    curve.movePoint (0, curve.getPointTime (0), value, false);
+            }
+        }
+    }
+}
+
+bool AutomatableParameter::queueParameterChange (float value, int sampleOffset)
+{
+    return getEdit().getParameterChangeQueue().postChange (*this, value, sampleOffset);
+}
+
+void AutomatableParameter::applyQueuedChange (float value)
+{
+    currentParameterValue = value;
+    setParameterValue (value, true);
+}
+
+void AutomatableParameter::commitQueuedChange (float previousValue)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    const float value = currentValue;
+
+    if (value != previousValue)
+        updateCurveForExplicitChange (value, previousValue);
+
+    listeners.call (&Listener::parameterChanged, *this, value);
+
+    if (attachedValue != nullptr)
+    {
+        attachedValue->cancelPendingUpdate();
+        attachedValue->handleAsyncUpdate();
+    }
+}
+// BEATCONNECT MODIFICATION END
+
 juce::String AutomatableParameter::getCurrentValueAsStringWithLabel()
 {
     auto text = getCurrentValueAsString();
@@ -1158,7 +1203,16 @@ void AutomatableParameter::parameterChangeGestureEnd()
 //==============================================================================
 void AutomatableParameter::midiControllerMoved (float newPosition)
 {
-    setParameter (snapToState (valueRange.convertFrom0to1 (newPosition)), juce::sendNotification);
+    const auto newValue = snapToState (valueRange.convertFrom0to1 (newPosition));
+
+    // BEATCONNECT MODIFICATION START
+    if (getEngine().getEngineBehaviour().shouldQueueControllerParameterChanges()
+         && getEdit().getTransport().isPlayContextActive()
+         && queueParameterChange (newValue))
+        return;
+    // BEATCONNECT MODIFICATION END
+
+    setParameter (newValue, juce::sendNotification);
 }
 
 void AutomatableParameter::midiControllerPressed()
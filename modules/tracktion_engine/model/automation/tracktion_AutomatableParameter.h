@@ -83,6 +83,19 @@ public:
     void setNormalisedParameter (float value, juce::NotificationType);
     void updateToFollowCurve (TimePosition);
 
+    // BEATCONNECT MODIFICATION START
+    /** Queues a change to this parameter's value without blocking.
+        This can be called from any thread. The new value is applied on the audio thread
+        at the start of the block containing the given sample offset and the change is
+        then committed to the Edit's state on the message thread, as if setParameter had
+        been called. Repeated changes made before the queue is serviced are coalesced.
+        Returns false if the Edit's ParameterChangeQueue was full, in which case the
+        value hasn't been changed.
+        @see ParameterChangeQueue
+    */
+    bool queueParameterChange (float value, int sampleOffset = 0);
+    // BEATCONNECT MODIFICATION END
+
     /** Call to indicate this parameter is about to be changed. */
     void parameterChangeGestureBegin();
 
@@ -248,6 +261,16 @@ protected:
 
     void setParameterValue (float value, bool isFollowingCurve);
 
+    // BEATCONNECT MODIFICATION START
+    friend class ParameterChangeQueue;
+    std::atomic<float> queuedValue { 0.0f }, valueBeforeQueuedChange { 0.0f };
+    std::atomic<bool> changeIsQueued { false }, queuedChangeNeedsCommitting { false }, hasBeenQueued { false };
+
+    void applyQueuedChange (float value);
+    void commitQueuedChange (float previousValue);
+    void updateCurveForExplicitChange (float value, float previousValue);
+    // BEATCONNECT MODIFICATION END
+
     void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
     void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override;
     void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override;
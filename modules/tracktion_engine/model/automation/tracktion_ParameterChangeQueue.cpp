@@ -0,0 +1,248 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+ParameterChangeQueue::ParameterChangeQueue (Edit& e, int maxNumParameters)
+    : edit (e), capacity (juce::jmax (1, maxNumParameters))
+{
+    incoming.reset ((size_t) capacity);
+    applied.reset ((size_t) capacity);
+    pending.reserve ((size_t) capacity);
+}
+
+ParameterChangeQueue::~ParameterChangeQueue()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    cancelPendingUpdate();
+    stopTimer();
+}
+
+//==============================================================================
+bool ParameterChangeQueue::postChange (AutomatableParameter& param, float value, int sampleOffset)
+{
+    numPosted.fetch_add (1, std::memory_order_relaxed);
+
+    // Reserve a place first so that a change can't be coalesced in to one that then gets dropped
+    if (numQueued.fetch_add (1) >= capacity)
+    {
+        numQueued.fetch_sub (1);
+        numDropped.fetch_add (1, std::memory_order_relaxed);
+        return false;
+    }
+
+    param.hasBeenQueued.store (true, std::memory_order_relaxed);
+    param.queuedValue.store (value);
+
+    if (param.changeIsQueued.exchange (true))
+    {
+        // The reader clears the flag before reading the value so will pick this one up
+        numQueued.fetch_sub (1);
+        numCoalesced.fetch_add (1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // There's always room as each parameter only has one event in the queue at a time
+    [[maybe_unused]] const bool added = incoming.push ({ &param, juce::jmax (0, sampleOffset) });
+    jassert (added);
+
+    triggerAsyncUpdate();
+    return true;
+}
+
+//==============================================================================
+void ParameterChangeQueue::dispatchPendingChanges (int numSamples) noexcept
+{
+    lastAudioThreadDispatchTime.store (juce::jmax (1u, juce::Time::getMillisecondCounter()), std::memory_order_relaxed);
+
+    if (numQueued.load (std::memory_order_relaxed) == 0)
+        return;
+
+    const juce::SpinLock::ScopedTryLockType tl (readerLock);
+
+    if (! tl.isLocked())
+        return;
+
+    if (dispatch (numSamples))
+        triggerAsyncUpdate();
+}
+
+void ParameterChangeQueue::flush()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    for (;;)
+    {
+        bool anyApplied = false;
+
+        {
+            const juce::SpinLock::ScopedLockType sl (readerLock);
+            anyApplied = dispatch (std::numeric_limits<int>::max());
+        }
+
+        commitAppliedChanges();
+
+        if (! anyApplied || getNumPendingChanges() == 0)
+            break;
+    }
+}
+
+void ParameterChangeQueue::removeParameter (AutomatableParameter& param)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    const juce::SpinLock::ScopedLockType sl (readerLock);
+
+    for (Event e; incoming.pop (e);)
+        pending.push_back (e);
+
+    const auto numBefore = pending.size();
+    pending.erase (std::remove_if (pending.begin(), pending.end(),
+                                   [&param] (const Event& e) { return e.parameter == &param; }),
+                   pending.end());
+    numQueued.fetch_sub ((int) (numBefore - pending.size()));
+    param.changeIsQueued = false;
+
+    // Holding the readerLock means nothing else can be adding to the applied list
+    for (auto numToCheck = applied.getUsedSlots(); numToCheck > 0; --numToCheck)
+    {
+        AutomatableParameter* p = nullptr;
+
+        if (applied.pop (p) && p != &param)
+            applied.push (p);
+    }
+
+    param.queuedChangeNeedsCommitting = false;
+}
+
+//==============================================================================
+ParameterChangeQueue::Statistics ParameterChangeQueue::getStatistics() const noexcept
+{
+    Statistics s;
+    s.numPosted     = numPosted.load (std::memory_order_relaxed);
+    s.numCoalesced  = numCoalesced.load (std::memory_order_relaxed);
+    s.numDropped    = numDropped.load (std::memory_order_relaxed);
+    s.numApplied    = numApplied.load (std::memory_order_relaxed);
+    s.numCommitted  = numCommitted.load (std::memory_order_relaxed);
+    return s;
+}
+
+void ParameterChangeQueue::resetStatistics() noexcept
+{
+    for (auto c : { &numPosted, &numCoalesced, &numDropped, &numApplied, &numCommitted })
+        c->store (0, std::memory_order_relaxed);
+}
+
+//==============================================================================
+bool ParameterChangeQueue::dispatch (int numSamples) noexcept
+{
+    // N.B. this must only be called with the readerLock held
+    for (Event e; incoming.pop (e);)
+        pending.push_back (e);
+
+    bool anyApplied = false;
+    size_t numKept = 0;
+
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        auto e = pending[i];
+
+        if (e.samplesUntilDue < numSamples)
+        {
+            if (apply (*e.parameter))
+            {
+                anyApplied = true;
+                continue;
+            }
+        }
+        else
+        {
+            e.samplesUntilDue -= numSamples;
+        }
+
+        pending[numKept++] = e;
+    }
+
+    pending.resize (numKept);
+    return anyApplied;
+}
+
+bool ParameterChangeQueue::apply (AutomatableParameter& param) noexcept
+{
+    // Make sure the change can be committed, otherwise leave it until next time
+    if (applied.getFreeSlots() == 0)
+        return false;
+
+    param.changeIsQueued.store (false);
+    const float value = param.queuedValue.load();
+    numQueued.fetch_sub (1);
+
+    const float previousValue = param.currentValue.load();
+    param.applyQueuedChange (value);
+    numApplied.fetch_add (1, std::memory_order_relaxed);
+
+    // Only add the parameter to the applied list if it isn't already waiting to be committed.
+    // The value is applied first so the message thread will always commit the latest one.
+    if (! param.queuedChangeNeedsCommitting.exchange (true))
+    {
+        param.valueBeforeQueuedChange.store (previousValue);
+        applied.push (&param);
+    }
+
+    return true;
+}
+
+void ParameterChangeQueue::commitAppliedChanges()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    for (AutomatableParameter* p = nullptr; applied.pop (p);)
+    {
+        const float previousValue = p->valueBeforeQueuedChange.load();
+
+        if (p->queuedChangeNeedsCommitting.exchange (false))
+        {
+            p->commitQueuedChange (previousValue);
+            numCommitted.fetch_add (1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ParameterChangeQueue::isAudioThreadDispatching() const noexcept
+{
+    const auto lastTime = lastAudioThreadDispatchTime.load (std::memory_order_relaxed);
+    return lastTime != 0 && juce::Time::getMillisecondCounter() - lastTime < 100;
+}
+
+//==============================================================================
+void ParameterChangeQueue::handleAsyncUpdate()
+{
+    CRASH_TRACER
+    commitAppliedChanges();
+
+    if (getNumPendingChanges() == 0)
+    {
+        stopTimer();
+        return;
+    }
+
+    // If the Edit isn't being played, nothing else will apply the changes
+    if (isAudioThreadDispatching() && ! edit.isRendering())
+        startTimer (50);
+    else
+        flush();
+}
+
+void ParameterChangeQueue::timerCallback()
+{
+    handleAsyncUpdate();
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,136 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+/**
+    Passes parameter changes from any thread to the audio thread without the audio
+    thread ever having to wait on a lock.
+
+    Changes are posted with AutomatableParameter::queueParameterChange (or postChange
+    here) and the EditPlaybackContext calls dispatchPendingChanges at the start of each
+    audio block. This sets the parameter's value in the same way automation does, so
+    the plugin sees it straight away. The parameters that were changed are then handed
+    back to the message thread which commits each one to the Edit's state, updating
+    its CachedValue, recording automation and notifying listeners just as setParameter
+    would.
+
+    If a parameter is changed again before its previous change has been applied, the
+    two are coalesced in to a single change with the latest value, so a flood of
+    controller messages results in at most one update per parameter per block on the
+    audio thread and one commit per parameter on the message thread.
+
+    Each change can have a sample offset, relative to the start of the next block. A
+    change is applied at the start of the block that contains its offset, which is the
+    resolution that parameter values are used at by the rest of the engine. Coalesced
+    changes keep the offset of the first change that was posted.
+
+    When the Edit isn't being played back, the message thread applies and commits any
+    pending changes itself.
+
+    There's one of these owned by each Edit.
+*/
+class ParameterChangeQueue  : private juce::AsyncUpdater,
+                              private juce::Timer
+{
+public:
+    //==============================================================================
+    /** Creates a queue for an Edit that can hold changes for up to maxNumParameters
+        different parameters at once.
+    */
+    ParameterChangeQueue (Edit&, int maxNumParameters = 4096);
+
+    /** Destructor. */
+    ~ParameterChangeQueue() override;
+
+    //==============================================================================
+    /** Queues a change to a parameter's value. This can be called from any thread and
+        never allocates. If the parameter already has a change queued, its value is
+        replaced.
+        @returns false if the queue was full, in which case the change was dropped
+    */
+    bool postChange (AutomatableParameter&, float value, int sampleOffset = 0);
+
+    /** Returns the number of parameters that currently have changes waiting to be applied. */
+    int getNumPendingChanges() const noexcept               { return numQueued.load (std::memory_order_relaxed); }
+
+    //==============================================================================
+    /** Applies any changes due in the next numSamples.
+        This is called by the EditPlaybackContext at the start of each audio block. It
+        won't block and will skip the update if the message thread is currently
+        servicing the queue.
+    */
+    void dispatchPendingChanges (int numSamples) noexcept;
+
+    /** Applies and commits all pending changes now, regardless of their sample offsets.
+        This must be called on the message thread.
+    */
+    void flush();
+
+    /** Removes any pending changes for a parameter.
+        This is called by AutomatableParameters when they're deleted.
+    */
+    void removeParameter (AutomatableParameter&);
+
+    //==============================================================================
+    /** Counters for monitoring the queue. */
+    struct Statistics
+    {
+        uint64_t numPosted = 0;     /**< The number of changes posted. */
+        uint64_t numCoalesced = 0;  /**< The number of posted changes merged with one already queued. */
+        uint64_t numDropped = 0;    /**< The number of changes dropped because the queue was full. */
+        uint64_t numApplied = 0;    /**< The number of changes applied to parameters. */
+        uint64_t numCommitted = 0;  /**< The number of changes committed to the Edit on the message thread. */
+    };
+
+    /** Returns the current statistics. */
+    Statistics getStatistics() const noexcept;
+
+    /** Resets the statistics. */
+    void resetStatistics() noexcept;
+
+private:
+    //==============================================================================
+    struct Event
+    {
+        AutomatableParameter* parameter = nullptr;
+        int samplesUntilDue = 0;
+    };
+
+    Edit& edit;
+    const int capacity;
+
+    // Written by any thread, read by whichever thread holds the readerLock
+    choc::fifo::SingleReaderMultipleWriterFIFO<Event> incoming;
+
+    // Only accessed by the thread holding the readerLock
+    std::vector<Event> pending;
+    juce::SpinLock readerLock;
+
+    // Written with the readerLock held, read on the message thread
+    choc::fifo::SingleReaderSingleWriterFIFO<AutomatableParameter*> applied;
+
+    std::atomic<int> numQueued { 0 };
+    std::atomic<uint32_t> lastAudioThreadDispatchTime { 0 };
+    std::atomic<uint64_t> numPosted { 0 }, numCoalesced { 0 }, numDropped { 0 }, numApplied { 0 }, numCommitted { 0 };
+
+    bool dispatch (int numSamples) noexcept;
+    bool apply (AutomatableParameter&) noexcept;
+    void commitAppliedChanges();
+    bool isAudioThreadDispatching() const noexcept;
+
+    void handleAsyncUpdate() override;
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterChangeQueue)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,194 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
+
+namespace tracktion { inline namespace engine
+{
+
+#if TRACKTION_UNIT_TESTS
+
+//==============================================================================
+//==============================================================================
+class ParameterChangeQueueTests  : public juce::UnitTest
+{
+public:
+    ParameterChangeQueueTests()
+        : juce::UnitTest ("ParameterChangeQueue", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto volumePlugin = edit->getMasterVolumePlugin();
+        auto& volParam = *volumePlugin->volParam;
+        auto& panParam = *volumePlugin->panParam;
+        auto& queue = edit->getParameterChangeQueue();
+
+        beginTest ("Coalescing");
+        {
+            queue.resetStatistics();
+
+            for (int i = 1; i <= 100; ++i)
+                expect (volParam.queueParameterChange (i / 200.0f));
+
+            expectEquals (queue.getNumPendingChanges(), 1);
+            expectEquals ((int) queue.getStatistics().numCoalesced, 99);
+
+            queue.dispatchPendingChanges (512);
+            expectEquals (queue.getNumPendingChanges(), 0);
+            expectWithinAbsoluteError (volParam.getCurrentValue(), 0.5f, 0.0001f);
+            expectWithinAbsoluteError (volParam.getCurrentExplicitValue(), 0.5f, 0.0001f);
+
+            queue.flush();
+            expectWithinAbsoluteError (volumePlugin->volume.get(), 0.5f, 0.0001f, "Value should be committed to the state");
+            expectEquals ((int) queue.getStatistics().numApplied, 1);
+            expectEquals ((int) queue.getStatistics().numCommitted, 1);
+        }
+
+        beginTest ("Sample offsets");
+        {
+            expect (panParam.queueParameterChange (0.25f, 1000));
+
+            queue.dispatchPendingChanges (512);
+            expect (panParam.getCurrentValue() != 0.25f, "Change shouldn't be applied before its block");
+
+            queue.dispatchPendingChanges (512);
+            expectWithinAbsoluteError (panParam.getCurrentValue(), 0.25f, 0.0001f);
+            queue.flush();
+        }
+
+        beginTest ("Removing parameters");
+        {
+            const auto currentValue = volParam.getCurrentValue();
+            expect (volParam.queueParameterChange (0.1f));
+            queue.removeParameter (volParam);
+
+            expectEquals (queue.getNumPendingChanges(), 0);
+            queue.flush();
+            expectEquals (volParam.getCurrentValue(), currentValue);
+        }
+
+        beginTest ("Full queue");
+        {
+            ParameterChangeQueue smallQueue (*edit, 1);
+            expect (smallQueue.postChange (volParam, 0.2f));
+            expect (! smallQueue.postChange (panParam, 0.2f), "Queue should be full");
+            expect (smallQueue.postChange (volParam, 0.3f), "Changes to queued parameters should be coalesced");
+            expectEquals ((int) smallQueue.getStatistics().numDropped, 1);
+
+            smallQueue.flush();
+            expectWithinAbsoluteError (volParam.getCurrentValue(), 0.3f, 0.0001f);
+            expectEquals (smallQueue.getNumPendingChanges(), 0);
+        }
+    }
+};
+
+static ParameterChangeQueueTests parameterChangeQueueTests;
+
+#endif // TRACKTION_UNIT_TESTS
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+class ParameterChangeQueueBenchmarks  : public juce::UnitTest
+{
+public:
+    ParameterChangeQueueBenchmarks()
+        : juce::UnitTest ("ParameterChangeQueue", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = Edit::createSingleTrackEdit (engine);
+        edit->ensureNumberOfAudioTracks (16);
+        auto params = getAllAutomatableParameter (*edit);
+
+        for (int numProducers : { 1, 4, 8 })
+        {
+            beginTest ("Contention: " + juce::String (numProducers) + " producers");
+            runContention (*edit, params, numProducers);
+        }
+    }
+
+private:
+    void runContention (Edit& edit, const juce::Array<AutomatableParameter*>& params, int numProducers)
+    {
+        constexpr int numBlocks = 2000, blockSize = 256, changesPerMillisecond = 10;
+        auto& queue = edit.getParameterChangeQueue();
+        queue.resetStatistics();
+
+        // Each producer posts ~10,000 changes per second to random parameters
+        std::atomic<bool> finished { false };
+        std::vector<std::thread> producers;
+
+        for (int i = 0; i < numProducers; ++i)
+        {
+            producers.emplace_back ([&, i]
+            {
+                juce::Random r (i);
+
+                while (! finished)
+                {
+                    for (int n = 0; n < changesPerMillisecond; ++n)
+                    {
+                        auto& p = *params.getUnchecked (r.nextInt (params.size()));
+                        queue.postChange (p, p.valueRange.convertFrom0to1 (r.nextFloat()), r.nextInt (blockSize * 2));
+                    }
+
+                    std::this_thread::sleep_for (std::chrono::milliseconds (1));
+                }
+            });
+        }
+
+        Benchmark benchmark (createBenchmarkDescription (*this, "Dispatch " + std::to_string (blockSize) + " sample blocks, "
+                                                              + std::to_string (numProducers) + " producers"));
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            benchmark.start();
+            queue.dispatchPendingChanges (blockSize);
+            benchmark.stop();
+
+            std::this_thread::sleep_for (std::chrono::microseconds (500));
+        }
+
+        finished = true;
+
+        for (auto& t : producers)
+            t.join();
+
+        BenchmarkList::getInstance().addResult (benchmark.getResult());
+        queue.flush();
+
+        const auto stats = queue.getStatistics();
+        logMessage ("Posted: " + juce::String (stats.numPosted)
+                    + ", coalesced: " + juce::String (stats.numCoalesced)
+                    + ", dropped: " + juce::String (stats.numDropped)
+                    + ", applied: " + juce::String (stats.numApplied)
+                    + ", committed: " + juce::String (stats.numCommitted));
+
+        expectEquals (queue.getNumPendingChanges(), 0);
+        expectEquals (stats.numPosted, stats.numCoalesced + stats.numDropped + stats.numApplied);
+    }
+};
+
+static ParameterChangeQueueBenchmarks parameterChangeQueueBenchmarks;
+
+#endif // TRACKTION_BENCHMARKS
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
@@ -1870,6 +1870,9 @@ struct StretchSegment
                     double sampleRate, const AudioSegmentList::Segment& s)
         : segment (s),
           fileInfo (file.getInfo()),
+          // BEATCONNECT MODIFICATION START
+          outputSampleRate (sampleRate),
+          // BEATCONNECT MODIFICATION END
           crossfadeSamples ((int) tracktion::toSamples (info.audioSegmentList->getCrossfadeLength(), sampleRate)),
           numChannelsToUse (juce::jlimit (1, maxNumChannels, fileInfo.numChannels))
     {
@@ -1899,6 +1902,29 @@ struct StretchSegment
         }
     }
 
+    // BEATCONNECT MODIFICATION START
+    /** Moves the source read position so rendering can start part way through the segment.
+        This is used when a proxy is rendered in separate chunks, each with its own set of segments.
+    */
+    void seekTo (TimePosition editTime)
+    {
+        auto loopRange = segment.getRange();
+
+        if (reader == nullptr || editTime <= loopRange.getStart() || editTime >= loopRange.getEnd())
+            return;
+
+        const auto outputOffset = (SampleCount) std::llround ((editTime - loopRange.getStart()).inSeconds() * outputSampleRate);
+        const auto sourceOffset = (SampleCount) (outputOffset * segment.getStretchRatio());
+
+        if (segment.isFollowedBySilence())
+            reader->setReadPosition (segment.getSampleRange().getStart() + sourceOffset);
+        else
+            reader->setReadPosition (sourceOffset);
+
+        readySampleOutputPos = outputOffset;
+    }
+    // BEATCONNECT MODIFICATION END
+
     void renderNextBlock (juce::AudioBuffer<float>& buffer, TimeRange editTime, int numSamples)
     {
         if (reader == nullptr)
@@ -2050,6 +2076,9 @@ struct StretchSegment
 
     AudioFileInfo fileInfo;
     AudioFileCache::Reader::Ptr reader;
+    // BEATCONNECT MODIFICATION START
+    const double outputSampleRate;
+    // BEATCONNECT MODIFICATION END
 
     const int outputBufferSize = 1024;
     int readySamplesStart = 0, readySamplesEnd = 0;
@@ -2060,6 +2089,71 @@ struct StretchSegment
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StretchSegment)
 };
 
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+static constexpr int proxyRenderBlockSize = 1024;
+
+static int getNumProxyRenderBlocks (TimeRange clipTime, double sampleRate)
+{
+    return 1 + (int) (clipTime.getLength().inSeconds() * sampleRate / proxyRenderBlockSize);
+}
+
+static bool renderProxyInChunks (Engine& engine, const AudioFile& sourceFile,
+                                 const AudioClipBase::ProxyRenderingInfo& info, AudioFileWriter& writer,
+                                 juce::ThreadPoolJob* const& job, std::atomic<float>& progress,
+                                 const ParallelTimeStretchRenderer::Options& options, int samplesPerBlock)
+{
+    CRASH_TRACER
+    const auto sampleRate = sourceFile.getSampleRate();
+
+    // Each chunk gets its own set of segments, and hence TimeStretchers and readers, so they can run concurrently.
+    // The range includes the chunk's pre-roll so only the segments that overlap it are needed.
+    auto renderChunk = [&] (SampleRange range, juce::AudioBuffer<float>& dest)
+    {
+        const auto chunkTime = TimeRange (TimePosition::fromSamples (range.getStart(), sampleRate),
+                                          TimePosition::fromSamples (range.getEnd(), sampleRate));
+        juce::OwnedArray<StretchSegment> segments;
+
+        for (auto& segment : info.audioSegmentList->getSegments())
+        {
+            if (! segment.getRange().overlaps (chunkTime))
+                continue;
+
+            auto s = segments.add (new StretchSegment (engine, sourceFile, info, sampleRate, segment));
+            s->seekTo (chunkTime.getStart());
+        }
+
+        juce::AudioBuffer<float> buffer (dest.getNumChannels(), samplesPerBlock);
+
+        for (auto pos = range.getStart(); pos < range.getEnd(); pos += samplesPerBlock)
+        {
+            if (job != nullptr && job->shouldExit())
+                return false;
+
+            buffer.clear();
+
+            const auto editTime = TimeRange (TimePosition::fromSamples (pos, sampleRate),
+                                             TimePosition::fromSamples (pos + samplesPerBlock, sampleRate));
+
+            for (auto s : segments)
+                s->renderNextBlock (buffer, editTime, samplesPerBlock);
+
+            const auto numThisBlock = (int) std::min ((SampleCount) samplesPerBlock, range.getEnd() - pos);
+
+            for (int i = 0; i < dest.getNumChannels(); ++i)
+                dest.copyFrom (i, (int) (pos - range.getStart()), buffer, i, 0, numThisBlock);
+        }
+
+        return true;
+    };
+
+    return ParallelTimeStretchRenderer::render (options, renderChunk,
+                                                [&writer] (juce::AudioBuffer<float>& buffer) { return writer.appendBuffer (buffer, buffer.getNumSamples()); },
+                                                progress,
+                                                [&job] { return job != nullptr && job->shouldExit(); });
+}
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 std::unique_ptr<AudioClipBase::ProxyRenderingInfo> AudioClipBase::createProxyRenderingInfo()
 {
@@ -2075,6 +2169,38 @@ std::unique_ptr<AudioClipBase::ProxyRenderingInfo> AudioClipBase::createProxyRen
     return p;
 }
 
+// BEATCONNECT MODIFICATION START
+std::optional<ParallelTimeStretchRenderer::Options> AudioClipBase::ProxyRenderingInfo::getChunkOptions (Engine& engine, const AudioFile& sourceFile) const
+{
+    const auto threadsToUse = numThreads > 0 ? numThreads : engine.getEngineBehaviour().getNumberOfCPUsToUseForOfflineTimeStretching();
+
+    if (threadsToUse <= 1 || audioSegmentList->getSegments().isEmpty() || ! sourceFile.isValid())
+        return {};
+
+    float maxSpeedRatio = 1.0f, maxTranspose = 0.0f;
+
+    for (auto& segment : audioSegmentList->getSegments())
+    {
+        maxSpeedRatio = std::max (maxSpeedRatio, 1.0f / segment.getStretchRatio());
+        maxTranspose = std::max (maxTranspose, std::abs (segment.getTranspose()));
+    }
+
+    const auto sampleRate = sourceFile.getSampleRate();
+    auto chunkOptions = ParallelTimeStretchRenderer::createOptions (mode, options, sampleRate, sourceFile.getNumChannels(),
+                                                                    maxSpeedRatio, maxTranspose,
+                                                                    getNumProxyRenderBlocks (clipTime, sampleRate) * (SampleCount) proxyRenderBlockSize,
+                                                                    threadsToUse);
+
+    if (chunkSize > 0)
+        chunkOptions.chunkSize = std::max (chunkSize, chunkOptions.prerollSamples * 2);
+
+    if (! ParallelTimeStretchRenderer::shouldRenderInChunks (chunkOptions))
+        return {};
+
+    return chunkOptions;
+}
+// BEATCONNECT MODIFICATION END
+
 bool AudioClipBase::ProxyRenderingInfo::render (Engine& engine, const AudioFile& sourceFile, AudioFileWriter& writer,
                                                 juce::ThreadPoolJob* const& job, std::atomic<float>& progress) const
 {
@@ -2087,15 +2213,20 @@ bool AudioClipBase::ProxyRenderingInfo::render (Engine& engine, const AudioFile&
 
     auto sampleRate = sourceFile.getSampleRate();
 
+    // BEATCONNECT MODIFICATION START
+    const int samplesPerBlock = proxyRenderBlockSize;
+    auto numBlocks = getNumProxyRenderBlocks (clipTime, sampleRate);
+
+    if (auto chunkOptions = getChunkOptions (engine, sourceFile))
+        return renderProxyInChunks (engine, sourceFile, *this, writer, job, progress, *chunkOptions, samplesPerBlock);
+    // BEATCONNECT MODIFICATION END
+
     for (auto& segment : audioSegmentList->getSegments())
         segments.add (new StretchSegment (engine, sourceFile, *this, sampleRate, segment));
 
-    const int samplesPerBlock = 1024;
     juce::AudioBuffer<float> buffer (sourceFile.getNumChannels(), samplesPerBlock);
     double time = 0.0;
 
-    auto numBlocks = 1 + (int) (clipTime.getLength().inSeconds() * sampleRate / samplesPerBlock);
-
     for (int i = 0; i < numBlocks; ++i)
     {
         if (job != nullptr && job->shouldExit())
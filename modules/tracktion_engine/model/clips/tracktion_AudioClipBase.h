@@ -444,6 +444,19 @@ public:
         TimeStretcher::Mode mode;
         TimeStretcher::ElastiqueProOptions options;
 
+        // BEATCONNECT MODIFICATION START
+        /** The number of threads to render with, or 0 to use EngineBehaviour::getNumberOfCPUsToUseForOfflineTimeStretching. */
+        int numThreads = 0;
+
+        /** The number of output samples in each chunk when rendering on several threads, or 0 to choose automatically. */
+        int chunkSize = 0;
+
+        /** Returns the Options render() will use to split the proxy in to chunks,
+            or an empty optional if it will be rendered serially.
+        */
+        std::optional<ParallelTimeStretchRenderer::Options> getChunkOptions (Engine&, const AudioFile&) const;
+        // BEATCONNECT MODIFICATION END
+
         /** Renders this audio segment list to an AudioFile. */
         bool render (Engine&, const AudioFile&, AudioFileWriter&, juce::ThreadPoolJob* const&, std::atomic<float>& progress) const;
 
@@ -1465,13 +1465,10 @@ void MidiCompManager::createComp (const juce::ValueTree& takeTree)
                 {
                     const BeatRange beats (startBeat, endBeat);
 
-                    for (auto n : src->getNotes())
+                    // BEATCONNECT MODIFICATION START
+                    for (auto n : src->getNotesInRange (beats))
                     {
                         auto nBeats = n->getRangeBeats();
-
-                        if (nBeats.getStart() > endBeat)
-                            break;
-
                         auto newRange = beats.getIntersectionWith (nBeats);
 
                         if (! newRange.isEmpty())
@@ -1482,6 +1479,7 @@ void MidiCompManager::createComp (const juce::ValueTree& takeTree)
                             dest->addNote (newNote, um);
                         }
                     }
+                    // BEATCONNECT MODIFICATION END
 
                     for (auto e : src->getControllerEvents())
                     {
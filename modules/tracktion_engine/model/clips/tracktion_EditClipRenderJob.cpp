@@ -108,9 +108,22 @@ bool EditRenderJob::setUpRender()
                                               }
                                           });
         juce::ignoreUnused (contextUpdater);
-        auto edit = new Edit (*params.engine,
-                              loadEditFromProjectManager (params.engine->getProjectManager(), itemID),
+
+        // BEATCONNECT MODIFICATION START
+        // The saved state is usually already held by the EditSnapshot so can be copied
+        // on this thread rather than parsing the file again
+        auto editState = [this]
+        {
+            if (auto snapshot = EditSnapshot::getEditSnapshot (*params.engine, itemID))
+                if (auto savedState = snapshot->getSavedState(); savedState != nullptr && savedState->hasType (IDs::EDIT))
+                    return savedState->createCopy();
+
+            return loadEditFromProjectManager (params.engine->getProjectManager(), itemID);
+        }();
+
+        auto edit = new Edit (*params.engine, editState,
                               Edit::forRendering, &context, 1); // always use saved version!
+        // BEATCONNECT MODIFICATION END
         editDeleter.setOwned (edit);
 
         // it's difficult to determine the marked region or selections at this point, so we'll ignore it,
@@ -181,6 +194,12 @@ EditRenderJob::RenderPass::~RenderPass()
     auto errorMessage (task != nullptr ? task->errorMessage : juce::String());
     owner.setLastError (errorMessage);
     const bool completedOk = task != nullptr ? task->getCurrentTaskProgress() == 1.0f : false;
+
+    // BEATCONNECT MODIFICATION START
+    if (completedOk && ! r.createMidiFile)
+        owner.result.loudness = task->params.resultLoudness;
+    // BEATCONNECT MODIFICATION END
+
     task = nullptr;
 
     if (owner.editDeleter.willDeleteObject())
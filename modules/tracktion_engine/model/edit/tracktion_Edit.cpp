@@ -555,6 +555,9 @@ Edit::Edit (Options options)
     masterPluginList            = std::make_unique<PluginList> (*this);
     parameterChangeHandler      = std::make_unique<ParameterChangeHandler> (*this);
     parameterControlMappings    = std::make_unique<ParameterControlMappings> (*this);
+    // BEATCONNECT MODIFICATION START
+    parameterChangeQueue        = std::make_unique<ParameterChangeQueue> (*this);
+    // BEATCONNECT MODIFICATION END
     rackTypes                   = std::make_unique<RackTypeList> (*this);
     trackCompManager            = std::make_unique<TrackCompManager> (*this);
     changedPluginsList          = std::make_unique<ChangedPluginsList>();
@@ -565,6 +568,13 @@ Edit::Edit (Options options)
 
     undoTransactionTimer = std::make_unique<UndoTransactionTimer> (*this);
 
+    // BEATCONNECT MODIFICATION START
+    if (shouldPlay())
+        autoFreezeManager = std::make_unique<AutoFreezeManager> (*this);
+
+    stateSnapshotter = std::make_unique<ValueTreeSnapshotter> (state);
+    // BEATCONNECT MODIFICATION END
+
     if (loadContext != nullptr && ! loadContext->shouldExit)
     {
         loadContext->completed = true;
@@ -603,10 +613,18 @@ Edit::~Edit()
     engine.getActiveEdits().edits.removeFirstMatchingValue (this);
     masterReference.clear();
     changeResetterTimer.reset();
+    // BEATCONNECT MODIFICATION START
+    autoFreezeManager.reset();
+    stateSnapshotter.reset();
+    // BEATCONNECT MODIFICATION END
 
     if (transportControl != nullptr)
         transportControl->freePlaybackContext();
 
+    // BEATCONNECT MODIFICATION START
+    parameterChangeQueue.reset();
+    // BEATCONNECT MODIFICATION END
+
     // must only delete an edit with the message thread locked - many things on the message thread may be in the
     // middle of using it at this point..
     jassert (juce::MessageManager::getInstance()->currentThreadHasLockedMessageManager());
@@ -710,6 +728,12 @@ void Edit::initialise()
     initialiseClickTrack();
     initialiseMetadata();
     initialiseMasterVolume();
+
+    // BEATCONNECT MODIFICATION START
+    if (shouldLoadPlugins())
+        engine.getPluginManager().getInstancePool().prepareForEdit (state, *this);
+    // BEATCONNECT MODIFICATION END
+
     initialiseRacks();
     initialiseMasterPlugins();
     initialiseAuxBusses();
@@ -721,6 +745,12 @@ void Edit::initialise()
 
     initialiseTracks();
     initialiseARA();
+
+    // BEATCONNECT MODIFICATION START
+    if (shouldLoadPlugins())
+        engine.getPluginManager().getInstancePool().removeUnusedPreparedInstances (*this);
+    // BEATCONNECT MODIFICATION END
+
     updateMuteSoloStatuses();
     readFrozenTracksFiles();
 
@@ -1027,6 +1057,26 @@ void Edit::flushState()
         araDocument->flushStateToValueTree();
 }
 
+// BEATCONNECT MODIFICATION START
+ValueTreeSnapshot::Ptr Edit::getStateSnapshot() const
+{
+    if (stateSnapshotter != nullptr)
+        return stateSnapshotter->getSnapshot();
+
+    return {};
+}
+
+ValueTreeSnapshot::Ptr Edit::updateStateSnapshot()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (stateSnapshotter != nullptr)
+        return stateSnapshotter->update();
+
+    return ValueTreeSnapshot::create (state);
+}
+// BEATCONNECT MODIFICATION END
+
 void Edit::flushPluginStateIfNeeded (Plugin& p)
 {
     changedPluginsList->flushPluginStateIfNeeded (p);
@@ -1084,6 +1134,17 @@ void Edit::warnOfWastedMidiMessages (InputDevice* d, Track* t)
     wastedMidiMessagesListeners.call (&WastedMidiMessagesListener::warnOfWastedMidiMessages, d, t);
 }
 
+//==============================================================================
+void Edit::setPreviewLevelMeasurer (SharedLevelMeasurer::Ptr p)
+{
+    previewLevelMeasurer = p;
+
+    // BEATCONNECT MODIFICATION START
+    if (previewLevelMeasurer != nullptr)
+        previewLevelMeasurer->setFreezeRequests (&engine.getDeviceManager().getOverloadPolicy().getMeterFreezeRequests());
+    // BEATCONNECT MODIFICATION END
+}
+
 //==============================================================================
 static juce::Array<SelectionManager*> getSelectionManagers (const Edit& ed)
 {
@@ -136,6 +136,18 @@ public:
 
     // BEATCONNECT MODIFICATION START
     std::function<juce::File()> recordFileRetriever;
+
+    /** If this is set, it's called when a wave input starts recording to a file.
+        Any sink it returns will be sent the recording as a sequence of FLAC
+        segments alongside the file, e.g. so they can be uploaded whilst recording.
+        @see SegmentedRecordingWriter, LocalDirectorySegmentSink
+    */
+    std::function<std::unique_ptr<RecordingSegmentSink> (const juce::File& recordedFile)> recordingSegmentSinkRetriever;
+
+    /** The options used for recording segments.
+        If the name is empty, the name of the recorded file is used.
+    */
+    SegmentedRecordingWriter::Options recordingSegmentOptions;
     // BEATCONNECT MODIFICATION END
 
     /** Sets the ProjectItemID of the Edit, this is also stored in the state. */
@@ -224,6 +236,11 @@ public:
     /** Quick way to find and iterate all Clip[s] in the Edit. */
     EditItemCache<Clip> clipCache;
 
+    // BEATCONNECT MODIFICATION START
+    /** Quick way to find and iterate all Plugin[s] in the Edit. */
+    EditItemCache<Plugin> pluginItemCache;
+    // BEATCONNECT MODIFICATION END
+
     //==============================================================================
     /** Returns the EditInputDevices for the Edit. */
     EditInputDevices& getEditInputDevices() noexcept;
@@ -248,6 +265,11 @@ public:
     /** Returns the ParameterControlMappings for the Edit. */
     ParameterControlMappings& getParameterControlMappings() noexcept    { return *parameterControlMappings; }
 
+    // BEATCONNECT MODIFICATION START
+    /** Returns the ParameterChangeQueue which passes parameter changes to the audio thread. */
+    ParameterChangeQueue& getParameterChangeQueue() noexcept            { return *parameterChangeQueue; }
+    // BEATCONNECT MODIFICATION END
+
     /** Returns the AutomationRecordManager for the Edit.
         Used to change automation read/write modes and start/stop automation recording.
     */
@@ -258,6 +280,27 @@ public:
     */
     AbletonLink& getAbletonLink() const noexcept                        { return *abletonLink; }
 
+    // BEATCONNECT MODIFICATION START
+    /** Returns the AutoFreezeManager which freezes expensive tracks in the background.
+        This will be nullptr for Edits that can't be played back.
+    */
+    AutoFreezeManager* getAutoFreezeManager() const noexcept            { return autoFreezeManager.get(); }
+
+    /** Returns the latest immutable snapshot of the Edit's state.
+        This can be called from any thread without locking and the snapshot can be read
+        whilst the Edit carries on changing, so background tasks should use this rather
+        than the state. It's updated asynchronously after changes so call
+        updateStateSnapshot() on the message thread if you need the very latest state.
+        This will be nullptr whilst the Edit is being constructed.
+    */
+    ValueTreeSnapshot::Ptr getStateSnapshot() const;
+
+    /** Brings the state snapshot up to date with any pending changes and returns it.
+        This must be called on the message thread.
+    */
+    ValueTreeSnapshot::Ptr updateStateSnapshot();
+    // BEATCONNECT MODIFICATION END
+
     //==============================================================================
     /**
         Temporarily removes an Edit from the device manager, optionally re-adding it on destruction.
@@ -773,7 +816,7 @@ public:
     SharedLevelMeasurer::Ptr getPreviewLevelMeasurer()          { return previewLevelMeasurer; }
 
     /** Sets a SharedLevelMeasurer to use. */
-    void setPreviewLevelMeasurer (SharedLevelMeasurer::Ptr p)   { previewLevelMeasurer = p; }
+    void setPreviewLevelMeasurer (SharedLevelMeasurer::Ptr);
 
     //==============================================================================
     juce::CachedValue<juce::String> lastSignificantChange;  /**< The last time a change was made to the Edit. @see getTimeOfLastChange */
@@ -836,6 +879,11 @@ private:
     std::unique_ptr<TrackCompManager> trackCompManager;
     juce::Array<ModifierTimer*, juce::CriticalSection> modifierTimers;
     std::unique_ptr<GlobalMacros> globalMacros;
+    // BEATCONNECT MODIFICATION START
+    std::unique_ptr<AutoFreezeManager> autoFreezeManager;
+    std::unique_ptr<ParameterChangeQueue> parameterChangeQueue;
+    std::unique_ptr<ValueTreeSnapshotter> stateSnapshotter;
+    // BEATCONNECT MODIFICATION END
 
     mutable std::optional<TimeDuration> totalEditLength;
     std::atomic<bool> isLoadInProgress { true };
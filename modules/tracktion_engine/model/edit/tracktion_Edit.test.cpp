@@ -122,6 +122,62 @@ public:
            #endif
         }
         
+        // BEATCONNECT MODIFICATION START
+        {
+            std::vector<EditItemID> trackIDs, clipIDs, pluginIDs;
+
+            for (auto t : getAllTracks (*edit))
+                trackIDs.push_back (t->itemID);
+
+            for (auto at : getAudioTracks (*edit))
+                for (auto c : at->getClips())
+                    clipIDs.push_back (c->itemID);
+
+            for (auto p : getAllPlugins (*edit, true))
+                pluginIDs.push_back (p->itemID);
+
+            [[ maybe_unused ]] int numFound = 0;
+
+            {
+                ScopedBenchmark sb (getDescription ("Find " + std::to_string (trackIDs.size()) + " tracks by ID"));
+
+                for (auto id : trackIDs)
+                    numFound += findTrackForID (*edit, id) != nullptr ? 1 : 0;
+            }
+
+            {
+                ScopedBenchmark sb (getDescription ("Find " + std::to_string (clipIDs.size()) + " clips by ID"));
+
+                for (auto id : clipIDs)
+                    numFound += findClipForID (*edit, id) != nullptr ? 1 : 0;
+            }
+
+            {
+                ScopedBenchmark sb (getDescription ("Find " + std::to_string (pluginIDs.size()) + " plugins by ID"));
+
+                for (auto id : pluginIDs)
+                    numFound += findPluginForID (*edit, id) != nullptr ? 1 : 0;
+            }
+
+            jassert (numFound == (int) (trackIDs.size() + clipIDs.size() + pluginIDs.size()));
+
+            {
+                uint64_t maxID = 0;
+
+                for (auto ids : { &trackIDs, &clipIDs, &pluginIDs })
+                    for (auto id : *ids)
+                        maxID = std::max (maxID, id.getRawID());
+
+                ScopedBenchmark sb (getDescription ("Look up 10,000 missing clip IDs"));
+
+                for (uint64_t i = 1; i <= 10'000; ++i)
+                    numFound += findClipForID (*edit, EditItemID::fromRawID (maxID + i)) != nullptr ? 1 : 0;
+            }
+
+            jassert (numFound == (int) (trackIDs.size() + clipIDs.size() + pluginIDs.size()));
+        }
+        // BEATCONNECT MODIFICATION END
+
         {
             auto editStateCopy = edit->state.createCopy();
             
@@ -23,13 +23,15 @@ struct ThreadedEditFileWriter   : private juce::Thread
         jassert (pending.isEmpty());
     }
 
-    void writeTreeToFile (juce::ValueTree&& v, const juce::File& f)
+    // BEATCONNECT MODIFICATION START
+    void writeTreeToFile (ValueTreeSnapshot::Ptr v, const juce::File& f)
     {
         TRACKTION_ASSERT_MESSAGE_THREAD
-        pending.add (std::pair<juce::ValueTree, juce::File> (v, f));
+        pending.add (std::pair<ValueTreeSnapshot::Ptr, juce::File> (std::move (v), f));
         waiter.signal();
         startThread();
     }
+    // BEATCONNECT MODIFICATION END
 
     void flushAllFiles()
     {
@@ -53,14 +55,16 @@ private:
         }
     }
 
-    void writeToFile (std::pair<juce::ValueTree, juce::File> item)
+    // BEATCONNECT MODIFICATION START
+    void writeToFile (std::pair<ValueTreeSnapshot::Ptr, juce::File> item)
     {
         item.second.deleteFile();
         juce::FileOutputStream os (item.second);
-        item.first.writeToStream (os);
+        item.first->writeToStream (os);
     }
 
-    juce::Array<std::pair<juce::ValueTree, juce::File>, juce::CriticalSection> pending;
+    juce::Array<std::pair<ValueTreeSnapshot::Ptr, juce::File>, juce::CriticalSection> pending;
+    // BEATCONNECT MODIFICATION END
     juce::WaitableEvent waiter;
 };
 
@@ -140,10 +144,12 @@ struct EditFileOperations::SharedDataPimpl
         cache->cleanUp();
     }
 
-    void writeValueTreeToDisk (juce::ValueTree&& v, const juce::File& f)
+    // BEATCONNECT MODIFICATION START
+    void writeValueTreeToDisk (ValueTreeSnapshot::Ptr v, const juce::File& f)
     {
         editFileWriter->writeTreeToFile (std::move (v), f);
     }
+    // BEATCONNECT MODIFICATION END
 
     juce::SharedResourcePointer<SharedEditFileDataCache> cache;
     std::shared_ptr<SharedEditFileDataCache::Data> data;
@@ -186,14 +192,19 @@ bool EditFileOperations::writeToFile (const juce::File& file, bool writeQuickBin
     {
         if (writeQuickBinaryVersion)
         {
-            sharedDataPimpl->writeValueTreeToDisk (edit.state.createCopy(), file);
+            // BEATCONNECT MODIFICATION START
+            // The snapshot is immutable so can be written on the background thread without copying the state
+            sharedDataPimpl->writeValueTreeToDisk (edit.updateStateSnapshot(), file);
+            // BEATCONNECT MODIFICATION END
         }
         else
         {
             edit.flushState();
 
+            // BEATCONNECT MODIFICATION START
             if (editSnapshot != nullptr)
-                editSnapshot->setState (edit.state, edit.getLength());
+                editSnapshot->setState (edit.updateStateSnapshot(), edit.getLength());
+            // BEATCONNECT MODIFICATION END
 
             if (auto xml = edit.state.createXml())
                 ok = xml->writeTo (file);
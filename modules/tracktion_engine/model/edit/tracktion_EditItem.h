@@ -120,6 +120,25 @@ struct EditItemCache
         return {};
     }
 
+    // BEATCONNECT MODIFICATION START
+    /** Returns the first item with the given ID that matches a predicate.
+        There can be more than one object alive with the same ID, for example if one
+        has been removed from the Edit but is still referenced somewhere, so this
+        can be used to pick the one that's actually in use.
+    */
+    template<typename Predicate>
+    EditItemType* findItem (EditItemID id, Predicate&& predicate) const
+    {
+        auto range = knownEditItems.equal_range (id);
+
+        for (auto o = range.first; o != range.second; ++o)
+            if (predicate (*o->second))
+                return o->second;
+
+        return {};
+    }
+    // BEATCONNECT MODIFICATION END
+
     template<typename Visitor>
     void visitItems (Visitor&& visitor) const
     {
@@ -127,22 +146,33 @@ struct EditItemCache
             std::forward<Visitor> (visitor)(iter.second);
     }
 
+    // BEATCONNECT MODIFICATION START
     void addItem (EditItemType& item)
     {
-        jassert (knownEditItems.find (item.itemID) == knownEditItems.end());
-
         if (item.itemID.isValid())
-            knownEditItems[item.itemID] = &item;
+            knownEditItems.emplace (item.itemID, &item);
     }
 
     void removeItem (EditItemType& item)
     {
-        if (item.itemID.isValid())
-            knownEditItems.erase (item.itemID);
+        if (! item.itemID.isValid())
+            return;
+
+        auto range = knownEditItems.equal_range (item.itemID);
+
+        for (auto o = range.first; o != range.second; ++o)
+        {
+            if (o->second == &item)
+            {
+                knownEditItems.erase (o);
+                break;
+            }
+        }
     }
 
 private:
-    std::map<EditItemID, EditItemType*> knownEditItems;
+    std::unordered_multimap<EditItemID, EditItemType*> knownEditItems;
+    // BEATCONNECT MODIFICATION END
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EditItemCache)
 };
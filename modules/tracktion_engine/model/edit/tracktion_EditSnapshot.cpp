@@ -84,20 +84,23 @@ EditSnapshot::~EditSnapshot()
     listHolder->list->removeSnapshot (*this);
 }
 
-void EditSnapshot::setState (juce::ValueTree newState, TimeDuration editLength)
+// BEATCONNECT MODIFICATION START
+void EditSnapshot::setState (ValueTreeSnapshot::Ptr newState, TimeDuration editLength)
 {
-    if (state.getReferenceCount() == 1)
-        state = std::move (newState);
-    else
-        state = newState.createCopy();
-
+    state = std::move (newState);
     length = editLength.inSeconds();
 }
 
+void EditSnapshot::setState (const juce::ValueTree& newState, TimeDuration editLength)
+{
+    setState (ValueTreeSnapshot::create (newState), editLength);
+}
+
 bool EditSnapshot::isValid() const
 {
-    return state.hasType (IDs::EDIT);
+    return state != nullptr && state->hasType (IDs::EDIT);
 }
+// BEATCONNECT MODIFICATION END
 
 void EditSnapshot::refreshCacheAndNotifyListeners()
 {
@@ -105,21 +108,22 @@ void EditSnapshot::refreshCacheAndNotifyListeners()
     listeners.call (&Listener::editChanged, *this);
 }
 
-void EditSnapshot::addSubTracksRecursively (const juce::XmlElement& parent, int& audioTrackNameNumber)
+// BEATCONNECT MODIFICATION START
+void EditSnapshot::addSubTracksRecursively (const ValueTreeSnapshot& parent, int& audioTrackNameNumber)
 {
-    for (auto track : parent.getChildIterator())
+    for (auto& track : parent.getChildren())
     {
-        juce::Identifier trackType (track->getTagName());
+        auto trackType = track->getType();
 
         if (! TrackList::isTrack (trackType))
             continue;
 
-        auto trackName = track->getStringAttribute (IDs::name);
-        trackIDs.add (EditItemID::fromXML (*track, IDs::id));
+        auto trackName = track->getProperty (IDs::name).toString();
+        trackIDs.add (EditItemID::fromVar (track->getProperty (IDs::id)));
 
-        mutedTracks.setBit (numTracks, track->getBoolAttribute (IDs::mute, false));
-        soloedTracks.setBit (numTracks, track->getBoolAttribute (IDs::solo, false));
-        soloIsolatedTracks.setBit (numTracks, track->getBoolAttribute (IDs::soloIsolate, false));
+        mutedTracks.setBit (numTracks, track->getProperty (IDs::mute, false));
+        soloedTracks.setBit (numTracks, track->getProperty (IDs::solo, false));
+        soloIsolatedTracks.setBit (numTracks, track->getProperty (IDs::soloIsolate, false));
 
         if (trackType == IDs::TRACK || trackType == IDs::MARKERTRACK)
         {
@@ -146,23 +150,23 @@ void EditSnapshot::addSubTracksRecursively (const juce::XmlElement& parent, int&
     }
 }
 
-void EditSnapshot::refreshFromXml (const juce::XmlElement& xml,
-                                   const juce::String& newName, double newLength)
+void EditSnapshot::refreshFromSnapshot (const ValueTreeSnapshot& editState,
+                                        const juce::String& newName, double newLength)
 {
     clear();
     name = newName;
     length = newLength;
 
     // last significant change
-    auto changeHexString = xml.getStringAttribute (IDs::lastSignificantChange);
+    auto changeHexString = editState.getProperty (IDs::lastSignificantChange).toString();
     lastSaveTime = changeHexString.isEmpty() ? sourceFile.getLastModificationTime()
                                              : juce::Time (changeHexString.getHexValue64());
 
     // marks
-    if (auto viewState = xml.getChildByName (IDs::TRANSPORT))
+    if (auto viewState = editState.getChildWithName (IDs::TRANSPORT))
     {
-        auto loopRange = juce::Range<double>::between (viewState->getDoubleAttribute (IDs::loopPoint1),
-                                                       viewState->getDoubleAttribute (IDs::loopPoint2));
+        auto loopRange = juce::Range<double>::between (viewState->getProperty (IDs::loopPoint1),
+                                                       viewState->getProperty (IDs::loopPoint2));
         markIn = loopRange.getStart();
         markOut = loopRange.getEnd();
 
@@ -170,29 +174,30 @@ void EditSnapshot::refreshFromXml (const juce::XmlElement& xml,
     }
 
     // tempo, time sig & pitch
-    if (auto tempoSeq = xml.getChildByName (IDs::TEMPOSEQUENCE))
+    if (auto tempoSeq = editState.getChildWithName (IDs::TEMPOSEQUENCE))
     {
-        if (auto tempoItem = tempoSeq->getChildByName (IDs::TEMPO))
-            tempo = tempoItem->getDoubleAttribute (IDs::bpm);
+        if (auto tempoItem = tempoSeq->getChildWithName (IDs::TEMPO))
+            tempo = tempoItem->getProperty (IDs::bpm);
 
-        if (auto timeSigItem = tempoSeq->getChildByName (IDs::TIMESIG))
+        if (auto timeSigItem = tempoSeq->getChildWithName (IDs::TIMESIG))
         {
-            timeSigNumerator    = timeSigItem->getIntAttribute (IDs::numerator);
-            timeSigDenominator  = timeSigItem->getIntAttribute (IDs::denominator);
+            timeSigNumerator    = timeSigItem->getProperty (IDs::numerator);
+            timeSigDenominator  = timeSigItem->getProperty (IDs::denominator);
         }
     }
 
-    if (auto pitchSeq = xml.getChildByName (IDs::PITCHSEQUENCE))
-        if (auto pitchItem = pitchSeq->getChildByName (IDs::PITCH))
-            pitch = pitchItem->getIntAttribute (IDs::pitch);
+    if (auto pitchSeq = editState.getChildWithName (IDs::PITCHSEQUENCE))
+        if (auto pitchItem = pitchSeq->getChildWithName (IDs::PITCH))
+            pitch = pitchItem->getProperty (IDs::pitch);
 
     // tracks
-    trackNames.ensureStorageAllocated (xml.getNumChildElements());
+    trackNames.ensureStorageAllocated (editState.getNumChildren());
 
     int audioTrackNameNumber = 1;
-    addSubTracksRecursively (xml, audioTrackNameNumber);
+    addSubTracksRecursively (editState, audioTrackNameNumber);
     numAudioTracks = audioTracks.countNumberOfSetBits();
 }
+// BEATCONNECT MODIFICATION END
 
 int EditSnapshot::audioToGlobalTrackIndex (int audioIndex) const
 {
@@ -221,7 +226,14 @@ void EditSnapshot::refreshFromProjectItem (ProjectItem::Ptr pi)
         return;
 
     sourceFile = pi->getSourceFile();
-    auto newState = loadValueTree (sourceFile, true);
+
+    // BEATCONNECT MODIFICATION START
+    // Loading this in the same way as an Edit means the saved state can be used to create one directly
+    if (! sourceFile.existsAsFile() || sourceFile.getSize() == 0)
+        return;
+
+    auto newState = loadEditFromFile (engine, sourceFile, itemID);
+    // BEATCONNECT MODIFICATION END
 
     if (! newState.hasType (IDs::EDIT))
         return;
@@ -231,15 +243,19 @@ void EditSnapshot::refreshFromProjectItem (ProjectItem::Ptr pi)
     refreshFromState();
 }
 
+// BEATCONNECT MODIFICATION START
 void EditSnapshot::refreshFromState()
 {
     auto editName = name;
     auto editLength = length;
     clear();
 
-    if (auto xml = state.createXml())
-        refreshFromXml (*xml, editName, editLength);
+    if (state != nullptr)
+        refreshFromSnapshot (*state, editName, editLength);
+
+    std::atomic_store (&savedState, state);
 }
+// BEATCONNECT MODIFICATION END
 
 void EditSnapshot::clear()
 {
@@ -263,39 +279,41 @@ void EditSnapshot::clear()
     markers.clear();
 }
 
-void EditSnapshot::addEditClips (const juce::XmlElement& track)
+// BEATCONNECT MODIFICATION START
+void EditSnapshot::addEditClips (const ValueTreeSnapshot& track)
 {
-    for (auto clip : track.getChildIterator())
-        if (clip->hasTagName (IDs::EDITCLIP))
-            editClipIDs.add (ProjectItemID (clip->getStringAttribute ("source")));
+    for (auto& clip : track.getChildren())
+        if (clip->hasType (IDs::EDITCLIP))
+            editClipIDs.add (ProjectItemID (clip->getProperty ("source").toString()));
 }
 
-void EditSnapshot::addClipSources (const juce::XmlElement& track)
+void EditSnapshot::addClipSources (const ValueTreeSnapshot& track)
 {
-    for (auto clip : track.getChildIterator())
+    for (auto& clip : track.getChildren())
     {
-        auto sourceID = clip->getStringAttribute ("source");
+        auto sourceID = clip->getProperty ("source").toString();
 
         if (sourceID.isNotEmpty())
             clipSourceIDs.add (ProjectItemID (sourceID));
     }
 }
 
-void EditSnapshot::addMarkers (const juce::XmlElement& track)
+void EditSnapshot::addMarkers (const ValueTreeSnapshot& track)
 {
-    for (auto clip : track.getChildIterator())
+    for (auto& clip : track.getChildren())
     {
         Marker m;
-        m.name      = clip->getStringAttribute ("name", TRANS("unnamed"));
-        m.colour    = juce::Colour::fromString (clip->getStringAttribute ("colour", TRANS("unnamed")));
-        auto start  = TimePosition::fromSeconds (clip->getDoubleAttribute ("start", 0.0));
-        auto len    = TimeDuration::fromSeconds (clip->getDoubleAttribute ("length", 0.0));
+        m.name      = clip->getProperty ("name", TRANS("unnamed")).toString();
+        m.colour    = juce::Colour::fromString (clip->getProperty ("colour", TRANS("unnamed")).toString());
+        auto start  = TimePosition::fromSeconds (static_cast<double> (clip->getProperty ("start", 0.0)));
+        auto len    = TimeDuration::fromSeconds (static_cast<double> (clip->getProperty ("length", 0.0)));
         m.time      = { start, start + len };
 
         if (len > 0s)
             markers.add (m);
     }
 }
+// BEATCONNECT MODIFICATION END
 
 
 static void addNestedEditObjects (EditSnapshot& baseEdit, juce::ReferenceCountedArray<EditSnapshot>& edits)
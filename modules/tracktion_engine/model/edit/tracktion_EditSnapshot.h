@@ -40,20 +40,38 @@ public:
     /** Returns the File if this was created from one. */
     juce::File getFile() const                          { return sourceFile; }
 
-    /** Returns the source Xml. */
-    juce::ValueTree getState() noexcept                 { return state; }
+    // BEATCONNECT MODIFICATION START
+    /** Returns a copy of the source state.
+        This creates a new ValueTree so use getStateSnapshot() if you only need to read it.
+    */
+    juce::ValueTree getState() const                    { return state != nullptr ? state->createCopy() : juce::ValueTree(); }
+
+    /** Returns the source state without copying it.
+        This is immutable so can be read from any thread.
+    */
+    ValueTreeSnapshot::Ptr getStateSnapshot() const noexcept    { return state; }
 
-    /** Sets the Edit XML that the XmlEdit should refer to.
-        This will take ownership of the XmlElement so don't hang on to it.
-        Once this is set you can retrieve the Xml for saving etc. using getXml().
-        As the length isn't stored in the Xml we need to provide it.
+    /** Returns the state of the Edit as it was last saved.
+        This is immutable so can be read from any thread, e.g. to load the Edit for rendering
+        without having to parse the file again.
+    */
+    ValueTreeSnapshot::Ptr getSavedState() const        { return std::atomic_load (&savedState); }
+
+    /** Sets the Edit state that the EditSnapshot should refer to.
+        This is usually the Edit's state snapshot so doesn't need to be copied.
+        Once this is set you can retrieve it for saving etc. using getStateSnapshot().
+        As the length isn't stored in the state we need to provide it.
 
         Note that this DOES NOT update the cached properties, once the Xml has been set call
         refreshCacheAndSave to update these. Although this seems a bit convoluted it's how the
         temp Edit files work so we need to follow this. It means that this will hold up-to-date
         Xml but only cached properties of the last save which can be used in things like EditClips.
     */
-    void setState (juce::ValueTree, TimeDuration editLength);
+    void setState (ValueTreeSnapshot::Ptr, TimeDuration editLength);
+
+    /** Sets the Edit state from a ValueTree, taking a copy of it. */
+    void setState (const juce::ValueTree&, TimeDuration editLength);
+    // BEATCONNECT MODIFICATION END
 
     /** Returns true if the current source is a valid Edit. */
     bool isValid() const;
@@ -116,7 +134,9 @@ private:
 
     ProjectItemID itemID;
     juce::File sourceFile;
-    juce::ValueTree state;
+    // BEATCONNECT MODIFICATION START
+    ValueTreeSnapshot::Ptr state, savedState;
+    // BEATCONNECT MODIFICATION END
     juce::Time lastSaveTime;
 
     juce::String name;
@@ -136,13 +156,15 @@ private:
     //==============================================================================
     EditSnapshot (Engine&, ProjectItemID);
     void refreshFromProjectItem (ProjectItem::Ptr);
-    void refreshFromXml (const juce::XmlElement&, const juce::String&, double newLength);
+    // BEATCONNECT MODIFICATION START
+    void refreshFromSnapshot (const ValueTreeSnapshot&, const juce::String&, double newLength);
     void refreshFromState();
     void clear();
-    void addEditClips (const juce::XmlElement& track);
-    void addClipSources (const juce::XmlElement& track);
-    void addMarkers (const juce::XmlElement& track);
-    void addSubTracksRecursively (const juce::XmlElement& parent, int& audioTrackNameNumber);
+    void addEditClips (const ValueTreeSnapshot& track);
+    void addClipSources (const ValueTreeSnapshot& track);
+    void addMarkers (const ValueTreeSnapshot& track);
+    void addSubTracksRecursively (const ValueTreeSnapshot& parent, int& audioTrackNameNumber);
+    // BEATCONNECT MODIFICATION END
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EditSnapshot)
 };
@@ -61,6 +61,19 @@ void insertSpaceIntoEditFromBeatRange (Edit& edit, BeatRange beatRange)
 }
 
 //==============================================================================
+// BEATCONNECT MODIFICATION START
+namespace
+{
+    /** Returns true if an item's state is currently part of the Edit, rather than
+        belonging to an object that's been removed but is still referenced somewhere.
+    */
+    bool isStateInEdit (const Edit& edit, const juce::ValueTree& v)
+    {
+        return v.isAChildOf (edit.state);
+    }
+}
+// BEATCONNECT MODIFICATION END
+
 juce::Array<Track*> getAllTracks (const Edit& edit)
 {
     juce::Array<Track*> tracks;
@@ -94,7 +107,9 @@ int getTotalNumTracks (const Edit& edit)
 
 Track* findTrackForID (const Edit& edit, EditItemID id)
 {
-    return findTrackForPredicate (edit, [id] (Track& t) { return t.itemID == id; });
+    // BEATCONNECT MODIFICATION START
+    return edit.trackCache.findItem (id, [&edit] (Track& t) { return isStateInEdit (edit, t.state); });
+    // BEATCONNECT MODIFICATION END
 }
 
 juce::Array<Track*> findTracksForIDs (const Edit& edit, const juce::Array<EditItemID>& ids)
@@ -114,7 +129,9 @@ juce::Array<Track*> findTracksForIDs (const Edit& edit, const juce::Array<EditIt
 
 Track* findTrackForState (const Edit& edit, const juce::ValueTree& v)
 {
-    return findTrackForPredicate (edit, [&] (Track& t) { return t.state == v; });
+    // BEATCONNECT MODIFICATION START
+    return edit.trackCache.findItem (EditItemID::fromID (v), [&] (Track& t) { return t.state == v && isStateInEdit (edit, v); });
+    // BEATCONNECT MODIFICATION END
 }
 
 AudioTrack* getFirstAudioTrack (const Edit& edit)
@@ -124,7 +141,9 @@ AudioTrack* getFirstAudioTrack (const Edit& edit)
 
 bool containsTrack (const Edit& edit, const Track& track)
 {
-    return findTrackForPredicate (edit, [&track] (Track& t) { return &track == &t; }) != nullptr;
+    // BEATCONNECT MODIFICATION START
+    return findTrackForID (edit, track.itemID) == &track;
+    // BEATCONNECT MODIFICATION END
 }
 
 TrackOutput* getTrackOutput (Track& track)
@@ -582,20 +601,15 @@ juce::Array<ClipEffect*> getAllClipEffects (Edit& edit)
 //==============================================================================
 Clip* findClipForID (const Edit& edit, EditItemID clipID)
 {
-    Clip* result = nullptr;
-
-    edit.visitAllTracksRecursive ([&] (Track& t)
-                                  {
-                                      if (auto c = t.findClipForID (clipID))
-                                      {
-                                          result = c;
-                                          return false;
-                                      }
-
-                                      return true;
-                                  });
-
-    return result;
+    // BEATCONNECT MODIFICATION START
+    // Only clips that live directly on a track are found, not those inside other clips
+    return edit.clipCache.findItem (clipID, [&edit] (Clip& c)
+                                    {
+                                        return c.getClipTrack() != nullptr
+                                            && TrackList::isTrack (c.state.getParent())
+                                            && isStateInEdit (edit, c.state);
+                                    });
+    // BEATCONNECT MODIFICATION END
 }
 
 Clip* findClipForState (const Edit& edit, const juce::ValueTree& v)
@@ -792,11 +806,9 @@ Plugin::Ptr findPluginForState (const Edit& edit, const juce::ValueTree& v)
 
 Plugin::Ptr findPluginForID (const Edit& edit, EditItemID id)
 {
-    for (auto p : getAllPlugins (edit, true))
-        if (p->itemID == id)
-            return p;
-
-    return {};
+    // BEATCONNECT MODIFICATION START
+    return edit.pluginItemCache.findItem (id, [&edit] (Plugin& p) { return isStateInEdit (edit, p.state); });
+    // BEATCONNECT MODIFICATION END
 }
 
 Track* getTrackContainingPlugin (const Edit& edit, const Plugin* p)
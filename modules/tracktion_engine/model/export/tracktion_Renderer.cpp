@@ -197,11 +197,27 @@ bool Renderer::RenderTask::performNormalisingAndTrimming (const Renderer::Parame
                                                + doneRange.getStart());
     }
 
-    if (target.shouldNormalise || target.shouldNormaliseByRMS)
+    if (target.shouldNormalise || target.shouldNormaliseByRMS || target.shouldNormaliseByLoudness)
         setJobName (TRANS("Normalising") + "...");
 
-    std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (params.edit->engine,
-                                                                                      intermediate.destFile));
+    std::unique_ptr<juce::AudioFormatReader> reader;
+
+    // BEATCONNECT MODIFICATION START
+    // The levels were measured whilst rendering so this is the only pass over the
+    // intermediate file. Mapping it avoids copying it through a stream.
+    {
+        juce::AudioFormat* mappedFormat = nullptr;
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader (AudioFileUtils::createMemoryMappedReader (params.edit->engine,
+                                                                                                                    intermediate.destFile,
+                                                                                                                    mappedFormat));
+
+        if (mappedReader != nullptr && mappedReader->mapEntireFile())
+            reader = std::move (mappedReader);
+    }
+    // BEATCONNECT MODIFICATION END
+
+    if (reader == nullptr)
+        reader.reset (AudioFileUtils::createReaderFor (params.edit->engine, intermediate.destFile));
 
     if (reader == nullptr)
     {
@@ -226,6 +242,14 @@ bool Renderer::RenderTask::performNormalisingAndTrimming (const Renderer::Parame
         gain = juce::jlimit (0.0f, 100.0f, dbToGain (target.normaliseToLevelDb) / (intermediate.resultRMS + 2.0f / 32768.0f));
     else if (target.shouldNormalise)
         gain = juce::jlimit (0.0f, 100.0f, dbToGain (target.normaliseToLevelDb) * (1.0f / (intermediate.resultMagnitude * 1.005f + 2.0f / 32768.0f)));
+    // BEATCONNECT MODIFICATION START
+    else if (target.shouldNormaliseByLoudness)
+        gain = juce::jlimit (0.0f, 100.0f, dbToGain (LoudnessMeter::getNormalisingGainDb (intermediate.resultLoudness,
+                                                                                          target.normaliseToLoudness,
+                                                                                          target.maxTruePeakDb)));
+
+    params.resultLoudness = intermediate.resultLoudness.withGain (gainToDb (gain));
+    // BEATCONNECT MODIFICATION END
 
     Ditherers ditherers ((int) reader->numChannels, target.bitDepth);
 
@@ -585,6 +609,9 @@ Renderer::Statistics Renderer::measureStatistics (const juce::String& taskDescri
             result.peak          = task->params.resultMagnitude;
             result.average       = task->params.resultRMS;
             result.audioDuration = task->params.resultAudioDuration;
+            // BEATCONNECT MODIFICATION START
+            result.loudness      = task->params.resultLoudness;
+            // BEATCONNECT MODIFICATION END
         }
     }
 
@@ -59,6 +59,15 @@ public:
         bool shouldNormalise = false;
         bool shouldNormaliseByRMS = false;
         float normaliseToLevelDb = 0;
+
+        // BEATCONNECT MODIFICATION START
+        /** Normalises the integrated loudness to normaliseToLoudness, in LUFS,
+            without letting the true-peak level go above maxTruePeakDb.
+        */
+        bool shouldNormaliseByLoudness = false;
+        float normaliseToLoudness = -14.0f;
+        float maxTruePeakDb = -1.0f;
+        // BEATCONNECT MODIFICATION END
         bool canRenderInMono = true;
         bool mustRenderInMono = false;
         bool usePlugins = true;
@@ -75,6 +84,13 @@ public:
         float resultMagnitude = 0;
         float resultRMS = 0;
         float resultAudioDuration = 0;
+
+        // BEATCONNECT MODIFICATION START
+        /** The loudness of the rendered file, measured whilst rendering and
+            adjusted for any normalisation.
+        */
+        LoudnessMeter::Result resultLoudness;
+        // BEATCONNECT MODIFICATION END
     };
 
     //==============================================================================
@@ -166,6 +182,10 @@ public:
         float peak = 0;
         float average = 0;
         float audioDuration = 0;
+
+        // BEATCONNECT MODIFICATION START
+        LoudnessMeter::Result loudness;
+        // BEATCONNECT MODIFICATION END
     };
 
     /** Renders a section of an edit to measure various details about its audio content */
@@ -186,17 +206,23 @@ public:
         }
 
         RenderResult (const RenderResult& other)
-            : result (other.result), items (other.items) {}
+            : result (other.result), items (other.items), loudness (other.loudness) {}
 
         RenderResult& operator= (const RenderResult& other)
         {
             result = other.result;
             items = other.items;
+            loudness = other.loudness;
             return *this;
         }
 
         juce::Result result;
         juce::ReferenceCountedArray<ProjectItem> items;
+
+        // BEATCONNECT MODIFICATION START
+        /** The loudness of the rendered audio. If several files were rendered this is the last one. */
+        LoudnessMeter::Result loudness;
+        // BEATCONNECT MODIFICATION END
     };
 };
 
@@ -95,6 +95,127 @@ public:
 
 static TrackFreezeTests trackFreezeTests;
 
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+//==============================================================================
+class RendererLoudnessTests  : public juce::UnitTest
+{
+public:
+    RendererLoudnessTests()
+        : juce::UnitTest ("Renderer loudness", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+        const double sampleRate = 44100.0;
+
+        // A 10s stereo 1kHz sine at -30dBFS
+        juce::TemporaryFile sourceFile (".wav");
+
+        {
+            juce::AudioBuffer<float> buffer (2, (int) (sampleRate * 10.0));
+
+            for (int c = 0; c < buffer.getNumChannels(); ++c)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (c, i, dbToGain (-30.0f) * (float) std::sin (juce::MathConstants<double>::twoPi * 1000.0 * i / sampleRate));
+
+            std::unique_ptr<juce::AudioFormatWriter> writer (juce::WavAudioFormat().createWriterFor (sourceFile.getFile().createOutputStream().release(),
+                                                                                                    sampleRate, 2, 32, {}, 0));
+            expect (writer != nullptr);
+            writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+        }
+
+        auto edit = test_utilities::createTestEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+        track->insertWaveClip ("sine", sourceFile.getFile(), {{ 0_tp, TimeDuration::fromSeconds (10.0) }}, false);
+
+        beginTest ("Measuring");
+        {
+            // The pan law may change the level but a stereo sine's loudness is always its peak level
+            auto stats = Renderer::measureStatistics ("Loudness", *edit, { 0_tp, TimePosition::fromSeconds (10.0) },
+                                                      toBitSet (getAllTracks (*edit)), 512, sampleRate);
+            expectWithinAbsoluteError (stats.loudness.truePeak, gainToDb (stats.peak), 0.2f);
+            expectWithinAbsoluteError (stats.loudness.integratedLoudness, stats.loudness.truePeak, 0.2f);
+            expectWithinAbsoluteError (stats.loudness.loudnessRange, 0.0f, 0.2f);
+
+            auto r = render (*edit, sampleRate, std::nullopt, -1.0f);
+            expectWithinAbsoluteError (r.integratedLoudness, stats.loudness.integratedLoudness, 0.01f);
+        }
+
+        beginTest ("Normalising to a target loudness");
+        {
+            juce::TemporaryFile outputFile (".wav");
+            auto r = render (*edit, sampleRate, -16.0f, -1.0f, outputFile.getFile());
+            expectWithinAbsoluteError (r.integratedLoudness, -16.0f, 0.2f);
+            expectWithinAbsoluteError (measureFile (engine, outputFile.getFile()).integratedLoudness, -16.0f, 0.2f,
+                                       "The file should be at the reported loudness");
+        }
+
+        beginTest ("Normalising with a true-peak ceiling");
+        {
+            // Reaching 0 LUFS would take the peaks to 0dBTP so it should stop at the ceiling
+            juce::TemporaryFile outputFile (".wav");
+            auto r = render (*edit, sampleRate, 0.0f, -1.0f, outputFile.getFile());
+            expectWithinAbsoluteError (r.truePeak, -1.0f, 0.2f);
+            expectWithinAbsoluteError (r.integratedLoudness, -1.0f, 0.2f);
+
+            auto fileResult = measureFile (engine, outputFile.getFile());
+            expectWithinAbsoluteError (fileResult.truePeak, -1.0f, 0.2f);
+        }
+    }
+
+private:
+    LoudnessMeter::Result render (Edit& edit, double sampleRate, std::optional<float> targetLoudness,
+                                  float maxTruePeakDb, juce::File destFile = {})
+    {
+        Renderer::Parameters r (edit);
+        r.destFile = destFile;
+        r.audioFormat = edit.engine.getAudioFileFormatManager().getDefaultFormat();
+        r.bitDepth = 32;
+        r.blockSizeForAudio = 512;
+        r.sampleRateForAudio = sampleRate;
+        r.time = { 0_tp, TimePosition::fromSeconds (10.0) };
+        r.tracksToDo = toBitSet (getAllTracks (edit));
+        r.canRenderInMono = false;
+        r.shouldNormaliseByLoudness = targetLoudness.has_value();
+        r.normaliseToLoudness = targetLoudness.value_or (0.0f);
+        r.maxTruePeakDb = maxTruePeakDb;
+
+        auto task = render_utils::createRenderTask (r, "Loudness", nullptr, nullptr);
+        expect (task != nullptr);
+
+        while (task->runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+        {}
+
+        expect (task->errorMessage.isEmpty());
+        return task->params.resultLoudness;
+    }
+
+    LoudnessMeter::Result measureFile (Engine& engine, const juce::File& file)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, file));
+
+        if (reader == nullptr)
+        {
+            expect (false, "Couldn't read the rendered file");
+            return {};
+        }
+
+        juce::AudioBuffer<float> buffer ((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+
+        LoudnessMeter meter;
+        meter.prepare (reader->sampleRate, buffer.getNumChannels());
+        meter.process (buffer, 0, buffer.getNumSamples());
+        return meter.getResult();
+    }
+};
+
+static RendererLoudnessTests rendererLoudnessTests;
+// BEATCONNECT MODIFICATION END
+
 #endif
 
 }} // namespace tracktion { inline namespace engine
@@ -741,16 +741,15 @@ bool AudioTrack::mergeInMidiSequence (const juce::MidiMessageSequence& original,
 
     if (mc == nullptr)
     {
-        for (auto c : getClips())
+        // BEATCONNECT MODIFICATION START
+        for (auto c : getClipsInRange ({ start, end }))
         {
-            if (c->getPosition().time.overlaps ({ start, end }))
-            {
-                mc = dynamic_cast<MidiClip*> (c);
+            mc = dynamic_cast<MidiClip*> (c);
 
-                if (mc != nullptr)
-                    break;
-            }
+            if (mc != nullptr)
+                break;
         }
+        // BEATCONNECT MODIFICATION END
     }
 
     if (mc != nullptr)
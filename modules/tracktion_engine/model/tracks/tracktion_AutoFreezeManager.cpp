@@ -0,0 +1,713 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+AutoFreezeManager::AutoFreezeManager (Edit& e)
+    : edit (e)
+{
+    edit.state.addListener (this);
+
+    auto opts = options;
+    opts.enabled = edit.engine.getEngineBehaviour().shouldAutoFreezeExpensiveTracks (edit);
+    setOptions (opts);
+}
+
+AutoFreezeManager::~AutoFreezeManager()
+{
+    stopTimer();
+    edit.state.removeListener (this);
+
+    for (auto& info : tracks)
+    {
+        cancelRender (info);
+
+        if (info.frozen)
+            setPluginsAutoFrozen (info.frozen->frozenPlugins, false);
+
+        // Only the current freeze files are kept for when the Edit is reloaded
+        staleFiles.addArray (info.cachedFiles);
+    }
+
+    deleteStaleFiles();
+}
+
+void AutoFreezeManager::setOptions (const Options& newOptions)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    options = newOptions;
+
+    if (options.enabled)
+    {
+        startTimer (1000);
+    }
+    else
+    {
+        stopTimer();
+        unfreezeAll();
+    }
+}
+
+//==============================================================================
+std::optional<AutoFreezeManager::FrozenTrack> AutoFreezeManager::getFrozenTrack (const AudioTrack& at) const
+{
+    if (auto info = getInfo (at.itemID))
+        return info->frozen;
+
+    return {};
+}
+
+bool AutoFreezeManager::isAutoFrozen (const AudioTrack& at) const
+{
+    return getFrozenTrack (at).has_value();
+}
+
+bool AutoFreezeManager::isRendering (const AudioTrack& at) const
+{
+    if (auto info = getInfo (at.itemID))
+        return info->job != nullptr;
+
+    return false;
+}
+
+void AutoFreezeManager::unfreezeAll()
+{
+    bool needsRestart = false;
+
+    for (auto& info : tracks)
+    {
+        cancelRender (info);
+
+        if (info.frozen)
+        {
+            unfreeze (info);
+            needsRestart = true;
+        }
+    }
+
+    if (needsRestart)
+        edit.restartPlayback();
+}
+
+//==============================================================================
+namespace auto_freeze_utils
+{
+    /** Returns the plugins that get rendered in to a track's freeze. */
+    inline juce::Array<Plugin*> getFrozenPlugins (AudioTrack& at)
+    {
+        juce::Array<Plugin*> plugins;
+        const int numFreezablePlugins = AutoFreezeManager::getNumFreezablePlugins (at);
+
+        for (int i = 0; i < numFreezablePlugins; ++i)
+            plugins.add (at.pluginList[i]);
+
+        for (auto c : at.getClips())
+            if (auto pluginList = c->getPluginList())
+                for (auto p : *pluginList)
+                    plugins.add (p);
+
+        // Racks on clips use the plugins in their RackType
+        for (int i = 0; i < plugins.size(); ++i)
+            if (auto ri = dynamic_cast<RackInstance*> (plugins[i]))
+                if (ri->type != nullptr)
+                    for (auto p : ri->type->getPlugins())
+                        plugins.addIfNotAlreadyThere (p);
+
+        return plugins;
+    }
+
+    /** Adds the modifiers and macros assigned to a parameter, and any assigned to those in turn. */
+    inline void addModifierSources (AutomatableParameter& param, juce::Array<AutomatableParameter::ModifierSource*>& sources)
+    {
+        for (auto source : param.getModifiers())
+        {
+            if (sources.contains (source))
+                continue;
+
+            sources.add (source);
+
+            if (auto modifier = dynamic_cast<Modifier*> (source))
+            {
+                for (auto modifierParam : modifier->getAutomatableParameters())
+                    addModifierSources (*modifierParam, sources);
+            }
+            else if (auto macro = dynamic_cast<MacroParameter*> (source))
+            {
+                addModifierSources (*macro, sources);
+            }
+        }
+    }
+
+    inline juce::Array<AutomatableParameter::ModifierSource*> getModifierSources (AudioTrack& at)
+    {
+        juce::Array<AutomatableParameter::ModifierSource*> sources;
+
+        for (auto p : getFrozenPlugins (at))
+            for (auto param : p->getAutomatableParameters())
+                addModifierSources (*param, sources);
+
+        return sources;
+    }
+
+    /** Returns true if a Modifier's output depends on the signal of the track it's on. */
+    inline bool followsTrackSignal (Modifier& m)
+    {
+        return dynamic_cast<EnvelopeFollowerModifier*> (&m) != nullptr
+            || dynamic_cast<MIDITrackerModifier*> (&m) != nullptr;
+    }
+}
+
+//==============================================================================
+int AutoFreezeManager::getNumFreezablePlugins (AudioTrack& at)
+{
+    int num = 0;
+
+    for (auto p : at.pluginList)
+    {
+        if (dynamic_cast<VolumeAndPanPlugin*> (p) != nullptr
+             || dynamic_cast<LevelMeterPlugin*> (p) != nullptr
+             || dynamic_cast<AuxSendPlugin*> (p) != nullptr
+             || dynamic_cast<AuxReturnPlugin*> (p) != nullptr
+             || dynamic_cast<RackInstance*> (p) != nullptr
+             || dynamic_cast<InsertPlugin*> (p) != nullptr
+             || dynamic_cast<FreezePointPlugin*> (p) != nullptr
+             || p->getSidechainSourceID().isValid())
+            break;
+
+        ++num;
+    }
+
+    return num;
+}
+
+double AutoFreezeManager::getFreezableCpuUsage (AudioTrack& at)
+{
+    double cpuUsage = 0.0;
+    const int numFreezablePlugins = getNumFreezablePlugins (at);
+
+    for (int i = 0; i < numFreezablePlugins; ++i)
+        cpuUsage += at.pluginList[i]->getCpuUsage();
+
+    for (auto c : at.getClips())
+        if (auto pluginList = c->getPluginList())
+            for (auto p : *pluginList)
+                cpuUsage += p->getCpuUsage();
+
+    return cpuUsage;
+}
+
+bool AutoFreezeManager::canBeAutoFrozen (AudioTrack& at)
+{
+    if (at.isFrozen (Track::anyFreeze)
+         || at.isPartOfSubmix()
+         || at.getOutput().getDestinationTrack() != nullptr
+         || ! at.getInputTracks().isEmpty()
+         || at.getCompGroup() >= 0
+         || ! at.getListeners().isEmpty()
+         || ! at.edit.getEditInputDevices().getDevicesForTargetTrack (at).isEmpty())
+        return false;
+
+    if (at.getClips().isEmpty())
+        return false;
+
+    for (auto c : at.getClips())
+    {
+        if (auto acb = dynamic_cast<AudioClipBase*> (c))
+        {
+            if (acb->isUsingMelodyne())
+                return false;
+
+            // Wait for any proxies to finish rendering
+            if (! acb->getPlaybackFile().isValid())
+                return false;
+        }
+    }
+
+    // Modifiers that follow another track's signal would need that track rendering too
+    for (auto source : auto_freeze_utils::getModifierSources (at))
+        if (auto modifier = dynamic_cast<Modifier*> (source))
+            if (auto_freeze_utils::followsTrackSignal (*modifier) && ! modifier->state.isAChildOf (at.state))
+                return false;
+
+    return true;
+}
+
+juce::ValueTree AutoFreezeManager::createFreezableState (AudioTrack& at)
+{
+    auto v = at.state.createCopy();
+
+    // Remove the plugins that have to stay live
+    const int numFreezablePlugins = getNumFreezablePlugins (at);
+    int pluginIndex = 0;
+
+    for (int i = 0; i < v.getNumChildren();)
+    {
+        auto child = v.getChild (i);
+
+        if ((child.hasType (IDs::PLUGIN) && pluginIndex++ >= numFreezablePlugins)
+             || child.hasType (IDs::AUTOMATIONTRACK))
+        {
+            v.removeChild (i, nullptr);
+            continue;
+        }
+
+        ++i;
+    }
+
+    // And any properties that don't change the audio
+    for (auto& id : { IDs::mute, IDs::solo, IDs::soloIsolate, IDs::name, IDs::colour, IDs::height,
+                      IDs::expanded, IDs::midiVProp, IDs::midiVOffset, IDs::ghostTracks })
+        v.removeProperty (id, nullptr);
+
+    return v;
+}
+
+juce::Array<juce::ValueTree> AutoFreezeManager::getExternalStates (AudioTrack& at)
+{
+    juce::Array<juce::ValueTree> states;
+
+    auto addIfExternal = [&] (const juce::ValueTree& v)
+    {
+        if (v.isValid() && v != at.state && ! v.isAChildOf (at.state))
+            states.addIfNotAlreadyThere (v);
+    };
+
+    for (auto source : auto_freeze_utils::getModifierSources (at))
+    {
+        if (auto modifier = dynamic_cast<Modifier*> (source))
+        {
+            addIfExternal (modifier->state);
+        }
+        else if (auto macro = dynamic_cast<MacroParameter*> (source))
+        {
+            addIfExternal (macro->state);
+            addIfExternal (macro->getCurve().state);
+        }
+    }
+
+    for (auto c : at.getClips())
+        if (auto pluginList = c->getPluginList())
+            for (auto p : *pluginList)
+                if (auto ri = dynamic_cast<RackInstance*> (p))
+                    if (ri->type != nullptr)
+                        addIfExternal (ri->type->state);
+
+    return states;
+}
+
+HashCode AutoFreezeManager::getContentHash (AudioTrack& at)
+{
+    auto hash = (uint64_t) getStateHash (createFreezableState (at));
+    hash = hash * 31 + (uint64_t) getStateHash (at.edit.tempoSequence.getState());
+    hash = hash * 31 + (uint64_t) getStateHash (at.edit.state.getChildWithName (IDs::PITCHSEQUENCE));
+    hash = hash * 31 + (uint64_t) at.edit.engine.getDeviceManager().getSampleRate();
+
+    // Modifiers, macros and racks can be on other tracks or in the Edit but still change the audio
+    for (auto& v : getExternalStates (at))
+        hash = hash * 31 + (uint64_t) getStateHash (v);
+
+    // The playback files can change without the state changing, e.g. when they're edited externally
+    for (auto c : at.getClips())
+    {
+        if (auto acb = dynamic_cast<AudioClipBase*> (c))
+        {
+            const auto playbackFile = acb->getPlaybackFile();
+            hash = hash * 31 + (uint64_t) playbackFile.getHash();
+            hash = hash * 31 + (uint64_t) playbackFile.getFile().getLastModificationTime().toMilliseconds();
+        }
+    }
+
+    // 0 is used to mean a track can't be frozen
+    return hash == 0 ? 1 : (HashCode) hash;
+}
+
+HashCode AutoFreezeManager::getStateHash (const juce::ValueTree& v)
+{
+    auto hash = (uint64_t) v.getType().toString().hashCode64();
+
+    for (int i = 0; i < v.getNumProperties(); ++i)
+    {
+        const auto name = v.getPropertyName (i);
+        hash = hash * 31 + (uint64_t) name.toString().hashCode64();
+        hash = hash * 31 + (uint64_t) v[name].toString().hashCode64();
+    }
+
+    for (const auto& child : v)
+        hash = hash * 31 + (uint64_t) getStateHash (child);
+
+    return (HashCode) hash;
+}
+
+//==============================================================================
+AutoFreezeManager::TrackInfo* AutoFreezeManager::getInfo (EditItemID trackID)
+{
+    for (auto& info : tracks)
+        if (info.trackID == trackID)
+            return &info;
+
+    return nullptr;
+}
+
+const AutoFreezeManager::TrackInfo* AutoFreezeManager::getInfo (EditItemID trackID) const
+{
+    for (auto& info : tracks)
+        if (info.trackID == trackID)
+            return &info;
+
+    return nullptr;
+}
+
+AutoFreezeManager::TrackInfo& AutoFreezeManager::getOrCreateInfo (EditItemID trackID)
+{
+    if (auto info = getInfo (trackID))
+        return *info;
+
+    tracks.push_back ({});
+    tracks.back().trackID = trackID;
+    return tracks.back();
+}
+
+//==============================================================================
+void AutoFreezeManager::update()
+{
+    CRASH_TRACER
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (! options.enabled || edit.isLoading() || edit.isRendering()
+         || ! edit.getTransport().isAllowedToReallocate())
+        return;
+
+    deleteStaleFiles();
+    updateHashes();
+    startRendersIfNeeded();
+}
+
+void AutoFreezeManager::timerCallback()
+{
+    update();
+}
+
+void AutoFreezeManager::updateHashes()
+{
+    const auto now = juce::Time::getMillisecondCounterHiRes() / 1000.0;
+    const auto audioTracks = getAudioTracks (edit);
+    bool needsRestart = false;
+
+    // Forget about any tracks that have been deleted
+    for (auto i = tracks.size(); i > 0; --i)
+    {
+        auto& info = tracks[i - 1];
+
+        if (! std::any_of (audioTracks.begin(), audioTracks.end(), [&info] (auto at) { return at->itemID == info.trackID; }))
+        {
+            cancelRender (info);
+            staleFiles.addArray (info.cachedFiles);
+            tracks.erase (tracks.begin() + (long) (i - 1));
+        }
+    }
+
+    for (auto at : audioTracks)
+    {
+        // Changes made inside plugins need to be in the state before it's hashed
+        for (auto p : at->pluginList)
+            edit.flushPluginStateIfNeeded (*p);
+
+        auto& info = getOrCreateInfo (at->itemID);
+
+        // Tracks that couldn't be frozen are checked every time as they might be waiting for proxies
+        if (! info.needsHashing && info.hash != 0)
+            continue;
+
+        info.needsHashing = false;
+        info.externalStates = getExternalStates (*at);
+        const auto newHash = canBeAutoFrozen (*at) ? getContentHash (*at) : 0;
+
+        if (newHash == info.hash)
+            continue;
+
+        info.hash = newHash;
+        info.lastChangeTime = now;
+
+        if (info.job != nullptr && info.pendingFreeze.hash != newHash)
+            cancelRender (info);
+
+        if (info.frozen && info.frozen->hash != newHash)
+        {
+            TRACKTION_LOG ("Auto-freeze invalidated: " + at->getName());
+            cacheFile (info, info.frozen->file);
+            unfreeze (info);
+            needsRestart = true;
+        }
+
+        // If this state has been frozen before, the file can be used straight away
+        if (newHash != 0 && ! info.frozen && info.job == nullptr)
+        {
+            auto file = TemporaryFileManager::getAutoFreezeFileForTrack (*at, newHash);
+
+            if (file.existsAsFile())
+            {
+                FrozenTrack frozen;
+                frozen.file = file;
+                frozen.hash = newHash;
+
+                for (int i = 0; i < getNumFreezablePlugins (*at); ++i)
+                    frozen.frozenPlugins.push_back (at->pluginList[i]->itemID);
+
+                info.cachedFiles.removeFirstMatchingValue (file);
+                staleFiles.removeFirstMatchingValue (file);
+                freeze (*at, info, std::move (frozen));
+                needsRestart = true;
+            }
+        }
+    }
+
+    if (needsRestart)
+        edit.restartPlayback();
+}
+
+void AutoFreezeManager::startRendersIfNeeded()
+{
+    if (! (options.enabled && edit.getTransport().isPlayContextActive()))
+        return;
+
+    const auto now = juce::Time::getMillisecondCounterHiRes() / 1000.0;
+    int numRendering = 0;
+
+    for (auto& info : tracks)
+        if (info.job != nullptr)
+            ++numRendering;
+
+    std::vector<std::pair<AudioTrack*, double>> candidates;
+
+    for (auto& info : tracks)
+    {
+        if (info.hash == 0 || info.frozen || info.job != nullptr
+             || now - info.lastChangeTime < options.secondsUnchangedBeforeFreezing)
+            continue;
+
+        if (auto at = dynamic_cast<AudioTrack*> (findTrackForID (edit, info.trackID)))
+        {
+            const auto cpuUsage = getFreezableCpuUsage (*at);
+
+            if (cpuUsage >= options.minCpuUsage)
+                candidates.emplace_back (at, cpuUsage);
+        }
+    }
+
+    // Freeze the most expensive tracks first
+    std::sort (candidates.begin(), candidates.end(),
+               [] (auto& c1, auto& c2) { return c1.second > c2.second; });
+
+    for (auto& candidate : candidates)
+    {
+        if (numRendering >= options.maxNumConcurrentRenders)
+            break;
+
+        if (auto info = getInfo (candidate.first->itemID))
+        {
+            startRender (*candidate.first, *info);
+
+            if (info->job != nullptr)
+                ++numRendering;
+        }
+    }
+}
+
+void AutoFreezeManager::startRender (AudioTrack& at, TrackInfo& info)
+{
+    CRASH_TRACER
+    jassert (info.job == nullptr);
+
+    auto& dm = edit.engine.getDeviceManager();
+    const auto file = TemporaryFileManager::getAutoFreezeFileForTrack (at, info.hash);
+
+    // The track is rendered in its own Edit so the live plugins aren't used on the render thread
+    auto renderEdit = std::make_unique<Edit> (edit.engine, createEmptyEdit (edit.engine), Edit::forRendering, nullptr, 1);
+    renderEdit->setTempDirectory (edit.getTempDirectory (false));
+    renderEdit->editFileRetriever = edit.editFileRetriever;
+    renderEdit->filePathResolver = edit.filePathResolver;
+    renderEdit->tempoSequence.copyFrom (edit.tempoSequence);
+    renderEdit->pitchSequence.copyFrom (edit.pitchSequence);
+
+    auto renderTrack = dynamic_cast<AudioTrack*> (renderEdit->insertTrack (TrackInsertPoint (nullptr, nullptr),
+                                                                            createFreezableState (at), nullptr).get());
+
+    if (renderTrack == nullptr)
+    {
+        jassertfalse;
+        return;
+    }
+
+    juce::Array<EditItemID> trackIDs { renderTrack->itemID };
+
+    Renderer::Parameters r (*renderEdit);
+    r.tracksToDo = toBitSet (juce::Array<Track*> { renderTrack });
+    r.destFile = file;
+    r.audioFormat = edit.engine.getAudioFileFormatManager().getFrozenFileFormat();
+    r.blockSizeForAudio = dm.getBlockSize();
+    r.sampleRateForAudio = dm.getSampleRate();
+    r.time = { {}, renderTrack->getLength() };
+    r.endAllowance = RenderOptions::findEndAllowance (*renderEdit, &trackIDs, nullptr);
+    r.canRenderInMono = true;
+    r.mustRenderInMono = false;
+    r.usePlugins = true;
+    r.useMasterPlugins = false;
+    r.addAntiDenormalisationNoise = EditPlaybackContext::shouldAddAntiDenormalisationNoise (edit.engine);
+    r.category = ProjectItem::Category::none;
+
+    info.pendingFreeze = {};
+    info.pendingFreeze.file = file;
+    info.pendingFreeze.hash = info.hash;
+
+    for (int i = 0; i < getNumFreezablePlugins (at); ++i)
+        info.pendingFreeze.frozenPlugins.push_back (at.pluginList[i]->itemID);
+
+    // The job takes ownership of the Edit
+    renderEdit.release();
+    info.job = EditRenderJob::getOrCreateRenderJob (edit.engine, r, true, false, false);
+
+    if (info.job != nullptr)
+        info.job->addListener (this);
+
+    TRACKTION_LOG ("Auto-freezing: " + at.getName());
+}
+
+void AutoFreezeManager::jobFinished (RenderManager::Job& job, bool completedOk)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    for (auto& info : tracks)
+    {
+        if (info.job.get() != &job)
+            continue;
+
+        job.removeListener (this);
+        info.job = nullptr;
+
+        auto at = dynamic_cast<AudioTrack*> (findTrackForID (edit, info.trackID));
+
+        // Only use the file if the track hasn't changed since the render started
+        if (completedOk && at != nullptr
+             && options.enabled
+             && info.pendingFreeze.hash == info.hash
+             && info.pendingFreeze.file.existsAsFile())
+        {
+            freeze (*at, info, info.pendingFreeze);
+            edit.restartPlayback();
+        }
+        else if (completedOk && at != nullptr && info.pendingFreeze.file.existsAsFile())
+        {
+            // The track changed whilst it was rendering but the file can be used if the change is undone
+            cacheFile (info, info.pendingFreeze.file);
+        }
+        else
+        {
+            staleFiles.add (info.pendingFreeze.file);
+        }
+
+        info.pendingFreeze = {};
+        return;
+    }
+}
+
+//==============================================================================
+void AutoFreezeManager::freeze (AudioTrack& at, TrackInfo& info, FrozenTrack frozen)
+{
+    const AudioFile af (edit.engine, frozen.file);
+    frozen.time = { TimePosition(), TimeDuration::fromSeconds (af.getLength()) };
+
+    if (frozen.time.isEmpty())
+        return;
+
+    setPluginsAutoFrozen (frozen.frozenPlugins, true);
+    info.frozen = std::move (frozen);
+
+    TRACKTION_LOG ("Auto-frozen: " + at.getName());
+}
+
+void AutoFreezeManager::unfreeze (TrackInfo& info)
+{
+    if (info.frozen)
+        setPluginsAutoFrozen (info.frozen->frozenPlugins, false);
+
+    info.frozen.reset();
+}
+
+void AutoFreezeManager::cancelRender (TrackInfo& info)
+{
+    if (info.job == nullptr)
+        return;
+
+    info.job->removeListener (this);
+    info.job->cancelJob();
+    info.job = nullptr;
+
+    staleFiles.add (info.pendingFreeze.file);
+    info.pendingFreeze = {};
+}
+
+void AutoFreezeManager::cacheFile (TrackInfo& info, const juce::File& file)
+{
+    info.cachedFiles.removeFirstMatchingValue (file);
+    info.cachedFiles.add (file);
+
+    while (info.cachedFiles.size() > std::max (0, options.maxNumCachedFilesPerTrack))
+    {
+        staleFiles.add (info.cachedFiles.getFirst());
+        info.cachedFiles.remove (0);
+    }
+}
+
+void AutoFreezeManager::setPluginsAutoFrozen (const std::vector<EditItemID>& pluginIDs, bool shouldBeFrozen)
+{
+    for (auto& pluginID : pluginIDs)
+        if (auto p = findPluginForID (edit, pluginID))
+            p->setAutoFrozen (shouldBeFrozen);
+}
+
+void AutoFreezeManager::markDirty (const juce::ValueTree& v)
+{
+    for (auto parent = v; parent.isValid(); parent = parent.getParent())
+    {
+        if (parent.hasType (IDs::TEMPOSEQUENCE) || parent.hasType (IDs::PITCHSEQUENCE))
+        {
+            for (auto& info : tracks)
+                info.needsHashing = true;
+
+            return;
+        }
+
+        // Modifiers, macros and racks can be used by tracks other than the one they're on
+        for (auto& info : tracks)
+            if (info.externalStates.contains (parent))
+                info.needsHashing = true;
+
+        if (parent.hasType (IDs::TRACK))
+        {
+            if (auto info = getInfo (EditItemID::fromID (parent)))
+                info->needsHashing = true;
+
+            return;
+        }
+    }
+}
+
+void AutoFreezeManager::deleteStaleFiles()
+{
+    // These are deleted a tick after they stop being used so the playback graph has been rebuilt
+    for (auto& f : staleFiles)
+        if (f != juce::File())
+            AudioFile (edit.engine, f).deleteFile();
+
+    staleFiles.clear();
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,178 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+/**
+    Automatically freezes expensive AudioTracks in the background.
+
+    Whilst an Edit plays, this looks at the CPU usage of each track's plugins (as
+    measured by Plugin::getCpuUsage). When a track costs more than a threshold and
+    hasn't changed for a while, its clips and leading plugins are rendered to a
+    freeze file on a background RenderManager job. Once that's finished, the
+    playback graph is rebuilt with a WaveNode playing the file in place of the
+    clips and those plugins.
+
+    Only the plugins before the first one that has to stay live are frozen. This
+    is the first VolumeAndPanPlugin, LevelMeterPlugin, aux send or return, rack,
+    insert, freeze point or plugin with a sidechain input. This means volume,
+    pan, meters and sends can still be changed without losing the freeze.
+
+    Each freeze is identified by a content hash of the frozen part of the track
+    state along with the tempo and pitch sequences, the playback files used and
+    the state of any modifiers, macros or racks outside the track that the frozen
+    plugins depend on.
+    As soon as any of these change, the freeze is dropped and the track plays
+    live again until it has been unchanged for long enough to be re-frozen.
+    Freeze files are named by their hash and the last few files for each track
+    are kept whilst the Edit is open, so undoing a change reuses an existing
+    file straight away. When the Edit closes these older files are deleted but
+    each track's current freeze file is kept, so reloading the Edit reuses it too.
+
+    Tracks aren't auto-frozen if they've been frozen manually, have live inputs,
+    input tracks, comp groups, Melodyne clips, are routed to another track or
+    have plugins modulated by an envelope follower or MIDI tracker on another track.
+
+    There's one of these owned by each Edit that can be played back. It's
+    disabled unless EngineBehaviour::shouldAutoFreezeExpensiveTracks returns true.
+*/
+class AutoFreezeManager  : private juce::Timer,
+                           private juce::ValueTree::Listener,
+                           private RenderManager::Job::Listener
+{
+public:
+    //==============================================================================
+    AutoFreezeManager (Edit&);
+    ~AutoFreezeManager() override;
+
+    /** Configures when tracks get frozen. */
+    struct Options
+    {
+        bool enabled = false;                           /**< Whether tracks should be frozen automatically. */
+        double minCpuUsage = 0.1;                       /**< The proportion of the audio callback a track has to use before it's frozen. */
+        double secondsUnchangedBeforeFreezing = 10.0;   /**< How long a track must be unchanged before it's frozen. */
+        int maxNumConcurrentRenders = 1;                /**< The maximum number of tracks to render at once. */
+        int maxNumCachedFilesPerTrack = 4;              /**< The number of previous freeze files to keep for each track so undoing a change can reuse one. */
+    };
+
+    /** Sets new options. If this disables the manager, all auto-frozen tracks will be unfrozen. */
+    void setOptions (const Options&);
+
+    /** Returns the current options. */
+    const Options& getOptions() const noexcept          { return options; }
+
+    //==============================================================================
+    /** Describes the freeze of a track. */
+    struct FrozenTrack
+    {
+        juce::File file;                                /**< The freeze file. */
+        TimeRange time;                                 /**< The time range the file covers. */
+        HashCode hash = 0;                              /**< The content hash the file was rendered with. */
+        std::vector<EditItemID> frozenPlugins;          /**< The track plugins rendered in to the file. */
+    };
+
+    /** Returns the freeze for a track if it's currently auto-frozen.
+        This is used when building the playback graph.
+    */
+    std::optional<FrozenTrack> getFrozenTrack (const AudioTrack&) const;
+
+    /** Returns true if a track is currently auto-frozen. */
+    bool isAutoFrozen (const AudioTrack&) const;
+
+    /** Returns true if a track is currently being rendered. */
+    bool isRendering (const AudioTrack&) const;
+
+    /** Unfreezes all auto-frozen tracks and cancels any renders. */
+    void unfreezeAll();
+
+    /** Checks the tracks for changes, freezing any that have a freeze file for their
+        current state and starting any renders that are needed.
+        This is called periodically whilst enabled but can be called to check straight away.
+    */
+    void update();
+
+    //==============================================================================
+    /** Returns the number of plugins at the start of a track's plugin list that can be frozen. */
+    static int getNumFreezablePlugins (AudioTrack&);
+
+    /** Returns the measured CPU usage, as a proportion of the audio callback, of the
+        parts of a track that would be frozen.
+    */
+    static double getFreezableCpuUsage (AudioTrack&);
+
+    /** Returns true if a track can be auto-frozen. */
+    static bool canBeAutoFrozen (AudioTrack&);
+
+    /** Returns a copy of the part of a track's state that gets frozen.
+        This has all the plugins that can't be frozen and any properties that
+        don't affect the rendered audio, such as mute and solo, removed.
+    */
+    static juce::ValueTree createFreezableState (AudioTrack&);
+
+    /** Returns the states outside a track that its freeze depends on. These are any
+        modifiers and macros assigned to the frozen plugins that aren't on the track,
+        and the RackTypes used by its clips' plugins.
+    */
+    static juce::Array<juce::ValueTree> getExternalStates (AudioTrack&);
+
+    /** Returns the content hash that identifies a track's freeze. */
+    static HashCode getContentHash (AudioTrack&);
+
+    /** Returns a hash of a ValueTree's type, properties and children. */
+    static HashCode getStateHash (const juce::ValueTree&);
+
+private:
+    //==============================================================================
+    struct TrackInfo
+    {
+        EditItemID trackID;
+        HashCode hash = 0;
+        bool needsHashing = true;
+        double lastChangeTime = 0.0;
+        std::optional<FrozenTrack> frozen;
+        RenderManager::Job::Ptr job;
+        FrozenTrack pendingFreeze;
+        juce::Array<juce::File> cachedFiles;    // Previous freeze files, oldest first
+        juce::Array<juce::ValueTree> externalStates;
+    };
+
+    Edit& edit;
+    Options options;
+    std::vector<TrackInfo> tracks;
+    juce::Array<juce::File> staleFiles;
+
+    TrackInfo* getInfo (EditItemID);
+    const TrackInfo* getInfo (EditItemID) const;
+    TrackInfo& getOrCreateInfo (EditItemID);
+
+    void timerCallback() override;
+    void updateHashes();
+    void startRendersIfNeeded();
+    void startRender (AudioTrack&, TrackInfo&);
+    void freeze (AudioTrack&, TrackInfo&, FrozenTrack);
+    void unfreeze (TrackInfo&);
+    void cancelRender (TrackInfo&);
+    void cacheFile (TrackInfo&, const juce::File&);
+    void setPluginsAutoFrozen (const std::vector<EditItemID>&, bool);
+    void markDirty (const juce::ValueTree&);
+    void deleteStaleFiles();
+
+    void jobFinished (RenderManager::Job&, bool completedOk) override;
+
+    void valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier&) override    { markDirty (v); }
+    void valueTreeChildAdded (juce::ValueTree& p, juce::ValueTree&) override                { markDirty (p); }
+    void valueTreeChildRemoved (juce::ValueTree& p, juce::ValueTree&, int) override         { markDirty (p); }
+    void valueTreeChildOrderChanged (juce::ValueTree& p, int, int) override                 { markDirty (p); }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutoFreezeManager)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,210 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class AutoFreezeManagerTests  : public juce::UnitTest
+{
+public:
+    AutoFreezeManagerTests()
+        : juce::UnitTest ("AutoFreezeManager", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+
+        beginTest ("State hashes");
+        {
+            juce::ValueTree v (IDs::TRACK);
+            v.setProperty (IDs::name, "Track", nullptr);
+            v.appendChild (juce::ValueTree (IDs::MIDICLIP), nullptr);
+
+            const auto hash = AutoFreezeManager::getStateHash (v);
+            expectEquals (AutoFreezeManager::getStateHash (v.createCopy()), hash, "Copies should have the same hash");
+
+            v.getChild (0).setProperty (IDs::start, 1.0, nullptr);
+            expect (AutoFreezeManager::getStateHash (v) != hash, "Changing a child should change the hash");
+        }
+
+        beginTest ("Content hashes");
+        {
+            auto edit = Edit::createSingleTrackEdit (engine);
+            auto track = getAudioTracks (*edit)[0];
+
+            expect (edit->getAutoFreezeManager() != nullptr);
+            expect (! edit->getAutoFreezeManager()->getOptions().enabled, "Auto-freezing should be disabled by default");
+            expect (! AutoFreezeManager::canBeAutoFrozen (*track), "Empty tracks shouldn't be frozen");
+            expect (AutoFreezeManager::getNumFreezablePlugins (*track) <= track->pluginList.size());
+
+            auto clip = track->insertMIDIClip ({ 0.0s, TimePosition (1.0s) }, nullptr);
+            const auto hash = AutoFreezeManager::getContentHash (*track);
+            expect (hash != 0);
+
+            track->setMute (true);
+            track->setName ("Renamed");
+
+            auto freezableState = AutoFreezeManager::createFreezableState (*track);
+            expect (! freezableState.hasProperty (IDs::mute));
+            expect (! freezableState.hasProperty (IDs::name));
+            expectEquals (AutoFreezeManager::getContentHash (*track), hash, "Mute and name shouldn't change the hash");
+
+            clip->setStart (TimePosition (0.5s), false, true);
+            expect (AutoFreezeManager::getContentHash (*track) != hash, "Moving a clip should change the hash");
+        }
+
+        beginTest ("Modifiers on other tracks");
+        {
+            auto edit = Edit::createSingleTrackEdit (engine);
+            edit->ensureNumberOfAudioTracks (2);
+            auto track = getAudioTracks (*edit)[0];
+            auto otherTrack = getAudioTracks (*edit)[1];
+            track->insertMIDIClip ({ 0.0s, TimePosition (1.0s) }, nullptr);
+
+            auto plugin = edit->getPluginCache().createNewPlugin (LowPassPlugin::xmlTypeName, {});
+            track->pluginList.insertPlugin (plugin, 0, nullptr);
+            auto lowPass = dynamic_cast<LowPassPlugin*> (plugin.get());
+            expect (lowPass != nullptr);
+            expectEquals (AutoFreezeManager::getNumFreezablePlugins (*track), 1);
+
+            auto lfo = otherTrack->getModifierList().insertModifier (juce::ValueTree (IDs::LFO), 0, nullptr);
+            lowPass->frequency->addModifier (*lfo);
+
+            expect (AutoFreezeManager::canBeAutoFrozen (*track));
+            expect (AutoFreezeManager::getExternalStates (*track).contains (lfo->state),
+                    "An LFO on another track should be an external state");
+
+            auto& afm = *edit->getAutoFreezeManager();
+            AutoFreezeManager::Options options;
+            options.enabled = true;
+            options.maxNumConcurrentRenders = 0;
+            afm.setOptions (options);
+
+            const auto hash = AutoFreezeManager::getContentHash (*track);
+            const auto file = TemporaryFileManager::getAutoFreezeFileForTrack (*track, hash);
+            writeFreezeFile (engine, file);
+
+            afm.update();
+            expect (afm.isAutoFrozen (*track));
+
+            lfo->state.setProperty (IDs::rate, 4.0f, nullptr);
+            expect (AutoFreezeManager::getContentHash (*track) != hash, "Changing the LFO should change the hash");
+
+            afm.update();
+            expect (! afm.isAutoFrozen (*track), "Changing the LFO on the other track should drop the freeze");
+
+            // An envelope follower follows its own track's audio, so can't be frozen with this track
+            auto envelopeFollower = otherTrack->getModifierList().insertModifier (juce::ValueTree (IDs::ENVELOPEFOLLOWER), 1, nullptr);
+            lowPass->frequency->addModifier (*envelopeFollower);
+            expect (! AutoFreezeManager::canBeAutoFrozen (*track));
+
+            file.deleteFile();
+        }
+
+        beginTest ("Undoing a change reuses the freeze file");
+        {
+            auto edit = Edit::createSingleTrackEdit (engine);
+            auto track = getAudioTracks (*edit)[0];
+            auto clip = track->insertMIDIClip ({ 0.0s, TimePosition (1.0s) }, nullptr);
+            auto& afm = *edit->getAutoFreezeManager();
+
+            // No renders are started so the only way to be frozen is with an existing file
+            AutoFreezeManager::Options options;
+            options.enabled = true;
+            options.maxNumConcurrentRenders = 0;
+            afm.setOptions (options);
+
+            const auto file = TemporaryFileManager::getAutoFreezeFileForTrack (*track, AutoFreezeManager::getContentHash (*track));
+            writeFreezeFile (engine, file);
+
+            afm.update();
+            expect (afm.isAutoFrozen (*track), "An existing file should be used straight away");
+
+            edit->getUndoManager().beginNewTransaction();
+            clip->setStart (TimePosition (0.5s), false, true);
+            afm.update();
+            expect (! afm.isAutoFrozen (*track), "Changing the track should drop the freeze");
+
+            afm.update();
+            expect (file.existsAsFile(), "The old freeze file should be kept");
+
+            edit->getUndoManager().undo();
+            afm.update();
+            expect (afm.isAutoFrozen (*track), "Undoing the change should reuse the file");
+            expectEquals (afm.getFrozenTrack (*track)->file, file);
+
+            // The current freeze file is kept when the Edit closes but older ones aren't
+            edit->getUndoManager().beginNewTransaction();
+            clip->setStart (TimePosition (0.5s), false, true);
+            afm.update();
+            edit.reset();
+            expect (! file.existsAsFile(), "Old freeze files should be deleted when the Edit closes");
+        }
+
+        beginTest ("Changing a track cancels its render");
+        {
+            auto edit = Edit::createSingleTrackEdit (engine);
+            auto track = getAudioTracks (*edit)[0];
+            auto clip = track->insertMIDIClip ({ 0.0s, TimePosition (1.0s) }, nullptr);
+            auto& afm = *edit->getAutoFreezeManager();
+            edit->getTransport().ensureContextAllocated();
+
+            AutoFreezeManager::Options options;
+            options.enabled = true;
+            options.minCpuUsage = 0.0;
+            options.secondsUnchangedBeforeFreezing = 0.0;
+            afm.setOptions (options);
+
+            afm.update();
+            expect (afm.isRendering (*track), "The track should start rendering");
+
+            // Stop the new state being rendered straight away
+            options.secondsUnchangedBeforeFreezing = 1000.0;
+            afm.setOptions (options);
+
+            // The job can't report that it's finished until the message loop runs so it's still pending here
+            clip->setStart (TimePosition (0.5s), false, true);
+            afm.update();
+            expect (! afm.isRendering (*track), "The render of the old state should be cancelled");
+            expect (! afm.isAutoFrozen (*track));
+        }
+    }
+
+private:
+    static void writeFreezeFile (Engine& engine, const juce::File& file)
+    {
+        juce::AudioBuffer<float> buffer (2, 44100);
+        buffer.clear();
+
+        file.deleteFile();
+
+        if (auto fileStream = file.createOutputStream())
+        {
+            if (auto writer = std::unique_ptr<juce::AudioFormatWriter> (engine.getAudioFileFormatManager().getFrozenFileFormat()
+                                                                          ->createWriterFor (fileStream.get(), 44100.0, 2, 32, {}, 0)))
+            {
+                fileStream.release();
+                writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+            }
+        }
+    }
+};
+
+static AutoFreezeManagerTests autoFreezeManagerTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
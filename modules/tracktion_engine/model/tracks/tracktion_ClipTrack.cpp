@@ -20,6 +20,11 @@ struct ClipTrack::ClipList  : public ValueTreeObjectList<Clip>,
     {
         rebuildObjects();
 
+        // BEATCONNECT MODIFICATION START
+        for (auto c : objects)
+            clipIndex.insert (c->getPosition().time, c, c->itemID.getRawID());
+        // BEATCONNECT MODIFICATION END
+
         editLoadedCallback.reset (new Edit::LoadFinishedCallback<ClipList> (*this, ct.edit));
         clipTrack.trackItemsDirty = true;
     }
@@ -73,8 +78,10 @@ struct ClipTrack::ClipList  : public ValueTreeObjectList<Clip>,
         c->decReferenceCount();
     }
 
-    void newObjectAdded (Clip* c) override      { objectAddedOrRemoved (c); }
-    void objectRemoved (Clip* c) override       { objectAddedOrRemoved (c); }
+    // BEATCONNECT MODIFICATION START
+    void newObjectAdded (Clip* c) override      { clipIndex.insert (c->getPosition().time, c, c->itemID.getRawID()); objectAddedOrRemoved (c); }
+    void objectRemoved (Clip* c) override       { clipIndex.remove (c); objectAddedOrRemoved (c); }
+    // BEATCONNECT MODIFICATION END
     void objectOrderChanged() override          { objectAddedOrRemoved (nullptr); }
 
     void objectAddedOrRemoved (Clip* c)
@@ -94,12 +101,25 @@ struct ClipTrack::ClipList  : public ValueTreeObjectList<Clip>,
     ClipTrack& clipTrack;
     std::unique_ptr<Edit::LoadFinishedCallback<ClipList>> editLoadedCallback;
 
+    // BEATCONNECT MODIFICATION START
+    // Clips that start at the same time are ordered by their ID
+    IntervalTree<TimeRange, Clip*> clipIndex;
+    // BEATCONNECT MODIFICATION END
+
     void valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& id) override
     {
         if (Clip::isClipState (v))
         {
             if (id == IDs::start || id == IDs::length)
             {
+                // BEATCONNECT MODIFICATION START
+                // The clip's own listeners have already updated its position by now
+                if (auto c = clipTrack.edit.clipCache.findItem (EditItemID::fromID (v),
+                                                                [&v] (Clip& clip) { return clip.state == v; }))
+                    if (clipIndex.contains (c))
+                        clipIndex.insert (c->getPosition().time, c, c->itemID.getRawID());
+                // BEATCONNECT MODIFICATION END
+
                 if (! clipTrack.edit.getUndoManager().isPerformingUndoRedo())
                     triggerAsyncUpdate();
 
@@ -436,6 +456,32 @@ const juce::Array<Clip*>& ClipTrack::getClips() const noexcept
     return clipList->objects;
 }
 
+// BEATCONNECT MODIFICATION START
+juce::Array<Clip*> ClipTrack::getClipsInRange (TimeRange range) const
+{
+    juce::Array<Clip*> clips;
+    clipList->clipIndex.visitOverlapping (range, [&clips] (Clip* c) { clips.add (c); });
+    return clips;
+}
+
+juce::Array<Clip*> ClipTrack::getClipsAt (TimePosition time) const
+{
+    juce::Array<Clip*> clips;
+    clipList->clipIndex.visitContaining (time, [&clips] (Clip* c) { clips.add (c); });
+    return clips;
+}
+
+std::optional<TimePosition> ClipTrack::getNextClipEdgeAfter (TimePosition time) const
+{
+    return clipList->clipIndex.getNextEdgeAfter (time);
+}
+
+std::optional<TimePosition> ClipTrack::getPreviousClipEdgeBefore (TimePosition time) const
+{
+    return clipList->clipIndex.getPreviousEdgeBefore (time);
+}
+// BEATCONNECT MODIFICATION END
+
 Clip* ClipTrack::findClipForID (EditItemID id) const
 {
     for (auto* c : clipList->objects)
@@ -778,11 +824,12 @@ void ClipTrack::deleteRegion (TimeRange range, SelectionManager* sm)
     setFrozen (false, individualFreeze);
 
     // make a copied list first, as they'll get moved out-of-order..
+    // BEATCONNECT MODIFICATION START
     Clip::Array clipsToDo;
 
-    for (auto c : getClips())
-        if (c->getPosition().time.overlaps (range))
-            clipsToDo.add (c);
+    for (auto c : getClipsInRange (range))
+        clipsToDo.add (c);
+    // BEATCONNECT MODIFICATION END
 
     for (int i = clipsToDo.size(); --i >= 0;)
         deleteRegionOfClip (clipsToDo.getUnchecked (i), range, sm);
@@ -960,11 +1007,12 @@ void ClipTrack::splitAt (TimePosition time)
 {
     CRASH_TRACER
     // make a copied list first, as they'll get moved out-of-order..
+    // BEATCONNECT MODIFICATION START
     Clip::Array clipsToDo;
 
-    for (auto c : *clipList)
-        if (c->getPosition().time.contains (time))
-            clipsToDo.add (c);
+    for (auto c : getClipsAt (time))
+        clipsToDo.add (c);
+    // BEATCONNECT MODIFICATION END
 
     for (auto c : clipsToDo)
         splitClip (*c, time);
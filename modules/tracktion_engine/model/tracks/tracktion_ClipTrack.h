@@ -24,6 +24,20 @@ public:
     const juce::Array<Clip*>& getClips() const noexcept;
     Clip* findClipForID (EditItemID) const override;
 
+    // BEATCONNECT MODIFICATION START
+    /** Returns the clips that overlap a time range, in order of their start times. */
+    juce::Array<Clip*> getClipsInRange (TimeRange) const;
+
+    /** Returns the clips that contain a time, in order of their start times. */
+    juce::Array<Clip*> getClipsAt (TimePosition) const;
+
+    /** Returns the first clip start or end after a time, if there is one. */
+    std::optional<TimePosition> getNextClipEdgeAfter (TimePosition) const;
+
+    /** Returns the last clip start or end before a time, if there is one. */
+    std::optional<TimePosition> getPreviousClipEdgeBefore (TimePosition) const;
+    // BEATCONNECT MODIFICATION END
+
     //==============================================================================
     void refreshCollectionClips (Clip& newClip);
     CollectionClip* getCollectionClip (int index) const noexcept;
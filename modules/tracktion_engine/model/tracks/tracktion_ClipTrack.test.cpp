@@ -0,0 +1,170 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
+
+namespace tracktion { inline namespace engine
+{
+
+#if TRACKTION_UNIT_TESTS
+
+//==============================================================================
+//==============================================================================
+class ClipTrackRangeQueryTests  : public juce::UnitTest
+{
+public:
+    ClipTrackRangeQueryTests()
+        : juce::UnitTest ("ClipTrack range queries", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runClipTests();
+    }
+
+private:
+    static TimeRange secondsRange (double start, double end)
+    {
+        return { TimePosition::fromSeconds (start), TimePosition::fromSeconds (end) };
+    }
+
+    void runClipTests()
+    {
+        beginTest ("Clip queries");
+
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+
+        auto c1 = track->insertMIDIClip (secondsRange (0.0, 2.0), nullptr);
+        auto c2 = track->insertMIDIClip (secondsRange (1.0, 3.0), nullptr);
+        auto c3 = track->insertMIDIClip (secondsRange (5.0, 6.0), nullptr);
+
+        expect (track->getClipsInRange (secondsRange (0.5, 1.5)) == juce::Array<Clip*> { c1.get(), c2.get() });
+        expect (track->getClipsInRange (secondsRange (3.0, 5.0)).isEmpty(), "Ranges that only touch shouldn't overlap");
+        expect (track->getClipsAt (TimePosition::fromSeconds (5.5)) == juce::Array<Clip*> { c3.get() });
+        expect (track->getNextClipEdgeAfter (TimePosition::fromSeconds (3.0)) == TimePosition::fromSeconds (5.0));
+        expect (track->getPreviousClipEdgeBefore (TimePosition::fromSeconds (5.0)) == TimePosition::fromSeconds (3.0));
+
+        // Moving clips should update the index
+        c3->setStart (TimePosition::fromSeconds (1.5), false, true);
+        expect (track->getClipsAt (TimePosition::fromSeconds (1.6)) == juce::Array<Clip*> { c1.get(), c2.get(), c3.get() });
+        expect (track->getClipsAt (TimePosition::fromSeconds (5.5)).isEmpty());
+
+        c1->setLength (TimeDuration::fromSeconds (1.0), false);
+        expect (track->getClipsAt (TimePosition::fromSeconds (1.6)) == juce::Array<Clip*> { c2.get(), c3.get() });
+
+        // As should splitting and removing them
+        track->splitAt (TimePosition::fromSeconds (2.0));
+        expectEquals (track->getClipsInRange (secondsRange (0.0, 10.0)).size(), track->getClips().size());
+
+        c2->removeFromParentTrack();
+        expect (! track->getClipsInRange (secondsRange (0.0, 10.0)).contains (c2.get()));
+        expectEquals (track->getClipsInRange (secondsRange (0.0, 10.0)).size(), track->getClips().size());
+
+        // Clips that start together are returned in order of their IDs
+        track->insertMIDIClip (secondsRange (8.0, 10.0), nullptr);
+        track->insertMIDIClip (secondsRange (8.0, 9.0), nullptr);
+
+        auto clipsAt = track->getClipsAt (TimePosition::fromSeconds (8.5));
+        expectEquals (clipsAt.size(), 2);
+        expect (clipsAt[0]->itemID.getRawID() < clipsAt[1]->itemID.getRawID());
+    }
+};
+
+static ClipTrackRangeQueryTests clipTrackRangeQueryTests;
+
+#endif // TRACKTION_UNIT_TESTS
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+class ClipTrackRangeQueryBenchmarks  : public juce::UnitTest
+{
+public:
+    ClipTrackRangeQueryBenchmarks()
+        : juce::UnitTest ("ClipTrack range queries", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+        constexpr int numClips = 2000, numNotes = 20000, numQueries = 10000;
+
+        for (int i = 0; i < numClips; ++i)
+            track->insertMIDIClip ({ TimePosition::fromSeconds (i), TimeDuration::fromSeconds (1.5) }, nullptr);
+
+        auto& seq = track->insertMIDIClip ({ 0_tp, TimeDuration::fromSeconds (numNotes) }, nullptr)->getSequence();
+
+        for (int i = 0; i < numNotes; ++i)
+            seq.addNote (60 + (i % 12), BeatPosition::fromBeats (i * 0.5), 1_bd, 100, 0, nullptr);
+
+        juce::Random r (42);
+        int numFound = 0;
+
+        beginTest ("Clips");
+        {
+            ScopedBenchmark sb (createBenchmarkDescription (*this, "Find clips in " + std::to_string (numClips) + " by scanning"));
+
+            for (int i = 0; i < numQueries; ++i)
+            {
+                const auto range = TimeRange (TimePosition::fromSeconds (r.nextInt (numClips)), TimeDuration::fromSeconds (4.0));
+
+                for (auto c : track->getClips())
+                    if (c->getPosition().time.overlaps (range))
+                        ++numFound;
+            }
+        }
+
+        {
+            ScopedBenchmark sb (createBenchmarkDescription (*this, "Find clips in " + std::to_string (numClips) + " with the index"));
+
+            for (int i = 0; i < numQueries; ++i)
+                numFound += track->getClipsInRange (TimeRange (TimePosition::fromSeconds (r.nextInt (numClips)),
+                                                               TimeDuration::fromSeconds (4.0))).size();
+        }
+
+        beginTest ("Notes");
+        {
+            ScopedBenchmark sb (createBenchmarkDescription (*this, "Find notes in " + std::to_string (numNotes) + " by scanning"));
+
+            for (int i = 0; i < numQueries; ++i)
+            {
+                const auto range = BeatRange (BeatPosition::fromBeats (r.nextInt (numNotes / 2)), 4_bd);
+
+                for (auto n : seq.getNotes())
+                    if (n->getRangeBeats().overlaps (range))
+                        ++numFound;
+            }
+        }
+
+        {
+            ScopedBenchmark sb (createBenchmarkDescription (*this, "Find notes in " + std::to_string (numNotes) + " with the index"));
+
+            for (int i = 0; i < numQueries; ++i)
+                numFound += seq.getNotesInRange (BeatRange (BeatPosition::fromBeats (r.nextInt (numNotes / 2)), 4_bd)).size();
+        }
+
+        expect (numFound > 0);
+    }
+};
+
+static ClipTrackRangeQueryBenchmarks clipTrackRangeQueryBenchmarks;
+
+#endif // TRACKTION_BENCHMARKS
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
@@ -16,6 +16,10 @@ InputDevice::InputDevice (Engine& e, const juce::String& t, const juce::String&
 {
     alias = e.getPropertyStorage().getPropertyItem (SettingID::invalid, getGlobalPropertyName());
     defaultAlias = n;
+
+    // BEATCONNECT MODIFICATION START
+    levelMeasurer.setFreezeRequests (&e.getDeviceManager().getOverloadPolicy().getMeterFreezeRequests());
+    // BEATCONNECT MODIFICATION END
 }
 
 InputDevice::~InputDevice()
@@ -522,24 +522,49 @@ void MidiOutputDevice::fireMessage (const juce::MidiMessage& message)
     if (! message.isMetaEvent())
     {
         sendMessageNow (message);
+        // BEATCONNECT MODIFICATION START
+        updateNotesOn (message);
+        // BEATCONNECT MODIFICATION END
+    }
+}
 
-        if (message.isNoteOnOrOff())
-        {
-            const juce::ScopedLock sl (noteOnLock);
+// BEATCONNECT MODIFICATION START
+void MidiOutputDevice::fireMessages (const juce::MidiBuffer& buffer)
+{
+    // Subclasses without a real device send each message themselves
+    if (outputDevice == nullptr)
+    {
+        for (auto m : buffer)
+            fireMessage (m.getMessage());
 
-            if (message.isNoteOn())
-                midiNotesOn.setBit (message.getNoteNumber());
-            else if (message.isNoteOff())
-                midiNotesOn.clearBit (message.getNoteNumber());
+        return;
+    }
 
-            channelsUsed.setBit (message.getChannel());
-        }
-        else if (message.isController() && message.getControllerNumber() == 64)
-        {
-            sustain = message.getControllerValue();
-        }
+    outputDevice->sendBlockOfMessagesNow (buffer);
+
+    for (auto m : buffer)
+        updateNotesOn (m.getMessage());
+}
+
+void MidiOutputDevice::updateNotesOn (const juce::MidiMessage& message)
+{
+    if (message.isNoteOnOrOff())
+    {
+        const juce::ScopedLock sl (noteOnLock);
+
+        if (message.isNoteOn())
+            midiNotesOn.setBit (message.getNoteNumber());
+        else if (message.isNoteOff())
+            midiNotesOn.clearBit (message.getNoteNumber());
+
+        channelsUsed.setBit (message.getChannel());
+    }
+    else if (message.isController() && message.getControllerNumber() == 64)
+    {
+        sustain = message.getControllerValue();
     }
 }
+// BEATCONNECT MODIFICATION END
 
 TimeDuration MidiOutputDevice::getDeviceDelay() const noexcept
 {
@@ -52,6 +52,11 @@ public:
     void fireMessage (const juce::MidiMessage&);
     void sendNoteOffMessages();
 
+    // BEATCONNECT MODIFICATION START
+    /** Sends a block of messages at once, which lets the driver pack them together. */
+    void fireMessages (const juce::MidiBuffer&);
+    // BEATCONNECT MODIFICATION END
+
     TimeDuration getDeviceDelay() const noexcept;
 
     int getPreDelayMs() const noexcept                  { return preDelayMillisecs; }
@@ -107,6 +112,10 @@ protected:
 
     juce::String openDevice() override;
     void closeDevice() override;
+
+    // BEATCONNECT MODIFICATION START
+    void updateNotesOn (const juce::MidiMessage&);
+    // BEATCONNECT MODIFICATION END
 };
 
 //==============================================================================
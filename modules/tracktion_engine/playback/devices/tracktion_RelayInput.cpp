@@ -0,0 +1,417 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+RelayInput::RelayInput()
+{
+}
+
+RelayInput::~RelayInput()
+{
+}
+
+void RelayInput::setOptions (const Options& newOptions)
+{
+    jassert (newOptions.numChannels > 0);
+    jassert (newOptions.minLatencyMs <= newOptions.maxLatencyMs);
+
+    {
+        const juce::SpinLock::ScopedLockType pl (producerLock);
+        const juce::SpinLock::ScopedLockType cl (consumerLock);
+        options = newOptions;
+    }
+
+    if (sampleRate > 0)
+        prepare (sampleRate, blockSize);
+}
+
+RelayInput::Options RelayInput::getOptions() const
+{
+    const juce::SpinLock::ScopedLockType cl (consumerLock);
+    return options;
+}
+
+void RelayInput::prepare (double newSampleRate, int maxBlockSize)
+{
+    jassert (newSampleRate > 0 && maxBlockSize > 0);
+
+    const juce::SpinLock::ScopedLockType pl (producerLock);
+    const juce::SpinLock::ScopedLockType cl (consumerLock);
+
+    sampleRate = newSampleRate;
+    blockSize = maxBlockSize;
+
+    // Leave room for a burst of twice the maximum latency before anything is dropped
+    const int capacity = msToSamples (options.maxLatencyMs) * 2 + blockSize * 4;
+    fifo.setTotalSize (capacity);
+    buffer.setSize (std::max (1, options.numChannels), capacity);
+    buffer.clear();
+    lastOutput.assign ((size_t) buffer.getNumChannels(), 0.0f);
+
+    resetState();
+}
+
+void RelayInput::reset()
+{
+    const juce::SpinLock::ScopedLockType pl (producerLock);
+    const juce::SpinLock::ScopedLockType cl (consumerLock);
+    resetState();
+}
+
+//==============================================================================
+int RelayInput::push (const float* const* data, int numChannels, int numSamples)
+{
+    // The producer and consumer use different locks so these are only ever
+    // contended whilst the buffer is being prepared
+    const juce::SpinLock::ScopedTryLockType sl (producerLock);
+
+    if (! sl.isLocked() || sampleRate <= 0 || numChannels <= 0 || numSamples <= 0)
+        return 0;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+    const int numWritten = size1 + size2;
+
+    for (int i = 0; i < buffer.getNumChannels(); ++i)
+    {
+        auto src = data[std::min (i, numChannels - 1)];
+        auto dest = buffer.getWritePointer (i);
+
+        juce::FloatVectorOperations::copy (dest + start1, src, size1);
+        juce::FloatVectorOperations::copy (dest + start2, src + size1, size2);
+    }
+
+    fifo.finishedWrite (numWritten);
+
+    if (numWritten < numSamples)
+    {
+        statOverruns.fetch_add (1, std::memory_order_relaxed);
+        statSamplesDropped.fetch_add ((uint64_t) (numSamples - numWritten), std::memory_order_relaxed);
+    }
+
+    return numWritten;
+}
+
+void RelayInput::pull (juce::AudioBuffer<float>& dest, int numSamples)
+{
+    jassert (numSamples <= dest.getNumSamples());
+
+    if (numSamples <= 0 || dest.getNumChannels() == 0)
+        return;
+
+    const juce::SpinLock::ScopedTryLockType sl (consumerLock);
+
+    if (! sl.isLocked() || sampleRate <= 0)
+    {
+        dest.clear (0, numSamples);
+        return;
+    }
+
+    int numReady = fifo.getNumReady();
+
+    if (! isPlaying)
+    {
+        if (numReady < targetSamples)
+        {
+            conceal (dest, numSamples);
+            updateStats (numReady);
+            return;
+        }
+
+        isPlaying = true;
+        fadeInPosition = 0;
+        averageDepth = numReady;
+        ratio = 1.0;
+        readPhase = 0.0;
+        minDepthInWindow = std::numeric_limits<int>::max();
+        windowPosition = 0;
+    }
+
+    // If a burst has left far more than the maximum latency waiting, jump ahead
+    // rather than waiting for the drift correction to catch up
+    if (numReady > msToSamples (options.maxLatencyMs) + blockSize)
+    {
+        const int numToSkip = numReady - targetSamples;
+        skip (numToSkip);
+        numReady -= numToSkip;
+        averageDepth = numReady;
+
+        statOverruns.fetch_add (1, std::memory_order_relaxed);
+        statSamplesDropped.fetch_add ((uint64_t) numToSkip, std::memory_order_relaxed);
+    }
+
+    // The depth is smoothed over about half a second so the correction follows
+    // the clock drift rather than the network jitter
+    averageDepth += (numReady - averageDepth) * (1.0 - std::exp (-numSamples / (sampleRate * 0.5)));
+
+    const double error = averageDepth - targetSamples;
+    const double deadBand = std::max (blockSize, numSamples);
+    double targetRatio = 1.0;
+
+    if (std::abs (error) > deadBand)
+        targetRatio += juce::jlimit (-options.maxDriftCorrection, options.maxDriftCorrection,
+                                     (error - std::copysign (deadBand, error)) / (sampleRate * 2.0));
+
+    ratio += (targetRatio - ratio) * (1.0 - std::exp (-numSamples / (sampleRate * 0.25)));
+
+    if (std::abs (ratio - targetRatio) < 1.0e-7)
+        ratio = targetRatio;
+
+    if (ratio == 1.0)
+        readPhase = 0.0;
+
+    const int numNeeded = ratio == 1.0 ? numSamples
+                                       : (int) std::floor (readPhase + numSamples * ratio) + 2;
+
+    if (numReady < numNeeded)
+    {
+        statUnderruns.fetch_add (1, std::memory_order_relaxed);
+        isPlaying = false;
+        concealGain = 1.0f;
+        targetSamples = std::min (targetSamples + msToSamples (options.latencyStepMs),
+                                  msToSamples (options.maxLatencyMs));
+
+        conceal (dest, numSamples);
+        updateStats (numReady);
+        return;
+    }
+
+    const int numRead = read (dest, numSamples, numReady);
+    updateTarget (numReady - numRead, numSamples);
+    updateStats (numReady);
+}
+
+//==============================================================================
+RelayInput::Stats RelayInput::getStats() const
+{
+    Stats s;
+    s.targetLatencyMs       = statTargetLatencyMs.load (std::memory_order_relaxed);
+    s.depthMs               = statDepthMs.load (std::memory_order_relaxed);
+    s.averageDepthMs        = statAverageDepthMs.load (std::memory_order_relaxed);
+    s.resamplingRatio       = statRatio.load (std::memory_order_relaxed);
+    s.numUnderruns          = statUnderruns.load (std::memory_order_relaxed);
+    s.numOverruns           = statOverruns.load (std::memory_order_relaxed);
+    s.numSamplesConcealed   = statSamplesConcealed.load (std::memory_order_relaxed);
+    s.numSamplesDropped     = statSamplesDropped.load (std::memory_order_relaxed);
+    s.isPlaying             = statIsPlaying.load (std::memory_order_relaxed);
+    return s;
+}
+
+void RelayInput::resetStats()
+{
+    statUnderruns = 0;
+    statOverruns = 0;
+    statSamplesConcealed = 0;
+    statSamplesDropped = 0;
+}
+
+//==============================================================================
+void RelayInput::resetState()
+{
+    fifo.reset();
+
+    isPlaying = false;
+    targetSamples = msToSamples (juce::jlimit (options.minLatencyMs, options.maxLatencyMs, options.initialLatencyMs));
+    fadeSamples = std::max (1, msToSamples (options.fadeMs));
+    fadeInPosition = 0;
+    averageDepth = 0.0;
+    ratio = 1.0;
+    readPhase = 0.0;
+    concealGain = 0.0f;
+    std::fill (lastOutput.begin(), lastOutput.end(), 0.0f);
+    minDepthInWindow = std::numeric_limits<int>::max();
+    windowPosition = 0;
+
+    updateStats (0);
+}
+
+int RelayInput::msToSamples (double ms) const
+{
+    return juce::roundToInt (ms * sampleRate / 1000.0);
+}
+
+void RelayInput::conceal (juce::AudioBuffer<float>& dest, int numSamples)
+{
+    // Fades the last output sample out rather than dropping straight to silence
+    const auto step = 1.0f / (float) fadeSamples;
+
+    for (int i = 0; i < dest.getNumChannels(); ++i)
+    {
+        const auto last = lastOutput[(size_t) std::min (i, (int) lastOutput.size() - 1)];
+        auto d = dest.getWritePointer (i);
+        auto gain = concealGain;
+
+        for (int j = 0; j < numSamples; ++j)
+        {
+            gain = std::max (0.0f, gain - step);
+            d[j] = last * gain;
+        }
+    }
+
+    concealGain = std::max (0.0f, concealGain - step * (float) numSamples);
+    statSamplesConcealed.fetch_add ((uint64_t) numSamples, std::memory_order_relaxed);
+}
+
+int RelayInput::read (juce::AudioBuffer<float>& dest, int numSamples, int numReady)
+{
+    const int numToRead = ratio == 1.0 ? numSamples
+                                       : std::min (numReady, (int) std::floor (readPhase + numSamples * ratio) + 2);
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (numToRead, start1, size1, start2, size2);
+    jassert (size1 + size2 == numToRead);
+
+    const int numChannels = buffer.getNumChannels();
+    int numConsumed = numSamples;
+
+    if (ratio == 1.0)
+    {
+        for (int i = 0; i < dest.getNumChannels(); ++i)
+        {
+            auto src = buffer.getReadPointer (std::min (i, numChannels - 1));
+            auto d = dest.getWritePointer (i);
+
+            juce::FloatVectorOperations::copy (d, src + start1, size1);
+            juce::FloatVectorOperations::copy (d + size1, src + start2, size2);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < dest.getNumChannels(); ++i)
+        {
+            auto src = buffer.getReadPointer (std::min (i, numChannels - 1));
+            auto d = dest.getWritePointer (i);
+            auto getSample = [&] (int index) { return index < size1 ? src[start1 + index] : src[start2 + index - size1]; };
+            double position = readPhase;
+
+            for (int j = 0; j < numSamples; ++j)
+            {
+                const auto index = (int) position;
+                const auto alpha = (float) (position - index);
+                const auto s1 = getSample (index);
+                d[j] = s1 + alpha * (getSample (index + 1) - s1);
+                position += ratio;
+            }
+        }
+
+        const double end = readPhase + numSamples * ratio;
+        numConsumed = (int) end;
+        readPhase = end - numConsumed;
+    }
+
+    fifo.finishedRead (numConsumed);
+
+    if (fadeInPosition < fadeSamples)
+    {
+        const int numToFade = std::min (numSamples, fadeSamples - fadeInPosition);
+        const auto startGain = fadeInPosition / (float) fadeSamples;
+        const auto endGain = (fadeInPosition + numToFade) / (float) fadeSamples;
+
+        for (int i = 0; i < dest.getNumChannels(); ++i)
+            dest.applyGainRamp (i, 0, numToFade, startGain, endGain);
+
+        fadeInPosition += numToFade;
+    }
+
+    for (size_t i = 0; i < lastOutput.size(); ++i)
+        lastOutput[i] = dest.getSample (std::min ((int) i, dest.getNumChannels() - 1), numSamples - 1);
+
+    return numConsumed;
+}
+
+void RelayInput::skip (int numSamples)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (numSamples, start1, size1, start2, size2);
+    fifo.finishedRead (size1 + size2);
+}
+
+void RelayInput::updateTarget (int depthAfterRead, int numSamples)
+{
+    minDepthInWindow = std::min (minDepthInWindow, depthAfterRead);
+    windowPosition += numSamples;
+
+    if (windowPosition < options.secondsBeforeReducing * sampleRate)
+        return;
+
+    // Only lower the target if there'd still be a step's worth of spare samples afterwards
+    const int step = msToSamples (options.latencyStepMs);
+
+    if (minDepthInWindow > step * 2)
+        targetSamples = std::max (targetSamples - step, msToSamples (options.minLatencyMs));
+
+    minDepthInWindow = std::numeric_limits<int>::max();
+    windowPosition = 0;
+}
+
+void RelayInput::updateStats (int numReady)
+{
+    const double msPerSample = sampleRate > 0 ? 1000.0 / sampleRate : 0.0;
+
+    statTargetLatencyMs.store (targetSamples * msPerSample, std::memory_order_relaxed);
+    statDepthMs.store (numReady * msPerSample, std::memory_order_relaxed);
+    statAverageDepthMs.store (averageDepth * msPerSample, std::memory_order_relaxed);
+    statRatio.store (ratio, std::memory_order_relaxed);
+    statIsPlaying.store (isPlaying, std::memory_order_relaxed);
+}
+
+//==============================================================================
+RelayLoopbackProducer::RelayLoopbackProducer (RelayInput& r, Options o)
+    : relay (r), options (o), random (o.seed),
+      packet (std::max (1, r.getOptions().numChannels), std::max (1, o.packetSize))
+{
+}
+
+int RelayLoopbackProducer::advance (int numDeviceSamples)
+{
+    pendingSamples += numDeviceSamples * options.clockRatio;
+
+    while (pendingSamples >= packet.getNumSamples())
+    {
+        pendingSamples -= packet.getNumSamples();
+        ++numPacketsHeld;
+    }
+
+    if (numPacketsHeld > 0
+         && (numPacketsHeld >= options.maxPacketsHeld || random.nextDouble() >= options.holdProbability))
+        return sendHeldPackets();
+
+    return 0;
+}
+
+float RelayLoopbackProducer::getSampleValue (juce::int64 sampleIndex, int channel) noexcept
+{
+    const auto value = (float) (sampleIndex & 0xffff) / 65536.0f;
+    return (channel % 2) == 0 ? value : -value;
+}
+
+int RelayLoopbackProducer::sendHeldPackets()
+{
+    int numPushed = 0;
+
+    for (; numPacketsHeld > 0; --numPacketsHeld)
+    {
+        for (int i = 0; i < packet.getNumChannels(); ++i)
+        {
+            auto d = packet.getWritePointer (i);
+
+            for (int j = 0; j < packet.getNumSamples(); ++j)
+                d[j] = getSampleValue (numSamplesSent + j, i);
+        }
+
+        numPushed += relay.push (packet.getArrayOfReadPointers(), packet.getNumChannels(), packet.getNumSamples());
+        numSamplesSent += packet.getNumSamples();
+    }
+
+    return numPushed;
+}
+
+}} // namespace tracktion { inline namespace engine
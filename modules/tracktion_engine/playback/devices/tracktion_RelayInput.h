@@ -0,0 +1,198 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    The source of audio for the Relay wave input device.
+
+    Audio arriving from the network is pushed into a single-producer single-consumer
+    FIFO by one thread, and the audio callback pulls it out again without ever
+    waiting on the producer. Each side only takes a lock that guards against the
+    buffer being reconfigured, and the audio thread only ever tries to take its
+    own, so pulling is non-blocking.
+
+    The FIFO acts as a jitter buffer: nothing is played until it holds the target
+    latency, and if it runs dry the last output is faded out, the target is raised
+    and it fills up again. If it stays comfortably full for a while, the target is
+    lowered again.
+
+    Because the sender's clock won't run at exactly the same rate as the audio
+    device, the depth of the buffer is smoothed and the audio is resampled very
+    slightly (by up to Options::maxDriftCorrection) to keep it near the target.
+*/
+class RelayInput
+{
+public:
+    //==============================================================================
+    /** Configures the jitter buffer. */
+    struct Options
+    {
+        double minLatencyMs = 10.0;             /**< The lowest the target latency will be reduced to. */
+        double maxLatencyMs = 200.0;            /**< The highest the target latency will be raised to. */
+        double initialLatencyMs = 40.0;         /**< The target latency to start with. */
+        double latencyStepMs = 5.0;             /**< How much the target changes by on each adjustment. */
+        double secondsBeforeReducing = 5.0;     /**< How long the buffer must have spare samples before the target is lowered. */
+        double maxDriftCorrection = 0.005;      /**< The largest change in playback rate used to correct for clock drift. */
+        double fadeMs = 5.0;                    /**< The length of the fades used when running dry and restarting. */
+        int numChannels = 2;                    /**< The number of channels the relay carries. */
+    };
+
+    /** Statistics about the buffer. */
+    struct Stats
+    {
+        double targetLatencyMs = 0;             /**< The current target latency. */
+        double depthMs = 0;                     /**< The amount of audio in the buffer at the last callback. */
+        double averageDepthMs = 0;              /**< The smoothed depth used for the drift correction. */
+        double resamplingRatio = 1.0;           /**< The rate audio is being read, > 1 if the sender is running fast. */
+        uint64_t numUnderruns = 0;              /**< The number of times the buffer has run dry. */
+        uint64_t numOverruns = 0;               /**< The number of times audio has been dropped because the buffer was full. */
+        uint64_t numSamplesConcealed = 0;       /**< The number of samples output whilst the buffer was filling. */
+        uint64_t numSamplesDropped = 0;         /**< The number of samples dropped on overruns. */
+        bool isPlaying = false;                 /**< True if the buffer has filled and audio is being played. */
+    };
+
+    //==============================================================================
+    /** Creates an unprepared RelayInput. */
+    RelayInput();
+
+    /** Destructor. */
+    ~RelayInput();
+
+    /** Changes the options. This resets the buffer. */
+    void setOptions (const Options&);
+
+    /** Returns the current options. */
+    Options getOptions() const;
+
+    /** Allocates the buffer for a sample rate and block size and empties it.
+        The DeviceManager calls this when the audio device starts.
+    */
+    void prepare (double sampleRate, int maxBlockSize);
+
+    /** Empties the buffer so it has to fill up to the target again. */
+    void reset();
+
+    //==============================================================================
+    /** Adds some audio to the buffer. This should only be called from one thread.
+        If the data has fewer channels than the relay, the last one is repeated.
+        @returns the number of samples that fitted in the buffer
+    */
+    int push (const float* const* data, int numChannels, int numSamples);
+
+    /** Fills a buffer with the next block of audio.
+        This should only be called from the audio thread and never blocks.
+    */
+    void pull (juce::AudioBuffer<float>& dest, int numSamples);
+
+    /** Returns the number of samples waiting in the buffer. */
+    int getNumReady() const noexcept                    { return fifo.getNumReady(); }
+
+    //==============================================================================
+    /** Returns the current statistics. This can be called from any thread. */
+    Stats getStats() const;
+
+    /** Resets the counters in the statistics. */
+    void resetStats();
+
+    /** Called by the input device to say whether a recording has caught up with
+        its latency compensation and is ready for the relay's audio.
+    */
+    void setRecordingReady (bool isReady) noexcept      { recordingReady.store (isReady, std::memory_order_relaxed); }
+
+    /** Returns true if a recording is ready for the relay's audio. */
+    bool isRecordingReady() const noexcept              { return recordingReady.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    Options options;
+    double sampleRate = 0;
+    int blockSize = 0;
+
+    juce::AbstractFifo fifo { 1 };
+    juce::AudioBuffer<float> buffer;
+    juce::SpinLock producerLock, consumerLock;
+
+    // Only used on the audio thread
+    bool isPlaying = false;
+    int targetSamples = 0, fadeSamples = 0, fadeInPosition = 0;
+    double averageDepth = 0, ratio = 1.0, readPhase = 0;
+    float concealGain = 0;
+    std::vector<float> lastOutput;
+    int minDepthInWindow = 0, windowPosition = 0;
+
+    std::atomic<double> statTargetLatencyMs { 0 }, statDepthMs { 0 }, statAverageDepthMs { 0 }, statRatio { 1.0 };
+    std::atomic<uint64_t> statUnderruns { 0 }, statOverruns { 0 }, statSamplesConcealed { 0 }, statSamplesDropped { 0 };
+    std::atomic<bool> statIsPlaying { false }, recordingReady { false };
+
+    void resetState();
+    int msToSamples (double ms) const;
+    void conceal (juce::AudioBuffer<float>&, int numSamples);
+    int read (juce::AudioBuffer<float>&, int numSamples, int numReady);
+    void skip (int numSamples);
+    void updateTarget (int depthAfterRead, int numSamples);
+    void updateStats (int numReady);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RelayInput)
+};
+
+//==============================================================================
+/**
+    Pushes a predictable test signal into a RelayInput, simulating a sender with
+    its own clock and a network that delivers packets unevenly.
+
+    Nothing happens on its own: each call to advance() moves the sender's clock
+    on, so tests can interleave it with RelayInput::pull() and get the same
+    results every time.
+*/
+class RelayLoopbackProducer
+{
+public:
+    /** Describes the simulated sender and network. */
+    struct Options
+    {
+        double clockRatio = 1.0;        /**< The sender's sample rate relative to the device's. */
+        int packetSize = 128;           /**< The number of samples in each packet. */
+        double holdProbability = 0.0;   /**< The chance (0-1) of packets being held back on each advance. */
+        int maxPacketsHeld = 4;         /**< The most packets that can be held back before they're all delivered. */
+        juce::int64 seed = 1;           /**< The seed for the random network delays. */
+    };
+
+    RelayLoopbackProducer (RelayInput&, Options);
+
+    /** Moves the sender's clock on by a number of the device's samples,
+        delivering any packets that are due.
+        @returns the number of samples pushed
+    */
+    int advance (int numDeviceSamples);
+
+    /** Returns the number of samples that have been pushed. */
+    juce::int64 getNumSamplesSent() const noexcept      { return numSamplesSent; }
+
+    /** Returns the value of the test signal for a channel at a sample index.
+        This is a ramp on even channels and an inverted ramp on odd ones.
+    */
+    static float getSampleValue (juce::int64 sampleIndex, int channel) noexcept;
+
+private:
+    RelayInput& relay;
+    Options options;
+    juce::Random random;
+    juce::AudioBuffer<float> packet;
+    double pendingSamples = 0;
+    int numPacketsHeld = 0;
+    juce::int64 numSamplesSent = 0;
+
+    int sendHeldPackets();
+};
+
+}} // namespace tracktion { inline namespace engine
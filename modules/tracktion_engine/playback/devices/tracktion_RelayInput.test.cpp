@@ -0,0 +1,299 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class RelayInputTests  : public juce::UnitTest
+{
+public:
+    RelayInputTests()
+        : juce::UnitTest ("RelayInput", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runPlaybackTests();
+        runUnderrunTests();
+        runDriftTests();
+        runJitterTests();
+        runThreadTests();
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 128;
+
+    static int secondsToBlocks (double seconds)
+    {
+        return juce::roundToInt (seconds * sampleRate / blockSize);
+    }
+
+    static int getNumBlocksToFill (const RelayInput& relay)
+    {
+        return (int) std::ceil (relay.getStats().targetLatencyMs * sampleRate / 1000.0 / blockSize);
+    }
+
+    static RelayInput::Options getOptionsWithFixedLatency()
+    {
+        RelayInput::Options options;
+        options.secondsBeforeReducing = 1000.0;
+        return options;
+    }
+
+    void runPlaybackTests()
+    {
+        beginTest ("Filling and playback");
+
+        RelayInput relay;
+        relay.setOptions (getOptionsWithFixedLatency());
+        relay.prepare (sampleRate, blockSize);
+        RelayLoopbackProducer producer (relay, {});
+        juce::AudioBuffer<float> output (2, blockSize);
+
+        // Nothing should be played until the target latency has arrived
+        const int numBlocksToFill = getNumBlocksToFill (relay);
+        int numBlocksSilent = 0;
+
+        for (;;)
+        {
+            producer.advance (blockSize);
+            relay.pull (output, blockSize);
+
+            if (relay.getStats().isPlaying)
+                break;
+
+            expectEquals (output.getMagnitude (0, blockSize), 0.0f);
+            ++numBlocksSilent;
+        }
+
+        expectEquals (numBlocksSilent, numBlocksToFill - 1);
+        expectEquals (relay.getStats().numSamplesConcealed, (uint64_t) (numBlocksSilent * blockSize));
+
+        // With the clocks in step it should be an exact copy once it's faded in
+        const int fadeSamples = juce::roundToInt (relay.getOptions().fadeMs * sampleRate / 1000.0);
+        juce::int64 sampleIndex = blockSize;
+        int numMismatches = 0;
+
+        for (int i = 0; i < secondsToBlocks (2.0); ++i)
+        {
+            producer.advance (blockSize);
+            relay.pull (output, blockSize);
+
+            for (int j = 0; j < blockSize; ++j)
+            {
+                if (sampleIndex + j < fadeSamples)
+                    continue;
+
+                if (output.getSample (0, j) != RelayLoopbackProducer::getSampleValue (sampleIndex + j, 0)
+                     || output.getSample (1, j) != RelayLoopbackProducer::getSampleValue (sampleIndex + j, 1))
+                    ++numMismatches;
+            }
+
+            sampleIndex += blockSize;
+        }
+
+        expectEquals (numMismatches, 0);
+
+        const auto stats = relay.getStats();
+        expect (stats.isPlaying);
+        expectEquals (stats.numUnderruns, (uint64_t) 0);
+        expectEquals (stats.numOverruns, (uint64_t) 0);
+        expectEquals (stats.resamplingRatio, 1.0);
+        expectWithinAbsoluteError (stats.depthMs, stats.targetLatencyMs, 1000.0 * blockSize / sampleRate);
+    }
+
+    void runUnderrunTests()
+    {
+        beginTest ("Underrun concealment");
+
+        RelayInput relay;
+        relay.setOptions (getOptionsWithFixedLatency());
+        relay.prepare (sampleRate, blockSize);
+        RelayLoopbackProducer producer (relay, {});
+        juce::AudioBuffer<float> output (2, blockSize);
+
+        for (int i = 0; i < secondsToBlocks (1.0); ++i)
+        {
+            producer.advance (blockSize);
+            relay.pull (output, blockSize);
+        }
+
+        const auto initialTarget = relay.getStats().targetLatencyMs;
+        auto lastSample = output.getSample (0, blockSize - 1);
+        bool wasPlaying = true, jumped = false;
+
+        // Stop sending, which should play out what's left then fade out
+        for (int i = 0; i < secondsToBlocks (0.5); ++i)
+        {
+            relay.pull (output, blockSize);
+            const auto isPlaying = relay.getStats().isPlaying;
+
+            if (wasPlaying && ! isPlaying)
+                jumped = std::abs (output.getSample (0, 0) - lastSample) > 0.01f;
+
+            wasPlaying = isPlaying;
+            lastSample = output.getSample (0, blockSize - 1);
+        }
+
+        auto stats = relay.getStats();
+        expect (! stats.isPlaying);
+        expect (! jumped, "The output should fade out from the last sample");
+        expectEquals (stats.numUnderruns, (uint64_t) 1);
+        expectEquals (output.getMagnitude (0, blockSize), 0.0f);
+        expectEquals (stats.targetLatencyMs, initialTarget + relay.getOptions().latencyStepMs);
+
+        // Starting again should fill up to the new target
+        int numBlocksToRestart = 0;
+
+        while (! relay.getStats().isPlaying && numBlocksToRestart < secondsToBlocks (1.0))
+        {
+            producer.advance (blockSize);
+            relay.pull (output, blockSize);
+            ++numBlocksToRestart;
+        }
+
+        stats = relay.getStats();
+        expect (stats.isPlaying);
+        expectEquals (numBlocksToRestart, getNumBlocksToFill (relay));
+
+        relay.resetStats();
+        expectEquals (relay.getStats().numUnderruns, (uint64_t) 0);
+    }
+
+    void runDriftTests()
+    {
+        for (auto clockRatio : { 1.003, 0.997 })
+        {
+            beginTest ("Clock drift " + juce::String (clockRatio));
+
+            RelayInput relay;
+            relay.setOptions (getOptionsWithFixedLatency());
+            relay.prepare (sampleRate, blockSize);
+
+            RelayLoopbackProducer::Options producerOptions;
+            producerOptions.clockRatio = clockRatio;
+            RelayLoopbackProducer producer (relay, producerOptions);
+            juce::AudioBuffer<float> output (2, blockSize);
+
+            for (int i = 0; i < secondsToBlocks (60.0); ++i)
+            {
+                producer.advance (blockSize);
+                relay.pull (output, blockSize);
+            }
+
+            // The sender's clock should have been matched without ever running dry or overflowing
+            const auto stats = relay.getStats();
+            expect (stats.isPlaying);
+            expectEquals (stats.numUnderruns, (uint64_t) 0);
+            expectEquals (stats.numOverruns, (uint64_t) 0);
+            expectWithinAbsoluteError (stats.resamplingRatio, clockRatio, 0.0005);
+            expectWithinAbsoluteError (stats.averageDepthMs, stats.targetLatencyMs, 15.0);
+        }
+    }
+
+    void runJitterTests()
+    {
+        beginTest ("Network jitter");
+
+        RelayInput::Options options;
+        options.initialLatencyMs = options.minLatencyMs;
+        options.secondsBeforeReducing = 2.0;
+
+        RelayInput relay;
+        relay.setOptions (options);
+        relay.prepare (sampleRate, blockSize);
+
+        // Packets are held back for up to 8 blocks
+        RelayLoopbackProducer::Options producerOptions;
+        producerOptions.holdProbability = 0.6;
+        producerOptions.maxPacketsHeld = 8;
+        producerOptions.seed = 1234;
+        RelayLoopbackProducer producer (relay, producerOptions);
+        juce::AudioBuffer<float> output (2, blockSize);
+
+        for (int i = 0; i < secondsToBlocks (30.0); ++i)
+        {
+            producer.advance (blockSize);
+            relay.pull (output, blockSize);
+        }
+
+        // The target should have been raised until the jitter is covered
+        auto stats = relay.getStats();
+        const auto numInitialUnderruns = stats.numUnderruns;
+        expect (numInitialUnderruns > 0);
+        expectGreaterThan (stats.targetLatencyMs, options.minLatencyMs);
+
+        for (int i = 0; i < secondsToBlocks (60.0); ++i)
+        {
+            producer.advance (blockSize);
+            relay.pull (output, blockSize);
+        }
+
+        stats = relay.getStats();
+        expectLessOrEqual (stats.numUnderruns - numInitialUnderruns, (uint64_t) 6);
+        expectLessOrEqual (stats.targetLatencyMs, 8 * 1000.0 * blockSize / sampleRate + 2 * options.latencyStepMs);
+        expectEquals (stats.numOverruns, (uint64_t) 0);
+    }
+
+    void runThreadTests()
+    {
+        beginTest ("Separate producer thread");
+
+        RelayInput relay;
+        relay.prepare (sampleRate, blockSize);
+        RelayLoopbackProducer producer (relay, {});
+        std::atomic<bool> finished { false };
+
+        std::thread producerThread ([&]
+        {
+            while (! finished)
+            {
+                if (relay.getNumReady() < 4096)
+                    producer.advance (blockSize);
+                else
+                    std::this_thread::yield();
+            }
+        });
+
+        juce::AudioBuffer<float> output (2, blockSize);
+        int numBadSamples = 0;
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            relay.pull (output, blockSize);
+
+            for (int j = 0; j < blockSize; ++j)
+            {
+                const auto left = output.getSample (0, j), right = output.getSample (1, j);
+
+                if (! std::isfinite (left) || std::abs (left) > 1.0f || right != -left)
+                    ++numBadSamples;
+            }
+        }
+
+        finished = true;
+        producerThread.join();
+
+        expectEquals (numBadSamples, 0);
+        expectEquals (relay.getStats().numSamplesDropped, (uint64_t) 0);
+    }
+};
+
+static RelayInputTests relayInputTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
@@ -250,10 +250,22 @@ public:
 
     void closeFileWriter()
     {
-        const juce::ScopedLock sl (contextLock);
+        // BEATCONNECT MODIFICATION START
+        // The segments are finished outside the lock as they may have to wait for the encoder
+        std::unique_ptr<SegmentedRecordingWriter> segmentWriter;
 
-        if (recordingContext != nullptr)
-            closeFileWriter (*recordingContext);
+        {
+            const juce::ScopedLock sl (contextLock);
+
+            if (recordingContext != nullptr)
+            {
+                segmentWriter = std::move (recordingContext->segmentWriter);
+                closeFileWriter (*recordingContext);
+            }
+        }
+
+        closeSegmentWriter (edit.engine, std::move (segmentWriter), false);
+        // BEATCONNECT MODIFICATION END
     }
 
     juce::AudioFormat* getFormatToUse() const
@@ -401,6 +413,23 @@ public:
                     }
                 }
 
+                // BEATCONNECT MODIFICATION START
+                if (edit.recordingSegmentSinkRetriever)
+                {
+                    if (auto sink = edit.recordingSegmentSinkRetriever (recordedFile))
+                    {
+                        auto options = edit.recordingSegmentOptions;
+
+                        if (options.name.isEmpty())
+                            options.name = recordedFile.getFileNameWithoutExtension();
+
+                        rc->segmentWriter = std::make_unique<SegmentedRecordingWriter> (std::move (sink),
+                                                                                        edit.engine.getWaveInputRecordingThread().getSegmentEncoderPool(),
+                                                                                        sr, wi.isStereoPair() ? 2 : 1, options);
+                    }
+                }
+                // BEATCONNECT MODIFICATION END
+
                 const juce::ScopedLock sl (contextLock);
                 recordingContext = std::move (rc);
             }
@@ -482,7 +511,9 @@ public:
         if (rc != nullptr)
         {
             auto f = rc->file;
-            closeFileWriter (*rc);
+            // BEATCONNECT MODIFICATION START
+            closeFileWriter (*rc, true);
+            // BEATCONNECT MODIFICATION END
             f.deleteFile();
         }
     }
@@ -518,16 +549,22 @@ public:
         int adjustSamples = 0;
 
         std::unique_ptr<AudioFileWriter> fileWriter;
+        // BEATCONNECT MODIFICATION START
+        std::unique_ptr<SegmentedRecordingWriter> segmentWriter;
+        // BEATCONNECT MODIFICATION END
         DiskSpaceCheckTask diskSpaceChecker;
         RecordingThumbnailManager::Thumbnail::Ptr thumbnail;
         WaveInputRecordingThread::ScopedInitialiser threadInitialiser;
 
         void addBlockToRecord (const juce::AudioBuffer<float>& buffer, int start, int numSamples)
         {
-            if (fileWriter != nullptr)
+            // BEATCONNECT MODIFICATION START
+            if (fileWriter != nullptr || segmentWriter != nullptr)
             {
-                engine.getWaveInputRecordingThread().addBlockToRecord(*fileWriter, buffer, start, numSamples, thumbnail);
+                engine.getWaveInputRecordingThread().addBlockToRecord (fileWriter.get(), segmentWriter.get(),
+                                                                       buffer, start, numSamples, thumbnail);
             }
+            // BEATCONNECT MODIFICATION END
         }
     };
 
@@ -1024,16 +1061,12 @@ public:
         // BEATCONNECT MODIFICATION START (RELAY)
         if (wi.getIsRelay() && wi.isEnabled())
         {
-            // relayBufferProcessor is a shared resource.
-            // This callback function will be set to nullptr when the Relay disconnects or the application is closed.
-            std::unique_lock<std::mutex> lock(edit.engine.getDeviceManager().m_muRelayCallback);
-
-            if (nullptr != edit.engine.getDeviceManager().relayBufferProcessor)
-            {
-                bool isReady = (recordingContext != nullptr && recordingContext->adjustSamples < numSamples);
-                edit.engine.getDeviceManager().relayBufferProcessor(inputBuffer, numSamples, isReady);
-            }
+            // The relay's audio arrives on another thread so is read from its jitter buffer, which never blocks
+            auto& relay = edit.engine.getDeviceManager().getRelayInput();
+            relay.setRecordingReady (recordingContext != nullptr && recordingContext->adjustSamples < numSamples);
 
+            inputBuffer.setSize (wi.getChannelSet().size(), numSamples, false, false, true);
+            relay.pull (inputBuffer, numSamples);
             return;
         }
         // BEATCONNECT MODIFICATION END (RELAY)
@@ -1186,14 +1219,31 @@ protected:
         recordingContext->addBlockToRecord (buffer, start, numSamples);
     }
 
-    static void closeFileWriter (RecordingContext& rc)
+    // BEATCONNECT MODIFICATION START
+    static void closeFileWriter (RecordingContext& rc, bool wasCancelled = false)
     {
         CRASH_TRACER
 
         if (auto localCopy = std::move (rc.fileWriter))
             rc.engine.getWaveInputRecordingThread().waitForWriterToFinish (*localCopy);
+
+        closeSegmentWriter (rc.engine, std::move (rc.segmentWriter), wasCancelled);
     }
 
+    static void closeSegmentWriter (Engine& engine, std::unique_ptr<SegmentedRecordingWriter> segmentWriter, bool wasCancelled)
+    {
+        if (segmentWriter == nullptr)
+            return;
+
+        engine.getWaveInputRecordingThread().waitForWriterToFinish (*segmentWriter);
+
+        if (wasCancelled)
+            segmentWriter->cancel();
+        else
+            segmentWriter->finish();
+    }
+    // BEATCONNECT MODIFICATION END
+
     WaveInputDevice& getWaveInput() const noexcept    { return static_cast<WaveInputDevice&> (owner); }
 
     //==============================================================================
@@ -1581,7 +1631,8 @@ struct WaveInputRecordingThread::BlockQueue
     {
         QueuedBlock() = default;
 
-        void load (AudioFileWriter& w, const juce::AudioBuffer<float>& newBuffer,
+        // BEATCONNECT MODIFICATION START
+        void load (AudioFileWriter* w, SegmentedRecordingWriter* sw, const juce::AudioBuffer<float>& newBuffer,
                    int start, int numSamples, const RecordingThumbnailManager::Thumbnail::Ptr& thumb)
         {
             buffer.setSize (newBuffer.getNumChannels(), numSamples);
@@ -1589,11 +1640,16 @@ struct WaveInputRecordingThread::BlockQueue
             for (int i = buffer.getNumChannels(); --i >= 0;)
                 buffer.copyFrom (i, 0, newBuffer, i, start, numSamples);
 
-            writer = &w;
+            writer = w;
+            segmentWriter = sw;
             thumbnail = thumb;
         }
+        // BEATCONNECT MODIFICATION END
 
         std::atomic<AudioFileWriter*> writer { nullptr };
+        // BEATCONNECT MODIFICATION START
+        SegmentedRecordingWriter* segmentWriter = nullptr;
+        // BEATCONNECT MODIFICATION END
         QueuedBlock* next = nullptr;
         juce::AudioBuffer<float> buffer { 2, 512 };
         RecordingThumbnailManager::Thumbnail::Ptr thumbnail;
@@ -1606,6 +1662,9 @@ struct WaveInputRecordingThread::BlockQueue
     QueuedBlock* lastPending = nullptr;
     QueuedBlock* firstFree = nullptr;
     std::atomic<int> numPending { 0 };
+    // BEATCONNECT MODIFICATION START
+    QueuedBlock* blockBeingWritten = nullptr;
+    // BEATCONNECT MODIFICATION END
 
     QueuedBlock* findFreeBlock()
     {
@@ -1625,6 +1684,9 @@ struct WaveInputRecordingThread::BlockQueue
         jassert (b != nullptr);
         const juce::ScopedLock sl (freeQueueLock);
         b->writer = nullptr;
+        // BEATCONNECT MODIFICATION START
+        b->segmentWriter = nullptr;
+        // BEATCONNECT MODIFICATION END
         b->next = firstFree;
         firstFree = b;
     }
@@ -1682,6 +1744,41 @@ struct WaveInputRecordingThread::BlockQueue
         return false;
     }
 
+    // BEATCONNECT MODIFICATION START
+    // Blocks are taken off the pending queue before they're written so this
+    // also checks the one being written
+    QueuedBlock* removeFirstPendingToWrite() noexcept
+    {
+        const juce::ScopedLock sl (pendingQueueLock);
+        blockBeingWritten = removeFirstPending();
+        return blockBeingWritten;
+    }
+
+    void finishedWriting (QueuedBlock* b) noexcept
+    {
+        {
+            const juce::ScopedLock sl (pendingQueueLock);
+            blockBeingWritten = nullptr;
+        }
+
+        addToFreeQueue (b);
+    }
+
+    bool isWriterInQueue (SegmentedRecordingWriter& writer) const
+    {
+        const juce::ScopedLock sl (pendingQueueLock);
+
+        if (blockBeingWritten != nullptr && blockBeingWritten->segmentWriter == &writer)
+            return true;
+
+        for (auto b = firstPending; b != nullptr; b = b->next)
+            if (b->segmentWriter == &writer)
+                return true;
+
+        return false;
+    }
+    // BEATCONNECT MODIFICATION END
+
     void deleteFreeQueue() noexcept
     {
         auto b = firstFree;
@@ -1726,21 +1823,50 @@ void WaveInputRecordingThread::removeUser()
 void WaveInputRecordingThread::addBlockToRecord (AudioFileWriter& writer, const juce::AudioBuffer<float>& buffer,
                                                  int start, int numSamples, const RecordingThumbnailManager::Thumbnail::Ptr& thumbnail)
 {
+    // BEATCONNECT MODIFICATION START
+    addBlockToRecord (&writer, nullptr, buffer, start, numSamples, thumbnail);
+    // BEATCONNECT MODIFICATION END
+}
+
+void WaveInputRecordingThread::waitForWriterToFinish (AudioFileWriter& writer)
+{
+    while (queue->isWriterInQueue (writer) && isThreadRunning())
+        Thread::sleep (2);
+}
+
+// BEATCONNECT MODIFICATION START
+void WaveInputRecordingThread::addBlockToRecord (AudioFileWriter* writer, SegmentedRecordingWriter* segmentWriter,
+                                                 const juce::AudioBuffer<float>& buffer, int start, int numSamples,
+                                                 const RecordingThumbnailManager::Thumbnail::Ptr& thumbnail)
+{
+    jassert (writer != nullptr || segmentWriter != nullptr);
+
     if (! threadShouldExit())
     {
         auto block = queue->findFreeBlock();
-        block->load (writer, buffer, start, numSamples, thumbnail);
+        block->load (writer, segmentWriter, buffer, start, numSamples, thumbnail);
         queue->addToPendingQueue (block);
         notify();
     }
 }
 
-void WaveInputRecordingThread::waitForWriterToFinish (AudioFileWriter& writer)
+void WaveInputRecordingThread::waitForWriterToFinish (SegmentedRecordingWriter& writer)
 {
     while (queue->isWriterInQueue (writer) && isThreadRunning())
         Thread::sleep (2);
 }
 
+juce::ThreadPool& WaveInputRecordingThread::getSegmentEncoderPool()
+{
+    const juce::ScopedLock sl (segmentEncoderPoolLock);
+
+    if (segmentEncoderPool == nullptr)
+        segmentEncoderPool = std::make_unique<juce::ThreadPool> (2);
+
+    return *segmentEncoderPool;
+}
+// BEATCONNECT MODIFICATION END
+
 void WaveInputRecordingThread::run()
 {
     CRASH_TRACER
@@ -1754,9 +1880,12 @@ void WaveInputRecordingThread::run()
             TRACKTION_LOG_ERROR ("Audio recording can't keep up!");
         }
 
-        if (auto block = queue->removeFirstPending())
+        // BEATCONNECT MODIFICATION START
+        if (auto block = queue->removeFirstPendingToWrite())
         {
-            if (! block->writer.load()->appendBuffer (block->buffer, block->buffer.getNumSamples()))
+            auto writer = block->writer.load();
+
+            if (writer != nullptr && ! writer->appendBuffer (block->buffer, block->buffer.getNumSamples()))
             {
                 if (! hasSentStop)
                 {
@@ -1766,14 +1895,18 @@ void WaveInputRecordingThread::run()
                 }
             }
 
+            if (block->segmentWriter != nullptr)
+                block->segmentWriter->addBlock (block->buffer, 0, block->buffer.getNumSamples());
+
             if (block->thumbnail != nullptr)
             {
                 block->thumbnail->addBlock (block->buffer, 0, block->buffer.getNumSamples());
                 block->thumbnail = nullptr;
             }
 
-            queue->addToFreeQueue (block);
+            queue->finishedWriting (block);
         }
+        // BEATCONNECT MODIFICATION END
         else
         {
             if (threadShouldExit())
@@ -147,6 +147,18 @@ public:
     void run() override;
     void timerCallback() override;
 
+    // BEATCONNECT MODIFICATION START
+    /** Queues a block for a WAV writer, a SegmentedRecordingWriter or both. Either can be nullptr. */
+    void addBlockToRecord (AudioFileWriter*, SegmentedRecordingWriter*, const juce::AudioBuffer<float>&,
+                           int start, int numSamples, const RecordingThumbnailManager::Thumbnail::Ptr&);
+
+    /** Waits until all the blocks queued for a SegmentedRecordingWriter have been added to it. */
+    void waitForWriterToFinish (SegmentedRecordingWriter&);
+
+    /** Returns the pool used to encode recording segments. */
+    juce::ThreadPool& getSegmentEncoderPool();
+    // BEATCONNECT MODIFICATION END
+
     Engine& engine;
 
 private:
@@ -156,6 +168,11 @@ private:
     struct BlockQueue;
     std::unique_ptr<BlockQueue> queue;
 
+    // BEATCONNECT MODIFICATION START
+    std::unique_ptr<juce::ThreadPool> segmentEncoderPool;
+    juce::CriticalSection segmentEncoderPoolLock;
+    // BEATCONNECT MODIFICATION END
+
     void prepareToStart();
     void flushAndStop();
 
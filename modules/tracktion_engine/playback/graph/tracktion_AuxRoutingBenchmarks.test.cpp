@@ -0,0 +1,176 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+#if TRACKTION_BENCHMARKS
+
+#include "tracktion_BenchmarkUtilities.h"
+
+
+namespace tracktion { inline namespace engine
+{
+
+using namespace tracktion::graph;
+
+//==============================================================================
+//==============================================================================
+class AuxRoutingBenchmarks : public juce::UnitTest
+{
+public:
+    AuxRoutingBenchmarks()
+        : juce::UnitTest ("Aux Routing Benchmarks", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        test_utilities::TestSetup ts;
+        ts.sampleRate = 96000.0;
+        ts.blockSize = 128;
+
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+
+        runAuxSendTemplateTest (engine, ts);
+        runSendGainSummingTest (ts);
+    }
+
+    void runAuxSendTemplateTest (Engine& engine, test_utilities::TestSetup ts)
+    {
+        using namespace benchmark_utilities;
+
+        // A mixing template where every track sends to two aux busses, one at unity gain
+        // and one attenuated, which are picked up by two return tracks
+        const auto editName = "64 tracks, 2 aux sends each";
+        const int numSourceTracks = 64;
+        const double fileLength = 20.0;
+
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto sinFile = test_utilities::getSinFile<juce::WavAudioFormat> (ts.sampleRate, fileLength, 2);
+
+        beginTest ("Create Edit");
+        {
+            edit->ensureNumberOfAudioTracks (numSourceTracks + 2);
+            auto audioTracks = getAudioTracks (*edit);
+            expectEquals (audioTracks.size(), numSourceTracks + 2);
+
+            auto insertPlugin = [&edit] (AudioTrack& track, const juce::String& type) -> Plugin::Ptr
+            {
+                auto plugin = edit->getPluginCache().createNewPlugin (type, {});
+                track.pluginList.insertPlugin (plugin, -1, nullptr);
+                return plugin;
+            };
+
+            for (int i = 0; i < numSourceTracks; ++i)
+            {
+                auto track = audioTracks[i];
+                track->insertWaveClip (sinFile->getFile().getFileName(), sinFile->getFile(),
+                                       {{ 0_tp, TimeDuration::fromSeconds (fileLength) }}, false);
+
+                for (int bus : { 0, 1 })
+                {
+                    if (auto send = dynamic_cast<AuxSendPlugin*> (insertPlugin (*track, AuxSendPlugin::xmlTypeName).get()))
+                    {
+                        send->busNumber = bus;
+                        send->setGainDb (bus == 0 ? 0.0f : -6.0f);
+                    }
+                }
+            }
+
+            for (int bus : { 0, 1 })
+                if (auto auxReturn = dynamic_cast<AuxReturnPlugin*> (insertPlugin (*audioTracks[numSourceTracks + bus], AuxReturnPlugin::xmlTypeName).get()))
+                    auxReturn->busNumber = bus;
+
+            expectEquals (edit->getLength().inSeconds(), fileLength);
+        }
+
+        renderEdit (*this, { edit.get(), editName, ts, MultiThreaded::no, LockFree::yes, ThreadPoolStrategy::lightweightSemaphore });
+        renderEdit (*this, { edit.get(), editName, ts, MultiThreaded::yes, LockFree::yes, ThreadPoolStrategy::lightweightSemaphore, PoolMemoryAllocations::no });
+        renderEdit (*this, { edit.get(), editName, ts, MultiThreaded::yes, LockFree::yes, ThreadPoolStrategy::lightweightSemaphore, PoolMemoryAllocations::yes });
+    }
+
+    /** Compares the sends being summed by a return with their gains deferred to the
+        SummingNode against the copy path, where each gain is applied to its own copy first.
+    */
+    void runSendGainSummingTest (test_utilities::TestSetup ts)
+    {
+        const int numSends = 128;
+        const double duration = 20.0;
+        const auto name = juce::String (numSends) + " sends summed by a return";
+
+        for (bool deferGains : { false, true })
+        {
+            const auto description = deferGains ? "Gains deferred to the SummingNode" : "Gains applied to copies (baseline)";
+            beginTest (name + ": " + description);
+
+            std::vector<std::unique_ptr<Node>> inputs;
+
+            for (int i = 0; i < numSends; ++i)
+            {
+                auto source = makeNode<SinNode> (220.0f, 2);
+                const float gain = (i % 2) == 0 ? 1.0f : 0.5f;
+
+                if (deferGains)
+                    inputs.push_back (makeNode<GainNode> (std::move (source), [gain] { return gain; }));
+                else
+                    inputs.push_back (makeNode<CopyingGainNode> (std::move (source), gain));
+            }
+
+            test_utilities::TestProcess<NodePlayer> testProcess (std::make_unique<NodePlayer> (makeNode<SummingNode> (std::move (inputs))),
+                                                                 ts, 2, duration, false);
+            testProcess.processAll();
+            const auto stats = testProcess.getStatisticsAndReset();
+
+            BenchmarkList::getInstance().addResult (createBenchmarkResult (createBenchmarkDescription ("Node",
+                                                                                                       (name + ": rendering").toStdString(),
+                                                                                                       description),
+                                                                           stats));
+
+            // Every block should have been timed
+            const auto numSamples = juce::roundToInt (duration * ts.sampleRate);
+            expectEquals (stats.numRuns, (int64_t) ((numSamples + ts.blockSize - 1) / ts.blockSize));
+        }
+    }
+
+private:
+    /** Applies a gain the way GainNode did before it could defer it, by copying its input. */
+    class CopyingGainNode final : public Node
+    {
+    public:
+        CopyingGainNode (std::unique_ptr<Node> inputNode, float gainToUse)
+            : input (std::move (inputNode)), gain (gainToUse)
+        {
+        }
+
+        NodeProperties getNodeProperties() override         { return input->getNodeProperties(); }
+        std::vector<Node*> getDirectInputNodes() override   { return { input.get() }; }
+        bool isReadyToProcess() override                    { return input->hasProcessed(); }
+
+        void process (ProcessContext& pc) override
+        {
+            auto source = input->getProcessedOutput();
+            copy (pc.buffers.audio, source.audio);
+            pc.buffers.midi.mergeFrom (source.midi);
+
+            if (gain != 1.0f)
+                applyGain (pc.buffers.audio, gain);
+        }
+
+    private:
+        std::unique_ptr<Node> input;
+        const float gain;
+    };
+};
+
+static AuxRoutingBenchmarks auxRoutingBenchmarks;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif
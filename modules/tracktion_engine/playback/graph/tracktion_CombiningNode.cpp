@@ -24,6 +24,78 @@ namespace combining_node_utils
     {
         return static_cast<int> (t.inSeconds()) / secondsPerGroup;
     }
+
+    // BEATCONNECT MODIFICATION START
+    /** Adds an item to any groups it's near to, keeping each group sorted by start time. */
+    template<typename Type>
+    static void addToGroups (juce::OwnedArray<juce::Array<Type*>>& groups, Type* item)
+    {
+        const auto time = item->time;
+        auto start = std::max (0, timeToGroupIndex (time.getStart() - TimeDuration::fromSeconds (secondsPerGroup / 2 + 2)));
+        auto end   = std::max (0, timeToGroupIndex (time.getEnd()   + TimeDuration::fromSeconds (secondsPerGroup / 2 + 2)));
+
+        while (groups.size() <= end)
+            groups.add (new juce::Array<Type*>());
+
+        for (int i = start; i <= end; ++i)
+        {
+            auto g = groups.getUnchecked (i);
+
+            int j;
+            for (j = 0; j < g->size(); ++j)
+                if (g->getUnchecked (j)->time.getStart() >= time.getStart())
+                    break;
+
+            g->insert (j, item);
+        }
+    }
+
+    // Lazy inputs are created when they start within this time of the play position
+    // (or loop start) and deleted when they're further away than the release time
+    static constexpr double lazyInputCreateAheadSeconds = 10.0;
+    static constexpr double lazyInputReleaseAheadSeconds = 30.0;
+    static constexpr double lazyInputReleaseBehindSeconds = 2.0;
+    static constexpr int lazyInputUpdateIntervalMs = 100;
+
+    // When the play position is moved, inputs starting within this time of the new
+    // position are created straight away so the first blocks there aren't missed
+    static constexpr double lazyInputCreateOnLocateSeconds = 2.0;
+
+    /** Returns the nodes and their internal nodes, as they'd appear in a NodeGraph's map. */
+    static std::vector<tracktion::graph::Node*> getNodesToMap (const std::vector<tracktion::graph::Node*>& nodes)
+    {
+        std::vector<tracktion::graph::Node*> nodesToMap;
+
+        for (auto n : nodes)
+        {
+            nodesToMap.push_back (n);
+
+            for (auto internalNode : n->getInternalNodes())
+                nodesToMap.push_back (internalNode);
+        }
+
+        return nodesToMap;
+    }
+
+    /** Returns a copy of a graph's map with some extra nodes added to it.
+        Lazy nodes aren't in the map of the graph they're playing in, as that might be
+        read by another thread whilst they're created, so the nodes replacing them are
+        prepared with one of these instead.
+    */
+    static std::unique_ptr<tracktion::graph::NodeGraph> createNodeMapWith (const tracktion::graph::NodeGraph& nodeGraph,
+                                                                           const std::vector<tracktion::graph::Node*>& nodes)
+    {
+        auto nodeMap = std::make_unique<tracktion::graph::NodeGraph>();
+        nodeMap->sortedNodes = nodeGraph.sortedNodes;
+
+        for (auto n : getNodesToMap (nodes))
+            nodeMap->sortedNodes.push_back ({ n, n->getNodeProperties().nodeID });
+
+        std::stable_sort (nodeMap->sortedNodes.begin(), nodeMap->sortedNodes.end());
+
+        return nodeMap;
+    }
+    // BEATCONNECT MODIFICATION END
 }
 
 //==============================================================================
@@ -118,6 +190,10 @@ struct CombiningNode::TimedNode
     
     TimeRange time;
 
+    // BEATCONNECT MODIFICATION START
+    int lane = 0;
+    // BEATCONNECT MODIFICATION END
+
 private:
     const std::unique_ptr<Node> node;
     std::vector<Node*> nodesToProcess;
@@ -126,6 +202,133 @@ private:
     JUCE_DECLARE_NON_COPYABLE (TimedNode)
 };
 
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+struct CombiningNode::LazyInput
+{
+    LazyInput (std::function<std::unique_ptr<Node>()> f, TimeRange t, EditItemID id)
+        : time (t), itemID (id), createNode (std::move (f))
+    {
+    }
+
+    const TimeRange time;
+    const EditItemID itemID;
+    const std::function<std::unique_ptr<Node>()> createNode;
+    int lane = 0;
+
+    // The node the audio thread should use, if it's been created
+    std::atomic<TimedNode*> node { nullptr };
+
+    // Only accessed by the loader
+    std::unique_ptr<TimedNode> ownedNode;
+    bool failedToCreate = false;
+
+    JUCE_DECLARE_NON_COPYABLE (LazyInput)
+};
+
+//==============================================================================
+struct CombiningNode::LazyInputLoader  : private juce::Timer
+{
+    LazyInputLoader (CombiningNode& o) : owner (o) {}
+
+    ~LazyInputLoader() override
+    {
+        stop();
+    }
+
+    void start()
+    {
+        startTimer (combining_node_utils::lazyInputUpdateIntervalMs);
+    }
+
+    void update()
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (active)
+            owner.updateLazyInputs();
+    }
+
+    /** Stops any more updates, waiting for one in progress to finish. */
+    void stop()
+    {
+        const juce::ScopedLock sl (lock);
+        active = false;
+        stopTimer();
+    }
+
+    juce::CriticalSection lock;
+
+private:
+    CombiningNode& owner;
+    bool active = true;
+
+    void timerCallback() override
+    {
+        update();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (LazyInputLoader)
+};
+
+//==============================================================================
+/** Processes the inputs assigned to one lane so they can run in parallel with the others. */
+struct CombiningNode::Lane final : public tracktion::graph::Node
+{
+    Lane (CombiningNode& o, int laneIndex)
+        : owner (o), index (laneIndex), nodeProperties (o.nodeProperties)
+    {
+        hash_combine (nodeProperties.nodeID, std::string_view ("CombiningNode::Lane"));
+        hash_combine (nodeProperties.nodeID, index);
+    }
+
+    tracktion::graph::NodeProperties getNodeProperties() override
+    {
+        return nodeProperties;
+    }
+
+    std::vector<Node*> getDirectInputNodes() override
+    {
+        return {};
+    }
+
+    void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override
+    {
+        // The inputs are prepared by the CombiningNode
+        isReadyToProcessBlock.store (true, std::memory_order_release);
+    }
+
+    bool isReadyToProcess() override
+    {
+        return isReadyToProcessBlock.load (std::memory_order_acquire);
+    }
+
+    void prefetchBlock (juce::Range<int64_t> referenceSampleRange) override
+    {
+        isReadyToProcessBlock.store (owner.prefetchLane (referenceSampleRange, owner.getEditTimeRange(), index, epoch),
+                                     std::memory_order_release);
+    }
+
+    void process (ProcessContext& pc) override
+    {
+        owner.processLane (pc, owner.getEditTimeRange(), index, epoch, tempAudioBuffer);
+    }
+
+    CombiningNode& owner;
+    const int index;
+    choc::buffer::ChannelArrayBuffer<float> tempAudioBuffer;
+
+    // Odd while this lane might be using a lazy node
+    std::atomic<uint32_t> epoch { 0 };
+
+private:
+    tracktion::graph::NodeProperties nodeProperties;
+    std::atomic<bool> isReadyToProcessBlock { false };
+
+    JUCE_DECLARE_NON_COPYABLE (Lane)
+};
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 CombiningNode::CombiningNode (EditItemID id, ProcessState& ps)
     : TracktionEngineNode (ps),
@@ -134,7 +337,13 @@ CombiningNode::CombiningNode (EditItemID id, ProcessState& ps)
     hash_combine (nodeProperties.nodeID, itemID);
 }
 
-CombiningNode::~CombiningNode() {}
+CombiningNode::~CombiningNode()
+{
+    // BEATCONNECT MODIFICATION START
+    if (lazyInputLoader != nullptr)
+        lazyInputLoader->stop();
+    // BEATCONNECT MODIFICATION END
+}
 
 void CombiningNode::addInput (std::unique_ptr<Node> input, TimeRange time)
 {
@@ -161,31 +370,92 @@ void CombiningNode::addInput (std::unique_ptr<Node> input, TimeRange time)
     jassert (time.getEnd() <= Edit::getMaximumEditEnd());
 
     // add the node to any groups it's near to.
-    auto start = std::max (0, combining_node_utils::timeToGroupIndex (time.getStart() - TimeDuration::fromSeconds (combining_node_utils::secondsPerGroup / 2 + 2)));
-    auto end   = std::max (0, combining_node_utils::timeToGroupIndex (time.getEnd()   + TimeDuration::fromSeconds (combining_node_utils::secondsPerGroup / 2 + 2)));
+    // BEATCONNECT MODIFICATION START
+    jassert (tan != nullptr);
+    combining_node_utils::addToGroups (groups, tan);
 
-    while (groups.size() <= end)
-        groups.add (new juce::Array<TimedNode*>());
+    // Inputs can't be added once the lanes have been created
+    jassert (! lanesCreated);
+    // BEATCONNECT MODIFICATION END
+}
 
-    for (i = start; i <= end; ++i)
-    {
-        auto g = groups.getUnchecked (i);
+int CombiningNode::getNumInputs() const
+{
+    return inputs.size();
+}
 
-        int j;
-        for (j = 0; j < g->size(); ++j)
-            if (g->getUnchecked (j)->time.getStart() >= time.getStart())
-                break;
+// BEATCONNECT MODIFICATION START
+void CombiningNode::addLazyInput (std::function<std::unique_ptr<Node>()> createNode, TimeRange time,
+                                  EditItemID clipID, tracktion::graph::NodeProperties props)
+{
+    assert (createNode != nullptr);
+    jassert (props.latencyNumSamples == 0);
 
-        jassert (tan != nullptr);
-        g->insert (j, tan);
-    }
+    if (time.isEmpty())
+        return;
+
+    nodeProperties.hasAudio |= props.hasAudio;
+    nodeProperties.hasMidi |= props.hasMidi;
+    nodeProperties.numberOfChannels = std::max (nodeProperties.numberOfChannels, props.numberOfChannels);
+    hash_combine (nodeProperties.nodeID, props.nodeID);
+
+    jassert (time.getEnd() <= Edit::getMaximumEditEnd());
+
+    auto li = lazyInputs.add (new LazyInput (std::move (createNode), time, clipID));
+    combining_node_utils::addToGroups (lazyGroups, li);
+    jassert (! lanesCreated);
+
+    if (lazyInputLoader == nullptr)
+        lazyInputLoader = std::make_unique<LazyInputLoader> (*this);
 }
 
-int CombiningNode::getNumInputs() const
+void CombiningNode::createLazyInputsNear (TimePosition position)
 {
-    return inputs.size();
+    if (lazyInputLoader == nullptr)
+        return;
+
+    const juce::ScopedLock sl (lazyInputLoader->lock);
+    lastLocatePosition = position;
+
+    if (preparedNodeGraph == nullptr)
+        return;
+
+    const TimeRange timeToCreate (position - TimeDuration::fromSeconds (combining_node_utils::lazyInputReleaseBehindSeconds),
+                                  position + TimeDuration::fromSeconds (combining_node_utils::lazyInputCreateOnLocateSeconds));
+
+    for (auto li : lazyInputs)
+        if (li->ownedNode == nullptr && ! li->failedToCreate && li->time.overlaps (timeToCreate))
+            createLazyInput (*li);
+}
+
+int CombiningNode::getNumLazyInputs() const
+{
+    return lazyInputs.size();
+}
+
+int CombiningNode::getNumLazyInputsCreated() const
+{
+    int num = 0;
+
+    for (auto li : lazyInputs)
+        if (li->node.load (std::memory_order_acquire) != nullptr)
+            ++num;
+
+    return num;
+}
+
+void CombiningNode::setMaxNumParallelInputs (int maxNum)
+{
+    jassert (! lanesCreated);
+    maxNumParallelInputs = std::max (1, maxNum);
 }
 
+int CombiningNode::getNumParallelLanes() const
+{
+    return (int) lanes.size();
+}
+// BEATCONNECT MODIFICATION END
+
 std::vector<Node*> CombiningNode::getInternalNodes()
 {
     std::vector<Node*> leafNodes;
@@ -199,7 +469,17 @@ std::vector<Node*> CombiningNode::getInternalNodes()
 
 std::vector<tracktion::graph::Node*> CombiningNode::getDirectInputNodes()
 {
-    return {};
+    // BEATCONNECT MODIFICATION START
+    if (! lanesCreated)
+        createLanes();
+
+    std::vector<Node*> laneNodes;
+
+    for (auto& lane : lanes)
+        laneNodes.push_back (lane.get());
+
+    return laneNodes;
+    // BEATCONNECT MODIFICATION END
 }
 
 tracktion::graph::NodeProperties CombiningNode::getNodeProperties()
@@ -213,14 +493,65 @@ void CombiningNode::prepareToPlay (const tracktion::graph::PlaybackInitialisatio
     tempAudioBuffer.resize (choc::buffer::Size::create ((choc::buffer::ChannelCount) nodeProperties.numberOfChannels,
                                                         (choc::buffer::FrameCount) info.blockSize));
 
+    // BEATCONNECT MODIFICATION START
+    // Each lane needs its own buffer as they can be processed at the same time
+    for (auto& lane : lanes)
+        lane->tempAudioBuffer.resize (tempAudioBuffer.getSize());
+
     for (auto& i : inputs)
     {
-        i->prepareToPlay (info, tempAudioBuffer.getView());
+        i->prepareToPlay (info, getTempAudioBufferView (i->lane));
+        // BEATCONNECT MODIFICATION END
         
         if (! i->isReadyToProcess())
             isReadyToProcessBlock.store (false, std::memory_order_release);
     }
 
+    // BEATCONNECT MODIFICATION START
+    // Create any lazy inputs near the play position now so they're ready to play straight away
+    if (lazyInputLoader != nullptr)
+    {
+        {
+            const juce::ScopedLock sl (lazyInputLoader->lock);
+            preparedSampleRate = info.sampleRate;
+            preparedBlockSize = info.blockSize;
+            preparedNodeGraph = &info.nodeGraph;
+
+            // Any nodes already created will be using the old buffer
+            for (auto li : lazyInputs)
+                if (li->ownedNode != nullptr)
+                    li->ownedNode->prepareToPlay (info, getTempAudioBufferView (li->lane));
+
+            // The nodes created now can take over the state of the ones the node being
+            // replaced created, which aren't in its graph's map
+            const CombiningNode* oldNode = nullptr;
+            std::unique_ptr<juce::ScopedLock> oldLoaderLock;
+
+            if (info.nodeGraphToReplace != nullptr)
+                oldNode = findNode<CombiningNode> (*info.nodeGraphToReplace,
+                                                   [itemID = itemID] (auto& cn) { return cn.itemID == itemID; });
+
+            if (oldNode != nullptr && oldNode->lazyInputLoader != nullptr)
+            {
+                oldLoaderLock = std::make_unique<juce::ScopedLock> (oldNode->lazyInputLoader->lock);
+                std::vector<Node*> oldLazyNodes;
+
+                for (auto oldLazyInput : oldNode->lazyInputs)
+                    if (oldLazyInput->ownedNode != nullptr)
+                        for (auto n : oldLazyInput->ownedNode->getNodes())
+                            oldLazyNodes.push_back (n);
+
+                lazyNodeGraphToReplace = combining_node_utils::createNodeMapWith (*info.nodeGraphToReplace, oldLazyNodes);
+            }
+
+            updateLazyInputs();
+            lazyNodeGraphToReplace.reset();
+        }
+
+        lazyInputLoader->start();
+    }
+    // BEATCONNECT MODIFICATION END
+
     // Inspect the old graph to find clips that need to be killed
     if (info.nodeGraphToReplace != nullptr)
     {
@@ -234,6 +565,12 @@ void CombiningNode::prepareToPlay (const tracktion::graph::PlaybackInitialisatio
 
 bool CombiningNode::isReadyToProcess()
 {
+    // BEATCONNECT MODIFICATION START
+    if (! lanes.empty())
+        return std::all_of (lanes.begin(), lanes.end(),
+                            [] (auto& lane) { return lane->hasProcessed(); });
+    // BEATCONNECT MODIFICATION END
+
     return isReadyToProcessBlock.load (std::memory_order_acquire);
 }
 
@@ -241,23 +578,14 @@ void CombiningNode::prefetchBlock (juce::Range<int64_t> referenceSampleRange)
 {
     SCOPED_REALTIME_CHECK
 
-    const auto editTime = getEditTimeRange();
-    prefetchGroup (referenceSampleRange, editTime);
+    // BEATCONNECT MODIFICATION START
+    // Lanes prefetch their own inputs
+    if (! lanes.empty())
+        return;
 
-    // Update ready to process state based on nodes intersecting this time
-    isReadyToProcessBlock.store (true, std::memory_order_release);
-    
-    if (auto g = groups[combining_node_utils::timeToGroupIndex (editTime.getStart())])
-    {
-        for (auto tan : *g)
-        {
-            if (! tan->isReadyToProcess())
-            {
-                isReadyToProcessBlock.store (false, std::memory_order_release);
-                break;
-            }
-        }
-    }
+    isReadyToProcessBlock.store (prefetchLane (referenceSampleRange, getEditTimeRange(), 0, audioThreadEpoch),
+                                 std::memory_order_release);
+    // BEATCONNECT MODIFICATION END
 }
 
 void CombiningNode::process (ProcessContext& pc)
@@ -269,25 +597,30 @@ void CombiningNode::process (ProcessContext& pc)
     // Merge any note-offs from clips that have been deleted
     pc.buffers.midi.mergeFromAndClear (noteOffEventsToSend);
 
-    // Then process the list
-    if (auto g = groups[combining_node_utils::timeToGroupIndex (editTime.getStart())])
+    // BEATCONNECT MODIFICATION START
+    if (lanes.empty())
     {
-        for (auto tan : *g)
+        processLane (pc, editTime, 0, audioThreadEpoch, tempAudioBuffer);
+    }
+    else
+    {
+        // Always sum the lanes in the same order so the output doesn't depend on
+        // which threads they were processed on
+        const auto numDestChannels = pc.buffers.audio.getNumChannels();
+
+        for (auto& lane : lanes)
         {
-            if (tan->time.getEnd() > editTime.getStart())
-            {
-                if (tan->time.getStart() >= editTime.getEnd())
-                    break;
+            auto laneOutput = lane->getProcessedOutput();
+            const auto numChannelsToAdd = std::min (laneOutput.audio.getNumChannels(), numDestChannels);
 
-                // Clear the allocated storage
-                tempAudioBuffer.clear();
-                
-                // Then process the buffer.
-                // This will use the local buffer for the Nodes in the TimedNode and put the result in pc.buffers
-                tan->process (pc);
-            }
+            if (numChannelsToAdd > 0)
+                add (pc.buffers.audio.getFirstChannels (numChannelsToAdd),
+                     laneOutput.audio.getFirstChannels (numChannelsToAdd));
+
+            pc.buffers.midi.mergeFrom (laneOutput.midi);
         }
     }
+    // BEATCONNECT MODIFICATION END
 
     if (pc.buffers.midi.size() > initialEvents)
         pc.buffers.midi.sortByTimestamp();
@@ -296,14 +629,31 @@ void CombiningNode::process (ProcessContext& pc)
 size_t CombiningNode::getAllocatedBytes() const
 {
     size_t size = tempAudioBuffer.getView().data.getBytesNeeded (tempAudioBuffer.getSize());
+
+    // BEATCONNECT MODIFICATION START
+    for (auto& lane : lanes)
+        size += lane->tempAudioBuffer.getView().data.getBytesNeeded (lane->tempAudioBuffer.getSize());
+    // BEATCONNECT MODIFICATION END
     
     for (const auto& i : inputs)
         size += i->getAllocatedBytes();
+
+    // BEATCONNECT MODIFICATION START
+    if (lazyInputLoader != nullptr)
+    {
+        const juce::ScopedLock sl (lazyInputLoader->lock);
+
+        for (auto li : lazyInputs)
+            if (li->ownedNode != nullptr)
+                size += li->ownedNode->getAllocatedBytes();
+    }
+    // BEATCONNECT MODIFICATION END
     
     return size;
 }
 
-void CombiningNode::prefetchGroup (juce::Range<int64_t> referenceSampleRange, TimeRange editTime)
+// BEATCONNECT MODIFICATION START
+void CombiningNode::prefetchGroup (juce::Range<int64_t> referenceSampleRange, TimeRange editTime, int lane)
 {
     if (auto g = groups[combining_node_utils::timeToGroupIndex (editTime.getStart())])
     {
@@ -314,11 +664,13 @@ void CombiningNode::prefetchGroup (juce::Range<int64_t> referenceSampleRange, Ti
                 if (tan->time.getStart() >= editTime.getEnd())
                     break;
 
-                tan->prefetchBlock (referenceSampleRange);
+                if (tan->lane == lane)
+                    tan->prefetchBlock (referenceSampleRange);
             }
         }
     }
 }
+// BEATCONNECT MODIFICATION END
 
 void CombiningNode::queueNoteOffsForClipsNoLongerPresent (const CombiningNode& oldCombiningNode)
 {
@@ -331,7 +683,25 @@ void CombiningNode::queueNoteOffsForClipsNoLongerPresent (const CombiningNode& o
             if (auto loopingMidiNode = dynamic_cast<LoopingMidiNode*> (node))
                 currentNodeIDs.push_back (loopingMidiNode->getItemID());
 
-    for (auto oldTimedNode : oldCombiningNode.inputs)
+    // BEATCONNECT MODIFICATION START
+    // Lazy inputs might not have been created yet so use the ID of the clip they're for
+    for (auto li : lazyInputs)
+        currentNodeIDs.push_back (li->itemID);
+
+    std::vector<TimedNode*> oldTimedNodes (oldCombiningNode.inputs.begin(), oldCombiningNode.inputs.end());
+    std::unique_ptr<juce::ScopedLock> oldLoaderLock;
+
+    if (oldCombiningNode.lazyInputLoader != nullptr)
+    {
+        // Stop the old node's loader deleting its nodes whilst they're being inspected
+        oldLoaderLock = std::make_unique<juce::ScopedLock> (oldCombiningNode.lazyInputLoader->lock);
+
+        for (auto oldLazyInput : oldCombiningNode.lazyInputs)
+            if (auto oldTimedNode = oldLazyInput->node.load (std::memory_order_acquire))
+                oldTimedNodes.push_back (oldTimedNode);
+    }
+
+    for (auto oldTimedNode : oldTimedNodes)
     {
         for (auto oldNode : oldTimedNode->getNodes())
         {
@@ -349,6 +719,268 @@ void CombiningNode::queueNoteOffsForClipsNoLongerPresent (const CombiningNode& o
             }
         }
     }
+    // BEATCONNECT MODIFICATION END
+}
+
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+void CombiningNode::createLanes()
+{
+    lanesCreated = true;
+
+    if (maxNumParallelInputs < 2)
+        return;
+
+    std::vector<std::pair<TimeRange, int*>> items;
+
+    for (auto i : inputs)
+        items.emplace_back (i->time, &i->lane);
+
+    for (auto li : lazyInputs)
+        items.emplace_back (li->time, &li->lane);
+
+    std::stable_sort (items.begin(), items.end(),
+                      [] (auto& i1, auto& i2) { return i1.first.getStart() < i2.first.getStart(); });
+
+    // Give each input the lane that finishes first, adding a new lane if that one's still busy,
+    // so overlapping inputs end up on different lanes
+    std::vector<TimePosition> laneEndTimes;
+
+    for (auto& item : items)
+    {
+        const auto time = item.first;
+        auto lane = std::min_element (laneEndTimes.begin(), laneEndTimes.end());
+
+        if ((lane == laneEndTimes.end() || *lane > time.getStart())
+             && (int) laneEndTimes.size() < maxNumParallelInputs)
+        {
+            *item.second = (int) laneEndTimes.size();
+            laneEndTimes.push_back (time.getEnd());
+            continue;
+        }
+
+        *item.second = (int) std::distance (laneEndTimes.begin(), lane);
+        *lane = std::max (*lane, time.getEnd());
+    }
+
+    // Nothing overlaps so there's no point using separate lanes
+    if (laneEndTimes.size() < 2)
+        return;
+
+    for (size_t i = 0; i < laneEndTimes.size(); ++i)
+        lanes.push_back (std::make_unique<Lane> (*this, (int) i));
+}
+
+choc::buffer::ChannelArrayView<float> CombiningNode::getTempAudioBufferView (int lane)
+{
+    if (lanes.empty())
+        return tempAudioBuffer.getView();
+
+    return lanes[(size_t) lane]->tempAudioBuffer.getView();
+}
+
+std::vector<uint32_t> CombiningNode::getAudioThreadEpochs() const
+{
+    std::vector<uint32_t> epochs { audioThreadEpoch.load() };
+
+    for (auto& lane : lanes)
+        epochs.push_back (lane->epoch.load());
+
+    return epochs;
+}
+
+bool CombiningNode::prefetchLane (juce::Range<int64_t> referenceSampleRange, TimeRange editTime,
+                                  int lane, std::atomic<uint32_t>& epoch)
+{
+    prefetchGroup (referenceSampleRange, editTime, lane);
+
+    // Update ready to process state based on nodes intersecting this time
+    bool isReady = true;
+
+    if (auto g = groups[combining_node_utils::timeToGroupIndex (editTime.getStart())])
+    {
+        for (auto tan : *g)
+        {
+            if (tan->lane == lane && ! tan->isReadyToProcess())
+            {
+                isReady = false;
+                break;
+            }
+        }
+    }
+
+    visitCreatedLazyInputs (editTime, lane, epoch, [&] (TimedNode& tan)
+                            {
+                                tan.prefetchBlock (referenceSampleRange);
+
+                                if (! tan.isReadyToProcess())
+                                    isReady = false;
+                            });
+
+    return isReady;
+}
+
+void CombiningNode::processLane (ProcessContext& pc, TimeRange editTime, int lane, std::atomic<uint32_t>& epoch,
+                                 choc::buffer::ChannelArrayBuffer<float>& laneAudioBuffer)
+{
+    if (auto g = groups[combining_node_utils::timeToGroupIndex (editTime.getStart())])
+    {
+        for (auto tan : *g)
+        {
+            if (tan->time.getEnd() > editTime.getStart())
+            {
+                if (tan->time.getStart() >= editTime.getEnd())
+                    break;
+
+                if (tan->lane != lane)
+                    continue;
+
+                // Clear the allocated storage
+                laneAudioBuffer.clear();
+
+                // Then process the buffer.
+                // This will use the local buffer for the Nodes in the TimedNode and put the result in pc.buffers
+                tan->process (pc);
+            }
+        }
+    }
+
+    // Nodes created since prefetchBlock was called will need prefetching first
+    visitCreatedLazyInputs (editTime, lane, epoch, [&] (TimedNode& tan)
+                            {
+                                laneAudioBuffer.clear();
+                                tan.prefetchBlock (pc.referenceSampleRange);
+                                tan.process (pc);
+                            });
+}
+
+template<typename Fn>
+void CombiningNode::visitCreatedLazyInputs (TimeRange editTime, int lane, std::atomic<uint32_t>& epoch, Fn&& fn)
+{
+    if (lazyInputs.isEmpty())
+        return;
+
+    // Let the loader know the nodes might be in use until this returns
+    epoch.fetch_add (1);
+
+    if (auto g = lazyGroups[combining_node_utils::timeToGroupIndex (editTime.getStart())])
+    {
+        for (auto li : *g)
+        {
+            if (li->time.getEnd() > editTime.getStart())
+            {
+                if (li->time.getStart() >= editTime.getEnd())
+                    break;
+
+                if (li->lane != lane)
+                    continue;
+
+                if (auto tan = li->node.load (std::memory_order_acquire))
+                    fn (*tan);
+            }
+        }
+    }
+
+    epoch.fetch_add (1);
+}
+
+void CombiningNode::updateLazyInputs()
+{
+    // N.B. this must only be called with the loader's lock held
+    CRASH_TRACER
+    deleteReleasedLazyNodes();
+
+    if (preparedNodeGraph == nullptr)
+        return;
+
+    auto& playHead = getPlayHead();
+    const auto position = TimePosition::fromSamples (playHead.getPosition(), preparedSampleRate);
+    const auto loopStart = playHead.isLooping() ? std::optional<TimePosition> (TimePosition::fromSamples (playHead.getLoopRange().getStart(), preparedSampleRate))
+                                                : std::nullopt;
+
+    auto isNear = [&] (TimeRange time, double secondsAhead)
+    {
+        auto isNearPosition = [&] (TimePosition p)
+        {
+            return time.getEnd() > p - TimeDuration::fromSeconds (combining_node_utils::lazyInputReleaseBehindSeconds)
+                && time.getStart() < p + TimeDuration::fromSeconds (secondsAhead);
+        };
+
+        return isNearPosition (position)
+            || (loopStart && isNearPosition (*loopStart))
+            || (lastLocatePosition && isNearPosition (*lastLocatePosition));
+    };
+
+    bool anyReleased = false;
+
+    for (auto li : lazyInputs)
+    {
+        if (li->ownedNode == nullptr)
+        {
+            if (! li->failedToCreate && isNear (li->time, combining_node_utils::lazyInputCreateAheadSeconds))
+                createLazyInput (*li);
+        }
+        else if (! isNear (li->time, combining_node_utils::lazyInputReleaseAheadSeconds))
+        {
+            li->node.store (nullptr);
+            releasedLazyNodes.push_back (std::move (li->ownedNode));
+            anyReleased = true;
+        }
+    }
+
+    if (anyReleased)
+    {
+        releasedLazyNodesEpochs = getAudioThreadEpochs();
+        deleteReleasedLazyNodes();
+    }
+}
+
+void CombiningNode::createLazyInput (LazyInput& li)
+{
+    auto node = li.createNode();
+
+    if (node == nullptr)
+    {
+        li.failedToCreate = true;
+        return;
+    }
+
+    auto props = node->getNodeProperties();
+
+    // The properties passed to addLazyInput don't match the node
+    if (props.numberOfChannels > (int) tempAudioBuffer.getNumChannels() || props.latencyNumSamples > 0)
+    {
+        jassertfalse;
+        li.failedToCreate = true;
+        return;
+    }
+
+    auto timedNode = std::make_unique<TimedNode> (std::move (node), li.time);
+    timedNode->prepareToPlay ({ preparedSampleRate, preparedBlockSize, *preparedNodeGraph, lazyNodeGraphToReplace.get() },
+                              getTempAudioBufferView (li.lane));
+
+    // The node is fully prepared before it's handed over, and the audio thread only
+    // ever sees it through this pointer, so nothing it's using is changed
+    li.ownedNode = std::move (timedNode);
+    li.node.store (li.ownedNode.get(), std::memory_order_release);
+}
+
+void CombiningNode::deleteReleasedLazyNodes()
+{
+    if (releasedLazyNodes.empty())
+        return;
+
+    // Released nodes can be deleted once none of the audio threads are in a call that
+    // might have started before they were released
+    const auto epochs = getAudioThreadEpochs();
+    jassert (epochs.size() == releasedLazyNodesEpochs.size());
+
+    for (size_t i = 0; i < epochs.size(); ++i)
+        if ((epochs[i] & 1) != 0 && epochs[i] == releasedLazyNodesEpochs[i])
+            return;
+
+    releasedLazyNodes.clear();
 }
+// BEATCONNECT MODIFICATION END
 
 }} // namespace tracktion { inline namespace engine
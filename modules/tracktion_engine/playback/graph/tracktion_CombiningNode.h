@@ -18,6 +18,15 @@ namespace tracktion { inline namespace engine
 
     It initialises and releases its inputs as required according to its current
     play position.
+
+    Inputs can also be added lazily with a function that creates them. These are only
+    created and prepared when the play position gets near them, and deleted again once
+    it's moved away, so tracks with thousands of clips don't have to build nodes for
+    clips nowhere near the playhead.
+
+    Overlapping inputs can be spread across a number of lanes, each of which is an input
+    Node of this one, so a multi-threaded player can process them in parallel.
+    @see setMaxNumParallelInputs
 */
 class CombiningNode final : public tracktion::graph::Node,
                             public TracktionEngineNode
@@ -39,6 +48,57 @@ public:
     /** Returns the number of inputs added. */
     int getNumInputs() const;
 
+    // BEATCONNECT MODIFICATION START
+    /** Adds an input that will only be created when the play position gets near it.
+
+        The function is called to create the node when the play position comes within a
+        few seconds of the time range, and the node is deleted once it has moved away.
+        The properties should be the ones the created node will have, as they're needed
+        before it exists. Nodes that aren't ready in time are skipped, so this should
+        only be used for playback, not rendering, and the nodes mustn't have any latency.
+
+        The function is called on the message thread, apart from when the CombiningNode
+        is first prepared where it's called for any nodes near the current play position
+        on the thread preparing the graph. When the play position is about to be moved,
+        call createLazyInputsNear so the nodes at the new position are ready in time.
+
+        @param createNode   Creates the node. This can return nullptr.
+        @param itemID       The ID of the clip the node is for
+    */
+    void addLazyInput (std::function<std::unique_ptr<Node>()> createNode, TimeRange,
+                       EditItemID itemID, tracktion::graph::NodeProperties);
+
+    /** Creates any lazy inputs at or just after a position straight away.
+        This should be called on the message thread before the play position is moved,
+        e.g. by a locate, so the first blocks played there aren't missed. Inputs near the
+        position are then kept until this is called with another position.
+    */
+    void createLazyInputsNear (TimePosition);
+
+    /** Returns the number of inputs added with addLazyInput. */
+    int getNumLazyInputs() const;
+
+    /** Returns the number of lazy inputs that currently have a node created. */
+    int getNumLazyInputsCreated() const;
+
+    /** Sets the maximum number of overlapping inputs that can be processed in parallel.
+
+        Inputs are assigned to lanes so that ones which overlap end up on different lanes,
+        and each lane becomes an input Node of this one that a multi-threaded player can
+        process on its own thread. The lanes are always summed in the same order, so the
+        output doesn't depend on how they were scheduled.
+
+        This must be called before the node is added to a graph. The default of 1 means
+        all the inputs are processed serially by this node.
+    */
+    void setMaxNumParallelInputs (int);
+
+    /** Returns the number of lanes the inputs are being processed on in parallel.
+        This will be 0 if they're all processed serially by this node.
+    */
+    int getNumParallelLanes() const;
+    // BEATCONNECT MODIFICATION END
+
     /** Returns the inputs that have been added.
         N.B. This is a bit of a temporary hack to ensure WaveNodes can access previous
         Nodes that have been added via a CombinngNode. This will be cleaned up in the future.
@@ -67,9 +127,49 @@ private:
 
     tracktion::graph::NodeProperties nodeProperties;
 
-    void prefetchGroup (juce::Range<int64_t>, TimeRange);
+    // BEATCONNECT MODIFICATION START
+    void prefetchGroup (juce::Range<int64_t>, TimeRange, int lane);
+    // BEATCONNECT MODIFICATION END
     void queueNoteOffsForClipsNoLongerPresent (const CombiningNode& oldNode);
 
+    // BEATCONNECT MODIFICATION START
+    struct LazyInput;
+    struct LazyInputLoader;
+    juce::OwnedArray<LazyInput> lazyInputs;
+    juce::OwnedArray<juce::Array<LazyInput*>> lazyGroups;
+    std::unique_ptr<LazyInputLoader> lazyInputLoader;
+
+    // Only used by the loader
+    double preparedSampleRate = 0.0;
+    int preparedBlockSize = 0;
+    tracktion::graph::NodeGraph* preparedNodeGraph = nullptr;
+    std::unique_ptr<tracktion::graph::NodeGraph> lazyNodeGraphToReplace;
+    std::optional<TimePosition> lastLocatePosition;
+    std::vector<std::unique_ptr<TimedNode>> releasedLazyNodes;
+    std::vector<uint32_t> releasedLazyNodesEpochs;
+
+    // Odd while the audio thread might be using a lazy node
+    std::atomic<uint32_t> audioThreadEpoch { 0 };
+
+    struct Lane;
+    std::vector<std::unique_ptr<Lane>> lanes;
+    int maxNumParallelInputs = 1;
+    bool lanesCreated = false;
+
+    void createLanes();
+    choc::buffer::ChannelArrayView<float> getTempAudioBufferView (int lane);
+    std::vector<uint32_t> getAudioThreadEpochs() const;
+    bool prefetchLane (juce::Range<int64_t>, TimeRange, int lane, std::atomic<uint32_t>& epoch);
+    void processLane (ProcessContext&, TimeRange, int lane, std::atomic<uint32_t>& epoch,
+                      choc::buffer::ChannelArrayBuffer<float>& laneAudioBuffer);
+
+    template<typename Fn>
+    void visitCreatedLazyInputs (TimeRange editTime, int lane, std::atomic<uint32_t>& epoch, Fn&&);
+    void updateLazyInputs();
+    void createLazyInput (LazyInput&);
+    void deleteReleasedLazyNodes();
+    // BEATCONNECT MODIFICATION END
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CombiningNode)
 };
 
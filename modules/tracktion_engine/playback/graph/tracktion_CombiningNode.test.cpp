@@ -0,0 +1,398 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+#if ENGINE_UNIT_TESTS_COMBININGNODE
+
+//==============================================================================
+//==============================================================================
+class CombiningNodeTests : public juce::UnitTest
+{
+public:
+    CombiningNodeTests()
+        : juce::UnitTest ("CombiningNode", "tracktion_engine")
+    {
+    }
+
+    void runTest() override
+    {
+        for (auto ts : tracktion::graph::test_utilities::getTestSetups (*this))
+        {
+            runLazyInputTests (ts, false);
+            runLazyInputTests (ts, true);
+            runLazyInputGraphTests (ts);
+            runLazyInputLocateTests (ts);
+            runParallelInputTests (ts);
+        }
+    }
+
+private:
+    //==============================================================================
+    /** Counts how many times one of these finds a node with its ID in the graph it's replacing. */
+    struct ReplacingNode final  : public tracktion::graph::Node
+    {
+        ReplacingNode (size_t id)  : nodeID (id) {}
+
+        tracktion::graph::NodeProperties getNodeProperties() override
+        {
+            tracktion::graph::NodeProperties props;
+            props.hasAudio = true;
+            props.numberOfChannels = 1;
+            props.nodeID = nodeID;
+            return props;
+        }
+
+        std::vector<Node*> getDirectInputNodes() override   { return {}; }
+        bool isReadyToProcess() override                    { return true; }
+        void process (ProcessContext&) override             {}
+
+        void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info) override
+        {
+            if (tracktion::graph::findNodeWithIDIfNonZero<ReplacingNode> (info.nodeGraphToReplace, nodeID) != nullptr)
+                ++numReplaced;
+        }
+
+        const size_t nodeID;
+        static inline std::atomic<int> numReplaced { 0 };
+    };
+
+    //==============================================================================
+    void runLazyInputTests (tracktion::graph::test_utilities::TestSetup ts, bool lazy)
+    {
+        using namespace tracktion::graph;
+
+        beginTest (juce::String (lazy ? "Lazy" : "Eager") + " inputs: " + test_utilities::getDescription (ts));
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState (playHead);
+        ProcessState processState (playHeadState);
+        playHead.playSyncedToRange ({ 0, std::numeric_limits<int64_t>::max() });
+
+        // Half a second of sin at the start, then more much later on
+        const TimeRange clipTimes[] = { { TimePosition(), TimePosition::fromSeconds (0.5) },
+                                        { TimePosition::fromSeconds (60.0), TimePosition::fromSeconds (61.0) },
+                                        { TimePosition::fromSeconds (120.0), TimePosition::fromSeconds (121.0) } };
+        int numCreated[3] = {};
+
+        auto combiningNode = std::make_unique<CombiningNode> (EditItemID::fromRawID (1), processState);
+        auto combiningNodePtr = combiningNode.get();
+
+        for (int i = 0; i < 3; ++i)
+        {
+            const auto nodeID = (size_t) i + 100;
+
+            if (lazy)
+            {
+                NodeProperties props;
+                props.hasAudio = true;
+                props.numberOfChannels = 1;
+                props.nodeID = nodeID;
+
+                combiningNode->addLazyInput ([&numCreated, i, nodeID]
+                                             {
+                                                 ++numCreated[i];
+                                                 return std::make_unique<SinNode> (220.0f, 1, nodeID);
+                                             },
+                                             clipTimes[i], EditItemID::fromRawID ((uint64_t) nodeID), props);
+            }
+            else
+            {
+                combiningNode->addInput (std::make_unique<SinNode> (220.0f, 1, nodeID), clipTimes[i]);
+            }
+        }
+
+        expectEquals (combiningNodePtr->getNumInputs(), lazy ? 0 : 3);
+        expectEquals (combiningNodePtr->getNumLazyInputs(), lazy ? 3 : 0);
+        expectEquals (combiningNodePtr->getNumLazyInputsCreated(), 0);
+
+        test_utilities::TestProcess<TracktionNodePlayer> testProcess (std::make_unique<TracktionNodePlayer> (std::move (combiningNode), processState, ts.sampleRate, ts.blockSize,
+                                                                                                             getPoolCreatorFunction (ThreadPoolStrategy::realTime)),
+                                                                      ts, 1, 1.0, true);
+
+        if (lazy)
+        {
+            expectEquals (combiningNodePtr->getNumLazyInputsCreated(), 1, "Only the input near the play position should be created");
+            expect (numCreated[0] > 0);
+            expectEquals (numCreated[1], 0);
+            expectEquals (numCreated[2], 0);
+        }
+
+        auto testContext = testProcess.processAll();
+        test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, juce::roundToInt (ts.sampleRate / 2.0),
+                                           1.0f, 0.707f, 0.0f, 0.0f);
+    }
+
+    void runLazyInputGraphTests (tracktion::graph::test_utilities::TestSetup ts)
+    {
+        using namespace tracktion::graph;
+
+        beginTest ("Lazy inputs in the graph: " + test_utilities::getDescription (ts));
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState (playHead);
+        ProcessState processState (playHeadState);
+        playHead.playSyncedToRange ({ 0, std::numeric_limits<int64_t>::max() });
+
+        // One input at the start and another a minute later
+        auto createCombiningNode = [&processState] (bool lazy)
+        {
+            auto combiningNode = std::make_unique<CombiningNode> (EditItemID::fromRawID (1), processState);
+
+            for (int i = 0; i < 2; ++i)
+            {
+                const auto nodeID = (size_t) i + 100;
+                const TimeRange time (TimePosition::fromSeconds (i * 60.0), TimeDuration::fromSeconds (1.0));
+
+                if (lazy)
+                {
+                    NodeProperties props;
+                    props.hasAudio = true;
+                    props.numberOfChannels = 1;
+                    props.nodeID = nodeID;
+
+                    combiningNode->addLazyInput ([nodeID] { return std::make_unique<ReplacingNode> (nodeID); },
+                                                 time, EditItemID::fromRawID ((uint64_t) nodeID), props);
+                }
+                else
+                {
+                    combiningNode->addInput (std::make_unique<ReplacingNode> (nodeID), time);
+                }
+            }
+
+            return combiningNode;
+        };
+
+        expect (createCombiningNode (true)->getNodeProperties().nodeID == createCombiningNode (false)->getNodeProperties().nodeID,
+                "The ID shouldn't depend on whether the inputs are created lazily");
+
+        auto nodeGraph = node_player_utils::prepareToPlay (createCombiningNode (true), nullptr, ts.sampleRate, ts.blockSize);
+        expect (findNodeWithID<ReplacingNode> (*nodeGraph, 100) == nullptr, "Lazy inputs shouldn't change the map of the graph they're playing in");
+
+        // A graph replacing this one should still be able to take over the created node's state
+        auto newNodeGraph = node_player_utils::prepareToPlay (createCombiningNode (true), nodeGraph.get(), ts.sampleRate, ts.blockSize);
+        auto newCombiningNode = dynamic_cast<CombiningNode*> (newNodeGraph->rootNode.get());
+        expect (newCombiningNode != nullptr);
+
+        if (newCombiningNode != nullptr)
+        {
+            expectEquals (newCombiningNode->getNumLazyInputsCreated(), 1);
+            expectEquals (ReplacingNode::numReplaced.load(), 1, "The new lazy node should find the one it's replacing");
+        }
+
+        ReplacingNode::numReplaced = 0;
+    }
+
+    void runLazyInputLocateTests (tracktion::graph::test_utilities::TestSetup ts)
+    {
+        using namespace tracktion::graph;
+
+        beginTest ("Locating to lazy inputs: " + test_utilities::getDescription (ts));
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState (playHead);
+        ProcessState processState (playHeadState);
+        playHead.play ({ 0, std::numeric_limits<int64_t>::max() }, false);
+
+        // An input a minute in, well outside the range that's created ahead of the play position
+        const TimeRange clipTime (TimePosition::fromSeconds (60.0), TimeDuration::fromSeconds (10.0));
+
+        auto combiningNode = std::make_unique<CombiningNode> (EditItemID::fromRawID (1), processState);
+        auto combiningNodePtr = combiningNode.get();
+
+        NodeProperties props;
+        props.hasAudio = true;
+        props.numberOfChannels = 1;
+        props.nodeID = 100;
+        combiningNode->addLazyInput ([] { return std::make_unique<SinNode> (220.0f, 1, 100); },
+                                     clipTime, EditItemID::fromRawID (100), props);
+
+        test_utilities::TestProcess<TracktionNodePlayer> testProcess (std::make_unique<TracktionNodePlayer> (std::move (combiningNode), processState, ts.sampleRate, ts.blockSize,
+                                                                                                             getPoolCreatorFunction (ThreadPoolStrategy::realTime)),
+                                                                      ts, 1, 1.0, true);
+        testProcess.setPlayHead (&playHead);
+
+        const int numSamplesBeforeLocate = juce::roundToInt (ts.sampleRate / 10.0);
+        testProcess.process (numSamplesBeforeLocate);
+        expectEquals (combiningNodePtr->getNumLazyInputsCreated(), 0);
+
+        // The transport creates the inputs at the new position before moving the play head there,
+        // without waiting for the loader's timer
+        combiningNodePtr->createLazyInputsNear (clipTime.getStart());
+        expectEquals (combiningNodePtr->getNumLazyInputsCreated(), 1, "The input at the new position should be created straight away");
+        playHead.setPosition (toSamples (clipTime.getStart(), ts.sampleRate));
+
+        testProcess.process (ts.blockSize);
+        auto testContext = testProcess.getTestResult();
+        expectGreaterThan (testContext->buffer.getMagnitude (0, numSamplesBeforeLocate, ts.blockSize), 0.5f,
+                           "The first block after the locate shouldn't be silent");
+    }
+
+    void runParallelInputTests (tracktion::graph::test_utilities::TestSetup ts)
+    {
+        using namespace tracktion::graph;
+
+        beginTest ("Parallel inputs: " + test_utilities::getDescription (ts));
+
+        // Four clips overlapping in the first second and a fifth on its own after them
+        const TimeRange clipTimes[] = { { TimePosition(), TimePosition::fromSeconds (1.0) },
+                                        { TimePosition::fromSeconds (0.25), TimePosition::fromSeconds (1.0) },
+                                        { TimePosition::fromSeconds (0.5), TimePosition::fromSeconds (1.0) },
+                                        { TimePosition::fromSeconds (0.5), TimePosition::fromSeconds (0.75) },
+                                        { TimePosition::fromSeconds (1.0), TimePosition::fromSeconds (1.5) } };
+
+        auto render = [&] (int maxNumParallelInputs, size_t numThreads, int expectedNumLanes)
+        {
+            tracktion::graph::PlayHead playHead;
+            tracktion::graph::PlayHeadState playHeadState (playHead);
+            ProcessState processState (playHeadState);
+            playHead.playSyncedToRange ({ 0, std::numeric_limits<int64_t>::max() });
+
+            auto combiningNode = std::make_unique<CombiningNode> (EditItemID::fromRawID (1), processState);
+            auto combiningNodePtr = combiningNode.get();
+            combiningNode->setMaxNumParallelInputs (maxNumParallelInputs);
+
+            for (int i = 0; i < juce::numElementsInArray (clipTimes); ++i)
+                combiningNode->addInput (std::make_unique<SinNode> (110.0f * (i + 1), 1, (size_t) i + 100), clipTimes[i]);
+
+            test_utilities::TestProcess<TracktionNodePlayer> testProcess (std::make_unique<TracktionNodePlayer> (std::move (combiningNode), processState, ts.sampleRate, ts.blockSize,
+                                                                                                                 getPoolCreatorFunction (ThreadPoolStrategy::realTime)),
+                                                                          ts, 1, 1.5, true);
+            testProcess.getNodePlayer().setNumThreads (numThreads);
+            expectEquals (combiningNodePtr->getNumParallelLanes(), expectedNumLanes);
+
+            return testProcess.processAll();
+        };
+
+        auto serial = render (1, 0, 0);
+        auto parallel = render (8, 4, 4);
+
+        expectEquals (render (2, 4, 2)->buffer.getNumSamples(), serial->buffer.getNumSamples());
+        expectEquals (parallel->buffer.getNumSamples(), serial->buffer.getNumSamples());
+
+        float maxDifference = 0.0f;
+
+        for (int i = 0; i < serial->buffer.getNumSamples(); ++i)
+            maxDifference = std::max (maxDifference, std::abs (serial->buffer.getSample (0, i) - parallel->buffer.getSample (0, i)));
+
+        expectLessThan (maxDifference, 0.0001f, "Parallel inputs should sound the same as serial ones");
+
+        // The lanes are always summed in the same order so every render should be identical
+        for (int n = 0; n < 3; ++n)
+        {
+            auto other = render (8, 4, 4);
+            bool identical = other->buffer.getNumSamples() == parallel->buffer.getNumSamples();
+
+            for (int i = 0; identical && i < parallel->buffer.getNumSamples(); ++i)
+                identical = other->buffer.getSample (0, i) == parallel->buffer.getSample (0, i);
+
+            expect (identical, "Parallel renders should be deterministic");
+        }
+    }
+};
+
+static CombiningNodeTests combiningNodeTests;
+
+#endif // ENGINE_UNIT_TESTS_COMBININGNODE
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+class CombiningNodeBenchmarks : public juce::UnitTest
+{
+public:
+    CombiningNodeBenchmarks()
+        : juce::UnitTest ("CombiningNode", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+        constexpr int numClips = 32;
+        constexpr double clipDuration = 10.0;
+
+        // A single track with 32 clips all playing at once, each being time-stretched in real-time
+        auto sinFile = tracktion::graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, clipDuration, 2, 220.0f);
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+
+        for (int i = 0; i < numClips; ++i)
+        {
+            auto clip = track->insertWaveClip ("clip" + juce::String (i), sinFile->getFile(),
+                                               {{ 0_tp, TimeDuration::fromSeconds (clipDuration) }}, false);
+            clip->setUsesProxy (false);
+            clip->setTimeStretchMode (TimeStretcher::defaultMode);
+            clip->setSpeedRatio (0.75 + i * 0.01);
+            clip->setGainDB (gainToDb (1.0f / numClips));
+        }
+
+        for (int maxNumParallelClips : { 1, 4, 8, 32 })
+            for (auto multiThreaded : { false, true })
+                runStretchedClips (*edit, numClips, maxNumParallelClips, multiThreaded);
+    }
+
+private:
+    void runStretchedClips (Edit& edit, int numClips, int maxNumParallelClips, bool multiThreaded)
+    {
+        using namespace tracktion::graph;
+
+        test_utilities::TestSetup ts;
+        ts.sampleRate = 44100.0;
+        ts.blockSize = 256;
+
+        const auto name = std::to_string (numClips) + " stretched clips, max parallel: "
+                            + std::to_string (maxNumParallelClips) + (multiThreaded ? ", MT" : ", ST");
+        beginTest (name);
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState { playHead };
+        ProcessState processState { playHeadState, edit.tempoSequence };
+
+        CreateNodeParams params { processState };
+        params.sampleRate = ts.sampleRate;
+        params.blockSize = ts.blockSize;
+        params.forRendering = true;
+        params.maxNumParallelClipsPerTrack = maxNumParallelClips;
+        auto node = createNodeForEdit (edit, params);
+
+        test_utilities::TestProcess<TracktionNodePlayer> testProcess (std::make_unique<TracktionNodePlayer> (std::move (node), processState, ts.sampleRate, ts.blockSize,
+                                                                                                             getPoolCreatorFunction (ThreadPoolStrategy::lightweightSemaphore)),
+                                                                      ts, 2, edit.getLength().inSeconds(), false);
+
+        if (! multiThreaded)
+            testProcess.getNodePlayer().setNumThreads (0);
+
+        testProcess.setPlayHead (&playHeadState.playHead);
+        playHeadState.playHead.playSyncedToRange ({});
+
+        {
+            ScopedBenchmark sb (createBenchmarkDescription (*this, name));
+            testProcess.processAll();
+        }
+
+        // All the clips overlap, so each clip should get its own lane, up to the maximum
+        int numLanes = 0;
+
+        for (auto n : getNodes (testProcess.getNode(), VertexOrdering::postordering))
+            if (auto combiningNode = dynamic_cast<CombiningNode*> (n))
+                numLanes += combiningNode->getNumParallelLanes();
+
+        expectEquals (numLanes, maxNumParallelClips > 1 ? std::min (maxNumParallelClips, numClips) : 0);
+    }
+};
+
+static CombiningNodeBenchmarks combiningNodeBenchmarks;
+
+#endif // TRACKTION_BENCHMARKS
+
+}} // namespace tracktion { inline namespace engine
@@ -721,6 +721,67 @@ std::unique_ptr<tracktion::graph::Node> createNodeForClip (Clip& clip, const Tra
     return {};
 }
 
+// BEATCONNECT MODIFICATION START
+bool canCreateNodeForClipLazily (Clip& clip, const CreateNodeParams& params)
+{
+    // Clip plugins can change the number of channels so these are always created up front
+    if (params.includePlugins)
+        if (auto pluginList = clip.getPluginList())
+            if (pluginList->size() > 0)
+                return false;
+
+    // Clips that wouldn't get a node, or would get one with a different layout, are
+    // created up front so the CombiningNode gets the same inputs either way
+    if (auto audioClip = dynamic_cast<AudioClipBase*> (&clip))
+        return ! audioClip->isUsingMelodyne()
+            && ! audioClip->usesTimestretchedPreview()
+            && ! audioClip->getPlaybackFile().isNull();
+
+    return dynamic_cast<MidiClip*> (&clip) != nullptr
+        || dynamic_cast<StepClip*> (&clip) != nullptr;
+}
+
+/** Returns the ID of the node createNodeForClip will return for a clip that can be
+    created lazily, so the CombiningNode's ID is derived in the same way as when it's
+    given the node up front.
+*/
+size_t getLazyNodeIDForClip (Clip& clip)
+{
+    // These clips' nodes are wrapped in nodes that don't have an ID
+    if (auto audioClip = dynamic_cast<AudioClipBase*> (&clip))
+    {
+        if (audioClip->getFadeIn() > 0_td || audioClip->getFadeOut() > 0_td)
+            return 0;
+    }
+    else if (dynamic_cast<StepClip*> (&clip) != nullptr)
+    {
+        if (! clip.getListeners().isEmpty())
+            return 0;
+    }
+
+    return (size_t) clip.itemID.getRawID();
+}
+
+/** Returns the properties the node created by createNodeForClip will have. */
+tracktion::graph::NodeProperties getLazyNodePropertiesForClip (Clip& clip)
+{
+    tracktion::graph::NodeProperties props;
+    props.nodeID = getLazyNodeIDForClip (clip);
+
+    if (auto audioClip = dynamic_cast<AudioClipBase*> (&clip))
+    {
+        props.hasAudio = true;
+        props.numberOfChannels = std::max (2, audioClip->getActiveChannels().size());
+    }
+    else
+    {
+        props.hasMidi = true;
+    }
+
+    return props;
+}
+// BEATCONNECT MODIFICATION END
+
 std::unique_ptr<tracktion::graph::Node> createNodeForClips (EditItemID trackID, const juce::Array<Clip*>& clips, const TrackMuteState& trackMuteState, const CreateNodeParams& params)
 {
     // If there are no clips, we still need to send note-offs for clips that might have been deleted whilst still playing
@@ -773,24 +834,66 @@ std::unique_ptr<tracktion::graph::Node> createNodeForClips (EditItemID trackID,
 
     auto combiner = std::make_unique<CombiningNode> (trackID, params.processState);
 
+    // BEATCONNECT MODIFICATION START
+    auto& engineBehaviour = clips.getFirst()->edit.engine.getEngineBehaviour();
+
+    // Let overlapping clips be processed on different threads
+    combiner->setMaxNumParallelInputs (params.maxNumParallelClipsPerTrack > 0 ? params.maxNumParallelClipsPerTrack
+                                                                              : engineBehaviour.getMaxNumParallelClipsPerTrack());
+
+    // For tracks with lots of clips, only create the nodes for clips near the play position
+    const bool createNodesLazily = ! params.forRendering
+        && clips.size() >= engineBehaviour.getMinNumClipsToCreateClipNodesLazily();
+
+    auto lazyParams = params;
+    lazyParams.allowedClips = nullptr;
+    lazyParams.allowedTracks = nullptr;
+    // BEATCONNECT MODIFICATION END
+
     // Use a CombiningNode for most clips
     for (auto clip : clips)
+    {
         if (params.allowedClips == nullptr || params.allowedClips->contains (clip))
+        {
+            // BEATCONNECT MODIFICATION START
+            if (createNodesLazily && canCreateNodeForClipLazily (*clip, params))
+            {
+                // The TrackMuteState is owned by the TrackMutingNode this combiner is an input
+                // of, which deletes its input (and so the combiner's loader) before it
+                // deletes the TrackMuteState, so it can be referenced like the eager nodes do
+                combiner->addLazyInput ([clipRef = clip->getWeakRef(), &trackMuteState, lazyParams]() -> std::unique_ptr<Node>
+                                        {
+                                            if (auto c = dynamic_cast<Clip*> (clipRef.get()))
+                                                return createNodeForClip (*c, trackMuteState, lazyParams);
+
+                                            return {};
+                                        },
+                                        clip->getPosition().time, clip->itemID,
+                                        getLazyNodePropertiesForClip (*clip));
+                continue;
+            }
+            // BEATCONNECT MODIFICATION END
+
             if (auto clipNode = createNodeForClip (*clip, trackMuteState, params))
                 combiner->addInput (std::move (clipNode), clip->getPosition().time);
+        }
+    }
 
     return combiner;
 }
 
 //==============================================================================
-std::unique_ptr<tracktion::graph::Node> createNodeForFrozenAudioTrack (AudioTrack& track, tracktion::graph::PlayHeadState& playHeadState, const CreateNodeParams& params)
+// BEATCONNECT MODIFICATION START
+std::unique_ptr<tracktion::graph::Node> createNodeForFrozenAudioTrack (AudioTrack& track, const juce::File& freezeFile, TimeRange freezeTime,
+                                                                      tracktion::graph::PlayHeadState& playHeadState, const CreateNodeParams& params)
 {
     jassert (! params.forRendering);
 
     const bool processMidiWhenMuted = track.state.getProperty (IDs::processMidiWhenMuted, false);
     auto trackMuteState = std::make_unique<TrackMuteState> (track, false, processMidiWhenMuted);
-    auto node = tracktion::graph::makeNode<WaveNode> (AudioFile (track.edit.engine, TemporaryFileManager::getFreezeFileForTrack (track)),
-                                                     TimeRange (TimePosition(), track.getLengthIncludingInputTracks()),
+    auto node = tracktion::graph::makeNode<WaveNode> (AudioFile (track.edit.engine, freezeFile),
+                                                     freezeTime,
+// BEATCONNECT MODIFICATION END
                                                      TimeDuration(), TimeRange(), LiveClipLevel(),
                                                      1.0, juce::AudioChannelSet::stereo(), juce::AudioChannelSet::stereo(),
                                                      params.processState,
@@ -1023,8 +1126,10 @@ std::unique_ptr<tracktion::graph::Node> createPluginNodeForList (PluginList& lis
 {
     for (auto p : list)
     {
-        if (! params.forRendering && p->isFrozen())
+        // BEATCONNECT MODIFICATION START
+        if (! params.forRendering && (p->isFrozen() || p->isAutoFrozen()))
             continue;
+        // BEATCONNECT MODIFICATION END
         
         if (auto meterPlugin = dynamic_cast<LevelMeterPlugin*> (p))
         {
@@ -1147,15 +1252,31 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioTrack (AudioTrack& at,
     jassert (at.isProcessing (false));
     auto& playHeadState = params.processState.playHeadState;
 
+    // BEATCONNECT MODIFICATION START
     if (! params.forRendering && at.isFrozen (AudioTrack::individualFreeze))
-        return createNodeForFrozenAudioTrack (at, playHeadState, params);
+        return createNodeForFrozenAudioTrack (at, TemporaryFileManager::getFreezeFileForTrack (at),
+                                              TimeRange (TimePosition(), at.getLengthIncludingInputTracks()),
+                                              playHeadState, params);
+
+    if (! params.forRendering)
+        if (auto autoFreezeManager = at.edit.getAutoFreezeManager())
+            if (auto frozen = autoFreezeManager->getFrozenTrack (at))
+                return createNodeForFrozenAudioTrack (at, frozen->file, frozen->time, playHeadState, params);
+    // BEATCONNECT MODIFICATION END
 
     auto inputTracks = getDirectInputTracks (at);
     const bool processMidiWhenMuted = at.state.getProperty (IDs::processMidiWhenMuted, false);
     auto clipsMuteState = std::make_unique<TrackMuteState> (at, true, processMidiWhenMuted);
     auto trackMuteState = std::make_unique<TrackMuteState> (at, false, processMidiWhenMuted);
 
-    const auto& clips = at.getClips();
+    // BEATCONNECT MODIFICATION START
+    juce::Array<Clip*> clipsInRange;
+
+    if (params.clipTimeRange)
+        clipsInRange = at.getClipsInRange (*params.clipTimeRange);
+
+    const auto& clips = params.clipTimeRange ? clipsInRange : at.getClips();
+    // BEATCONNECT MODIFICATION END
     std::unique_ptr<Node> node = createClipsNode (at.itemID, clips, *clipsMuteState, params);
     
     if (node)
@@ -32,6 +32,10 @@ struct CreateNodeParams
     bool addAntiDenormalisationNoise = false;           /**< Whether to add low level anti-denormalisation noise to the output. */
     bool includeBypassedPlugins = true;                 /**< If false, bypassed plugins will be completely ommited from the graph. */
     bool implicitlyIncludeSubmixChildTracks = true;     /**< If true, chid track in submixes will be included regardless of the allowedTracks param. Only relevent when forRendering is also true. */
+    // BEATCONNECT MODIFICATION START
+    int maxNumParallelClipsPerTrack = 0;                /**< The maximum number of overlapping clips on a track to process in parallel. If this is 0, EngineBehaviour::getMaxNumParallelClipsPerTrack is used. */
+    std::optional<TimeRange> clipTimeRange;             /**< If set, only clips overlapping this range will be included. Useful when only part of a long Edit will be played or rendered. */
+    // BEATCONNECT MODIFICATION END
 };
 
 //==============================================================================
@@ -431,12 +431,25 @@ namespace MidiHelpers
         }
     }
 
+    // BEATCONNECT MODIFICATION START
+    /** createNoteOffMap adds the note-ons in order so they can be found with a binary search. */
+    inline std::vector<std::pair<size_t, size_t>>::const_iterator findNoteOff (size_t noteOnIndex,
+                                                                               const std::vector<std::pair<size_t, size_t>>& noteOffMap)
+    {
+        auto found = std::lower_bound (noteOffMap.begin(), noteOffMap.end(), noteOnIndex,
+                                       [] (const auto& m, size_t index) { return m.first < index; });
+
+        if (found != noteOffMap.end() && found->first == noteOnIndex)
+            return found;
+
+        return noteOffMap.end();
+    }
+
     inline choc::midi::Sequence::Event* getNoteOff (size_t noteOnIndex,
                                                     choc::midi::Sequence& ms,
                                                     const std::vector<std::pair<size_t, size_t>>& noteOffMap)
     {
-        auto found = std::find_if (noteOffMap.begin(), noteOffMap.end(),
-                                   [noteOnIndex] (const auto& m) { return m.first == noteOnIndex; });
+        auto found = findNoteOff (noteOnIndex, noteOffMap);
 
         if (found != noteOffMap.end())
             return &ms.events[found->second];
@@ -448,14 +461,14 @@ namespace MidiHelpers
                                                           const choc::midi::Sequence& ms,
                                                           const std::vector<std::pair<size_t, size_t>>& noteOffMap)
     {
-        auto found = std::find_if (noteOffMap.begin(), noteOffMap.end(),
-                                   [noteOnIndex] (const auto& m) { return m.first == noteOnIndex; });
+        auto found = findNoteOff (noteOnIndex, noteOffMap);
 
         if (found != noteOffMap.end())
             return &ms.events[found->second];
 
         return {};
     }
+    // BEATCONNECT MODIFICATION END
 
     inline void applyQuantisationToSequence (const QuantisationType& q, bool canQuantiseNoteOffs,
                                              choc::midi::Sequence& ms, const std::vector<std::pair<size_t, size_t>>& noteOffMap)
@@ -670,6 +683,11 @@ public:
     //==============================================================================
     virtual void cacheSequence (double /*offset*/) {}
 
+    // BEATCONNECT MODIFICATION START
+    /** Called with the offset the next call to cacheSequence is likely to use so it can be prepared in advance. */
+    virtual void prepareNextSequence (double /*offset*/) {}
+    // BEATCONNECT MODIFICATION END
+
     virtual void setTime (double) = 0;
     virtual bool advance() = 0;
 
@@ -773,6 +791,79 @@ struct EventGenerator   : public MidiGenerator
 };
 
 
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+/** A shared thread that prepares the next loop iterations of CachingMidiEventGenerators. */
+class MidiLoopPreparationThread  : private juce::Thread
+{
+public:
+    MidiLoopPreparationThread()
+        : juce::Thread ("MIDI loop preparation")
+    {
+        startThread (juce::Thread::Priority::high);
+    }
+
+    ~MidiLoopPreparationThread() override
+    {
+        signalThreadShouldExit();
+        preparationRequested.signal();
+        stopThread (5000);
+    }
+
+    /** Lets the thread know there's a sequence to prepare.
+        Unlike Thread::notify, this doesn't take a lock so is safe to call from the audio thread.
+    */
+    void triggerPreparation()
+    {
+        preparationRequested.signal();
+    }
+
+    template<typename GeneratorType>
+    void addGenerator (GeneratorType& g)
+    {
+        const juce::ScopedLock sl (lock);
+        generators.add ({ &g, [] (void* gen) { static_cast<GeneratorType*> (gen)->prepareRequestedSequence(); } });
+    }
+
+    /** Removes a generator, waiting for any preparation it's doing to finish. */
+    void removeGenerator (void* g)
+    {
+        const juce::ScopedLock sl (lock);
+        generators.removeIf ([g] (auto& entry) { return entry.generator == g; });
+    }
+
+private:
+    struct Entry
+    {
+        void* generator = nullptr;
+        void (*prepare) (void*) = nullptr;
+    };
+
+    juce::CriticalSection lock;
+    juce::Array<Entry> generators;
+    tracktion::graph::LightweightSemaphore preparationRequested;
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            preparationRequested.wait();
+
+            // Several requests made whilst this was busy only need one pass
+            while (preparationRequested.try_wait())
+            {}
+
+            const juce::ScopedLock sl (lock);
+
+            for (auto& entry : generators)
+                entry.prepare (entry.generator);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (MidiLoopPreparationThread)
+};
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 //==============================================================================
 class CachingMidiEventGenerator : public MidiGenerator
@@ -780,11 +871,16 @@ class CachingMidiEventGenerator : public MidiGenerator
 public:
     CachingMidiEventGenerator (std::vector<juce::MidiMessageSequence> seq,
                                QuantisationType qt,
-                               const GrooveTemplate& grooveTemplate, float grooveStrength_)
+                               const GrooveTemplate& grooveTemplate, float grooveStrength_,
+                               bool prepareSequencesInBackground,
+                               std::atomic<int>* numBackgroundPreparedIterationsToUpdate,
+                               std::atomic<int>* numPendingBackgroundPreparationsToUpdate)
         : sequences (std::move (seq)),
           quantisation (std::move (qt)),
           groove (grooveTemplate),
-          grooveStrength (grooveStrength_)
+          grooveStrength (grooveStrength_),
+          numBackgroundPreparedIterations (numBackgroundPreparedIterationsToUpdate),
+          numPendingBackgroundPreparations (numPendingBackgroundPreparationsToUpdate)
     {
         // Cache the sequence at 0.0 time to reserve the required storage
         cacheSequence (0.0);
@@ -810,7 +906,31 @@ public:
 
         noteOffMap.reserve (maxNumNoteOns);
         currentSequence.events.reserve (maxNumEvents);
+
+        // BEATCONNECT MODIFICATION START
+        if (prepareSequencesInBackground)
+        {
+            nextSequence.noteOffMap.reserve (maxNumNoteOns);
+            nextSequence.sequence.events.reserve (maxNumEvents);
+
+            preparationThread.emplace();
+            (*preparationThread)->addGenerator (*this);
+        }
+        // BEATCONNECT MODIFICATION END
+    }
+
+    // BEATCONNECT MODIFICATION START
+    ~CachingMidiEventGenerator() override
+    {
+        if (preparationThread)
+        {
+            (*preparationThread)->removeGenerator (this);
+
+            if (nextSequenceState.load() == SequenceState::requested)
+                updateNumPendingPreparations (-1);
+        }
     }
+    // BEATCONNECT MODIFICATION END
 
     void createMessagesForTime (MidiMessageArray& destBuffer,
                                 EditBeatPosition editBeatPosition,
@@ -820,6 +940,10 @@ public:
                                 bool useMPEChannelMode, MidiMessageArray::MPESourceID midiSourceID,
                                 juce::Array<juce::MidiMessage>& controllerMessagesScratchBuffer) override
     {
+        // BEATCONNECT MODIFICATION START
+        requestPendingSequence();
+        // BEATCONNECT MODIFICATION END
+
         generator.createMessagesForTime (destBuffer,
                                          editBeatPosition,
                                          noteList,
@@ -844,38 +968,62 @@ public:
 
     void cacheSequence (double offsetBeats) override
     {
-        // Create a new sequence by:
-        // - Iterating the current sequence
-        // - Adding the offset timestamp to get Edit times
-        // - Applying the quantisation
-        // - Applying the groove
-        // - Sortign so events are in order
-        // - Setting the sequence to be iterated
-        // - Updating the offset used
+        // BEATCONNECT MODIFICATION START
+        const auto nextSequenceIndex = getNextSequenceIndex();
 
-        if (sequences.size() > 0)
-            if (++currentSequenceIndex >= sequences.size())
-                currentSequenceIndex = 0;
-
-        // Create the cached sequence (without allocating)
-        currentSequence.events.clear();
+        // If the next sequence has already been prepared, swapping it in doesn't allocate
+        if (nextSequenceState.load (std::memory_order_acquire) == SequenceState::ready
+            && nextSequence.offset == offsetBeats
+            && nextSequence.sequenceIndex == nextSequenceIndex)
+        {
+            std::swap (currentSequence.events, nextSequence.sequence.events);
+            std::swap (noteOffMap, nextSequence.noteOffMap);
+            nextSequenceState.store (SequenceState::idle, std::memory_order_release);
 
-        if (currentSequenceIndex < sequences.size())
-            MidiHelpers::addSequence (currentSequence, sequences[currentSequenceIndex], offsetBeats);
+            if (numBackgroundPreparedIterations != nullptr)
+                numBackgroundPreparedIterations->fetch_add (1, std::memory_order_relaxed);
+        }
+        else
+        {
+            // Cancel any preparation that hasn't started yet as it's for the wrong position
+            auto expected = SequenceState::requested;
 
-        jassert (std::is_sorted (currentSequence.begin(), currentSequence.end()));
-        MidiHelpers::createNoteOffMap (noteOffMap, currentSequence);
-        MidiHelpers::applyQuantisationToSequence (quantisation, false, currentSequence, noteOffMap);
+            if (nextSequenceState.compare_exchange_strong (expected, SequenceState::idle))
+                updateNumPendingPreparations (-1);
 
-        if (! groove.isEmpty())
-            MidiHelpers::applyGrooveToSequence (groove, grooveStrength, currentSequence);
+            createSequence (currentSequence, noteOffMap, nextSequenceIndex, offsetBeats);
+        }
 
-        currentSequence.sortEvents();
-        MidiHelpers::createNoteOffMap (noteOffMap, currentSequence);
+        currentSequenceIndex = nextSequenceIndex;
+        // BEATCONNECT MODIFICATION END
 
         cachedSequenceOffset = offsetBeats;
     }
 
+    // BEATCONNECT MODIFICATION START
+    void prepareNextSequence (double offsetBeats) override
+    {
+        if (! preparationThread)
+            return;
+
+        pendingRequest = { offsetBeats, getNextSequenceIndex() };
+        requestPendingSequence();
+    }
+
+    /** Called on the preparation thread to create any requested sequence. */
+    void prepareRequestedSequence()
+    {
+        auto expected = SequenceState::requested;
+
+        if (! nextSequenceState.compare_exchange_strong (expected, SequenceState::preparing))
+            return;
+
+        createSequence (nextSequence.sequence, nextSequence.noteOffMap, nextSequence.sequenceIndex, nextSequence.offset);
+        nextSequenceState.store (SequenceState::ready, std::memory_order_release);
+        updateNumPendingPreparations (-1);
+    }
+    // BEATCONNECT MODIFICATION END
+
     juce::MidiMessage getEvent() override
     {
         auto e = generator.getEvent();
@@ -906,6 +1054,117 @@ private:
 
     size_t currentSequenceIndex = 0;
     double cachedSequenceOffset = 0.0;
+
+    // BEATCONNECT MODIFICATION START
+    enum class SequenceState
+    {
+        idle,       // Nothing has been requested, owned by the audio thread
+        requested,  // Waiting for the preparation thread
+        preparing,  // Owned by the preparation thread
+        ready       // Prepared and owned by the audio thread again
+    };
+
+    struct PreparedSequence
+    {
+        choc::midi::Sequence sequence;
+        std::vector<std::pair<size_t, size_t>> noteOffMap;
+        double offset = 0.0;
+        size_t sequenceIndex = 0;
+    };
+
+    struct Request
+    {
+        double offset = 0.0;
+        size_t sequenceIndex = 0;
+    };
+
+    PreparedSequence nextSequence;
+    std::atomic<SequenceState> nextSequenceState { SequenceState::idle };
+    std::optional<juce::SharedResourcePointer<MidiLoopPreparationThread>> preparationThread;
+    std::optional<Request> pendingRequest;   // Only accessed on the audio thread
+    std::atomic<int>* numBackgroundPreparedIterations = nullptr;
+    std::atomic<int>* numPendingBackgroundPreparations = nullptr;
+
+    void updateNumPendingPreparations (int delta)
+    {
+        if (numPendingBackgroundPreparations != nullptr)
+            numPendingBackgroundPreparations->fetch_add (delta, std::memory_order_acq_rel);
+    }
+
+    /** Passes the pending request on to the preparation thread, if it's not busy with an old one. */
+    void requestPendingSequence()
+    {
+        if (! pendingRequest)
+            return;
+
+        auto state = nextSequenceState.load (std::memory_order_acquire);
+
+        // The background thread owns the next sequence whilst it's preparing it so if the
+        // playhead has jumped, the new position is requested once it's finished
+        if (state == SequenceState::preparing)
+            return;
+
+        // A request that hasn't been started yet can just be replaced
+        if (state == SequenceState::requested)
+        {
+            if (! nextSequenceState.compare_exchange_strong (state, SequenceState::idle))
+                return;
+
+            updateNumPendingPreparations (-1);
+        }
+
+        if (state == SequenceState::ready
+             && nextSequence.offset == pendingRequest->offset
+             && nextSequence.sequenceIndex == pendingRequest->sequenceIndex)
+        {
+            pendingRequest.reset();
+            return;
+        }
+
+        nextSequence.offset = pendingRequest->offset;
+        nextSequence.sequenceIndex = pendingRequest->sequenceIndex;
+        pendingRequest.reset();
+        updateNumPendingPreparations (1);
+        nextSequenceState.store (SequenceState::requested, std::memory_order_release);
+
+        (*preparationThread)->triggerPreparation();
+    }
+
+    size_t getNextSequenceIndex() const
+    {
+        if (sequences.empty() || currentSequenceIndex + 1 >= sequences.size())
+            return 0;
+
+        return currentSequenceIndex + 1;
+    }
+
+    void createSequence (choc::midi::Sequence& dest, std::vector<std::pair<size_t, size_t>>& destNoteOffMap,
+                         size_t sequenceIndex, double offsetBeats) const
+    {
+        // Create a new sequence by:
+        // - Iterating the current sequence
+        // - Adding the offset timestamp to get Edit times
+        // - Applying the quantisation
+        // - Applying the groove
+        // - Sortign so events are in order
+
+        // Create the cached sequence (without allocating)
+        dest.events.clear();
+
+        if (sequenceIndex < sequences.size())
+            MidiHelpers::addSequence (dest, sequences[sequenceIndex], offsetBeats);
+
+        jassert (std::is_sorted (dest.begin(), dest.end()));
+        MidiHelpers::createNoteOffMap (destNoteOffMap, dest);
+        MidiHelpers::applyQuantisationToSequence (quantisation, false, dest, destNoteOffMap);
+
+        if (! groove.isEmpty())
+            MidiHelpers::applyGrooveToSequence (groove, grooveStrength, dest);
+
+        dest.sortEvents();
+        MidiHelpers::createNoteOffMap (destNoteOffMap, dest);
+    }
+    // BEATCONNECT MODIFICATION END
 };
 
 //==============================================================================
@@ -923,6 +1182,11 @@ public:
           loopTimes (loopTimesToUse)
     {
         assert (activeNoteList);
+
+        // BEATCONNECT MODIFICATION START
+        if (! loopTimes.isEmpty())
+            generator->prepareNextSequence (getSequenceOffset (loopIndex + 1));
+        // BEATCONNECT MODIFICATION END
     }
 
     void createMessagesForTime (MidiMessageArray& destBuffer,
@@ -1022,9 +1286,18 @@ private:
             return;
 
         loopIndex = newLoopIndex;
-        const auto sequenceOffset = clipRange.getStart() + (loopIndex * loopTimes.getLength());
-        generator->cacheSequence (sequenceOffset);
+        // BEATCONNECT MODIFICATION START
+        generator->cacheSequence (getSequenceOffset (loopIndex));
+
+        // Get the following iteration ready before it's needed
+        generator->prepareNextSequence (getSequenceOffset (loopIndex + 1));
     }
+
+    double getSequenceOffset (int index) const
+    {
+        return clipRange.getStart() + (index * loopTimes.getLength());
+    }
+    // BEATCONNECT MODIFICATION END
 };
 
 
@@ -1114,7 +1387,10 @@ public:
     }
 
     void initialise (std::shared_ptr<ActiveNoteList> noteListToUse,
-                     bool sendNoteOffs, size_t lastSequencesHash)
+                     bool sendNoteOffs, size_t lastSequencesHash,
+                     bool prepareLoopIterationsInBackground,
+                     std::atomic<int>& numBackgroundPreparedIterations,
+                     std::atomic<int>& numPendingBackgroundPreparations)
     {
         shouldSendNoteOffs = sendNoteOffs;
         shouldCreateMessagesForTime = shouldSendNoteOffs || noteListToUse == nullptr;
@@ -1132,8 +1408,14 @@ public:
         if (sequencesHash != lastSequencesHash)
             shouldSendNoteOffsForNotesNoLongerPlaying = true;
 
+        // BEATCONNECT MODIFICATION START
+        // Only looped sequences need preparing for each iteration
         auto cachingGenerator = std::make_unique<CachingMidiEventGenerator> (std::move (sequences),
-                                                                             std::move (quantisation), std::move (groove), grooveStrength);
+                                                                             std::move (quantisation), std::move (groove), grooveStrength,
+                                                                             prepareLoopIterationsInBackground && ! loopRangeRaw.isEmpty(),
+                                                                             &numBackgroundPreparedIterations,
+                                                                             &numPendingBackgroundPreparations);
+        // BEATCONNECT MODIFICATION END
         auto loopedGenerator = std::make_unique<LoopedMidiEventGenerator> (std::move (cachingGenerator),
                                                                            activeNoteList, clipRangeRaw, loopRangeRaw);
         generator = std::make_unique<OffsetMidiEventGenerator> (std::move (loopedGenerator),
@@ -1390,8 +1672,29 @@ void LoopingMidiNode::prepareToPlay (const tracktion::graph::PlaybackInitialisat
         lastSequencesHash = oldNode->generatorAndNoteList->getSequencesHash();
     }
 
-    generatorAndNoteList->initialise (activeNoteList, sendNoteOffEvents, lastSequencesHash);
+    // BEATCONNECT MODIFICATION START
+    generatorAndNoteList->initialise (activeNoteList, sendNoteOffEvents, lastSequencesHash,
+                                      prepareLoopIterationsInBackground, numBackgroundPreparedIterations,
+                                      numPendingBackgroundPreparations);
+    // BEATCONNECT MODIFICATION END
+}
+
+// BEATCONNECT MODIFICATION START
+void LoopingMidiNode::setPrepareLoopIterationsInBackground (bool shouldPrepareInBackground)
+{
+    prepareLoopIterationsInBackground = shouldPrepareInBackground;
+}
+
+int LoopingMidiNode::getNumBackgroundPreparedIterations() const
+{
+    return numBackgroundPreparedIterations.load (std::memory_order_relaxed);
+}
+
+bool LoopingMidiNode::isPreparingLoopIterationInBackground() const
+{
+    return numPendingBackgroundPreparations.load (std::memory_order_acquire) > 0;
 }
+// BEATCONNECT MODIFICATION END
 
 bool LoopingMidiNode::isReadyToProcess()
 {
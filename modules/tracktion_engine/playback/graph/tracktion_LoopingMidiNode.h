@@ -51,6 +51,24 @@ public:
     */
     const std::shared_ptr<ActiveNoteList>& getActiveNoteList() const;
 
+    // BEATCONNECT MODIFICATION START
+    /** Sets whether the sequence for the next loop iteration should be prepared on a
+        background thread, so the audio thread only has to swap it in at the loop boundary.
+        This is enabled by default and must be called before prepareToPlay.
+    */
+    void setPrepareLoopIterationsInBackground (bool);
+
+    /** Returns the number of loop iterations that were swapped in after being prepared in
+        the background, rather than being created at the loop boundary.
+    */
+    int getNumBackgroundPreparedIterations() const;
+
+    /** Returns true if a loop iteration has been requested from the background thread
+        but hasn't finished being prepared yet.
+    */
+    bool isPreparingLoopIterationInBackground() const;
+    // BEATCONNECT MODIFICATION END
+
     tracktion::graph::NodeProperties getNodeProperties() override;
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
@@ -68,6 +86,11 @@ private:
 
     MidiMessageArray::MPESourceID midiSourceID = MidiMessageArray::createUniqueMPESourceID();
     bool wasMute = false;
+
+    // BEATCONNECT MODIFICATION START
+    bool prepareLoopIterationsInBackground = true;
+    std::atomic<int> numBackgroundPreparedIterations { 0 }, numPendingBackgroundPreparations { 0 };
+    // BEATCONNECT MODIFICATION END
 };
 
 }} // namespace tracktion { inline namespace engine
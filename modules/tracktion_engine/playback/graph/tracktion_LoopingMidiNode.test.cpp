@@ -8,6 +8,106 @@
     Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
 */
 
+// BEATCONNECT MODIFICATION START
+#if ENGINE_UNIT_TESTS_LOOPINGMIDINODE || TRACKTION_BENCHMARKS
+
+namespace tracktion { inline namespace engine
+{
+
+namespace looping_midi_node_test_utilities
+{
+    /** Creates a sequence with lots of overlapping notes in the given number of beats. */
+    inline juce::MidiMessageSequence createDenseSequence (int numNotes, double numBeats, juce::Random r)
+    {
+        juce::MidiMessageSequence seq;
+
+        for (int i = 0; i < numNotes; ++i)
+        {
+            const auto start = r.nextDouble() * numBeats * 0.9;
+            const auto length = 0.01 + r.nextDouble() * (numBeats - start - 0.01);
+            const auto note = r.nextInt ({ 24, 96 });
+
+            seq.addEvent (juce::MidiMessage::noteOn (1, note, (juce::uint8) r.nextInt ({ 1, 127 })), start);
+            seq.addEvent (juce::MidiMessage::noteOff (1, note), start + length);
+        }
+
+        seq.updateMatchedPairs();
+        return seq;
+    }
+
+    /** Plays a quantised sequence looped over the given number of beats and returns the MIDI it creates.
+        After each block, this waits for any loop iteration being prepared in the background.
+        If a Benchmark is passed in, it's used to time each block. If numBackgroundPreparedIterations
+        is passed in, it's set to the number of iterations that were prepared in the background.
+    */
+    inline juce::MidiBuffer renderLoopedSequence (Edit& edit, const juce::MidiMessageSequence& seq,
+                                                  double loopBeats, double clipBeats, bool prepareInBackground,
+                                                  tracktion::graph::test_utilities::TestSetup ts,
+                                                  std::chrono::microseconds pauseBetweenBlocks,
+                                                  Benchmark* benchmark = nullptr,
+                                                  int* numBackgroundPreparedIterations = nullptr)
+    {
+        using namespace tracktion::graph;
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState { playHead };
+        ProcessState processState { playHeadState, edit.tempoSequence };
+
+        QuantisationType quantisation;
+        quantisation.setType ("1/16");
+
+        auto node = std::make_unique<LoopingMidiNode> (std::vector<juce::MidiMessageSequence> { seq },
+                                                       juce::Range<int> (1, 1), false,
+                                                       BeatRange (0_bp, BeatDuration::fromBeats (clipBeats)),
+                                                       BeatRange (0_bp, BeatDuration::fromBeats (loopBeats)),
+                                                       0_bd, LiveClipLevel(), processState, EditItemID::fromRawID (1),
+                                                       quantisation, nullptr, 0.0f);
+        node->setPrepareLoopIterationsInBackground (prepareInBackground);
+        auto nodePtr = node.get();
+
+        const auto duration = edit.tempoSequence.toTime (BeatPosition::fromBeats (clipBeats)).inSeconds();
+        test_utilities::TestProcess<TracktionNodePlayer> testProcess (std::make_unique<TracktionNodePlayer> (std::move (node), processState, ts.sampleRate, ts.blockSize,
+                                                                                                             getPoolCreatorFunction (ThreadPoolStrategy::realTime)),
+                                                                      ts, 1, duration, false);
+        testProcess.setPlayHead (&playHead);
+        playHead.playSyncedToRange ({});
+
+        for (;;)
+        {
+            if (benchmark != nullptr)
+                benchmark->start();
+
+            const bool isMoreToDo = testProcess.process (ts.blockSize);
+
+            if (benchmark != nullptr)
+                benchmark->stop();
+
+            if (! isMoreToDo)
+                break;
+
+            std::this_thread::sleep_for (pauseBetweenBlocks);
+
+            // Give the background thread as long as it needs to prepare the next iteration
+            // so the number prepared doesn't depend on how busy the machine is
+            const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds (10);
+
+            while (nodePtr->isPreparingLoopIterationInBackground()
+                   && std::chrono::steady_clock::now() < timeout)
+                std::this_thread::sleep_for (std::chrono::microseconds (100));
+        }
+
+        if (numBackgroundPreparedIterations != nullptr)
+            *numBackgroundPreparedIterations = nodePtr->getNumBackgroundPreparedIterations();
+
+        return testProcess.getTestResult()->midi;
+    }
+}
+
+}} // namespace tracktion { inline namespace engine
+
+#endif
+// BEATCONNECT MODIFICATION END
+
 #if ENGINE_UNIT_TESTS_LOOPINGMIDINODE
 
 namespace tracktion { inline namespace engine
@@ -41,6 +141,10 @@ public:
             runStuckNotesTests (setup, false, 2);
 
             runOffsetTests (setup);
+
+            // BEATCONNECT MODIFICATION START
+            runBackgroundPreparationTests (setup);
+            // BEATCONNECT MODIFICATION END
         }
 
         runProgramChangeTests (false);
@@ -256,6 +360,45 @@ private:
         testMidiClip (*mc, ts);
     }
 
+    // BEATCONNECT MODIFICATION START
+    void runBackgroundPreparationTests (test_utilities::TestSetup ts)
+    {
+        beginTest ("Loop iterations prepared in the background");
+
+        // Play a dense, quantised loop with and without the next iterations being prepared
+        // on the background thread and check the output is identical
+        using namespace looping_midi_node_test_utilities;
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+        auto edit = Edit::createSingleTrackEdit (engine);
+        const auto seq = createDenseSequence (500, 1.0, ts.random);
+
+        int numSynchronousPrepared = -1, numBackgroundPrepared = -1;
+        const auto synchronous = renderLoopedSequence (*edit, seq, 1.0, 8.0, false, ts, std::chrono::microseconds (0),
+                                                       nullptr, &numSynchronousPrepared);
+        const auto background = renderLoopedSequence (*edit, seq, 1.0, 8.0, true, ts, std::chrono::microseconds (0),
+                                                      nullptr, &numBackgroundPrepared);
+
+        // Check the background path was actually used, not just the synchronous fallback
+        expectEquals (numSynchronousPrepared, 0);
+        expectGreaterThan (numBackgroundPrepared, 0);
+
+        expect (synchronous.getNumEvents() > 0);
+        expectEquals (background.getNumEvents(), synchronous.getNumEvents());
+
+        for (auto i1 = synchronous.begin(), i2 = background.begin();
+             i1 != synchronous.end() && i2 != background.end(); ++i1, ++i2)
+        {
+            const auto m1 = (*i1).getMessage(), m2 = (*i2).getMessage();
+
+            if (! expect ((*i1).samplePosition == (*i2).samplePosition
+                            && m1.getRawDataSize() == m2.getRawDataSize()
+                            && std::memcmp (m1.getRawData(), m2.getRawData(), (size_t) m1.getRawDataSize()) == 0,
+                          "Events should be the same: " + m1.getDescription() + " vs " + m2.getDescription()))
+                break;
+        }
+    }
+    // BEATCONNECT MODIFICATION END
+
     void testMidiClip (MidiClip& mc, test_utilities::TestSetup ts)
     {
         auto renderOpts = RenderOptions::forClipRender ({ &mc }, true);
@@ -323,3 +466,70 @@ static LoopingMidiNodeTests loopingMidiNodeTests;
 }} // namespace tracktion { inline namespace engine
 
 #endif //ENGINE_UNIT_TESTS_LOOPINGMIDINODE
+
+// BEATCONNECT MODIFICATION START
+#if TRACKTION_BENCHMARKS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class LoopingMidiNodeBenchmarks : public juce::UnitTest
+{
+public:
+    LoopingMidiNodeBenchmarks()
+        : juce::UnitTest ("LoopingMidiNode", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        using namespace looping_midi_node_test_utilities;
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+        auto edit = Edit::createSingleTrackEdit (engine);
+
+        tracktion::graph::test_utilities::TestSetup ts;
+        ts.sampleRate = 44100.0;
+        ts.blockSize = 256;
+
+        for (int numNotes : { 500, 2000, 8000 })
+        {
+            const auto seq = createDenseSequence (numNotes, 1.0, ts.random);
+
+            for (bool prepareInBackground : { false, true })
+            {
+                const auto name = std::to_string (numNotes) + " note loop, "
+                                    + (prepareInBackground ? "prepared in background" : "prepared at loop boundary");
+                beginTest (name);
+
+                // Play 16 iterations of a 1 beat loop, pausing between blocks to give the
+                // background thread a realistic amount of time
+                Benchmark benchmark (createBenchmarkDescription (*this, "Block time: " + name));
+                int numBackgroundPrepared = -1;
+                const auto midi = renderLoopedSequence (*edit, seq, 1.0, 16.0, prepareInBackground, ts,
+                                                        std::chrono::microseconds (1000), &benchmark, &numBackgroundPrepared);
+
+                const auto result = benchmark.getResult();
+                BenchmarkList::getInstance().addResult (result);
+                logMessage ("Worst block: " + juce::String (result.maxSeconds * 1000.0, 3) + "ms, mean: "
+                            + juce::String (result.meanSeconds * 1000.0, 3) + "ms");
+
+                // Check the path being timed was the one actually used
+                expect (midi.getNumEvents() > 0);
+
+                if (prepareInBackground)
+                    expectGreaterThan (numBackgroundPrepared, 0);
+                else
+                    expectEquals (numBackgroundPrepared, 0);
+            }
+        }
+    }
+};
+
+static LoopingMidiNodeBenchmarks loopingMidiNodeBenchmarks;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_BENCHMARKS
+// BEATCONNECT MODIFICATION END
@@ -70,7 +70,7 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
         TRACKTION_LOG_ERROR("Rendering whilst attached to audio device");
     }
 
-    if (r.shouldNormalise || r.trimSilenceAtEnds || r.shouldNormaliseByRMS)
+    if (r.shouldNormalise || r.trimSilenceAtEnds || r.shouldNormaliseByRMS || r.shouldNormaliseByLoudness)
     {
         needsToNormaliseAndTrim = true;
 
@@ -82,6 +82,7 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
         r.shouldNormalise = false;
         r.trimSilenceAtEnds = false;
         r.shouldNormaliseByRMS = false;
+        r.shouldNormaliseByLoudness = false;
     }
 
     numOutputChans = 2;
@@ -126,6 +127,9 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
     peak = 0.0001f;
     rmsTotal = 0.0;
     rmsNumSamps = 0;
+    // BEATCONNECT MODIFICATION START
+    loudnessMeter.prepare (r.sampleRateForAudio, numOutputChans);
+    // BEATCONNECT MODIFICATION END
     streamTime = r.time.getStart();
 
     precount = numPreRenderBlocks;
@@ -156,6 +160,9 @@ NodeRenderContext::~NodeRenderContext()
     r.resultMagnitude = owner.params.resultMagnitude = peak;
     r.resultRMS = owner.params.resultRMS = rmsNumSamps > 0 ? (float) (rmsTotal / rmsNumSamps) : 0.0f;
     r.resultAudioDuration = owner.params.resultAudioDuration = float (numSamplesWrittenToSource / owner.params.sampleRateForAudio);
+    // BEATCONNECT MODIFICATION START
+    r.resultLoudness = owner.params.resultLoudness = loudnessMeter.getResult();
+    // BEATCONNECT MODIFICATION END
 
     playHead->stop();
     Renderer::RenderTask::setAllPluginsRealtime (plugins, true);
@@ -342,6 +349,10 @@ NodeRenderContext::WriteResult NodeRenderContext::writeAudioBlock (choc::buffer:
         ++rmsNumSamps;
     }
 
+    // BEATCONNECT MODIFICATION START
+    loudnessMeter.process (buffer, 0, blockSizeSamples);
+    // BEATCONNECT MODIFICATION END
+
     if (! hasStartedSavingToFile)
         samplesTrimmed += blockSizeSamples;
 
@@ -106,6 +106,9 @@ private:
     float peak = 0;
     double rmsTotal = 0;
     int64_t rmsNumSamps = 0;
+    // BEATCONNECT MODIFICATION START
+    LoudnessMeter loudnessMeter;
+    // BEATCONNECT MODIFICATION END
     int precount = 0;
     TimePosition streamTime;
 
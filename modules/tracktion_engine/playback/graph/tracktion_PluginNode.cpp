@@ -47,6 +47,11 @@ PluginNode::PluginNode (std::unique_ptr<Node> inputNode,
     jassert (input != nullptr);
     jassert (plugin != nullptr);
     initialisePlugin (sampleRateToUse, blockSizeToUse);
+
+    // BEATCONNECT MODIFICATION START
+    if (! isRendering)
+        overloadPolicy = &plugin->engine.getDeviceManager().getOverloadPolicy();
+    // BEATCONNECT MODIFICATION END
 }
 
 PluginNode::~PluginNode()
@@ -137,14 +142,23 @@ void PluginNode::process (ProcessContext& pc)
         tracktion::graph::copyIfNotAliased (outputAudioView.getFirstChannels (numInputChannelsToCopy),
                                             inputAudioBlock.getFirstChannels (numInputChannelsToCopy));
     
+    // BEATCONNECT MODIFICATION START
+    // When overloaded, non-essential plugins are bypassed (even if they could process bypassed)
+    // and fine-grain automation can be turned off
+    const bool isBypassedForOverload = overloadPolicy != nullptr && plugin->isBypassedForOverload();
+    const bool isPluginEnabled = plugin->isEnabled() && ! isBypassedForOverload;
+    const bool useCoarseAutomation = overloadPolicy != nullptr
+                                      && overloadPolicy->isApplied (OverloadPolicy::Measure::coarseAutomation);
+
     // Init block
-    auto subBlockSize = subBlockSizeToUse < 0 ? blockNumSamples
-                                              : (choc::buffer::FrameCount) subBlockSizeToUse;
+    auto subBlockSize = (subBlockSizeToUse < 0 || useCoarseAutomation) ? blockNumSamples
+                                                                       : (choc::buffer::FrameCount) subBlockSizeToUse;
     
     choc::buffer::FrameCount numSamplesDone = 0;
     auto numSamplesLeft = blockNumSamples;
     
-    bool shouldProcessPlugin = canProcessBypassed || plugin->isEnabled();
+    bool shouldProcessPlugin = ! isBypassedForOverload && (canProcessBypassed || plugin->isEnabled());
+    // BEATCONNECT MODIFICATION END
     bool isAllNotesOff = inputBuffers.midi.isAllNotesOff;
     
     if (playHeadState.didPlayheadJump())
@@ -218,7 +232,9 @@ void PluginNode::process (ProcessContext& pc)
     if (latencyProcessor)
     {
         // A slightly better approach would be to crossfade between the processed and latency block to minimise any discrepancies
-        if (plugin->isEnabled())
+        // BEATCONNECT MODIFICATION START
+        if (isPluginEnabled)
+        // BEATCONNECT MODIFICATION END
         {
             auto numSamples = (int) blockNumSamples;
             latencyProcessor->clearAudio (numSamples);
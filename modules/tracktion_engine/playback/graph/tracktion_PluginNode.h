@@ -75,6 +75,10 @@ private:
     
     std::shared_ptr<tracktion::graph::LatencyProcessor> latencyProcessor;
 
+    // BEATCONNECT MODIFICATION START
+    OverloadPolicy* overloadPolicy = nullptr;
+    // BEATCONNECT MODIFICATION END
+
     //==============================================================================
     void initialisePlugin (double sampleRateToUse, int blockSizeToUse);
     PluginRenderContext getPluginRenderContext (TimeRange, juce::AudioBuffer<float>&);
@@ -87,6 +87,9 @@ public:
 
 private:
     //==============================================================================
+    // BEATCONNECT MODIFICATION START
+    // N.B. this must be declared before the input as nodes in it can refer to it
+    // BEATCONNECT MODIFICATION END
     std::unique_ptr<TrackMuteState> trackMuteState;
     std::unique_ptr<tracktion::graph::Node> input;
     bool dontMuteIfTrackContentsShouldBeProcessed = false;
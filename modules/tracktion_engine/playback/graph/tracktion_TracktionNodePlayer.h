@@ -50,6 +50,24 @@ public:
         nodePlayer.setNumThreads (numThreads);
     }
 
+    // BEATCONNECT MODIFICATION START
+    /** Sets a function to call on each worker thread when it's created.
+        @see LockFreeMultiThreadedNodePlayer::setThreadInitialiser
+    */
+    void setThreadInitialiser (tracktion::graph::LockFreeMultiThreadedNodePlayer::ThreadInitialiser initialiser)
+    {
+        nodePlayer.setThreadInitialiser (std::move (initialiser));
+    }
+
+    /** Enables or disables parking the worker threads the graph doesn't need.
+        @see LockFreeMultiThreadedNodePlayer::enableAdaptiveThreadCount
+    */
+    void enableAdaptiveThreadCount (bool shouldAdapt)
+    {
+        nodePlayer.enableAdaptiveThreadCount (shouldAdapt);
+    }
+    // BEATCONNECT MODIFICATION END
+
     tracktion::graph::Node* getNode()
     {
         return nodePlayer.getNode();
@@ -466,7 +466,7 @@ public:
 class TimeStretchReader : public SingleInputAudioReader
 {
 public:
-    TimeStretchReader (std::unique_ptr<AudioReader> input)
+    TimeStretchReader (std::unique_ptr<AudioReader> input, const OverloadPolicy* = nullptr)
         : SingleInputAudioReader (std::move (input)), numChannels ((int) source->getNumChannels())
     {
         timeStretcher.initialise (source->getSampleRate(), chunkSize, numChannels,
@@ -580,14 +580,35 @@ public:
 class TimeStretchReader final   : public SingleInputAudioReader
 {
 public:
-    TimeStretchReader (std::unique_ptr<AudioReader> input)
-        : SingleInputAudioReader (std::move (input)), numChannels ((int) source->getNumChannels())
+    // BEATCONNECT MODIFICATION START
+    /** If an OverloadPolicy is passed in that can use the cheaperTimeStretching measure,
+        a second, cheaper stretcher is created up front so this can switch to it on any
+        block without allocating.
+    */
+    TimeStretchReader (std::unique_ptr<AudioReader> input, const OverloadPolicy* policy = nullptr)
+        : SingleInputAudioReader (std::move (input)), numChannels ((int) source->getNumChannels()),
+          overloadPolicy (policy)
     {
         timeStretcher.initialise (source->getSampleRate(), chunkSize, numChannels,
                                   TimeStretcher::defaultMode, {}, true);
-        inputFifo.setSize (numChannels, timeStretcher.getMaxFramesNeeded());
-        outputFifo.setSize (numChannels, timeStretcher.getMaxFramesNeeded());
+        auto maxFramesNeeded = timeStretcher.getMaxFramesNeeded();
+
+        if (overloadPolicy != nullptr && overloadPolicy->canApply (OverloadPolicy::Measure::cheaperTimeStretching))
+        {
+            if (auto cheaperMode = OverloadPolicy::getCheaperTimeStretchMode (TimeStretcher::defaultMode);
+                cheaperMode != TimeStretcher::defaultMode)
+            {
+                cheaperTimeStretcher = std::make_unique<TimeStretcher>();
+                cheaperTimeStretcher->initialise (source->getSampleRate(), chunkSize, numChannels,
+                                                  cheaperMode, {}, true);
+                maxFramesNeeded = std::max (maxFramesNeeded, cheaperTimeStretcher->getMaxFramesNeeded());
+            }
+        }
+
+        inputFifo.setSize (numChannels, maxFramesNeeded);
+        outputFifo.setSize (numChannels, maxFramesNeeded);
     }
+    // BEATCONNECT MODIFICATION END
 
     SampleCount getPosition() override
     {
@@ -599,13 +620,9 @@ public:
         if (std::abs (t - getReadPosition()) <= 1)
             return;
 
-        readPosition = (double) t;
-
-        source->setPosition (t);
-        timeStretcher.reset();
-        setSpeedAndPitch (playbackSpeedRatio, semitonesShift);
-        inputFifo.reset();
-        outputFifo.reset();
+        // BEATCONNECT MODIFICATION START
+        resetStretcher ((double) t);
+        // BEATCONNECT MODIFICATION END
     }
 
     void setPosition (TimePosition t) override
@@ -639,12 +656,22 @@ public:
     {
         playbackSpeedRatio = speedRatio;
         semitonesShift = semitones;
-        [[ maybe_unused ]] const bool ok = timeStretcher.setSpeedAndPitch ((float) (1.0 / speedRatio), (float) semitonesShift);
+        [[ maybe_unused ]] const bool ok = activeStretcher->setSpeedAndPitch ((float) (1.0 / speedRatio), (float) semitonesShift);
         assert (ok);
     }
 
     bool readSamples (choc::buffer::ChannelArrayView<float>& destBuffer) override
     {
+        // BEATCONNECT MODIFICATION START
+        if (auto stretcherToUse = getStretcherToUse(); stretcherToUse != activeStretcher)
+            return switchStretcher (*stretcherToUse, destBuffer);
+
+        return readFromActiveStretcher (destBuffer);
+    }
+
+    bool readFromActiveStretcher (choc::buffer::ChannelArrayView<float>& destBuffer)
+    {
+        // BEATCONNECT MODIFICATION END
         assert (numChannels == (int) destBuffer.getNumChannels());
         const auto numFramesToDo = destBuffer.getNumFrames();
 
@@ -658,7 +685,7 @@ public:
                 break;
             }
 
-            const auto numThisTime = timeStretcher.getFramesNeeded();
+            const auto numThisTime = activeStretcher->getFramesNeeded();
 
             if (numThisTime > 0)
             {
@@ -674,7 +701,7 @@ public:
             assert (inputFifo.getNumReady() >= numThisTime);
             assert (outputFifo.getFreeSpace() >= numThisTime);
             assert (outputFifo.getFreeSpace() >= chunkSize);
-            timeStretcher.processData (inputFifo, numThisTime, outputFifo);
+            activeStretcher->processData (inputFifo, numThisTime, outputFifo);
         }
 
         readPosition += numFramesToDo * playbackSpeedRatio;
@@ -688,6 +715,68 @@ public:
     AudioFifo inputFifo { numChannels, chunkSize }, outputFifo { numChannels, chunkSize };
     double playbackSpeedRatio = 1.0, semitonesShift = 0.0, readPosition = std::numeric_limits<double>::lowest();
 
+    // BEATCONNECT MODIFICATION START
+    const OverloadPolicy* overloadPolicy = nullptr;
+    std::unique_ptr<TimeStretcher> cheaperTimeStretcher;
+    TimeStretcher* activeStretcher = &timeStretcher;
+
+    TimeStretcher* getStretcherToUse() noexcept
+    {
+        if (cheaperTimeStretcher != nullptr && overloadPolicy->isApplied (OverloadPolicy::Measure::cheaperTimeStretching))
+            return cheaperTimeStretcher.get();
+
+        return &timeStretcher;
+    }
+
+    void resetStretcher (double newReadPosition)
+    {
+        readPosition = newReadPosition;
+
+        source->setPosition (getReadPosition());
+        activeStretcher->reset();
+        setSpeedAndPitch (playbackSpeedRatio, semitonesShift);
+        inputFifo.reset();
+        outputFifo.reset();
+    }
+
+    /** Reads the block with both the old and new stretcher and crossfades between them
+        so the change of mode doesn't click.
+    */
+    bool switchStretcher (TimeStretcher& newStretcher, choc::buffer::ChannelArrayView<float>& destBuffer)
+    {
+        // Nothing has been read yet so there's nothing to fade from
+        if (readPosition == std::numeric_limits<double>::lowest())
+        {
+            activeStretcher = &newStretcher;
+            setSpeedAndPitch (playbackSpeedRatio, semitonesShift);
+            return readFromActiveStretcher (destBuffer);
+        }
+
+        const auto numFrames = (int) destBuffer.getNumFrames();
+        const auto startPosition = readPosition;
+
+        AudioScratchBuffer oldStretcherOutput (numChannels, numFrames);
+        auto oldStretcherView = toBufferView (oldStretcherOutput.buffer);
+        readFromActiveStretcher (oldStretcherView);
+
+        activeStretcher = &newStretcher;
+        resetStretcher (startPosition);
+
+        if (! readFromActiveStretcher (destBuffer))
+            return false;
+
+        auto destAudioBuffer = toAudioBuffer (destBuffer);
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            destAudioBuffer.applyGainRamp (i, 0, numFrames, 0.0f, 1.0f);
+            destAudioBuffer.addFromWithRamp (i, 0, oldStretcherOutput.buffer.getReadPointer (i), numFrames, 1.0f, 0.0f);
+        }
+
+        return true;
+    }
+    // BEATCONNECT MODIFICATION END
+
     SampleCount getReadPosition() const
     {
         return static_cast<SampleCount> (readPosition + 0.5);
@@ -1862,7 +1951,10 @@ bool WaveNodeRealTime::buildAudioReaderGraph()
     std::unique_ptr<TimeStretchReader> timeStretchReader;
 
     if (! timestretchDisabled)
-        timeStretchReader = std::make_unique<TimeStretchReader> (std::move (resamplerAudioReader));
+        // BEATCONNECT MODIFICATION START
+        timeStretchReader = std::make_unique<TimeStretchReader> (std::move (resamplerAudioReader),
+                                                                 isOfflineRender ? nullptr : &audioFile.engine->getDeviceManager().getOverloadPolicy());
+        // BEATCONNECT MODIFICATION END
 
     auto timeStretcher = timeStretchReader.get();
     std::unique_ptr<TimeRangeReader> timeRangeReader;
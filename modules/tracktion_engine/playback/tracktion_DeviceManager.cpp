@@ -223,6 +223,9 @@ DeviceManager::DeviceManager (Engine& e) : engine (e)
     CRASH_TRACER
 
     contextDeviceClearer = std::make_unique<ContextDeviceClearer> (*this);
+    // BEATCONNECT MODIFICATION START
+    overloadPolicy = std::make_unique<OverloadPolicy> (engine);
+    // BEATCONNECT MODIFICATION END
 
     deviceManager.addChangeListener (this);
 
@@ -1139,6 +1142,18 @@ void DeviceManager::audioDeviceIOCallbackInternal (const float* const* inputChan
     CRASH_TRACER
     juce::FloatVectorOperations::disableDenormalisedNumberSupport();
 
+    // BEATCONNECT MODIFICATION START
+    // Devices don't start their callback thread until after audioDeviceAboutToStart
+    // so this has to be placed from the first callback it makes. The placement was
+    // prepared in audioDeviceAboutToStart so this only makes the system calls.
+    if (audioCallbackPlacement != nullptr
+        && placedAudioCallbackThread.load (std::memory_order_relaxed) != std::this_thread::get_id())
+    {
+        placedAudioCallbackThread = std::this_thread::get_id();
+        audioCallbackPlacement->applyToCurrentThread();
+    }
+    // BEATCONNECT MODIFICATION END
+
     {
        #if JUCE_ANDROID
         const ScopedSteadyLoad load (steadyLoadContext, numSamples);
@@ -1146,8 +1161,14 @@ void DeviceManager::audioDeviceIOCallbackInternal (const float* const* inputChan
 
         const auto startTimeTicks = juce::Time::getHighResolutionTicks();
 
-        if (currentCpuUsage > cpuLimitBeforeMuting)
+        // BEATCONNECT MODIFICATION START
+        overloadPolicy->updateCpuUsage (currentCpuUsage, numSamples / currentSampleRate);
+
+        if (currentCpuUsage > cpuLimitBeforeMuting && overloadPolicy->shouldMuteOnOverload())
         {
+            overloadPolicy->outputWasMuted();
+        // BEATCONNECT MODIFICATION END
+
             for (int i = 0; i < totalNumOutputChannels; ++i)
                 if (auto dest = outputChannelData[i])
                     juce::FloatVectorOperations::clear (dest, numSamples);
@@ -1232,6 +1253,14 @@ void DeviceManager::audioDeviceAboutToStart (juce::AudioIODevice* device)
 
     streamTime = 0;
     currentCpuUsage = 0.0f;
+    // BEATCONNECT MODIFICATION START
+    {
+        auto& threadPlacementPolicy = engine.getThreadPlacementPolicy();
+        threadPlacementPolicy.addRealTimeResultsToReport();
+        audioCallbackPlacement = threadPlacementPolicy.prepareRealTimePlacement (ThreadPlacementPolicy::ThreadRole::audioCallback, "Audio callback");
+        placedAudioCallbackThread = std::thread::id();
+    }
+    // BEATCONNECT MODIFICATION END
     maxBlockSize = device->getCurrentBufferSizeSamples();
     currentSampleRate = device->getCurrentSampleRate();
     currentLatencyMs  = maxBlockSize * 1000.0f / currentSampleRate;
@@ -1255,6 +1284,10 @@ void DeviceManager::audioDeviceAboutToStart (juce::AudioIODevice* device)
     if (globalOutputAudioProcessor != nullptr)
         globalOutputAudioProcessor->prepareToPlay (currentSampleRate, device->getCurrentBufferSizeSamples());
 
+    // BEATCONNECT MODIFICATION START (RELAY)
+    relayInput.prepare (currentSampleRate, std::max (1, maxBlockSize));
+    // BEATCONNECT MODIFICATION END (RELAY)
+
     if (device->getCurrentBufferSizeSamples() > 0)
         cpuAvgCounter = cpuReportingInterval = std::max (1, static_cast<int> (device->getCurrentSampleRate())
                                                              / device->getCurrentBufferSizeSamples());
@@ -1271,6 +1304,9 @@ void DeviceManager::audioDeviceAboutToStart (juce::AudioIODevice* device)
 void DeviceManager::audioDeviceStopped()
 {
     currentCpuUsage = 0.0f;
+    // BEATCONNECT MODIFICATION START
+    engine.getThreadPlacementPolicy().addRealTimeResultsToReport();
+    // BEATCONNECT MODIFICATION END
     contextDeviceClearer->triggerClearDevices();
 
     if (globalOutputAudioProcessor != nullptr)
@@ -1340,9 +1376,81 @@ void DeviceManager::setGlobalOutputAudioProcessor (juce::AudioProcessor* newProc
 }
 
 // BEATCONNECT MODIFICATION START (RELAY)
+/** Calls the deprecated relayBufferProcessor away from the audio thread and pushes
+    the audio it produces into the RelayInput, at roughly the device's rate. The
+    RelayInput's drift correction takes care of the difference in clocks.
+*/
+struct DeviceManager::RelayCallbackForwarder  : public juce::Thread
+{
+    RelayCallbackForwarder (DeviceManager& dm)
+        : juce::Thread ("Relay callback"), owner (dm)
+    {
+        startThread();
+    }
+
+    ~RelayCallbackForwarder() override
+    {
+        stopThread (1000);
+    }
+
+    void run() override
+    {
+        // The options are read once as that locks out the audio thread
+        auto& relay = owner.getRelayInput();
+        const int numChannels = relay.getOptions().numChannels;
+
+        juce::AudioBuffer<float> block;
+        auto lastTime = juce::Time::getMillisecondCounterHiRes();
+        double numSamplesDue = 0;
+
+        while (! threadShouldExit())
+        {
+            const auto sampleRate = owner.getSampleRate();
+            const int blockSize = owner.getBlockSize();
+            const auto now = juce::Time::getMillisecondCounterHiRes();
+
+            // Don't try to catch up with more than a few blocks if this thread has been held up
+            numSamplesDue = std::min (numSamplesDue + (now - lastTime) * sampleRate / 1000.0, 4.0 * blockSize);
+            lastTime = now;
+
+            while (blockSize > 0 && numSamplesDue >= blockSize && ! threadShouldExit())
+            {
+                numSamplesDue -= blockSize;
+
+                block.setSize (numChannels, blockSize, false, false, true);
+                block.clear();
+
+                {
+                    std::unique_lock<std::mutex> lock (owner.m_muRelayCallback);
+
+                    if (owner.relayBufferProcessor == nullptr)
+                    {
+                        numSamplesDue = 0;
+                        break;
+                    }
+
+                    owner.relayBufferProcessor (block, blockSize, relay.isRecordingReady());
+                }
+
+                relay.push (block.getArrayOfReadPointers(), block.getNumChannels(), blockSize);
+            }
+
+            wait (sampleRate > 0 ? std::max (1, juce::roundToInt (500.0 * blockSize / sampleRate)) : 10);
+        }
+    }
+
+    DeviceManager& owner;
+};
+
 void DeviceManager::enableRelay(bool p_Enable)
 {
     m_EnableRealy = p_Enable;
+
+    if (! p_Enable)
+        relayCallbackForwarder.reset();
+    else if (relayCallbackForwarder == nullptr)
+        relayCallbackForwarder = std::make_unique<RelayCallbackForwarder> (*this);
+
     rebuildWaveDeviceList();
 }
 // BEATCONNECT MODIFICATION END (RELAY)
@@ -76,8 +76,16 @@ public:
 
     // Sets an upper limit on the proportion of CPU time being used - if getCpuUsage() exceeds this,
     // the processing will be muted to keep the system running. Defaults to 0.98
+    // BEATCONNECT MODIFICATION START
+    // The output is only muted once the OverloadPolicy has run out of other measures to apply.
+    // BEATCONNECT MODIFICATION END
     void setCpuLimitBeforeMuting (double newLimit)      { jassert (newLimit > 0); cpuLimitBeforeMuting = newLimit; }
 
+    // BEATCONNECT MODIFICATION START
+    /** Returns the policy used to shed load when the audio callback is overloaded. */
+    OverloadPolicy& getOverloadPolicy() const           { return *overloadPolicy; }
+    // BEATCONNECT MODIFICATION END
+
     void updateNumCPUs(); // should be called when active num CPUs is changed
 
     //==============================================================================
@@ -216,10 +224,25 @@ public:
     std::function<void (InputDevice*)> warnOfWastedMidiMessagesFunction;
 
     // BEATCONNECT MODIFICATION START (RELAY)
-    std::function<void(juce::AudioBuffer<float>&, int, bool)> relayBufferProcessor;
-    std::mutex m_muRelayCallback;
     bool m_EnableRealy = false;
     void enableRelay(bool p_Enable);
+
+    /** Returns the buffer that feeds the Relay input device.
+        The relay's network thread should push its audio into this.
+    */
+    RelayInput& getRelayInput() noexcept                { return relayInput; }
+
+    /** @deprecated Push the relay's audio into getRelayInput() instead.
+
+        Whilst the relay is enabled, this is called on a background thread at the
+        device's rate to fill a block of audio, which is then pushed into
+        getRelayInput(). It's no longer called from the audio callback, so the
+        bool it's passed comes from RelayInput::isRecordingReady().
+        Lock m_muRelayCallback when changing it, and don't push into
+        getRelayInput() yourself whilst it's set.
+    */
+    std::function<void(juce::AudioBuffer<float>&, int, bool)> relayBufferProcessor;
+    std::mutex m_muRelayCallback;
     // BEATCONNECT MODIFICATION END (RELAY)
 
 private:
@@ -244,6 +267,16 @@ private:
     juce::CriticalSection contextLock;
     juce::Array<EditPlaybackContext*> activeContexts;
     std::unique_ptr<juce::AudioProcessor> globalOutputAudioProcessor;
+    // BEATCONNECT MODIFICATION START
+    std::unique_ptr<OverloadPolicy> overloadPolicy;
+    std::shared_ptr<ThreadPlacementPolicy::RealTimePlacement> audioCallbackPlacement;
+    std::atomic<std::thread::id> placedAudioCallbackThread;
+    // BEATCONNECT MODIFICATION END
+    // BEATCONNECT MODIFICATION START (RELAY)
+    RelayInput relayInput;
+    struct RelayCallbackForwarder;
+    std::unique_ptr<RelayCallbackForwarder> relayCallbackForwarder;
+    // BEATCONNECT MODIFICATION END (RELAY)
     juce::HeapBlock<const float*> inputChannelsScratch;
     juce::HeapBlock<float*> outputChannelsScratch;
 
@@ -26,6 +26,14 @@ namespace EditPlaybackContextInternal
         static bool usePool = false;
         return usePool;
     }
+
+    // BEATCONNECT MODIFICATION START
+    inline bool& getAdaptiveThreadCountFlag()
+    {
+        static bool adaptThreadCount = false;
+        return adaptThreadCount;
+    }
+    // BEATCONNECT MODIFICATION END
 }
 
 
@@ -143,8 +151,14 @@ private:
           player (processState, getPoolCreatorFunction (static_cast<tracktion::graph::ThreadPoolStrategy> (getThreadPoolStrategy()))),
           maxNumThreads (maxNumThreadsToUse)
      {
+         // BEATCONNECT MODIFICATION START
+         player.setThreadInitialiser (ts.edit.engine.getThreadPlacementPolicy().getGraphWorkerInitialiser());
+         // BEATCONNECT MODIFICATION END
          setNumThreads (numThreads);
          player.enablePooledMemoryAllocations (EditPlaybackContextInternal::getPooledMemoryFlag());
+         // BEATCONNECT MODIFICATION START
+         player.enableAdaptiveThreadCount (EditPlaybackContextInternal::getAdaptiveThreadCountFlag());
+         // BEATCONNECT MODIFICATION END
      }
      
      void setNumThreads (size_t numThreads)
@@ -162,10 +176,23 @@ private:
          
          if (auto currentNode = player.getNode())
              latencySamples = currentNode->getNodeProperties().latencyNumSamples;
+
+         // BEATCONNECT MODIFICATION START
+         lazyCombiningNodes.clear();
+
+         if (auto currentNode = player.getNode())
+             for (auto n : tracktion::graph::getNodes (*currentNode, tracktion::graph::VertexOrdering::postordering))
+                 if (auto combiningNode = dynamic_cast<CombiningNode*> (n))
+                     if (combiningNode->getNumLazyInputs() > 0)
+                         lazyCombiningNodes.push_back (combiningNode);
+         // BEATCONNECT MODIFICATION END
      }
      
      void clearNode()
      {
+         // BEATCONNECT MODIFICATION START
+         lazyCombiningNodes.clear();
+         // BEATCONNECT MODIFICATION END
          player.clearNode();
      }
      
@@ -176,6 +203,12 @@ private:
      
      void postPosition (TimePosition newPosition)
      {
+         // BEATCONNECT MODIFICATION START
+         // Clips that are only created near the play position need creating before it moves
+         for (auto combiningNode : lazyCombiningNodes)
+             combiningNode->createLazyInputsNear (newPosition);
+         // BEATCONNECT MODIFICATION END
+
          pendingPosition.store (newPosition.inSeconds(), std::memory_order_release);
          pendingRollInToLoop.store (false, std::memory_order_release);
          positionUpdatePending = true;
@@ -288,6 +321,10 @@ private:
      MidiMessageArray scratchMidiBuffer;
      TracktionNodePlayer player;
      const size_t maxNumThreads;
+
+     // BEATCONNECT MODIFICATION START
+     std::vector<CombiningNode*> lazyCombiningNodes;
+     // BEATCONNECT MODIFICATION END
      
      int latencySamples = 0;
      choc::buffer::FrameCount numSamplesToProcess = 0;
@@ -332,6 +369,10 @@ EditPlaybackContext::ScopedDeviceListReleaser::~ScopedDeviceListReleaser()
 EditPlaybackContext::EditPlaybackContext (TransportControl& tc)
     : edit (tc.edit), transport (tc)
 {
+    // BEATCONNECT MODIFICATION START
+    masterLevels.setFreezeRequests (&edit.engine.getDeviceManager().getOverloadPolicy().getMeterFreezeRequests());
+    // BEATCONNECT MODIFICATION END
+
     if (edit.isRendering())
     {
         jassertfalse;
@@ -758,6 +799,10 @@ void EditPlaybackContext::fillNextNodeBlock (float* const* allChannels, int numC
         }
     }
 
+    // BEATCONNECT MODIFICATION START
+    edit.getParameterChangeQueue().dispatchPendingChanges (numSamples);
+    // BEATCONNECT MODIFICATION END
+
     const auto editTime = TimePosition::fromSamples (nodePlaybackContext->playHead.getPosition(), nodePlaybackContext->getSampleRate());
     edit.updateModifierTimers (editTime, numSamples);
     midiDispatcher.masterTimeUpdate (editTime);
@@ -990,6 +1035,13 @@ void EditPlaybackContext::enablePooledMemory (bool enable)
     EditPlaybackContextInternal::getPooledMemoryFlag() = enable;
 }
 
+// BEATCONNECT MODIFICATION START
+void EditPlaybackContext::enableAdaptiveThreadCount (bool enable)
+{
+    EditPlaybackContextInternal::getAdaptiveThreadCountFlag() = enable;
+}
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 static int numHighPriorityPlayers = 0, numRealtimeDefeaters = 0;
 
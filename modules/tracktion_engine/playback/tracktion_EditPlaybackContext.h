@@ -123,6 +123,14 @@ public:
     */
     static void enablePooledMemory (bool);
 
+    // BEATCONNECT MODIFICATION START
+    /** Enables parking the audio worker threads that an Edit's graph can't keep busy,
+        which saves CPU on graphs with little parallelism.
+        This applies to EditPlaybackContexts created afterwards.
+    */
+    static void enableAdaptiveThreadCount (bool);
+    // BEATCONNECT MODIFICATION END
+
 private:
     bool isAllocated = false;
 
@@ -42,6 +42,21 @@ static void getSumAndDiff (const juce::AudioBuffer<FloatType>& buffer,
 }
 
 //==============================================================================
+// BEATCONNECT MODIFICATION START
+void LevelMeasurer::FreezeRequests::setFrozen (bool shouldBeFrozen) noexcept
+{
+    if (shouldBeFrozen)
+    {
+        ++numRequests;
+    }
+    else
+    {
+        [[ maybe_unused ]] const auto numLeft = --numRequests;
+        jassert (numLeft >= 0); // Unmatched call to setFrozen (false)
+    }
+}
+// BEATCONNECT MODIFICATION END
+
 LevelMeasurer::LevelMeasurer()
 {
     clear();
@@ -50,8 +65,216 @@ LevelMeasurer::LevelMeasurer()
 LevelMeasurer::~LevelMeasurer()
 {
     TRACKTION_ASSERT_MESSAGE_THREAD
+
+    // BEATCONNECT MODIFICATION START
+    const juce::ScopedLock sl (clientsMutex);
+
+    for (auto c : clients)
+        c->setMeasurer (nullptr, -1);
+    // BEATCONNECT MODIFICATION END
 }
 
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+template<typename Fn>
+void LevelMeasurer::writeLatest (Fn&& fn) noexcept
+{
+    juce::SpinLock::ScopedLockType sl (writerLock);
+
+    // An odd version tells readers the levels are being changed
+    const auto version = latestVersion.load (std::memory_order_relaxed);
+    latestVersion.store (version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    fn (latest);
+
+    latestVersion.store (version + 2, std::memory_order_release);
+}
+
+template<typename Fn>
+void LevelMeasurer::readLatest (Fn&& fn) const noexcept
+{
+    // The function may be called more than once if the levels change whilst they're
+    // being read so it should only copy from them
+    for (;;)
+    {
+        const auto version = latestVersion.load (std::memory_order_acquire);
+
+        if ((version & 1) == 0)
+        {
+            fn (latest);
+            std::atomic_thread_fence (std::memory_order_acquire);
+
+            if (latestVersion.load (std::memory_order_relaxed) == version)
+                return;
+        }
+    }
+}
+
+uint64_t LevelMeasurer::pack (DbTimePair level) noexcept
+{
+    uint32_t dBBits;
+    std::memcpy (&dBBits, &level.dB, sizeof (dBBits));
+    return ((uint64_t) dBBits << 32) | level.time;
+}
+
+DbTimePair LevelMeasurer::unpack (uint64_t packed) noexcept
+{
+    DbTimePair level;
+    const auto dBBits = (uint32_t) (packed >> 32);
+    std::memcpy (&level.dB, &dBBits, sizeof (dBBits));
+    level.time = (uint32_t) packed;
+    return level;
+}
+
+void LevelMeasurer::raiseLevel (std::atomic<uint64_t>& maxLevel, DbTimePair level) noexcept
+{
+    const auto newLevel = pack (level);
+    auto current = maxLevel.load (std::memory_order_relaxed);
+
+    while (level.dB > unpack (current).dB
+           && ! maxLevel.compare_exchange_weak (current, newLevel, std::memory_order_relaxed))
+    {}
+}
+
+void LevelMeasurer::addAudioBlock (const float* gains, int numChannels) noexcept
+{
+    const auto now = juce::Time::getApproximateMillisecondCounter();
+    DbTimePair levels[Client::maxNumChannels];
+    uint32_t overloadedChannels = 0;
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        levels[i] = { now, gainToDb (gains[i]) };
+
+        if (gains[i] > 0.999f)
+            overloadedChannels |= 1u << i;
+    }
+
+    writeLatest ([&] (LatestLevels& l)
+    {
+        for (int i = 0; i < Client::maxNumChannels; ++i)
+        {
+            l.audioLevels[i] = i < numChannels ? levels[i] : DbTimePair { now, -100.0f };
+
+            if ((overloadedChannels & (1u << i)) != 0)
+                ++l.numOverloads[i];
+        }
+
+        l.numChannelsUsed = numChannels;
+        ++l.numAudioBlocks;
+    });
+
+    const auto activeSlots = activeClientSlots.load (std::memory_order_acquire);
+
+    for (int slot = 0; slot < maxNumClients; ++slot)
+    {
+        if ((activeSlots & (1u << slot)) == 0)
+            continue;
+
+        auto& c = clientLevels[slot];
+
+        for (int i = 0; i < numChannels; ++i)
+            raiseLevel (c.audioLevels[i], levels[i]);
+
+        if (overloadedChannels != 0)
+            c.overloadedChannels.fetch_or (overloadedChannels, std::memory_order_relaxed);
+    }
+}
+
+void LevelMeasurer::addMidiBlock (float level) noexcept
+{
+    const DbTimePair newLevel { juce::Time::getApproximateMillisecondCounter(), gainToDb (level) };
+
+    writeLatest ([&] (LatestLevels& l)
+    {
+        l.midiLevel = newLevel;
+        ++l.numMidiBlocks;
+    });
+
+    const auto activeSlots = activeClientSlots.load (std::memory_order_acquire);
+
+    for (int slot = 0; slot < maxNumClients; ++slot)
+        if ((activeSlots & (1u << slot)) != 0)
+            raiseLevel (clientLevels[slot].midiLevel, newLevel);
+}
+
+void LevelMeasurer::resetClientLevels (int slot) noexcept
+{
+    auto& c = clientLevels[slot];
+
+    for (auto& l : c.audioLevels)
+        l.store (pack ({}), std::memory_order_relaxed);
+
+    c.midiLevel.store (pack ({}), std::memory_order_relaxed);
+    c.overloadedChannels.store (0, std::memory_order_relaxed);
+}
+
+DbTimePair LevelMeasurer::takeAudioLevel (int slot, int channel) noexcept
+{
+    return unpack (clientLevels[slot].audioLevels[channel].exchange (pack ({}), std::memory_order_relaxed));
+}
+
+DbTimePair LevelMeasurer::takeMidiLevel (int slot) noexcept
+{
+    return unpack (clientLevels[slot].midiLevel.exchange (pack ({}), std::memory_order_relaxed));
+}
+
+uint32_t LevelMeasurer::takeOverloadedChannels (int slot) noexcept
+{
+    return clientLevels[slot].overloadedChannels.exchange (0, std::memory_order_relaxed);
+}
+
+LevelMeasurer::Snapshot LevelMeasurer::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+
+    readLatest ([&snapshot] (const LatestLevels& l)
+    {
+        std::copy_n (l.audioLevels, Client::maxNumChannels, snapshot.audioLevels);
+        std::copy_n (l.numOverloads, Client::maxNumChannels, snapshot.numOverloads);
+        snapshot.midiLevel = l.midiLevel;
+        snapshot.numChannelsUsed = l.numChannelsUsed;
+        snapshot.numAudioBlocks = l.numAudioBlocks;
+        snapshot.numMidiBlocks = l.numMidiBlocks;
+    });
+
+    return snapshot;
+}
+
+float LevelMeasurer::getRMSLevel (const float* samples, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return 0.0f;
+
+    float sum = 0.0f;
+    int i = 0;
+
+   #if JUCE_USE_SIMD
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int numLanes = (int) Vec::SIMDNumElements;
+
+    for (; i < numSamples && ! Vec::isSIMDAligned (samples + i); ++i)
+        sum += samples[i] * samples[i];
+
+    auto squares = Vec::expand (0.0f);
+
+    for (; i + numLanes <= numSamples; i += numLanes)
+    {
+        auto v = Vec::fromRawArray (samples + i);
+        squares += v * v;
+    }
+
+    sum += squares.sum();
+   #endif
+
+    for (; i < numSamples; ++i)
+        sum += samples[i] * samples[i];
+
+    return std::sqrt (sum / (float) numSamples);
+}
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 void LevelMeasurer::Client::reset() noexcept
 {
@@ -64,7 +287,41 @@ void LevelMeasurer::Client::reset() noexcept
 
     midiLevels = {};
     clearOverload = true;
+
+    // BEATCONNECT MODIFICATION START
+    if (measurer != nullptr && slot >= 0)
+        measurer->resetClientLevels (slot);
+    // BEATCONNECT MODIFICATION END
+}
+
+// BEATCONNECT MODIFICATION START
+void LevelMeasurer::Client::setMeasurer (LevelMeasurer* newMeasurer, int newSlot) noexcept
+{
+    juce::SpinLock::ScopedLockType sl (mutex);
+    measurer = newMeasurer;
+    slot = newSlot;
+}
+
+bool LevelMeasurer::Client::isOverloaded (int channel) noexcept
+{
+    jassert (channel >= 0 && channel < maxNumChannels);
+    uint32_t overloadedChannels = 0;
+
+    {
+        juce::SpinLock::ScopedLockType sl (mutex);
+
+        if (measurer != nullptr && slot >= 0)
+            overloadedChannels = measurer->takeOverloadedChannels (slot);
+    }
+
+    for (int i = 0; i < maxNumChannels; ++i)
+        if ((overloadedChannels & (1u << i)) != 0)
+            setOverload (i, true);
+
+    juce::SpinLock::ScopedLockType sl (mutex);
+    return overload[channel];
 }
+// BEATCONNECT MODIFICATION END
 
 bool LevelMeasurer::Client::getAndClearOverload() noexcept
 {
@@ -85,6 +342,18 @@ bool LevelMeasurer::Client::getAndClearPeak() noexcept
 DbTimePair LevelMeasurer::Client::getAndClearMidiLevel() noexcept
 {
     juce::SpinLock::ScopedLockType sl (mutex);
+
+    // BEATCONNECT MODIFICATION START
+    if (measurer != nullptr)
+    {
+        auto newLevel = slot >= 0 ? measurer->takeMidiLevel (slot)
+                                  : measurer->getSnapshot().midiLevel;
+
+        if (newLevel.dB >= midiLevels.dB)
+            midiLevels = newLevel;
+    }
+    // BEATCONNECT MODIFICATION END
+
     auto result = midiLevels;
     midiLevels.dB = -100.0f;
     return result;
@@ -94,6 +363,18 @@ DbTimePair LevelMeasurer::Client::getAndClearAudioLevel (int chan) noexcept
 {
     juce::SpinLock::ScopedLockType sl (mutex);
     jassert (chan >= 0 && chan < maxNumChannels);
+
+    // BEATCONNECT MODIFICATION START
+    if (measurer != nullptr)
+    {
+        auto newLevel = slot >= 0 ? measurer->takeAudioLevel (slot, chan)
+                                  : measurer->getSnapshot().audioLevels[chan];
+
+        if (newLevel.dB >= audioLevels[chan].dB)
+            audioLevels[chan] = newLevel;
+    }
+    // BEATCONNECT MODIFICATION END
+
     auto result = audioLevels[chan];
     audioLevels[chan].dB = -100.0f;
     return result;
@@ -108,6 +389,10 @@ void LevelMeasurer::Client::setNumChannelsUsed (int numChannels) noexcept
 int LevelMeasurer::Client::getNumChannelsUsed() noexcept
 {
     juce::SpinLock::ScopedLockType sl(mutex);
+
+    if (measurer != nullptr)
+        return measurer->getSnapshot().numChannelsUsed;
+
     return numChannelsUsed;
 }
 // BEATCONNECT MODIFICATION END
@@ -121,6 +406,17 @@ void LevelMeasurer::Client::setClearOverload (bool clear) noexcept
 {
     juce::SpinLock::ScopedLockType sl (mutex);
     clearOverload = clear;
+
+    // BEATCONNECT MODIFICATION START
+    if (clear)
+    {
+        for (auto& o : overload)
+            o = false;
+
+        if (measurer != nullptr && slot >= 0)
+            measurer->takeOverloadedChannels (slot);
+    }
+    // BEATCONNECT MODIFICATION END
 }
 
 void LevelMeasurer::Client::setClearPeak (bool clear) noexcept
@@ -141,7 +437,7 @@ void LevelMeasurer::Client::updateMidiLevel (DbTimePair newMidiLevel) noexcept
 {
     juce::SpinLock::ScopedLockType sl (mutex);
     
-    if (midiLevels.dB >= midiLevels.dB)
+    if (newMidiLevel.dB >= midiLevels.dB)
         midiLevels = newMidiLevel;
 }
 
@@ -149,81 +445,43 @@ void LevelMeasurer::Client::updateMidiLevel (DbTimePair newMidiLevel) noexcept
 //==============================================================================
 void LevelMeasurer::processBuffer (juce::AudioBuffer<float>& buffer, int start, int numSamples)
 {
-    const juce::ScopedLock sl (clientsMutex);
-
-    if (clients.isEmpty())
+    // BEATCONNECT MODIFICATION START
+    // The levels are measured once per block and raised in each client's running
+    // maximum without locking, so this doesn't need to lock the clients
+    if (isFrozen() || numClients.load (std::memory_order_relaxed) == 0)
         return;
 
     auto numChans = std::min ((int) Client::maxNumChannels, buffer.getNumChannels());
-    auto now = juce::Time::getApproximateMillisecondCounter();
+    float gains[Client::maxNumChannels] = {};
 
     if (mode == LevelMeasurer::peakMode)
     {
         // peak mode
-        for (int i = numChans; --i >= 0;)
-        {
-            auto gain = buffer.getMagnitude (i, start, numSamples);
-            bool overloaded = gain > 0.999f;
-            auto newDB = gainToDb (gain);
-
-            for (auto c : clients)
-            {
-                c->updateAudioLevel (i, { now, newDB });
-
-                if (overloaded)
-                    c->setOverload (i, true);
-
-                c->setNumChannelsUsed (numChans);
-            }
-        }
+        for (int i = 0; i < numChans; ++i)
+            gains[i] = buffer.getMagnitude (i, start, numSamples);
     }
     else if (mode == LevelMeasurer::RMSMode)
     {
         // rms mode
-        for (int i = numChans; --i >= 0;)
-        {
-            auto gain = buffer.getRMSLevel (i, start, numSamples);
-            bool overloaded = gain > 0.999f;
-            auto newDB = gainToDb (gain);
-
-            for (auto c : clients)
-            {
-                c->updateAudioLevel (i, { now, newDB });
-
-                if (overloaded)
-                    c->setOverload (i, true);
-
-                c->setNumChannelsUsed (numChans);
-            }
-        }
+        for (int i = 0; i < numChans; ++i)
+            gains[i] = getRMSLevel (buffer.getReadPointer (i, start), numSamples);
     }
     else
     {
         // sum + diff
-        float sum, diff;
-        getSumAndDiff (buffer, sum, diff, start, numSamples);
-
-        auto sumDB  = gainToDb (sum);
-        auto diffDB = gainToDb (diff);
-
-        for (auto c : clients)
-        {
-            c->updateAudioLevel (0, { now, sumDB });
-            c->updateAudioLevel (1, { now, diffDB });
-
-            if (sum  > 0.999f) c->setOverload (0, true);
-            if (diff > 0.999f) c->setOverload (1, true);
-
-            c->setNumChannelsUsed (2);
-        }
+        getSumAndDiff (buffer, gains[0], gains[1], start, numSamples);
+        numChans = 2;
     }
+
+    if (numChans > 0)
+        addAudioBlock (gains, numChans);
+    // BEATCONNECT MODIFICATION END
 }
 
 void LevelMeasurer::processMidi (MidiMessageArray& midiBuffer, const float*)
 {
-    const juce::ScopedLock sl (clientsMutex);
-
-    if (clients.isEmpty() || ! showMidi)
+    // BEATCONNECT MODIFICATION START
+    if (isFrozen() || numClients.load (std::memory_order_relaxed) == 0 || ! showMidi)
         return;
 
     float max = 0.0f;
@@ -232,23 +490,18 @@ void LevelMeasurer::processMidi (MidiMessageArray& midiBuffer, const float*)
         if (m.isNoteOn())
             max = juce::jmax (max, m.getFloatVelocity());
 
-    auto now = juce::Time::getApproximateMillisecondCounter();
-
-    for (auto c : clients)
-        c->updateMidiLevel ({ now, gainToDb (max) });
+    addMidiBlock (max);
+    // BEATCONNECT MODIFICATION END
 }
 
 void LevelMeasurer::processMidiLevel (float level)
 {
-    const juce::ScopedLock sl (clientsMutex);
-
-    if (clients.isEmpty() || ! showMidi)
+    // BEATCONNECT MODIFICATION START
+    if (isFrozen() || numClients.load (std::memory_order_relaxed) == 0 || ! showMidi)
         return;
 
-    auto now = juce::Time::getApproximateMillisecondCounter();
-
-    for (auto c : clients)
-        c->updateMidiLevel ({ now, gainToDb (level) });
+    addMidiBlock (level);
+    // BEATCONNECT MODIFICATION END
 }
 
 void LevelMeasurer::clearOverload()
@@ -269,6 +522,21 @@ void LevelMeasurer::clearPeak()
 
 void LevelMeasurer::clear()
 {
+    // BEATCONNECT MODIFICATION START
+    writeLatest ([] (LatestLevels& l)
+    {
+        for (auto& level : l.audioLevels)
+            level = {};
+
+        for (auto& n : l.numOverloads)
+            n = 0;
+
+        l.midiLevel = {};
+    });
+
+    // Each client's running levels are reset by Client::reset below
+    // BEATCONNECT MODIFICATION END
+
     const juce::ScopedLock sl (clientsMutex);
 
     for (auto c : clients)
@@ -290,12 +558,40 @@ void LevelMeasurer::addClient (Client& c)
     const juce::ScopedLock sl (clientsMutex);
     jassert (! clients.contains (&c));
     clients.add (&c);
+
+    // BEATCONNECT MODIFICATION START
+    // Give the client a free set of running levels if there is one
+    int slot = -1;
+    const auto activeSlots = activeClientSlots.load();
+
+    for (int i = 0; i < maxNumClients; ++i)
+    {
+        if ((activeSlots & (1u << i)) == 0)
+        {
+            slot = i;
+            resetClientLevels (slot);
+            activeClientSlots.store (activeSlots | (1u << slot), std::memory_order_release);
+            break;
+        }
+    }
+
+    c.setMeasurer (this, slot);
+    numClients = clients.size();
+    // BEATCONNECT MODIFICATION END
 }
 
 void LevelMeasurer::removeClient (Client& c)
 {
     const juce::ScopedLock sl (clientsMutex);
     clients.removeFirstMatchingValue (&c);
+
+    // BEATCONNECT MODIFICATION START
+    if (c.measurer == this && c.slot >= 0)
+        activeClientSlots.fetch_and (~(1u << c.slot));
+
+    c.setMeasurer (nullptr, -1);
+    numClients = clients.size();
+    // BEATCONNECT MODIFICATION END
 }
 
 void LevelMeasurer::setShowMidi (bool show)
@@ -327,6 +623,11 @@ void SharedLevelMeasurer::setSize (int channels, int numSamples)
 
 void SharedLevelMeasurer::addBuffer (const juce::AudioBuffer<float>& inBuffer, int startSample, int numSamples)
 {
+    // BEATCONNECT MODIFICATION START
+    if (isFrozen())
+        return;
+    // BEATCONNECT MODIFICATION END
+
     setSize (2, numSamples);
 
     juce::SpinLock::ScopedLockType lock (spinLock);
@@ -54,6 +54,11 @@ public:
     int getNumActiveChannels() const noexcept           { return numActiveChannels; }
 
     //==============================================================================
+    /** Something that displays the levels of a LevelMeasurer.
+        The audio thread keeps a running maximum of each channel for every client
+        without locking, and clients take it when they're asked for their levels.
+        The getAndClear methods return the loudest level since they were last called.
+    */
     struct Client
     {
         Client() = default;
@@ -68,6 +73,11 @@ public:
 
         // BEATCONNECT MODIFICATION START
         int getNumChannelsUsed() noexcept;
+
+        /** Returns true if a channel has overloaded since the client was reset or
+            the measurer's overloads were last cleared.
+        */
+        bool isOverloaded (int channel) noexcept;
         // BEATCONNECT MODIFICATION END
 
         /** @internal */
@@ -88,15 +98,81 @@ public:
         bool clearPeak = true;
 
         juce::SpinLock mutex;
+
+        // BEATCONNECT MODIFICATION START
+        friend class LevelMeasurer;
+        LevelMeasurer* measurer = nullptr;
+        int slot = -1;
+
+        void setMeasurer (LevelMeasurer*, int slot) noexcept;
+        // BEATCONNECT MODIFICATION END
+    };
+
+    // BEATCONNECT MODIFICATION START
+    //==============================================================================
+    /** The levels of the most recent blocks a LevelMeasurer has measured. */
+    struct Snapshot
+    {
+        DbTimePair audioLevels[Client::maxNumChannels];     /**< The levels of the last audio block. */
+        DbTimePair midiLevel;                               /**< The level of the last MIDI block. */
+        uint32_t numOverloads[Client::maxNumChannels] = {}; /**< The number of blocks each channel has overloaded in since the last clear(). */
+        int numChannelsUsed = 0;                            /**< The number of channels in the last audio block. */
+        uint32_t numAudioBlocks = 0;                        /**< The number of audio blocks measured so far. */
+        uint32_t numMidiBlocks = 0;                         /**< The number of MIDI blocks measured so far. */
     };
 
+    /** Returns the levels of the most recent blocks.
+        This doesn't lock so can be called from any thread, e.g. to update control
+        surfaces, without holding up the audio thread. Levels are only measured
+        whilst at least one Client is attached.
+    */
+    Snapshot getSnapshot() const noexcept;
+    // BEATCONNECT MODIFICATION END
+
     //==============================================================================
+    // BEATCONNECT MODIFICATION START
+    /** The number of clients the audio thread keeps running levels for.
+        Any more than this only see the levels of the most recent block when they read them.
+    */
+    static constexpr int maxNumClients = 8;
+    // BEATCONNECT MODIFICATION END
+
     void addClient (Client&);
     void removeClient (Client&);
 
     void setLevelCache (float dBL, float dBR) noexcept      { levelCacheL = dBL; levelCacheR = dBR; }
     std::pair<float, float> getLevelCache() const noexcept  { return { levelCacheL, levelCacheR }; }
 
+    // BEATCONNECT MODIFICATION START
+    //==============================================================================
+    /** Stops a group of LevelMeasurers from measuring incoming buffers so clients will
+        see their last levels. Each Engine's OverloadPolicy has one of these which that
+        Engine's meters are attached to, so an overload only freezes its own meters.
+    */
+    class FreezeRequests
+    {
+    public:
+        /** Calls are counted so each call with true must be matched by one with false. */
+        void setFrozen (bool shouldBeFrozen) noexcept;
+
+        /** Returns true if there are any outstanding requests to freeze. */
+        bool isFrozen() const noexcept                      { return numRequests.load (std::memory_order_relaxed) > 0; }
+
+    private:
+        std::atomic<int> numRequests { 0 };
+    };
+
+    /** Attaches this to a set of FreezeRequests, which must outlive it, or nullptr to detach it. */
+    void setFreezeRequests (const FreezeRequests* f) noexcept   { freezeRequests.store (f, std::memory_order_relaxed); }
+
+    /** Returns true if the FreezeRequests this is attached to are frozen. */
+    bool isFrozen() const noexcept
+    {
+        auto f = freezeRequests.load (std::memory_order_relaxed);
+        return f != nullptr && f->isFrozen();
+    }
+    // BEATCONNECT MODIFICATION END
+
 private:
     Mode mode = peakMode;
     int numActiveChannels = 1;
@@ -107,6 +183,54 @@ private:
     juce::Array<Client*> clients;
     juce::CriticalSection clientsMutex;
 
+    // BEATCONNECT MODIFICATION START
+    std::atomic<const FreezeRequests*> freezeRequests { nullptr };
+
+    // The levels of the last block, for snapshots. Readers use latestVersion to check
+    // the audio thread didn't change them whilst they were reading them.
+    struct LatestLevels
+    {
+        DbTimePair audioLevels[Client::maxNumChannels];
+        DbTimePair midiLevel;
+        uint32_t numOverloads[Client::maxNumChannels] = {};
+        int numChannelsUsed = 0;
+        uint32_t numAudioBlocks = 0, numMidiBlocks = 0;
+    };
+
+    LatestLevels latest;
+    std::atomic<uint32_t> latestVersion { 0 };
+    juce::SpinLock writerLock;
+    std::atomic<int> numClients { 0 };
+
+    // The loudest levels since each client last read them. A DbTimePair is packed into
+    // each atomic so the audio thread can raise them, and clients take them, without locking.
+    struct ClientLevels
+    {
+        std::atomic<uint64_t> audioLevels[Client::maxNumChannels];
+        std::atomic<uint64_t> midiLevel;
+        std::atomic<uint32_t> overloadedChannels { 0 };
+    };
+
+    ClientLevels clientLevels[maxNumClients];
+    std::atomic<uint32_t> activeClientSlots { 0 };
+
+    void addAudioBlock (const float* gains, int numChannels) noexcept;
+    void addMidiBlock (float level) noexcept;
+    void resetClientLevels (int slot) noexcept;
+    DbTimePair takeAudioLevel (int slot, int channel) noexcept;
+    DbTimePair takeMidiLevel (int slot) noexcept;
+    uint32_t takeOverloadedChannels (int slot) noexcept;
+
+    template<typename Fn> void writeLatest (Fn&&) noexcept;
+    template<typename Fn> void readLatest (Fn&&) const noexcept;
+
+    static uint64_t pack (DbTimePair) noexcept;
+    static DbTimePair unpack (uint64_t) noexcept;
+    static void raiseLevel (std::atomic<uint64_t>&, DbTimePair) noexcept;
+
+    static float getRMSLevel (const float* samples, int numSamples) noexcept;
+    // BEATCONNECT MODIFICATION END
+
     JUCE_DECLARE_WEAK_REFERENCEABLE(LevelMeasurer)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeasurer)
 };
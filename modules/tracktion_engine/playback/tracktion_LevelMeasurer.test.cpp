@@ -0,0 +1,312 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
+
+namespace tracktion { inline namespace engine
+{
+
+#if TRACKTION_UNIT_TESTS
+
+//==============================================================================
+//==============================================================================
+class LevelMeasurerTests  : public juce::UnitTest
+{
+public:
+    LevelMeasurerTests()
+        : juce::UnitTest ("LevelMeasurer", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runLevelTests();
+        runClientTests();
+        runSnapshotTests();
+    }
+
+private:
+    static void fillBuffer (juce::AudioBuffer<float>& buffer, float gain)
+    {
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+            juce::FloatVectorOperations::fill (buffer.getWritePointer (c), gain, buffer.getNumSamples());
+    }
+
+    void runLevelTests()
+    {
+        beginTest ("Peak and RMS levels");
+
+        juce::Random r (42);
+        juce::AudioBuffer<float> buffer (2, 1031);
+
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (c, i, r.nextFloat() * 1.6f - 0.8f);
+
+        for (auto mode : { LevelMeasurer::peakMode, LevelMeasurer::RMSMode })
+        {
+            LevelMeasurer measurer;
+            LevelMeasurer::Client client;
+            measurer.setMode (mode);
+            measurer.addClient (client);
+
+            // Odd starts and lengths check the unaligned parts of the vectorised code
+            for (auto [start, numSamples] : { std::pair<int, int> { 0, 1024 }, { 1, 1030 }, { 3, 7 }, { 5, 1 } })
+            {
+                measurer.processBuffer (buffer, start, numSamples);
+                auto snapshot = measurer.getSnapshot();
+                expectEquals (snapshot.numChannelsUsed, 2);
+
+                for (int c = 0; c < 2; ++c)
+                {
+                    const auto expected = mode == LevelMeasurer::peakMode ? buffer.getMagnitude (c, start, numSamples)
+                                                                          : buffer.getRMSLevel (c, start, numSamples);
+                    expectWithinAbsoluteError (snapshot.audioLevels[c].dB, gainToDb (expected), 0.001f);
+                    expectWithinAbsoluteError (client.getAndClearAudioLevel (c).dB, gainToDb (expected), 0.001f);
+                }
+            }
+
+            measurer.removeClient (client);
+        }
+    }
+
+    void runClientTests()
+    {
+        beginTest ("Clients");
+
+        LevelMeasurer measurer;
+        LevelMeasurer::Client client1, client2;
+        measurer.addClient (client1);
+        measurer.addClient (client2);
+
+        juce::AudioBuffer<float> buffer (2, 256);
+
+        // Each client should see the loudest block since it last read the level
+        for (auto gain : { 0.25f, 0.5f, 0.125f })
+        {
+            fillBuffer (buffer, gain);
+            measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        }
+
+        expectWithinAbsoluteError (client1.getAndClearAudioLevel (0).dB, gainToDb (0.5f), 0.001f);
+        expect (client1.getAndClearAudioLevel (0).dB < -90.0f, "The level should be cleared once it's been read");
+
+        fillBuffer (buffer, 0.75f);
+        measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        fillBuffer (buffer, 0.125f);
+        measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+
+        expectWithinAbsoluteError (client1.getAndClearAudioLevel (0).dB, gainToDb (0.75f), 0.001f);
+        expectWithinAbsoluteError (client2.getAndClearAudioLevel (0).dB, gainToDb (0.75f), 0.001f);
+        expectWithinAbsoluteError (client2.getAndClearAudioLevel (1).dB, gainToDb (0.75f), 0.001f);
+        expectEquals (client2.getNumChannelsUsed(), 2);
+
+        // However many blocks are measured between reads, the peak shouldn't be lost
+        fillBuffer (buffer, 0.9f);
+        measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        fillBuffer (buffer, 0.125f);
+
+        for (int i = 0; i < 1000; ++i)
+            measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+
+        expectWithinAbsoluteError (client1.getAndClearAudioLevel (0).dB, gainToDb (0.9f), 0.001f);
+        expectWithinAbsoluteError (client2.getAndClearAudioLevel (0).dB, gainToDb (0.9f), 0.001f);
+
+        // Overloads should stay set until they're cleared
+        expect (! client1.isOverloaded (0));
+        fillBuffer (buffer, 1.0f);
+        measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        fillBuffer (buffer, 0.125f);
+        measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+
+        expect (client1.isOverloaded (0));
+        expect (client1.isOverloaded (1));
+        expect (client1.isOverloaded (0), "Reading an overload shouldn't clear it");
+        expect (client2.isOverloaded (1));
+
+        measurer.clearOverload();
+        expect (client1.getAndClearOverload());
+        expect (! client1.isOverloaded (0));
+        expect (! client2.isOverloaded (1));
+
+        // Clients added later or reset shouldn't see older blocks
+        LevelMeasurer::Client client3;
+        measurer.addClient (client3);
+        expect (client3.getAndClearAudioLevel (0).dB < -90.0f);
+
+        measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        measurer.clear();
+        expect (client3.getAndClearAudioLevel (0).dB < -90.0f);
+
+        // MIDI levels
+        measurer.setShowMidi (true);
+        measurer.processMidiLevel (0.5f);
+        measurer.processMidiLevel (0.25f);
+        expectWithinAbsoluteError (client1.getAndClearMidiLevel().dB, gainToDb (0.5f), 0.001f);
+        expect (client1.getAndClearMidiLevel().dB < -90.0f);
+
+        measurer.removeClient (client1);
+        measurer.removeClient (client2);
+        measurer.removeClient (client3);
+
+        // Without any clients nothing should be measured
+        const auto numBlocks = measurer.getSnapshot().numAudioBlocks;
+        measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        expectEquals ((int) measurer.getSnapshot().numAudioBlocks, (int) numBlocks);
+    }
+
+    void runSnapshotTests()
+    {
+        beginTest ("Snapshots");
+
+        LevelMeasurer measurer;
+        LevelMeasurer::Client client;
+        measurer.addClient (client);
+
+        juce::AudioBuffer<float> buffer (4, 64);
+        fillBuffer (buffer, 1.0f);
+        measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+
+        auto snapshot = measurer.getSnapshot();
+        expectEquals (snapshot.numChannelsUsed, 4);
+        expectEquals ((int) snapshot.numAudioBlocks, 1);
+
+        for (int c = 0; c < 4; ++c)
+            expectEquals ((int) snapshot.numOverloads[c], 1);
+
+        measurer.clear();
+        snapshot = measurer.getSnapshot();
+
+        for (int c = 0; c < 4; ++c)
+            expectEquals ((int) snapshot.numOverloads[c], 0, "Overloads should be reset by clear()");
+
+        // All the channels of a block get the same level here, so if a reader ever
+        // sees them differ it must have read a block whilst it was being written
+        std::atomic<bool> finished { false };
+        std::atomic<int> numTornSnapshots { 0 }, numSnapshots { 0 };
+
+        std::thread reader ([&]
+        {
+            while (! finished)
+            {
+                auto s = measurer.getSnapshot();
+
+                for (int c = 1; c < s.numChannelsUsed; ++c)
+                    if (s.audioLevels[c].dB != s.audioLevels[0].dB)
+                        ++numTornSnapshots;
+
+                ++numSnapshots;
+            }
+        });
+
+        for (int i = 0; i < 20000 || numSnapshots < 1000; ++i)
+        {
+            fillBuffer (buffer, (i % 100) / 100.0f);
+            measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        }
+
+        finished = true;
+        reader.join();
+
+        expectEquals (numTornSnapshots.load(), 0);
+        measurer.removeClient (client);
+    }
+};
+
+static LevelMeasurerTests levelMeasurerTests;
+
+#endif // TRACKTION_UNIT_TESTS
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+class LevelMeasurerBenchmarks  : public juce::UnitTest
+{
+public:
+    LevelMeasurerBenchmarks()
+        : juce::UnitTest ("LevelMeasurer", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        for (auto mode : { LevelMeasurer::peakMode, LevelMeasurer::RMSMode })
+            runMeasurers (mode, 256, 2, 1000);
+    }
+
+private:
+    void runMeasurers (LevelMeasurer::Mode mode, int numMeasurers, int numClientsEach, int numBlocks)
+    {
+        const auto name = std::to_string (numMeasurers) + " measurers, " + std::to_string (numClientsEach) + " clients each, "
+                            + (mode == LevelMeasurer::peakMode ? "peak" : "RMS");
+        beginTest (name);
+
+        std::vector<std::unique_ptr<LevelMeasurer>> measurers;
+        std::vector<std::unique_ptr<LevelMeasurer::Client>> clients;
+
+        for (int i = 0; i < numMeasurers; ++i)
+        {
+            measurers.push_back (std::make_unique<LevelMeasurer>());
+            measurers.back()->setMode (mode);
+
+            for (int j = 0; j < numClientsEach; ++j)
+            {
+                clients.push_back (std::make_unique<LevelMeasurer::Client>());
+                measurers.back()->addClient (*clients.back());
+            }
+        }
+
+        juce::Random r (42);
+        juce::AudioBuffer<float> buffer (2, 512);
+
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (c, i, r.nextFloat() * 2.0f - 1.0f);
+
+        // Simulates the audio thread measuring every track whilst the UI reads
+        // the levels at a much lower rate
+        {
+            ScopedBenchmark sb (createBenchmarkDescription (*this, name));
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (auto& m : measurers)
+                    m->processBuffer (buffer, 0, buffer.getNumSamples());
+
+                if (block % 8 == 0)
+                    for (auto& c : clients)
+                        for (int chan = 0; chan < 2; ++chan)
+                            c->getAndClearAudioLevel (chan);
+            }
+        }
+
+        // The blocks measured since the last read should have reached every client
+        int numClientsWithLevels = 0;
+
+        for (auto& c : clients)
+            if (c->getAndClearAudioLevel (0).dB > -10.0f && c->getAndClearAudioLevel (1).dB > -10.0f)
+                ++numClientsWithLevels;
+
+        expectEquals (numClientsWithLevels, numMeasurers * numClientsEach);
+
+        for (int i = 0; i < numMeasurers; ++i)
+            for (int j = 0; j < numClientsEach; ++j)
+                measurers[(size_t) i]->removeClient (*clients[(size_t) (i * numClientsEach + j)]);
+    }
+};
+
+static LevelMeasurerBenchmarks levelMeasurerBenchmarks;
+
+#endif // TRACKTION_BENCHMARKS
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
@@ -0,0 +1,433 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+OverloadPolicy::OverloadPolicy (Engine& e)
+    : engine (e)
+{
+    setOptions (options);
+}
+
+OverloadPolicy::~OverloadPolicy()
+{
+    stopTimer();
+
+    // Only restore the things that don't need the Edits here as they may already have been deleted
+    for (auto& ref : bypassedPlugins)
+        if (auto p = dynamic_cast<Plugin*> (ref.get()))
+            p->setBypassedForOverload (false);
+}
+
+//==============================================================================
+juce::String OverloadPolicy::getMeasureName (Measure m)
+{
+    switch (m)
+    {
+        case Measure::bypassNonEssentialPlugins:    return "Bypass non-essential plugins";
+        case Measure::cheaperTimeStretching:        return "Cheaper time-stretching";
+        case Measure::coarseAutomation:             return "Coarse automation";
+        case Measure::freezeMeters:                 return "Freeze meters";
+        case Measure::muteOutput:                   return "Mute output";
+    }
+
+    return {};
+}
+
+void OverloadPolicy::setOptions (const Options& newOptions)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    jassert (newOptions.headroomThreshold < newOptions.overloadThreshold);
+    jassert (std::find (newOptions.measures.begin(), newOptions.measures.end(), Measure::muteOutput) == newOptions.measures.end());
+
+    options = newOptions;
+
+    overloadThreshold = options.overloadThreshold;
+    headroomThreshold = options.headroomThreshold;
+    secondsBeforeApplying = options.secondsBeforeApplying;
+    secondsBeforeRestoring = options.secondsBeforeRestoring;
+    allMeasuresApplied = false;
+
+    uint32_t newUsableMeasures = 0;
+
+    for (auto m : options.measures)
+        newUsableMeasures |= getMask (m);
+
+    usableMeasures = options.enabled ? newUsableMeasures : 0u;
+
+    if (! options.enabled)
+    {
+        enabled = false;
+        stopTimer();
+        restoreAll();
+        return;
+    }
+
+    // Restore any measures that aren't used any more
+    for (int i = (int) appliedOrder.size(); --i >= 0;)
+    {
+        const auto m = appliedOrder[(size_t) i];
+
+        if (std::find (options.measures.begin(), options.measures.end(), m) == options.measures.end())
+        {
+            appliedOrder.erase (appliedOrder.begin() + i);
+            restore (m, lastCpuUsage);
+        }
+    }
+
+    enabled = true;
+    startTimer (50);
+}
+
+//==============================================================================
+TimeStretcher::Mode OverloadPolicy::getTimeStretchModeToUse (TimeStretcher::Mode mode) const
+{
+    if (isApplied (Measure::cheaperTimeStretching))
+        return getCheaperTimeStretchMode (mode);
+
+    return mode;
+}
+
+TimeStretcher::Mode OverloadPolicy::getCheaperTimeStretchMode (TimeStretcher::Mode mode)
+{
+    auto cheaperMode = mode;
+
+    switch (mode)
+    {
+        case TimeStretcher::soundtouchBetter:
+        case TimeStretcher::rubberbandMelodic:
+        case TimeStretcher::rubberbandPercussive:
+            cheaperMode = TimeStretcher::soundtouchNormal;
+            break;
+
+        case TimeStretcher::elastiquePro:
+        case TimeStretcher::elastiqueMonophonic:
+            cheaperMode = TimeStretcher::elastiqueEfficient;
+            break;
+
+        case TimeStretcher::disabled:
+        case TimeStretcher::elastiqueTransient:
+        case TimeStretcher::elastiqueTonal:
+        case TimeStretcher::soundtouchNormal:
+        case TimeStretcher::melodyne:
+        case TimeStretcher::elastiqueEfficient:
+        case TimeStretcher::elastiqueMobile:
+        default:
+            return mode;
+    }
+
+    // If the cheaper mode isn't available this will return the default mode instead
+    if (TimeStretcher::checkModeIsAvailable (cheaperMode) != cheaperMode)
+        return mode;
+
+    return cheaperMode;
+}
+
+void OverloadPolicy::restoreAll()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    const float cpuUsage = lastCpuUsage;
+
+    while (! appliedOrder.empty())
+        restoreLastStep (cpuUsage);
+
+    allMeasuresApplied = false;
+}
+
+//==============================================================================
+void OverloadPolicy::updateCpuUsage (double cpuUsage, double blockLengthSeconds) noexcept
+{
+    lastCpuUsage.store ((float) cpuUsage, std::memory_order_relaxed);
+
+    if (! enabled.load (std::memory_order_relaxed))
+        return;
+
+    if (cpuUsage > overloadThreshold.load (std::memory_order_relaxed))
+    {
+        secondsWithHeadroom = 0.0;
+        secondsOverloaded += blockLengthSeconds;
+
+        if (secondsOverloaded >= secondsBeforeApplying.load (std::memory_order_relaxed))
+        {
+            secondsOverloaded = 0.0;
+
+            if (! allMeasuresApplied.load (std::memory_order_relaxed))
+                pendingSteps.store (1, std::memory_order_relaxed);
+        }
+    }
+    else if (cpuUsage < headroomThreshold.load (std::memory_order_relaxed)
+             && appliedMeasures.load (std::memory_order_relaxed) != 0)
+    {
+        secondsOverloaded = 0.0;
+        secondsWithHeadroom += blockLengthSeconds;
+
+        if (secondsWithHeadroom >= secondsBeforeRestoring.load (std::memory_order_relaxed))
+        {
+            secondsWithHeadroom = 0.0;
+            pendingSteps.store (-1, std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        secondsOverloaded = 0.0;
+        secondsWithHeadroom = 0.0;
+    }
+}
+
+bool OverloadPolicy::shouldMuteOnOverload() const noexcept
+{
+    return ! enabled.load (std::memory_order_relaxed)
+            || allMeasuresApplied.load (std::memory_order_relaxed);
+}
+
+//==============================================================================
+void OverloadPolicy::timerCallback()
+{
+    processPendingSteps();
+}
+
+void OverloadPolicy::processPendingSteps()
+{
+    const float cpuUsage = lastCpuUsage;
+
+    if (wasMuted.exchange (false))
+        sendAction (Measure::muteOutput, true, "Output muted", cpuUsage);
+
+    const auto step = pendingSteps.exchange (0);
+
+    if (step > 0)
+        applyNextStep (cpuUsage);
+    else if (step < 0)
+        restoreLastStep (cpuUsage);
+}
+
+void OverloadPolicy::applyNextStep (float cpuUsage)
+{
+    for (auto m : options.measures)
+    {
+        if (m == Measure::bypassNonEssentialPlugins)
+        {
+            // This can be applied several times, bypassing more plugins each time
+            if (bypassMorePlugins (cpuUsage))
+            {
+                if (std::find (appliedOrder.begin(), appliedOrder.end(), m) == appliedOrder.end())
+                    appliedOrder.push_back (m);
+
+                return;
+            }
+
+            continue;
+        }
+
+        if (isApplied (m))
+            continue;
+
+        // Measures that won't have any effect are skipped until the next step
+        if (apply (m, cpuUsage))
+        {
+            appliedOrder.push_back (m);
+            return;
+        }
+    }
+
+    allMeasuresApplied = true;
+}
+
+void OverloadPolicy::restoreLastStep (float cpuUsage)
+{
+    allMeasuresApplied = false;
+
+    if (appliedOrder.empty())
+        return;
+
+    const auto m = appliedOrder.back();
+
+    // Plugins are re-enabled a few at a time so the CPU usage can be checked in between
+    if (m == Measure::bypassNonEssentialPlugins
+         && restoreBypassedPlugins (cpuUsage, std::max (1, options.numPluginsToRestorePerStep)))
+        return;
+
+    appliedOrder.pop_back();
+    restore (m, cpuUsage);
+}
+
+bool OverloadPolicy::apply (Measure m, float cpuUsage)
+{
+    switch (m)
+    {
+        case Measure::cheaperTimeStretching:
+        {
+            // The playing nodes check this each block so nothing needs rebuilding
+            if (auto numEdits = getNumEditsUsingRealTimeStretching(); numEdits > 0)
+            {
+                setApplied (m, true);
+                sendAction (m, true, "Using cheaper time-stretching in " + juce::String (numEdits) + " Edit(s)", cpuUsage);
+                return true;
+            }
+
+            return false;
+        }
+
+        case Measure::coarseAutomation:
+            setApplied (m, true);
+            sendAction (m, true, "Using coarse automation", cpuUsage);
+            return true;
+
+        case Measure::freezeMeters:
+            meterFreezeRequests.setFrozen (true);
+            setApplied (m, true);
+            sendAction (m, true, "Froze meters", cpuUsage);
+            return true;
+
+        case Measure::bypassNonEssentialPlugins:
+            return bypassMorePlugins (cpuUsage);
+
+        case Measure::muteOutput:
+        default:
+            return false;
+    }
+}
+
+void OverloadPolicy::restore (Measure m, float cpuUsage)
+{
+    switch (m)
+    {
+        case Measure::bypassNonEssentialPlugins:
+            restoreBypassedPlugins (cpuUsage, std::numeric_limits<int>::max());
+            setApplied (m, false);
+            break;
+
+        case Measure::cheaperTimeStretching:
+            setApplied (m, false);
+            sendAction (m, false, "Restored time-stretching", cpuUsage);
+            break;
+
+        case Measure::coarseAutomation:
+            setApplied (m, false);
+            sendAction (m, false, "Restored fine-grain automation", cpuUsage);
+            break;
+
+        case Measure::freezeMeters:
+            setApplied (m, false);
+            meterFreezeRequests.setFrozen (false);
+            sendAction (m, false, "Unfroze meters", cpuUsage);
+            break;
+
+        case Measure::muteOutput:
+        default:
+            break;
+    }
+}
+
+bool OverloadPolicy::bypassMorePlugins (float cpuUsage)
+{
+    std::vector<Plugin::Ptr> candidates;
+
+    for (auto edit : engine.getActiveEdits().getEdits())
+        for (auto p : getAllPlugins (*edit, false))
+            if (p->isNonEssential() && p->isEnabled() && ! p->isBypassedForOverload() && getPluginCpuUsage (*p) > 0.0)
+                candidates.push_back (p);
+
+    if (candidates.empty())
+        return false;
+
+    std::sort (candidates.begin(), candidates.end(),
+               [this] (auto& p1, auto& p2) { return getPluginCpuUsage (*p1) > getPluginCpuUsage (*p2); });
+
+    // Bypass the most expensive plugins until we've roughly saved enough to get back in to the headroom
+    const auto cpuToSave = cpuUsage - headroomThreshold.load();
+    double cpuSaved = 0.0;
+
+    for (auto& p : candidates)
+    {
+        const auto cost = getPluginCpuUsage (*p);
+        p->setBypassedForOverload (true);
+        bypassedPlugins.add (p->getWeakRef());
+        setApplied (Measure::bypassNonEssentialPlugins, true);
+        sendAction (Measure::bypassNonEssentialPlugins, true,
+                    "Bypassed " + p->getName() + " (" + juce::String (cost * 100.0, 1) + "% CPU)", cpuUsage);
+
+        cpuSaved += cost;
+
+        if (cpuSaved >= cpuToSave)
+            break;
+    }
+
+    return true;
+}
+
+bool OverloadPolicy::restoreBypassedPlugins (float cpuUsage, int maxNumPlugins)
+{
+    int numRestored = 0;
+
+    while (! bypassedPlugins.isEmpty() && numRestored < maxNumPlugins)
+    {
+        // Plugins that have since been deleted don't count towards the number restored
+        if (auto p = dynamic_cast<Plugin*> (bypassedPlugins.removeAndReturn (bypassedPlugins.size() - 1).get()))
+        {
+            p->setBypassedForOverload (false);
+            sendAction (Measure::bypassNonEssentialPlugins, false, "Restored " + p->getName(), cpuUsage);
+            ++numRestored;
+        }
+    }
+
+    return ! bypassedPlugins.isEmpty();
+}
+
+double OverloadPolicy::getPluginCpuUsage (const Plugin& p)
+{
+    return p.getCpuUsage();
+}
+
+int OverloadPolicy::getNumEditsUsingRealTimeStretching()
+{
+    int numEdits = 0;
+
+   #if TRACKTION_ENABLE_REALTIME_TIMESTRETCHING
+    for (auto edit : engine.getActiveEdits().getEdits())
+    {
+        if (! edit->getTransport().isPlayContextActive())
+            continue;
+
+        auto usesRealTimeStretching = [] (Edit& ed)
+        {
+            for (auto t : getClipTracks (ed))
+                for (auto c : t->getClips())
+                    if (auto ac = dynamic_cast<AudioClipBase*> (c))
+                        if (! ac->canUseProxy() && ac->getActualTimeStretchMode() != TimeStretcher::disabled)
+                            return true;
+
+            return false;
+        };
+
+        if (usesRealTimeStretching (*edit))
+            ++numEdits;
+    }
+   #endif
+
+    return numEdits;
+}
+
+void OverloadPolicy::setApplied (Measure m, bool isNowApplied)
+{
+    if (isNowApplied)
+        appliedMeasures.fetch_or (getMask (m));
+    else
+        appliedMeasures.fetch_and (~getMask (m));
+}
+
+void OverloadPolicy::sendAction (Measure m, bool applied, const juce::String& description, float cpuUsage)
+{
+    TRACKTION_LOG ("Overload: " + description);
+    listeners.call ([action = Action { m, applied, description, cpuUsage }] (Listener& l) { l.overloadActionPerformed (action); });
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,190 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+/**
+    Progressively degrades playback when the audio callback is overloaded, rather
+    than muting the whole output.
+
+    The DeviceManager passes the CPU usage of each audio callback to this. When it
+    stays above the overload threshold, measures are applied one step at a time in
+    the order given in the Options. When it stays below the headroom threshold for
+    long enough, they're restored again in reverse order.
+
+    The available measures are:
+     - bypassNonEssentialPlugins: Plugins flagged with Plugin::setNonEssential are
+       bypassed, most expensive first (as measured by Plugin::getCpuUsage), until
+       enough CPU has been saved. Each further step bypasses more of them. They're
+       re-enabled a few at a time, most recently bypassed first.
+     - cheaperTimeStretching: Real-time time-stretched clips switch to a cheaper
+       TimeStretcher::Mode (@see getCheaperTimeStretchMode) on their next block,
+       crossfading from the old one. The playback graph isn't rebuilt.
+     - coarseAutomation: Plugins using fine-grain automation update their
+       parameters once per block rather than in sub-blocks.
+     - freezeMeters: The Engine's LevelMeasurers stop measuring.
+
+    Only once all the measures have been applied will the DeviceManager mute the
+    output if the CPU usage goes over its limit.
+
+    None of the measures are applied to offline renders.
+
+    This is disabled by default, so the output is just muted on overload. Call
+    setOptions with Options::enabled set to true to use it.
+
+    Listeners are told about every action, on the message thread.
+*/
+class OverloadPolicy  : private juce::Timer
+{
+public:
+    //==============================================================================
+    OverloadPolicy (Engine&);
+    ~OverloadPolicy() override;
+
+    //==============================================================================
+    /** The measures that can be applied to reduce the CPU usage. */
+    enum class Measure
+    {
+        bypassNonEssentialPlugins,  /**< Bypasses plugins flagged as non-essential. */
+        cheaperTimeStretching,      /**< Uses a cheaper time-stretch mode for real-time stretched clips. */
+        coarseAutomation,           /**< Turns off fine-grain, sub-block automation. */
+        freezeMeters,               /**< Stops the Engine's level meters. */
+        muteOutput                  /**< Only used to report that the output was muted as a last resort. */
+    };
+
+    /** Returns a name for a Measure, for displaying in logs. */
+    static juce::String getMeasureName (Measure);
+
+    /** Configures the policy. */
+    struct Options
+    {
+        bool enabled = false;                   /**< If false, the output will be muted on overload as it always used to be. */
+        double overloadThreshold = 0.85;        /**< CPU usage (0-1) above which measures will be applied. */
+        double headroomThreshold = 0.6;         /**< CPU usage (0-1) below which measures will be restored. */
+        double secondsBeforeApplying = 0.05;    /**< How long the CPU must be overloaded before each step is applied. */
+        double secondsBeforeRestoring = 3.0;    /**< How long there must be headroom before each step is restored. */
+        int numPluginsToRestorePerStep = 2;     /**< How many bypassed plugins are re-enabled by each restoring step. */
+
+        /** The measures to use, in the order they should be applied. */
+        std::vector<Measure> measures { Measure::bypassNonEssentialPlugins,
+                                        Measure::cheaperTimeStretching,
+                                        Measure::coarseAutomation,
+                                        Measure::freezeMeters };
+    };
+
+    /** Sets new options. Any measures that are no longer in use will be restored. */
+    void setOptions (const Options&);
+
+    /** Returns the current options. */
+    const Options& getOptions() const noexcept          { return options; }
+
+    //==============================================================================
+    /** Describes something the policy has done. */
+    struct Action
+    {
+        Measure measure;
+        bool applied = true;        /**< true if the measure was applied, false if it was restored. */
+        juce::String description;   /**< A description of what was done. */
+        float cpuUsage = 0.0f;      /**< The CPU usage that triggered the action. */
+    };
+
+    /** Listens for actions performed by the policy. */
+    struct Listener
+    {
+        virtual ~Listener() = default;
+
+        /** Called on the message thread for each action. */
+        virtual void overloadActionPerformed (const Action&) = 0;
+    };
+
+    void addListener (Listener* l)                      { listeners.add (l); }
+    void removeListener (Listener* l)                   { listeners.remove (l); }
+
+    //==============================================================================
+    /** Returns true if a measure is currently applied. This is safe to call from the audio thread. */
+    bool isApplied (Measure m) const noexcept           { return (appliedMeasures.load (std::memory_order_relaxed) & getMask (m)) != 0; }
+
+    /** Returns true if a measure is in the current options, so may be applied.
+        This is safe to call from any thread.
+    */
+    bool canApply (Measure m) const noexcept            { return (usableMeasures.load (std::memory_order_relaxed) & getMask (m)) != 0; }
+
+    /** Returns the mode that real-time time-stretchers should currently use, given the mode they'd normally use. */
+    TimeStretcher::Mode getTimeStretchModeToUse (TimeStretcher::Mode) const;
+
+    /** Returns a cheaper mode to use for a given mode, or the same mode if there isn't one available. */
+    static TimeStretcher::Mode getCheaperTimeStretchMode (TimeStretcher::Mode);
+
+    /** Restores any measures that have been applied. */
+    void restoreAll();
+
+    /** Returns the FreezeRequests the Engine's LevelMeasurers should be attached to. */
+    LevelMeasurer::FreezeRequests& getMeterFreezeRequests() noexcept     { return meterFreezeRequests; }
+
+    //==============================================================================
+    /** @internal. Called by the DeviceManager from the audio thread with the CPU usage of each block. */
+    void updateCpuUsage (double cpuUsage, double blockLengthSeconds) noexcept;
+
+    /** @internal. Returns true if the output should be muted when the CPU usage is over the limit.
+        This is true if the policy is disabled or all the measures have already been applied.
+    */
+    bool shouldMuteOnOverload() const noexcept;
+
+    /** @internal. Called by the DeviceManager from the audio thread when the output had to be muted. */
+    void outputWasMuted() noexcept                      { wasMuted.store (true, std::memory_order_relaxed); }
+
+protected:
+    //==============================================================================
+    /** Applies or restores a step if the audio thread has asked for one. This is called by a timer. */
+    void processPendingSteps();
+
+    /** Returns the CPU usage used to decide which plugins to bypass. By default this is Plugin::getCpuUsage(). */
+    virtual double getPluginCpuUsage (const Plugin&);
+
+private:
+    //==============================================================================
+    Engine& engine;
+    Options options;
+
+    std::atomic<bool> enabled { false }, allMeasuresApplied { false }, wasMuted { false };
+    std::atomic<double> overloadThreshold { 0.85 }, headroomThreshold { 0.6 },
+                        secondsBeforeApplying { 0.05 }, secondsBeforeRestoring { 3.0 };
+    std::atomic<uint32_t> appliedMeasures { 0 }, usableMeasures { 0 };
+    std::atomic<int> pendingSteps { 0 };
+    std::atomic<float> lastCpuUsage { 0.0f };
+
+    // Only accessed on the audio thread
+    double secondsOverloaded = 0.0, secondsWithHeadroom = 0.0;
+
+    LevelMeasurer::FreezeRequests meterFreezeRequests;
+
+    // Only accessed on the message thread
+    juce::Array<Selectable::WeakRef> bypassedPlugins;
+    std::vector<Measure> appliedOrder;
+    juce::ListenerList<Listener> listeners;
+
+    static uint32_t getMask (Measure m) noexcept        { return 1u << (uint32_t) m; }
+
+    void timerCallback() override;
+    void applyNextStep (float cpuUsage);
+    void restoreLastStep (float cpuUsage);
+    bool apply (Measure, float cpuUsage);
+    void restore (Measure, float cpuUsage);
+    bool bypassMorePlugins (float cpuUsage);
+    bool restoreBypassedPlugins (float cpuUsage, int maxNumPlugins);
+    int getNumEditsUsingRealTimeStretching();
+    void setApplied (Measure, bool);
+    void sendAction (Measure, bool applied, const juce::String& description, float cpuUsage);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OverloadPolicy)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,271 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class OverloadPolicyTests  : public juce::UnitTest
+{
+public:
+    OverloadPolicyTests()
+        : juce::UnitTest ("OverloadPolicy", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+
+        beginTest ("Muting");
+        {
+            OverloadPolicy policy (engine);
+            expect (policy.shouldMuteOnOverload(), "The policy should be disabled by default");
+            expect (! policy.canApply (OverloadPolicy::Measure::cheaperTimeStretching));
+
+            auto opts = policy.getOptions();
+            opts.enabled = true;
+            policy.setOptions (opts);
+            expect (! policy.shouldMuteOnOverload(), "Enabled policy shouldn't mute until measures have been applied");
+            expect (policy.canApply (OverloadPolicy::Measure::cheaperTimeStretching));
+
+            opts.enabled = false;
+            policy.setOptions (opts);
+            expect (policy.shouldMuteOnOverload(), "Disabled policy should always allow muting");
+            expect (! policy.canApply (OverloadPolicy::Measure::cheaperTimeStretching));
+
+            // Overloads shouldn't request any steps when disabled
+            for (int i = 0; i < 100; ++i)
+                policy.updateCpuUsage (1.0, 0.01);
+
+            for (auto m : policy.getOptions().measures)
+                expect (! policy.isApplied (m));
+        }
+
+        beginTest ("Cheaper time-stretch modes");
+        {
+            for (auto mode : { TimeStretcher::disabled, TimeStretcher::soundtouchNormal, TimeStretcher::soundtouchBetter,
+                               TimeStretcher::elastiquePro, TimeStretcher::elastiqueEfficient, TimeStretcher::rubberbandMelodic })
+            {
+                const auto cheaperMode = OverloadPolicy::getCheaperTimeStretchMode (mode);
+
+                if (cheaperMode != mode)
+                    expect (TimeStretcher::checkModeIsAvailable (cheaperMode) == cheaperMode, "Cheaper mode should be available");
+
+                expect (OverloadPolicy::getCheaperTimeStretchMode (cheaperMode) == cheaperMode, "Cheaper modes shouldn't chain");
+            }
+
+            expect (OverloadPolicy::getCheaperTimeStretchMode (TimeStretcher::disabled) == TimeStretcher::disabled);
+
+            OverloadPolicy policy (engine);
+            expect (policy.getTimeStretchModeToUse (TimeStretcher::soundtouchBetter) == TimeStretcher::soundtouchBetter,
+                    "Mode shouldn't change until the measure is applied");
+        }
+
+        beginTest ("Frozen meters");
+        {
+            LevelMeasurer::FreezeRequests freezeRequests;
+            LevelMeasurer measurer, otherMeasurer;
+            LevelMeasurer::Client client, otherClient;
+            measurer.setFreezeRequests (&freezeRequests);
+            measurer.addClient (client);
+            otherMeasurer.addClient (otherClient);
+
+            juce::AudioBuffer<float> buffer (2, 512);
+            buffer.clear();
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (0, i, 0.5f);
+
+            freezeRequests.setFrozen (true);
+            expect (measurer.isFrozen());
+            expect (! otherMeasurer.isFrozen(), "Meters attached to other FreezeRequests shouldn't be frozen");
+            measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+            otherMeasurer.processBuffer (buffer, 0, buffer.getNumSamples());
+            expect (client.getAndClearAudioLevel (0).dB < -90.0f, "Frozen meters shouldn't measure anything");
+            expectWithinAbsoluteError (otherClient.getAndClearAudioLevel (0).dB, gainToDb (0.5f), 0.01f);
+
+            freezeRequests.setFrozen (false);
+            expect (! measurer.isFrozen());
+            measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+            expectWithinAbsoluteError (client.getAndClearAudioLevel (0).dB, gainToDb (0.5f), 0.01f);
+
+            measurer.removeClient (client);
+            otherMeasurer.removeClient (otherClient);
+        }
+
+        runStepTests (engine);
+    }
+
+private:
+    /** Lets the tests process steps straight away and set the CPU usage of plugins. */
+    struct TestPolicy  : public OverloadPolicy,
+                         private OverloadPolicy::Listener
+    {
+        TestPolicy (Engine& e)  : OverloadPolicy (e)    { addListener (this); }
+        ~TestPolicy() override                          { removeListener (this); }
+
+        using OverloadPolicy::processPendingSteps;
+
+        double getPluginCpuUsage (const Plugin& p) override
+        {
+            auto found = pluginCpuUsage.find (&p);
+            return found != pluginCpuUsage.end() ? found->second : 0.0;
+        }
+
+        void overloadActionPerformed (const Action& a) override    { actions.push_back (a); }
+
+        std::map<const Plugin*, double> pluginCpuUsage;
+        std::vector<Action> actions;
+    };
+
+    void runStepTests (Engine& engine)
+    {
+        using Measure = OverloadPolicy::Measure;
+
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+
+        TestPolicy policy (engine);
+        auto opts = policy.getOptions();
+        opts.enabled = true;
+        opts.overloadThreshold = 0.85;
+        opts.headroomThreshold = 0.6;
+        opts.secondsBeforeApplying = 0.05;
+        opts.secondsBeforeRestoring = 1.0;
+        opts.numPluginsToRestorePerStep = 2;
+        opts.measures = { Measure::bypassNonEssentialPlugins, Measure::coarseAutomation };
+        policy.setOptions (opts);
+
+        // The plugins are bypassed most expensive first
+        juce::Array<Plugin*> plugins;
+
+        for (auto cpuUsage : { 0.01, 0.5, 0.02, 0.3 })
+        {
+            auto plugin = edit->getPluginCache().createNewPlugin (VolumeAndPanPlugin::xmlTypeName, {});
+            track->pluginList.insertPlugin (plugin, 0, nullptr);
+            plugin->setNonEssential (true);
+            policy.pluginCpuUsage[plugin.get()] = cpuUsage;
+            plugins.add (plugin.get());
+        }
+
+        auto getBypassed = [&plugins]
+        {
+            juce::Array<Plugin*> bypassed;
+
+            for (auto p : plugins)
+                if (p->isBypassedForOverload())
+                    bypassed.add (p);
+
+            return bypassed;
+        };
+
+        auto updateAndProcess = [&policy] (double cpuUsage, double seconds)
+        {
+            policy.updateCpuUsage (cpuUsage, seconds);
+            policy.processPendingSteps();
+        };
+
+        beginTest ("Steps applied in order");
+        {
+            // Saving 0.35 needs the most expensive plugin first, then the other three
+            updateAndProcess (0.95, 0.1);
+            expect (getBypassed() == juce::Array<Plugin*> { plugins[1] });
+            expect (policy.isApplied (Measure::bypassNonEssentialPlugins));
+            expect (! policy.isApplied (Measure::coarseAutomation));
+
+            updateAndProcess (0.95, 0.1);
+            expectEquals (getBypassed().size(), 4);
+            expect (! policy.isApplied (Measure::coarseAutomation));
+
+            // With no more plugins to bypass the next measure is used
+            updateAndProcess (0.95, 0.1);
+            expect (policy.isApplied (Measure::coarseAutomation));
+            expect (! policy.shouldMuteOnOverload());
+
+            updateAndProcess (0.95, 0.1);
+            expect (policy.shouldMuteOnOverload(), "Should mute once all measures have been applied");
+
+            // Too short an overload shouldn't do anything
+            policy.actions.clear();
+            updateAndProcess (0.95, 0.01);
+            expect (policy.actions.empty());
+        }
+
+        beginTest ("Steps restored in reverse order with hysteresis");
+        {
+            policy.actions.clear();
+
+            // Usage between the thresholds doesn't count towards restoring
+            updateAndProcess (0.7, 10.0);
+            expect (policy.isApplied (Measure::coarseAutomation));
+
+            updateAndProcess (0.5, 0.5);
+            expect (policy.isApplied (Measure::coarseAutomation), "Shouldn't restore before secondsBeforeRestoring");
+
+            updateAndProcess (0.5, 0.5);
+            expect (! policy.isApplied (Measure::coarseAutomation));
+            expect (! policy.shouldMuteOnOverload());
+            expectEquals (getBypassed().size(), 4);
+
+            // A brief overload resets the time spent with headroom
+            updateAndProcess (0.5, 0.5);
+            updateAndProcess (0.9, 0.01);
+            updateAndProcess (0.5, 0.5);
+            expectEquals (getBypassed().size(), 4);
+
+            // Plugins are restored a couple at a time, most recently bypassed first
+            updateAndProcess (0.5, 0.5);
+            expect (getBypassed() == juce::Array<Plugin*> { plugins[1], plugins[3] });
+            expect (policy.isApplied (Measure::bypassNonEssentialPlugins));
+
+            updateAndProcess (0.5, 1.0);
+            expect (getBypassed().isEmpty());
+            expect (! policy.isApplied (Measure::bypassNonEssentialPlugins));
+
+            std::vector<Measure> restored;
+
+            for (auto& a : policy.actions)
+            {
+                expect (! a.applied);
+                restored.push_back (a.measure);
+            }
+
+            expect (restored == std::vector<Measure> { Measure::coarseAutomation,
+                                                       Measure::bypassNonEssentialPlugins, Measure::bypassNonEssentialPlugins,
+                                                       Measure::bypassNonEssentialPlugins, Measure::bypassNonEssentialPlugins });
+
+            // Nothing is left to restore
+            policy.actions.clear();
+            updateAndProcess (0.5, 10.0);
+            expect (policy.actions.empty());
+        }
+
+        beginTest ("Restoring all steps");
+        {
+            updateAndProcess (0.95, 0.1);
+            updateAndProcess (0.95, 0.1);
+            expectEquals (getBypassed().size(), 4);
+
+            policy.restoreAll();
+            expect (getBypassed().isEmpty());
+            expect (! policy.isApplied (Measure::bypassNonEssentialPlugins));
+        }
+    }
+};
+
+static OverloadPolicyTests overloadPolicyTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
@@ -0,0 +1,331 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace thread_placement_utils
+{
+    // The Scheduling values match tracktion::graph::ThreadScheduling
+    inline tracktion::graph::ThreadPlacement toGraphPlacement (const ThreadPlacementPolicy::Placement& p)
+    {
+        tracktion::graph::ThreadPlacement placement;
+        placement.cpus.assign (p.cpus.begin(), p.cpus.end());
+        placement.scheduling = static_cast<tracktion::graph::ThreadScheduling> (p.scheduling);
+        placement.priority = p.priority;
+
+        return placement;
+    }
+
+    inline ThreadPlacementPolicy::ThreadReport createReport (ThreadPlacementPolicy::ThreadRole role, const juce::String& threadName,
+                                                             const ThreadPlacementPolicy::Placement& requested,
+                                                             const tracktion::graph::ThreadPlacementResult& result)
+    {
+        ThreadPlacementPolicy::ThreadReport r;
+        r.role = role;
+        r.threadName = threadName;
+        r.requested = requested;
+
+        for (auto cpu : result.cpus)
+            r.achieved.cpus.add (cpu);
+
+        r.achieved.scheduling = static_cast<ThreadPlacementPolicy::Scheduling> (result.scheduling);
+        r.achieved.priority = result.priority;
+        r.error = result.error;
+
+        return r;
+    }
+
+    inline juce::String getSchedulingName (ThreadPlacementPolicy::Scheduling s, const juce::String& unsetName)
+    {
+        switch (s)
+        {
+            case ThreadPlacementPolicy::Scheduling::normal:         return "normal";
+            case ThreadPlacementPolicy::Scheduling::fifo:           return "SCHED_FIFO";
+            case ThreadPlacementPolicy::Scheduling::roundRobin:     return "SCHED_RR";
+            case ThreadPlacementPolicy::Scheduling::unchanged:      return "scheduling " + unsetName;
+        }
+
+        jassertfalse;
+        return {};
+    }
+
+    /** Describes a placement, using unsetName for anything that isn't set. */
+    inline juce::String describe (const ThreadPlacementPolicy::Placement& p, const juce::String& unsetName)
+    {
+        auto s = "CPUs " + (p.cpus.isEmpty() ? unsetName : ThreadPlacementPolicy::createCpuListString (p.cpus))
+                  + ", " + getSchedulingName (p.scheduling, unsetName);
+
+        if (p.scheduling == ThreadPlacementPolicy::Scheduling::fifo
+            || p.scheduling == ThreadPlacementPolicy::Scheduling::roundRobin)
+            s << " " << p.priority;
+
+        return s;
+    }
+}
+
+//==============================================================================
+void ThreadPlacementPolicy::setPlacement (ThreadRole role, Placement newPlacement)
+{
+    const std::lock_guard<std::mutex> sl (mutex);
+    placements[static_cast<int> (role)] = std::move (newPlacement);
+}
+
+ThreadPlacementPolicy::Placement ThreadPlacementPolicy::getPlacement (ThreadRole role) const
+{
+    const std::lock_guard<std::mutex> sl (mutex);
+    auto placement = placements[static_cast<int> (role)];
+
+    if (role != ThreadRole::housekeeping || ! placement.cpus.isEmpty())
+        return placement;
+
+    // Keep housekeeping off any CPUs reserved for audio
+    juce::Array<int> reservedCpus;
+    reservedCpus.addArray (placements[static_cast<int> (ThreadRole::audioCallback)].cpus);
+    reservedCpus.addArray (placements[static_cast<int> (ThreadRole::graphWorker)].cpus);
+
+    if (reservedCpus.isEmpty())
+        return placement;
+
+    for (int cpu = 0; cpu < juce::SystemStats::getNumCpus(); ++cpu)
+        if (! reservedCpus.contains (cpu))
+            placement.cpus.add (cpu);
+
+    return placement;
+}
+
+bool ThreadPlacementPolicy::hasPlacement (ThreadRole role) const
+{
+    return ! getPlacement (role).isEmpty();
+}
+
+bool ThreadPlacementPolicy::useIsolatedCpus (int audioCallbackPriority, int graphWorkerPriority)
+{
+    auto isolatedCpus = getIsolatedCpus();
+
+    if (isolatedCpus.isEmpty())
+        return false;
+
+    Placement audioCallback { { isolatedCpus.getFirst() }, Scheduling::fifo, audioCallbackPriority };
+    Placement graphWorker { isolatedCpus, Scheduling::fifo, graphWorkerPriority };
+
+    if (isolatedCpus.size() > 1)
+        graphWorker.cpus.remove (0);
+
+    setPlacement (ThreadRole::audioCallback, std::move (audioCallback));
+    setPlacement (ThreadRole::graphWorker, std::move (graphWorker));
+
+    return true;
+}
+
+//==============================================================================
+void ThreadPlacementPolicy::applyToCurrentThread (ThreadRole role, const juce::String& threadName)
+{
+    const auto placement = getPlacement (role);
+    const auto result = tracktion::graph::applyThreadPlacementToCurrentThread (thread_placement_utils::toGraphPlacement (placement));
+    addToReport (thread_placement_utils::createReport (role, threadName, placement, result));
+}
+
+void ThreadPlacementPolicy::applyToThread (std::thread& thread, ThreadRole role, const juce::String& threadName)
+{
+    const auto placement = getPlacement (role);
+    const auto result = tracktion::graph::applyThreadPlacement (thread, thread_placement_utils::toGraphPlacement (placement));
+    addToReport (thread_placement_utils::createReport (role, threadName, placement, result));
+}
+
+std::function<void (std::thread&, size_t)> ThreadPlacementPolicy::getGraphWorkerInitialiser()
+{
+    return [this] (std::thread& thread, size_t threadIndex)
+    {
+        // Without a placement, workers keep the priority the player would normally give them
+        if (! hasPlacement (ThreadRole::graphWorker))
+            tracktion::graph::setThreadPriority (thread, 10);
+
+        applyToThread (thread, ThreadRole::graphWorker, "Graph worker " + juce::String ((int) threadIndex + 1));
+    };
+}
+
+//==============================================================================
+ThreadPlacementPolicy::RealTimePlacement::RealTimePlacement (ThreadRole roleToUse, juce::String name, Placement placement)
+    : role (roleToUse), threadName (std::move (name)), requested (std::move (placement)),
+      prepared (thread_placement_utils::toGraphPlacement (requested))
+{
+}
+
+void ThreadPlacementPolicy::RealTimePlacement::applyToCurrentThread() noexcept
+{
+    const auto status = prepared.applyToCurrentThread();
+    affinityError.store (status.affinityError, std::memory_order_relaxed);
+    schedulingError.store (status.schedulingError, std::memory_order_relaxed);
+    hasNewResult.store (true, std::memory_order_release);
+}
+
+std::shared_ptr<ThreadPlacementPolicy::RealTimePlacement> ThreadPlacementPolicy::prepareRealTimePlacement (ThreadRole role, const juce::String& threadName)
+{
+    auto placement = getPlacement (role);
+
+    if (placement.isEmpty())
+        return {};
+
+    std::shared_ptr<RealTimePlacement> realTimePlacement (new RealTimePlacement (role, threadName, std::move (placement)));
+
+    const std::lock_guard<std::mutex> sl (mutex);
+    realTimePlacements.erase (std::remove_if (realTimePlacements.begin(), realTimePlacements.end(),
+                                              [] (auto& p) { return p.expired(); }),
+                              realTimePlacements.end());
+    realTimePlacements.push_back (realTimePlacement);
+
+    return realTimePlacement;
+}
+
+void ThreadPlacementPolicy::addRealTimeResultsToReport() const
+{
+    std::vector<ThreadReport> newReports;
+
+    {
+        const std::lock_guard<std::mutex> sl (mutex);
+
+        for (auto& weakPlacement : realTimePlacements)
+        {
+            if (auto p = weakPlacement.lock())
+            {
+                if (! p->hasNewResult.exchange (false, std::memory_order_acquire))
+                    continue;
+
+                const tracktion::graph::PreparedThreadPlacement::Status status { p->affinityError.load (std::memory_order_relaxed),
+                                                                                 p->schedulingError.load (std::memory_order_relaxed) };
+                newReports.push_back (thread_placement_utils::createReport (p->role, p->threadName, p->requested,
+                                                                            p->prepared.createResult (status)));
+            }
+        }
+    }
+
+    for (auto& r : newReports)
+        addToReport (std::move (r));
+}
+
+//==============================================================================
+std::vector<ThreadPlacementPolicy::ThreadReport> ThreadPlacementPolicy::getReport() const
+{
+    addRealTimeResultsToReport();
+
+    const std::lock_guard<std::mutex> sl (mutex);
+    return report;
+}
+
+juce::String ThreadPlacementPolicy::getReportAsString() const
+{
+    juce::StringArray lines;
+
+    for (auto& r : getReport())
+    {
+        auto line = r.threadName + " (" + getRoleName (r.role) + "): ";
+
+        if (! r.requested.isEmpty())
+            line << "requested " << thread_placement_utils::describe (r.requested, "unchanged") << ", ";
+
+        line << "running on " << thread_placement_utils::describe (r.achieved, "unknown");
+
+        if (r.error.isNotEmpty())
+            line << " - " << r.error;
+
+        lines.add (line);
+    }
+
+    return lines.joinIntoString ("\n");
+}
+
+void ThreadPlacementPolicy::addToReport (ThreadReport newReport) const
+{
+    if (newReport.error.isNotEmpty())
+        TRACKTION_LOG_ERROR ("Couldn't place thread " + newReport.threadName + ": " + newReport.error);
+
+    const std::lock_guard<std::mutex> sl (mutex);
+
+    for (auto& r : report)
+    {
+        if (r.threadName == newReport.threadName && r.role == newReport.role)
+        {
+            r = std::move (newReport);
+            return;
+        }
+    }
+
+    report.push_back (std::move (newReport));
+}
+
+//==============================================================================
+juce::Array<int> ThreadPlacementPolicy::getIsolatedCpus()
+{
+   #if JUCE_LINUX
+    return parseCpuList (juce::File ("/sys/devices/system/cpu/isolated").loadFileAsString());
+   #else
+    return {};
+   #endif
+}
+
+juce::Array<int> ThreadPlacementPolicy::parseCpuList (const juce::String& list)
+{
+    juce::Array<int> cpus;
+
+    for (auto range : juce::StringArray::fromTokens (list.trim(), ",", {}))
+    {
+        range = range.trim();
+
+        if (range.isEmpty())
+            continue;
+
+        const auto start = range.upToFirstOccurrenceOf ("-", false, false).getIntValue();
+        const auto end = range.containsChar ('-') ? range.fromFirstOccurrenceOf ("-", false, false).getIntValue()
+                                                  : start;
+
+        for (int cpu = start; cpu <= end; ++cpu)
+            cpus.addIfNotAlreadyThere (cpu);
+    }
+
+    return cpus;
+}
+
+juce::String ThreadPlacementPolicy::createCpuListString (const juce::Array<int>& cpus)
+{
+    auto sorted = cpus;
+    sorted.sort();
+
+    juce::StringArray ranges;
+
+    for (int i = 0; i < sorted.size();)
+    {
+        int end = i;
+
+        while (end + 1 < sorted.size() && sorted[end + 1] == sorted[end] + 1)
+            ++end;
+
+        ranges.add (end == i ? juce::String (sorted[i])
+                             : juce::String (sorted[i]) + "-" + juce::String (sorted[end]));
+        i = end + 1;
+    }
+
+    return ranges.joinIntoString (",");
+}
+
+juce::String ThreadPlacementPolicy::getRoleName (ThreadRole role)
+{
+    switch (role)
+    {
+        case ThreadRole::audioCallback:     return "audio callback";
+        case ThreadRole::graphWorker:       return "graph worker";
+        case ThreadRole::housekeeping:      return "housekeeping";
+    }
+
+    jassertfalse;
+    return {};
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,184 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+/**
+    Controls which CPUs the engine's threads run on and how they're scheduled.
+
+    Each thread the engine creates has a role, and each role can be given a set of
+    CPUs and a scheduling policy. For example, on a Linux machine with cores isolated
+    with isolcpus, the audio callback can be pinned to one isolated core with
+    SCHED_FIFO and the graph worker threads to the others.
+
+    The housekeeping role covers the engine's background threads, such as the audio
+    file cache threads and background jobs. If it isn't given any CPUs but the other
+    roles are, it uses every CPU the other roles don't, which keeps these threads off
+    the cores reserved for audio.
+
+    Placements are applied when threads start, so they should be set up before the
+    Engine creates its threads by overriding EngineBehaviour::initialiseThreadPlacement.
+    The Engine then applies the housekeeping placement to the thread it's created on,
+    so any threads created from that thread afterwards inherit its CPUs.
+
+    Real-time scheduling usually needs extra permissions, and CPU affinity isn't
+    available on every platform, so use getReport to see the placement each thread
+    actually ended up with.
+*/
+class ThreadPlacementPolicy
+{
+public:
+    //==============================================================================
+    /** The roles that threads can have. */
+    enum class ThreadRole
+    {
+        audioCallback,  /**< The audio device callback thread. */
+        graphWorker,    /**< The threads that help the audio callback process the playback graph. */
+        housekeeping    /**< Background threads such as the audio file cache and background jobs. */
+    };
+
+    /** How the OS should schedule a thread. */
+    enum class Scheduling
+    {
+        unchanged,      /**< Leaves the scheduling as it is. */
+        normal,         /**< The OS's default time-sharing scheduling. */
+        fifo,           /**< Real-time first-in first-out scheduling i.e. SCHED_FIFO. */
+        roundRobin      /**< Real-time round-robin scheduling i.e. SCHED_RR. */
+    };
+
+    /** Describes which CPUs a thread should run on and how it should be scheduled. */
+    struct Placement
+    {
+        juce::Array<int> cpus;                          /**< The CPUs to run on, or empty to leave them as they are. */
+        Scheduling scheduling = Scheduling::unchanged;  /**< How to schedule the thread. */
+        int priority = 0;                               /**< The OS priority to use for fifo or roundRobin, e.g. 1-99 on Linux. */
+
+        /** Returns true if this doesn't change anything. */
+        bool isEmpty() const                            { return cpus.isEmpty() && scheduling == Scheduling::unchanged; }
+    };
+
+    /** The placement requested for a thread and the one it actually ended up with. */
+    struct ThreadReport
+    {
+        ThreadRole role = ThreadRole::housekeeping;
+        juce::String threadName;
+        Placement requested;
+        Placement achieved;     /**< Has no CPUs if they couldn't be found out. */
+        juce::String error;     /**< Describes anything that couldn't be applied, or is empty. */
+    };
+
+    //==============================================================================
+    ThreadPlacementPolicy() = default;
+
+    /** Sets the placement for a role. This is only applied to threads started afterwards. */
+    void setPlacement (ThreadRole, Placement);
+
+    /** Returns the placement that will be applied to threads with a role.
+        For housekeeping this includes any CPUs chosen to avoid the other roles.
+    */
+    Placement getPlacement (ThreadRole) const;
+
+    /** Returns true if threads with this role will be moved or rescheduled. */
+    bool hasPlacement (ThreadRole) const;
+
+    /** Sets up the audio callback and graph worker roles to use the CPUs the OS has
+        isolated from general scheduling, with SCHED_FIFO.
+        The audio callback gets the first isolated CPU and the workers get the rest, or
+        share it if there's only one. Returns false if there aren't any isolated CPUs.
+    */
+    bool useIsolatedCpus (int audioCallbackPriority = 80, int graphWorkerPriority = 70);
+
+    //==============================================================================
+    /** Applies the placement for a role to the calling thread and adds it to the report. */
+    void applyToCurrentThread (ThreadRole, const juce::String& threadName);
+
+    /** Applies the placement for a role to a thread and adds it to the report. */
+    void applyToThread (std::thread&, ThreadRole, const juce::String& threadName);
+
+    /** Returns a function that the graph's LockFreeMultiThreadedNodePlayer can call to
+        place its worker threads.
+    */
+    std::function<void (std::thread&, size_t)> getGraphWorkerInitialiser();
+
+    //==============================================================================
+    /** A placement prepared so it can be applied from a real-time thread, such as the
+        audio callback, without locking or allocating.
+        Create one with prepareRealTimePlacement. Its results are added to the report the
+        next time the report is read or addRealTimeResultsToReport is called.
+    */
+    class RealTimePlacement
+    {
+    public:
+        /** Applies the placement to the calling thread. This only makes the system calls
+            needed so is safe to call from a real-time thread.
+        */
+        void applyToCurrentThread() noexcept;
+
+    private:
+        friend class ThreadPlacementPolicy;
+
+        RealTimePlacement (ThreadRole, juce::String threadName, Placement);
+
+        const ThreadRole role;
+        const juce::String threadName;
+        const Placement requested;
+        const tracktion::graph::PreparedThreadPlacement prepared;
+        std::atomic<int> affinityError { 0 }, schedulingError { 0 };
+        std::atomic<bool> hasNewResult { false };
+
+        JUCE_DECLARE_NON_COPYABLE (RealTimePlacement)
+    };
+
+    /** Prepares the placement for a role so it can be applied from a real-time thread.
+        Returns nullptr if the role doesn't have a placement.
+    */
+    std::shared_ptr<RealTimePlacement> prepareRealTimePlacement (ThreadRole, const juce::String& threadName);
+
+    /** Adds the results of any RealTimePlacements applied since this was last called to
+        the report, logging any errors. Call this from a non-real-time thread.
+    */
+    void addRealTimeResultsToReport() const;
+
+    //==============================================================================
+    /** Returns the latest report for each thread that has had a placement applied. */
+    std::vector<ThreadReport> getReport() const;
+
+    /** Returns the report as text, with one line per thread. */
+    juce::String getReportAsString() const;
+
+    //==============================================================================
+    /** Returns the CPUs that the OS has isolated from general scheduling, e.g. with
+        isolcpus on Linux. This will be empty if there aren't any or they can't be found.
+    */
+    static juce::Array<int> getIsolatedCpus();
+
+    /** Parses a list of CPUs in the form the Linux kernel uses, e.g. "0-3,6". */
+    static juce::Array<int> parseCpuList (const juce::String&);
+
+    /** Returns a list of CPUs in the form the Linux kernel uses, e.g. "0-3,6". */
+    static juce::String createCpuListString (const juce::Array<int>&);
+
+    /** Returns a name for a role, for displaying in logs. */
+    static juce::String getRoleName (ThreadRole);
+
+private:
+    //==============================================================================
+    mutable std::mutex mutex;
+    Placement placements[3];
+    mutable std::vector<ThreadReport> report;
+    std::vector<std::weak_ptr<RealTimePlacement>> realTimePlacements;
+
+    void addToReport (ThreadReport) const;
+
+    JUCE_DECLARE_NON_COPYABLE (ThreadPlacementPolicy)
+};
+
+}} // namespace tracktion { inline namespace engine
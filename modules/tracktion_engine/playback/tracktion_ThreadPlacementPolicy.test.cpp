@@ -0,0 +1,118 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class ThreadPlacementPolicyTests  : public juce::UnitTest
+{
+public:
+    ThreadPlacementPolicyTests()
+        : juce::UnitTest ("ThreadPlacementPolicy", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        using ThreadRole = ThreadPlacementPolicy::ThreadRole;
+
+        beginTest ("CPU lists");
+        {
+            expect (ThreadPlacementPolicy::parseCpuList ("0-2,5\n") == juce::Array<int> { 0, 1, 2, 5 });
+            expect (ThreadPlacementPolicy::parseCpuList ("").isEmpty());
+            expectEquals (ThreadPlacementPolicy::createCpuListString ({ 5, 0, 2, 1 }), juce::String ("0-2,5"));
+            expectEquals (ThreadPlacementPolicy::createCpuListString ({ 3 }), juce::String ("3"));
+        }
+
+        beginTest ("Housekeeping avoids reserved CPUs");
+        {
+            ThreadPlacementPolicy policy;
+            expect (! policy.hasPlacement (ThreadRole::housekeeping));
+
+            const int numCpus = juce::SystemStats::getNumCpus();
+            policy.setPlacement (ThreadRole::audioCallback, { { numCpus - 1 }, ThreadPlacementPolicy::Scheduling::fifo, 80 });
+
+            auto housekeeping = policy.getPlacement (ThreadRole::housekeeping);
+            expect (! housekeeping.cpus.contains (numCpus - 1));
+            expectEquals (housekeeping.cpus.size(), numCpus - 1);
+
+            // Explicit CPUs are used as they are
+            policy.setPlacement (ThreadRole::housekeeping, { { 0 } });
+            expect (policy.getPlacement (ThreadRole::housekeeping).cpus == juce::Array<int> { 0 });
+        }
+
+        beginTest ("Report");
+        {
+            ThreadPlacementPolicy policy;
+            policy.setPlacement (ThreadRole::graphWorker, { { 0 }, ThreadPlacementPolicy::Scheduling::normal });
+
+            std::atomic<bool> shouldExit { false };
+            std::thread thread ([&shouldExit] { while (! shouldExit) std::this_thread::yield(); });
+
+            policy.applyToThread (thread, ThreadRole::graphWorker, "Worker");
+            policy.applyToThread (thread, ThreadRole::graphWorker, "Worker");
+
+            shouldExit = true;
+            thread.join();
+
+            // Applying to the same thread again replaces its entry
+            auto report = policy.getReport();
+            expectEquals ((int) report.size(), 1);
+            expectEquals (report[0].threadName, juce::String ("Worker"));
+            expect (report[0].requested.cpus == juce::Array<int> { 0 });
+
+           #if JUCE_LINUX
+            expect (report[0].error.isEmpty(), report[0].error);
+            expect (report[0].achieved.cpus == juce::Array<int> { 0 });
+            expect (report[0].achieved.scheduling == ThreadPlacementPolicy::Scheduling::normal);
+           #endif
+
+            expect (policy.getReportAsString().startsWith ("Worker (graph worker): requested CPUs 0, normal"));
+        }
+
+        beginTest ("Real-time placement");
+        {
+            ThreadPlacementPolicy policy;
+            expect (policy.prepareRealTimePlacement (ThreadRole::audioCallback, "Audio callback") == nullptr);
+
+            policy.setPlacement (ThreadRole::audioCallback, { { 0 }, ThreadPlacementPolicy::Scheduling::normal });
+            auto realTimePlacement = policy.prepareRealTimePlacement (ThreadRole::audioCallback, "Audio callback");
+            expect (realTimePlacement != nullptr);
+
+            std::thread thread ([&realTimePlacement] { realTimePlacement->applyToCurrentThread(); });
+            thread.join();
+
+            // The result is only added to the report when it's read
+            auto report = policy.getReport();
+            expectEquals ((int) report.size(), 1);
+            expect (report[0].role == ThreadRole::audioCallback);
+            expectEquals (report[0].threadName, juce::String ("Audio callback"));
+
+           #if JUCE_LINUX
+            expect (report[0].error.isEmpty(), report[0].error);
+            expect (report[0].achieved.cpus == juce::Array<int> { 0 });
+            expect (report[0].achieved.scheduling == ThreadPlacementPolicy::Scheduling::normal);
+           #endif
+
+            // Nothing new is added until it's applied again
+            expectEquals ((int) policy.getReport().size(), 1);
+        }
+    }
+};
+
+static ThreadPlacementPolicyTests threadPlacementPolicyTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
@@ -59,6 +59,11 @@ void ChorusPlugin::initialise (const PluginInitialisationInfo& info)
     delayBuffer.ensureMaxBufferSize (bufferSizeSamples);
     delayBuffer.clearBuffer();
     phase = 0.0f;
+
+    // BEATCONNECT MODIFICATION START
+    mixSmoother.reset (info.sampleRate, 0.05);
+    mixSmoother.setCurrentAndTargetValue (mixProportion);
+    // BEATCONNECT MODIFICATION END
 }
 
 void ChorusPlugin::deinitialise()
@@ -66,6 +71,11 @@ void ChorusPlugin::deinitialise()
     delayBuffer.releaseBuffer();
 }
 
+// BEATCONNECT MODIFICATION START
+// This works on a chunk at a time: the sweep for each channel is generated with a
+// rotating phasor rather than a sin per sample, the delay line wraps with a compare
+// rather than a modulo, and the wet/dry mix is applied with vector operations. The
+// mix only gets worked out per sample while it's moving.
 void ChorusPlugin::applyToBuffer (const PluginRenderContext& fc)
 {
     if (fc.destBuffer == nullptr)
@@ -73,8 +83,7 @@ void ChorusPlugin::applyToBuffer (const PluginRenderContext& fc)
 
     SCOPED_REALTIME_CHECK
 
-    float ph = 0.0f;
-    int bufPos = 0;
+    using FVO = juce::FloatVectorOperations;
 
     const float delayMs = 20.0f;
     const float minSweepSamples = (float) ((delayMs * sampleRate) / 1000.0);
@@ -85,66 +94,89 @@ void ChorusPlugin::applyToBuffer (const PluginRenderContext& fc)
 
     delayBuffer.ensureMaxBufferSize (lengthInSamples);
 
-    // BEATCONNECT MODIFICATION START
-    // const float feedbackGain = 0.0f; // xxx not sure why this value was here..
-    // this is weird. commenting out. note that this is copied form 4OSC chorus, and this was added for some reason.
-    // BEATCONNECT MODIFICATION END
     const float lfoFactor = 0.5f * (maxSweepSamples - minSweepSamples);
     const float lfoOffset = minSweepSamples + lfoFactor;
+    const int numChannels = std::min (2, fc.destBuffer->getNumChannels());
 
-    AudioFadeCurve::CrossfadeLevels wetDry (mixProportion);
+    mixSmoother.setTargetValue (mixProportion);
 
     clearChannels (*fc.destBuffer, 2, -1, fc.bufferStartSample, fc.bufferNumSamples);
 
-    for (int chan = std::min (2, fc.destBuffer->getNumChannels()); --chan >= 0;)
-    {
-        float* const d = fc.destBuffer->getWritePointer (chan, fc.bufferStartSample);
-        float* const buf = (float*) delayBuffer.buffers[chan].getData();
+    constexpr int chunkSize = 256;
+    float sweep[chunkSize], wet[chunkSize], wetGains[chunkSize], dryGains[chunkSize];
 
-        ph = phase;
-        if (chan > 0)
-            ph += juce::MathConstants<float>::pi * width;
+    for (int done = 0; done < fc.bufferNumSamples;)
+    {
+        const auto numThisTime = std::min (chunkSize, fc.bufferNumSamples - done);
+        const bool isSmoothingMix = mixSmoother.isSmoothing();
+        AudioFadeCurve::CrossfadeLevels wetDry (mixSmoother.getTargetValue());
 
-        bufPos = delayBuffer.bufferPos;
+        if (isSmoothingMix)
+        {
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                AudioFadeCurve::CrossfadeLevels levels (mixSmoother.getNextValue());
+                wetGains[i] = levels.gain1;
+                dryGains[i] = levels.gain2;
+            }
+        }
 
-        for (int i = 0; i < fc.bufferNumSamples; ++i)
+        for (int chan = 0; chan < numChannels; ++chan)
         {
-            const float in = d[i];
+            float* const d = fc.destBuffer->getWritePointer (chan, fc.bufferStartSample + done);
+            float* const buf = (float*) delayBuffer.buffers[chan].getData();
+
+            const float channelPhase = chan > 0 ? phase + juce::MathConstants<float>::pi * width : phase;
+            effect_kernels::fillSine (sweep, numThisTime, channelPhase + (double) speed * done, speed, lfoOffset, lfoFactor);
+
+            int bufPos = delayBuffer.bufferPos;
 
-            const float sweep = lfoOffset + lfoFactor * sinf (ph);
-            ph += speed;
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                int intSweepPos = juce::roundToInt (sweep[i]);
+                const float interp = sweep[i] - intSweepPos;
 
-            int intSweepPos = juce::roundToInt (sweep);
-            const float interp = sweep - intSweepPos;
-            intSweepPos = bufPos + lengthInSamples - intSweepPos;
+                int readPos = bufPos - intSweepPos;
 
-            const float out = buf[(intSweepPos - 1) % lengthInSamples] * interp
-                              + buf[intSweepPos % lengthInSamples] * (1.0f - interp);
+                if (readPos < 0)
+                    readPos += lengthInSamples;
 
-            // BEATCONNECT MODIFICATION START
-            //float n = in + out * feedbackGain;
-            float n = in;
-            // BEATCONNECT MODIFICATION END
+                const int previousPos = readPos > 0 ? readPos - 1 : lengthInSamples - 1;
 
-            JUCE_UNDENORMALISE (n);
+                wet[i] = buf[previousPos] * interp + buf[readPos] * (1.0f - interp);
 
-            buf[bufPos] = n;
+                float n = d[i];
+                JUCE_UNDENORMALISE (n);
+                buf[bufPos] = n;
 
-            d[i] = out * wetDry.gain1 + in * wetDry.gain2;
+                if (++bufPos == lengthInSamples)
+                    bufPos = 0;
+            }
 
-            bufPos = (bufPos + 1) % lengthInSamples;
+            if (isSmoothingMix)
+            {
+                FVO::multiply (d, dryGains, numThisTime);
+                FVO::addWithMultiply (d, wet, wetGains, numThisTime);
+            }
+            else
+            {
+                FVO::multiply (d, wetDry.gain2, numThisTime);
+                FVO::addWithMultiply (d, wet, wetDry.gain1, numThisTime);
+            }
+
+            if (chan == numChannels - 1)
+                delayBuffer.bufferPos = bufPos;
         }
+
+        done += numThisTime;
     }
 
     jassert (! hasFloatingPointDenormaliseOccurred());
     zeroDenormalisedValuesIfNeeded (*fc.destBuffer);
 
-    phase = ph;
-    if (phase >= juce::MathConstants<float>::pi * 2)
-        phase -= juce::MathConstants<float>::pi * 2;
-
-    delayBuffer.bufferPos = bufPos;
+    phase = (float) std::fmod (phase + (double) speed * fc.bufferNumSamples, juce::MathConstants<double>::twoPi);
 }
+// BEATCONNECT MODIFICATION END
 
 void ChorusPlugin::restorePluginStateFromValueTree (const juce::ValueTree& v)
 {
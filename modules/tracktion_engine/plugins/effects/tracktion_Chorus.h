@@ -49,6 +49,9 @@ private:
     //==============================================================================
     DelayBufferBase delayBuffer;
     float phase = 0;
+    // BEATCONNECT MODIFICATION START
+    juce::SmoothedValue<float> mixSmoother;
+    // BEATCONNECT MODIFICATION END
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChorusPlugin)
 };
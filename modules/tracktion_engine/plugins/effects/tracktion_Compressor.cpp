@@ -86,18 +86,23 @@ void CompressorPlugin::getChannelNames (juce::StringArray* ins,
         ins->add (TRANS("Sidechain Trigger"));
 }
 
-void CompressorPlugin::initialise (const PluginInitialisationInfo&)
+void CompressorPlugin::initialise (const PluginInitialisationInfo& info)
 {
-    currentLevel = 0.0;
-    lastSamp = 0.0f;
+    // BEATCONNECT MODIFICATION START
+    envelopeFollower.reset();
+    outputGainSmoother.reset (info.sampleRate, 0.01);
+    outputGainSmoother.setCurrentAndTargetValue (dbToGain (outputDb->getCurrentValue()));
+    // BEATCONNECT MODIFICATION END
 }
 
 void CompressorPlugin::deinitialise()
 {
 }
 
-static const float preFilterAmount = 0.9f; // more = smoother level detection
-
+// BEATCONNECT MODIFICATION START
+// This works on a chunk at a time: the detector input and the gain are worked out
+// for the whole chunk with vector operations, leaving only the envelope follower
+// running per sample.
 void CompressorPlugin::applyToBuffer (const PluginRenderContext& fc)
 {
     if (fc.destBuffer == nullptr)
@@ -105,99 +110,80 @@ void CompressorPlugin::applyToBuffer (const PluginRenderContext& fc)
 
     SCOPED_REALTIME_CHECK
 
-    const double logThreshold = std::log10 (0.01);
-    const double attackFactor = std::pow (10.0, logThreshold / (attackMs->getCurrentValue() * sampleRate / 1000.0));
-    const double releaseFactor = std::pow (10.0, logThreshold / (releaseMs->getCurrentValue() * sampleRate / 1000.0));
-    const float outputGain = dbToGain (outputDb->getCurrentValue());
+    using effect_kernels::EnvelopeFollower;
+    using FVO = juce::FloatVectorOperations;
+
+    envelopeFollower.setTimes (attackMs->getCurrentValue(), releaseMs->getCurrentValue(), sampleRate);
+    outputGainSmoother.setTargetValue (dbToGain (outputDb->getCurrentValue()));
+
     const float thresh = thresholdGain->getCurrentValue();
     const float rat = ratio->getCurrentValue();
     const bool useSidechain = useSidechainTrigger.get();
     const float sidechainGain = dbToGain (sidechainDb->getCurrentValue());
 
-    float* b1 = fc.destBuffer->getWritePointer (0, fc.bufferStartSample);
+    const bool isStereo = fc.destBuffer->getNumChannels() >= 2;
+    const bool usesSidechainChannel = isStereo && useSidechain && fc.destBuffer->getNumChannels() > 2;
+    const int numChannels = isStereo ? 2 : 1;
+
+    constexpr int chunkSize = 256;
+    float detector[chunkSize], gains[chunkSize];
+    double levels[chunkSize];
 
-    if (fc.destBuffer->getNumChannels() >= 2)
+    for (int done = 0; done < fc.bufferNumSamples;)
     {
-        float* b2 = fc.destBuffer->getWritePointer (1, fc.bufferStartSample);
-        float* b3 = fc.destBuffer->getNumChannels() > 2 ? fc.destBuffer->getWritePointer (2, fc.bufferStartSample) : nullptr;
+        const auto numThisTime = std::min (chunkSize, fc.bufferNumSamples - done);
+        const auto start = fc.bufferStartSample + done;
+        float* b1 = fc.destBuffer->getWritePointer (0, start);
 
-        for (int i = fc.bufferNumSamples; --i >= 0;)
+        if (isStereo)
         {
-            float samp1 = *b1 + 1.0f;
-            samp1 -= 1.0f;
-            float samp2 = *b2 + 1.0f;
-            samp2 -= 1.0f;
-
-            float sampAvg = 0.0f;
+            float* b2 = fc.destBuffer->getWritePointer (1, start);
 
-            if (useSidechain && b3 != nullptr)
+            // Adding and removing 1 keeps tiny values from being denormals
+            for (auto b : { b1, b2 })
             {
-                sampAvg = lastSamp * preFilterAmount
-                            + std::abs (*b3++ * sidechainGain) * ((1.0f - preFilterAmount));
+                FVO::add (b, 1.0f, numThisTime);
+                FVO::add (b, -1.0f, numThisTime);
             }
-            else
+
+            if (usesSidechainChannel)
             {
-                sampAvg = lastSamp * preFilterAmount
-                            + std::abs (samp1 + samp2) * ((1.0f - preFilterAmount) * 0.5f);
+                FVO::multiply (detector, fc.destBuffer->getReadPointer (2, start), sidechainGain, numThisTime);
+                FVO::abs (detector, detector, numThisTime);
+                FVO::multiply (detector, 1.0f - EnvelopeFollower::preFilterAmount, numThisTime);
             }
-
-            JUCE_UNDENORMALISE (sampAvg);
-
-            lastSamp = sampAvg;
-
-            if (sampAvg > thresh)
-                currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
             else
-                currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
-
-            float r = outputGain;
-
-            if (currentLevel > thresh)
             {
-                // BEATCONNECT MODIFICATION START
-                // It looks like their formula here is wrong, ratio is inverted
-                //   r *= (float)((thresh + (currentLevel - thresh) * rat) / currentLevel);
-                r *= (float)((thresh + (currentLevel - thresh) * (1.0 - rat)) / currentLevel);
-                // BEATCONNECT MODIFICATION END
+                FVO::add (detector, b1, b2, numThisTime);
+                FVO::abs (detector, detector, numThisTime);
+                FVO::multiply (detector, (1.0f - EnvelopeFollower::preFilterAmount) * 0.5f, numThisTime);
             }
-
-            *b1++ = samp1 * r;
-            *b2++ = samp2 * r;
         }
-    }
-    else
-    {
-        for (int i = fc.bufferNumSamples; --i >= 0;)
+        else
         {
-            const float samp = *b1;
-            const float sampAvg = lastSamp * preFilterAmount
-                                    + std::abs (samp) * (1.0f - preFilterAmount);
-            lastSamp = sampAvg;
+            FVO::abs (detector, b1, numThisTime);
+            FVO::multiply (detector, 1.0f - EnvelopeFollower::preFilterAmount, numThisTime);
+        }
 
-            JUCE_UNDENORMALISE (lastSamp);
+        envelopeFollower.process (detector, levels, numThisTime, thresh);
 
-            if (sampAvg > thresh)
-                currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
-            else
-                currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
+        for (int i = 0; i < numThisTime; ++i)
+        {
+            const auto level = levels[i];
+            gains[i] = level > thresh ? (float) ((thresh + (level - thresh) * (1.0 - rat)) / level) : 1.0f;
+        }
 
-            float r = outputGain;
+        outputGainSmoother.applyGain (gains, numThisTime);
 
-            if (currentLevel > thresh)
-            {
-                // BEATCONNECT MODIFICATION START
-                // It looks like their formula here is wrong, ratio is inverted
-                //   r *= (float)((thresh + (currentLevel - thresh) * rat) / currentLevel);
-                r *= (float)((thresh + (currentLevel - thresh) * (1.0 - rat)) / currentLevel);
-                // BEATCONNECT MODIFICATION END
-            }
+        for (int c = 0; c < numChannels; ++c)
+            FVO::multiply (fc.destBuffer->getWritePointer (c, start), gains, numThisTime);
 
-            *b1++ = samp * r;
-        }
+        done += numThisTime;
     }
 
     clearChannels (*fc.destBuffer, 2, -1, fc.bufferStartSample, fc.bufferNumSamples);
 }
+// BEATCONNECT MODIFICATION END
 
 float CompressorPlugin::getThreshold() const
 {
@@ -58,8 +58,10 @@ public:
     static float getMaxThreshold()      { return 1.0f; }
 
 private:
-    double currentLevel = 0.0;
-    float lastSamp = 0.0f;
+    // BEATCONNECT MODIFICATION START
+    effect_kernels::EnvelopeFollower envelopeFollower;
+    juce::SmoothedValue<float> outputGainSmoother;
+    // BEATCONNECT MODIFICATION END
 
     void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
 
@@ -0,0 +1,189 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace effect_kernels
+{
+
+//==============================================================================
+BiquadCascade::BiquadCascade()
+{
+    reset();
+}
+
+void BiquadCascade::setCoefficients (int stageIndex, const juce::IIRCoefficients& coefficients) noexcept
+{
+    jassert (juce::isPositiveAndBelow (stageIndex, maxStages));
+    auto& stage = stages[stageIndex];
+
+    stage.c0 = FloatLanes::expand (coefficients.coefficients[0]);
+    stage.c1 = FloatLanes::expand (coefficients.coefficients[1]);
+    stage.c2 = FloatLanes::expand (coefficients.coefficients[2]);
+    stage.c3 = FloatLanes::expand (coefficients.coefficients[3]);
+    stage.c4 = FloatLanes::expand (coefficients.coefficients[4]);
+    stage.enabled = true;
+}
+
+void BiquadCascade::setStageEnabled (int stageIndex, bool shouldBeEnabled) noexcept
+{
+    jassert (juce::isPositiveAndBelow (stageIndex, maxStages));
+    stages[stageIndex].enabled = shouldBeEnabled;
+}
+
+void BiquadCascade::reset() noexcept
+{
+    for (auto& stage : stages)
+    {
+        for (int group = 0; group < numLaneGroups; ++group)
+        {
+            stage.state1[group] = FloatLanes::expand (0.0f);
+            stage.state2[group] = FloatLanes::expand (0.0f);
+        }
+    }
+}
+
+void BiquadCascade::process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    constexpr int lanesPerGroup = (int) FloatLanes::SIMDNumElements;
+    const auto numChannels = std::min (maxChannels, buffer.getNumChannels());
+
+    bool anyEnabled = false;
+
+    for (auto& stage : stages)
+        anyEnabled = anyEnabled || stage.enabled;
+
+    if (! anyEnabled)
+        return;
+
+    FloatLanes frames[laneBlockSize];
+
+    for (int group = 0; group * lanesPerGroup < numChannels; ++group)
+    {
+        const auto firstChannel = group * lanesPerGroup;
+        const auto numChannelsInGroup = std::min (lanesPerGroup, numChannels - firstChannel);
+        auto channels = buffer.getArrayOfWritePointers() + firstChannel;
+
+        for (int done = 0; done < numSamples;)
+        {
+            const auto numThisTime = std::min (laneBlockSize, numSamples - done);
+            interleave (frames, channels, numChannelsInGroup, startSample + done, numThisTime);
+
+            // The same transposed direct form II as juce::IIRFilter, so the results match
+            for (auto& stage : stages)
+            {
+                if (! stage.enabled)
+                    continue;
+
+                auto s1 = stage.state1[group], s2 = stage.state2[group];
+
+                for (int i = 0; i < numThisTime; ++i)
+                {
+                    const auto in = frames[i];
+                    const auto out = stage.c0 * in + s1;
+                    s1 = stage.c1 * in - stage.c3 * out + s2;
+                    s2 = stage.c2 * in - stage.c4 * out;
+                    frames[i] = out;
+                }
+
+                stage.state1[group] = s1;
+                stage.state2[group] = s2;
+            }
+
+            deinterleave (frames, channels, numChannelsInGroup, startSample + done, numThisTime);
+            done += numThisTime;
+        }
+
+        // juce::IIRFilter snaps its state to zero at the end of each block
+        for (auto& stage : stages)
+        {
+            if (! stage.enabled)
+                continue;
+
+            for (int lane = 0; lane < numChannelsInGroup; ++lane)
+            {
+                auto v1 = stage.state1[group].get ((size_t) lane);
+                auto v2 = stage.state2[group].get ((size_t) lane);
+                JUCE_SNAP_TO_ZERO (v1);
+                JUCE_SNAP_TO_ZERO (v2);
+                stage.state1[group].set ((size_t) lane, v1);
+                stage.state2[group].set ((size_t) lane, v2);
+            }
+        }
+    }
+}
+
+//==============================================================================
+void EnvelopeFollower::setTimes (double newAttackMs, double newReleaseMs, double newSampleRate) noexcept
+{
+    if (newAttackMs == attackMs && newReleaseMs == releaseMs && newSampleRate == sampleRate)
+        return;
+
+    attackMs = newAttackMs;
+    releaseMs = newReleaseMs;
+    sampleRate = newSampleRate;
+
+    // The times are how long the level takes to get within 1% of its target
+    const double logThreshold = std::log10 (0.01);
+    attackFactor = std::pow (10.0, logThreshold / (attackMs * sampleRate / 1000.0));
+    releaseFactor = std::pow (10.0, logThreshold / (releaseMs * sampleRate / 1000.0));
+}
+
+void EnvelopeFollower::reset() noexcept
+{
+    level = 0.0;
+    preFiltered = 0.0f;
+}
+
+void EnvelopeFollower::process (const float* input, double* levels, int numSamples, float threshold) noexcept
+{
+    auto lastSamp = preFiltered;
+    auto currentLevel = level;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float sampAvg = lastSamp * preFilterAmount + input[i];
+        JUCE_UNDENORMALISE (sampAvg);
+        lastSamp = sampAvg;
+
+        if (sampAvg > threshold)
+            currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
+        else
+            currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
+
+        levels[i] = currentLevel;
+    }
+
+    preFiltered = lastSamp;
+    level = currentLevel;
+}
+
+//==============================================================================
+void fillSine (float* dest, int numSamples, double phase, double increment, float offset, float scale) noexcept
+{
+    const auto cosIncrement = std::cos (increment);
+    const auto sinIncrement = std::sin (increment);
+    auto s = std::sin (phase);
+    auto c = std::cos (phase);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        dest[i] = offset + scale * (float) s;
+
+        const auto nextS = s * cosIncrement + c * sinIncrement;
+        c = c * cosIncrement - s * sinIncrement;
+        s = nextS;
+    }
+}
+
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,166 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+/**
+    Block-based DSP used by the built-in effects.
+
+    These work on a block at a time, with coefficients worked out once per block
+    rather than once per sample, and process the channels of a buffer together in
+    SIMD lanes where the algorithm allows it.
+*/
+namespace effect_kernels
+{
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    template <typename Type>
+    using Lanes = juce::dsp::SIMDRegister<Type>;
+   #else
+    /** A single lane stand-in for juce::dsp::SIMDRegister when SIMD isn't available. */
+    template <typename Type>
+    struct Lanes
+    {
+        using ElementType = Type;
+        static constexpr size_t SIMDNumElements = 1;
+
+        static Lanes expand (Type v) noexcept           { return { v }; }
+        Type get (size_t) const noexcept                { return value; }
+        void set (size_t, Type v) noexcept              { value = v; }
+
+        Lanes operator+ (Lanes other) const noexcept    { return { value + other.value }; }
+        Lanes operator- (Lanes other) const noexcept    { return { value - other.value }; }
+        Lanes operator* (Lanes other) const noexcept    { return { value * other.value }; }
+        Lanes& operator+= (Type v) noexcept             { value += v; return *this; }
+        Lanes& operator-= (Type v) noexcept             { value -= v; return *this; }
+
+        Type value;
+    };
+   #endif
+
+    /** The number of samples the kernels hold in lanes at a time. */
+    constexpr int laneBlockSize = 32;
+
+    /** Copies samples from some channels into lanes, one channel per lane.
+        Any lanes without a channel are set to zero.
+    */
+    template <typename LanesType>
+    void interleave (LanesType* dest, const float* const* channels, int numChannels,
+                     int startSample, int numSamples) noexcept
+    {
+        jassert (numChannels <= (int) LanesType::SIMDNumElements);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto v = LanesType::expand (0);
+
+            for (int c = 0; c < numChannels; ++c)
+                v.set ((size_t) c, (typename LanesType::ElementType) channels[c][startSample + i]);
+
+            dest[i] = v;
+        }
+    }
+
+    /** Copies lanes back to the channels they were interleaved from. */
+    template <typename LanesType>
+    void deinterleave (const LanesType* source, float* const* channels, int numChannels,
+                       int startSample, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            for (int c = 0; c < numChannels; ++c)
+                channels[c][startSample + i] = (float) source[i].get ((size_t) c);
+    }
+
+    //==============================================================================
+    /**
+        A series of up to four biquads applied to one or two channels at once, each
+        channel in its own lane.
+
+        This produces the same output as running each channel through a chain of
+        juce::IIRFilters, but passes over the audio once for the whole chain.
+    */
+    class BiquadCascade
+    {
+    public:
+        static constexpr int maxStages = 4;
+        static constexpr int maxChannels = 2;
+
+        BiquadCascade();
+
+        /** Sets a stage's coefficients, which also enables it. */
+        void setCoefficients (int stage, const juce::IIRCoefficients&) noexcept;
+
+        /** Bypasses or enables a stage. Bypassed stages keep their state. */
+        void setStageEnabled (int stage, bool) noexcept;
+
+        /** Clears the state of every stage. */
+        void reset() noexcept;
+
+        /** Filters up to maxChannels channels of a buffer in place. */
+        void process (juce::AudioBuffer<float>&, int startSample, int numSamples) noexcept;
+
+    private:
+        using FloatLanes = Lanes<float>;
+        static constexpr int numLaneGroups = (maxChannels + (int) FloatLanes::SIMDNumElements - 1) / (int) FloatLanes::SIMDNumElements;
+
+        struct Stage
+        {
+            FloatLanes c0, c1, c2, c3, c4;
+            FloatLanes state1[numLaneGroups], state2[numLaneGroups];
+            bool enabled = false;
+        };
+
+        Stage stages[maxStages];
+    };
+
+    //==============================================================================
+    /**
+        The level detector used by CompressorPlugin.
+
+        The input is smoothed by a one-pole pre-filter and then followed with the
+        attack time when it's above the threshold and the release time when it's
+        below. The attack and release coefficients are only recalculated when the
+        times change.
+    */
+    class EnvelopeFollower
+    {
+    public:
+        EnvelopeFollower() = default;
+
+        /** Sets the attack and release times. */
+        void setTimes (double attackMs, double releaseMs, double sampleRate) noexcept;
+
+        /** Clears the level. */
+        void reset() noexcept;
+
+        /** Follows a block of input, which should already be rectified and scaled by
+            (1 - preFilterAmount), writing the level for each sample.
+        */
+        void process (const float* input, double* levels, int numSamples, float threshold) noexcept;
+
+        static constexpr float preFilterAmount = 0.9f;  /**< More gives smoother level detection. */
+
+    private:
+        double attackMs = -1.0, releaseMs = -1.0, sampleRate = 0.0;
+        double attackFactor = 0.0, releaseFactor = 0.0;
+        double level = 0.0;
+        float preFiltered = 0.0f;
+    };
+
+    //==============================================================================
+    /** Fills a buffer with offset + scale * sin (phase + i * increment).
+        This uses a rotating phasor rather than calling sin for every sample.
+    */
+    void fillSine (float* dest, int numSamples, double phase, double increment,
+                   float offset, float scale) noexcept;
+}
+
+}} // namespace tracktion { inline namespace engine
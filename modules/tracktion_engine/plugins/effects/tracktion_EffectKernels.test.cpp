@@ -0,0 +1,590 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
+
+namespace tracktion { inline namespace engine
+{
+
+namespace effect_kernel_test_utilities
+{
+    constexpr double sampleRate = 44100.0;
+
+    //==============================================================================
+    // These are the per-sample loops the plugins used before they moved onto the
+    // kernels, kept to check the new versions against and to benchmark them.
+    struct ReferenceCompressor
+    {
+        void prepare (CompressorPlugin&) {}
+
+        void process (CompressorPlugin& p, juce::AudioBuffer<float>& buffer, int start, int numSamples)
+        {
+            const float preFilterAmount = 0.9f;
+            const double logThreshold = std::log10 (0.01);
+            const double attackFactor = std::pow (10.0, logThreshold / (p.attackMs->getCurrentValue() * sampleRate / 1000.0));
+            const double releaseFactor = std::pow (10.0, logThreshold / (p.releaseMs->getCurrentValue() * sampleRate / 1000.0));
+            const float outputGain = dbToGain (p.outputDb->getCurrentValue());
+            const float thresh = p.thresholdGain->getCurrentValue();
+            const float rat = p.ratio->getCurrentValue();
+
+            auto getGain = [&]
+            {
+                float r = outputGain;
+
+                if (currentLevel > thresh)
+                    r *= (float) ((thresh + (currentLevel - thresh) * (1.0 - rat)) / currentLevel);
+
+                return r;
+            };
+
+            float* b1 = buffer.getWritePointer (0, start);
+
+            if (buffer.getNumChannels() >= 2)
+            {
+                float* b2 = buffer.getWritePointer (1, start);
+
+                for (int i = numSamples; --i >= 0;)
+                {
+                    float samp1 = *b1 + 1.0f;
+                    samp1 -= 1.0f;
+                    float samp2 = *b2 + 1.0f;
+                    samp2 -= 1.0f;
+
+                    float sampAvg = lastSamp * preFilterAmount
+                                      + std::abs (samp1 + samp2) * ((1.0f - preFilterAmount) * 0.5f);
+                    JUCE_UNDENORMALISE (sampAvg);
+                    lastSamp = sampAvg;
+
+                    if (sampAvg > thresh)
+                        currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
+                    else
+                        currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
+
+                    const float r = getGain();
+                    *b1++ = samp1 * r;
+                    *b2++ = samp2 * r;
+                }
+            }
+            else
+            {
+                for (int i = numSamples; --i >= 0;)
+                {
+                    const float samp = *b1;
+                    const float sampAvg = lastSamp * preFilterAmount + std::abs (samp) * (1.0f - preFilterAmount);
+                    lastSamp = sampAvg;
+                    JUCE_UNDENORMALISE (lastSamp);
+
+                    if (sampAvg > thresh)
+                        currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
+                    else
+                        currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
+
+                    *b1++ = samp * getGain();
+                }
+            }
+        }
+
+        double currentLevel = 0.0;
+        float lastSamp = 0.0f;
+    };
+
+    struct ReferenceEqualiser
+    {
+        void prepare (EqualiserPlugin& p)
+        {
+            const auto sr = (float) sampleRate;
+
+            const juce::IIRCoefficients coefficients[] =
+            {
+                juce::IIRCoefficients::makeLowShelf (sr, p.loFreq->getCurrentValue(), p.loQ->getCurrentValue(),
+                                                     convertEQLevelToGain (p.loGain->getCurrentValue())),
+                juce::IIRCoefficients::makePeakFilter (sr, p.midFreq1->getCurrentValue(), p.midQ1->getCurrentValue(),
+                                                       convertEQLevelToGain (p.midGain1->getCurrentValue())),
+                juce::IIRCoefficients::makePeakFilter (sr, p.midFreq2->getCurrentValue(), p.midQ2->getCurrentValue(),
+                                                       convertEQLevelToGain (p.midGain2->getCurrentValue())),
+                juce::IIRCoefficients::makeHighShelf (sr, p.hiFreq->getCurrentValue(), p.hiQ->getCurrentValue(),
+                                                      convertEQLevelToGain (p.hiGain->getCurrentValue()))
+            };
+
+            for (int band = 0; band < 4; ++band)
+                for (auto& f : filters[band])
+                    f.setCoefficients (coefficients[band]);
+        }
+
+        void process (EqualiserPlugin& p, juce::AudioBuffer<float>& buffer, int start, int numSamples)
+        {
+            addAntiDenormalisationNoise (buffer, start, numSamples);
+
+            const float gains[] = { p.loGain->getCurrentValue(), p.midGain1->getCurrentValue(),
+                                    p.midGain2->getCurrentValue(), p.hiGain->getCurrentValue() };
+
+            for (int i = std::min (2, buffer.getNumChannels()); --i >= 0;)
+                for (int band = 0; band < 4; ++band)
+                    if (gains[band] != 0)
+                        filters[band][i].processSamples (buffer.getWritePointer (i, start), numSamples);
+
+            if (p.phaseInvert)
+                buffer.applyGain (start, numSamples, -1.0f);
+        }
+
+        juce::IIRFilter filters[4][2];
+    };
+
+    struct ReferenceLowPass
+    {
+        void prepare (LowPassPlugin& p)
+        {
+            auto c = p.mode->getCurrentValue() == 0 ? juce::IIRCoefficients::makeLowPass  (sampleRate, p.frequency->getCurrentValue())
+                                                    : juce::IIRCoefficients::makeHighPass (sampleRate, p.frequency->getCurrentValue());
+
+            for (auto& f : filter)
+                f.setCoefficients (c);
+        }
+
+        void process (LowPassPlugin&, juce::AudioBuffer<float>& buffer, int start, int numSamples)
+        {
+            for (int i = std::min (2, buffer.getNumChannels()); --i >= 0;)
+                filter[i].processSamples (buffer.getWritePointer (i, start), numSamples);
+
+            sanitiseValues (buffer, start, numSamples, 3.0f);
+        }
+
+        juce::IIRFilter filter[2];
+    };
+
+    struct ReferenceChorus
+    {
+        void prepare (ChorusPlugin& p)
+        {
+            const float delayMs = 20.0f;
+            auto maxLengthMs = 1 + juce::roundToInt (delayMs + p.depthMs);
+            delayBuffer.ensureMaxBufferSize (juce::roundToInt ((maxLengthMs * sampleRate) / 1000.0));
+            delayBuffer.clearBuffer();
+        }
+
+        void process (ChorusPlugin& p, juce::AudioBuffer<float>& buffer, int start, int numSamples)
+        {
+            float ph = 0.0f;
+            int bufPos = 0;
+
+            const float delayMs = 20.0f;
+            const float minSweepSamples = (float) ((delayMs * sampleRate) / 1000.0);
+            const float maxSweepSamples = (float) (((delayMs + p.depthMs) * sampleRate) / 1000.0);
+            const float speed = (float) ((juce::MathConstants<double>::pi * 2.0) / (sampleRate / p.speedHz));
+            const int maxLengthMs = 1 + juce::roundToInt (delayMs + p.depthMs);
+            const int lengthInSamples = juce::roundToInt ((maxLengthMs * sampleRate) / 1000.0);
+
+            const float lfoFactor = 0.5f * (maxSweepSamples - minSweepSamples);
+            const float lfoOffset = minSweepSamples + lfoFactor;
+
+            AudioFadeCurve::CrossfadeLevels wetDry (p.mixProportion);
+
+            for (int chan = std::min (2, buffer.getNumChannels()); --chan >= 0;)
+            {
+                float* const d = buffer.getWritePointer (chan, start);
+                float* const buf = (float*) delayBuffer.buffers[chan].getData();
+
+                ph = phase;
+
+                if (chan > 0)
+                    ph += juce::MathConstants<float>::pi * p.width;
+
+                bufPos = delayBuffer.bufferPos;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float in = d[i];
+
+                    const float sweep = lfoOffset + lfoFactor * sinf (ph);
+                    ph += speed;
+
+                    int intSweepPos = juce::roundToInt (sweep);
+                    const float interp = sweep - intSweepPos;
+                    intSweepPos = bufPos + lengthInSamples - intSweepPos;
+
+                    const float out = buf[(intSweepPos - 1) % lengthInSamples] * interp
+                                        + buf[intSweepPos % lengthInSamples] * (1.0f - interp);
+
+                    float n = in;
+                    JUCE_UNDENORMALISE (n);
+                    buf[bufPos] = n;
+
+                    d[i] = out * wetDry.gain1 + in * wetDry.gain2;
+
+                    bufPos = (bufPos + 1) % lengthInSamples;
+                }
+            }
+
+            phase = ph;
+
+            if (phase >= juce::MathConstants<float>::pi * 2)
+                phase -= juce::MathConstants<float>::pi * 2;
+
+            delayBuffer.bufferPos = bufPos;
+        }
+
+        DelayBufferBase delayBuffer;
+        float phase = 0.0f;
+    };
+
+    struct ReferencePhaser
+    {
+        void prepare (PhaserPlugin&)
+        {
+            std::memset (filterVals, 0, sizeof (filterVals));
+
+            const float delayMs = 100.0f;
+            sweep = minSweep = (juce::MathConstants<double>::pi * delayMs) / sampleRate;
+            sweepFactor = 1.001f;
+        }
+
+        void process (PhaserPlugin& p, juce::AudioBuffer<float>& buffer, int start, int numSamples)
+        {
+            const double range = pow (2.0, (double) p.depth);
+            const double sweepUp = pow (range, p.rate / (sampleRate / 2));
+            const double sweepDown = 1.0 / sweepUp;
+
+            const float delayMs = 100.0f;
+            const float maxSweep = (float) ((juce::MathConstants<double>::pi * delayMs * range) / sampleRate);
+
+            double swpFactor = sweepFactor;
+            double swp = sweep;
+
+            for (int chan = std::min (2, buffer.getNumChannels()); --chan >= 0;)
+            {
+                float* b = buffer.getWritePointer (chan, start);
+                swp = sweep;
+                swpFactor = sweepFactor;
+
+                for (int i = numSamples; --i >= 0;)
+                {
+                    float inval = *b;
+                    const double coef = (1.0 - swp) / (1.0 + swp);
+                    double* const fv = filterVals[chan];
+
+                    double t = inval + p.feedbackGain * fv[7];
+                    JUCE_UNDENORMALISE (t);
+
+                    fv[1] = coef * (fv[1] + t) - fv[0];
+                    JUCE_UNDENORMALISE (fv[1]);
+                    fv[0] = t;
+
+                    fv[3] = coef * (fv[3] + fv[1]) - fv[2];
+                    JUCE_UNDENORMALISE (fv[3]);
+                    fv[2] = fv[1];
+
+                    fv[5] = coef * (fv[5] + fv[3]) - fv[4];
+                    JUCE_UNDENORMALISE (fv[5]);
+                    fv[4] = fv[3];
+
+                    fv[7] = coef * (fv[7] + fv[5]) - fv[6];
+                    JUCE_UNDENORMALISE (fv[7]);
+                    fv[6] = fv[5];
+
+                    inval += (float) fv[7];
+                    JUCE_UNDENORMALISE (inval);
+
+                    *b++ = inval;
+
+                    swp *= swpFactor;
+
+                    if (swp > maxSweep)       swpFactor = sweepDown;
+                    else if (swp < minSweep)  swpFactor = sweepUp;
+                }
+            }
+
+            sweep = swp;
+            sweepFactor = swpFactor;
+        }
+
+        double filterVals[2][8];
+        double sweep = 0.0, sweepFactor = 0.0, minSweep = 0.0;
+    };
+
+    //==============================================================================
+    template <typename PluginType>
+    inline juce::ReferenceCountedObjectPtr<PluginType> createPlugin (Edit& edit)
+    {
+        return dynamic_cast<PluginType*> (edit.getPluginCache().createNewPlugin (PluginType::xmlTypeName, {}).get());
+    }
+
+    inline void processBlock (Plugin& plugin, juce::AudioBuffer<float>& buffer, int start, int numSamples)
+    {
+        MidiMessageArray midi;
+        const auto time = TimePosition::fromSamples (start, sampleRate);
+
+        plugin.applyToBuffer ({ &buffer, juce::AudioChannelSet::canonicalChannelSet (buffer.getNumChannels()),
+                                start, numSamples, &midi, 0.0,
+                                { time, time + TimeDuration::fromSamples (numSamples, sampleRate) },
+                                true, false, true, false });
+    }
+
+    /** Noise with a slow swell, so the dynamics have something to follow. */
+    inline juce::AudioBuffer<float> createNoise (int numChannels, int numSamples)
+    {
+        juce::Random r (42);
+        juce::AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (c, i, (r.nextFloat() * 2.0f - 1.0f)
+                                          * (0.55f + 0.45f * std::sin ((float) i * 0.0007f)));
+
+        return buffer;
+    }
+
+    inline juce::AudioBuffer<float> createSine (int numChannels, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (c, i, 0.5f * std::sin (juce::MathConstants<float>::twoPi * 220.0f * (float) i / (float) sampleRate + (float) c));
+
+        return buffer;
+    }
+
+    inline void setUpCompressor (CompressorPlugin& p)
+    {
+        p.setThreshold (0.1f);
+        p.setRatio (0.25f);
+        p.attackMs->setParameter (5.0f, juce::sendNotification);
+        p.releaseMs->setParameter (80.0f, juce::sendNotification);
+        p.outputDb->setParameter (3.0f, juce::sendNotification);
+    }
+
+    inline void setUpEqualiser (EqualiserPlugin& p)
+    {
+        p.setLowGain (6.0f);
+        p.setMidGain1 (-9.0f);
+        p.setMidFreq1 (700.0f);
+        p.setMidQ1 (2.0f);
+        p.setMidGain2 (0.0f);
+        p.setHighGain (-4.0f);
+    }
+
+    inline void setUpLowPass (LowPassPlugin& p)
+    {
+        p.frequency->setParameter (1200.0f, juce::sendNotification);
+    }
+
+    inline void setUpChorus (ChorusPlugin& p)
+    {
+        p.depthMsParam->setParameter (5.0f, juce::sendNotification);
+        p.speedHzParam->setParameter (1.3f, juce::sendNotification);
+        p.widthPram->setParameter (0.7f, juce::sendNotification);
+        p.mixProportionParam->setParameter (0.4f, juce::sendNotification);
+    }
+
+    inline void setUpPhaser (PhaserPlugin& p)
+    {
+        p.depthParam->setParameter (6.0f, juce::sendNotification);
+        p.rateParam->setParameter (2.0f, juce::sendNotification);
+        p.feedbackGainParam->setParameter (0.5f, juce::sendNotification);
+    }
+}
+
+#if TRACKTION_UNIT_TESTS
+
+//==============================================================================
+//==============================================================================
+class EffectKernelTests  : public juce::UnitTest
+{
+public:
+    EffectKernelTests()
+        : juce::UnitTest ("Effect kernels", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        using namespace effect_kernel_test_utilities;
+
+        runBiquadTests();
+
+        runPluginTest<CompressorPlugin, ReferenceCompressor> ("Compressor", setUpCompressor, createNoise (2, 30000), 1.0e-5f);
+        runPluginTest<CompressorPlugin, ReferenceCompressor> ("Compressor mono", setUpCompressor, createNoise (1, 30000), 1.0e-5f);
+        runPluginTest<EqualiserPlugin, ReferenceEqualiser> ("Equaliser", setUpEqualiser, createNoise (2, 30000), 1.0e-5f);
+        runPluginTest<LowPassPlugin, ReferenceLowPass> ("LowPass", setUpLowPass, createNoise (2, 30000), 1.0e-5f);
+        runPluginTest<PhaserPlugin, ReferencePhaser> ("Phaser", setUpPhaser, createNoise (2, 30000), 1.0e-5f);
+
+        // The old version accumulated its LFO phase in floats, which slowly drifts from
+        // the phasor the kernels use, so this only matches closely on smooth input
+        runPluginTest<ChorusPlugin, ReferenceChorus> ("Chorus", setUpChorus, createSine (2, 30000), 5.0e-3f);
+    }
+
+private:
+    void runBiquadTests()
+    {
+        beginTest ("Biquad cascade");
+
+        auto input = effect_kernel_test_utilities::createNoise (2, 5000);
+        auto expected = input, actual = input;
+
+        const juce::IIRCoefficients coefficients[] = { juce::IIRCoefficients::makeLowShelf (44100.0, 200.0, 0.7, 2.0f),
+                                                       juce::IIRCoefficients::makePeakFilter (44100.0, 1000.0, 3.0, 0.3f),
+                                                       juce::IIRCoefficients::makeHighPass (44100.0, 50.0) };
+
+        effect_kernels::BiquadCascade cascade;
+        juce::IIRFilter filters[3][2];
+
+        for (int stage = 0; stage < 3; ++stage)
+        {
+            cascade.setCoefficients (stage, coefficients[stage]);
+
+            for (auto& f : filters[stage])
+                f.setCoefficients (coefficients[stage]);
+        }
+
+        for (int start = 0, blockSize = 1; start < input.getNumSamples(); start += blockSize, blockSize = blockSize * 3 % 701 + 1)
+        {
+            const auto num = std::min (blockSize, input.getNumSamples() - start);
+            cascade.process (actual, start, num);
+
+            for (int c = 0; c < 2; ++c)
+                for (auto& stage : filters)
+                    stage[c].processSamples (expected.getWritePointer (c, start), num);
+        }
+
+        expectBuffersMatch (actual, expected, 1.0e-5f, "cascade");
+    }
+
+    template <typename PluginType, typename ReferenceType, typename SetUpFunction>
+    void runPluginTest (const juce::String& name, SetUpFunction setUp, const juce::AudioBuffer<float>& input, float tolerance)
+    {
+        using namespace effect_kernel_test_utilities;
+        beginTest (name);
+
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+
+        for (int blockSize : { 1, 37, 512, 1031 })
+        {
+            auto plugin = createPlugin<PluginType> (*edit);
+            setUp (*plugin);
+            plugin->baseClassInitialise ({ TimePosition(), sampleRate, blockSize });
+
+            ReferenceType reference;
+            reference.prepare (*plugin);
+
+            auto expected = input, actual = input;
+
+            for (int start = 0; start < input.getNumSamples(); start += blockSize)
+            {
+                const auto num = std::min (blockSize, input.getNumSamples() - start);
+                processBlock (*plugin, actual, start, num);
+                reference.process (*plugin, expected, start, num);
+            }
+
+            expectBuffersMatch (actual, expected, tolerance, "block size " + juce::String (blockSize));
+            plugin->baseClassDeinitialise();
+        }
+    }
+
+    void expectBuffersMatch (const juce::AudioBuffer<float>& actual, const juce::AudioBuffer<float>& expected,
+                             float tolerance, const juce::String& failureMessage)
+    {
+        float maxError = 0.0f;
+
+        for (int c = 0; c < expected.getNumChannels(); ++c)
+            for (int i = 0; i < expected.getNumSamples(); ++i)
+                maxError = std::max (maxError, std::abs (actual.getSample (c, i) - expected.getSample (c, i)));
+
+        expectLessThan (maxError, tolerance, failureMessage);
+    }
+};
+
+static EffectKernelTests effectKernelTests;
+
+#endif // TRACKTION_UNIT_TESTS
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+class EffectKernelBenchmarks  : public juce::UnitTest
+{
+public:
+    EffectKernelBenchmarks()
+        : juce::UnitTest ("Effect kernels", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        using namespace effect_kernel_test_utilities;
+
+        runPlugin<CompressorPlugin, ReferenceCompressor> ("Compressor", setUpCompressor);
+        runPlugin<EqualiserPlugin, ReferenceEqualiser> ("Equaliser", setUpEqualiser);
+        runPlugin<LowPassPlugin, ReferenceLowPass> ("LowPass", setUpLowPass);
+        runPlugin<ChorusPlugin, ReferenceChorus> ("Chorus", setUpChorus);
+        runPlugin<PhaserPlugin, ReferencePhaser> ("Phaser", setUpPhaser);
+    }
+
+private:
+    template <typename PluginType, typename ReferenceType, typename SetUpFunction>
+    void runPlugin (const std::string& pluginName, SetUpFunction setUp)
+    {
+        using namespace effect_kernel_test_utilities;
+        constexpr int blockSize = 512;
+
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+
+        auto plugin = createPlugin<PluginType> (*edit);
+        setUp (*plugin);
+        plugin->baseClassInitialise ({ TimePosition(), sampleRate, blockSize });
+
+        ReferenceType reference;
+        reference.prepare (*plugin);
+
+        // Ten seconds of stereo, with fresh input for each block
+        const int numBlocks = juce::roundToInt (10.0 * sampleRate / blockSize);
+        const auto input = createNoise (2, blockSize);
+        juce::AudioBuffer<float> buffer (2, blockSize);
+
+        for (bool useKernels : { false, true })
+        {
+            const auto name = pluginName + (useKernels ? ", kernels" : ", reference");
+            beginTest (name);
+
+            {
+                ScopedBenchmark sb (createBenchmarkDescription (*this, name));
+
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    buffer.makeCopyOf (input, true);
+
+                    if (useKernels)
+                        processBlock (*plugin, buffer, 0, blockSize);
+                    else
+                        reference.process (*plugin, buffer, 0, blockSize);
+                }
+            }
+
+            // The last block should still be a sensible level, which also catches NaNs
+            for (int c = 0; c < buffer.getNumChannels(); ++c)
+            {
+                const auto magnitude = buffer.getMagnitude (c, 0, blockSize);
+                expect (magnitude > 0.0f && magnitude < 4.0f, juce::String (name) + " output level: " + juce::String (magnitude));
+            }
+        }
+
+        plugin->baseClassDeinitialise();
+    }
+};
+
+static EffectKernelBenchmarks effectKernelBenchmarks;
+
+#endif // TRACKTION_BENCHMARKS
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
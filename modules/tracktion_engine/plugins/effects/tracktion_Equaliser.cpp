@@ -211,8 +211,10 @@ void EqualiserPlugin::updateIIRFilters()
         auto c = juce::IIRCoefficients::makeLowShelf (lastSampleRate, loFreq->getCurrentValue(), loQ->getCurrentValue(),
                                                       convertEQLevelToGain (loGain->getCurrentValue()));
 
-        for (int i = EQ_CHANS; --i >= 0;)
-            low[i].setCoefficients (c);
+        // BEATCONNECT MODIFICATION START
+        bandCoefficients[0] = c;
+        filters.setCoefficients (0, c);
+        // BEATCONNECT MODIFICATION END
     }
 
     if (needToUpdateFilters[1])
@@ -222,8 +224,10 @@ void EqualiserPlugin::updateIIRFilters()
         auto c = juce::IIRCoefficients::makePeakFilter (lastSampleRate, midFreq1->getCurrentValue(), midQ1->getCurrentValue(),
                                                         convertEQLevelToGain (midGain1->getCurrentValue()));
 
-        for (int i = EQ_CHANS; --i >= 0;)
-            mid1[i].setCoefficients (c);
+        // BEATCONNECT MODIFICATION START
+        bandCoefficients[1] = c;
+        filters.setCoefficients (1, c);
+        // BEATCONNECT MODIFICATION END
     }
 
     if (needToUpdateFilters[2])
@@ -233,8 +237,10 @@ void EqualiserPlugin::updateIIRFilters()
         auto c = juce::IIRCoefficients::makePeakFilter (lastSampleRate, midFreq2->getCurrentValue(), midQ2->getCurrentValue(),
                                                         convertEQLevelToGain (midGain2->getCurrentValue()));
 
-        for (int i = EQ_CHANS; --i >= 0;)
-            mid2[i].setCoefficients (c);
+        // BEATCONNECT MODIFICATION START
+        bandCoefficients[2] = c;
+        filters.setCoefficients (2, c);
+        // BEATCONNECT MODIFICATION END
     }
 
     if (needToUpdateFilters[3])
@@ -244,20 +250,18 @@ void EqualiserPlugin::updateIIRFilters()
         auto c = juce::IIRCoefficients::makeHighShelf (lastSampleRate, hiFreq->getCurrentValue(), hiQ->getCurrentValue(),
                                                        convertEQLevelToGain (hiGain->getCurrentValue()));
 
-        for (int i = EQ_CHANS; --i >= 0;)
-            high[i].setCoefficients (c);
+        // BEATCONNECT MODIFICATION START
+        bandCoefficients[3] = c;
+        filters.setCoefficients (3, c);
+        // BEATCONNECT MODIFICATION END
     }
 }
 
 void EqualiserPlugin::initialise (const PluginInitialisationInfo&)
 {
-    for (int i = EQ_CHANS; --i >= 0;)
-    {
-        low[i].reset();
-        mid1[i].reset();
-        mid2[i].reset();
-        high[i].reset();
-    }
+    // BEATCONNECT MODIFICATION START
+    filters.reset();
+    // BEATCONNECT MODIFICATION END
 
     if (lastSampleRate != sampleRate)
         curveNeedsUpdating = true;
@@ -290,15 +294,15 @@ void EqualiserPlugin::applyToBuffer (const PluginRenderContext& fc)
 
         addAntiDenormalisationNoise (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
 
-        for (int i = std::min ((int) EQ_CHANS, fc.destBuffer->getNumChannels()); --i >= 0;)
-        {
-            auto data = fc.destBuffer->getWritePointer (i, fc.bufferStartSample);
+        // BEATCONNECT MODIFICATION START
+        // Bands with no gain are skipped, and both channels go through the rest in one pass
+        filters.setStageEnabled (0, loGain->getCurrentValue() != 0);
+        filters.setStageEnabled (1, midGain1->getCurrentValue() != 0);
+        filters.setStageEnabled (2, midGain2->getCurrentValue() != 0);
+        filters.setStageEnabled (3, hiGain->getCurrentValue() != 0);
 
-            if (loGain->getCurrentValue() != 0)       low[i] .processSamples (data, fc.bufferNumSamples);
-            if (midGain1->getCurrentValue() != 0)     mid1[i].processSamples (data, fc.bufferNumSamples);
-             if (midGain2->getCurrentValue() != 0)     mid2[i].processSamples (data, fc.bufferNumSamples);
-            if (hiGain->getCurrentValue() != 0)       high[i].processSamples (data, fc.bufferNumSamples);
-        }
+        filters.process (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+        // BEATCONNECT MODIFICATION END
 
         if (phaseInvert)
             fc.destBuffer->applyGain (fc.bufferStartSample, fc.bufferNumSamples, -1.0f);
@@ -322,10 +326,20 @@ float EqualiserPlugin::getDBGainAtFrequency (float f)
         float samps[sampSize * 2 + 8] = {};
         samps[0] = 1.0f;
 
-        if (loGain->getCurrentValue() != 0)     juce::IIRFilter (low[0]) .processSamples (samps, sampSize);
-        if (midGain1->getCurrentValue() != 0)   juce::IIRFilter (mid1[0]).processSamples (samps, sampSize);
-        if (midGain2->getCurrentValue() != 0)   juce::IIRFilter (mid2[0]).processSamples (samps, sampSize);
-        if (hiGain->getCurrentValue() != 0)     juce::IIRFilter (high[0]).processSamples (samps, sampSize);
+        // BEATCONNECT MODIFICATION START
+        const float bandGains[] = { loGain->getCurrentValue(), midGain1->getCurrentValue(),
+                                    midGain2->getCurrentValue(), hiGain->getCurrentValue() };
+
+        for (int band = 0; band < 4; ++band)
+        {
+            if (bandGains[band] != 0)
+            {
+                juce::IIRFilter filter;
+                filter.setCoefficients (bandCoefficients[band]);
+                filter.processSamples (samps, sampSize);
+            }
+        }
+        // BEATCONNECT MODIFICATION END
 
         fft.performRealOnlyForwardTransform (samps);
 
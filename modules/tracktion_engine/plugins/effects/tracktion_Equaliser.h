@@ -88,7 +88,10 @@ private:
     bool curveNeedsUpdating = true;
 
     enum { EQ_CHANS = 2 };
-    juce::IIRFilter low[EQ_CHANS], mid1[EQ_CHANS], mid2[EQ_CHANS], high[EQ_CHANS];
+    // BEATCONNECT MODIFICATION START
+    effect_kernels::BiquadCascade filters;
+    juce::IIRCoefficients bandCoefficients[4];
+    // BEATCONNECT MODIFICATION END
 
     enum { fftOrder = 10 };
     juce::dsp::FFT fft { fftOrder };
@@ -278,6 +278,20 @@ private:
     float phase = 0, speedHz = 1.0f, depthMs = 3.0f, width = 0.5f, mix = 0;
 };
 
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+/** An IIRFilter whose state can be read and written so that the filters of
+    several voices can be run together by FOVoiceBatch.
+*/
+struct FOFilter  : public juce::IIRFilter
+{
+    using juce::IIRFilter::coefficients;
+    using juce::IIRFilter::v1;
+    using juce::IIRFilter::v2;
+    using juce::IIRFilter::active;
+};
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 class FourOscVoice : public juce::MPESynthesiserVoice
 {
@@ -399,18 +413,11 @@ public:
         return v * std::pow (25.0f, v) * 0.04f;
     }
 
+    // BEATCONNECT MODIFICATION START
     using MPESynthesiserVoice::renderNextBlock;
     void renderNextBlock (juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override
     {
-        juce::ScopedValueSetter<bool> svs (snapAllValues, firstBlock || snapAllValues);
-
-        updateParams (numSamples);
-
-        if (firstBlock)
-        {
-            filterFrequencySmoother.snapToValue();
-            firstBlock = false;
-        }
+        const float velocityGain = beginBlock (numSamples);
 
         if (numSamples > renderBuffer.getNumSamples())
             renderBuffer.setSize (2, numSamples, false, false, true);
@@ -422,8 +429,6 @@ public:
             o.process (renderBuffer, 0, numSamples);
 
         // Apply velocity
-        float velocityGain = velocityToGain (currentlyPlayingNote.noteOnVelocity.asUnsignedFloat(), paramValue (synth.ampVelocity) / 100.0f);
-        velocityGain = juce::jlimit (0.0f, 1.0f, velocityGain);
         renderBuffer.applyGain (velocityGain);
 
         // Apply filter
@@ -457,6 +462,34 @@ public:
             outputBuffer.addFrom (1, startSample, renderBuffer, 1, 0, numSamples);
         }
 
+        endBlock (numSamples);
+    }
+
+    /** Updates the parameters for the next block and returns the velocity gain to
+        apply to it. This must be followed by a call to endBlock() once the block has
+        been rendered.
+    */
+    float beginBlock (int numSamples)
+    {
+        juce::ScopedValueSetter<bool> svs (snapAllValues, firstBlock || snapAllValues);
+
+        updateParams (numSamples);
+
+        if (firstBlock)
+        {
+            filterFrequencySmoother.snapToValue();
+            firstBlock = false;
+        }
+
+        float velocityGain = velocityToGain (currentlyPlayingNote.noteOnVelocity.asUnsignedFloat(), paramValue (synth.ampVelocity) / 100.0f);
+        return juce::jlimit (0.0f, 1.0f, velocityGain);
+    }
+
+    /** Ends or retriggers the note once its envelope has finished and moves the
+        smoothers on past the block.
+    */
+    void endBlock (int numSamples)
+    {
         if (! ampAdsr.isActive())
         {
             isPlaying = false;
@@ -475,21 +508,7 @@ public:
         for (auto& itr : smoothers)
             itr.second.process (numSamples);
     }
-
-    void applyEnvelopeToBuffer (juce::ADSR& adsr, juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
-    {
-        float* l = buffer.getWritePointer (0, startSample);
-        float* r = buffer.getWritePointer (1, startSample);
-
-        while (--numSamples >= 0)
-        {
-            float db = adsr.getNextSample() * 100.0f - 100.0f;
-            float gain = juce::Decibels::decibelsToGain (db);
-
-            *l++ *= gain;
-            *r++ *= gain;
-        }
-    }
+    // BEATCONNECT MODIFICATION END
 
     void getLiveModulationPositions (AutomatableParameter::Ptr param, juce::Array<float>& positions)
     {
@@ -691,6 +710,10 @@ public:
     void noteKeyStateChanged() override     {}
 
 private:
+    // BEATCONNECT MODIFICATION START
+    friend class FOVoiceBatch;
+    // BEATCONNECT MODIFICATION END
+
     float paramValue (AutomatableParameter::Ptr param)
     {
         jassert (param != nullptr);
@@ -743,7 +766,9 @@ private:
     ExpEnvelope ampAdsr;
     LinEnvelope filterAdsr, modAdsr1, modAdsr2;
     SimpleLFO lfo1, lfo2;
-    juce::IIRFilter filterL1, filterR1, filterL2, filterR2;
+    // BEATCONNECT MODIFICATION START
+    FOFilter filterL1, filterR1, filterL2, filterR2;
+    // BEATCONNECT MODIFICATION END
 
     ValueSmoother<float> filterFrequencySmoother;
 
@@ -756,6 +781,184 @@ private:
     std::map<AutomatableParameter*, ValueSmoother<float>> smoothers;
 };
 
+// BEATCONNECT MODIFICATION START
+#if JUCE_USE_SIMD
+//==============================================================================
+/** Renders a group of voices together with each voice in its own SIMD lane, so the
+    oscillators, velocity, filters and envelope are applied to the whole group at
+    once. This produces the same output as rendering the voices one at a time.
+*/
+class FOVoiceBatch
+{
+public:
+    using Vec = MultiVoiceOscillator::Lanes;
+    static constexpr int numLanes = (int) Vec::SIMDNumElements;
+    static constexpr int maxBlockSize = 32;
+
+    void render (FourOscVoice* const* voices, int numVoices,
+                 juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+    {
+        jassert (numVoices > 0 && numVoices <= numLanes);
+        jassert (numSamples <= maxBlockSize);
+
+        auto& synth = voices[0]->synth;
+        alignas (Vec::SIMDRegisterSize) float laneValues[numLanes] = {};
+
+        for (int v = 0; v < numVoices; ++v)
+            laneValues[v] = voices[v]->beginBlock (numSamples);
+
+        const auto velocityGain = Vec::fromRawArray (laneValues);
+
+        std::fill (left, left + numSamples, Vec::expand (0.0f));
+        std::fill (right, right + numSamples, Vec::expand (0.0f));
+
+        // Run oscillators
+        for (int o = 0; o < (int) juce::numElementsInArray (voices[0]->oscillators); ++o)
+        {
+            MultiVoiceOscillator* oscillators[numLanes] = {};
+
+            for (int v = 0; v < numVoices; ++v)
+                oscillators[v] = &voices[v]->oscillators[o];
+
+            MultiVoiceOscillator::processLanes (oscillators, numVoices, left, right, numSamples);
+        }
+
+        // Apply velocity
+        for (int i = 0; i < numSamples; ++i)
+        {
+            left[i] *= velocityGain;
+            right[i] *= velocityGain;
+        }
+
+        // Apply filter
+        if (synth.filterTypeValue != 0)
+        {
+            processFilters (voices, numVoices, &FourOscVoice::filterL1, left, numSamples);
+            processFilters (voices, numVoices, &FourOscVoice::filterR1, right, numSamples);
+
+            if (synth.filterSlopeValue == 24)
+            {
+                clip (left, numSamples);
+                clip (right, numSamples);
+
+                processFilters (voices, numVoices, &FourOscVoice::filterL2, left, numSamples);
+                processFilters (voices, numVoices, &FourOscVoice::filterR2, right, numSamples);
+            }
+        }
+
+        // Apply ADSR, the envelope's stages are different for each voice so its
+        // values are generated per lane
+        std::fill (envelope, envelope + numSamples * numLanes, 0.0f);
+
+        for (int v = 0; v < numVoices; ++v)
+            for (int i = 0; i < numSamples; ++i)
+                envelope[i * numLanes + v] = voices[v]->ampAdsr.getNextSample();
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto env = Vec::fromRawArray (envelope + i * numLanes);
+            left[i] *= env;
+            right[i] *= env;
+        }
+
+        // Add to output, one voice after another in the same order as rendering them separately
+        const bool isMono = outputBuffer.getNumChannels() == 1;
+        auto* destL = outputBuffer.getWritePointer (0, startSample);
+        auto* destR = isMono ? destL : outputBuffer.getWritePointer (1, startSample);
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            if (isMono)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                    destL[i] += left[i].get ((size_t) v) * 0.5f;
+
+                for (int i = 0; i < numSamples; ++i)
+                    destL[i] += right[i].get ((size_t) v) * 0.5f;
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    destL[i] += left[i].get ((size_t) v);
+                    destR[i] += right[i].get ((size_t) v);
+                }
+            }
+        }
+
+        for (int v = 0; v < numVoices; ++v)
+            voices[v]->endBlock (numSamples);
+    }
+
+private:
+    Vec left[maxBlockSize], right[maxBlockSize];
+    alignas (Vec::SIMDRegisterSize) float envelope[maxBlockSize * numLanes];
+
+    static void clip (Vec* data, int numSamples)
+    {
+        const auto minValue = Vec::expand (-1.0f), maxValue = Vec::expand (1.0f);
+
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = Vec::max (minValue, Vec::min (maxValue, data[i]));
+    }
+
+    /** Runs one of the voices' filters with the same maths as juce::IIRFilter.
+        Lanes with an inactive filter are passed through unchanged.
+    */
+    static void processFilters (FourOscVoice* const* voices, int numVoices,
+                                FOFilter FourOscVoice::* filter, Vec* data, int numSamples)
+    {
+        alignas (Vec::SIMDRegisterSize) float c[5][numLanes] = {}, state1[numLanes] = {}, state2[numLanes] = {};
+
+        for (int v = 0; v < numLanes; ++v)
+            c[0][v] = 1.0f;
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            auto& f = voices[v]->*filter;
+
+            if (f.active)
+            {
+                for (int k = 0; k < 5; ++k)
+                    c[k][v] = f.coefficients.coefficients[k];
+
+                state1[v] = f.v1;
+                state2[v] = f.v2;
+            }
+        }
+
+        const auto c0 = Vec::fromRawArray (c[0]), c1 = Vec::fromRawArray (c[1]), c2 = Vec::fromRawArray (c[2]),
+                   c3 = Vec::fromRawArray (c[3]), c4 = Vec::fromRawArray (c[4]);
+        auto lv1 = Vec::fromRawArray (state1), lv2 = Vec::fromRawArray (state2);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto in = data[i];
+            const auto out = c0 * in + lv1;
+            data[i] = out;
+
+            lv1 = c1 * in - c3 * out + lv2;
+            lv2 = c2 * in - c4 * out;
+        }
+
+        lv1.copyToRawArray (state1);
+        lv2.copyToRawArray (state2);
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            auto& f = voices[v]->*filter;
+
+            if (f.active)
+            {
+                JUCE_SNAP_TO_ZERO (state1[v]);  f.v1 = state1[v];
+                JUCE_SNAP_TO_ZERO (state2[v]);  f.v2 = state2[v];
+            }
+        }
+    }
+};
+#endif
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 FourOscPlugin::OscParams::OscParams (FourOscPlugin& plugin, int oscNum)
 {
@@ -898,6 +1101,10 @@ FourOscPlugin::FourOscPlugin (PluginCreationInfo info)  : Plugin (info)
 
     levelMeasurer.addClient (*this);
 
+    // BEATCONNECT MODIFICATION START
+    levelMeasurer.setFreezeRequests (&engine.getDeviceManager().getOverloadPolicy().getMeterFreezeRequests());
+    // BEATCONNECT MODIFICATION END
+
     instrument.enableLegacyMode();
     setPitchbendTrackingMode (juce::MPEInstrument::allNotesOnChannel);
 
@@ -906,6 +1113,12 @@ FourOscPlugin::FourOscPlugin (PluginCreationInfo info)  : Plugin (info)
     delay  = std::make_unique<FODelay>();
     chorus = std::make_unique<FOChorus>();
 
+    // BEATCONNECT MODIFICATION START
+   #if JUCE_USE_SIMD
+    voiceBatch = std::make_unique<FOVoiceBatch>();
+   #endif
+    // BEATCONNECT MODIFICATION END
+
     for (int i = 0; i < 4; i++) oscParams.add (new OscParams (*this, i + 1));
     for (int i = 0; i < 2; i++) lfoParams.add (new LFOParams (*this, i + 1));
     for (int i = 0; i < 2; i++) modEnvParams.add (new MODEnvParams (*this, i + 1));
@@ -1551,6 +1764,44 @@ void FourOscPlugin::applyToBuffer (juce::AudioBuffer<float>& buffer, juce::MidiB
         itr.second.process (buffer.getNumSamples());
 }
 
+// BEATCONNECT MODIFICATION START
+void FourOscPlugin::renderNextSubBlock (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+   #if JUCE_USE_SIMD
+    if (voiceBatchingEnabled && numSamples <= FOVoiceBatch::maxBlockSize)
+    {
+        const juce::ScopedLock sl (voicesLock);
+
+        FourOscVoice* batch[FOVoiceBatch::numLanes] = {};
+        int numInBatch = 0;
+
+        for (auto v : voices)
+        {
+            if (! v->isActive())
+                continue;
+
+            batch[numInBatch++] = static_cast<FourOscVoice*> (v);
+
+            if (numInBatch == FOVoiceBatch::numLanes)
+            {
+                voiceBatch->render (batch, numInBatch, buffer, startSample, numSamples);
+                numInBatch = 0;
+            }
+        }
+
+        if (numInBatch == 1)
+            batch[0]->renderNextBlock (buffer, startSample, numSamples);
+        else if (numInBatch > 1)
+            voiceBatch->render (batch, numInBatch, buffer, startSample, numSamples);
+
+        return;
+    }
+   #endif
+
+    juce::MPESynthesiser::renderNextSubBlock (buffer, startSample, numSamples);
+}
+// BEATCONNECT MODIFICATION END
+
 void FourOscPlugin::applyEffects (juce::AudioBuffer<float>& buffer)
 {
     int numSamples = buffer.getNumSamples();
@@ -12,6 +12,9 @@ namespace tracktion { inline namespace engine
 
 class FODelay;
 class FOChorus;
+// BEATCONNECT MODIFICATION START
+class FOVoiceBatch;
+// BEATCONNECT MODIFICATION END
 
 //==============================================================================
 /** Smooths a value between 0 and 1 at a constant rate */
@@ -207,6 +210,14 @@ public:
 
     float getCurrentTempo()                             { return currentTempo; }
 
+    // BEATCONNECT MODIFICATION START
+    /** Enables rendering groups of voices together using SIMD, which is the default
+        where it's available. The output is the same either way; this is mainly for
+        comparing the two in tests and benchmarks.
+    */
+    void setVoiceBatchingEnabled (bool b)               { voiceBatchingEnabled = b; }
+    // BEATCONNECT MODIFICATION END
+
 private:
     std::unordered_map<juce::String, juce::String> labels;
 
@@ -393,6 +404,10 @@ private:
     AutomatableParameter* addParam (const juce::String& paramID, const juce::String& name, juce::NormalisableRange<float> valueRange, juce::String label = {});
 
     void applyToBuffer (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi);
+    // BEATCONNECT MODIFICATION START
+    using juce::MPESynthesiser::renderNextSubBlock;
+    void renderNextSubBlock (juce::AudioBuffer<float>&, int startSample, int numSamples) override;
+    // BEATCONNECT MODIFICATION END
     void updateParams (juce::AudioBuffer<float>& buffer);
     void applyEffects (juce::AudioBuffer<float>& buffer);
     float paramValue (AutomatableParameter::Ptr param);
@@ -401,6 +416,12 @@ private:
     juce::Reverb reverb;
     std::unique_ptr<FODelay> delay;
     std::unique_ptr<FOChorus> chorus;
+    // BEATCONNECT MODIFICATION START
+   #if JUCE_USE_SIMD
+    std::unique_ptr<FOVoiceBatch> voiceBatch;
+   #endif
+    std::atomic<bool> voiceBatchingEnabled { true };
+    // BEATCONNECT MODIFICATION END
     std::unordered_map<AutomatableParameter*, ValueSmoother<float>> smoothers;
 
     bool flushingState = false;
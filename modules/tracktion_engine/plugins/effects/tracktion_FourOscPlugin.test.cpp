@@ -0,0 +1,286 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if (TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS) && JUCE_USE_SIMD
+
+namespace tracktion { inline namespace engine
+{
+
+namespace four_osc_test_utilities
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr int blockSize = 512;
+
+    inline juce::ReferenceCountedObjectPtr<FourOscPlugin> createSynth (Edit& edit, const char* patch, bool useVoiceBatching)
+    {
+        juce::ReferenceCountedObjectPtr<FourOscPlugin> synth (dynamic_cast<FourOscPlugin*> (edit.getPluginCache().createNewPlugin (FourOscPlugin::xmlTypeName, {}).get()));
+
+        if (auto e = juce::parseXML (patch))
+            if (auto v = juce::ValueTree::fromXml (*e); v.isValid())
+                synth->restorePluginStateFromValueTree (v);
+
+        synth->setVoiceBatchingEnabled (useVoiceBatching);
+        synth->baseClassInitialise ({ TimePosition(), sampleRate, blockSize });
+
+        return synth;
+    }
+
+    /** Holds the notes for the first block and releases them after numBlocksHeld. */
+    inline juce::AudioBuffer<float> renderNotes (FourOscPlugin& synth, const juce::Array<int>& notes,
+                                                 int numBlocks, int numBlocksHeld)
+    {
+        juce::AudioBuffer<float> output (2, numBlocks * blockSize), buffer (2, blockSize);
+        MidiMessageArray midi;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            midi.clear();
+
+            for (int i = 0; i < notes.size(); ++i)
+            {
+                if (block == 0)
+                    midi.addMidiMessage (juce::MidiMessage::noteOn (1, notes[i], (juce::uint8) (127 - i * 5)), 0.0, MidiMessageArray::notMPE);
+                else if (block == numBlocksHeld)
+                    midi.addMidiMessage (juce::MidiMessage::noteOff (1, notes[i]), 0.0, MidiMessageArray::notMPE);
+            }
+
+            buffer.clear();
+
+            const auto start = TimePosition::fromSamples (block * blockSize, sampleRate);
+            synth.applyToBuffer ({ &buffer, juce::AudioChannelSet::stereo(), 0, blockSize, &midi, 0.0,
+                                   { start, start + TimeDuration::fromSamples (blockSize, sampleRate) },
+                                   true, false, true, false });
+
+            for (int c = 0; c < 2; ++c)
+                output.copyFrom (c, block * blockSize, buffer, c, 0, blockSize);
+        }
+
+        return output;
+    }
+}
+
+#if TRACKTION_UNIT_TESTS
+
+//==============================================================================
+//==============================================================================
+class FourOscVoiceBatchTests  : public juce::UnitTest
+{
+public:
+    FourOscVoiceBatchTests()
+        : juce::UnitTest ("FourOsc voice batching", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runOscillatorTests();
+        runPluginTests();
+    }
+
+private:
+    using Lanes = MultiVoiceOscillator::Lanes;
+    static constexpr int numLanes = (int) Lanes::SIMDNumElements;
+
+    static void setUpOscillator (MultiVoiceOscillator& o, Oscillator::Waves wave, int numVoices, int index)
+    {
+        o.setSampleRate (four_osc_test_utilities::sampleRate);
+        o.setWave (wave);
+        o.setNumVoices (numVoices);
+        o.setNote (30.0f + (float) index * 17.3f);
+        o.setGain (0.7f);
+        o.setPan (0.2f * (float) index - 0.3f);
+        o.setDetune (0.3f);
+        o.setSpread (0.5f);
+        o.setPulseWidth (0.3f + 0.1f * (float) index);
+    }
+
+    void runOscillatorTests()
+    {
+        beginTest ("Oscillator lanes");
+
+        for (auto wave : { Oscillator::none, Oscillator::sine, Oscillator::square,
+                           Oscillator::saw, Oscillator::triangle, Oscillator::noise })
+        {
+            for (int numVoices : { 1, 3 })
+            {
+                for (int numOscillators : { 1, numLanes })
+                {
+                    // Each lane should match a separate oscillator with the same settings
+                    std::vector<std::unique_ptr<MultiVoiceOscillator>> separate, batched;
+                    std::vector<MultiVoiceOscillator*> batchedPointers;
+
+                    for (int i = 0; i < numOscillators; ++i)
+                    {
+                        separate.push_back (std::make_unique<MultiVoiceOscillator>());
+                        batched.push_back (std::make_unique<MultiVoiceOscillator>());
+                        batchedPointers.push_back (batched.back().get());
+
+                        setUpOscillator (*separate.back(), wave, numVoices, i);
+                        setUpOscillator (*batched.back(), wave, numVoices, i);
+                    }
+
+                    std::vector<Lanes> left (32), right (32);
+                    juce::AudioBuffer<float> buffer (2, 32);
+                    float maxError = 0.0f;
+                    int numNonZeroUnusedLanes = 0;
+
+                    for (int numSamples : { 32, 7, 32, 19 })
+                    {
+                        std::fill (left.begin(), left.end(), Lanes::expand (0.0f));
+                        std::fill (right.begin(), right.end(), Lanes::expand (0.0f));
+                        MultiVoiceOscillator::processLanes (batchedPointers.data(), numOscillators,
+                                                            left.data(), right.data(), numSamples);
+
+                        for (int lane = 0; lane < numLanes; ++lane)
+                        {
+                            if (lane >= numOscillators)
+                            {
+                                for (int i = 0; i < numSamples; ++i)
+                                    if (left[(size_t) i].get ((size_t) lane) != 0.0f || right[(size_t) i].get ((size_t) lane) != 0.0f)
+                                        ++numNonZeroUnusedLanes;
+
+                                continue;
+                            }
+
+                            buffer.clear();
+                            separate[(size_t) lane]->process (buffer, 0, numSamples);
+
+                            for (int i = 0; i < numSamples; ++i)
+                            {
+                                maxError = std::max (maxError, std::abs (buffer.getSample (0, i) - left[(size_t) i].get ((size_t) lane)));
+                                maxError = std::max (maxError, std::abs (buffer.getSample (1, i) - right[(size_t) i].get ((size_t) lane)));
+                            }
+                        }
+                    }
+
+                    expectLessThan (maxError, 1.0e-6f, "Wave " + juce::String ((int) wave) + ", "
+                                                        + juce::String (numVoices) + " voices, "
+                                                        + juce::String (numOscillators) + " oscillators");
+                    expectEquals (numNonZeroUnusedLanes, 0);
+                }
+            }
+        }
+    }
+
+    void runPluginTests()
+    {
+        beginTest ("Batched voices");
+
+        using namespace four_osc_test_utilities;
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+
+        // Sines at different pitches, so the level of the mix doesn't depend on the
+        // random phases the voices start at, through a 24dB filter
+        static auto patch = "<PLUGIN type=\"4osc\" filterType=\"1\" filterSlope=\"24\" filterFreq=\"100.0\" ampAttack=\"0.01\" ampRelease=\"0.05\"> <MODMATRIX/> </PLUGIN>";
+
+        juce::Array<int> notes;
+
+        for (int i = 0; i < 12; ++i)
+            notes.add (48 + i * 2);
+
+        auto scalarSynth = createSynth (*edit, patch, false);
+        auto batchedSynth = createSynth (*edit, patch, true);
+
+        const int numBlocks = 86, numBlocksHeld = 60;
+        auto scalar = renderNotes (*scalarSynth, notes, numBlocks, numBlocksHeld);
+        auto batched = renderNotes (*batchedSynth, notes, numBlocks, numBlocksHeld);
+
+        for (int c = 0; c < 2; ++c)
+        {
+            const auto scalarRMS = scalar.getRMSLevel (c, 0, numBlocksHeld * blockSize);
+            const auto batchedRMS = batched.getRMSLevel (c, 0, numBlocksHeld * blockSize);
+
+            expectGreaterThan (scalarRMS, 0.01f);
+            expectWithinAbsoluteError (batchedRMS, scalarRMS, scalarRMS * 0.03f);
+        }
+
+        // All the voices should have finished once the release has
+        const auto tailStart = (numBlocks - 4) * blockSize;
+        expectEquals (batched.getMagnitude (tailStart, 4 * blockSize), 0.0f);
+        expectEquals (scalar.getMagnitude (tailStart, 4 * blockSize), 0.0f);
+
+        for (auto synth : { scalarSynth, batchedSynth })
+            synth->baseClassDeinitialise();
+    }
+};
+
+static FourOscVoiceBatchTests fourOscVoiceBatchTests;
+
+#endif // TRACKTION_UNIT_TESTS
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+class FourOscVoiceBatchBenchmarks  : public juce::UnitTest
+{
+public:
+    FourOscVoiceBatchBenchmarks()
+        : juce::UnitTest ("FourOsc voice batching", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        for (int numVoices : { 1, 4, 8, 16, 32 })
+            for (bool useVoiceBatching : { false, true })
+                runVoices (numVoices, useVoiceBatching);
+    }
+
+private:
+    void runVoices (int numVoices, bool useVoiceBatching)
+    {
+        using namespace four_osc_test_utilities;
+
+        const auto name = std::to_string (numVoices) + " voices, " + (useVoiceBatching ? "batched" : "scalar");
+        beginTest (name);
+
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+
+        // Two detuned saws and a square through a resonant 24dB filter
+        static auto patch = "<PLUGIN type=\"4osc\" filterType=\"1\" filterSlope=\"24\" filterFreq=\"90.0\" filterResonance=\"30.0\" "
+                            "ampAttack=\"0.01\" ampSustain=\"100.0\" "
+                            "waveShape1=\"3\" voices1=\"3\" detune1=\"0.2\" spread1=\"50.0\" "
+                            "waveShape2=\"3\" voices2=\"3\" detune2=\"0.3\" tune2=\"-12.0\" "
+                            "waveShape3=\"2\" tune3=\"7.0\"> <MODMATRIX/> </PLUGIN>";
+
+        auto synth = createSynth (*edit, patch, useVoiceBatching);
+
+        juce::Array<int> notes;
+
+        for (int i = 0; i < numVoices; ++i)
+            notes.add (36 + i * 2);
+
+        // Ten seconds of sustained notes
+        const int numBlocks = juce::roundToInt (10.0 * sampleRate / blockSize);
+
+        juce::AudioBuffer<float> output;
+
+        {
+            ScopedBenchmark sb (createBenchmarkDescription (*this, name));
+            output = renderNotes (*synth, notes, numBlocks, numBlocks);
+        }
+
+        synth->baseClassDeinitialise();
+
+        // The notes are held throughout, so the synth should still be sounding at the end
+        expectGreaterThan (output.getMagnitude (0, output.getNumSamples() - blockSize, blockSize), 0.01f);
+    }
+};
+
+static FourOscVoiceBatchBenchmarks fourOscVoiceBatchBenchmarks;
+
+#endif // TRACKTION_BENCHMARKS
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // (TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS) && JUCE_USE_SIMD
@@ -0,0 +1,982 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace ir_convolution
+{
+    //==============================================================================
+    // These prepare the IR in the same way as juce::dsp::Convolution so it sounds the same
+    static juce::AudioBuffer<float> trimSilence (const juce::AudioBuffer<float>& buffer)
+    {
+        const auto threshold = juce::Decibels::decibelsToGain (-80.0f);
+        const auto numSamples = buffer.getNumSamples();
+        int numToSkipAtStart = numSamples, numToSkipAtEnd = numSamples;
+
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+        {
+            auto data = buffer.getReadPointer (c);
+            auto isAboveThreshold = [threshold] (float s) { return std::abs (s) >= threshold; };
+
+            numToSkipAtStart = std::min (numToSkipAtStart, (int) std::distance (data, std::find_if (data, data + numSamples, isAboveThreshold)));
+            numToSkipAtEnd = std::min (numToSkipAtEnd, (int) std::distance (std::make_reverse_iterator (data + numSamples),
+                                                                            std::find_if (std::make_reverse_iterator (data + numSamples),
+                                                                                          std::make_reverse_iterator (data),
+                                                                                          isAboveThreshold)));
+        }
+
+        if (numToSkipAtStart == numSamples)
+            return {};
+
+        juce::AudioBuffer<float> result (buffer.getNumChannels(), std::max (1, numSamples - numToSkipAtStart - numToSkipAtEnd));
+
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+            result.copyFrom (c, 0, buffer, c, numToSkipAtStart, result.getNumSamples());
+
+        return result;
+    }
+
+    static juce::AudioBuffer<float> resample (const juce::AudioBuffer<float>& buffer, double sourceSampleRate, double destSampleRate)
+    {
+        if (sourceSampleRate == destSampleRate)
+            return buffer;
+
+        const auto ratio = sourceSampleRate / destSampleRate;
+        auto source = buffer;
+        juce::MemoryAudioSource memorySource (source, false);
+        juce::ResamplingAudioSource resamplingSource (&memorySource, false, buffer.getNumChannels());
+
+        juce::AudioBuffer<float> result (buffer.getNumChannels(), juce::roundToInt (std::max (1.0, buffer.getNumSamples() / ratio)));
+        resamplingSource.setResamplingRatio (ratio);
+        resamplingSource.prepareToPlay (result.getNumSamples(), sourceSampleRate);
+        resamplingSource.getNextAudioBlock ({ &result, 0, result.getNumSamples() });
+
+        return result;
+    }
+
+    static void normalise (juce::AudioBuffer<float>& buffer)
+    {
+        float maxSumOfSquares = 0.0f;
+
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+        {
+            auto data = buffer.getReadPointer (c);
+            maxSumOfSquares = std::max (maxSumOfSquares, std::inner_product (data, data + buffer.getNumSamples(), data, 0.0f));
+        }
+
+        if (maxSumOfSquares > 0.0f)
+            buffer.applyGain (0.125f / std::sqrt (maxSumOfSquares));
+    }
+
+    //==============================================================================
+    static int getFFTOrder (int partitionSize)
+    {
+        int order = 1;
+
+        while ((1 << order) < partitionSize * 2)
+            ++order;
+
+        return order;
+    }
+
+    /** Multiplies two arrays of interleaved complex values and adds the result to a third. */
+    static void multiplyAndAdd (float* dest, const float* a, const float* b, int numBins) noexcept
+    {
+        for (int i = 0; i < numBins * 2; i += 2)
+        {
+            dest[i]     += a[i] * b[i]     - a[i + 1] * b[i + 1];
+            dest[i + 1] += a[i] * b[i + 1] + a[i + 1] * b[i];
+        }
+    }
+
+    /** Returns the channel of the IR to use for a channel of audio, so mono IRs apply to every channel. */
+    static int getIRChannel (const ImpulseResponseCache::ImpulseResponse& ir, int channel)
+    {
+        return std::min (channel, ir.getNumChannels() - 1);
+    }
+
+    //==============================================================================
+    /** Convolves the first partitions of the IR on the audio thread with no latency.
+        Each call FFTs the part of the current input partition received so far, so the
+        output for every sample is available as soon as its input is.
+    */
+    struct HeadStage
+    {
+        using Stage = ImpulseResponseCache::ImpulseResponse::Stage;
+
+        HeadStage (const ImpulseResponseCache::ImpulseResponse& ir, const Stage& s, int numChannels)
+            : impulseResponse (ir), stage (s),
+              partitionSize (s.partitionSize), numBins (s.partitionSize + 1),
+              fft (getFFTOrder (s.partitionSize)),
+              fftData ((size_t) partitionSize * 4)
+        {
+            for (int c = 0; c < numChannels; ++c)
+                channels.push_back ({ std::vector<float> ((size_t) partitionSize),
+                                      std::vector<float> ((size_t) (stage.numPartitions * numBins * 2)),
+                                      std::vector<float> ((size_t) numBins * 2),
+                                      std::vector<float> ((size_t) partitionSize) });
+        }
+
+        int getNumSamplesToBoundary() const noexcept    { return partitionSize - position; }
+
+        void processChannel (int c, const float* input, float* output, int numSamples) noexcept
+        {
+            auto& channel = channels[(size_t) c];
+            auto& spectra = stage.spectra[(size_t) getIRChannel (impulseResponse, c)];
+            std::copy (input, input + numSamples, channel.input.begin() + position);
+
+            // Transform the partition so far, which becomes the newest in the delay line
+            std::fill (fftData.begin(), fftData.end(), 0.0f);
+            std::copy (channel.input.begin(), channel.input.begin() + position + numSamples, fftData.begin());
+            fft.performRealOnlyForwardTransform (fftData.data(), true);
+
+            auto newest = channel.delayLine.data() + delayLineIndex * numBins * 2;
+            std::copy (fftData.begin(), fftData.begin() + numBins * 2, newest);
+
+            std::copy (channel.previousPartitions.begin(), channel.previousPartitions.end(), fftData.begin());
+            multiplyAndAdd (fftData.data(), newest, spectra.data(), numBins);
+            fft.performRealOnlyInverseTransform (fftData.data());
+
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = fftData[(size_t) (position + i)] + channel.overlap[(size_t) (position + i)];
+
+            if (position + numSamples == partitionSize)
+                std::copy (fftData.begin() + partitionSize, fftData.begin() + partitionSize * 2, channel.overlap.begin());
+        }
+
+        void advance (int numSamples) noexcept
+        {
+            position += numSamples;
+
+            if (position < partitionSize)
+                return;
+
+            position = 0;
+            delayLineIndex = (delayLineIndex + 1) % stage.numPartitions;
+
+            // The older partitions don't change until the next boundary so are summed once here
+            for (size_t c = 0; c < channels.size(); ++c)
+            {
+                auto& channel = channels[c];
+                auto& spectra = stage.spectra[(size_t) getIRChannel (impulseResponse, (int) c)];
+                std::fill (channel.previousPartitions.begin(), channel.previousPartitions.end(), 0.0f);
+                std::fill (channel.input.begin(), channel.input.end(), 0.0f);
+
+                for (int p = 1; p < stage.numPartitions; ++p)
+                {
+                    const auto index = (delayLineIndex + stage.numPartitions - p) % stage.numPartitions;
+                    multiplyAndAdd (channel.previousPartitions.data(),
+                                    channel.delayLine.data() + index * numBins * 2,
+                                    spectra.data() + p * numBins * 2, numBins);
+                }
+            }
+        }
+
+        void reset() noexcept
+        {
+            for (auto& channel : channels)
+                for (auto v : { &channel.input, &channel.delayLine, &channel.previousPartitions, &channel.overlap })
+                    std::fill (v->begin(), v->end(), 0.0f);
+
+            position = 0;
+            delayLineIndex = 0;
+        }
+
+        struct Channel
+        {
+            std::vector<float> input, delayLine, previousPartitions, overlap;
+        };
+
+        const ImpulseResponseCache::ImpulseResponse& impulseResponse;
+        const Stage& stage;
+        const int partitionSize, numBins;
+        juce::dsp::FFT fft;
+        std::vector<float> fftData;
+        std::vector<Channel> channels;
+        int position = 0, delayLineIndex = 0;
+    };
+
+    //==============================================================================
+    /** Convolves a later stage of the IR with uniformly partitioned overlap-save.
+
+        Each partition's worth of input is handed to the worker thread as a job. The
+        stage starts three of its partitions into the IR, so a job's result isn't needed
+        until two partitions after it's handed over, giving the worker a whole partition
+        to spare. Jobs use a ring of three buffers: one being played, one that may still
+        be computing and the one just handed over.
+
+        The audio thread never waits for the worker. If a job hasn't been started when
+        its result is needed it's computed on the audio thread, and if it's still being
+        computed the stage is silent for that partition. When rendering, every job is
+        finished as it's handed over so the output is always the same.
+    */
+    struct TailStage
+    {
+        using Stage = ImpulseResponseCache::ImpulseResponse::Stage;
+
+        TailStage (const ImpulseResponseCache::ImpulseResponse& ir, const Stage& s, int numChannels)
+            : impulseResponse (ir), stage (s),
+              partitionSize (s.partitionSize), numBins (s.partitionSize + 1),
+              fft (getFFTOrder (s.partitionSize)),
+              fftData ((size_t) partitionSize * 4)
+        {
+            jassert (stage.offset == partitionSize * 3);
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                channels.push_back ({ std::vector<float> ((size_t) partitionSize), std::vector<float> ((size_t) partitionSize) });
+                delayLines.emplace_back ((size_t) (stage.numPartitions * numBins * 2));
+
+                for (auto& job : jobs)
+                    job.channels.push_back ({ std::vector<float> ((size_t) partitionSize * 2), std::vector<float> ((size_t) partitionSize) });
+            }
+        }
+
+        void processChannel (int c, const float* input, float* output, int numSamples) noexcept
+        {
+            std::copy (input, input + numSamples, channels[(size_t) c].collected.begin() + position);
+
+            if (readJob != nullptr)
+                juce::FloatVectorOperations::add (output, readJob->channels[(size_t) c].result.data() + position, numSamples);
+        }
+
+        /** Moves on, handing the collected input over as a job at the end of a partition. */
+        void advance (int numSamples, ImpulseResponseCache::TailWorker&, bool isNonRealtime, std::atomic<int>& numLateBlocks) noexcept;
+
+        /** Computes the next job in order if it's been handed over and nothing else has started it. */
+        bool runNextJob() noexcept
+        {
+            const auto sequence = nextJobToRun.load (std::memory_order_acquire);
+            auto& job = jobs[sequence % numJobs];
+            auto expected = JobState::queued;
+
+            if (! job.state.compare_exchange_strong (expected, JobState::running, std::memory_order_acquire))
+                return false;
+
+            // The ring may have moved on since nextJobToRun was read
+            if (job.sequence != sequence)
+            {
+                job.state.store (JobState::queued, std::memory_order_release);
+                return false;
+            }
+
+            run (job);
+            nextJobToRun.store (sequence + 1, std::memory_order_release);
+            job.state.store (JobState::done, std::memory_order_release);
+            jobFinished.signal();
+            return true;
+        }
+
+        /** Returns true if any jobs are waiting for the worker or being computed. */
+        bool hasUnfinishedJobs() const noexcept
+        {
+            for (auto& job : jobs)
+                if (isBusy (job))
+                    return true;
+
+            return false;
+        }
+
+        void reset() noexcept
+        {
+            // This isn't called on the audio thread, so it can wait for the worker
+            while (! tryToClear())
+                jobFinished.timed_wait (1000);
+
+            numHandedOver = 0;
+            nextJobToRun.store (0, std::memory_order_release);
+            position = 0;
+        }
+
+        enum class JobState { idle, queued, running, done };
+
+        struct Job
+        {
+            struct Channel
+            {
+                std::vector<float> input, result;
+            };
+
+            std::vector<Channel> channels;
+            uint32_t sequence = std::numeric_limits<uint32_t>::max();
+            std::atomic<JobState> state { JobState::idle };
+        };
+
+        struct Channel
+        {
+            std::vector<float> collected, previous;
+        };
+
+        static constexpr uint32_t numJobs = 3;
+
+        const ImpulseResponseCache::ImpulseResponse& impulseResponse;
+        const Stage& stage;
+        const int partitionSize, numBins;
+
+        // Only used by whichever thread is running a job
+        juce::dsp::FFT fft;
+        std::vector<float> fftData;
+        std::vector<std::vector<float>> delayLines;
+
+        Job jobs[numJobs];
+        std::atomic<uint32_t> nextJobToRun { 0 };
+        tracktion::graph::LightweightSemaphore jobFinished;
+
+        // Only used by the audio thread
+        std::vector<Channel> channels;
+        Job* readJob = nullptr;
+        uint32_t numHandedOver = 0;
+        int position = 0;
+        bool isClearing = false;
+
+        static bool isBusy (const Job& job) noexcept
+        {
+            const auto state = job.state.load (std::memory_order_acquire);
+            return state == JobState::queued || state == JobState::running;
+        }
+
+        void run (Job& job) noexcept
+        {
+            const auto delayLineIndex = (int) (job.sequence % (uint32_t) stage.numPartitions);
+
+            for (size_t c = 0; c < job.channels.size(); ++c)
+            {
+                auto& jobChannel = job.channels[c];
+                auto& delayLine = delayLines[c];
+                auto& spectra = stage.spectra[(size_t) getIRChannel (impulseResponse, (int) c)];
+
+                std::copy (jobChannel.input.begin(), jobChannel.input.end(), fftData.begin());
+                std::fill (fftData.begin() + partitionSize * 2, fftData.end(), 0.0f);
+                fft.performRealOnlyForwardTransform (fftData.data(), true);
+                std::copy (fftData.begin(), fftData.begin() + numBins * 2, delayLine.begin() + delayLineIndex * numBins * 2);
+
+                std::fill (fftData.begin(), fftData.end(), 0.0f);
+
+                for (int p = 0; p < stage.numPartitions; ++p)
+                {
+                    const auto index = (delayLineIndex + stage.numPartitions - p) % stage.numPartitions;
+                    multiplyAndAdd (fftData.data(), delayLine.data() + index * numBins * 2,
+                                    spectra.data() + p * numBins * 2, numBins);
+                }
+
+                // Only the second half of the result is free from wrap-around
+                fft.performRealOnlyInverseTransform (fftData.data());
+                std::copy (fftData.begin() + partitionSize, fftData.begin() + partitionSize * 2, jobChannel.result.begin());
+            }
+        }
+
+        /** Cancels any jobs the worker hasn't started and, if it isn't computing one,
+            clears the stage so it can start again from the next partition.
+            Returns false without waiting if the worker is still busy.
+        */
+        bool tryToClear() noexcept
+        {
+            for (auto& job : jobs)
+            {
+                auto expected = JobState::queued;
+                job.state.compare_exchange_strong (expected, JobState::idle, std::memory_order_acq_rel);
+
+                if (job.state.load (std::memory_order_acquire) == JobState::running)
+                    return false;
+            }
+
+            for (auto& job : jobs)
+            {
+                job.sequence = std::numeric_limits<uint32_t>::max();
+                job.state.store (JobState::idle, std::memory_order_relaxed);
+            }
+
+            for (auto& delayLine : delayLines)
+                std::fill (delayLine.begin(), delayLine.end(), 0.0f);
+
+            for (auto& channel : channels)
+                std::fill (channel.previous.begin(), channel.previous.end(), 0.0f);
+
+            nextJobToRun.store (numHandedOver, std::memory_order_release);
+            readJob = nullptr;
+            isClearing = false;
+            return true;
+        }
+
+        /** Computes every job that's been handed over, waiting for the worker to finish any it's started. */
+        void finishAllJobs() noexcept
+        {
+            while (nextJobToRun.load (std::memory_order_acquire) != numHandedOver)
+                if (! runNextJob())
+                    jobFinished.timed_wait (1000);
+        }
+    };
+}
+
+//==============================================================================
+class ImpulseResponseCache::TailWorker  : private juce::Thread
+{
+public:
+    TailWorker (ThreadPlacementPolicy* policy)
+        : juce::Thread ("IR Convolution"),
+          threadPlacementPolicy (policy)
+    {
+        startThread (juce::Thread::Priority::highest);
+    }
+
+    ~TailWorker() override
+    {
+        jassert (stages.empty());
+        signalThreadShouldExit();
+        jobsQueued.signal();
+        stopThread (5000);
+    }
+
+    void addStage (ir_convolution::TailStage& stage)
+    {
+        const juce::ScopedLock sl (lock);
+        stages.push_back (&stage);
+    }
+
+    /** Once this returns the worker won't touch the stage again. */
+    void removeStage (ir_convolution::TailStage& stage)
+    {
+        const juce::ScopedLock sl (lock);
+        stages.erase (std::remove (stages.begin(), stages.end(), &stage), stages.end());
+    }
+
+    /** Lets the worker know there's a job to compute.
+        Unlike Thread::notify, this doesn't take a lock so is safe to call from the audio thread.
+    */
+    void notify() noexcept
+    {
+        jobsQueued.signal();
+    }
+
+private:
+    ThreadPlacementPolicy* threadPlacementPolicy = nullptr;
+    juce::CriticalSection lock;
+    std::vector<ir_convolution::TailStage*> stages;
+    tracktion::graph::LightweightSemaphore jobsQueued;
+
+    void run() override
+    {
+        // The results are needed by the audio thread, so this is scheduled like the
+        // threads that help process the playback graph
+        if (threadPlacementPolicy != nullptr
+             && threadPlacementPolicy->hasPlacement (ThreadPlacementPolicy::ThreadRole::graphWorker))
+            threadPlacementPolicy->applyToCurrentThread (ThreadPlacementPolicy::ThreadRole::graphWorker, getThreadName());
+
+        while (! threadShouldExit())
+        {
+            bool didWork = false;
+
+            {
+                const juce::ScopedLock sl (lock);
+
+                for (auto stage : stages)
+                    while (stage->runNextJob())
+                        didWork = true;
+            }
+
+            if (! didWork)
+                jobsQueued.timed_wait (100000);
+        }
+    }
+};
+
+void ir_convolution::TailStage::advance (int numSamples, ImpulseResponseCache::TailWorker& worker,
+                                         bool isNonRealtime, std::atomic<int>& numLateBlocks) noexcept
+{
+    position += numSamples;
+
+    if (position < partitionSize)
+        return;
+
+    position = 0;
+    auto& job = jobs[numHandedOver % numJobs];
+
+    if (isNonRealtime)
+    {
+        // Rendering can wait for the worker to finish anything it started in real-time
+        if (isClearing)
+            while (! tryToClear())
+                jobFinished.timed_wait (1000);
+
+        finishAllJobs();
+    }
+    else if (isClearing || isBusy (job))
+    {
+        // The job from three partitions ago still isn't finished, so the worker has fallen
+        // too far behind. Rather than wait for it, this stage is silent until it's caught up.
+        if (! tryToClear())
+        {
+            isClearing = true;
+            ++numLateBlocks;
+            return;
+        }
+    }
+
+    const auto sequence = numHandedOver;
+
+    for (size_t c = 0; c < channels.size(); ++c)
+    {
+        auto& channel = channels[c];
+        auto& input = job.channels[c].input;
+        std::copy (channel.previous.begin(), channel.previous.end(), input.begin());
+        std::copy (channel.collected.begin(), channel.collected.end(), input.begin() + partitionSize);
+        std::swap (channel.previous, channel.collected);
+    }
+
+    job.sequence = sequence;
+    job.state.store (JobState::queued, std::memory_order_release);
+    ++numHandedOver;
+
+    if (isNonRealtime)
+        finishAllJobs();
+    else
+        worker.notify();
+
+    // The job handed over two partitions ago is needed for the next one
+    readJob = nullptr;
+
+    if (sequence >= 2)
+    {
+        auto& neededJob = jobs[(sequence - 2) % numJobs];
+
+        if (neededJob.sequence == sequence - 2)
+        {
+            if (neededJob.state.load (std::memory_order_acquire) == JobState::queued)
+                runNextJob();
+
+            if (neededJob.state.load (std::memory_order_acquire) == JobState::done)
+                readJob = &neededJob;
+            else
+                ++numLateBlocks;
+        }
+    }
+}
+
+//==============================================================================
+size_t ImpulseResponseCache::ImpulseResponse::getSizeInBytes() const noexcept
+{
+    size_t size = 0;
+
+    for (auto& stage : stages)
+        for (auto& spectra : stage.spectra)
+            size += spectra.size() * sizeof (float);
+
+    return size;
+}
+
+//==============================================================================
+ImpulseResponseCache::ImpulseResponseCache (ThreadPlacementPolicy* policy)
+    : threadPlacementPolicy (policy)
+{
+}
+
+ImpulseResponseCache::~ImpulseResponseCache()
+{
+    jassert (getNumImpulseResponses() == 0);
+}
+
+ImpulseResponseCache::ImpulseResponsePtr ImpulseResponseCache::getImpulseResponse (const juce::MemoryBlock& flacData, double sampleRate,
+                                                                                    bool normalise, bool trimSilence)
+{
+    const auto hash = std::hash<std::string_view>() (std::string_view (static_cast<const char*> (flacData.getData()), flacData.getSize()));
+
+    const juce::ScopedLock sl (lock);
+
+    entries.erase (std::remove_if (entries.begin(), entries.end(), [] (auto& e) { return e.impulseResponse.expired(); }),
+                   entries.end());
+
+    for (auto& e : entries)
+        if (e.hash == hash && e.sampleRate == sampleRate && e.normalise == normalise && e.trimSilence == trimSilence
+             && e.data == flacData)
+            if (auto ir = e.impulseResponse.lock())
+                return ir;
+
+    auto is = std::make_unique<juce::MemoryInputStream> (flacData, false);
+
+    if (auto reader = std::unique_ptr<juce::AudioFormatReader> (juce::FlacAudioFormat().createReaderFor (is.release(), true)))
+    {
+        if (reader->numChannels == 0)
+            return {};
+
+        juce::AudioBuffer<float> buffer ((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+
+        auto ir = createImpulseResponse (buffer, reader->sampleRate, sampleRate, normalise, trimSilence);
+        entries.push_back ({ hash, flacData, sampleRate, normalise, trimSilence, ir });
+
+        return ir;
+    }
+
+    return {};
+}
+
+ImpulseResponseCache::ImpulseResponsePtr ImpulseResponseCache::createImpulseResponse (const juce::AudioBuffer<float>& source, double sourceSampleRate,
+                                                                                       double sampleRate, bool normalise, bool trimSilence)
+{
+    jassert (source.getNumChannels() > 0 && sampleRate > 0.0);
+
+    auto trimmed = trimSilence ? ir_convolution::trimSilence (source) : source;
+
+    if (trimmed.getNumSamples() == 0)
+    {
+        trimmed.setSize (source.getNumChannels(), 1);
+        trimmed.clear();
+    }
+
+    auto buffer = ir_convolution::resample (trimmed, sourceSampleRate, sampleRate);
+
+    if (normalise)
+        ir_convolution::normalise (buffer);
+    else
+        buffer.applyGain ((float) (sourceSampleRate / sampleRate));
+
+    std::shared_ptr<ImpulseResponse> ir (new ImpulseResponse());
+    ir->numChannels = buffer.getNumChannels();
+    ir->length = buffer.getNumSamples();
+    ir->sampleRate = sampleRate;
+
+    // Each stage after the head starts at three times its partition size, so there are
+    // two partitions between a block being handed to the worker and it being needed
+    int offset = 0, partitionSize = headPartitionSize;
+
+    while (offset < ir->length)
+    {
+        const auto nextPartitionSize = std::min (partitionSize * 4, maxPartitionSize);
+        const auto end = nextPartitionSize > partitionSize ? std::min (ir->length, nextPartitionSize * 3)
+                                                           : ir->length;
+
+        ImpulseResponse::Stage stage;
+        stage.partitionSize = partitionSize;
+        stage.offset = offset;
+        stage.numPartitions = (end - offset + partitionSize - 1) / partitionSize;
+
+        juce::dsp::FFT fft (ir_convolution::getFFTOrder (partitionSize));
+        std::vector<float> fftData ((size_t) partitionSize * 4);
+        const auto numValues = (partitionSize + 1) * 2;
+
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+        {
+            std::vector<float> spectra ((size_t) (stage.numPartitions * numValues));
+
+            for (int p = 0; p < stage.numPartitions; ++p)
+            {
+                const auto start = offset + p * partitionSize;
+                auto data = buffer.getReadPointer (c, start);
+
+                std::fill (fftData.begin(), fftData.end(), 0.0f);
+                std::copy (data, data + std::min (partitionSize, end - start), fftData.begin());
+                fft.performRealOnlyForwardTransform (fftData.data(), true);
+                std::copy (fftData.begin(), fftData.begin() + numValues, spectra.begin() + p * numValues);
+            }
+
+            stage.spectra.push_back (std::move (spectra));
+        }
+
+        ir->stages.push_back (std::move (stage));
+        offset = end;
+        partitionSize = nextPartitionSize;
+    }
+
+    return ir;
+}
+
+int ImpulseResponseCache::getNumImpulseResponses() const
+{
+    const juce::ScopedLock sl (lock);
+
+    return (int) std::count_if (entries.begin(), entries.end(),
+                                [] (auto& e) { return ! e.impulseResponse.expired(); });
+}
+
+ImpulseResponseCache::TailWorker& ImpulseResponseCache::getWorker()
+{
+    const juce::ScopedLock sl (lock);
+
+    if (! worker)
+        worker = std::make_unique<TailWorker> (threadPlacementPolicy);
+
+    return *worker;
+}
+
+//==============================================================================
+struct PartitionedConvolution::Convolver
+{
+    Convolver (ImpulseResponseCache::TailWorker& w, ImpulseResponseCache::ImpulseResponsePtr ir,
+               int numChannelsToUse, std::atomic<int>& numLateBlocksToUpdate)
+        : worker (w), impulseResponse (std::move (ir)), numChannels (numChannelsToUse),
+          numLateBlocks (numLateBlocksToUpdate),
+          chunk ((size_t) ImpulseResponseCache::headPartitionSize)
+    {
+        auto& stages = impulseResponse->getStages();
+
+        if (! stages.empty())
+            head = std::make_unique<ir_convolution::HeadStage> (*impulseResponse, stages.front(), numChannels);
+
+        for (size_t i = 1; i < stages.size(); ++i)
+        {
+            tails.push_back (std::make_unique<ir_convolution::TailStage> (*impulseResponse, stages[i], numChannels));
+            worker.addStage (*tails.back());
+        }
+    }
+
+    ~Convolver()
+    {
+        for (auto& tail : tails)
+            worker.removeStage (*tail);
+    }
+
+    void process (juce::dsp::AudioBlock<float>& block, bool isNonRealtime) noexcept
+    {
+        const auto numChannelsToProcess = std::min ((int) block.getNumChannels(), numChannels);
+        const auto numSamples = (int) block.getNumSamples();
+        hasProcessedAudio.store (true, std::memory_order_relaxed);
+
+        if (head == nullptr)
+        {
+            block.clear();
+            return;
+        }
+
+        // Each chunk ends at or before the next head boundary, which all the
+        // larger partitions' boundaries line up with
+        for (int done = 0; done < numSamples;)
+        {
+            const auto numThisTime = std::min (numSamples - done, head->getNumSamplesToBoundary());
+
+            for (int c = 0; c < numChannelsToProcess; ++c)
+            {
+                auto data = block.getChannelPointer ((size_t) c) + done;
+                std::copy (data, data + numThisTime, chunk.begin());
+
+                head->processChannel (c, chunk.data(), data, numThisTime);
+
+                for (auto& tail : tails)
+                    tail->processChannel (c, chunk.data(), data, numThisTime);
+            }
+
+            head->advance (numThisTime);
+
+            for (auto& tail : tails)
+                tail->advance (numThisTime, worker, isNonRealtime, numLateBlocks);
+
+            done += numThisTime;
+        }
+    }
+
+    void reset() noexcept
+    {
+        if (head != nullptr)
+            head->reset();
+
+        for (auto& tail : tails)
+            tail->reset();
+    }
+
+    bool isComputingInBackground() const noexcept
+    {
+        for (auto& tail : tails)
+            if (tail->hasUnfinishedJobs())
+                return true;
+
+        return false;
+    }
+
+    ImpulseResponseCache::TailWorker& worker;
+    const ImpulseResponseCache::ImpulseResponsePtr impulseResponse;
+    const int numChannels;
+    std::atomic<int>& numLateBlocks;
+    std::atomic<bool> hasProcessedAudio { false };
+    std::vector<float> chunk;
+    std::unique_ptr<ir_convolution::HeadStage> head;
+    std::vector<std::unique_ptr<ir_convolution::TailStage>> tails;
+};
+
+//==============================================================================
+PartitionedConvolution::PartitionedConvolution() = default;
+
+PartitionedConvolution::~PartitionedConvolution()
+{
+    cancelPendingUpdate();
+
+    const juce::SpinLock::ScopedLockType sl (convolverLock);
+    fadingConvolver.reset();
+    convolver.reset();
+}
+
+void PartitionedConvolution::setImpulseResponse (ImpulseResponseCache& c, ImpulseResponseCache::ImpulseResponsePtr ir)
+{
+    cache = &c;
+    impulseResponse = std::move (ir);
+    updateConvolver (true);
+}
+
+ImpulseResponseCache::ImpulseResponsePtr PartitionedConvolution::getImpulseResponse() const
+{
+    return impulseResponse;
+}
+
+void PartitionedConvolution::setNonRealtime (bool isNonRealtime) noexcept
+{
+    nonRealtime.store (isNonRealtime, std::memory_order_relaxed);
+}
+
+bool PartitionedConvolution::isComputingInBackground() const noexcept
+{
+    const juce::SpinLock::ScopedLockType sl (convolverLock);
+
+    for (auto c : { convolver.get(), fadingConvolver.get() })
+        if (c != nullptr && c->isComputingInBackground())
+            return true;
+
+    return false;
+}
+
+void PartitionedConvolution::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    numChannels = (int) spec.numChannels;
+
+    {
+        const juce::SpinLock::ScopedLockType sl (convolverLock);
+        fadeBuffer.setSize (numChannels, (int) spec.maximumBlockSize);
+        fadeLength = std::max (1, juce::roundToInt (spec.sampleRate * crossfadeSeconds));
+    }
+
+    updateConvolver (false);
+}
+
+void PartitionedConvolution::process (const juce::dsp::ProcessContextReplacing<float>& context) noexcept
+{
+    if (context.isBypassed)
+        return;
+
+    auto block = context.getOutputBlock();
+
+    // The lock is only held briefly by the message thread, e.g. to swap the IR, and the
+    // audio thread doesn't wait for it
+    const juce::SpinLock::ScopedTryLockType sl (convolverLock);
+
+    if (! sl.isLocked())
+    {
+        block.clear();
+        return;
+    }
+
+    if (convolver == nullptr)
+        return;
+
+    const auto isNonRealtime = nonRealtime.load (std::memory_order_relaxed);
+
+    if (fadingConvolver == nullptr || fadePosition >= fadeLength)
+    {
+        convolver->process (block, isNonRealtime);
+        return;
+    }
+
+    // Both IRs are processed whilst fading from the old one to the new one
+    const auto numChannelsToFade = std::min (block.getNumChannels(), (size_t) fadeBuffer.getNumChannels());
+
+    for (size_t done = 0; done < block.getNumSamples();)
+    {
+        const auto numThisTime = std::min (block.getNumSamples() - done, (size_t) fadeBuffer.getNumSamples());
+        auto newBlock = block.getSubBlock (done, numThisTime);
+        auto oldBlock = juce::dsp::AudioBlock<float> (fadeBuffer).getSubsetChannelBlock (0, numChannelsToFade)
+                                                                 .getSubBlock (0, numThisTime);
+        oldBlock.copyFrom (newBlock);
+
+        fadingConvolver->process (oldBlock, isNonRealtime);
+        convolver->process (newBlock, isNonRealtime);
+
+        const auto numToFade = std::min ((int) numThisTime, fadeLength - fadePosition);
+
+        for (size_t c = 0; c < numChannelsToFade; ++c)
+        {
+            auto newData = newBlock.getChannelPointer (c);
+            auto oldData = oldBlock.getChannelPointer (c);
+
+            for (int i = 0; i < numToFade; ++i)
+            {
+                const auto gain = (float) (fadePosition + i) / (float) fadeLength;
+                newData[i] = newData[i] * gain + oldData[i] * (1.0f - gain);
+            }
+        }
+
+        fadePosition += numToFade;
+        done += numThisTime;
+
+        if (fadePosition >= fadeLength)
+        {
+            if (done < block.getNumSamples())
+                convolver->process (block.getSubBlock (done), isNonRealtime);
+
+            // The old convolver is deleted on the message thread
+            triggerAsyncUpdate();
+            break;
+        }
+    }
+}
+
+void PartitionedConvolution::reset() noexcept
+{
+    std::unique_ptr<Convolver> oldFadingConvolver;
+
+    {
+        const juce::SpinLock::ScopedLockType sl (convolverLock);
+
+        if (convolver != nullptr)
+            convolver->reset();
+
+        // There's nothing left to fade from
+        oldFadingConvolver = std::move (fadingConvolver);
+    }
+}
+
+void PartitionedConvolution::updateConvolver (bool shouldCrossfade)
+{
+    std::unique_ptr<Convolver> newConvolver, oldConvolver, oldFadingConvolver;
+
+    if (impulseResponse != nullptr && cache != nullptr)
+        newConvolver = std::make_unique<Convolver> (cache->getWorker(), impulseResponse, numChannels, numLateBlocks);
+
+    {
+        const juce::SpinLock::ScopedLockType sl (convolverLock);
+        oldFadingConvolver = std::move (fadingConvolver);
+
+        // There's only anything to fade from if the old IR has been playing
+        if (shouldCrossfade && newConvolver != nullptr && convolver != nullptr && fadeBuffer.getNumSamples() > 0
+             && convolver->hasProcessedAudio.load (std::memory_order_relaxed))
+        {
+            fadingConvolver = std::move (convolver);
+            fadePosition = 0;
+        }
+        else
+        {
+            oldConvolver = std::move (convolver);
+        }
+
+        convolver = std::move (newConvolver);
+    }
+
+    // The old ones are deleted here, outside the lock
+}
+
+void PartitionedConvolution::handleAsyncUpdate()
+{
+    std::unique_ptr<Convolver> oldFadingConvolver;
+
+    {
+        const juce::SpinLock::ScopedLockType sl (convolverLock);
+
+        if (fadePosition >= fadeLength)
+            oldFadingConvolver = std::move (fadingConvolver);
+    }
+}
+
+}} // namespace tracktion { inline namespace engine
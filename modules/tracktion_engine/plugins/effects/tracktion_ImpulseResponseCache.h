@@ -0,0 +1,219 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    An engine-wide store of impulse responses that have been prepared for
+    PartitionedConvolution.
+
+    Impulse responses are looked up by a hash of their audio file data along with
+    the sample rate and options they were prepared with, so any number of plugins
+    loading the same IR share a single copy of its frequency-domain partitions.
+    Each one is freed as soon as the last convolution using it lets it go.
+
+    This also owns the thread that computes the larger partitions of every
+    PartitionedConvolution in the background. It's given the graph worker placement
+    from the Engine's ThreadPlacementPolicy, if there is one, so it's scheduled like
+    the threads that help the audio callback.
+
+    @see Engine::getImpulseResponseCache
+*/
+class ImpulseResponseCache
+{
+public:
+    /** Creates an empty cache.
+        If a ThreadPlacementPolicy is passed in, it must outlive the cache.
+    */
+    ImpulseResponseCache (ThreadPlacementPolicy* = nullptr);
+
+    /** Destructor. Any PartitionedConvolutions must have been deleted first. */
+    ~ImpulseResponseCache();
+
+    //==============================================================================
+    /** An impulse response split into frequency-domain partitions.
+
+        The first stage has small partitions that are processed on the audio thread
+        with no latency. Each stage after that has partitions four times the size of
+        the one before, up to maxPartitionSize, and starts three of its partitions into
+        the IR, so each of its blocks can be computed in the background with a whole
+        partition to spare.
+
+        These are never modified once created so can be used from any thread.
+    */
+    class ImpulseResponse
+    {
+    public:
+        /** A run of equally sized partitions. */
+        struct Stage
+        {
+            int partitionSize = 0;      /**< The number of IR samples in each partition. */
+            int offset = 0;             /**< The position in the IR of the first partition. */
+            int numPartitions = 0;      /**< The number of partitions. */
+
+            /** For each channel, the spectrum of each partition as partitionSize + 1
+                interleaved complex values, from an FFT of twice the partition size.
+            */
+            std::vector<std::vector<float>> spectra;
+        };
+
+        /** Returns the number of channels in the IR. */
+        int getNumChannels() const noexcept                 { return numChannels; }
+
+        /** Returns the length of the IR, after trimming and resampling. */
+        int getLength() const noexcept                      { return length; }
+
+        /** Returns the sample rate the IR has been prepared for. */
+        double getSampleRate() const noexcept               { return sampleRate; }
+
+        /** Returns the partitions, starting with the head. */
+        const std::vector<Stage>& getStages() const noexcept  { return stages; }
+
+        /** Returns the memory used by the partitions. */
+        size_t getSizeInBytes() const noexcept;
+
+    private:
+        friend class ImpulseResponseCache;
+        ImpulseResponse() = default;
+
+        int numChannels = 0, length = 0;
+        double sampleRate = 0.0;
+        std::vector<Stage> stages;
+    };
+
+    using ImpulseResponsePtr = std::shared_ptr<const ImpulseResponse>;
+
+    //==============================================================================
+    /** Returns the IR for some FLAC data, prepared for a sample rate, creating it if
+        nothing else is using it yet.
+        The trimming, resampling and normalisation match juce::dsp::Convolution.
+        Returns nullptr if the data can't be read.
+    */
+    ImpulseResponsePtr getImpulseResponse (const juce::MemoryBlock& flacData, double sampleRate,
+                                           bool normalise, bool trimSilence);
+
+    /** Prepares an IR from a buffer without adding it to the cache. */
+    static ImpulseResponsePtr createImpulseResponse (const juce::AudioBuffer<float>&, double sourceSampleRate,
+                                                     double sampleRate, bool normalise, bool trimSilence);
+
+    /** Returns the number of cached IRs that are still in use. */
+    int getNumImpulseResponses() const;
+
+    /** The size of the partitions processed on the audio thread. */
+    static constexpr int headPartitionSize = 128;
+
+    /** The size that the background partitions stop growing at. */
+    static constexpr int maxPartitionSize = 8192;
+
+    /** @internal */
+    class TailWorker;
+
+private:
+    friend class PartitionedConvolution;
+
+    struct Entry
+    {
+        size_t hash;
+        juce::MemoryBlock data;
+        double sampleRate;
+        bool normalise, trimSilence;
+        std::weak_ptr<const ImpulseResponse> impulseResponse;
+    };
+
+    ThreadPlacementPolicy* threadPlacementPolicy = nullptr;
+    mutable juce::CriticalSection lock;
+    std::vector<Entry> entries;
+    std::unique_ptr<TailWorker> worker;
+
+    TailWorker& getWorker();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ImpulseResponseCache)
+};
+
+//==============================================================================
+/**
+    A juce::dsp style processor that convolves audio with an impulse response from
+    the ImpulseResponseCache, with no latency.
+
+    The start of the IR is convolved on the audio thread in small partitions and the
+    rest in increasingly large partitions on the cache's background thread. The audio
+    thread never waits for the background thread. If a background block hasn't been
+    started when it's needed, the audio thread computes it itself, and if it's still
+    being computed that part of the IR is left out for a partition and counted by
+    getNumLateBlocks. When rendering, call setNonRealtime so every block is finished
+    in time and the output is always the same.
+
+    Changing the IR whilst audio is playing crossfades from the old one to the new one.
+
+    Until an IR has been set this passes audio through unaltered.
+*/
+class PartitionedConvolution  : private juce::AsyncUpdater
+{
+public:
+    /** Creates a convolution with no IR. */
+    PartitionedConvolution();
+
+    /** Destructor. */
+    ~PartitionedConvolution() override;
+
+    /** Sets the IR to use, crossfading from the old one if it's been playing.
+        This allocates so should be called from the message thread.
+    */
+    void setImpulseResponse (ImpulseResponseCache&, ImpulseResponseCache::ImpulseResponsePtr);
+
+    /** Returns the IR in use. */
+    ImpulseResponseCache::ImpulseResponsePtr getImpulseResponse() const;
+
+    /** Returns the latency in samples, which is always zero. */
+    int getLatency() const noexcept     { return 0; }
+
+    /** Sets whether audio is being rendered rather than played in real-time.
+        When it is, process waits for any background blocks it needs, so the output
+        doesn't depend on how busy the background thread is.
+    */
+    void setNonRealtime (bool) noexcept;
+
+    /** Returns the number of background blocks that weren't ready in time and were left out. */
+    int getNumLateBlocks() const noexcept       { return numLateBlocks.load (std::memory_order_relaxed); }
+
+    /** Returns true if any blocks are waiting for, or being computed by, the background thread. */
+    bool isComputingInBackground() const noexcept;
+
+    //==============================================================================
+    /** @internal */
+    void prepare (const juce::dsp::ProcessSpec&);
+    /** @internal */
+    void process (const juce::dsp::ProcessContextReplacing<float>&) noexcept;
+    /** @internal. This may wait for the background thread, so shouldn't be called on the audio thread. */
+    void reset() noexcept;
+
+private:
+    struct Convolver;
+
+    static constexpr double crossfadeSeconds = 0.05;
+
+    ImpulseResponseCache* cache = nullptr;
+    ImpulseResponseCache::ImpulseResponsePtr impulseResponse;
+    std::unique_ptr<Convolver> convolver, fadingConvolver;
+    mutable juce::SpinLock convolverLock;
+    juce::AudioBuffer<float> fadeBuffer;
+    int numChannels = 2, fadeLength = 1, fadePosition = 0;
+    std::atomic<bool> nonRealtime { false };
+    std::atomic<int> numLateBlocks { 0 };
+
+    void updateConvolver (bool shouldCrossfade);
+    void handleAsyncUpdate() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PartitionedConvolution)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -152,6 +152,12 @@ void ImpulseResponsePlugin::initialise (const PluginInitialisationInfo& info)
     processSpec.numChannels = 2;
     processorChain.prepare (processSpec);
 
+    // BEATCONNECT MODIFICATION START
+    if (auto ir = processorChain.get<convolutionIndex>().getImpulseResponse())
+        if (ir->getSampleRate() != info.sampleRate)
+            loadImpulseResponseFromState();
+    // BEATCONNECT MODIFICATION END
+
     // Update smoothers
     lowFreqSmoother.setTargetValue (midiNoteToFrequency (lowPassCutoffParam->getCurrentValue()));
     highFreqSmoother.setTargetValue (midiNoteToFrequency (highPassCutoffParam->getCurrentValue()));
@@ -181,6 +187,10 @@ void ImpulseResponsePlugin::reset()
 
 void ImpulseResponsePlugin::applyToBuffer (const PluginRenderContext& fc)
 {
+    // BEATCONNECT MODIFICATION START
+    processorChain.get<convolutionIndex>().setNonRealtime (fc.isRendering);
+    // BEATCONNECT MODIFICATION END
+
     // Update smoothers
     lowFreqSmoother.setTargetValue (midiNoteToFrequency (lowPassCutoffParam->getCurrentValue()));
     highFreqSmoother.setTargetValue (midiNoteToFrequency (highPassCutoffParam->getCurrentValue()));
@@ -272,27 +282,16 @@ void ImpulseResponsePlugin::restorePluginStateFromValueTree (const juce::ValueTr
 //==============================================================================
 void ImpulseResponsePlugin::loadImpulseResponseFromState()
 {
+    // BEATCONNECT MODIFICATION START
+    // IRs come from the engine's cache, so instances loading the same file share its partitions
     if (auto irFileData = state.getProperty (IDs::irFileData).getBinaryData())
     {
-        auto is = std::make_unique<juce::MemoryInputStream> (*irFileData, false);
+        auto& cache = engine.getImpulseResponseCache();
 
-        if (auto reader = std::unique_ptr<juce::AudioFormatReader> (juce::FlacAudioFormat()
-                                                                        .createReaderFor (is.release(), true)))
-        {
-            juce::AudioBuffer<float> loadIRBuffer ((int) reader->numChannels, (int) reader->lengthInSamples);
-            reader->read (&loadIRBuffer, 0, (int) reader->lengthInSamples, 0, true, true);
-
-            jassert (reader->numChannels > 0);
-            processorChain.get<convolutionIndex>().loadImpulseResponse (std::move (loadIRBuffer),
-                                                                        reader->sampleRate,
-                                                                        reader->numChannels > 1 ? juce::dsp::Convolution::Stereo::yes
-                                                                                                : juce::dsp::Convolution::Stereo::no,
-                                                                        trimSilence.get() ? juce::dsp::Convolution::Trim::yes
-                                                                                          : juce::dsp::Convolution::Trim::no,
-                                                                        normalise.get() ? juce::dsp::Convolution::Normalise::yes
-                                                                                        : juce::dsp::Convolution::Normalise::no);
-        }
+        if (auto ir = cache.getImpulseResponse (*irFileData, sampleRate, normalise.get(), trimSilence.get()))
+            processorChain.get<convolutionIndex>().setImpulseResponse (cache, std::move (ir));
     }
+    // BEATCONNECT MODIFICATION END
 }
 
 void ImpulseResponsePlugin::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& id)
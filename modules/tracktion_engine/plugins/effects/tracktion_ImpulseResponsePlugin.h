@@ -106,7 +106,9 @@ private:
     juce::CachedValue<float> highPassCutoffValue, lowPassCutoffValue;
     juce::CachedValue<float> qValue;
 
-    juce::dsp::ProcessorChain<juce::dsp::Convolution,
+    // BEATCONNECT MODIFICATION START
+    juce::dsp::ProcessorChain<PartitionedConvolution,
+    // BEATCONNECT MODIFICATION END
                               juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>,
                               juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>,
                               juce::dsp::Gain<float>> processorChain;
@@ -0,0 +1,255 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class ImpulseResponseCacheTests  : public juce::UnitTest
+{
+public:
+    ImpulseResponseCacheTests()
+        : juce::UnitTest ("ImpulseResponseCache", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runConvolutionTests();
+        runRealtimeConvolutionTests();
+        runCrossfadeTests();
+        runSharingTests();
+    }
+
+private:
+    static juce::AudioBuffer<float> createNoise (juce::Random& r, int numChannels, int numSamples, float decay = 0.0f)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (c, i, (r.nextFloat() * 2.0f - 1.0f) * std::exp (-decay * (float) i / (float) numSamples));
+
+        return buffer;
+    }
+
+    void expectMatchesDirectConvolution (const juce::AudioBuffer<float>& irBuffer, const juce::AudioBuffer<float>& input,
+                                         const juce::AudioBuffer<float>& output, const juce::String& description)
+    {
+        // Compares against direct convolution, skipping samples to keep this quick
+        const int irLength = irBuffer.getNumSamples();
+        const int numIRChannels = irBuffer.getNumChannels();
+        const int step = irLength > 5000 ? 97 : 11;
+        double maxError = 0.0, maxLevel = 0.0;
+
+        for (int c = 0; c < input.getNumChannels(); ++c)
+        {
+            auto h = irBuffer.getReadPointer (std::min (c, numIRChannels - 1));
+            auto x = input.getReadPointer (c);
+
+            for (int i = 0; i < input.getNumSamples(); i += step)
+            {
+                double expected = 0.0;
+
+                for (int j = 0; j < std::min (irLength, i + 1); ++j)
+                    expected += (double) h[j] * x[i - j];
+
+                maxError = std::max (maxError, std::abs (expected - output.getSample (c, i)));
+                maxLevel = std::max (maxLevel, std::abs (expected));
+            }
+        }
+
+        expectLessThan (maxError, maxLevel * 1.0e-5, description);
+    }
+
+    void runConvolutionTests()
+    {
+        beginTest ("Partitioned convolution");
+
+        auto& cache = Engine::getEngines()[0]->getImpulseResponseCache();
+        juce::Random r (42);
+
+        // Lengths that end in the head, part way through the growing stages and in the largest one
+        for (int irLength : { 1, 1000, 5000, 40000 })
+        {
+            for (int numIRChannels : { 1, 2 })
+            {
+                const auto irBuffer = createNoise (r, numIRChannels, irLength, 3.0f);
+                const auto ir = ImpulseResponseCache::createImpulseResponse (irBuffer, 44100.0, 44100.0, false, false);
+                expectEquals (ir->getLength(), irLength);
+
+                for (int blockSize : { 37, 512, 3000 })
+                {
+                    PartitionedConvolution convolution;
+                    convolution.setNonRealtime (true);
+                    convolution.prepare ({ 44100.0, (juce::uint32) blockSize, 2 });
+                    convolution.setImpulseResponse (cache, ir);
+                    expectEquals (convolution.getLatency(), 0);
+
+                    const int numSamples = 60000;
+                    const auto input = createNoise (r, 2, numSamples);
+                    auto output = input;
+
+                    for (int start = 0; start < numSamples; start += blockSize)
+                    {
+                        auto block = juce::dsp::AudioBlock<float> (output).getSubBlock ((size_t) start, (size_t) std::min (blockSize, numSamples - start));
+                        convolution.process (juce::dsp::ProcessContextReplacing<float> (block));
+                    }
+
+                    expectMatchesDirectConvolution (irBuffer, input, output, "IR length " + juce::String (irLength)
+                                                                             + ", block size " + juce::String (blockSize));
+                }
+            }
+        }
+    }
+
+    void runRealtimeConvolutionTests()
+    {
+        beginTest ("Real-time partitioned convolution");
+
+        auto& cache = Engine::getEngines()[0]->getImpulseResponseCache();
+        juce::Random r (43);
+
+        const auto irBuffer = createNoise (r, 2, 40000, 3.0f);
+        const auto ir = ImpulseResponseCache::createImpulseResponse (irBuffer, 44100.0, 44100.0, false, false);
+        const int blockSize = 512;
+
+        PartitionedConvolution convolution;
+        convolution.prepare ({ 44100.0, (juce::uint32) blockSize, 2 });
+        convolution.setImpulseResponse (cache, ir);
+
+        const int numSamples = 60000;
+        const auto input = createNoise (r, 2, numSamples);
+        auto output = input;
+
+        // The audio thread never waits for the tail, so this gives the worker time to keep
+        // up, as it would between callbacks
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            auto block = juce::dsp::AudioBlock<float> (output).getSubBlock ((size_t) start, (size_t) std::min (blockSize, numSamples - start));
+            convolution.process (juce::dsp::ProcessContextReplacing<float> (block));
+
+            const auto timeout = juce::Time::getMillisecondCounter() + 10000;
+
+            while (convolution.isComputingInBackground() && juce::Time::getMillisecondCounter() < timeout)
+                juce::Thread::sleep (1);
+
+            expect (! convolution.isComputingInBackground());
+        }
+
+        expectEquals (convolution.getNumLateBlocks(), 0);
+        expectMatchesDirectConvolution (irBuffer, input, output, "Real-time");
+    }
+
+    void runCrossfadeTests()
+    {
+        beginTest ("Crossfading impulse responses");
+
+        auto& cache = Engine::getEngines()[0]->getImpulseResponseCache();
+
+        auto createGain = [] (float gain)
+        {
+            juce::AudioBuffer<float> buffer (1, 1);
+            buffer.setSample (0, 0, gain);
+            return ImpulseResponseCache::createImpulseResponse (buffer, 44100.0, 44100.0, false, false);
+        };
+
+        const int blockSize = 512;
+        PartitionedConvolution convolution;
+        convolution.setNonRealtime (true);
+        convolution.prepare ({ 44100.0, (juce::uint32) blockSize, 1 });
+        convolution.setImpulseResponse (cache, createGain (1.0f));
+
+        juce::AudioBuffer<float> buffer (1, blockSize);
+        float lastSample = 1.0f, maxStep = 0.0f;
+
+        auto processBlocks = [&] (int numBlocks)
+        {
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                std::fill_n (buffer.getWritePointer (0), blockSize, 1.0f);
+                juce::dsp::AudioBlock<float> block (buffer);
+                convolution.process (juce::dsp::ProcessContextReplacing<float> (block));
+
+                for (int j = 0; j < blockSize; ++j)
+                {
+                    maxStep = std::max (maxStep, std::abs (buffer.getSample (0, j) - lastSample));
+                    lastSample = buffer.getSample (0, j);
+                }
+            }
+        };
+
+        processBlocks (10);
+        expectWithinAbsoluteError (lastSample, 1.0f, 1.0e-5f);
+        expectLessThan (maxStep, 1.0e-5f);
+
+        // Changing the IR whilst playing shouldn't jump straight to the new level
+        convolution.setImpulseResponse (cache, createGain (0.5f));
+        processBlocks (10);
+
+        expectLessThan (maxStep, 0.001f);
+        expectWithinAbsoluteError (lastSample, 0.5f, 1.0e-5f);
+    }
+
+    void runSharingTests()
+    {
+        beginTest ("Shared impulse responses");
+
+        auto& engine = *Engine::getEngines()[0];
+        auto& cache = engine.getImpulseResponseCache();
+        auto edit = test_utilities::createTestEdit (engine);
+        const auto numBefore = cache.getNumImpulseResponses();
+
+        juce::Random r (7);
+        const auto irBuffer = createNoise (r, 2, 20000, 4.0f);
+
+        auto createPlugin = [&]
+        {
+            juce::ReferenceCountedObjectPtr<ImpulseResponsePlugin> plugin (dynamic_cast<ImpulseResponsePlugin*> (edit->getPluginCache().createNewPlugin (ImpulseResponsePlugin::xmlTypeName, {}).get()));
+            auto buffer = irBuffer;
+            expect (plugin->loadImpulseResponse (std::move (buffer), 44100.0, 24));
+            return plugin;
+        };
+
+        {
+            auto plugin1 = createPlugin();
+            auto plugin2 = createPlugin();
+            expectEquals (cache.getNumImpulseResponses(), numBefore + 1);
+
+            for (auto p : { plugin1, plugin2 })
+            {
+                p->baseClassInitialise ({ TimePosition(), 44100.0, 512 });
+                expectEquals (p->getLatencySeconds(), 0.0);
+            }
+
+            expectEquals (cache.getNumImpulseResponses(), numBefore + 1);
+
+            // Different options need their own partitions, and the old ones are freed
+            // once nothing is using them
+            plugin2->normalise = false;
+            expectEquals (cache.getNumImpulseResponses(), numBefore + 2);
+
+            plugin1->normalise = false;
+            expectEquals (cache.getNumImpulseResponses(), numBefore + 1);
+
+            for (auto p : { plugin1, plugin2 })
+                p->baseClassDeinitialise();
+        }
+    }
+};
+
+static ImpulseResponseCacheTests impulseResponseCacheTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
@@ -56,8 +56,9 @@ void LowPassPlugin::updateFilters()
         auto c = nowLowPass ? juce::IIRCoefficients::makeLowPass  (sampleRate, newFreq)
                             : juce::IIRCoefficients::makeHighPass (sampleRate, newFreq);
 
-        filter[0].setCoefficients (c);
-        filter[1].setCoefficients (c);
+        // BEATCONNECT MODIFICATION START
+        filter.setCoefficients (0, c);
+        // BEATCONNECT MODIFICATION END
     }
 }
 
@@ -65,8 +66,9 @@ void LowPassPlugin::initialise (const PluginInitialisationInfo& info)
 {
     sampleRate = info.sampleRate;
 
-    for (int i = 0; i < numElementsInArray (filter); ++i)
-        filter[i].reset();
+    // BEATCONNECT MODIFICATION START
+    filter.reset();
+    // BEATCONNECT MODIFICATION END
 
     currentFilterFreq = 0;
     updateFilters();
@@ -86,8 +88,9 @@ void LowPassPlugin::applyToBuffer (const PluginRenderContext& fc)
 
         clearChannels (*fc.destBuffer, 2, -1, fc.bufferStartSample, fc.bufferNumSamples);
 
-        for (int i = std::min (2, fc.destBuffer->getNumChannels()); --i >= 0;)
-            filter[i].processSamples (fc.destBuffer->getWritePointer (i, fc.bufferStartSample), fc.bufferNumSamples);
+        // BEATCONNECT MODIFICATION START
+        filter.process (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+        // BEATCONNECT MODIFICATION END
 
         sanitiseValues (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples, 3.0f);
     }
@@ -47,7 +47,9 @@ public:
     AutomatableParameter::Ptr mode;
 
 private:
-    juce::IIRFilter filter[2];
+    // BEATCONNECT MODIFICATION START
+    effect_kernels::BiquadCascade filter;
+    // BEATCONNECT MODIFICATION END
     float currentFilterFreq = 0;
     bool isCurrentlyLowPass = false;
 
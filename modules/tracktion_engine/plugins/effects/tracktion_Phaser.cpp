@@ -52,7 +52,15 @@ const char* PhaserPlugin::uniqueId = "bb7d2f63-861a-433a-9559-48696bd38851";
 void PhaserPlugin::initialise (const PluginInitialisationInfo& info)
 {
     sampleRate = info.sampleRate;
-    std::memset (filterVals, 0, sizeof (filterVals));
+
+    // BEATCONNECT MODIFICATION START
+    for (auto& group : filterVals)
+        for (auto& v : group)
+            v = DoubleLanes::expand (0.0);
+
+    feedbackSmoother.reset (info.sampleRate, 0.05);
+    feedbackSmoother.setCurrentAndTargetValue (feedbackGain);
+    // BEATCONNECT MODIFICATION END
 
     const float delayMs = 100.0f;
     sweep = minSweep = (juce::MathConstants<double>::pi * delayMs) / sampleRate;
@@ -63,6 +71,10 @@ void PhaserPlugin::deinitialise()
 {
 }
 
+// BEATCONNECT MODIFICATION START
+// The sweep is the same for every channel, so the allpass coefficients are worked
+// out once per chunk and the channels then go through the allpass chain together,
+// one per SIMD lane.
 void PhaserPlugin::applyToBuffer (const PluginRenderContext& fc)
 {
     if (fc.destBuffer == nullptr)
@@ -70,6 +82,8 @@ void PhaserPlugin::applyToBuffer (const PluginRenderContext& fc)
 
     SCOPED_REALTIME_CHECK
 
+    using namespace effect_kernels;
+
     const double range = pow (2.0, (double) depth);
     const double sweepUp = pow (range, rate / (sampleRate / 2));
     const double sweepDown = 1.0 / sweepUp;
@@ -77,60 +91,92 @@ void PhaserPlugin::applyToBuffer (const PluginRenderContext& fc)
     const float delayMs = 100.0f;
     const float maxSweep = (float) ((juce::MathConstants<double>::pi * delayMs * range) / sampleRate);
 
-    double swpFactor = sweepFactor > 1.0 ? sweepUp : sweepDown;
-    double swp = sweep;
+    feedbackSmoother.setTargetValue (feedbackGain);
 
     clearChannels (*fc.destBuffer, 2, -1, fc.bufferStartSample, fc.bufferNumSamples);
 
-    for (int chan = std::min (2, fc.destBuffer->getNumChannels()); --chan >= 0;)
+    constexpr int lanesPerGroup = (int) DoubleLanes::SIMDNumElements;
+    const int numChannels = std::min (2, fc.destBuffer->getNumChannels());
+    auto channels = fc.destBuffer->getArrayOfWritePointers();
+
+    double coefs[laneBlockSize], feedbacks[laneBlockSize];
+    DoubleLanes frames[laneBlockSize];
+
+    for (int done = 0; done < fc.bufferNumSamples;)
     {
-        float* b = fc.destBuffer->getWritePointer (chan, fc.bufferStartSample);
-        swp = sweep;
-        swpFactor = sweepFactor;
+        const auto numThisTime = std::min (laneBlockSize, fc.bufferNumSamples - done);
+        const auto start = fc.bufferStartSample + done;
+
+        for (int i = 0; i < numThisTime; ++i)
+        {
+            coefs[i] = (1.0 - sweep) / (1.0 + sweep);
+            feedbacks[i] = feedbackSmoother.getNextValue();
+
+            sweep *= sweepFactor;
 
-        for (int i = fc.bufferNumSamples; --i >= 0;)
+            if (sweep > maxSweep)       sweepFactor = sweepDown;
+            else if (sweep < minSweep)  sweepFactor = sweepUp;
+        }
+
+        for (int group = 0; group * lanesPerGroup < numChannels; ++group)
         {
-            float inval = *b;
-            const double coef = (1.0 - swp) / (1.0 + swp);
-            double* const fv = filterVals[chan];
+            const auto firstChannel = group * lanesPerGroup;
+            const auto numChannelsInGroup = std::min (lanesPerGroup, numChannels - firstChannel);
+
+            interleave (frames, channels + firstChannel, numChannelsInGroup, start, numThisTime);
 
-            double t = inval + feedbackGain * fv[7];
+            auto* const fv = filterVals[group];
+            auto fv0 = fv[0], fv1 = fv[1], fv2 = fv[2], fv3 = fv[3],
+                 fv4 = fv[4], fv5 = fv[5], fv6 = fv[6], fv7 = fv[7];
 
-            JUCE_UNDENORMALISE (t);
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                const auto coef = DoubleLanes::expand (coefs[i]);
 
-            fv[1] = coef * (fv[1] + t) - fv[0];
-            JUCE_UNDENORMALISE (fv[1]);
-            fv[0] = t;
+                auto t = frames[i] + DoubleLanes::expand (feedbacks[i]) * fv7;
+                JUCE_UNDENORMALISE (t);
 
-            fv[3] = coef * (fv[3] + fv[1]) - fv[2];
-            JUCE_UNDENORMALISE (fv[3]);
-            fv[2] = fv[1];
+                fv1 = coef * (fv1 + t) - fv0;
+                JUCE_UNDENORMALISE (fv1);
+                fv0 = t;
 
-            fv[5] = coef * (fv[5] + fv[3]) - fv[4];
-            JUCE_UNDENORMALISE (fv[5]);
-            fv[4] = fv[3];
+                fv3 = coef * (fv3 + fv1) - fv2;
+                JUCE_UNDENORMALISE (fv3);
+                fv2 = fv1;
 
-            fv[7] = coef * (fv[7] + fv[5]) - fv[6];
-            JUCE_UNDENORMALISE (fv[7]);
-            fv[6] = fv[5];
+                fv5 = coef * (fv5 + fv3) - fv4;
+                JUCE_UNDENORMALISE (fv5);
+                fv4 = fv3;
 
-            inval += (float)fv[7];
-            JUCE_UNDENORMALISE (inval);
+                fv7 = coef * (fv7 + fv5) - fv6;
+                JUCE_UNDENORMALISE (fv7);
+                fv6 = fv5;
 
-            *b++ = inval;
+                frames[i] = fv7;
+            }
 
-            swp *= swpFactor;
+            fv[0] = fv0; fv[1] = fv1; fv[2] = fv2; fv[3] = fv3;
+            fv[4] = fv4; fv[5] = fv5; fv[6] = fv6; fv[7] = fv7;
 
-            if (swp > maxSweep)       swpFactor = sweepDown;
-            else if (swp < minSweep)  swpFactor = sweepUp;
+            for (int c = 0; c < numChannelsInGroup; ++c)
+            {
+                float* const b = channels[firstChannel + c] + start;
+
+                for (int i = 0; i < numThisTime; ++i)
+                {
+                    float inval = b[i] + (float) frames[i].get ((size_t) c);
+                    JUCE_UNDENORMALISE (inval);
+                    b[i] = inval;
+                }
+            }
         }
+
+        done += numThisTime;
     }
 
     zeroDenormalisedValuesIfNeeded (*fc.destBuffer);
-
-    sweep = swp;
-    sweepFactor = swpFactor;
 }
+// BEATCONNECT MODIFICATION END
 
 juce::String PhaserPlugin::getSelectableDescription()
 {
@@ -44,7 +44,13 @@ public:
 
 private:
     //==============================================================================
-    double filterVals[2][8];
+    // BEATCONNECT MODIFICATION START
+    using DoubleLanes = effect_kernels::Lanes<double>;
+    static constexpr int numLaneGroups = (2 + (int) DoubleLanes::SIMDNumElements - 1) / (int) DoubleLanes::SIMDNumElements;
+
+    DoubleLanes filterVals[numLaneGroups][8];
+    juce::SmoothedValue<float> feedbackSmoother;
+    // BEATCONNECT MODIFICATION END
     double sweep = 0.0, sweepFactor = 0.0, minSweep = 0.0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PhaserPlugin)
@@ -579,8 +579,23 @@ void ExternalPlugin::initialiseFully()
         CRASH_TRACER_PLUGIN (getDebugName());
         fullyInitialised = true;
 
+        // BEATCONNECT MODIFICATION START
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+        loadTime = {};
+
         doFullInitialisation();
         restorePluginStateFromValueTree (state);
+
+        if (pluginInstance != nullptr)
+        {
+            loadTime.name = desc.name;
+            loadTime.identifier = identiferString;
+            loadTime.itemID = itemID;
+            loadTime.blockingSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+            engine.getPluginManager().getInstancePool().addLoadTime (loadTime);
+        }
+        // BEATCONNECT MODIFICATION END
+
         buildParameterList();
         restoreChannelLayout (*this);
     }
@@ -834,11 +849,18 @@ void ExternalPlugin::doFullInitialisation()
             CRASH_TRACER_PLUGIN (getDebugName());
             loadError = {};
 
-            callBlocking ([this, &foundDesc]
+            // BEATCONNECT MODIFICATION START
+            auto loadInstance = [this, &foundDesc]
             {
                 CRASH_TRACER_PLUGIN (getDebugName());
                 loadError = createPluginInstance (*foundDesc);
-            });
+            };
+
+            if (engine.getEngineBehaviour().canLoadPluginOffMessageThread (*foundDesc))
+                loadInstance();
+            else
+                callBlocking (loadInstance);
+            // BEATCONNECT MODIFICATION END
 
             if (pluginInstance != nullptr)
             {
@@ -964,38 +986,38 @@ void ExternalPlugin::flushBusesLayoutToValueTree()
 
 void ExternalPlugin::restorePluginStateFromValueTree (const juce::ValueTree& v)
 {
-    juce::String s;
-
-    if (v.hasProperty (IDs::state))
-    {
-        s = v.getProperty (IDs::state).toString();
-    }
-    else
-    {
-        auto vstDataTree = v.getChildWithName (IDs::VSTDATA);
-
-        if (vstDataTree.isValid())
-        {
-            s = vstDataTree.getProperty (IDs::DATA).toString();
-
-            if (s.isEmpty())
-                s = vstDataTree.getProperty (IDs::__TEXT).toString();
-        }
-    }
+    // BEATCONNECT MODIFICATION START
+    auto s = PluginInstancePool::getPluginStateString (v);
+    const auto stateAlreadyRestoredHash = std::exchange (poolRestoredStateHash, 0);
 
     if (pluginInstance != nullptr && s.isNotEmpty())
     {
         CRASH_TRACER_PLUGIN (getDebugName());
 
+        // The pool has already loaded this state on a background thread
+        if (stateAlreadyRestoredHash != 0 && stateAlreadyRestoredHash == PluginInstancePool::getStateHash (v))
+            return;
+
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
         if (getNumPrograms() > 1)
             setCurrentProgram (v.getProperty (IDs::programNum), false);
 
-        juce::MemoryBlock chunk;
-        chunk.fromBase64Encoding (s);
+        auto chunk = engine.getPluginManager().getInstancePool().getStateChunk (s);
 
-        if (chunk.getSize() > 0)
-            callBlocking ([this, &chunk]() { pluginInstance->setStateInformation (chunk.getData(), (int) chunk.getSize()); });
+        if (chunk != nullptr && chunk->getSize() > 0)
+        {
+            auto setState = [this, &chunk]() { pluginInstance->setStateInformation (chunk->getData(), (int) chunk->getSize()); };
+
+            if (engine.getEngineBehaviour().canLoadPluginOffMessageThread (desc))
+                setState();
+            else
+                callBlocking (setState);
+        }
+
+        loadTime.stateRestoreSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
     }
+    // BEATCONNECT MODIFICATION END
 }
 
 void ExternalPlugin::getPluginStateFromTree (juce::MemoryBlock& mb)
@@ -1707,7 +1729,16 @@ juce::String ExternalPlugin::createPluginInstance (const juce::PluginDescription
     auto& dm = engine.getDeviceManager();
 
     juce::String error;
-    pluginInstance = engine.getPluginManager().createPluginInstance (description, dm.getSampleRate(), dm.getBlockSize(), error);
+    // BEATCONNECT MODIFICATION START
+    auto acquired = engine.getPluginManager().getInstancePool().acquire (description, dm.getSampleRate(), dm.getBlockSize(),
+                                                                         PluginInstancePool::getStateHash (state),
+                                                                         &edit, error);
+    pluginInstance = std::move (acquired.instance);
+    poolRestoredStateHash = acquired.restoredStateHash;
+    loadTime.wasPooled = acquired.wasPooled;
+    loadTime.instantiationSeconds = acquired.instantiationSeconds;
+    loadTime.stateRestoreSeconds = acquired.stateRestoreSeconds;
+    // BEATCONNECT MODIFICATION END
 
     if (pluginInstance != nullptr)
     {
@@ -1721,7 +1752,19 @@ juce::String ExternalPlugin::createPluginInstance (const juce::PluginDescription
 void ExternalPlugin::deletePluginInstance()
 {
     processorChangedManager.reset();
-    AsyncPluginDeleter::getInstance()->deletePlugin (pluginInstance.release());
+    // BEATCONNECT MODIFICATION START
+    poolRestoredStateHash = 0;
+
+    if (pluginInstance != nullptr)
+    {
+       #if JUCE_PLUGINHOST_VST
+        juce::VSTPluginFormat::setExtraFunctions (pluginInstance.get(), nullptr);
+       #endif
+        pluginInstance->setPlayHead (nullptr);
+    }
+
+    engine.getPluginManager().getInstancePool().release (desc, std::move (pluginInstance));
+    // BEATCONNECT MODIFICATION END
 }
 
 //==============================================================================
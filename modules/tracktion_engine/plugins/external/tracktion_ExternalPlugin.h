@@ -157,6 +157,11 @@ private:
 
     bool fullyInitialised = false, supportsMPE = false, isFlushingLayoutToState = false;
 
+    // BEATCONNECT MODIFICATION START
+    PluginInstancePool::LoadTime loadTime;
+    HashCode poolRestoredStateHash = 0;
+    // BEATCONNECT MODIFICATION END
+
     struct MPEChannelRemapper;
     std::unique_ptr<MPEChannelRemapper> mpeRemapper;
 
@@ -16,6 +16,10 @@ LevelMeterPlugin::LevelMeterPlugin (PluginCreationInfo info)  : Plugin (info)
     showMidiActivity.referTo (state, IDs::showMidi, getUndoManager());
 
     measurer.setShowMidi (showMidiActivity);
+
+    // BEATCONNECT MODIFICATION START
+    measurer.setFreezeRequests (&engine.getDeviceManager().getOverloadPolicy().getMeterFreezeRequests());
+    // BEATCONNECT MODIFICATION END
 }
 
 LevelMeterPlugin::~LevelMeterPlugin()
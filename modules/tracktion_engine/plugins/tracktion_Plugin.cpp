@@ -71,6 +71,10 @@ Plugin::Plugin (PluginCreationInfo info)
       engine (info.edit.engine),
       state (info.state)
 {
+    // BEATCONNECT MODIFICATION START
+    edit.pluginItemCache.addItem (*this);
+    // BEATCONNECT MODIFICATION END
+
     isClipEffect = state.getParent().hasType (IDs::EFFECT);
     windowState = std::make_unique<WindowState> (*this);
 
@@ -92,6 +96,9 @@ Plugin::Plugin (PluginCreationInfo info)
     quickParamName.referTo (state, IDs::quickParamName, um);
     masterPluginID.referTo (state, IDs::masterPluginID, um);
     sidechainSourceID.referTo (state, IDs::sidechainSourceID, um);
+    // BEATCONNECT MODIFICATION START
+    nonEssential.referTo (state, IDs::nonEssential, um);
+    // BEATCONNECT MODIFICATION END
 
     state.addListener (this);
 
@@ -120,6 +127,10 @@ Plugin::Plugin (PluginCreationInfo info)
 Plugin::~Plugin()
 {
     CRASH_TRACER
+    // BEATCONNECT MODIFICATION START
+    edit.pluginItemCache.removeItem (*this);
+    // BEATCONNECT MODIFICATION END
+
     windowState->hideWindowForShutdown();
 
    #if TRACKTION_ENABLE_AUTOMAP && TRACKTION_ENABLE_CONTROL_SURFACES
@@ -164,6 +164,26 @@ public:
     void setProcessingEnabled (bool p)                      { processing = p; }
     bool isProcessingEnabled() const noexcept               { return processing; }
 
+    // BEATCONNECT MODIFICATION START
+    /** Flags the plugin as one that can be bypassed by the OverloadPolicy if the CPU is overloaded. */
+    void setNonEssential (bool isNonEssential)              { nonEssential = isNonEssential; }
+    bool isNonEssential() const noexcept                    { return nonEssential; }
+
+    /** Temporarily bypasses the plugin during playback, without changing its enabled state.
+        This is used by the OverloadPolicy to shed non-essential plugins and is ignored when rendering.
+    */
+    void setBypassedForOverload (bool b) noexcept           { bypassedForOverload = b; }
+    bool isBypassedForOverload() const noexcept             { return bypassedForOverload.load (std::memory_order_relaxed); }
+
+    /** Returns true if the AutoFreezeManager has rendered this plugin in to its track's freeze file.
+        Like frozen plugins, these are left out of the playback graph, but this isn't saved with the Edit.
+    */
+    bool isAutoFrozen() const noexcept                      { return autoFrozen; }
+
+    /** @internal */
+    void setAutoFrozen (bool b) noexcept                    { autoFrozen = b; }
+    // BEATCONNECT MODIFICATION END
+
     //==============================================================================
     /** Gives the plugin a chance to set itself up before being played.
 
@@ -387,6 +407,9 @@ protected:
     juce::CachedValue<bool> enabled, frozen, processing;
     juce::CachedValue<juce::String> quickParamName;
     juce::CachedValue<EditItemID> masterPluginID, sidechainSourceID;
+    // BEATCONNECT MODIFICATION START
+    juce::CachedValue<bool> nonEssential;
+    // BEATCONNECT MODIFICATION END
 
     double sampleRate = 44100.0;
     int blockSizeSamples = 512;
@@ -417,6 +440,10 @@ private:
     double timeToCpuScale = 0;
     std::atomic<double> cpuUsageMs { 0 };
     std::atomic<bool> isClipEffect { false };
+    // BEATCONNECT MODIFICATION START
+    std::atomic<bool> bypassedForOverload { false };
+    bool autoFrozen = false;
+    // BEATCONNECT MODIFICATION END
 
     juce::ValueTree getConnectionsTree();
     struct WireList;
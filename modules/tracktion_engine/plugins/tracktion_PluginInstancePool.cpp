@@ -0,0 +1,573 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace
+{
+    constexpr size_t maxNumLoadTimes = 4096;
+
+    double getSecondsSince (double startTimeMs)
+    {
+        return (juce::Time::getMillisecondCounterHiRes() - startTimeMs) / 1000.0;
+    }
+}
+
+//==============================================================================
+PluginInstancePool::PluginInstancePool (Engine& e)
+    : engine (e)
+{
+}
+
+PluginInstancePool::~PluginInstancePool()
+{
+    clear();
+}
+
+//==============================================================================
+void PluginInstancePool::prewarm (const juce::PluginDescription& description, int numInstances)
+{
+    CRASH_TRACER
+
+    PluginToLoad plugin;
+    plugin.description = description;
+    plugin.shouldCreateInstance = true;
+
+    std::vector<PluginToLoad> plugins ((size_t) std::max (0, numInstances), plugin);
+
+    if (canLoadOffMessageThread (description))
+    {
+        loadPlugins (plugins, nullptr);
+        return;
+    }
+
+    callBlocking ([this, &plugins]
+    {
+        auto& dm = engine.getDeviceManager();
+
+        for (auto& p : plugins)
+        {
+            juce::String error;
+            auto pooled = createInstance (p, dm.getSampleRate(), dm.getBlockSize(), true, error);
+
+            if (pooled.instance == nullptr)
+            {
+                TRACKTION_LOG_ERROR (error);
+                break;
+            }
+
+            addToPool (p.description, std::move (pooled));
+        }
+    });
+}
+
+void PluginInstancePool::prepareForEdit (const juce::ValueTree& editState, const Edit& edit)
+{
+    CRASH_TRACER
+    auto& pm = engine.getPluginManager();
+    auto& eb = engine.getEngineBehaviour();
+    const auto knownTypes = pm.knownPluginList.getTypes();
+
+    // This only looks for an exact match of the file or identifier, any others will be loaded
+    // as normal by the ExternalPlugin when it's created
+    auto findDescription = [&knownTypes] (const juce::ValueTree& v) -> const juce::PluginDescription*
+    {
+        const auto fileOrID = v[IDs::filename].toString();
+        const auto uid = (int) v[IDs::uniqueId].toString().getHexValue64();
+
+        if (fileOrID.isNotEmpty())
+            for (auto& d : knownTypes)
+                if (d.fileOrIdentifier == fileOrID && (uid == 0 || d.uniqueId == uid))
+                    return &d;
+
+        return nullptr;
+    };
+
+    std::vector<PluginToLoad> plugins;
+    bool anyToCreate = false;
+
+    std::function<void (const juce::ValueTree&)> findPlugins = [&] (const juce::ValueTree& v)
+    {
+        for (auto child : v)
+        {
+            if (child.hasType (IDs::PLUGIN) && child[IDs::type].toString() == ExternalPlugin::xmlTypeName)
+            {
+                if (auto desc = findDescription (child))
+                {
+                    if (eb.isPluginDisabled (createIdentifierString (*desc)))
+                        continue;
+
+                    PluginToLoad p;
+                    p.description = *desc;
+                    p.stateString = getPluginStateString (child);
+                    p.programNum = child[IDs::programNum];
+                    p.stateHash = getStateHash (child);
+                    p.shouldCreateInstance = canLoadOffMessageThread (*desc);
+
+                    anyToCreate = anyToCreate || p.shouldCreateInstance;
+
+                    if (p.shouldCreateInstance || p.stateString.isNotEmpty())
+                        plugins.push_back (std::move (p));
+                }
+
+                continue;
+            }
+
+            findPlugins (child);
+        }
+    };
+
+    findPlugins (editState);
+
+    // If nothing can be created here, the plugins will load as normal when the Edit creates them
+    if (anyToCreate)
+        loadPlugins (plugins, &edit);
+}
+
+void PluginInstancePool::loadPlugins (const std::vector<PluginToLoad>& plugins, const Edit* edit)
+{
+    auto& dm = engine.getDeviceManager();
+    const auto sampleRate = dm.getSampleRate();
+    const auto blockSize = dm.getBlockSize();
+    std::atomic<size_t> nextIndex { 0 };
+
+    // Plugins that have to be created on the message thread still have their
+    // state chunks decoded here so they're ready in the cache when they load
+    auto loadNext = [&]
+    {
+        for (;;)
+        {
+            const auto index = nextIndex++;
+
+            if (index >= plugins.size())
+                return;
+
+            auto& p = plugins[index];
+
+            if (! p.shouldCreateInstance)
+            {
+                getStateChunk (p.stateString);
+                continue;
+            }
+
+            juce::String error;
+            const bool canBeReset = p.stateString.isEmpty() || getMaxNumPooledInstances (p.description) > 0;
+            auto pooled = createInstance (p, sampleRate, blockSize, canBeReset, error);
+
+            if (pooled.instance != nullptr)
+            {
+                if (pooled.restoredStateHash != 0)
+                    pooled.edit = edit;
+
+                addToPool (p.description, std::move (pooled));
+            }
+            else
+                TRACKTION_LOG_ERROR (error);
+        }
+    };
+
+    struct LoadJob  : public juce::ThreadPoolJob
+    {
+        LoadJob (std::function<void()> f)   : juce::ThreadPoolJob ("Load Plugins"), load (std::move (f)) {}
+        JobStatus runJob() override         { load(); return jobHasFinished; }
+
+        std::function<void()> load;
+    };
+
+    const auto numToCreate = (int) std::count_if (plugins.begin(), plugins.end(), [] (auto& p) { return p.shouldCreateInstance; });
+    auto& pool = engine.getBackgroundJobs().getPool();
+    std::vector<std::unique_ptr<LoadJob>> jobs;
+
+    for (int i = 1; i < std::min (numToCreate, pool.getNumThreads() + 1); ++i)
+    {
+        jobs.push_back (std::make_unique<LoadJob> (loadNext));
+        pool.addJob (jobs.back().get(), false);
+    }
+
+    // This thread takes part too, so if the pool is busy the plugins still get loaded.
+    // Jobs that haven't started by the time it's finished are removed without running.
+    loadNext();
+
+    for (auto& job : jobs)
+        pool.removeJob (job.get(), false, -1);
+}
+
+void PluginInstancePool::removeUnusedPreparedInstances (const Edit& edit)
+{
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> toDelete;
+
+    {
+        const std::lock_guard<std::mutex> sl (poolMutex);
+
+        for (auto& [key, instances] : pooledInstances)
+        {
+            for (auto iter = instances.begin(); iter != instances.end();)
+            {
+                if (iter->restoredStateHash != 0 && iter->edit == &edit)
+                {
+                    toDelete.push_back (std::move (iter->instance));
+                    iter = instances.erase (iter);
+                }
+                else
+                {
+                    ++iter;
+                }
+            }
+        }
+    }
+
+    for (auto& instance : toDelete)
+        deleteInstance (std::move (instance));
+}
+
+void PluginInstancePool::clear()
+{
+    decltype (pooledInstances) toDelete;
+
+    {
+        const std::lock_guard<std::mutex> sl (poolMutex);
+        std::swap (toDelete, pooledInstances);
+    }
+
+    for (auto& [key, instances] : toDelete)
+        for (auto& p : instances)
+            deleteInstance (std::move (p.instance));
+}
+
+//==============================================================================
+PluginInstancePool::AcquiredInstance PluginInstancePool::acquire (const juce::PluginDescription& description,
+                                                                  double sampleRate, int blockSize,
+                                                                  HashCode stateHash, const Edit* edit,
+                                                                  juce::String& errorMessage)
+{
+    {
+        const std::lock_guard<std::mutex> sl (poolMutex);
+        auto found = pooledInstances.find (description.createIdentifierString());
+
+        if (found != pooledInstances.end())
+        {
+            auto& instances = found->second;
+
+            // Instances restored for another Edit are left for that Edit to use
+            auto iter = std::find_if (instances.begin(), instances.end(),
+                                      [stateHash, edit] (auto& p) { return stateHash != 0 && p.restoredStateHash == stateHash
+                                                                              && p.edit == edit; });
+
+            if (iter == instances.end())
+                iter = std::find_if (instances.begin(), instances.end(),
+                                     [] (auto& p) { return p.restoredStateHash == 0; });
+
+            if (iter != instances.end())
+            {
+                AcquiredInstance acquired;
+                acquired.instance = std::move (iter->instance);
+                acquired.restoredStateHash = iter->restoredStateHash;
+                acquired.wasPooled = true;
+                acquired.instantiationSeconds = iter->instantiationSeconds;
+                acquired.stateRestoreSeconds = iter->stateRestoreSeconds;
+                instances.erase (iter);
+
+                return acquired;
+            }
+        }
+    }
+
+    PluginToLoad p;
+    p.description = description;
+
+    const bool canBeReset = getMaxNumPooledInstances (description) > 0;
+    auto created = createInstance (p, sampleRate, blockSize, canBeReset, errorMessage);
+
+    AcquiredInstance acquired;
+    acquired.instance = std::move (created.instance);
+    acquired.instantiationSeconds = created.instantiationSeconds;
+
+    return acquired;
+}
+
+void PluginInstancePool::release (const juce::PluginDescription& description,
+                                  std::unique_ptr<juce::AudioPluginInstance> instance)
+{
+    if (instance == nullptr)
+        return;
+
+    const bool canReset = juce::MessageManager::existsAndIsCurrentThread()
+                            || canLoadOffMessageThread (description);
+
+    if (canReset
+        && getNumPooledInstances (description) < getMaxNumPooledInstances (description)
+        && resetInstance (*instance))
+    {
+        PooledInstance pooled;
+        pooled.instance = std::move (instance);
+        addToPool (description, std::move (pooled));
+        return;
+    }
+
+    deleteInstance (std::move (instance));
+}
+
+int PluginInstancePool::getNumPooledInstances (const juce::PluginDescription& description) const
+{
+    const std::lock_guard<std::mutex> sl (poolMutex);
+    auto found = pooledInstances.find (description.createIdentifierString());
+
+    if (found == pooledInstances.end())
+        return 0;
+
+    return (int) found->second.size();
+}
+
+//==============================================================================
+bool PluginInstancePool::canLoadOffMessageThread (const juce::PluginDescription& description)
+{
+    return engine.getEngineBehaviour().canLoadPluginOffMessageThread (description);
+}
+
+int PluginInstancePool::getMaxNumPooledInstances (const juce::PluginDescription& description)
+{
+    return engine.getEngineBehaviour().getMaxNumPooledPluginInstances (description);
+}
+
+//==============================================================================
+PluginInstancePool::PooledInstance PluginInstancePool::createInstance (const PluginToLoad& p,
+                                                                       double sampleRate, int blockSize,
+                                                                       bool canBeReset, juce::String& errorMessage)
+{
+    CRASH_TRACER
+    PooledInstance pooled;
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    pooled.instance = engine.getPluginManager().createPluginInstance (p.description, sampleRate, blockSize, errorMessage);
+    pooled.instantiationSeconds = getSecondsSince (startTime);
+
+    if (pooled.instance == nullptr)
+        return pooled;
+
+    pooled.instance->enableAllBuses();
+
+    if (canBeReset)
+    {
+        DefaultState defaultState;
+        pooled.instance->getStateInformation (defaultState.state);
+        defaultState.layout = pooled.instance->getBusesLayout();
+
+        const std::lock_guard<std::mutex> sl (poolMutex);
+        defaultStates[pooled.instance.get()] = std::move (defaultState);
+    }
+
+    if (p.stateString.isNotEmpty())
+    {
+        const auto restoreStartTime = juce::Time::getMillisecondCounterHiRes();
+
+        // N.B. This needs to match the order of ExternalPlugin::restorePluginStateFromValueTree
+        if (pooled.instance->getNumPrograms() > 1)
+            pooled.instance->setCurrentProgram (juce::jlimit (0, pooled.instance->getNumPrograms() - 1, p.programNum));
+
+        if (auto chunk = getStateChunk (p.stateString); chunk != nullptr && chunk->getSize() > 0)
+            pooled.instance->setStateInformation (chunk->getData(), (int) chunk->getSize());
+
+        pooled.restoredStateHash = p.stateHash;
+        pooled.stateRestoreSeconds = getSecondsSince (restoreStartTime);
+    }
+
+    return pooled;
+}
+
+void PluginInstancePool::addToPool (const juce::PluginDescription& description, PooledInstance pooled)
+{
+    jassert (pooled.instance != nullptr);
+    const std::lock_guard<std::mutex> sl (poolMutex);
+    pooledInstances[description.createIdentifierString()].push_back (std::move (pooled));
+}
+
+bool PluginInstancePool::resetInstance (juce::AudioPluginInstance& instance)
+{
+    CRASH_TRACER
+    DefaultState defaultState;
+
+    {
+        const std::lock_guard<std::mutex> sl (poolMutex);
+        auto found = defaultStates.find (&instance);
+
+        // Instances that weren't created by the pool can't be reset
+        if (found == defaultStates.end())
+            return false;
+
+        defaultState = found->second;
+    }
+
+    instance.setPlayHead (nullptr);
+    instance.releaseResources();
+
+    if (! instance.setBusesLayout (defaultState.layout))
+        return false;
+
+    instance.setStateInformation (defaultState.state.getData(), (int) defaultState.state.getSize());
+    instance.reset();
+
+    return true;
+}
+
+void PluginInstancePool::deleteInstance (std::unique_ptr<juce::AudioPluginInstance> instance)
+{
+    if (instance == nullptr)
+        return;
+
+    {
+        const std::lock_guard<std::mutex> sl (poolMutex);
+        defaultStates.erase (instance.get());
+    }
+
+    AsyncPluginDeleter::getInstance()->deletePlugin (instance.release());
+}
+
+//==============================================================================
+juce::String PluginInstancePool::getPluginStateString (const juce::ValueTree& v)
+{
+    if (v.hasProperty (IDs::state))
+        return v.getProperty (IDs::state).toString();
+
+    auto vstDataTree = v.getChildWithName (IDs::VSTDATA);
+
+    if (vstDataTree.isValid())
+    {
+        auto s = vstDataTree.getProperty (IDs::DATA).toString();
+
+        if (s.isEmpty())
+            s = vstDataTree.getProperty (IDs::__TEXT).toString();
+
+        return s;
+    }
+
+    return {};
+}
+
+HashCode PluginInstancePool::getStateHash (const juce::ValueTree& pluginState)
+{
+    auto s = getPluginStateString (pluginState);
+
+    if (s.isEmpty())
+        return 0;
+
+    const auto programNum = (int) pluginState[IDs::programNum];
+    const auto hash = (HashCode) ((uint64_t) s.hashCode64() * 31u + (uint64_t) programNum);
+
+    return hash != 0 ? hash : 1;
+}
+
+std::shared_ptr<const juce::MemoryBlock> PluginInstancePool::getStateChunk (const juce::String& base64State)
+{
+    if (base64State.isEmpty())
+        return {};
+
+    const auto hash = base64State.hashCode64();
+
+    {
+        const std::lock_guard<std::mutex> sl (chunkCacheMutex);
+        auto found = chunkCacheIndex.find (hash);
+
+        if (found != chunkCacheIndex.end())
+        {
+            chunkCache.splice (chunkCache.begin(), chunkCache, found->second);
+            return chunkCache.front().chunk;
+        }
+    }
+
+    auto chunk = std::make_shared<juce::MemoryBlock>();
+    chunk->fromBase64Encoding (base64State);
+
+    const std::lock_guard<std::mutex> sl (chunkCacheMutex);
+
+    // Another thread may have decoded the same chunk in the meantime
+    if (chunkCacheIndex.find (hash) == chunkCacheIndex.end())
+    {
+        chunkCache.push_front ({ hash, chunk });
+        chunkCacheIndex[hash] = chunkCache.begin();
+        chunkCacheSize += chunk->getSize();
+        trimChunkCache();
+    }
+
+    return chunk;
+}
+
+void PluginInstancePool::setMaxStateCacheSize (size_t numBytes)
+{
+    const std::lock_guard<std::mutex> sl (chunkCacheMutex);
+    maxChunkCacheSize = numBytes;
+    trimChunkCache();
+}
+
+void PluginInstancePool::trimChunkCache()
+{
+    while (chunkCacheSize > maxChunkCacheSize && ! chunkCache.empty())
+    {
+        auto& last = chunkCache.back();
+        chunkCacheSize -= last.chunk->getSize();
+        chunkCacheIndex.erase (last.hash);
+        chunkCache.pop_back();
+    }
+}
+
+//==============================================================================
+void PluginInstancePool::addLoadTime (LoadTime loadTime)
+{
+    const std::lock_guard<std::mutex> sl (loadTimesMutex);
+    loadTimes.push_back (std::move (loadTime));
+
+    while (loadTimes.size() > maxNumLoadTimes)
+        loadTimes.pop_front();
+}
+
+std::vector<PluginInstancePool::LoadTime> PluginInstancePool::getLoadTimes() const
+{
+    const std::lock_guard<std::mutex> sl (loadTimesMutex);
+    return { loadTimes.begin(), loadTimes.end() };
+}
+
+juce::String PluginInstancePool::getLoadTimeReport() const
+{
+    auto times = getLoadTimes();
+
+    std::sort (times.begin(), times.end(),
+               [] (auto& a, auto& b) { return a.blockingSeconds > b.blockingSeconds; });
+
+    auto formatMs = [] (double seconds) { return juce::String (seconds * 1000.0, 1) + " ms"; };
+
+    juce::String report;
+    double totalBlockingSeconds = 0.0;
+    int numPooled = 0;
+
+    for (auto& t : times)
+    {
+        report << t.name << " (" << t.identifier << "): "
+               << "blocked " << formatMs (t.blockingSeconds)
+               << ", instantiation " << formatMs (t.instantiationSeconds)
+               << ", state restore " << formatMs (t.stateRestoreSeconds)
+               << (t.wasPooled ? ", pooled" : "") << juce::newLine;
+
+        totalBlockingSeconds += t.blockingSeconds;
+        numPooled += t.wasPooled ? 1 : 0;
+    }
+
+    report << "Total: " << (int) times.size() << " plugins, " << numPooled << " pooled, "
+           << "blocked " << formatMs (totalBlockingSeconds) << juce::newLine;
+
+    return report;
+}
+
+void PluginInstancePool::clearLoadTimes()
+{
+    const std::lock_guard<std::mutex> sl (loadTimesMutex);
+    loadTimes.clear();
+}
+
+}} // namespace tracktion { inline namespace engine
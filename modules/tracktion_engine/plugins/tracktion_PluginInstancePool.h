@@ -0,0 +1,200 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+/**
+    Keeps a pool of ready-to-use juce::AudioPluginInstances to speed up opening Edits.
+
+    Instances are keyed by their PluginDescription and can be in one of two states:
+     - reset: the plugin is in the state it was in when it was first created. These are
+       created by prewarm() or are kept when an ExternalPlugin is deleted, up to the limit
+       given by EngineBehaviour::getMaxNumPooledPluginInstances().
+     - restored: the plugin has already had a specific state chunk applied to it. These are
+       created by prepareForEdit() which loads all the plugins in an Edit that
+       EngineBehaviour::canLoadPluginOffMessageThread() allows, in parallel.
+       Restored instances belong to the Edit instance they were prepared for, so several
+       Edits can be loading at once, even unsaved ones that share the same ProjectItemID,
+       without using or removing each other's instances.
+
+    ExternalPlugins will use an instance from the pool if there is one, and skip restoring
+    their state if the pooled instance already has it.
+
+    This also keeps a cache of decoded plugin state chunks and a log of how long each
+    plugin took to load.
+
+    There's a single instance of this owned by the PluginManager.
+*/
+class PluginInstancePool
+{
+public:
+    PluginInstancePool (Engine&);
+    virtual ~PluginInstancePool();
+
+    //==============================================================================
+    /** Creates a number of reset instances of a plugin and adds them to the pool.
+        If the plugin can't be loaded off the message thread this will block whilst they're
+        created on the message thread.
+    */
+    void prewarm (const juce::PluginDescription&, int numInstances);
+
+    /** Finds all the external plugins in an Edit's state which can be loaded off the message
+        thread and creates them, restoring their states, in parallel on the Engine's
+        background job pool. This blocks until they've all been loaded.
+        If none of the plugins can be loaded off the message thread this does nothing.
+        The instances will only be returned from acquire() calls for the same Edit.
+    */
+    void prepareForEdit (const juce::ValueTree& editState, const Edit&);
+
+    /** Removes any instances with restored states that were prepared for an Edit but weren't used.
+        Call this once the Edit has finished loading.
+    */
+    void removeUnusedPreparedInstances (const Edit&);
+
+    /** Deletes all the instances in the pool. */
+    void clear();
+
+    //==============================================================================
+    /** Describes an instance returned from acquire(). */
+    struct AcquiredInstance
+    {
+        std::unique_ptr<juce::AudioPluginInstance> instance;
+        HashCode restoredStateHash = 0;         /**< If non-zero, the hash of the state that has already been restored. */
+        bool wasPooled = false;                 /**< True if the instance came from the pool. */
+        double instantiationSeconds = 0.0;      /**< The time it took to create the instance. */
+        double stateRestoreSeconds = 0.0;       /**< The time it took to restore the state, if it was restored in the pool. */
+    };
+
+    /** Returns an instance of a plugin, creating one if there isn't a suitable one in the pool.
+        This will prefer an instance prepared for the given Edit with the state hash already
+        restored, then a reset instance, before creating a new one with
+        PluginManager::createPluginInstance.
+    */
+    AcquiredInstance acquire (const juce::PluginDescription&, double sampleRate, int blockSize,
+                              HashCode stateHash, const Edit*, juce::String& errorMessage);
+
+    /** Returns an instance to the pool.
+        If the pool is full or the instance can't be reset, it will be deleted asynchronously.
+    */
+    void release (const juce::PluginDescription&, std::unique_ptr<juce::AudioPluginInstance>);
+
+    /** Returns the number of idle instances in the pool for a plugin. */
+    int getNumPooledInstances (const juce::PluginDescription&) const;
+
+    //==============================================================================
+    /** Returns the base64 encoded state string stored in an ExternalPlugin's state. */
+    static juce::String getPluginStateString (const juce::ValueTree& pluginState);
+
+    /** Returns a hash identifying the state and program of an ExternalPlugin's state, or 0 if it has no state. */
+    static HashCode getStateHash (const juce::ValueTree& pluginState);
+
+    /** Returns the decoded state chunk for a base64 encoded state string.
+        This caches recently used chunks so Edits with the same plugin states, or
+        plugins that are re-initialised, don't have to decode them again.
+    */
+    std::shared_ptr<const juce::MemoryBlock> getStateChunk (const juce::String& base64State);
+
+    /** Sets the maximum number of bytes of decoded state chunks to keep. */
+    void setMaxStateCacheSize (size_t numBytes);
+
+    //==============================================================================
+    /** The time taken to load a single plugin. */
+    struct LoadTime
+    {
+        juce::String name, identifier;
+        EditItemID itemID;
+        double instantiationSeconds = 0.0;  /**< The time taken to create the instance, possibly on a background thread. */
+        double stateRestoreSeconds = 0.0;   /**< The time taken to restore the state, possibly on a background thread. */
+        double blockingSeconds = 0.0;       /**< The time the thread initialising the plugin was blocked for. */
+        bool wasPooled = false;             /**< True if the instance came from the pool. */
+    };
+
+    /** Adds an entry to the load time log. Called by ExternalPlugin when it's initialised. */
+    void addLoadTime (LoadTime);
+
+    /** Returns the most recent load times. */
+    std::vector<LoadTime> getLoadTimes() const;
+
+    /** Returns a human readable summary of the load times, slowest first. */
+    juce::String getLoadTimeReport() const;
+
+    /** Clears the load time log. */
+    void clearLoadTimes();
+
+protected:
+    //==============================================================================
+    /** Returns true if instances of a plugin can be created and reset off the message thread.
+        By default this calls EngineBehaviour::canLoadPluginOffMessageThread().
+    */
+    virtual bool canLoadOffMessageThread (const juce::PluginDescription&);
+
+    /** Returns the maximum number of reset instances of a plugin to keep.
+        By default this calls EngineBehaviour::getMaxNumPooledPluginInstances().
+    */
+    virtual int getMaxNumPooledInstances (const juce::PluginDescription&);
+
+private:
+    //==============================================================================
+    struct PooledInstance
+    {
+        std::unique_ptr<juce::AudioPluginInstance> instance;
+        HashCode restoredStateHash = 0;
+        const Edit* edit = nullptr;     // The Edit a restored instance was prepared for
+        double instantiationSeconds = 0.0, stateRestoreSeconds = 0.0;
+    };
+
+    struct DefaultState
+    {
+        juce::MemoryBlock state;
+        juce::AudioProcessor::BusesLayout layout;
+    };
+
+    struct CachedChunk
+    {
+        HashCode hash = 0;
+        std::shared_ptr<const juce::MemoryBlock> chunk;
+    };
+
+    struct PluginToLoad
+    {
+        juce::PluginDescription description;
+        juce::String stateString;
+        int programNum = 0;
+        HashCode stateHash = 0;
+        bool shouldCreateInstance = false;
+    };
+
+    Engine& engine;
+
+    mutable std::mutex poolMutex;
+    std::map<juce::String, std::vector<PooledInstance>> pooledInstances;
+    std::map<juce::AudioPluginInstance*, DefaultState> defaultStates;
+
+    std::mutex chunkCacheMutex;
+    std::list<CachedChunk> chunkCache;
+    std::unordered_map<HashCode, std::list<CachedChunk>::iterator> chunkCacheIndex;
+    size_t chunkCacheSize = 0, maxChunkCacheSize = 64 * 1024 * 1024;
+
+    mutable std::mutex loadTimesMutex;
+    std::deque<LoadTime> loadTimes;
+
+    PooledInstance createInstance (const PluginToLoad&, double sampleRate, int blockSize,
+                                   bool canBeReset, juce::String& errorMessage);
+    void addToPool (const juce::PluginDescription&, PooledInstance);
+    void loadPlugins (const std::vector<PluginToLoad>&, const Edit*);
+    bool resetInstance (juce::AudioPluginInstance&);
+    void deleteInstance (std::unique_ptr<juce::AudioPluginInstance>);
+    void trimChunkCache();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginInstancePool)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,348 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class PluginInstancePoolTests  : public juce::UnitTest
+{
+public:
+    PluginInstancePoolTests()
+        : juce::UnitTest ("PluginInstancePool", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+
+        beginTest ("State hashes");
+        {
+            auto v1 = createPluginState ("abcdefgh", 0);
+            auto v2 = createPluginState ("abcdefgh", 1);
+            auto v3 = createPluginState ("ijklmnop", 0);
+
+            expectEquals (PluginInstancePool::getStateHash (juce::ValueTree (IDs::PLUGIN)), (HashCode) 0);
+            expectEquals (PluginInstancePool::getStateHash (v1), PluginInstancePool::getStateHash (createPluginState ("abcdefgh", 0)));
+            expect (PluginInstancePool::getStateHash (v1) != PluginInstancePool::getStateHash (v2), "Program should be part of the hash");
+            expect (PluginInstancePool::getStateHash (v1) != PluginInstancePool::getStateHash (v3));
+
+            juce::ValueTree vstData (IDs::PLUGIN);
+            juce::ValueTree data (IDs::VSTDATA);
+            data.setProperty (IDs::DATA, "abcdefgh", nullptr);
+            vstData.appendChild (data, nullptr);
+            expectEquals (PluginInstancePool::getPluginStateString (vstData), juce::String ("abcdefgh"));
+        }
+
+        beginTest ("State chunk cache");
+        {
+            PluginInstancePool pool (engine);
+
+            juce::MemoryBlock original;
+
+            for (int i = 0; i < 1024; ++i)
+                original.append (&i, sizeof (i));
+
+            const auto base64 = original.toBase64Encoding();
+            auto chunk1 = pool.getStateChunk (base64);
+            auto chunk2 = pool.getStateChunk (base64);
+
+            expect (chunk1 != nullptr);
+            expect (*chunk1 == original, "Decoded chunk should match the original");
+            expect (chunk1 == chunk2, "Second lookup should return the cached chunk");
+            expect (pool.getStateChunk ({}) == nullptr);
+
+            pool.setMaxStateCacheSize (0);
+            auto chunk3 = pool.getStateChunk (base64);
+            expect (chunk3 != chunk1, "Cache should have been emptied");
+            expect (*chunk3 == original);
+        }
+
+        beginTest ("Load times");
+        {
+            PluginInstancePool pool (engine);
+
+            PluginInstancePool::LoadTime fast, slow;
+            fast.name = "Fast";
+            fast.blockingSeconds = 0.001;
+            slow.name = "Slow";
+            slow.blockingSeconds = 1.0;
+            slow.wasPooled = true;
+
+            pool.addLoadTime (fast);
+            pool.addLoadTime (slow);
+            expectEquals ((int) pool.getLoadTimes().size(), 2);
+
+            auto report = pool.getLoadTimeReport();
+            expect (report.indexOf ("Slow") < report.indexOf ("Fast"), "Slowest plugins should be reported first");
+            expect (report.contains ("1 pooled"));
+
+            pool.clearLoadTimes();
+            expect (pool.getLoadTimes().empty());
+        }
+
+        runPoolingTests (engine);
+    }
+
+private:
+    //==============================================================================
+    /** A plugin that just stores whatever state it's given. */
+    class TestPluginInstance  : public juce::AudioPluginInstance
+    {
+    public:
+        TestPluginInstance (const juce::PluginDescription& d)
+            : juce::AudioPluginInstance (BusesProperties().withInput ("Input", juce::AudioChannelSet::stereo())
+                                                          .withOutput ("Output", juce::AudioChannelSet::stereo())),
+              description (d)
+        {
+            state.append ("default", 7);
+        }
+
+        void fillInPluginDescription (juce::PluginDescription& d) const override    { d = description; }
+        const juce::String getName() const override                                { return description.name; }
+
+        void prepareToPlay (double, int) override                                   {}
+        void releaseResources() override                                            {}
+        void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override   {}
+        double getTailLengthSeconds() const override                                { return 0.0; }
+        bool acceptsMidi() const override                                           { return false; }
+        bool producesMidi() const override                                          { return false; }
+        juce::AudioProcessorEditor* createEditor() override                         { return nullptr; }
+        bool hasEditor() const override                                             { return false; }
+
+        int getNumPrograms() override                                               { return 1; }
+        int getCurrentProgram() override                                            { return 0; }
+        void setCurrentProgram (int) override                                       {}
+        const juce::String getProgramName (int) override                            { return {}; }
+        void changeProgramName (int, const juce::String&) override                  {}
+
+        void getStateInformation (juce::MemoryBlock& destData) override             { destData = state; }
+        void setStateInformation (const void* data, int size) override              { state = juce::MemoryBlock (data, (size_t) size); }
+
+        juce::PluginDescription description;
+        juce::MemoryBlock state;
+    };
+
+    /** A pool that can keep instances regardless of the EngineBehaviour. */
+    class TestPool  : public PluginInstancePool
+    {
+    public:
+        TestPool (Engine& e, int maxNumInstances, bool shouldLoadOffThread = true)
+            : PluginInstancePool (e), maxNumPooledInstances (maxNumInstances), canLoadOffThread (shouldLoadOffThread)
+        {
+        }
+
+        bool canLoadOffMessageThread (const juce::PluginDescription&) override     { return canLoadOffThread; }
+        int getMaxNumPooledInstances (const juce::PluginDescription&) override      { return maxNumPooledInstances; }
+
+        const int maxNumPooledInstances;
+        const bool canLoadOffThread;
+    };
+
+    void runPoolingTests (Engine& engine)
+    {
+        auto& pm = engine.getPluginManager();
+
+        juce::PluginDescription description;
+        description.name = "Pool Test Plugin";
+        description.pluginFormatName = "Test";
+        description.fileOrIdentifier = "PoolTestPlugin";
+        description.uniqueId = 0x1234;
+
+        std::atomic<int> numInstancesCreated { 0 };
+        const juce::ScopedValueSetter<decltype (pm.createPluginInstance)> createPluginInstanceSetter (pm.createPluginInstance,
+            [&numInstancesCreated] (const juce::PluginDescription& d, double, int, juce::String&) -> std::unique_ptr<juce::AudioPluginInstance>
+            {
+                ++numInstancesCreated;
+                return std::make_unique<TestPluginInstance> (d);
+            });
+
+        auto getState = [] (juce::AudioPluginInstance& instance)
+        {
+            juce::MemoryBlock mb;
+            instance.getStateInformation (mb);
+            return mb.toString();
+        };
+
+        // Unsaved Edits share the same ProjectItemID so the pool has to tell them apart by instance
+        auto edit1 = Edit::createSingleTrackEdit (engine);
+        auto edit2 = Edit::createSingleTrackEdit (engine);
+        expect (edit1->getProjectItemID() == edit2->getProjectItemID());
+
+        beginTest ("Acquire and release");
+        {
+            TestPool pool (engine, 1);
+            juce::String error;
+
+            auto acquired = pool.acquire (description, 44100.0, 512, 0, edit1.get(), error);
+            expect (acquired.instance != nullptr, error);
+            expect (! acquired.wasPooled);
+            expectEquals (numInstancesCreated.load(), 1);
+
+            // Released instances are reset to their default state
+            auto instancePtr = acquired.instance.get();
+            acquired.instance->setStateInformation ("changed", 7);
+            pool.release (description, std::move (acquired.instance));
+            expectEquals (pool.getNumPooledInstances (description), 1);
+
+            auto reacquired = pool.acquire (description, 44100.0, 512, 0, edit2.get(), error);
+            expect (reacquired.wasPooled);
+            expect (reacquired.instance.get() == instancePtr);
+            expectEquals (reacquired.restoredStateHash, (HashCode) 0);
+            expectEquals (getState (*reacquired.instance), juce::String ("default"));
+            expectEquals (pool.getNumPooledInstances (description), 0);
+            expectEquals (numInstancesCreated.load(), 1);
+
+            // Instances past the limit are deleted
+            auto second = pool.acquire (description, 44100.0, 512, 0, edit1.get(), error);
+            pool.release (description, std::move (reacquired.instance));
+            pool.release (description, std::move (second.instance));
+            expectEquals (pool.getNumPooledInstances (description), 1);
+
+            // Instances the pool didn't create can't be reset
+            pool.clear();
+            pool.release (description, std::make_unique<TestPluginInstance> (description));
+            expectEquals (pool.getNumPooledInstances (description), 0);
+        }
+
+        beginTest ("Prewarming");
+        {
+            TestPool pool (engine, 4);
+            numInstancesCreated = 0;
+            pool.prewarm (description, 3);
+            expectEquals (pool.getNumPooledInstances (description), 3);
+            expectEquals (numInstancesCreated.load(), 3);
+
+            juce::String error;
+            auto acquired = pool.acquire (description, 44100.0, 512, 0, edit1.get(), error);
+            expect (acquired.wasPooled);
+            expectEquals (numInstancesCreated.load(), 3);
+            pool.release (description, std::move (acquired.instance));
+
+            pool.clear();
+            expectEquals (pool.getNumPooledInstances (description), 0);
+        }
+
+        // The pool only prepares plugins it can find in the known plugin list
+        pm.knownPluginList.addType (description);
+
+        juce::MemoryBlock pluginState;
+        pluginState.append ("restored", 8);
+        auto editState = createEditState (description, pluginState.toBase64Encoding());
+        const auto stateHash = PluginInstancePool::getStateHash (editState.getChild (0).getChild (0));
+
+        beginTest ("Preparing for an Edit");
+        {
+            TestPool pool (engine, 4);
+            pool.prepareForEdit (editState, *edit1);
+            expectEquals (pool.getNumPooledInstances (description), 2);
+
+            // Another Edit with the same state doesn't get the instances prepared for this one
+            juce::String error;
+            auto other = pool.acquire (description, 44100.0, 512, stateHash, edit2.get(), error);
+            expect (! other.wasPooled);
+            expectEquals (pool.getNumPooledInstances (description), 2);
+
+            std::vector<std::unique_ptr<juce::AudioPluginInstance>> instances;
+
+            for (int i = 0; i < 2; ++i)
+            {
+                auto acquired = pool.acquire (description, 44100.0, 512, stateHash, edit1.get(), error);
+                expect (acquired.wasPooled);
+                expectEquals (acquired.restoredStateHash, stateHash);
+                expectEquals (getState (*acquired.instance), juce::String ("restored"));
+                instances.push_back (std::move (acquired.instance));
+            }
+
+            expectEquals (pool.getNumPooledInstances (description), 0);
+
+            pool.release (description, std::move (other.instance));
+
+            for (auto& instance : instances)
+                pool.release (description, std::move (instance));
+        }
+
+        beginTest ("Nothing is prepared if no plugins can be loaded off the message thread");
+        {
+            TestPool pool (engine, 0, false);
+            numInstancesCreated = 0;
+            pool.prepareForEdit (editState, *edit1);
+            expectEquals (pool.getNumPooledInstances (description), 0);
+            expectEquals (numInstancesCreated.load(), 0);
+        }
+
+        beginTest ("Removing unused instances only affects their Edit");
+        {
+            TestPool pool (engine, 4);
+            pool.prewarm (description, 1);
+            pool.prepareForEdit (editState, *edit1);
+            pool.prepareForEdit (editState, *edit2);
+            expectEquals (pool.getNumPooledInstances (description), 5);
+
+            // Edit 1 finishes loading whilst Edit 2 is still loading
+            pool.removeUnusedPreparedInstances (*edit1);
+            expectEquals (pool.getNumPooledInstances (description), 3);
+
+            juce::String error;
+            auto acquired = pool.acquire (description, 44100.0, 512, stateHash, edit2.get(), error);
+            expect (acquired.wasPooled);
+            expectEquals (acquired.restoredStateHash, stateHash);
+
+            // Reset instances are kept for the next Edit
+            pool.removeUnusedPreparedInstances (*edit2);
+            expectEquals (pool.getNumPooledInstances (description), 1);
+
+            auto reset = pool.acquire (description, 44100.0, 512, stateHash, edit2.get(), error);
+            expect (reset.wasPooled);
+            expectEquals (reset.restoredStateHash, (HashCode) 0);
+
+            pool.release (description, std::move (acquired.instance));
+            pool.release (description, std::move (reset.instance));
+        }
+
+        pm.knownPluginList.removeType (description);
+    }
+
+    static juce::ValueTree createEditState (const juce::PluginDescription& description, const juce::String& stateString)
+    {
+        juce::ValueTree track (IDs::TRACK);
+
+        for (int i = 0; i < 2; ++i)
+        {
+            auto plugin = createPluginState (stateString, 0);
+            plugin.setProperty (IDs::filename, description.fileOrIdentifier, nullptr);
+            plugin.setProperty (IDs::uniqueId, juce::String::toHexString (description.uniqueId), nullptr);
+            track.appendChild (plugin, nullptr);
+        }
+
+        juce::ValueTree edit (IDs::EDIT);
+        edit.appendChild (track, nullptr);
+        return edit;
+    }
+
+    static juce::ValueTree createPluginState (const juce::String& stateString, int programNum)
+    {
+        juce::ValueTree v (IDs::PLUGIN);
+        v.setProperty (IDs::type, ExternalPlugin::xmlTypeName, nullptr);
+        v.setProperty (IDs::state, stateString, nullptr);
+        v.setProperty (IDs::programNum, programNum, nullptr);
+        return v;
+    }
+};
+
+static PluginInstancePoolTests pluginInstancePoolTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
@@ -403,6 +403,10 @@ PluginManager::PluginManager (Engine& e)
         return std::unique_ptr<juce::AudioPluginInstance> (pluginFormatManager.createPluginInstance (description, rate,
                                                                                                      blockSize, errorMessage));
     };
+
+    // BEATCONNECT MODIFICATION START
+    instancePool = std::make_unique<PluginInstancePool> (engine);
+    // BEATCONNECT MODIFICATION END
 }
 
 void PluginManager::initialise()
@@ -451,6 +455,9 @@ void PluginManager::initialise()
 PluginManager::~PluginManager()
 {
     knownPluginList.removeChangeListener (this);
+    // BEATCONNECT MODIFICATION START
+    instancePool.reset();
+    // BEATCONNECT MODIFICATION END
     cleanUpDanglingPlugins();
 }
 
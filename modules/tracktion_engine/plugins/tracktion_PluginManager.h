@@ -84,6 +84,11 @@ public:
                                                               double rate, int blockSize,
                                                               juce::String& errorMessage)> createPluginInstance;
 
+    // BEATCONNECT MODIFICATION START
+    /** Returns the pool of pre-instantiated plugin instances used when loading ExternalPlugins. */
+    PluginInstancePool& getInstancePool() const     { return *instancePool; }
+    // BEATCONNECT MODIFICATION END
+
     /** Callback that is used to determine if a plugin should use fine-grain automation or not. */
     std::function<bool (Plugin&)> canUseFineGrainAutomation;
 
@@ -96,6 +101,9 @@ private:
     juce::CriticalSection existingListLock;
     juce::OwnedArray<BuiltInType> builtInTypes;
     bool initialised = false;
+    // BEATCONNECT MODIFICATION START
+    std::unique_ptr<PluginInstancePool> instancePool;
+    // BEATCONNECT MODIFICATION END
 
     Plugin::Ptr createPlugin (Edit&, const juce::ValueTree&, bool isNew);
 
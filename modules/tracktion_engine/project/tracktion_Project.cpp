@@ -14,6 +14,16 @@ namespace tracktion { inline namespace engine
 // a combined version number and file identifier for the project file
 static const char* magicNumberV1 = "TP01";
 
+// BEATCONNECT MODIFICATION START
+// Items can refer to a compressed substitute of their file which will have a different
+// extension, so files are indexed without one and ProjectItem::isForFile picks the match
+static juce::String getFileIndexKey (const juce::File& f)
+{
+    auto key = f.withFileExtension ({}).getFullPathName();
+    return juce::File::areFileNamesCaseSensitive() ? key : key.toLowerCase();
+}
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 Project::Project (Engine& e, ProjectManager& pm, const juce::File& projectFile)
    : engine (e), projectManager (pm), file (projectFile)
@@ -103,8 +113,14 @@ bool Project::readProjectHeader (juce::InputStream& in, bool clearObjectInfo)
     CRASH_TRACER
 
     if (clearObjectInfo)
+    {
         objects.clear();
 
+        // BEATCONNECT MODIFICATION START
+        invalidateIndexes();
+        // BEATCONNECT MODIFICATION END
+    }
+
     char n[4] = { 0 };
     in.read (n, 4);
 
@@ -491,16 +507,34 @@ ProjectItem::Ptr Project::getProjectItemForFile (const juce::File& fileToFind)
 {
     const juce::ScopedLock sl (objectLock);
 
-    for (auto& o : objects)
+    // BEATCONNECT MODIFICATION START
+    if (fileToFind == juce::File())
+        return {};
+
+    buildFileIndex();
+    buildItemIndexes();
+
+    // If more than one item is for the file, return the first one in the list
+    auto range = fileIndex.equal_range (getFileIndexKey (fileToFind));
+    int bestIndex = -1;
+
+    for (auto i = range.first; i != range.second; ++i)
     {
-        if (o.item == nullptr)
-            if (! loadProjectItem (o))
-                continue;
+        auto found = itemIndexes.find (i->second);
+
+        if (found == itemIndexes.end() || (bestIndex >= 0 && found->second > bestIndex))
+            continue;
 
-        if (o.item->isForFile (fileToFind))
-            return o.item;
+        auto& o = objects.getReference (found->second);
+
+        if (o.item != nullptr && o.item->isForFile (fileToFind))
+            bestIndex = found->second;
     }
 
+    if (bestIndex >= 0)
+        return objects.getReference (bestIndex).item;
+    // BEATCONNECT MODIFICATION END
+
     return {};
 }
 
@@ -510,11 +544,13 @@ int Project::getIndexOf (ProjectItemID mo) const
 
     if (mo.getProjectID() == getProjectID())
     {
-        auto itemID = mo.getItemID();
+        // BEATCONNECT MODIFICATION START
+        buildItemIndexes();
+        auto found = itemIndexes.find (mo.getItemID());
 
-        for (int i = objects.size(); --i >= 0;)
-            if (objects.getReference(i).itemID == itemID)
-                return i;
+        if (found != itemIndexes.end())
+            return found->second;
+        // BEATCONNECT MODIFICATION END
     }
 
     return -1;
@@ -529,6 +565,11 @@ void Project::moveProjectItem (int indexToMoveFrom, int indexToMoveTo)
         if (indexToMoveFrom >= 0 && indexToMoveFrom < objects.size())
         {
             objects.move (indexToMoveFrom, juce::jlimit (0, objects.size(), indexToMoveTo));
+
+            // BEATCONNECT MODIFICATION START
+            itemIndexesValid = false;
+            // BEATCONNECT MODIFICATION END
+
             changed();
         }
     }
@@ -558,10 +599,9 @@ ProjectItem::Ptr Project::createNewItem (const juce::File& fileToReference,
         {
             const juce::ScopedLock sl (objectLock);
 
-            if (atTopOfList)
-                objects.insert (0, o);
-            else
-                objects.add (o);
+            // BEATCONNECT MODIFICATION START
+            addObject (o, atTopOfList);
+            // BEATCONNECT MODIFICATION END
         }
 
         o.item->setSourceFile (fileToReference);
@@ -574,6 +614,76 @@ ProjectItem::Ptr Project::createNewItem (const juce::File& fileToReference,
     return {};
 }
 
+// BEATCONNECT MODIFICATION START
+juce::Array<ProjectItem::Ptr> Project::createNewItems (const juce::Array<juce::File>& filesToReference,
+                                                       const juce::String& type,
+                                                       const ProjectItem::Category cat,
+                                                       bool atTopOfList)
+{
+    CRASH_TRACER
+    jassert (type.isNotEmpty());
+
+    juce::Array<ProjectItem::Ptr> items;
+
+    if (! isValid() || isReadOnly())
+        return items;
+
+    auto projectDir = getDefaultDirectory();
+    juce::Array<ProjectItem::Ptr> newItems;
+
+    {
+        const juce::ScopedLock sl (objectLock);
+
+        // New items are added to the end so the indexes can be kept up to date as
+        // they're added, then moved to the top all at once if needed
+        const int numExisting = objects.size();
+
+        for (auto& f : filesToReference)
+        {
+            if (auto mo = getProjectItemForFile (f))
+            {
+                if (mo->getID().isValid() && mo->getType() == type)
+                {
+                    items.add (mo);
+                    continue;
+                }
+            }
+
+            ObjectInfo o;
+            o.item = new ProjectItem (engine, f.getFileNameWithoutExtension(), type, {}, {}, cat, 0,
+                                      ProjectItemID::createNewID (getProjectID()));
+            o.itemID = o.item->getID().getItemID();
+            o.fileOffset = 0;
+
+            // This is the same as ProjectItem::setSourceFile but without notifying anyone
+            // of the change for each item
+            o.item->file = f.isAChildOf (projectDir) ? f.getRelativePathFrom (projectDir)
+                                                     : f.getFullPathName();
+
+            addObject (o, false);
+            items.add (o.item);
+            newItems.add (o.item);
+        }
+
+        if (atTopOfList && objects.size() > numExisting)
+        {
+            std::rotate (objects.begin(), objects.begin() + numExisting, objects.end());
+            itemIndexesValid = false;
+        }
+    }
+
+    if (newItems.isEmpty())
+        return items;
+
+    for (auto& item : newItems)
+        item->verifyLength();
+
+    changed();
+
+    return items;
+}
+// BEATCONNECT MODIFICATION END
+
 ProjectItem::Ptr Project::quickAddProjectItem (const juce::String& relPathName,
                                                const juce::String& type,
                                                const juce::String& name,
@@ -589,7 +699,10 @@ ProjectItem::Ptr Project::quickAddProjectItem (const juce::String& relPathName,
 
     {
         const juce::ScopedLock sl (objectLock);
-        objects.add (o);
+
+        // BEATCONNECT MODIFICATION START
+        addObject (o, false);
+        // BEATCONNECT MODIFICATION END
     }
 
     changed();
@@ -619,6 +732,15 @@ bool Project::removeProjectItem (ProjectItemID item, bool deleteSourceMaterial)
                             return false;
                 }
 
+                // BEATCONNECT MODIFICATION START
+                if (o.item != nullptr)
+                    removeFromFileIndex (*o.item, o.item->file);
+                else
+                    fileIndexValid = false;
+
+                itemIndexesValid = false;
+                // BEATCONNECT MODIFICATION END
+
                 objects.remove (index);
             }
         }
@@ -630,6 +752,108 @@ bool Project::removeProjectItem (ProjectItemID item, bool deleteSourceMaterial)
     return false;
 }
 
+// BEATCONNECT MODIFICATION START
+void Project::buildItemIndexes() const
+{
+    if (itemIndexesValid)
+        return;
+
+    itemIndexes.clear();
+    itemIndexes.reserve ((size_t) objects.size());
+
+    // If an ID appears more than once, the last one wins
+    for (int i = 0; i < objects.size(); ++i)
+        itemIndexes[objects.getReference (i).itemID] = i;
+
+    itemIndexesValid = true;
+}
+
+void Project::buildFileIndex()
+{
+    if (fileIndexValid)
+        return;
+
+    CRASH_TRACER
+    fileIndex.clear();
+    fileIndex.reserve ((size_t) objects.size());
+    fileIndexValid = true;
+
+    for (auto& o : objects)
+    {
+        if (o.item == nullptr)
+            if (! loadProjectItem (o))
+                continue;
+
+        addToFileIndex (*o.item, o.item->file);
+    }
+}
+
+void Project::invalidateIndexes()
+{
+    itemIndexesValid = false;
+    fileIndexValid = false;
+    itemIndexes.clear();
+    fileIndex.clear();
+}
+
+void Project::addObject (const ObjectInfo& o, bool atTopOfList)
+{
+    if (atTopOfList)
+    {
+        objects.insert (0, o);
+        itemIndexesValid = false;
+    }
+    else
+    {
+        objects.add (o);
+
+        if (itemIndexesValid)
+            itemIndexes[o.itemID] = objects.size() - 1;
+    }
+
+    if (o.item != nullptr)
+        addToFileIndex (*o.item, o.item->file);
+    else
+        fileIndexValid = false;
+}
+
+void Project::addToFileIndex (ProjectItem& item, const juce::String& relativePath)
+{
+    if (fileIndexValid)
+        fileIndex.emplace (getFileIndexKey (item.getRelativeFile (relativePath)),
+                           item.getID().getItemID());
+}
+
+void Project::removeFromFileIndex (ProjectItem& item, const juce::String& relativePath)
+{
+    if (! fileIndexValid)
+        return;
+
+    auto range = fileIndex.equal_range (getFileIndexKey (item.getRelativeFile (relativePath)));
+    const int itemID = item.getID().getItemID();
+
+    for (auto i = range.first; i != range.second; ++i)
+    {
+        if (i->second == itemID)
+        {
+            fileIndex.erase (i);
+            return;
+        }
+    }
+}
+
+void Project::itemSourceFileChanged (ProjectItem& item, const juce::String& oldRelativePath)
+{
+    const juce::ScopedLock sl (objectLock);
+
+    if (oldRelativePath != item.file)
+    {
+        removeFromFileIndex (item, oldRelativePath);
+        addToFileIndex (item, item.file);
+    }
+}
+// BEATCONNECT MODIFICATION END
+
 juce::File Project::getDirectoryForMedia (ProjectItem::Category category) const
 {
     auto dir = getDefaultDirectory();
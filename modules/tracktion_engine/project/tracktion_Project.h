@@ -87,6 +87,20 @@ public:
                                     const ProjectItem::Category cat,
                                     bool atTopOfList);
 
+    // BEATCONNECT MODIFICATION START
+    /** Creates items for a set of files, returning existing ones where there are any.
+        The items are named after their files. This is much quicker than calling
+        createNewItem for each file when importing lots of them, as the project is only
+        locked and marked as changed once.
+        @returns an array with an item for each of the files, or nullptr for any that
+                 couldn't be added
+    */
+    juce::Array<ProjectItem::Ptr> createNewItems (const juce::Array<juce::File>& filesToReference,
+                                                  const juce::String& type,
+                                                  const ProjectItem::Category cat,
+                                                  bool atTopOfList);
+    // BEATCONNECT MODIFICATION END
+
     bool removeProjectItem (ProjectItemID, bool deleteSourceMaterial);
 
     void moveProjectItem (int indexToMoveFrom, int indexToMoveTo);
@@ -166,6 +180,24 @@ private:
     int objectOffset = 0, indexOffset = 0;
     bool readOnly = false, hasChanged = false, temporary = false;
 
+    // BEATCONNECT MODIFICATION START
+    // Lookups by ID and by file. These are built the first time they're needed and
+    // kept up to date as items are added and removed, so must only be used with the
+    // objectLock held.
+    mutable std::unordered_map<int, int> itemIndexes;              // item ID -> index in objects
+    std::unordered_multimap<juce::String, int> fileIndex;          // file key -> item ID
+    mutable bool itemIndexesValid = false;
+    bool fileIndexValid = false;
+
+    void buildItemIndexes() const;
+    void buildFileIndex();
+    void invalidateIndexes();
+    void addObject (const ObjectInfo&, bool atTopOfList);
+    void addToFileIndex (ProjectItem&, const juce::String& relativePath);
+    void removeFromFileIndex (ProjectItem&, const juce::String& relativePath);
+    void itemSourceFileChanged (ProjectItem&, const juce::String& oldRelativePath);
+    // BEATCONNECT MODIFICATION END
+
     Project (Engine&, ProjectManager&, const juce::File&);
 
     juce::BufferedInputStream* getInputStream();
@@ -0,0 +1,202 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
+
+namespace tracktion { inline namespace engine
+{
+
+namespace project_test_utilities
+{
+    /** Creates a temporary project in its own directory along with some empty media files. */
+    struct TestProject
+    {
+        TestProject (Engine& engine, int numFiles)
+            : dir (engine.getTemporaryFileManager().getTempDirectory().getNonexistentChildFile ("project_test", {}, false))
+        {
+            dir.createDirectory();
+            temp = std::make_unique<ProjectManager::TempProject> (engine.getProjectManager(),
+                                                                  dir.getChildFile (juce::String ("test") + projectFileSuffix),
+                                                                  true);
+
+            for (int i = 0; i < numFiles; ++i)
+            {
+                auto f = dir.getChildFile ("file_" + juce::String (i) + ".wav");
+                f.create();
+                files.add (f);
+            }
+        }
+
+        ~TestProject()
+        {
+            temp.reset();
+            dir.deleteRecursively();
+        }
+
+        Project& getProject()   { return *temp->project; }
+
+        juce::File dir;
+        std::unique_ptr<ProjectManager::TempProject> temp;
+        juce::Array<juce::File> files;
+    };
+}
+
+#if TRACKTION_UNIT_TESTS
+
+//==============================================================================
+//==============================================================================
+class ProjectTests  : public juce::UnitTest
+{
+public:
+    ProjectTests()
+        : juce::UnitTest ("Project", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+        project_test_utilities::TestProject testProject (engine, 20);
+        auto& project = testProject.getProject();
+        auto& files = testProject.files;
+
+        beginTest ("Finding items");
+        {
+            expect (project.isValid());
+
+            auto first = project.createNewItem (files[0], ProjectItem::waveItemType(), "first", {},
+                                                ProjectItem::Category::imported, false);
+            auto second = project.createNewItem (files[1], ProjectItem::waveItemType(), "second", {},
+                                                 ProjectItem::Category::imported, true);
+            expect (first != nullptr && second != nullptr);
+
+            expectEquals (project.getIndexOf (second->getID()), 0);
+            expectEquals (project.getIndexOf (first->getID()), 1);
+            expect (project.getProjectItemForID (first->getID()) == first);
+            expect (project.getProjectItemForFile (files[0]) == first);
+            expect (project.getProjectItemForFile (files[1]) == second);
+            expect (project.getProjectItemForFile (files[2]) == nullptr);
+
+            expect (project.createNewItem (files[0], ProjectItem::waveItemType(), "duplicate", {},
+                                           ProjectItem::Category::imported, false) == first,
+                    "Existing items should be returned");
+            expectEquals (project.getNumProjectItems(), 2);
+
+            project.moveProjectItem (0, 2);
+            expectEquals (project.getIndexOf (first->getID()), 0);
+            expectEquals (project.getIndexOf (second->getID()), 1);
+        }
+
+        beginTest ("Changing files");
+        {
+            auto item = project.getProjectItemForFile (files[0]);
+            item->setSourceFile (files[2]);
+
+            expect (project.getProjectItemForFile (files[0]) == nullptr);
+            expect (project.getProjectItemForFile (files[2]) == item);
+        }
+
+        beginTest ("Removing items");
+        {
+            auto item = project.getProjectItemForFile (files[1]);
+            const auto otherID = project.getProjectItemForFile (files[2])->getID();
+
+            expect (project.removeProjectItem (item->getID(), false));
+            expectEquals (project.getIndexOf (item->getID()), -1);
+            expect (project.getProjectItemForFile (files[1]) == nullptr);
+            expectEquals (project.getIndexOf (otherID), 0);
+        }
+
+        beginTest ("Batch import");
+        {
+            const auto numBefore = project.getNumProjectItems();
+            auto existing = project.getProjectItemForFile (files[2]);
+            auto items = project.createNewItems (files, ProjectItem::waveItemType(),
+                                                 ProjectItem::Category::imported, true);
+
+            expectEquals (items.size(), files.size());
+            expectEquals (project.getNumProjectItems(), numBefore + files.size() - 1);
+            expect (items[2] == existing, "Existing items should be returned");
+
+            for (int i = 0; i < files.size(); ++i)
+            {
+                expect (project.getProjectItemForFile (files[i]) == items[i]);
+                expectEquals (items[i]->getName(), files[i].getFileNameWithoutExtension());
+            }
+
+            expectEquals (project.getIndexOf (items[0]->getID()), 0);
+            expectEquals (project.getIndexOf (items[1]->getID()), 1);
+            expectEquals (project.getIndexOf (existing->getID()), project.getNumProjectItems() - 1);
+        }
+    }
+};
+
+static ProjectTests projectTests;
+
+#endif // TRACKTION_UNIT_TESTS
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+class ProjectBenchmarks  : public juce::UnitTest
+{
+public:
+    ProjectBenchmarks()
+        : juce::UnitTest ("Project", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+
+        for (int numFiles : { 100, 1000, 5000 })
+        {
+            beginTest ("Importing " + juce::String (numFiles) + " files");
+
+            {
+                project_test_utilities::TestProject testProject (engine, numFiles);
+                auto& project = testProject.getProject();
+
+                ScopedBenchmark sb (createBenchmarkDescription (*this, "Import " + std::to_string (numFiles) + " files individually"));
+
+                for (auto& f : testProject.files)
+                    project.createNewItem (f, ProjectItem::waveItemType(), f.getFileNameWithoutExtension(), {},
+                                           ProjectItem::Category::imported, false);
+            }
+
+            {
+                project_test_utilities::TestProject testProject (engine, numFiles);
+                auto& project = testProject.getProject();
+
+                {
+                    ScopedBenchmark sb (createBenchmarkDescription (*this, "Import " + std::to_string (numFiles) + " files as a batch"));
+                    project.createNewItems (testProject.files, ProjectItem::waveItemType(),
+                                            ProjectItem::Category::imported, false);
+                }
+
+                ScopedBenchmark sb (createBenchmarkDescription (*this, "Find " + std::to_string (numFiles) + " items by file and ID"));
+
+                for (auto& f : testProject.files)
+                    if (auto item = project.getProjectItemForFile (f))
+                        project.getIndexOf (item->getID());
+            }
+        }
+    }
+};
+
+static ProjectBenchmarks projectBenchmarks;
+
+#endif // TRACKTION_BENCHMARKS
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
@@ -350,6 +350,10 @@ void ProjectItem::setSourceFile (const juce::File& f)
     {
         auto projectDir = pp->getDefaultDirectory();
 
+        // BEATCONNECT MODIFICATION START
+        auto oldFile = file;
+        // BEATCONNECT MODIFICATION END
+
         if (f.isAChildOf (projectDir))
             file = f.getRelativePathFrom (projectDir);
         else
@@ -357,6 +361,10 @@ void ProjectItem::setSourceFile (const juce::File& f)
 
         sourceFile = juce::File();
 
+        // BEATCONNECT MODIFICATION START
+        pp->itemSourceFileChanged (*this, oldFile);
+        // BEATCONNECT MODIFICATION END
+
         changed();
         pp->changed();
 
@@ -0,0 +1,159 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace
+{
+    constexpr double minChunkLengthSeconds = 10.0;
+    constexpr int chunkAlignment = 1024;
+
+    int roundUpToAlignment (SampleCount numSamples)
+    {
+        return (int) (((numSamples + chunkAlignment - 1) / chunkAlignment) * chunkAlignment);
+    }
+
+    struct RenderedChunk
+    {
+        juce::AudioBuffer<float> buffer;
+        int numPrerollSamples = 0, numOutputSamples = 0;
+        bool ok = false;
+    };
+}
+
+//==============================================================================
+ParallelTimeStretchRenderer::Options ParallelTimeStretchRenderer::createOptions (TimeStretcher::Mode mode,
+                                                                                 TimeStretcher::ElastiqueProOptions elastiqueOptions,
+                                                                                 double sampleRate, int numChannels,
+                                                                                 float speedRatio, float semitonesUp,
+                                                                                 SampleCount totalNumSamples, int numThreads)
+{
+    int latency = 0;
+
+    {
+        TimeStretcher probe;
+        probe.initialise (sampleRate, chunkAlignment, numChannels, mode, elastiqueOptions, false);
+        probe.setSpeedAndPitch (speedRatio, semitonesUp);
+        latency = probe.getLatencyNumSamples();
+    }
+
+    // The latency is in input samples so scale it to the output and then allow twice that
+    // for the stretcher to settle as it needs to fill its analysis window before it's stable
+    const auto latencyOut = (SampleCount) std::ceil (latency * std::max (1.0f, speedRatio));
+
+    Options o;
+    o.totalNumSamples   = totalNumSamples;
+    o.numChannels       = numChannels;
+    o.crossfadeSamples  = roundUpToAlignment (std::max<SampleCount> (latencyOut / 2, chunkAlignment));
+    o.prerollSamples    = roundUpToAlignment (latencyOut * 2 + o.crossfadeSamples);
+    o.chunkSize         = roundUpToAlignment (std::max ((SampleCount) (minChunkLengthSeconds * sampleRate),
+                                                        (SampleCount) o.prerollSamples * 8));
+    o.numThreads        = std::max (1, numThreads);
+
+    return o;
+}
+
+bool ParallelTimeStretchRenderer::shouldRenderInChunks (const Options& o)
+{
+    return o.numThreads > 1
+        && o.chunkSize > 0
+        && o.totalNumSamples > o.chunkSize * (SampleCount) 2;
+}
+
+//==============================================================================
+bool ParallelTimeStretchRenderer::render (const Options& o,
+                                          const RenderChunkFunction& renderChunk,
+                                          const WriteFunction& write,
+                                          std::atomic<float>& progress,
+                                          const std::function<bool()>& shouldExit)
+{
+    CRASH_TRACER
+    jassert (o.chunkSize > 0);
+    jassert (o.crossfadeSamples <= o.prerollSamples);
+
+    if (o.totalNumSamples <= 0 || o.chunkSize <= 0)
+        return false;
+
+    const auto numChunks = (int) ((o.totalNumSamples + o.chunkSize - 1) / o.chunkSize);
+
+    auto renderChunkAt = [&o, &renderChunk] (int index)
+    {
+        auto chunk = std::make_unique<RenderedChunk>();
+
+        const auto start        = index * (SampleCount) o.chunkSize;
+        const auto end          = std::min (o.totalNumSamples, start + o.chunkSize);
+        const auto renderStart  = std::max ((SampleCount) 0, start - o.prerollSamples);
+        const auto renderEnd    = std::min (o.totalNumSamples, end + o.crossfadeSamples);
+
+        chunk->numPrerollSamples = (int) (start - renderStart);
+        chunk->numOutputSamples = (int) (end - start);
+        chunk->buffer.setSize (o.numChannels, (int) (renderEnd - renderStart));
+        chunk->buffer.clear();
+        chunk->ok = renderChunk ({ renderStart, renderEnd }, chunk->buffer);
+
+        return chunk;
+    };
+
+    std::vector<std::future<std::unique_ptr<RenderedChunk>>> pending;
+    pending.reserve ((size_t) numChunks);
+
+    juce::AudioBuffer<float> tail (o.numChannels, o.crossfadeSamples);
+    int numTailSamples = 0;
+
+    auto exitRequested = [&shouldExit] { return shouldExit != nullptr && shouldExit(); };
+
+    for (int i = 0; i < numChunks; ++i)
+    {
+        // Keep numThreads chunks in flight, this also limits the amount of memory in use
+        while ((int) pending.size() < std::min (numChunks, i + o.numThreads) && ! exitRequested())
+            pending.push_back (std::async (std::launch::async, renderChunkAt, (int) pending.size()));
+
+        if (i >= (int) pending.size())
+            return false;
+
+        auto chunk = pending[(size_t) i].get();
+
+        if (! chunk->ok || exitRequested())
+            return false;
+
+        auto& buffer = chunk->buffer;
+        const auto outputStart = chunk->numPrerollSamples;
+
+        if (numTailSamples > 0)
+        {
+            const auto numToFade = std::min (numTailSamples, chunk->numOutputSamples);
+
+            AudioFadeCurve::applyCrossfadeSection (buffer, outputStart, numToFade, AudioFadeCurve::linear, 0.0f, 1.0f);
+
+            for (int chan = 0; chan < o.numChannels; ++chan)
+                AudioFadeCurve::addWithCrossfade (buffer, tail, chan, outputStart, chan, 0, numToFade,
+                                                  AudioFadeCurve::linear, 1.0f, 0.0f);
+        }
+
+        numTailSamples = buffer.getNumSamples() - (outputStart + chunk->numOutputSamples);
+        jassert (numTailSamples >= 0 && numTailSamples <= tail.getNumSamples());
+
+        for (int chan = 0; chan < o.numChannels; ++chan)
+            tail.copyFrom (chan, 0, buffer, chan, outputStart + chunk->numOutputSamples, numTailSamples);
+
+        juce::AudioBuffer<float> output (buffer.getArrayOfWritePointers(), o.numChannels,
+                                         outputStart, chunk->numOutputSamples);
+
+        if (! write (output))
+            return false;
+
+        progress = (i + 1) / (float) numChunks;
+    }
+
+    return true;
+}
+
+}} // namespace tracktion { inline namespace engine
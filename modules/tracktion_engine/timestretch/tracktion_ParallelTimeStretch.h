@@ -0,0 +1,81 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+/**
+    Renders a long, offline time-stretch in overlapping chunks across several threads.
+
+    The output is split up in to chunks which are each rendered by a separate call
+    to a RenderChunkFunction, on a separate thread. Each call should create its own
+    TimeStretcher, start reading the source at the position corresponding to the
+    start of the range it's given and fill the destination buffer.
+
+    Each chunk is started a number of pre-roll samples before its nominal start to
+    give the stretcher time to settle. These samples are discarded apart from a
+    short section at the end of the previous chunk which is crossfaded with the start
+    of the next one to hide any phase differences between the two stretchers.
+
+    Chunks are passed to the WriteFunction in order, so the result can be streamed
+    straight to an AudioFileWriter.
+*/
+class ParallelTimeStretchRenderer
+{
+public:
+    //==============================================================================
+    /** Describes how the output should be split up. All sizes are in output samples. */
+    struct Options
+    {
+        SampleCount totalNumSamples = 0;    /**< The total number of output samples to render. */
+        int numChannels = 0;                /**< The number of channels to render. */
+        int chunkSize = 0;                  /**< The number of samples each chunk contributes to the output. */
+        int prerollSamples = 0;             /**< The number of samples to render before each chunk. */
+        int crossfadeSamples = 0;           /**< The length of the crossfade between chunks. Must be <= prerollSamples. */
+        int numThreads = 1;                 /**< The maximum number of chunks to render at once. */
+    };
+
+    /** Creates a set of Options suitable for a given stretcher configuration.
+        This creates a temporary TimeStretcher to find out the latency of the mode and sizes
+        the pre-roll and crossfade accordingly.
+        @param speedRatio   The ratio passed to TimeStretcher::setSpeedAndPitch
+    */
+    static Options createOptions (TimeStretcher::Mode, TimeStretcher::ElastiqueProOptions,
+                                  double sampleRate, int numChannels,
+                                  float speedRatio, float semitonesUp,
+                                  SampleCount totalNumSamples, int numThreads);
+
+    /** Returns true if rendering with the given Options will use more than one chunk. */
+    static bool shouldRenderInChunks (const Options&);
+
+    //==============================================================================
+    /** Should render the given output range in to the buffer, which will be the same length as the range.
+        This will be called on a background thread so must not share any state with other calls.
+        Return false to abort the render.
+    */
+    using RenderChunkFunction = std::function<bool (SampleRange, juce::AudioBuffer<float>&)>;
+
+    /** Called on the calling thread with each consecutive block of finished output.
+        Return false to abort the render.
+    */
+    using WriteFunction = std::function<bool (juce::AudioBuffer<float>&)>;
+
+    /** Renders the whole output, blocking until it has completed.
+        @param shouldExit   An optional function which will be polled between chunks to see if the render should stop
+        @returns            true if all the chunks were rendered and written successfully
+    */
+    static bool render (const Options&,
+                        const RenderChunkFunction&,
+                        const WriteFunction&,
+                        std::atomic<float>& progress,
+                        const std::function<bool()>& shouldExit = {});
+};
+
+}} // namespace tracktion { inline namespace engine
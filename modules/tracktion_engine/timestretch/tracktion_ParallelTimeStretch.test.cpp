@@ -0,0 +1,283 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_BENCHMARKS
+ #include "../../tracktion_core/utilities/tracktion_Benchmark.h"
+#endif
+
+#if TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
+
+#include "../../tracktion_graph/tracktion_graph/tracktion_TestUtilities.h"
+
+namespace tracktion { inline namespace engine
+{
+
+namespace parallel_timestretch_test_utilities
+{
+    inline std::vector<TimeStretcher::Mode> getModesToTest()
+    {
+        return {
+           #if TRACKTION_ENABLE_TIMESTRETCH_SOUNDTOUCH
+            TimeStretcher::soundtouchBetter,
+           #endif
+           #if TRACKTION_ENABLE_TIMESTRETCH_RUBBERBAND
+            TimeStretcher::rubberbandMelodic,
+           #endif
+           #if TRACKTION_ENABLE_TIMESTRETCH_ELASTIQUE
+            TimeStretcher::elastiquePro,
+           #endif
+        };
+    }
+
+    /** Creates an Edit with a clip that time-stretches a sin file, optionally looping part of it. */
+    inline std::unique_ptr<Edit> createStretchedClipEdit (Engine& engine, const juce::File& sourceFile, TimeStretcher::Mode mode,
+                                                          double speedRatio, TimeDuration clipLength, std::optional<TimeRange> loopRange)
+    {
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+        auto clip = track->insertWaveClip ("sin", sourceFile, {{ TimePosition(), clipLength }}, false);
+
+        clip->setTimeStretchMode (mode);
+        clip->setSpeedRatio (speedRatio);
+
+        if (loopRange)
+            clip->setLoopRange (*loopRange);
+
+        clip->setPosition ({{ TimePosition(), clipLength }});
+
+        return edit;
+    }
+
+    /** Renders a clip's proxy with AudioClipBase::ProxyRenderingInfo, the same way the proxy
+        generator does, and returns the result.
+    */
+    inline juce::AudioBuffer<float> renderProxy (Engine& engine, AudioClipBase& clip, const juce::File& sourceFile,
+                                                 int numThreads, int chunkSize)
+    {
+        auto info = clip.createProxyRenderingInfo();
+        info->numThreads = numThreads;
+        info->chunkSize = chunkSize;
+
+        const AudioFile source (engine, sourceFile);
+        juce::TemporaryFile outputFile (".wav");
+
+        {
+            AudioFileWriter writer (AudioFile (engine, outputFile.getFile()), engine.getAudioFileFormatManager().getWavFormat(),
+                                    source.getNumChannels(), source.getSampleRate(), 32, {}, 0);
+            juce::ThreadPoolJob* const job = nullptr;
+            std::atomic<float> progress { 0.0f };
+
+            if (! (writer.isOpen() && info->render (engine, source, writer, job, progress)))
+                return {};
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, outputFile.getFile()));
+
+        if (reader == nullptr)
+            return {};
+
+        juce::AudioBuffer<float> result ((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read (&result, 0, result.getNumSamples(), 0, true, true);
+
+        return result;
+    }
+
+    inline float getMaxSampleDelta (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+    {
+        float maxDelta = 0.0f;
+
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+        {
+            auto data = buffer.getReadPointer (c);
+
+            for (int i = std::max (1, startSample); i < startSample + numSamples; ++i)
+                maxDelta = std::max (maxDelta, std::abs (data[i] - data[i - 1]));
+        }
+
+        return maxDelta;
+    }
+}
+
+#if TRACKTION_UNIT_TESTS
+
+//==============================================================================
+//==============================================================================
+class ParallelTimeStretchTests  : public juce::UnitTest
+{
+public:
+    ParallelTimeStretchTests()
+        : juce::UnitTest ("ParallelTimeStretch", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+        const double sampleRate = 44100.0;
+        auto sourceFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (sampleRate, 4.0, 2, 440.0f);
+
+        for (auto mode : parallel_timestretch_test_utilities::getModesToTest())
+        {
+            beginTest ("Chunked vs serial proxy: " + TimeStretcher::getNameOfMode (mode));
+
+            for (auto speedRatio : { 0.5, 1.5 })
+                compareWithSerial (engine, sourceFile->getFile(), mode, speedRatio, {});
+
+            // A looped clip has several segments, each chunk only creating the ones it overlaps
+            compareWithSerial (engine, sourceFile->getFile(), mode, 0.75, TimeRange (TimePosition(), TimePosition::fromSeconds (2.0)));
+        }
+    }
+
+private:
+    void compareWithSerial (Engine& engine, const juce::File& sourceFile, TimeStretcher::Mode mode,
+                            double speedRatio, std::optional<TimeRange> loopRange)
+    {
+        using namespace parallel_timestretch_test_utilities;
+        const double sampleRate = 44100.0;
+        const auto clipLength = loopRange ? TimeDuration::fromSeconds (12.0) : TimeDuration::fromSeconds (4.0 / speedRatio);
+
+        auto edit = createStretchedClipEdit (engine, sourceFile, mode, speedRatio, clipLength, loopRange);
+        auto clip = dynamic_cast<AudioClipBase*> (getAudioTracks (*edit)[0]->getClips()[0]);
+        expect (clip != nullptr);
+
+        if (clip == nullptr)
+            return;
+
+        // Short chunks so the clip is split up in to lots of them
+        const int chunkSize = (int) sampleRate;
+        const auto serial = renderProxy (engine, *clip, sourceFile, 1, 0);
+        const auto chunked = renderProxy (engine, *clip, sourceFile, 4, chunkSize);
+
+        expect (serial.getNumSamples() > 0, "The serial render should succeed");
+        expectEquals (chunked.getNumSamples(), serial.getNumSamples(), "Chunked output should be the same length as the serial output");
+
+        // Ignore the start and end where the stretchers are settling or flushing
+        const int start = (int) sampleRate / 2;
+        const int numSamples = std::min (chunked.getNumSamples(), serial.getNumSamples()) - (int) sampleRate;
+
+        if (numSamples <= 0)
+            return;
+
+        for (int c = 0; c < serial.getNumChannels(); ++c)
+        {
+            const auto serialRMS = serial.getRMSLevel (c, start, numSamples);
+            const auto chunkedRMS = chunked.getRMSLevel (c, start, numSamples);
+            expectWithinAbsoluteError (juce::Decibels::gainToDecibels (chunkedRMS),
+                                       juce::Decibels::gainToDecibels (serialRMS), 0.5f,
+                                       "Chunked level should match serial level");
+        }
+
+        auto info = clip->createProxyRenderingInfo();
+        info->numThreads = 4;
+        info->chunkSize = chunkSize;
+        const auto chunkOptions = info->getChunkOptions (engine, AudioFile (engine, sourceFile));
+        expect (chunkOptions.has_value(), "The clip should be long enough to render in chunks");
+
+        if (chunkOptions)
+            compareSeams (serial, chunked, *chunkOptions, start, start + numSamples);
+    }
+
+    /** Checks the crossfade at each chunk boundary against the same section of the serial render.
+        A click shows up as a jump between consecutive samples and a phase mismatch between the
+        two stretchers as a dip in level part way through the crossfade.
+    */
+    void compareSeams (const juce::AudioBuffer<float>& serial, const juce::AudioBuffer<float>& chunked,
+                       const ParallelTimeStretchRenderer::Options& chunkOptions, int start, int end)
+    {
+        using namespace parallel_timestretch_test_utilities;
+        const int crossfade = chunkOptions.crossfadeSamples;
+        const int windowSize = crossfade / 4;
+        int numSeamsChecked = 0;
+
+        for (auto seam = (SampleCount) chunkOptions.chunkSize; seam < end; seam += chunkOptions.chunkSize)
+        {
+            const auto seamStart = (int) seam - windowSize;
+            const auto seamEnd = (int) seam + crossfade + windowSize;
+
+            if (seamStart < start || seamEnd > end)
+                continue;
+
+            const auto seamName = "Seam at " + juce::String (seam);
+
+            expectLessOrEqual (getMaxSampleDelta (chunked, seamStart, seamEnd - seamStart),
+                               getMaxSampleDelta (serial, seamStart, seamEnd - seamStart) * 1.25f + 0.002f,
+                               seamName + " should not click");
+
+            for (int window = seamStart; window + windowSize <= seamEnd; window += windowSize)
+            {
+                for (int c = 0; c < serial.getNumChannels(); ++c)
+                {
+                    const auto serialRMS = serial.getRMSLevel (c, window, windowSize);
+                    const auto chunkedRMS = chunked.getRMSLevel (c, window, windowSize);
+                    expectWithinAbsoluteError (juce::Decibels::gainToDecibels (chunkedRMS, -60.0f),
+                                               juce::Decibels::gainToDecibels (serialRMS, -60.0f), 1.0f,
+                                               seamName + " should not dip in level");
+                }
+            }
+
+            ++numSeamsChecked;
+        }
+
+        expectGreaterThan (numSeamsChecked, 0, "At least one seam should be checked");
+    }
+};
+
+static ParallelTimeStretchTests parallelTimeStretchTests;
+
+#endif // TRACKTION_UNIT_TESTS
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+class ParallelTimeStretchBenchmarks  : public juce::UnitTest
+{
+public:
+    ParallelTimeStretchBenchmarks()
+        : juce::UnitTest ("ParallelTimeStretch", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        using namespace parallel_timestretch_test_utilities;
+        auto& engine = *Engine::getEngines()[0];
+        auto sourceFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, 120.0, 2, 440.0f);
+
+        for (auto mode : getModesToTest())
+        {
+            const auto modeName = TimeStretcher::getNameOfMode (mode).toStdString();
+            beginTest ("Stretch 2 min stereo: " + modeName);
+
+            auto edit = createStretchedClipEdit (engine, sourceFile->getFile(), mode, 1.0 / 1.5,
+                                                 TimeDuration::fromSeconds (120.0 * 1.5), {});
+            auto& clip = *dynamic_cast<AudioClipBase*> (getAudioTracks (*edit)[0]->getClips()[0]);
+
+            {
+                ScopedBenchmark sb (createBenchmarkDescription (*this, "Stretch 2 min stereo, serial: " + modeName));
+                expect (renderProxy (engine, clip, sourceFile->getFile(), 1, 0).getNumSamples() > 0);
+            }
+
+            for (int numThreads : { 2, 4, 8 })
+            {
+                ScopedBenchmark sb (createBenchmarkDescription (*this, "Stretch 2 min stereo, " + std::to_string (numThreads) + " threads: " + modeName));
+                expect (renderProxy (engine, clip, sourceFile->getFile(), numThreads, 0).getNumSamples() > 0);
+            }
+        }
+    }
+};
+
+static ParallelTimeStretchBenchmarks parallelTimeStretchBenchmarks;
+
+#endif // TRACKTION_BENCHMARKS
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS || TRACKTION_BENCHMARKS
@@ -85,6 +85,9 @@ struct TimeStretcher::Stretcher
     virtual bool setSpeedAndPitch (float speedRatio, float semitonesUp) = 0;
     virtual int getFramesNeeded() const = 0;
     virtual int getMaxFramesNeeded() const = 0;
+    // BEATCONNECT MODIFICATION START
+    virtual int getLatency() const                  { return getMaxFramesNeeded(); }
+    // BEATCONNECT MODIFICATION END
     virtual int processData (const float* const* inChannels, int numSamples, float* const* outChannels) = 0;
     virtual int flush (float* const* outChannels) = 0;
 };
@@ -258,6 +261,13 @@ struct SoundTouchStretcher  : public TimeStretcher::Stretcher,
         return 8192;
     }
 
+    // BEATCONNECT MODIFICATION START
+    int getLatency() const override
+    {
+        return getSetting (SETTING_INITIAL_LATENCY);
+    }
+    // BEATCONNECT MODIFICATION END
+
     int processData (const float* const* inChannels, int numSamples, float* const* outChannels) override
     {
         CRASH_TRACER
@@ -478,6 +488,13 @@ struct RubberBandStretcher  : public TimeStretcher::Stretcher
         return maxFramesNeeded;
     }
 
+    // BEATCONNECT MODIFICATION START
+    int getLatency() const override
+    {
+        return (int) rubberBandStretcher.getLatency();
+    }
+    // BEATCONNECT MODIFICATION END
+
     int processData (const float* const* inChannels, int numSamples, float* const* outChannels) override
     {
         jassert (numSamples <= getFramesNeeded());
@@ -794,6 +811,16 @@ int TimeStretcher::getMaxFramesNeeded() const
     return 0;
 }
 
+// BEATCONNECT MODIFICATION START
+int TimeStretcher::getLatencyNumSamples() const
+{
+    if (stretcher != nullptr)
+        return stretcher->getLatency();
+
+    return 0;
+}
+// BEATCONNECT MODIFICATION END
+
 int TimeStretcher::processData (const float* const* inChannels, int numSamples, float* const* outChannels)
 {
     if (stretcher != nullptr)
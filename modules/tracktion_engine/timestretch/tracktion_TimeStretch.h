@@ -135,6 +135,14 @@ public:
         This should be queried each block and the returned number of frames be passes to processData.
     */
     int getFramesNeeded() const;
+
+    // BEATCONNECT MODIFICATION START
+    /** Returns the number of frames the stretcher needs to be fed before its output settles.
+        This can be used to determine how much pre-roll to render when starting a stretcher
+        part way through a source, e.g. when rendering in separate chunks.
+    */
+    int getLatencyNumSamples() const;
+    // BEATCONNECT MODIFICATION END
     
     /** Processes some input frames and fills some output frames with the applied speed ratio and pitch shift.
         @param inChannels   The input sample data in non-interleaved format
@@ -58,11 +58,17 @@
  #include <choc/audio/choc_MIDI.h>
  #include <choc/containers/choc_SingleReaderSingleWriterFIFO.h>
  #include <choc/containers/choc_NonAllocatingStableSort.h>
+ // BEATCONNECT MODIFICATION START
+ #include <choc/containers/choc_SingleReaderMultipleWriterFIFO.h>
+ // BEATCONNECT MODIFICATION END
 #else
  #include "../3rd_party/choc/audio/choc_SampleBuffers.h"
  #include "../3rd_party/choc/audio/choc_MIDI.h"
  #include "../3rd_party/choc/containers/choc_SingleReaderSingleWriterFIFO.h"
  #include "../3rd_party/choc/containers/choc_NonAllocatingStableSort.h"
+ // BEATCONNECT MODIFICATION START
+ #include "../3rd_party/choc/containers/choc_SingleReaderMultipleWriterFIFO.h"
+ // BEATCONNECT MODIFICATION END
 #endif
 
 #undef __TEXT
@@ -275,6 +281,10 @@ namespace tracktion { inline namespace engine
 {
     // BEATCONNECT MODIFICATION START
     class AudioFifo;
+    class AutoFreezeManager;
+    class ParameterChangeQueue;
+    class ImpulseResponseCache;
+    class ThreadPlacementPolicy;
     // BEATCONNECT MODIFICATION END
 
     class EngineBehaviour;
@@ -399,6 +409,9 @@ namespace tracktion { inline namespace engine
 #include "utilities/tracktion_AtomicWrapper.h"
 #include "utilities/tracktion_Identifiers.h"
 #include "utilities/tracktion_ValueTreeUtilities.h"
+// BEATCONNECT MODIFICATION START
+#include "utilities/tracktion_ValueTreeSnapshot.h"
+// BEATCONNECT MODIFICATION END
 #include "utilities/tracktion_CrashTracer.h"
 #include "utilities/tracktion_AsyncFunctionUtils.h"
 #include "utilities/tracktion_CpuMeasurement.h"
@@ -409,6 +422,9 @@ namespace tracktion { inline namespace engine
 #include "utilities/tracktion_AudioFadeCurve.h"
 #include "utilities/tracktion_Spline.h"
 #include "utilities/tracktion_Ditherer.h"
+// BEATCONNECT MODIFICATION START
+#include "utilities/tracktion_LoudnessMeter.h"
+// BEATCONNECT MODIFICATION END
 #include "utilities/tracktion_ExternalPlayheadSynchroniser.h"
 #include "selection/tracktion_Selectable.h"
 #include "selection/tracktion_SelectableClass.h"
@@ -416,6 +432,9 @@ namespace tracktion { inline namespace engine
 #include "model/tracks/tracktion_EditTime.h"
 #include "utilities/tracktion_BackgroundJobs.h"
 #include "utilities/tracktion_MiscUtilities.h"
+// BEATCONNECT MODIFICATION START
+#include "utilities/tracktion_IntervalTree.h"
+// BEATCONNECT MODIFICATION END
 #include "utilities/tracktion_TemporaryFileManager.h"
 #include "utilities/tracktion_PluginComponent.h"
 #include "utilities/tracktion_BinaryData.h"
@@ -464,6 +483,9 @@ namespace tracktion { inline namespace engine
 #include "plugins/tracktion_PluginWindowState.h"
 #include "plugins/tracktion_Plugin.h"
 #include "plugins/tracktion_PluginList.h"
+// BEATCONNECT MODIFICATION START
+#include "plugins/tracktion_PluginInstancePool.h"
+// BEATCONNECT MODIFICATION END
 #include "plugins/tracktion_PluginManager.h"
 
 #include "project/tracktion_ProjectItem.h"
@@ -486,6 +508,9 @@ namespace tracktion { inline namespace engine
 #include "plugins/internal/tracktion_RackInstance.h"
 #include "plugins/internal/tracktion_AuxReturn.h"
 #include "plugins/internal/tracktion_AuxSend.h"
+// BEATCONNECT MODIFICATION START
+#include "plugins/effects/tracktion_EffectKernels.h"
+// BEATCONNECT MODIFICATION END
 #include "plugins/effects/tracktion_Equaliser.h"
 
 #include "model/edit/tracktion_EditSnapshot.h"
@@ -498,12 +523,18 @@ namespace tracktion { inline namespace engine
 #include "model/edit/tracktion_TimecodeDisplayFormat.h"
 #include "model/edit/tracktion_PitchSetting.h"
 #include "model/edit/tracktion_PitchSequence.h"
+// BEATCONNECT MODIFICATION START
+#include "audio_files/tracktion_SegmentedRecordingWriter.h"
+// BEATCONNECT MODIFICATION END
 #include "model/edit/tracktion_Edit.h"
 #include "model/edit/tracktion_EditFileOperations.h"
 
 #include "playback/tracktion_TransportControl.h"
 #include "playback/tracktion_AbletonLink.h"
 
+// BEATCONNECT MODIFICATION START
+#include "control_surfaces/tracktion_ControlSurfaceOutputQueue.h"
+// BEATCONNECT MODIFICATION END
 #include "control_surfaces/tracktion_ControlSurface.h"
 #include "control_surfaces/tracktion_ExternalController.h"
 
@@ -518,6 +549,9 @@ namespace tracktion { inline namespace engine
 #include "utilities/tracktion_Pitch.h"
 
 #include "audio_files/tracktion_AudioFileCache.h"
+// BEATCONNECT MODIFICATION START
+#include "audio_files/tracktion_ThumbnailStream.h"
+// BEATCONNECT MODIFICATION END
 #include "audio_files/tracktion_Thumbnail.h"
 #include "audio_files/tracktion_SmartThumbnail.h"
 #include "audio_files/tracktion_AudioProxyGenerator.h"
@@ -539,6 +573,9 @@ namespace tracktion { inline namespace engine
 #include "model/automation/tracktion_AutomationRecordManager.h"
 #include "model/automation/tracktion_ParameterChangeHandler.h"
 #include "model/automation/tracktion_ParameterControlMappings.h"
+// BEATCONNECT MODIFICATION START
+#include "model/automation/tracktion_ParameterChangeQueue.h"
+// BEATCONNECT MODIFICATION END
 
 #include "playback/devices/tracktion_OutputDevice.h"
 
@@ -548,6 +585,9 @@ namespace tracktion { inline namespace engine
 
 #include "timestretch/tracktion_BeatDetect.h"
 #include "timestretch/tracktion_TimeStretch.h"
+// BEATCONNECT MODIFICATION START
+#include "timestretch/tracktion_ParallelTimeStretch.h"
+// BEATCONNECT MODIFICATION END
 
 #include "model/export/tracktion_ArchiveFile.h"
 #include "model/export/tracktion_ExportJob.h"
@@ -586,6 +626,9 @@ namespace tracktion { inline namespace engine
 #include "model/tracks/tracktion_TrackCompManager.h"
 #include "model/export/tracktion_RenderOptions.h"
 #include "model/clips/tracktion_EditClipRenderJob.h"
+// BEATCONNECT MODIFICATION START
+#include "model/tracks/tracktion_AutoFreezeManager.h"
+// BEATCONNECT MODIFICATION END
 
 #include "selection/tracktion_Clipboard.h"
 
@@ -601,6 +644,11 @@ namespace tracktion { inline namespace engine
  #include "playback/tracktion_ScopedSteadyLoad.h"
 #endif
 
+// BEATCONNECT MODIFICATION START
+#include "playback/tracktion_OverloadPolicy.h"
+#include "playback/tracktion_ThreadPlacementPolicy.h"
+#include "playback/devices/tracktion_RelayInput.h"
+// BEATCONNECT MODIFICATION END
 #include "playback/tracktion_DeviceManager.h"
 #include "playback/tracktion_HostedAudioDevice.h"
 #include "playback/tracktion_MidiNoteDispatcher.h"
@@ -621,6 +669,9 @@ namespace tracktion { inline namespace engine
 #include "plugins/effects/tracktion_Delay.h"
 #include "plugins/effects/tracktion_Chorus.h"
 #include "plugins/effects/tracktion_FourOscPlugin.h"
+// BEATCONNECT MODIFICATION START
+#include "plugins/effects/tracktion_ImpulseResponseCache.h"
+// BEATCONNECT MODIFICATION END
 #include "plugins/effects/tracktion_ImpulseResponsePlugin.h"
 #include "plugins/effects/tracktion_LatencyPlugin.h"
 #include "plugins/effects/tracktion_LowPass.h"
@@ -33,13 +33,24 @@ extern "C"
 #include "audio_files/formats/tracktion_LAMEManager.cpp"
 
 #include "audio_files/tracktion_Thumbnail.cpp"
+// BEATCONNECT MODIFICATION START
+#include "audio_files/tracktion_ThumbnailStream.cpp"
+#include "audio_files/tracktion_ThumbnailStream.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "audio_files/tracktion_AudioFileCache.cpp"
 #include "audio_files/tracktion_AudioFile.cpp"
 #include "audio_files/tracktion_AudioFile.test.cpp"
 #include "audio_files/tracktion_AudioFileUtils.cpp"
 #include "audio_files/tracktion_AudioFormatManager.cpp"
+// BEATCONNECT MODIFICATION START
+#include "audio_files/tracktion_SegmentedRecordingWriter.cpp"
+#include "audio_files/tracktion_SegmentedRecordingWriter.test.cpp"
+// BEATCONNECT MODIFICATION END
 
 #include "midi/tracktion_MidiList.cpp"
+// BEATCONNECT MODIFICATION START
+#include "midi/tracktion_MidiList.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "midi/tracktion_MidiProgramManager.cpp"
 #include "midi/tracktion_Musicality.cpp"
 #include "midi/tracktion_SelectedMidiEvents.cpp"
@@ -38,6 +38,10 @@ using namespace std::literals;
 #include "model/automation/tracktion_MidiLearn.cpp"
 #include "model/automation/tracktion_ParameterChangeHandler.cpp"
 #include "model/automation/tracktion_ParameterControlMappings.cpp"
+// BEATCONNECT MODIFICATION START
+#include "model/automation/tracktion_ParameterChangeQueue.cpp"
+#include "model/automation/tracktion_ParameterChangeQueue.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "model/automation/tracktion_Modifier.cpp"
 #include "model/automation/modifiers/tracktion_ModifierCommon.cpp"
 #include "model/automation/modifiers/tracktion_BreakpointOscillatorModifier.cpp"
@@ -19,6 +19,12 @@ using namespace std::literals;
 
 #include "utilities/tracktion_TestUtilities.h"
 
+// BEATCONNECT MODIFICATION START
+#if TRACKTION_BENCHMARKS
+ #include "../tracktion_core/utilities/tracktion_Benchmark.h"
+#endif
+// BEATCONNECT MODIFICATION END
+
 #include "playback/graph/tracktion_TracktionEngineNode.h"
 #include "playback/graph/tracktion_TracktionNodePlayer.h"
 #include "playback/graph/tracktion_MultiThreadedNodePlayer.h"
@@ -33,6 +39,9 @@ using namespace std::literals;
 #include "model/tracks/tracktion_AutomationTrack.cpp"
 #include "model/tracks/tracktion_ChordTrack.cpp"
 #include "model/tracks/tracktion_ClipTrack.cpp"
+// BEATCONNECT MODIFICATION START
+#include "model/tracks/tracktion_ClipTrack.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "model/tracks/tracktion_MarkerTrack.cpp"
 #include "model/tracks/tracktion_MasterTrack.cpp"
 #include "model/tracks/tracktion_TempoTrack.cpp"
@@ -41,6 +50,10 @@ using namespace std::literals;
 #include "model/tracks/tracktion_TrackItem.cpp"
 #include "model/tracks/tracktion_TrackOutput.cpp"
 #include "model/tracks/tracktion_TrackCompManager.cpp"
+// BEATCONNECT MODIFICATION START
+#include "model/tracks/tracktion_AutoFreezeManager.cpp"
+#include "model/tracks/tracktion_AutoFreezeManager.test.cpp"
+// BEATCONNECT MODIFICATION END
 
 #include "model/edit/tracktion_GrooveTemplate.cpp"
 #include "model/edit/tracktion_MarkerManager.cpp"
@@ -69,6 +82,9 @@ using namespace std::literals;
 #include "project/tracktion_ProjectItemID.cpp"
 #include "project/tracktion_ProjectItem.cpp"
 #include "project/tracktion_Project.cpp"
+// BEATCONNECT MODIFICATION START
+#include "project/tracktion_Project.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "project/tracktion_ProjectManager.cpp"
 #include "project/tracktion_ProjectSearchIndex.cpp"
 
@@ -182,6 +182,9 @@ using namespace std::literals;
 
 #include "playback/graph/tracktion_CombiningNode.h"
 #include "playback/graph/tracktion_CombiningNode.cpp"
+// BEATCONNECT MODIFICATION START
+#include "playback/graph/tracktion_CombiningNode.test.cpp"
+// BEATCONNECT MODIFICATION END
 
 #include "playback/graph/tracktion_FadeInOutNode.h"
 #include "playback/graph/tracktion_FadeInOutNode.cpp"
@@ -272,11 +275,23 @@ using namespace std::literals;
 #include "playback/graph/tracktion_WaveNode.test.cpp"
 #include "playback/graph/tracktion_MidiNode.test.cpp"
 #include "playback/graph/tracktion_RackBenchmarks.test.cpp"
-
+// BEATCONNECT MODIFICATION START
+#include "playback/graph/tracktion_AuxRoutingBenchmarks.test.cpp"
+// BEATCONNECT MODIFICATION END
+
+// BEATCONNECT MODIFICATION START
+#include "playback/tracktion_OverloadPolicy.cpp"
+#include "playback/tracktion_OverloadPolicy.test.cpp"
+#include "playback/tracktion_ThreadPlacementPolicy.cpp"
+#include "playback/tracktion_ThreadPlacementPolicy.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "playback/tracktion_DeviceManager.cpp"
 #include "playback/tracktion_EditPlaybackContext.cpp"
 #include "playback/tracktion_EditInputDevices.cpp"
 #include "playback/tracktion_LevelMeasurer.cpp"
+// BEATCONNECT MODIFICATION START
+#include "playback/tracktion_LevelMeasurer.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "playback/tracktion_MidiNoteDispatcher.cpp"
 #include "playback/tracktion_TransportControl.test.cpp"
 #include "playback/tracktion_TransportControl.cpp"
@@ -303,6 +318,10 @@ using namespace std::literals;
 #include "playback/devices/tracktion_OutputDevice.cpp"
 #include "playback/devices/tracktion_WaveDeviceDescription.cpp"
 #include "playback/devices/tracktion_WaveInputDevice.cpp"
+// BEATCONNECT MODIFICATION START
+#include "playback/devices/tracktion_RelayInput.cpp"
+#include "playback/devices/tracktion_RelayInput.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "playback/devices/tracktion_WaveOutputDevice.cpp"
 
 #include "playback/tracktion_HostedAudioDevice.cpp"
@@ -324,6 +343,10 @@ static inline void sprintf (char* dest, size_t maxLength, const char* format, ..
 }
 
 #include "control_surfaces/tracktion_ControlSurface.cpp"
+// BEATCONNECT MODIFICATION START
+#include "control_surfaces/tracktion_ControlSurfaceOutputQueue.cpp"
+#include "control_surfaces/tracktion_ControlSurfaceOutputQueue.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "control_surfaces/tracktion_ExternalControllerManager.cpp"
 #include "control_surfaces/tracktion_ExternalController.cpp"
 #include "control_surfaces/tracktion_CustomControlSurface.cpp"
@@ -52,6 +52,10 @@ using namespace std::literals;
 #include "plugins/external/tracktion_ExternalAutomatableParameter.h"
 #include "plugins/external/tracktion_ExternalPluginBlacklist.h"
 #include "plugins/external/tracktion_ExternalPlugin.cpp"
+// BEATCONNECT MODIFICATION START
+#include "plugins/tracktion_PluginInstancePool.cpp"
+#include "plugins/tracktion_PluginInstancePool.test.cpp"
+// BEATCONNECT MODIFICATION END
 
 #include "plugins/internal/tracktion_AuxReturn.cpp"
 #include "plugins/internal/tracktion_AuxSend.cpp"
@@ -69,10 +73,22 @@ using namespace std::literals;
 #include "plugins/effects/tracktion_Chorus.cpp"
 #include "plugins/effects/tracktion_Compressor.cpp"
 #include "plugins/effects/tracktion_Delay.cpp"
+// BEATCONNECT MODIFICATION START
+#include "plugins/effects/tracktion_EffectKernels.cpp"
+// BEATCONNECT MODIFICATION END
 #include "plugins/effects/tracktion_FourOscPlugin.cpp"
+// BEATCONNECT MODIFICATION START
+#include "plugins/effects/tracktion_FourOscPlugin.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "plugins/effects/tracktion_LatencyPlugin.cpp"
 #include "plugins/effects/tracktion_Equaliser.cpp"
+// BEATCONNECT MODIFICATION START
+#include "plugins/effects/tracktion_ImpulseResponseCache.cpp"
+// BEATCONNECT MODIFICATION END
 #include "plugins/effects/tracktion_ImpulseResponsePlugin.cpp"
+// BEATCONNECT MODIFICATION START
+#include "plugins/effects/tracktion_ImpulseResponsePlugin.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "plugins/effects/tracktion_LowPass.cpp"
 #include "plugins/effects/tracktion_MidiModifier.cpp"
 #include "plugins/effects/tracktion_MidiPatchBay.cpp"
@@ -83,6 +99,7 @@ using namespace std::literals;
 #include "plugins/effects/tracktion_SamplerPlugin.cpp"
 #include "plugins/effects/tracktion_ToneGenerator.cpp"
 // BEATCONNECT MODIFICATION START
+#include "plugins/effects/tracktion_EffectKernels.test.cpp"
 #include "plugins/effects/DrumMachinePlugin.cpp"
 // BEATCONNECT MODIFICATION END
 
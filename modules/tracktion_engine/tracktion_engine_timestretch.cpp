@@ -10,6 +10,10 @@
 
 #if ! JUCE_PROJUCER_LIVE_BUILD
 
+// BEATCONNECT MODIFICATION START
+#include <future>
+// BEATCONNECT MODIFICATION END
+
 #include "tracktion_engine.h"
 
 #if TRACKTION_ENABLE_TIMESTRETCH_ELASTIQUE
@@ -65,6 +69,10 @@
 
 #include "timestretch/tracktion_TimeStretch.cpp"
 #include "timestretch/tracktion_TimeStretch.test.cpp"
+// BEATCONNECT MODIFICATION START
+#include "timestretch/tracktion_ParallelTimeStretch.cpp"
+#include "timestretch/tracktion_ParallelTimeStretch.test.cpp"
+// BEATCONNECT MODIFICATION END
 
 namespace tracktion { inline namespace engine
 {
@@ -65,9 +65,20 @@ extern "C" char MacGetMacFSRefForREXDLL (FSRef* fsRef)
 #include "utilities/tracktion_ExternalPlayheadSynchroniser.cpp"
 #include "utilities/tracktion_Envelope.cpp"
 #include "utilities/tracktion_FileUtilities.cpp"
+// BEATCONNECT MODIFICATION START
+#include "utilities/tracktion_IntervalTree.test.cpp"
+// BEATCONNECT MODIFICATION END
+// BEATCONNECT MODIFICATION START
+#include "utilities/tracktion_LoudnessMeter.cpp"
+#include "utilities/tracktion_LoudnessMeter.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "utilities/tracktion_Oscillators.cpp"
 #include "utilities/tracktion_PropertyStorage.cpp"
 #include "utilities/tracktion_UIBehaviour.cpp"
+// BEATCONNECT MODIFICATION START
+#include "utilities/tracktion_ValueTreeSnapshot.cpp"
+#include "utilities/tracktion_ValueTreeSnapshot.test.cpp"
+// BEATCONNECT MODIFICATION END
 #include "utilities/tracktion_TemporaryFileManager.cpp"
 #include "utilities/tracktion_Engine.cpp"
 #include "utilities/tracktion_BinaryData.cpp"
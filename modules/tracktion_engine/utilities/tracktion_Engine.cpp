@@ -48,6 +48,16 @@ void Engine::initialise()
 {
     Selectable::initialise();
     AudioScratchBuffer::initialise();
+
+    // BEATCONNECT MODIFICATION START
+    // Threads inherit the CPUs of the thread that creates them, so placing this thread
+    // first keeps the threads created below off any CPUs reserved for audio
+    threadPlacementPolicy.reset (new ThreadPlacementPolicy());
+    engineBehaviour->initialiseThreadPlacement (*threadPlacementPolicy);
+
+    if (threadPlacementPolicy->hasPlacement (ThreadPlacementPolicy::ThreadRole::housekeeping))
+        threadPlacementPolicy->applyToCurrentThread (ThreadPlacementPolicy::ThreadRole::housekeeping, "Message thread");
+    // BEATCONNECT MODIFICATION END
     
     projectManager.reset (new ProjectManager (*this));
     activeEdits.reset (new ActiveEdits());
@@ -109,6 +119,10 @@ Engine::~Engine()
     audioFileManager.reset();
     midiLearnState.reset();
     audioFileFormatManager.reset();
+    // BEATCONNECT MODIFICATION START
+    impulseResponseCache.reset();
+    threadPlacementPolicy.reset();
+    // BEATCONNECT MODIFICATION END
 
     instance = nullptr;
     engines.removeFirstMatchingValue (this);
@@ -264,6 +278,21 @@ WarpTimeFactory& Engine::getWarpTimeFactory() const
     return *warpTimeFactory;
 }
 
+// BEATCONNECT MODIFICATION START
+ImpulseResponseCache& Engine::getImpulseResponseCache() const
+{
+    if (! impulseResponseCache)
+        impulseResponseCache = std::make_unique<ImpulseResponseCache> (threadPlacementPolicy.get());
+
+    return *impulseResponseCache;
+}
+
+ThreadPlacementPolicy& Engine::getThreadPlacementPolicy() const
+{
+    return *threadPlacementPolicy;
+}
+// BEATCONNECT MODIFICATION END
+
 // BEATCONNECT MODIFICATION START
 // TODO: Remove when S3 is finallized 
 //  Engine::FifoBundle::FifoBundle(const double p_PunchIn, const juce::Array<AudioTrack*>&& p_Tracks)
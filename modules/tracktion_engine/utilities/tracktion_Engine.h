@@ -93,6 +93,10 @@ public:
     CompFactory& getCompFactory() const;                                ///< Returns the CompFactory instance.
     WarpTimeFactory& getWarpTimeFactory() const;                        ///< Returns the WarpTimeFactory instance.
     ProjectManager& getProjectManager() const;                          ///< Returns the ProjectManager instance.
+    // BEATCONNECT MODIFICATION START
+    ImpulseResponseCache& getImpulseResponseCache() const;              ///< Returns the ImpulseResponseCache instance.
+    ThreadPlacementPolicy& getThreadPlacementPolicy() const;            ///< Returns the ThreadPlacementPolicy instance.
+    // BEATCONNECT MODIFICATION END
 
     using WeakRef = juce::WeakReference<Engine>;
 
@@ -125,6 +129,10 @@ private:
     mutable std::unique_ptr<GrooveTemplateManager> grooveTemplateManager;
     mutable std::unique_ptr<CompFactory> compFactory;
     mutable std::unique_ptr<WarpTimeFactory> warpTimeFactory;
+    // BEATCONNECT MODIFICATION START
+    mutable std::unique_ptr<ImpulseResponseCache> impulseResponseCache;
+    std::unique_ptr<ThreadPlacementPolicy> threadPlacementPolicy;
+    // BEATCONNECT MODIFICATION END
 
     JUCE_DECLARE_WEAK_REFERENCEABLE (Engine)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Engine)
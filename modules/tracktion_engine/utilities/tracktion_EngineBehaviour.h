@@ -62,6 +62,22 @@ public:
     /** Gives the host a chance to do any extra configuration after a plugin is loaded */
     virtual void doAdditionalInitialisation (ExternalPlugin&)                       {}
 
+    // BEATCONNECT MODIFICATION START
+    /** Should return true if the given plugin can safely be instantiated and have its state
+        restored on a background thread.
+        When an Edit is opened, the PluginInstancePool will load these in parallel before the
+        plugins are created. Most plugin formats expect to be created on the message thread
+        so this is false by default.
+    */
+    virtual bool canLoadPluginOffMessageThread (const juce::PluginDescription&)     { return false; }
+
+    /** Should return the maximum number of idle, reset instances of the given plugin to keep
+        in the PluginInstancePool when ExternalPlugins are deleted, ready to be reused by the
+        next Edit. Return 0 to delete instances straight away.
+    */
+    virtual int getMaxNumPooledPluginInstances (const juce::PluginDescription&)     { return 0; }
+    // BEATCONNECT MODIFICATION END
+
     /** If you have any special VST plugins that access items in the Edit, you need to return them */
     virtual juce::Array<Exportable::ReferencedItem> getReferencedItems (ExternalPlugin&) { return {}; }
 
@@ -129,6 +145,42 @@ public:
 
     virtual int getNumberOfCPUsToUseForAudio()                                      { return juce::jmax (1, juce::SystemStats::getNumCpus()); }
 
+    // BEATCONNECT MODIFICATION START
+    /** Should return the number of threads to use when rendering time-stretched proxies offline.
+        Long files will be split in to overlapping chunks and stretched in parallel.
+        Return 1 to always render them serially.
+    */
+    virtual int getNumberOfCPUsToUseForOfflineTimeStretching()                      { return juce::jmax (1, juce::SystemStats::getNumCpus()); }
+
+    /** Should return true if expensive tracks in an Edit should be frozen automatically in the background.
+        @see AutoFreezeManager
+    */
+    virtual bool shouldAutoFreezeExpensiveTracks (Edit&)                            { return false; }
+
+    /** Should return true if parameter changes from MIDI controllers and control surfaces should
+        go via the Edit's ParameterChangeQueue rather than being set synchronously on the
+        message thread. This coalesces rapid changes and hands them to the audio thread
+        without locking.
+        @see ParameterChangeQueue
+    */
+    virtual bool shouldQueueControllerParameterChanges()                            { return false; }
+
+    /** Should return the number of clips a track needs before the playback nodes for its clips
+        are only created when the play position gets near them, rather than all being created
+        when the playback graph is built. This isn't used when rendering.
+        By default this is disabled, so all the clip nodes are created up front.
+        @see CombiningNode::addLazyInput
+    */
+    virtual int getMinNumClipsToCreateClipNodesLazily()                             { return std::numeric_limits<int>::max(); }
+
+    /** Should return the maximum number of overlapping clips on a track that can be processed
+        in parallel when the Edit is played with more than one thread.
+        By default this is 1, so a track's clips are always processed serially.
+        @see CombiningNode::setMaxNumParallelInputs
+    */
+    virtual int getMaxNumParallelClipsPerTrack()                                    { return 1; }
+    // BEATCONNECT MODIFICATION END
+
     /** Should muted tracks processing be disabled to save CPU */
     virtual bool shouldProcessMutedTracks()                                         { return false; }
 
@@ -175,6 +227,14 @@ public:
     // 0 = normal, 1 = high, 2 = realtime
     virtual void setProcessPriority (int /*level*/)                                 {}
 
+    // BEATCONNECT MODIFICATION START
+    /** Called when the Engine is created, before it starts any threads, to set which
+        CPUs its threads should run on and how they should be scheduled.
+        @see ThreadPlacementPolicy
+    */
+    virtual void initialiseThreadPlacement (ThreadPlacementPolicy&)                {}
+    // BEATCONNECT MODIFICATION END
+
     /** If this returns true, you must implement describeWaveDevices to determine the wave devices for a given device.
         If it's false, a standard, stereo pair layout will be automatically generated.
     */
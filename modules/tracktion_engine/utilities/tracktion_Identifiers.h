@@ -684,6 +684,9 @@ namespace IDs
     DECLARE_ID(SamplerDrumPad)
     DECLARE_ID(Snare)
     DECLARE_ID(Tambourine)
+
+    // Overload IDs
+    DECLARE_ID(nonEssential)
     // BEATCONNECT MODIFICATIONS END HERE
 
     #undef DECLARE_ID
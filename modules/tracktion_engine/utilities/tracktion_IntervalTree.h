@@ -0,0 +1,411 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    An index of values by the range they occupy, e.g. clips by their time range
+    or notes by their beat range.
+
+    This is a balanced binary tree ordered by range start, where each node also
+    stores the latest end in its subtree. That means finding the values that
+    overlap a range or contain a position takes O(log n + k) where k is the
+    number of results. Adding, moving and removing values takes O(log n) so
+    it can be kept up to date as the things it indexes change.
+
+    The start and end of every range are also kept sorted so the nearest edge
+    to a position can be found in O(log n).
+
+    RangeType should be a TimeRange or BeatRange and ValueType something
+    hashable, usually a pointer. Each value can only be in the index once.
+
+    Values that start at the same position are returned in order of a key, which
+    can be given when they're added (e.g. an EditItemID) or is otherwise the order
+    they were first added in, so results don't depend on where things are in memory.
+
+    This isn't thread safe, it's up to the caller to synchronise access.
+*/
+template<typename RangeType, typename ValueType>
+class IntervalTree
+{
+public:
+    using Position = typename RangeType::Position;
+
+    //==============================================================================
+    IntervalTree() = default;
+    IntervalTree (IntervalTree&&) = default;
+    IntervalTree& operator= (IntervalTree&&) = default;
+
+    //==============================================================================
+    /** Adds a value, or moves it to a new range if it's already in the index.
+        Values added like this are ordered by when they were first added.
+    */
+    void insert (RangeType range, ValueType value)
+    {
+        auto found = ranges.find (value);
+        insert (range, value, found != ranges.end() ? found->second.key : nextKey++);
+    }
+
+    /** Adds a value, or moves it to a new range if it's already in the index.
+        Values that start at the same position are ordered by the key, so this must be
+        unique and shouldn't be mixed with values added without a key.
+    */
+    void insert (RangeType range, ValueType value, uint64_t key)
+    {
+        auto found = ranges.find (value);
+
+        if (found != ranges.end())
+        {
+            if (found->second.range == range && found->second.key == key)
+                return;
+
+            removeEntry (found->second, value);
+            found->second = { range, key };
+        }
+        else
+        {
+            ranges.emplace (value, Entry { range, key });
+        }
+
+        auto newNode = std::make_unique<Node>();
+        newNode->entry = { range, key };
+        newNode->value = value;
+        newNode->maxEnd = range.getEnd();
+        insertNode (root, std::move (newNode));
+
+        edges.insert (range.getStart());
+        edges.insert (range.getEnd());
+    }
+
+    /** Removes a value, returning false if it wasn't in the index. */
+    bool remove (const ValueType& value)
+    {
+        auto found = ranges.find (value);
+
+        if (found == ranges.end())
+            return false;
+
+        removeEntry (found->second, value);
+        ranges.erase (found);
+        return true;
+    }
+
+    /** Removes all the values. */
+    void clear()
+    {
+        root.reset();
+        ranges.clear();
+        edges.clear();
+        nextKey = 0;
+    }
+
+    //==============================================================================
+    /** Returns the number of values in the index. */
+    size_t size() const noexcept                                { return ranges.size(); }
+
+    /** Returns true if there are no values in the index. */
+    bool isEmpty() const noexcept                               { return ranges.empty(); }
+
+    /** Returns true if the value is in the index. */
+    bool contains (const ValueType& value) const                { return ranges.find (value) != ranges.end(); }
+
+    /** Returns the range a value was added with, if it's in the index. */
+    std::optional<RangeType> getRange (const ValueType& value) const
+    {
+        auto found = ranges.find (value);
+
+        if (found == ranges.end())
+            return {};
+
+        return found->second.range;
+    }
+
+    //==============================================================================
+    /** Calls a function for each value whose range overlaps the given one, in
+        order of their start positions.
+        This uses the same test as RangeType::overlaps.
+    */
+    template<typename Fn>
+    void visitOverlapping (RangeType range, Fn&& fn) const
+    {
+        visitOverlapping (root.get(), range, fn);
+    }
+
+    /** Calls a function for each value whose range contains the given position,
+        in order of their start positions.
+        This uses the same test as RangeType::contains.
+    */
+    template<typename Fn>
+    void visitContaining (Position position, Fn&& fn) const
+    {
+        visitContaining (root.get(), position, fn);
+    }
+
+    /** Returns the values whose ranges overlap the given one, in order of their start positions. */
+    std::vector<ValueType> getOverlapping (RangeType range) const
+    {
+        std::vector<ValueType> result;
+        visitOverlapping (range, [&result] (const ValueType& v) { result.push_back (v); });
+        return result;
+    }
+
+    /** Returns the values whose ranges contain the given position, in order of their start positions. */
+    std::vector<ValueType> getContaining (Position position) const
+    {
+        std::vector<ValueType> result;
+        visitContaining (position, [&result] (const ValueType& v) { result.push_back (v); });
+        return result;
+    }
+
+    //==============================================================================
+    /** Returns the first range start or end after a position, if there is one. */
+    std::optional<Position> getNextEdgeAfter (Position position) const
+    {
+        auto found = edges.upper_bound (position);
+
+        if (found == edges.end())
+            return {};
+
+        return *found;
+    }
+
+    /** Returns the last range start or end before a position, if there is one. */
+    std::optional<Position> getPreviousEdgeBefore (Position position) const
+    {
+        auto found = edges.lower_bound (position);
+
+        if (found == edges.begin())
+            return {};
+
+        return *std::prev (found);
+    }
+
+    /** Returns the range start or end closest to a position, if there is one. */
+    std::optional<Position> getNearestEdge (Position position) const
+    {
+        auto found = edges.lower_bound (position);
+
+        if (found == edges.end())
+            return getPreviousEdgeBefore (position);
+
+        if (found == edges.begin() || (*found - position) < (position - *std::prev (found)))
+            return *found;
+
+        return *std::prev (found);
+    }
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        RangeType range;
+        uint64_t key = 0;
+    };
+
+    struct Node
+    {
+        Entry entry;
+        ValueType value;
+        Position maxEnd;
+        int height = 1;
+        std::unique_ptr<Node> left, right;
+    };
+
+    std::unique_ptr<Node> root;
+    std::unordered_map<ValueType, Entry> ranges;
+    std::multiset<Position> edges;
+    uint64_t nextKey = 0;
+
+    //==============================================================================
+    static bool isBefore (const Entry& e1, const Entry& e2)
+    {
+        if (e1.range.getStart() != e2.range.getStart())
+            return e1.range.getStart() < e2.range.getStart();
+
+        return e1.key < e2.key;
+    }
+
+    static int getHeight (const std::unique_ptr<Node>& n) noexcept
+    {
+        return n != nullptr ? n->height : 0;
+    }
+
+    static void update (Node& n)
+    {
+        n.height = 1 + std::max (getHeight (n.left), getHeight (n.right));
+        n.maxEnd = n.entry.range.getEnd();
+
+        if (n.left != nullptr)  n.maxEnd = std::max (n.maxEnd, n.left->maxEnd);
+        if (n.right != nullptr) n.maxEnd = std::max (n.maxEnd, n.right->maxEnd);
+    }
+
+    static void rotateLeft (std::unique_ptr<Node>& n)
+    {
+        auto r = std::move (n->right);
+        n->right = std::move (r->left);
+        update (*n);
+        r->left = std::move (n);
+        n = std::move (r);
+        update (*n);
+    }
+
+    static void rotateRight (std::unique_ptr<Node>& n)
+    {
+        auto l = std::move (n->left);
+        n->left = std::move (l->right);
+        update (*n);
+        l->right = std::move (n);
+        n = std::move (l);
+        update (*n);
+    }
+
+    static void rebalance (std::unique_ptr<Node>& n)
+    {
+        update (*n);
+        const auto balance = getHeight (n->left) - getHeight (n->right);
+
+        if (balance > 1)
+        {
+            if (getHeight (n->left->left) < getHeight (n->left->right))
+                rotateLeft (n->left);
+
+            rotateRight (n);
+        }
+        else if (balance < -1)
+        {
+            if (getHeight (n->right->right) < getHeight (n->right->left))
+                rotateRight (n->right);
+
+            rotateLeft (n);
+        }
+    }
+
+    static void insertNode (std::unique_ptr<Node>& n, std::unique_ptr<Node> newNode)
+    {
+        if (n == nullptr)
+        {
+            n = std::move (newNode);
+            return;
+        }
+
+        if (isBefore (newNode->entry, n->entry))
+            insertNode (n->left, std::move (newNode));
+        else
+            insertNode (n->right, std::move (newNode));
+
+        rebalance (n);
+    }
+
+    static std::unique_ptr<Node> removeFirstNode (std::unique_ptr<Node>& n)
+    {
+        if (n->left == nullptr)
+        {
+            auto first = std::move (n);
+            n = std::move (first->right);
+            return first;
+        }
+
+        auto first = removeFirstNode (n->left);
+        rebalance (n);
+        return first;
+    }
+
+    static bool removeNode (std::unique_ptr<Node>& n, const Entry& entry, const ValueType& value)
+    {
+        if (n == nullptr)
+            return false;
+
+        if (n->value == value)
+        {
+            if (n->left == nullptr)
+            {
+                n = std::move (n->right);
+            }
+            else if (n->right == nullptr)
+            {
+                n = std::move (n->left);
+            }
+            else
+            {
+                auto next = removeFirstNode (n->right);
+                next->left = std::move (n->left);
+                next->right = std::move (n->right);
+                n = std::move (next);
+            }
+
+            if (n != nullptr)
+                rebalance (n);
+
+            return true;
+        }
+
+        const bool removed = isBefore (entry, n->entry) ? removeNode (n->left, entry, value)
+                                                        : removeNode (n->right, entry, value);
+
+        if (removed)
+            rebalance (n);
+
+        return removed;
+    }
+
+    void removeEntry (const Entry& entry, const ValueType& value)
+    {
+        [[maybe_unused]] const bool removed = removeNode (root, entry, value);
+        jassert (removed);
+
+        edges.erase (edges.find (entry.range.getStart()));
+        edges.erase (edges.find (entry.range.getEnd()));
+    }
+
+    template<typename Fn>
+    static void visitOverlapping (const Node* n, const RangeType& range, Fn& fn)
+    {
+        // Nothing in this subtree ends after the start of the range
+        if (n == nullptr || n->maxEnd <= range.getStart())
+            return;
+
+        visitOverlapping (n->left.get(), range, fn);
+
+        // Everything to the right starts at or after this one
+        if (n->entry.range.getStart() >= range.getEnd())
+            return;
+
+        if (n->entry.range.overlaps (range))
+            fn (n->value);
+
+        visitOverlapping (n->right.get(), range, fn);
+    }
+
+    template<typename Fn>
+    static void visitContaining (const Node* n, Position position, Fn& fn)
+    {
+        if (n == nullptr || n->maxEnd <= position)
+            return;
+
+        visitContaining (n->left.get(), position, fn);
+
+        if (n->entry.range.getStart() > position)
+            return;
+
+        if (n->entry.range.contains (position))
+            fn (n->value);
+
+        visitContaining (n->right.get(), position, fn);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (IntervalTree)
+};
+
+}} // namespace tracktion { inline namespace engine
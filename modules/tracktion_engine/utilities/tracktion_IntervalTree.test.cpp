@@ -0,0 +1,143 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class IntervalTreeTests  : public juce::UnitTest
+{
+public:
+    IntervalTreeTests()
+        : juce::UnitTest ("IntervalTree", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runBruteForceTests();
+        runOrderingTests();
+    }
+
+private:
+    static TimeRange secondsRange (double start, double end)
+    {
+        return { TimePosition::fromSeconds (start), TimePosition::fromSeconds (end) };
+    }
+
+    void runBruteForceTests()
+    {
+        beginTest ("Matches brute force");
+
+        // Compare a randomly changing tree against a brute force search
+        juce::Random r (42);
+        IntervalTree<TimeRange, int> tree;
+        std::map<int, TimeRange> ranges;
+
+        auto randomRange = [&r]
+        {
+            const auto start = r.nextInt (1000) / 10.0;
+            return secondsRange (start, start + r.nextInt (100) / 10.0);
+        };
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            const int value = r.nextInt (200);
+
+            switch (r.nextInt (3))
+            {
+                case 0:
+                {
+                    const auto range = randomRange();
+                    tree.insert (range, value);
+                    ranges[value] = range;
+                    break;
+                }
+                case 1:
+                {
+                    expectEquals (tree.remove (value), ranges.erase (value) > 0);
+                    break;
+                }
+                default:
+                {
+                    const auto query = randomRange();
+                    std::vector<int> expectedOverlapping, expectedContaining;
+                    std::optional<TimePosition> expectedNext, expectedPrevious;
+
+                    for (auto& [v, range] : ranges)
+                    {
+                        if (range.overlaps (query))                     expectedOverlapping.push_back (v);
+                        if (range.contains (query.getStart()))          expectedContaining.push_back (v);
+
+                        for (auto edge : { range.getStart(), range.getEnd() })
+                        {
+                            if (edge > query.getStart() && (! expectedNext || edge < *expectedNext))
+                                expectedNext = edge;
+
+                            if (edge < query.getStart() && (! expectedPrevious || edge > *expectedPrevious))
+                                expectedPrevious = edge;
+                        }
+                    }
+
+                    auto overlapping = tree.getOverlapping (query);
+                    auto containing = tree.getContaining (query.getStart());
+
+                    for (size_t n = 1; n < overlapping.size(); ++n)
+                        expect (ranges[overlapping[n - 1]].getStart() <= ranges[overlapping[n]].getStart(), "Results should be sorted");
+
+                    std::sort (overlapping.begin(), overlapping.end());
+                    std::sort (containing.begin(), containing.end());
+                    expect (overlapping == expectedOverlapping);
+                    expect (containing == expectedContaining);
+                    expect (tree.getNextEdgeAfter (query.getStart()) == expectedNext);
+                    expect (tree.getPreviousEdgeBefore (query.getStart()) == expectedPrevious);
+                    break;
+                }
+            }
+
+            expectEquals ((int) tree.size(), (int) ranges.size());
+        }
+    }
+
+    void runOrderingTests()
+    {
+        beginTest ("Values that start together");
+
+        // Without keys, values are kept in the order they were first added
+        IntervalTree<TimeRange, int> tree;
+
+        for (int v : { 3, 1, 2 })
+            tree.insert (secondsRange (0.0, 1.0 + v), v);
+
+        tree.insert (secondsRange (0.0, 5.0), 3);
+        expect (tree.getContaining (TimePosition::fromSeconds (0.5)) == std::vector<int> { 3, 1, 2 }, "Moving a value shouldn't change its order");
+
+        tree.remove (1);
+        tree.insert (secondsRange (0.0, 1.0), 1);
+        expect (tree.getContaining (TimePosition::fromSeconds (0.5)) == std::vector<int> { 3, 2, 1 }, "A value added again should go last");
+
+        // Otherwise they're ordered by their keys
+        IntervalTree<TimeRange, int> keyedTree;
+
+        for (int v : { 3, 1, 2 })
+            keyedTree.insert (secondsRange (0.0, 1.0), v, (uint64_t) v);
+
+        expect (keyedTree.getOverlapping (secondsRange (0.0, 1.0)) == std::vector<int> { 1, 2, 3 });
+    }
+};
+
+static IntervalTreeTests intervalTreeTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
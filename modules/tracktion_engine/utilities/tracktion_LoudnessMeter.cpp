@@ -0,0 +1,323 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace
+{
+    // Blocks quieter than this are ignored by the integrated loudness and loudness range
+    constexpr float absoluteGateLoudness = -70.0f;
+
+    inline float powerToLoudness (double power) noexcept
+    {
+        if (power <= 0.0)
+            return -100.0f;
+
+        return std::max (-100.0f, (float) (-0.691 + 10.0 * std::log10 (power)));
+    }
+
+    inline double loudnessToPower (float loudness) noexcept
+    {
+        return std::pow (10.0, (loudness + 0.691) / 10.0);
+    }
+
+    template<typename Fn>
+    double getGatedMeanPower (const std::vector<double>& powers, double threshold, Fn&& onIncluded)
+    {
+        double sum = 0.0;
+        int num = 0;
+
+        for (auto p : powers)
+        {
+            if (p > threshold)
+            {
+                sum += p;
+                ++num;
+                onIncluded (p);
+            }
+        }
+
+        return num > 0 ? sum / num : 0.0;
+    }
+}
+
+//==============================================================================
+LoudnessMeter::Result LoudnessMeter::Result::withGain (float gainDb) const noexcept
+{
+    auto addGain = [gainDb] (float level) { return level > -100.0f ? level + gainDb : level; };
+
+    auto r = *this;
+    r.integratedLoudness = addGain (integratedLoudness);
+    r.maxMomentaryLoudness = addGain (maxMomentaryLoudness);
+    r.maxShortTermLoudness = addGain (maxShortTermLoudness);
+    r.truePeak = addGain (truePeak);
+    return r;
+}
+
+//==============================================================================
+void LoudnessMeter::prepare (double newSampleRate, int numChannels)
+{
+    jassert (newSampleRate > 0.0 && numChannels > 0);
+    sampleRate = newSampleRate;
+    channels.assign ((size_t) numChannels, {});
+
+    // The K-weighting filters, a high shelf modelling the head followed by a high-pass.
+    // These are the BS.1770 coefficients recalculated for the sample rate.
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        const auto k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        const auto vh = std::pow (10.0, gainDb / 20.0);
+        const auto vb = std::pow (vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        for (auto& c : channels)
+        {
+            c.preFilter.b0 = (vh + vb * k / q + k * k) / a0;
+            c.preFilter.b1 = 2.0 * (k * k - vh) / a0;
+            c.preFilter.b2 = (vh - vb * k / q + k * k) / a0;
+            c.preFilter.a1 = 2.0 * (k * k - 1.0) / a0;
+            c.preFilter.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const auto k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        for (auto& c : channels)
+        {
+            c.highPass.b0 = 1.0;
+            c.highPass.b1 = -2.0;
+            c.highPass.b2 = 1.0;
+            c.highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+            c.highPass.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    // The true-peak interpolator is a Hann windowed sinc split into one set of
+    // taps for each of the oversampled phases
+    {
+        constexpr int numTaps = oversamplingFactor * numTruePeakTaps;
+        constexpr double centre = (numTaps - 1) / 2.0;
+
+        for (int phase = 0; phase < oversamplingFactor; ++phase)
+        {
+            double sum = 0.0;
+
+            for (int i = 0; i < numTruePeakTaps; ++i)
+            {
+                const auto n = i * oversamplingFactor + phase - centre;
+                const auto t = n / oversamplingFactor;
+                const auto sinc = std::abs (t) < 1.0e-9 ? 1.0 : std::sin (juce::MathConstants<double>::pi * t) / (juce::MathConstants<double>::pi * t);
+                const auto window = 0.5 + 0.5 * std::cos (juce::MathConstants<double>::pi * n / (centre + 0.5));
+
+                truePeakCoefficients[phase][i] = (float) (sinc * window);
+                sum += sinc * window;
+            }
+
+            for (auto& coeff : truePeakCoefficients[phase])
+                coeff = (float) (coeff / sum);
+        }
+    }
+
+    subBlockLength = std::max (1, juce::roundToInt (sampleRate * 0.1));
+    reset();
+}
+
+void LoudnessMeter::reset()
+{
+    for (auto& c : channels)
+    {
+        c.preFilter.z1 = c.preFilter.z2 = 0.0;
+        c.highPass.z1 = c.highPass.z2 = 0.0;
+        std::fill (std::begin (c.truePeakHistory), std::end (c.truePeakHistory), 0.0f);
+        c.truePeakHistoryPos = 0;
+    }
+
+    numSamplesInSubBlock = 0;
+    subBlockSum = 0.0;
+    std::fill (std::begin (subBlockPowers), std::end (subBlockPowers), 0.0);
+    numSubBlocks = 0;
+
+    momentaryPowers.clear();
+    shortTermPowers.clear();
+    momentaryLoudness = shortTermLoudness = -100.0f;
+    maxMomentaryLoudness = maxShortTermLoudness = -100.0f;
+    truePeak = 0.0f;
+}
+
+void LoudnessMeter::process (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    jassert (! channels.empty());
+    const auto numChannels = std::min ((int) channels.size(), buffer.getNumChannels());
+
+    while (numSamples > 0)
+    {
+        // Measure up to the end of the current 100ms sub-block
+        const auto numThisTime = std::min (numSamples, subBlockLength - numSamplesInSubBlock);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            auto& state = channels[(size_t) c];
+            auto src = buffer.getReadPointer (c, startSample);
+            double sum = 0.0;
+            float peak = truePeak;
+
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                peak = std::max (peak, processTruePeak (state, src[i]));
+
+                const auto y = state.highPass.process (state.preFilter.process (src[i]));
+                sum += y * y;
+            }
+
+            subBlockSum += sum;
+            truePeak = peak;
+        }
+
+        numSamplesInSubBlock += numThisTime;
+        startSample += numThisTime;
+        numSamples -= numThisTime;
+
+        if (numSamplesInSubBlock == subBlockLength)
+            endSubBlock();
+    }
+}
+
+LoudnessMeter::Result LoudnessMeter::getResult() const
+{
+    Result r;
+    r.maxMomentaryLoudness = maxMomentaryLoudness;
+    r.maxShortTermLoudness = maxShortTermLoudness;
+    r.truePeak = gainToDb (truePeak);
+
+    const auto absoluteGate = loudnessToPower (absoluteGateLoudness);
+
+    // Integrated loudness uses the overlapping 400ms blocks, gated at -70 LUFS and
+    // then at 10 LU below the loudness of the blocks that pass the first gate
+    {
+        const auto ungatedPower = getGatedMeanPower (momentaryPowers, absoluteGate, [] (double) {});
+
+        if (ungatedPower > 0.0)
+        {
+            const auto relativeGate = std::max (absoluteGate, loudnessToPower (powerToLoudness (ungatedPower) - 10.0f));
+            r.integratedLoudness = powerToLoudness (getGatedMeanPower (momentaryPowers, relativeGate, [] (double) {}));
+        }
+    }
+
+    // Loudness range is the spread between the 10th and 95th percentiles of the
+    // short-term loudness, gated at -70 LUFS and then at 20 LU below
+    {
+        const auto ungatedPower = getGatedMeanPower (shortTermPowers, absoluteGate, [] (double) {});
+
+        if (ungatedPower > 0.0)
+        {
+            const auto relativeGate = std::max (absoluteGate, loudnessToPower (powerToLoudness (ungatedPower) - 20.0f));
+            std::vector<float> levels;
+            getGatedMeanPower (shortTermPowers, relativeGate, [&levels] (double p) { levels.push_back (powerToLoudness (p)); });
+
+            if (! levels.empty())
+            {
+                std::sort (levels.begin(), levels.end());
+                auto getPercentile = [&levels] (double percentile)
+                {
+                    return levels[(size_t) juce::roundToInt (percentile * (double) (levels.size() - 1))];
+                };
+
+                r.loudnessRange = getPercentile (0.95) - getPercentile (0.1);
+            }
+        }
+    }
+
+    return r;
+}
+
+float LoudnessMeter::getNormalisingGainDb (const Result& r, float targetLoudness, float maxTruePeakDb) noexcept
+{
+    // Silence can't be brought up to the target
+    if (r.integratedLoudness <= absoluteGateLoudness)
+        return 0.0f;
+
+    auto gainDb = targetLoudness - r.integratedLoudness;
+
+    if (r.truePeak > -100.0f)
+        gainDb = std::min (gainDb, maxTruePeakDb - r.truePeak);
+
+    return gainDb;
+}
+
+//==============================================================================
+void LoudnessMeter::endSubBlock()
+{
+    subBlockPowers[numSubBlocks % numShortTermSubBlocks] = subBlockSum / subBlockLength;
+    ++numSubBlocks;
+    subBlockSum = 0.0;
+    numSamplesInSubBlock = 0;
+
+    // The windows overlap, moving on by one sub-block each time
+    if (numSubBlocks >= numMomentarySubBlocks)
+    {
+        const auto power = getMeanPower (numMomentarySubBlocks);
+        momentaryPowers.push_back (power);
+        momentaryLoudness = powerToLoudness (power);
+        maxMomentaryLoudness = std::max (maxMomentaryLoudness, momentaryLoudness);
+    }
+
+    if (numSubBlocks >= numShortTermSubBlocks)
+    {
+        const auto power = getMeanPower (numShortTermSubBlocks);
+        shortTermPowers.push_back (power);
+        shortTermLoudness = powerToLoudness (power);
+        maxShortTermLoudness = std::max (maxShortTermLoudness, shortTermLoudness);
+    }
+}
+
+double LoudnessMeter::getMeanPower (int numBlocksToAverage) const noexcept
+{
+    double sum = 0.0;
+
+    for (int i = 1; i <= numBlocksToAverage; ++i)
+        sum += subBlockPowers[(numSubBlocks - i) % numShortTermSubBlocks];
+
+    return sum / numBlocksToAverage;
+}
+
+float LoudnessMeter::processTruePeak (ChannelState& state, float sample) noexcept
+{
+    // Writing each sample twice means the last numTruePeakTaps samples, newest
+    // first, always start at truePeakHistoryPos
+    auto pos = state.truePeakHistoryPos - 1;
+
+    if (pos < 0)
+        pos += numTruePeakTaps;
+
+    state.truePeakHistory[pos] = sample;
+    state.truePeakHistory[pos + numTruePeakTaps] = sample;
+    state.truePeakHistoryPos = pos;
+
+    auto history = state.truePeakHistory + pos;
+    auto peak = std::abs (sample);
+
+    for (auto& coefficients : truePeakCoefficients)
+    {
+        float y = 0.0f;
+
+        for (int i = 0; i < numTruePeakTaps; ++i)
+            y += coefficients[i] * history[i];
+
+        peak = std::max (peak, std::abs (y));
+    }
+
+    return peak;
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,117 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    Measures the loudness of a stream of audio as described by EBU R128 and
+    ITU-R BS.1770-4.
+
+    Feed it consecutive blocks with process() and call getResult() to find the
+    integrated, short-term and momentary loudness, the loudness range and the
+    true-peak level of everything it's been given so far. All the channels are
+    treated as front channels, i.e. with a weighting of 1.
+
+    This isn't thread safe and is intended to be used on a render thread.
+*/
+class LoudnessMeter
+{
+public:
+    //==============================================================================
+    /** The loudness figures of the audio measured so far. */
+    struct Result
+    {
+        float integratedLoudness = -100.0f;     /**< The gated loudness of the whole programme, in LUFS. */
+        float maxMomentaryLoudness = -100.0f;   /**< The loudest 400ms window, in LUFS. */
+        float maxShortTermLoudness = -100.0f;   /**< The loudest 3s window, in LUFS. */
+        float loudnessRange = 0.0f;             /**< The spread of the short-term loudness, in LU. */
+        float truePeak = -100.0f;               /**< The peak level of the 4x oversampled signal, in dBTP. */
+
+        /** Returns the figures after a gain in dB has been applied to the audio. */
+        Result withGain (float gainDb) const noexcept;
+    };
+
+    //==============================================================================
+    LoudnessMeter() = default;
+
+    /** Prepares the meter for audio at a given rate and clears any measurements. */
+    void prepare (double sampleRate, int numChannels);
+
+    /** Clears the measurements. */
+    void reset();
+
+    /** Measures the next block of audio. */
+    void process (const juce::AudioBuffer<float>&, int startSample, int numSamples);
+
+    /** Returns the figures of all the audio measured since the meter was prepared or reset. */
+    Result getResult() const;
+
+    /** Returns the loudness of the most recent 400ms, in LUFS. */
+    float getMomentaryLoudness() const noexcept             { return momentaryLoudness; }
+
+    /** Returns the loudness of the most recent 3s, in LUFS. */
+    float getShortTermLoudness() const noexcept             { return shortTermLoudness; }
+
+    //==============================================================================
+    /** Returns the gain in dB needed to bring a Result to a target integrated
+        loudness whilst keeping its true-peak level at or below a ceiling.
+    */
+    static float getNormalisingGainDb (const Result&, float targetLoudness, float maxTruePeakDb) noexcept;
+
+private:
+    //==============================================================================
+    static constexpr int oversamplingFactor = 4, numTruePeakTaps = 12;
+    static constexpr int numMomentarySubBlocks = 4, numShortTermSubBlocks = 30;
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double z1 = 0.0, z2 = 0.0;
+
+        double process (double x) noexcept
+        {
+            const auto y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    struct ChannelState
+    {
+        Biquad preFilter, highPass;
+        float truePeakHistory[numTruePeakTaps * 2] = {};   // Doubled so the taps can always be read contiguously
+        int truePeakHistoryPos = 0;
+    };
+
+    double sampleRate = 44100.0;
+    std::vector<ChannelState> channels;
+    float truePeakCoefficients[oversamplingFactor][numTruePeakTaps] = {};
+
+    int subBlockLength = 4410, numSamplesInSubBlock = 0;
+    double subBlockSum = 0.0;
+    double subBlockPowers[numShortTermSubBlocks] = {};
+    int64_t numSubBlocks = 0;
+
+    std::vector<double> momentaryPowers, shortTermPowers;
+    float momentaryLoudness = -100.0f, shortTermLoudness = -100.0f;
+    float maxMomentaryLoudness = -100.0f, maxShortTermLoudness = -100.0f;
+    float truePeak = 0.0f;
+
+    void endSubBlock();
+    double getMeanPower (int numBlocksToAverage) const noexcept;
+    float processTruePeak (ChannelState&, float sample) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessMeter)
+};
+
+}} // namespace tracktion { inline namespace engine
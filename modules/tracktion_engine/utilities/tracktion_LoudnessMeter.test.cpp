@@ -0,0 +1,135 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class LoudnessMeterTests  : public juce::UnitTest
+{
+public:
+    LoudnessMeterTests()
+        : juce::UnitTest ("LoudnessMeter", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0 })
+        {
+            runLoudnessTests (sampleRate);
+            runTruePeakTests (sampleRate);
+        }
+
+        runNormalisingTests();
+    }
+
+private:
+    static void addSine (LoudnessMeter& meter, double sampleRate, double seconds, float levelDb,
+                         double frequency, int numChannels, int blockSize = 512, double phase = 0.0)
+    {
+        const auto numSamples = (int) (sampleRate * seconds);
+        const auto amplitude = dbToGain (levelDb);
+        juce::AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (c, i, amplitude * (float) std::sin (juce::MathConstants<double>::twoPi * frequency * i / sampleRate + phase));
+
+        for (int start = 0; start < numSamples; start += blockSize)
+            meter.process (buffer, start, std::min (blockSize, numSamples - start));
+    }
+
+    void runLoudnessTests (double sampleRate)
+    {
+        beginTest ("Loudness at " + juce::String (sampleRate) + "Hz");
+
+        LoudnessMeter meter;
+        meter.prepare (sampleRate, 2);
+
+        // A stereo 1kHz sine at -23dBFS should read -23 LUFS
+        addSine (meter, sampleRate, 20.0, -23.0f, 1000.0, 2);
+        auto r = meter.getResult();
+        expectWithinAbsoluteError (r.integratedLoudness, -23.0f, 0.1f);
+        expectWithinAbsoluteError (r.maxMomentaryLoudness, -23.0f, 0.1f);
+        expectWithinAbsoluteError (r.maxShortTermLoudness, -23.0f, 0.1f);
+        expectWithinAbsoluteError (meter.getShortTermLoudness(), -23.0f, 0.1f);
+        expectWithinAbsoluteError (r.loudnessRange, 0.0f, 0.1f);
+
+        // The quiet sections should be gated out of the integrated loudness
+        meter.reset();
+        addSine (meter, sampleRate, 10.0, -36.0f, 1000.0, 2);
+        addSine (meter, sampleRate, 60.0, -23.0f, 1000.0, 2);
+        addSine (meter, sampleRate, 10.0, -36.0f, 1000.0, 2);
+        r = meter.getResult();
+        expectWithinAbsoluteError (r.integratedLoudness, -23.0f, 0.1f);
+        expectWithinAbsoluteError (r.loudnessRange, 13.0f, 0.5f);
+
+        // As should silence
+        meter.reset();
+        addSine (meter, sampleRate, 10.0, -23.0f, 1000.0, 2);
+        addSine (meter, sampleRate, 10.0, -200.0f, 1000.0, 2);
+        expectWithinAbsoluteError (meter.getResult().integratedLoudness, -23.0f, 0.1f);
+
+        // The block size shouldn't make any difference
+        LoudnessMeter otherMeter;
+        otherMeter.prepare (sampleRate, 2);
+        meter.reset();
+        addSine (meter, sampleRate, 5.0, -18.0f, 440.0, 2, 512);
+        addSine (otherMeter, sampleRate, 5.0, -18.0f, 440.0, 2, 37);
+        expectWithinAbsoluteError (meter.getResult().integratedLoudness, otherMeter.getResult().integratedLoudness, 0.001f);
+    }
+
+    void runTruePeakTests (double sampleRate)
+    {
+        beginTest ("True peak at " + juce::String (sampleRate) + "Hz");
+
+        // A quarter sample rate sine with a 45 degree phase has samples at only 0.707
+        // of its amplitude, so the sample peak is 3dB lower than the true peak
+        LoudnessMeter meter;
+        meter.prepare (sampleRate, 1);
+        addSine (meter, sampleRate, 1.0, 0.0f, sampleRate / 4.0, 1, 512, juce::MathConstants<double>::pi / 4.0);
+        expectWithinAbsoluteError (meter.getResult().truePeak, 0.0f, 0.2f);
+
+        meter.reset();
+        addSine (meter, sampleRate, 1.0, -12.0f, 997.0, 1);
+        expectWithinAbsoluteError (meter.getResult().truePeak, -12.0f, 0.1f);
+    }
+
+    void runNormalisingTests()
+    {
+        beginTest ("Normalising gain");
+
+        LoudnessMeter::Result r;
+        r.integratedLoudness = -20.0f;
+        r.truePeak = -6.0f;
+
+        expectWithinAbsoluteError (LoudnessMeter::getNormalisingGainDb (r, -14.0f, -1.0f), 5.0f, 0.001f,
+                                   "The gain should be limited by the true-peak ceiling");
+        expectWithinAbsoluteError (LoudnessMeter::getNormalisingGainDb (r, -23.0f, -1.0f), -3.0f, 0.001f);
+
+        auto normalised = r.withGain (5.0f);
+        expectWithinAbsoluteError (normalised.integratedLoudness, -15.0f, 0.001f);
+        expectWithinAbsoluteError (normalised.truePeak, -1.0f, 0.001f);
+        expectEquals (normalised.maxShortTermLoudness, -100.0f, "Unmeasured figures shouldn't change");
+
+        LoudnessMeter::Result silent;
+        expectEquals (LoudnessMeter::getNormalisingGainDb (silent, -14.0f, -1.0f), 0.0f);
+    }
+};
+
+static LoudnessMeterTests loudnessMeterTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
@@ -311,6 +311,186 @@ void MultiVoiceOscillator::process (juce::AudioBuffer<float>& buffer, int startS
     }
 }
 
+// BEATCONNECT MODIFICATION START
+#if JUCE_USE_SIMD
+void MultiVoiceOscillator::processLanes (MultiVoiceOscillator* const* oscs, int numOscs,
+                                         Lanes* left, Lanes* right, int numSamples)
+{
+    constexpr int numLanes = (int) Lanes::SIMDNumElements;
+    jassert (numOscs > 0 && numOscs <= numLanes);
+
+    auto& first = *oscs[0];
+    const auto wave = first.oscillators[0]->wave;
+    const auto numVoices = first.voices;
+    jassert (numVoices * 2 <= first.oscillators.size());
+
+    bool canUseLanes = wave == Oscillator::sine || wave == Oscillator::square
+                        || wave == Oscillator::saw || wave == Oscillator::triangle;
+
+    for (int lane = 0; lane < numOscs && canUseLanes; ++lane)
+        canUseLanes = oscs[lane]->voices == numVoices
+                       && oscs[lane]->oscillators[0]->wave == wave
+                       && oscs[lane]->oscillators[0]->lookupTables != nullptr
+                       && oscs[lane]->oscillators[0]->lookupTables->tableSize == first.oscillators[0]->lookupTables->tableSize;
+
+    if (! canUseLanes)
+    {
+        // Noise has its own generator per oscillator so these are rendered one at a time
+        constexpr int chunkSize = 64;
+        float tempLeft[chunkSize], tempRight[chunkSize];
+        float* tempChannels[] = { tempLeft, tempRight };
+
+        for (int lane = 0; lane < numOscs; ++lane)
+        {
+            for (int start = 0; start < numSamples; start += chunkSize)
+            {
+                const int numThisTime = std::min (chunkSize, numSamples - start);
+                juce::AudioBuffer<float> temp (tempChannels, 2, numThisTime);
+                temp.clear();
+
+                oscs[lane]->process (temp, 0, numThisTime);
+
+                for (int i = 0; i < numThisTime; ++i)
+                {
+                    left[start + i].set ((size_t) lane, left[start + i].get ((size_t) lane) + tempLeft[i]);
+                    right[start + i].set ((size_t) lane, right[start + i].get ((size_t) lane) + tempRight[i]);
+                }
+            }
+        }
+
+        return;
+    }
+
+    const auto scaler = (float) (first.oscillators[0]->lookupTables->tableSize - 1);
+    const auto one = Lanes::expand (1.0f);
+
+    alignas (Lanes::SIMDRegisterSize) float phases[numLanes] = {}, deltas[numLanes] = {},
+                                             leftGains[numLanes] = {}, rightGains[numLanes] = {},
+                                             phases1[numLanes] = {}, phases2[numLanes] = {},
+                                             x0[numLanes] = {}, x1[numLanes] = {}, fractions[numLanes] = {};
+    float pulseWidths[numLanes] = {};
+    const float* tables1[numLanes] = {};
+    const float* tables2[numLanes] = {};
+
+    // Interpolates each lane's table in the same way as juce::dsp::LookupTableTransform
+    auto lookup = [&] (const float* const* tables, const float* lanePhases)
+    {
+        for (int lane = 0; lane < numOscs; ++lane)
+        {
+            const auto index = scaler * lanePhases[lane];
+            const auto i = (unsigned int) index;
+            fractions[lane] = index - (float) i;
+            x0[lane] = tables[lane][i];
+            x1[lane] = tables[lane][i + 1];
+        }
+
+        const auto start = Lanes::fromRawArray (x0);
+        return start + Lanes::fromRawArray (fractions) * (Lanes::fromRawArray (x1) - start);
+    };
+
+    for (int voice = 0; voice < numVoices; ++voice)
+    {
+        // The left and right oscillators of a voice always have the same phase and
+        // note so the wave only needs to be worked out once for both
+        for (int lane = 0; lane < numOscs; ++lane)
+        {
+            auto& m = *oscs[lane];
+            auto& l = *m.oscillators[voice * 2];
+            auto& r = *m.oscillators[voice * 2 + 1];
+
+            float leftGain = 1.0f - m.pan, rightGain = 1.0f + m.pan, voiceNote = m.note;
+
+            if (numVoices > 1)
+            {
+                float localPan = juce::jlimit (-1.0f, 1.0f, ((voice % 2 == 0) ? 1 : -1) * m.spread);
+                leftGain  = 1.0f - localPan;
+                rightGain = 1.0f + localPan;
+                voiceNote = (m.note - m.detune / 2) + m.detune / (numVoices - 1) * voice;
+            }
+
+            l.setGain (m.gain * leftGain / numVoices);
+            r.setGain (m.gain * rightGain / numVoices);
+            l.setNote (voiceNote);
+            r.setNote (voiceNote);
+
+            const float frequency = std::min (float (l.sampleRate) / 2.0f, 440.0f * std::pow (2.0f, (voiceNote - 69.0f) / 12.0f));
+            const float period = 1.0f / float (frequency);
+            const float periodInSamples = float (period * l.sampleRate);
+
+            phases[lane] = l.phase;
+            deltas[lane] = 1.0f / periodInSamples;
+            leftGains[lane] = l.gain;
+            rightGains[lane] = r.gain;
+            pulseWidths[lane] = l.pulseWidth;
+
+            auto& tables = *l.lookupTables;
+            const int tableIndex = juce::jlimit (0, (int) tables.sawUpTables.size() - 1,
+                                                 int ((voiceNote - 0.5) / tables.tablePerNumNotes));
+
+            switch (wave)
+            {
+                case Oscillator::sine:      tables1[lane] = tables.sineTable.data(); break;
+                case Oscillator::saw:       tables1[lane] = tables.sawUpTables[(size_t) tableIndex].data(); break;
+                case Oscillator::triangle:  tables1[lane] = tables.triangleTables[(size_t) tableIndex].data(); break;
+                case Oscillator::square:
+                    tables1[lane] = tables.sawUpTables[(size_t) tableIndex].data();
+                    tables2[lane] = tables.sawDownTables[(size_t) tableIndex].data();
+                    break;
+                case Oscillator::none:
+                case Oscillator::noise:
+                default:                    jassertfalse; break;
+            }
+        }
+
+        auto phase = Lanes::fromRawArray (phases);
+        const auto delta = Lanes::fromRawArray (deltas);
+        const auto leftGain = Lanes::fromRawArray (leftGains);
+        const auto rightGain = Lanes::fromRawArray (rightGains);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            phase.copyToRawArray (phases);
+            Lanes value;
+
+            if (wave == Oscillator::square)
+            {
+                for (int lane = 0; lane < numOscs; ++lane)
+                {
+                    phases1[lane] = phases[lane] + 0.5f * pulseWidths[lane];
+                    phases2[lane] = phases[lane] - 0.5f * pulseWidths[lane];
+
+                    if (phases1[lane] > 1.0f) phases1[lane] -= 1.0f;
+                    if (phases2[lane] < 0.0f) phases2[lane] += 1.0f;
+                }
+
+                value = lookup (tables1, phases1);
+                value += lookup (tables2, phases2);
+            }
+            else
+            {
+                value = lookup (tables1, phases);
+            }
+
+            left[i]  += value * leftGain;
+            right[i] += value * rightGain;
+
+            // The phase increment is never more than 0.5 so this only needs to wrap once
+            phase += delta;
+            phase -= one & Lanes::greaterThanOrEqual (phase, one);
+        }
+
+        phase.copyToRawArray (phases);
+
+        for (int lane = 0; lane < numOscs; ++lane)
+        {
+            oscs[lane]->oscillators[voice * 2]->phase = phases[lane];
+            oscs[lane]->oscillators[voice * 2 + 1]->phase = phases[lane];
+        }
+    }
+}
+#endif
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 static juce::Array<BandlimitedWaveLookupTables*> tableCache;
 
@@ -324,9 +504,10 @@ BandlimitedWaveLookupTables::Ptr BandlimitedWaveLookupTables::getLookupTables (d
     return table;
 }
 
-BandlimitedWaveLookupTables::BandlimitedWaveLookupTables (double sr, int tableSize)
+BandlimitedWaveLookupTables::BandlimitedWaveLookupTables (double sr, int size)
     : sampleRate (sr),
-      sineFunction ([] (float in) { return sine (in); }, 0.0f, 1.0f, (size_t) tableSize)
+      sineFunction ([] (float in) { return sine (in); }, 0.0f, 1.0f, (size_t) size),
+      tableSize (size)
 {
     auto getMidiNoteInHertz = [](float noteNumber)
     {
@@ -335,19 +516,44 @@ BandlimitedWaveLookupTables::BandlimitedWaveLookupTables (double sr, int tableSi
 
     auto start = juce::Time::getCurrentTime();
 
+    // BEATCONNECT MODIFICATION START
+    // The tables are sampled at the same points as the LookupTableTransform uses, which
+    // is then built from them so the waves are only calculated once
+    auto createTable = [this] (const std::function<float (float)>& function)
+    {
+        std::vector<float> values ((size_t) tableSize + 1);
+
+        for (int i = 0; i < tableSize; ++i)
+            values[(size_t) i] = function (juce::jmap ((float) i, 0.0f, (float) (tableSize - 1), 0.0f, 1.0f));
+
+        values[(size_t) tableSize] = values[(size_t) tableSize - 1];
+        return values;
+    };
+
+    auto createFunction = [this] (const std::vector<float>& values)
+    {
+        const auto maxIndex = (float) (tableSize - 1);
+
+        return new juce::dsp::LookupTableTransform<float> ([&values, maxIndex] (float value)
+                                                           { return values[(size_t) juce::roundToInt (value * maxIndex)]; },
+                                                           0.0f, 1.0f, (size_t) tableSize);
+    };
+
+    sineTable = createTable ([] (float in) { return sine (in); });
+
     for (float note = tablePerNumNotes + 0.5f; note < 127; note += tablePerNumNotes)
     {
         const float freq = getMidiNoteInHertz (note);
 
-        triangleFunctions.add (new juce::dsp::LookupTableTransform<float> ([freq, sr] (float value)
-                               { return triangle (value, freq, sr); }, 0.0f, 1.0f, (size_t) tableSize));
-
-        sawUpFunctions.add (new juce::dsp::LookupTableTransform<float> ([freq, sr] (float value)
-                            { return sawUp (value, freq, sr); }, 0.0f, 1.0f, (size_t) tableSize));
+        triangleTables.push_back (createTable ([freq, sr] (float value) { return triangle (value, freq, sr); }));
+        sawUpTables.push_back (createTable ([freq, sr] (float value) { return sawUp (value, freq, sr); }));
+        sawDownTables.push_back (createTable ([freq, sr] (float value) { return sawDown (value, freq, sr); }));
 
-        sawDownFunctions.add (new juce::dsp::LookupTableTransform<float> ([freq, sr] (float value)
-                              { return sawDown (value, freq, sr); }, 0.0f, 1.0f, (size_t) tableSize));
+        triangleFunctions.add (createFunction (triangleTables.back()));
+        sawUpFunctions.add (createFunction (sawUpTables.back()));
+        sawDownFunctions.add (createFunction (sawDownTables.back()));
     }
+    // BEATCONNECT MODIFICATION END
 
     auto elapsed = (juce::Time::getCurrentTime() - start);
     DBG ("Generating waves: " + juce::String (elapsed.inMilliseconds()) + "ms");
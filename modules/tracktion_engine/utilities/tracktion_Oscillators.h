@@ -29,6 +29,16 @@ public:
 
     const int tablePerNumNotes = 3;
 
+    // BEATCONNECT MODIFICATION START
+    /** The values the functions above are built from, for renderers that interpolate
+        the tables directly. Each holds tableSize + 1 values, the last repeating the one
+        before it, and is read at phase * (tableSize - 1).
+    */
+    const int tableSize;
+    std::vector<float> sineTable;
+    std::vector<std::vector<float>> triangleTables, sawUpTables, sawDownTables;
+    // BEATCONNECT MODIFICATION END
+
 private:
     BandlimitedWaveLookupTables (double sampleRate, int tableSize);
 };
@@ -63,6 +73,10 @@ public:
     void process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
 
 private:
+    // BEATCONNECT MODIFICATION START
+    friend class MultiVoiceOscillator;
+    // BEATCONNECT MODIFICATION END
+
     //==============================================================================
     void processSine (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
     void processSquare (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
@@ -102,6 +116,21 @@ public:
 
     void process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
 
+    // BEATCONNECT MODIFICATION START
+   #if JUCE_USE_SIMD
+    using Lanes = juce::dsp::SIMDRegister<float>;
+
+    /** Adds the output of several oscillators to a pair of buffers in which each
+        oscillator has its own SIMD lane, so a synth can render the same oscillator
+        of several voices in one pass. This produces the same output as calling
+        process() on each one.
+        There must be no more than Lanes::SIMDNumElements oscillators.
+    */
+    static void processLanes (MultiVoiceOscillator* const* oscillators, int numOscillators,
+                              Lanes* left, Lanes* right, int numSamples);
+   #endif
+    // BEATCONNECT MODIFICATION END
+
 private:
     juce::OwnedArray<Oscillator> oscillators;
 
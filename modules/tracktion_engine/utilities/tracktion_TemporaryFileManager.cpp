@@ -203,6 +203,9 @@ static juce::String getClipProxyPrefix()                { return "clip_"; }
 static juce::String getFileProxyPrefix()                { return "proxy_"; }
 static juce::String getDeviceFreezePrefix (Edit& edit)  { return "freeze_" + edit.getProjectItemID().toStringSuitableForFilename() + "_"; }
 static juce::String getTrackFreezePrefix()              { return "trackFreeze_"; }
+// BEATCONNECT MODIFICATION START
+static juce::String getTrackAutoFreezePrefix()          { return "autoFreeze_"; }
+// BEATCONNECT MODIFICATION END
 static juce::String getCompPrefix()                     { return "comp_"; }
 
 static AudioFile getCachedEditFile (Edit& edit, const juce::String& prefix, HashCode hash)
@@ -252,6 +255,15 @@ juce::File TemporaryFileManager::getFreezeFileForTrack (const AudioTrack& track)
              .getChildFile (getTrackFreezePrefix() + "0_" + track.itemID.toString() + ".freeze");
 }
 
+// BEATCONNECT MODIFICATION START
+juce::File TemporaryFileManager::getAutoFreezeFileForTrack (const AudioTrack& track, HashCode hash)
+{
+    return track.edit.getTempDirectory (true)
+             .getChildFile (getTrackAutoFreezePrefix() + "0_" + track.itemID.toString()
+                             + "_" + juce::String::toHexString (hash) + ".freeze");
+}
+// BEATCONNECT MODIFICATION END
+
 juce::Array<juce::File> TemporaryFileManager::getFrozenTrackFiles (Edit& edit)
 {
     return edit.getTempDirectory (false)
@@ -354,6 +366,13 @@ void TemporaryFileManager::purgeOrphanFreezeAndProxyFiles (Edit& edit)
                     if (! at->isFrozen (Track::individualFreeze))
                         filesToDelete.add (entry.getFile());
             }
+            // BEATCONNECT MODIFICATION START
+            else if (name.startsWith (getTrackAutoFreezePrefix()))
+            {
+                if (dynamic_cast<AudioTrack*> (findTrackForID (edit, itemID)) == nullptr)
+                    filesToDelete.add (entry.getFile());
+            }
+            // BEATCONNECT MODIFICATION END
         }
         else if (name.startsWith (RenderManager::getFileRenderPrefix()))
         {
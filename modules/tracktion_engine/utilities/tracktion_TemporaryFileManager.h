@@ -83,6 +83,11 @@ public:
     /** */
     static juce::File getFreezeFileForTrack (const AudioTrack&);
 
+    // BEATCONNECT MODIFICATION START
+    /** Returns the file the AutoFreezeManager uses for a track with a given content hash. */
+    static juce::File getAutoFreezeFileForTrack (const AudioTrack&, HashCode);
+    // BEATCONNECT MODIFICATION END
+
     /** */
     static juce::Array<juce::File> getFrozenTrackFiles (Edit&);
 
@@ -0,0 +1,259 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+ValueTreeSnapshot::ValueTreeSnapshot (const juce::ValueTree& v, std::vector<Ptr> newChildren)
+    : type (v.getType()), children (std::move (newChildren))
+{
+    for (int i = 0; i < v.getNumProperties(); ++i)
+    {
+        auto name = v.getPropertyName (i);
+        properties.set (name, v.getProperty (name));
+    }
+}
+
+ValueTreeSnapshot::Ptr ValueTreeSnapshot::create (const juce::ValueTree& v)
+{
+    std::vector<Ptr> newChildren;
+    newChildren.reserve ((size_t) v.getNumChildren());
+
+    for (const auto& child : v)
+        newChildren.push_back (create (child));
+
+    return Ptr (new ValueTreeSnapshot (v, std::move (newChildren)));
+}
+
+juce::var ValueTreeSnapshot::getProperty (const juce::Identifier& name, const juce::var& defaultValue) const
+{
+    if (auto v = properties.getVarPointer (name))
+        return *v;
+
+    return defaultValue;
+}
+
+ValueTreeSnapshot::Ptr ValueTreeSnapshot::getChild (int index) const
+{
+    if (juce::isPositiveAndBelow (index, children.size()))
+        return children[(size_t) index];
+
+    return {};
+}
+
+ValueTreeSnapshot::Ptr ValueTreeSnapshot::getChildWithName (const juce::Identifier& name) const
+{
+    for (auto& c : children)
+        if (c->hasType (name))
+            return c;
+
+    return {};
+}
+
+juce::ValueTree ValueTreeSnapshot::createCopy() const
+{
+    juce::ValueTree v (type);
+
+    for (const auto& p : properties)
+        v.setProperty (p.name, p.value, nullptr);
+
+    for (auto& c : children)
+        v.appendChild (c->createCopy(), nullptr);
+
+    return v;
+}
+
+void ValueTreeSnapshot::writeToStream (juce::OutputStream& output) const
+{
+    output.writeString (type.toString());
+    output.writeCompressedInt (properties.size());
+
+    for (const auto& p : properties)
+    {
+        output.writeString (p.name.toString());
+        p.value.writeToStream (output);
+    }
+
+    output.writeCompressedInt ((int) children.size());
+
+    for (auto& c : children)
+        c->writeToStream (output);
+}
+
+
+//==============================================================================
+ValueTreeSnapshotter::ValueTreeSnapshotter (const juce::ValueTree& v)
+    : tree (v)
+{
+    root = createNode (tree);
+    publish (buildSnapshot (*root));
+    tree.addListener (this);
+}
+
+ValueTreeSnapshotter::~ValueTreeSnapshotter()
+{
+    tree.removeListener (this);
+    cancelPendingUpdate();
+}
+
+ValueTreeSnapshot::Ptr ValueTreeSnapshotter::getSnapshot() const
+{
+    return std::atomic_load (&published);
+}
+
+ValueTreeSnapshot::Ptr ValueTreeSnapshotter::update()
+{
+    cancelPendingUpdate();
+
+    if (root->snapshot == nullptr)
+        publish (buildSnapshot (*root));
+
+    return root->snapshot;
+}
+
+//==============================================================================
+std::unique_ptr<ValueTreeSnapshotter::Node> ValueTreeSnapshotter::createNode (const juce::ValueTree& v)
+{
+    auto node = std::make_unique<Node>();
+    node->tree = v;
+    node->children.reserve ((size_t) v.getNumChildren());
+
+    for (const auto& child : v)
+        node->children.push_back (createNode (child));
+
+    return node;
+}
+
+void ValueTreeSnapshotter::syncChildren (Node& node)
+{
+    // Keeps the nodes of any children that are still there. These will usually be
+    // in the same order so searching on from the last match is quick.
+    auto oldChildren = std::move (node.children);
+    node.children.clear();
+    node.children.reserve ((size_t) node.tree.getNumChildren());
+    size_t searchStart = 0;
+
+    for (const auto& child : node.tree)
+    {
+        std::unique_ptr<Node> existing;
+
+        for (size_t i = 0; i < oldChildren.size() && existing == nullptr; ++i)
+        {
+            auto& old = oldChildren[(searchStart + i) % oldChildren.size()];
+
+            if (old != nullptr && old->tree == child)
+            {
+                existing = std::move (old);
+                searchStart = (searchStart + i + 1) % oldChildren.size();
+            }
+        }
+
+        node.children.push_back (existing != nullptr ? std::move (existing) : createNode (child));
+    }
+}
+
+ValueTreeSnapshot::Ptr ValueTreeSnapshotter::buildSnapshot (Node& node)
+{
+    if (node.snapshot == nullptr)
+    {
+        std::vector<ValueTreeSnapshot::Ptr> children;
+        children.reserve (node.children.size());
+
+        for (auto& c : node.children)
+            children.push_back (buildSnapshot (*c));
+
+        node.snapshot = ValueTreeSnapshot::Ptr (new ValueTreeSnapshot (node.tree, std::move (children)));
+    }
+
+    return node.snapshot;
+}
+
+ValueTreeSnapshotter::Node* ValueTreeSnapshotter::invalidate (const juce::ValueTree& v)
+{
+    // Finds the path from the root to the changed node, clearing the snapshots
+    // along it so only they get rebuilt
+    juce::Array<juce::ValueTree> path;
+
+    for (auto t = v; t != tree; t = t.getParent())
+    {
+        if (! t.isValid())
+            return nullptr;
+
+        path.add (t);
+    }
+
+    auto node = root.get();
+    node->snapshot = nullptr;
+
+    for (int i = path.size(); --i >= 0;)
+    {
+        const auto& child = path.getReference (i);
+        const auto index = node->tree.indexOf (child);
+
+        // If other listeners have changed the tree before this one was called
+        // the nodes could be out of step so check before using the index
+        if (! juce::isPositiveAndBelow (index, node->children.size())
+             || node->children[(size_t) index]->tree != child)
+            syncChildren (*node);
+
+        if (! juce::isPositiveAndBelow (index, node->children.size()))
+            return nullptr;
+
+        node = node->children[(size_t) index].get();
+        node->snapshot = nullptr;
+    }
+
+    triggerAsyncUpdate();
+    return node;
+}
+
+void ValueTreeSnapshotter::publish (ValueTreeSnapshot::Ptr newSnapshot)
+{
+    std::atomic_store (&published, std::move (newSnapshot));
+    version.fetch_add (1, std::memory_order_release);
+}
+
+//==============================================================================
+void ValueTreeSnapshotter::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier&)
+{
+    invalidate (v);
+}
+
+void ValueTreeSnapshotter::valueTreeChildAdded (juce::ValueTree& parent, juce::ValueTree&)
+{
+    if (auto node = invalidate (parent))
+        syncChildren (*node);
+}
+
+void ValueTreeSnapshotter::valueTreeChildRemoved (juce::ValueTree& parent, juce::ValueTree&, int)
+{
+    if (auto node = invalidate (parent))
+        syncChildren (*node);
+}
+
+void ValueTreeSnapshotter::valueTreeChildOrderChanged (juce::ValueTree& parent, int, int)
+{
+    if (auto node = invalidate (parent))
+        syncChildren (*node);
+}
+
+void ValueTreeSnapshotter::valueTreeRedirected (juce::ValueTree&)
+{
+    root = createNode (tree);
+    triggerAsyncUpdate();
+}
+
+void ValueTreeSnapshotter::handleAsyncUpdate()
+{
+    update();
+}
+
+}} // namespace tracktion { inline namespace engine
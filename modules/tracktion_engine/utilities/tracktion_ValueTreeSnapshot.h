@@ -0,0 +1,157 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    An immutable copy of a ValueTree node and all of its children.
+
+    As nothing can change once a snapshot has been created, it can be read from
+    any number of threads at once without any locking. Snapshots taken with a
+    ValueTreeSnapshotter share any subtrees that haven't changed between them so
+    taking a new one only copies the nodes that have been modified.
+
+    Note that property values are copied with the var copy constructor so any
+    reference counted objects they hold will be shared with the source tree.
+*/
+class ValueTreeSnapshot
+{
+public:
+    //==============================================================================
+    using Ptr = std::shared_ptr<const ValueTreeSnapshot>;
+
+    /** Creates a snapshot of a tree by copying all of it. */
+    static Ptr create (const juce::ValueTree&);
+
+    //==============================================================================
+    /** Returns the type of the node. */
+    const juce::Identifier& getType() const noexcept                    { return type; }
+
+    /** Returns true if the node has a given type. */
+    bool hasType (const juce::Identifier& t) const noexcept             { return type == t; }
+
+    /** Returns a property or a void var if it doesn't exist. */
+    const juce::var& getProperty (const juce::Identifier& name) const noexcept      { return properties[name]; }
+
+    /** Returns a property or a default value if it doesn't exist. */
+    juce::var getProperty (const juce::Identifier& name, const juce::var& defaultValue) const;
+
+    /** Returns true if the node has a given property. */
+    bool hasProperty (const juce::Identifier& name) const noexcept      { return properties.contains (name); }
+
+    /** Returns all the properties of the node. */
+    const juce::NamedValueSet& getProperties() const noexcept           { return properties; }
+
+    //==============================================================================
+    /** Returns the number of children. */
+    int getNumChildren() const noexcept                                 { return (int) children.size(); }
+
+    /** Returns a child or nullptr if the index is out of range. */
+    Ptr getChild (int index) const;
+
+    /** Returns the first child of a given type or nullptr if there isn't one. */
+    Ptr getChildWithName (const juce::Identifier&) const;
+
+    /** Returns all the children, e.g. to iterate them. */
+    const std::vector<Ptr>& getChildren() const noexcept                { return children; }
+
+    //==============================================================================
+    /** Creates a new, independent ValueTree with the same contents as this snapshot. */
+    juce::ValueTree createCopy() const;
+
+    /** Writes the snapshot in the same binary format as ValueTree::writeToStream,
+        so it can be read back with ValueTree::readFromStream.
+    */
+    void writeToStream (juce::OutputStream&) const;
+
+private:
+    //==============================================================================
+    friend class ValueTreeSnapshotter;
+
+    juce::Identifier type;
+    juce::NamedValueSet properties;
+    std::vector<Ptr> children;
+
+    ValueTreeSnapshot (const juce::ValueTree&, std::vector<Ptr>);
+};
+
+
+//==============================================================================
+/**
+    Keeps an up-to-date ValueTreeSnapshot of a ValueTree as it changes.
+
+    This listens to the tree and, whenever it changes, marks the nodes between the
+    change and the root as needing a new snapshot. The new snapshot is then built
+    asynchronously, or when update() is called, reusing the snapshots of all the
+    subtrees that haven't changed. This means taking a snapshot after a change
+    only costs a copy of the changed node and its ancestors.
+
+    getSnapshot() can be called from any thread. Everything else, like the
+    ValueTree itself, must only be used on the message thread or with it locked.
+*/
+class ValueTreeSnapshotter  : private juce::ValueTree::Listener,
+                              private juce::AsyncUpdater
+{
+public:
+    //==============================================================================
+    /** Creates a snapshotter for a tree, taking an initial snapshot of it. */
+    ValueTreeSnapshotter (const juce::ValueTree&);
+
+    /** Destructor. */
+    ~ValueTreeSnapshotter() override;
+
+    //==============================================================================
+    /** Returns the most recently published snapshot.
+        This can be called from any thread and the snapshot will remain valid for
+        as long as the caller holds on to it.
+    */
+    ValueTreeSnapshot::Ptr getSnapshot() const;
+
+    /** Returns the number of snapshots that have been published.
+        This can be used to cheaply check whether the state has changed.
+    */
+    uint64_t getVersion() const noexcept                    { return version.load (std::memory_order_acquire); }
+
+    /** Publishes a new snapshot if the tree has changed since the last one and returns it. */
+    ValueTreeSnapshot::Ptr update();
+
+private:
+    //==============================================================================
+    struct Node
+    {
+        juce::ValueTree tree;
+        ValueTreeSnapshot::Ptr snapshot;
+        std::vector<std::unique_ptr<Node>> children;
+    };
+
+    juce::ValueTree tree;
+    std::unique_ptr<Node> root;
+    ValueTreeSnapshot::Ptr published;
+    std::atomic<uint64_t> version { 0 };
+
+    static std::unique_ptr<Node> createNode (const juce::ValueTree&);
+    static void syncChildren (Node&);
+    static ValueTreeSnapshot::Ptr buildSnapshot (Node&);
+    Node* invalidate (const juce::ValueTree&);
+    void publish (ValueTreeSnapshot::Ptr);
+
+    void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override;
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override;
+    void valueTreeChildOrderChanged (juce::ValueTree&, int, int) override;
+    void valueTreeRedirected (juce::ValueTree&) override;
+    void handleAsyncUpdate() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ValueTreeSnapshotter)
+};
+
+}} // namespace tracktion { inline namespace engine
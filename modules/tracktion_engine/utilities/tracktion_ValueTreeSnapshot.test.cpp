@@ -0,0 +1,239 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class ValueTreeSnapshotTests  : public juce::UnitTest
+{
+public:
+    ValueTreeSnapshotTests()
+        : juce::UnitTest ("ValueTreeSnapshot", "Tracktion")
+    {
+    }
+
+    void runTest() override
+    {
+        runCopyTests();
+        runSharingTests();
+        runStructureTests();
+        runThreadTests();
+    }
+
+private:
+    static juce::ValueTree createRandomTree (juce::Random& r, int depth)
+    {
+        juce::ValueTree v ("NODE" + juce::String (r.nextInt (4)));
+        v.setProperty ("name", "Node " + juce::String (r.nextInt()), nullptr);
+        v.setProperty ("value", r.nextDouble(), nullptr);
+
+        if (r.nextBool())
+            v.setProperty ("flag", r.nextBool(), nullptr);
+
+        if (depth > 0)
+            for (int i = r.nextInt (5); --i >= 0;)
+                v.appendChild (createRandomTree (r, depth - 1), nullptr);
+
+        return v;
+    }
+
+    static juce::MemoryBlock getData (const juce::ValueTree& v)
+    {
+        juce::MemoryOutputStream os;
+        v.writeToStream (os);
+        return os.getMemoryBlock();
+    }
+
+    static juce::MemoryBlock getData (const ValueTreeSnapshot& s)
+    {
+        juce::MemoryOutputStream os;
+        s.writeToStream (os);
+        return os.getMemoryBlock();
+    }
+
+    void expectMatches (const ValueTreeSnapshot::Ptr& snapshot, const juce::ValueTree& v)
+    {
+        expect (snapshot != nullptr);
+        expect (getData (*snapshot) == getData (v), "The snapshot should hold the same state as the tree");
+        expect (snapshot->createCopy().isEquivalentTo (v));
+    }
+
+    void runCopyTests()
+    {
+        beginTest ("Copying");
+
+        juce::Random r (42);
+        auto v = createRandomTree (r, 4);
+        auto snapshot = ValueTreeSnapshot::create (v);
+        expectMatches (snapshot, v);
+
+        expect (snapshot->hasType (v.getType()));
+        expectEquals (snapshot->getNumChildren(), v.getNumChildren());
+        expect (snapshot->getProperty ("name") == v.getProperty ("name"));
+        expect (snapshot->getProperty ("missing", 7) == juce::var (7));
+        expect (snapshot->getChild (v.getNumChildren()) == nullptr);
+
+        // Snapshots shouldn't change with the tree
+        const auto originalData = getData (*snapshot);
+        v.setProperty ("name", "Changed", nullptr);
+        v.removeAllChildren (nullptr);
+        expect (getData (*snapshot) == originalData);
+
+        // The stream format should be readable as a ValueTree
+        juce::MemoryInputStream is (originalData, false);
+        expect (juce::ValueTree::readFromStream (is).isEquivalentTo (snapshot->createCopy()));
+    }
+
+    void runSharingTests()
+    {
+        beginTest ("Structural sharing");
+
+        juce::ValueTree v ("ROOT");
+
+        for (int i = 0; i < 3; ++i)
+        {
+            juce::ValueTree child ("CHILD");
+
+            for (int j = 0; j < 2; ++j)
+                child.appendChild (createValueTree ("GRANDCHILD", "index", j), nullptr);
+
+            v.appendChild (child, nullptr);
+        }
+
+        ValueTreeSnapshotter snapshotter (v);
+        auto s1 = snapshotter.getSnapshot();
+        expectMatches (s1, v);
+        expect (snapshotter.update() == s1, "Nothing has changed so there shouldn't be a new snapshot");
+
+        const auto version = snapshotter.getVersion();
+        v.getChild (0).getChild (1).setProperty ("index", 5, nullptr);
+        expect (snapshotter.getSnapshot() == s1, "Changes shouldn't be published until the update");
+
+        auto s2 = snapshotter.update();
+        expectMatches (s2, v);
+        expect (snapshotter.getVersion() > version);
+        expect (s2 != s1);
+
+        // Only the changed node and its parents should have been copied
+        expect (s2->getChild (0) != s1->getChild (0));
+        expect (s2->getChild (0)->getChild (1) != s1->getChild (0)->getChild (1));
+        expect (s2->getChild (0)->getChild (0) == s1->getChild (0)->getChild (0));
+        expect (s2->getChild (1) == s1->getChild (1));
+        expect (s2->getChild (2) == s1->getChild (2));
+
+        expect (s1->getChild (0)->getChild (1)->getProperty ("index") == juce::var (1));
+        expect (s2->getChild (0)->getChild (1)->getProperty ("index") == juce::var (5));
+    }
+
+    void runStructureTests()
+    {
+        beginTest ("Structural changes");
+
+        juce::Random r (1234);
+        auto v = createRandomTree (r, 3);
+        v.appendChild (createRandomTree (r, 2), nullptr);
+        ValueTreeSnapshotter snapshotter (v);
+
+        // Listeners that change the tree in response to changes could make the
+        // nodes get out of step with the tree
+        struct ReentrantListener  : public juce::ValueTree::Listener
+        {
+            void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree& child) override
+            {
+                if (child.hasType ("ADDED"))
+                    child.appendChild (juce::ValueTree ("NESTED"), nullptr);
+            }
+        };
+
+        ReentrantListener listener;
+        v.addListener (&listener);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            auto parent = v;
+
+            while (parent.getNumChildren() > 0 && r.nextInt (3) != 0)
+                parent = parent.getChild (r.nextInt (parent.getNumChildren()));
+
+            switch (r.nextInt (5))
+            {
+                case 0:     parent.setProperty ("value", r.nextInt(), nullptr); break;
+                case 1:     parent.appendChild (createRandomTree (r, 2), nullptr); break;
+                case 2:     parent.addChild (juce::ValueTree ("ADDED"), r.nextInt (parent.getNumChildren() + 1), nullptr); break;
+                case 3:     if (parent.getNumChildren() > 0) parent.removeChild (r.nextInt (parent.getNumChildren()), nullptr); break;
+                case 4:     if (parent.getNumChildren() > 1) parent.moveChild (0, parent.getNumChildren() - 1, nullptr); break;
+                default:    break;
+            }
+
+            if (r.nextInt (4) == 0)
+                expectMatches (snapshotter.update(), v);
+        }
+
+        expectMatches (snapshotter.update(), v);
+        v.removeListener (&listener);
+    }
+
+    void runThreadTests()
+    {
+        beginTest ("Concurrent reads");
+
+        juce::ValueTree v ("ROOT");
+
+        for (int i = 0; i < 64; ++i)
+            v.appendChild (createValueTree ("CHILD", "a", 0, "b", 0), nullptr);
+
+        ValueTreeSnapshotter snapshotter (v);
+
+        // The tree is only published between changes so readers should always see
+        // the two properties of each child equal
+        std::atomic<bool> finished { false };
+        std::atomic<int> numMismatches { 0 }, numReads { 0 };
+
+        std::thread reader ([&]
+        {
+            while (! finished)
+            {
+                auto s = snapshotter.getSnapshot();
+
+                for (auto& child : s->getChildren())
+                    if (child->getProperty ("a") != child->getProperty ("b"))
+                        ++numMismatches;
+
+                ++numReads;
+            }
+        });
+
+        juce::Random r (42);
+
+        for (int i = 0; i < 5000 || numReads < 100; ++i)
+        {
+            auto child = v.getChild (r.nextInt (v.getNumChildren()));
+            child.setProperty ("a", i, nullptr);
+            child.setProperty ("b", i, nullptr);
+            snapshotter.update();
+        }
+
+        finished = true;
+        reader.join();
+
+        expectEquals (numMismatches.load(), 0);
+        expectMatches (snapshotter.getSnapshot(), v);
+    }
+};
+
+static ValueTreeSnapshotTests valueTreeSnapshotTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
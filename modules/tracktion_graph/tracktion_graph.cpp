@@ -38,6 +38,9 @@
 #include "tracktion_graph/tracktion_MultiThreadedNodePlayer.cpp"
 #include "tracktion_graph/tracktion_LockFreeMultiThreadedNodePlayer.cpp"
 #include "tracktion_graph/tracktion_NodePlayerThreadPools.cpp"
+// BEATCONNECT MODIFICATION START
+#include "tracktion_graph/tracktion_LockFreeMultiThreadedNodePlayer.test.cpp"
+// BEATCONNECT MODIFICATION END
 
 #include "tracktion_graph/nodes/tracktion_ConnectedNode.test.cpp"
 
@@ -45,6 +48,9 @@
 #include "utilities/tracktion_Semaphore.cpp"
 #include "utilities/tracktion_Semaphore.tests.cpp"
 #include "utilities/tracktion_Threads.cpp"
+// BEATCONNECT MODIFICATION START
+#include "utilities/tracktion_SummingKernel.test.cpp"
+// BEATCONNECT MODIFICATION END
 
 // Put this last to avoid macro leakage
 #include "utilities/tracktion_Allocation.test.cpp"
@@ -98,12 +98,18 @@ namespace tracktion_engine = tracktion::engine;
 #include "utilities/tracktion_Threads.h"
 #include "utilities/tracktion_LatencyProcessor.h"
 #include "utilities/tracktion_LockFreeObject.h"
+// BEATCONNECT MODIFICATION START
+#include "utilities/tracktion_SummingKernel.h"
+// BEATCONNECT MODIFICATION END
 
 #include "tracktion_graph/tracktion_PlayHead.h"
 
 #include "tracktion_graph/tracktion_PlayHeadState.h"
 
 #include "tracktion_graph/players/tracktion_NodePlayerUtilities.h"
+// BEATCONNECT MODIFICATION START
+#include "tracktion_graph/players/tracktion_WorkerCountController.h"
+// BEATCONNECT MODIFICATION END
 
 #include "tracktion_graph/tracktion_NodePlayer.h"
 #include "tracktion_graph/tracktion_MultiThreadedNodePlayer.h"
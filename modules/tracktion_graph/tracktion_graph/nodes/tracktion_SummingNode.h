@@ -13,6 +13,34 @@
 namespace tracktion { inline namespace graph
 {
 
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+//==============================================================================
+/**
+    Implemented by Nodes that apply a gain to their input, so they can leave that
+    gain for a SummingNode to apply as it adds them in.
+
+    When the gain is deferred the Node should pass its input straight on with
+    setAudioOutput rather than copying it, and report the gain it would have
+    applied from getDeferredGain.
+
+    The same gain is applied to every channel, so this can't be used to pan.
+*/
+struct DeferrableGainNode
+{
+    virtual ~DeferrableGainNode() = default;
+
+    /** Called before playback by the Node that will apply the gain. */
+    virtual void setGainDeferred (bool shouldDeferGain) = 0;
+
+    /** The gain should ramp from the first value to the second over the last block.
+        The first value is the gain before the first sample, so the first sample
+        gets one step of the ramp.
+    */
+    virtual std::pair<float, float> getDeferredGain() const = 0;
+};
+// BEATCONNECT MODIFICATION END
+
 //==============================================================================
 //==============================================================================
 /**
@@ -22,7 +50,11 @@ namespace tracktion { inline namespace graph
 class SummingNode final : public Node
 {
 public:
-    SummingNode() = default;
+    // BEATCONNECT MODIFICATION START
+    SummingNode()
+    {
+        setOptimisations ({ ClearBuffers::no, AllocateAudioBuffer::yes });
+    }
     
     SummingNode (std::vector<std::unique_ptr<Node>> inputs)
         : ownedNodes (std::move (inputs))
@@ -31,13 +63,16 @@ public:
             nodes.push_back (ownedNode.get());
 
         assert (std::find (nodes.begin(), nodes.end(), nullptr) == nodes.end());
+        setOptimisations ({ ClearBuffers::no, AllocateAudioBuffer::yes });
     }
 
     SummingNode (std::vector<Node*> inputs)
         : nodes (std::move (inputs))
     {
         assert (std::find (nodes.begin(), nodes.end(), nullptr) == nodes.end());
+        setOptimisations ({ ClearBuffers::no, AllocateAudioBuffer::yes });
     }
+    // BEATCONNECT MODIFICATION END
     
     SummingNode (std::vector<std::unique_ptr<Node>> ownedInputs,
                  std::vector<Node*> referencedInputs)
@@ -106,6 +141,14 @@ public:
 
     void prepareToPlay (const PlaybackInitialisationInfo& info) override
     {
+        // BEATCONNECT MODIFICATION START
+        findDeferredGainNodes (info.nodeGraph);
+
+        // Reserved here so nothing is allocated while processing
+        inputAudio.resize (nodes.size());
+        channelSources.reserve (nodes.size());
+        // BEATCONNECT MODIFICATION END
+
         useDoublePrecision = useDoublePrecision && nodes.size() > 1;
         
         if (useDoublePrecision)
@@ -137,6 +180,85 @@ private:
     
     bool useDoublePrecision = false;
     choc::buffer::ChannelArrayBuffer<double> tempDoubleBuffer;
+
+    // BEATCONNECT MODIFICATION START
+    std::vector<DeferrableGainNode*> deferredGainNodes;
+    std::vector<choc::buffer::ChannelArrayView<float>> inputAudio;
+    std::vector<SummingSource> channelSources;
+
+    /** Any inputs that apply a gain and are only read by this can leave the gain for
+        this to apply as it sums, which saves them copying their input.
+    */
+    void findDeferredGainNodes (NodeGraph& nodeGraph)
+    {
+        deferredGainNodes.assign (nodes.size(), nullptr);
+
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            if (auto gainNode = dynamic_cast<DeferrableGainNode*> (nodes[i]))
+            {
+                int numReaders = 0;
+
+                for (auto n : nodeGraph.orderedNodes)
+                    for (auto inputNode : n->getDirectInputNodes())
+                        if (inputNode == nodes[i])
+                            ++numReaders;
+
+                const bool shouldDefer = numReaders == 1;
+                gainNode->setGainDeferred (shouldDefer);
+
+                if (shouldDefer)
+                    deferredGainNodes[i] = gainNode;
+            }
+        }
+    }
+
+    /** Returns the gain ramp to apply to an input, or { 1, 1 } if it applies its own gain. */
+    std::pair<float, float> getInputGain (size_t index) const
+    {
+        if (index < deferredGainNodes.size())
+            if (auto gainNode = deferredGainNodes[index])
+                return gainNode->getDeferredGain();
+
+        return { 1.0f, 1.0f };
+    }
+
+    template<typename DestBuffer>
+    static void addWithGain (DestBuffer&& dest, const choc::buffer::ChannelArrayView<float>& source, std::pair<float, float> gain)
+    {
+        if (gain.first != gain.second)
+        {
+            // Ramps the same way the GainNode would have done
+            const auto step = (gain.second - gain.first) / (float) source.getNumFrames();
+            addApplyingGainRamp (dest, source, gain.first + step, gain.second + step);
+        }
+        else if (gain.first == 1.0f)
+        {
+            add (dest, source);
+        }
+        else if (gain.first != 0.0f)
+        {
+            add (dest, source, gain.first);
+        }
+    }
+
+    /** A single input that doesn't need any gain applying can just be passed on. */
+    bool passOnSingleInput (const ProcessContext& pc)
+    {
+        if (nodes.size() != 1 || getInputGain (0) != std::pair<float, float> (1.0f, 1.0f))
+            return false;
+
+        auto inputFromNode = nodes.front()->getProcessedOutput();
+
+        if (inputFromNode.audio.getNumChannels() != pc.buffers.audio.getNumChannels())
+            return false;
+
+        setAudioOutput (nodes.front(), inputFromNode.audio);
+        pc.buffers.midi.copyFrom (inputFromNode.midi);
+
+        return true;
+    }
+    // BEATCONNECT MODIFICATION END
     
     static void sortByTimestampUnstable (tracktion_engine::MidiMessageArray& messages) noexcept
     {
@@ -157,18 +279,28 @@ private:
     //==============================================================================
     void processSinglePrecision (const ProcessContext& pc)
     {
+        // BEATCONNECT MODIFICATION START
+        if (passOnSingleInput (pc))
+            return;
+
+        // N.B We need to clear the MIDI manually here due to optimisations.
+        // The audio doesn't need clearing as every channel is overwritten by the sum
+        pc.buffers.midi.clear();
+        // BEATCONNECT MODIFICATION END
+
         const auto numChannels = pc.buffers.audio.getNumChannels();
 
         int nodesWithMidi = pc.buffers.midi.isEmpty() ? 0 : 1;
 
-        // Get each of the inputs and add them to dest
-        for (auto& node : nodes)
+        // BEATCONNECT MODIFICATION START
+        jassert (inputAudio.size() == nodes.size());
+
+        // Get each of the inputs and merge their MIDI
+        for (size_t i = 0; i < nodes.size(); ++i)
         {
-            auto inputFromNode = node->getProcessedOutput();
-            
-            if (auto numChannelsToAdd = std::min (inputFromNode.audio.getNumChannels(), numChannels))
-                add (pc.buffers.audio.getFirstChannels (numChannelsToAdd),
-                     inputFromNode.audio.getFirstChannels (numChannelsToAdd));
+            auto inputFromNode = nodes[i]->getProcessedOutput();
+            inputAudio[i] = inputFromNode.audio;
+        // BEATCONNECT MODIFICATION END
 
             if (inputFromNode.midi.isNotEmpty())
                 nodesWithMidi++;
@@ -176,12 +308,47 @@ private:
             pc.buffers.midi.mergeFrom (inputFromNode.midi);
         }
 
+        // BEATCONNECT MODIFICATION START
+        // Then sum all the inputs to each channel in one pass, applying any deferred gains
+        const auto numFrames = pc.buffers.audio.getNumFrames();
+
+        for (choc::buffer::ChannelCount channel = 0; channel < numChannels; ++channel)
+        {
+            channelSources.clear();
+
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                if (channel >= inputAudio[i].getNumChannels())
+                    continue;
+
+                jassert (inputAudio[i].getNumFrames() == numFrames);
+                const auto gain = getInputGain (i);
+
+                if (gain.first == 0.0f && gain.second == 0.0f)
+                    continue;
+
+                // Ramps the same way the GainNode would have done
+                const auto step = (gain.second - gain.first) / (float) numFrames;
+                channelSources.push_back ({ inputAudio[i].getIterator (channel).sample, gain.first + step, step });
+            }
+
+            sumChannels (pc.buffers.audio.getIterator (channel).sample,
+                         channelSources.data(), channelSources.size(), numFrames);
+        }
+        // BEATCONNECT MODIFICATION END
+
         if (nodesWithMidi > 1)
             sortByTimestampUnstable (pc.buffers.midi);
     }
 
     void processDoublePrecision (const ProcessContext& pc)
     {
+        // BEATCONNECT MODIFICATION START
+        // N.B We need to clear manually here due to optimisations
+        pc.buffers.audio.clear();
+        pc.buffers.midi.clear();
+        // BEATCONNECT MODIFICATION END
+
         const auto numChannels = pc.buffers.audio.getNumChannels();
         auto doubleView = tempDoubleBuffer.getView().getStart (pc.buffers.audio.getNumFrames());
         doubleView.clear();
@@ -189,13 +356,16 @@ private:
         int nodesWithMidi = pc.buffers.midi.isEmpty() ? 0 : 1;
 
         // Get each of the inputs and add them to dest
-        for (auto& node : nodes)
+        // BEATCONNECT MODIFICATION START
+        for (size_t i = 0; i < nodes.size(); ++i)
         {
-            auto inputFromNode = node->getProcessedOutput();
+            auto inputFromNode = nodes[i]->getProcessedOutput();
             
             if (auto numChannelsToAdd = std::min (inputFromNode.audio.getNumChannels(), numChannels))
-                add (doubleView.getFirstChannels (numChannelsToAdd),
-                     inputFromNode.audio.getFirstChannels (numChannelsToAdd));
+                addWithGain (doubleView.getFirstChannels (numChannelsToAdd),
+                             inputFromNode.audio.getFirstChannels (numChannelsToAdd),
+                             getInputGain (i));
+        // BEATCONNECT MODIFICATION END
 
             if (inputFromNode.midi.isNotEmpty())
                 nodesWithMidi++;
@@ -0,0 +1,152 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+//==============================================================================
+/**
+    Decides how many worker threads a multi-threaded player should keep running,
+    based on how much parallelism it measures in each block.
+
+    Each block, the player tells this how long the block took (the wall time) and how
+    long all the threads spent processing Nodes (the busy time). The ratio of these is
+    the number of threads that were actually kept busy. This is smoothed and used to
+    find the number of workers the graph can use, with some headroom.
+
+    Workers are added quickly, either when every running thread is busy (so there may be
+    more parallelism available than can be measured) or when a block uses too much of its
+    real-time budget. They're removed one at a time and only after many consecutive blocks
+    that didn't need them, to avoid threads being parked and woken constantly.
+
+    This isn't thread safe and should only be used from the audio thread.
+*/
+class WorkerCountController
+{
+public:
+    //==============================================================================
+    /** Tuning for the controller. */
+    struct Options
+    {
+        double smoothing = 0.1;             /**< The weight each new block has in the smoothed parallelism. */
+        double saturation = 0.9;            /**< The utilisation of the running threads above which a worker is added. */
+        double utilisation = 0.75;          /**< The utilisation the threads should be below after a worker is removed. */
+        double maxLoad = 0.7;               /**< The proportion of the block's real-time budget above which a worker is added straight away. */
+        int numBlocksBeforeIncrease = 4;    /**< The number of consecutive blocks that need a worker before one is added. */
+        int numBlocksBeforeDecrease = 64;   /**< The number of consecutive blocks that don't need a worker before one is removed. */
+    };
+
+    //==============================================================================
+    /** Creates a controller with the default Options and no workers. */
+    WorkerCountController() = default;
+
+    /** Creates a controller with some Options and no workers. */
+    WorkerCountController (Options optionsToUse)
+        : options (optionsToUse)
+    {
+    }
+
+    /** Resets the measurements and sets the number of workers. */
+    void reset (size_t newNumWorkers)
+    {
+        numWorkers = std::min (newNumWorkers, maxNumWorkers);
+        parallelism = -1.0;
+        numBlocksAbove = numBlocksBelow = 0;
+    }
+
+    /** Sets the maximum number of workers that could be useful, e.g. the number of
+        threads available or the width of the graph.
+    */
+    void setMaxNumWorkers (size_t newMax)
+    {
+        maxNumWorkers = newMax;
+        numWorkers = std::min (numWorkers, maxNumWorkers);
+    }
+
+    /** Returns the number of workers that should be running. */
+    size_t getNumWorkers() const                { return numWorkers; }
+
+    /** Returns the smoothed number of threads that have been kept busy. */
+    double getParallelism() const               { return std::max (parallelism, 0.0); }
+
+    //==============================================================================
+    /** Updates the controller with the measurements from a block and returns the
+        number of workers that should be running.
+        @param busySeconds      The total time all the threads spent processing Nodes
+        @param wallSeconds      The time the block took to process
+        @param budgetSeconds    The duration of the block i.e. the time available to process it
+    */
+    size_t update (double busySeconds, double wallSeconds, double budgetSeconds)
+    {
+        if (wallSeconds <= 0.0 || budgetSeconds <= 0.0)
+            return numWorkers;
+
+        const auto blockParallelism = busySeconds / wallSeconds;
+        parallelism = parallelism < 0.0 ? blockParallelism
+                                        : parallelism + options.smoothing * (blockParallelism - parallelism);
+
+        const auto numThreads = (double) (numWorkers + 1);
+        const auto load = wallSeconds / budgetSeconds;
+
+        if (numWorkers < maxNumWorkers)
+        {
+            // The block is close to its deadline so add a worker now
+            if (load > options.maxLoad)
+                return changeNumWorkers (numWorkers + 1);
+
+            // All the running threads are busy so there may be more parallelism available
+            if (blockParallelism >= options.saturation * numThreads)
+            {
+                numBlocksBelow = 0;
+
+                if (++numBlocksAbove >= options.numBlocksBeforeIncrease)
+                    return changeNumWorkers (numWorkers + 1);
+
+                return numWorkers;
+            }
+        }
+
+        numBlocksAbove = 0;
+
+        // One fewer thread could handle the smoothed parallelism
+        if (numWorkers > 0 && load <= options.maxLoad
+            && parallelism <= options.utilisation * (numThreads - 1.0))
+        {
+            if (++numBlocksBelow >= options.numBlocksBeforeDecrease)
+                return changeNumWorkers (numWorkers - 1);
+
+            return numWorkers;
+        }
+
+        numBlocksBelow = 0;
+        return numWorkers;
+    }
+
+private:
+    //==============================================================================
+    Options options;
+    size_t numWorkers = 0, maxNumWorkers = 0;
+    double parallelism = -1.0;
+    int numBlocksAbove = 0, numBlocksBelow = 0;
+
+    size_t changeNumWorkers (size_t newNumWorkers)
+    {
+        numWorkers = std::min (newNumWorkers, maxNumWorkers);
+        numBlocksAbove = numBlocksBelow = 0;
+        return numWorkers;
+    }
+};
+// BEATCONNECT MODIFICATION END
+
+}}
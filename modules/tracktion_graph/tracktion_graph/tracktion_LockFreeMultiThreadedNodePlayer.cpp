@@ -9,6 +9,7 @@
 */
 
 #include <thread>
+#include <unordered_map>
 #if JUCE_INTEL
  #include <emmintrin.h>
 #endif
@@ -42,6 +43,28 @@ void LockFreeMultiThreadedNodePlayer::setNumThreads (size_t newNumThreads)
     createThreads();
 }
 
+// BEATCONNECT MODIFICATION START
+void LockFreeMultiThreadedNodePlayer::setThreadInitialiser (ThreadInitialiser newInitialiser)
+{
+    threadInitialiser = std::move (newInitialiser);
+}
+
+void LockFreeMultiThreadedNodePlayer::enableAdaptiveThreadCount (bool shouldAdapt)
+{
+    if (adaptiveThreadCount.exchange (shouldAdapt) == shouldAdapt)
+        return;
+
+    if (shouldAdapt)
+    {
+        shouldResetWorkerCount = true;
+        return;
+    }
+
+    numActiveThreads = std::numeric_limits<size_t>::max();
+    threadPool->unparkThreads();
+}
+// BEATCONNECT MODIFICATION END
+
 void LockFreeMultiThreadedNodePlayer::setNode (std::unique_ptr<Node> newNode)
 {
     setNode (std::move (newNode), getSampleRate(), blockSize);
@@ -104,13 +127,27 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
     // We need to retain the root so we can get the output from it
     preparedNode->graph->rootNode->retain();
 
-    if (numThreadsToUse.load (std::memory_order_acquire) == 0 || preparedNode->graph->orderedNodes.size() == 1)
+    // BEATCONNECT MODIFICATION START
+    const bool isAdaptive = isAdaptiveThreadCountEnabled();
+    const auto startTime = isAdaptive ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    bool isSingleThreaded = numThreadsToUse.load (std::memory_order_acquire) == 0 || preparedNode->graph->orderedNodes.size() == 1;
+
+    // With no workers active, skip the queueing overhead
+    if (isAdaptive && getNumActiveThreads() == 0)
+        isSingleThreaded = true;
+    // BEATCONNECT MODIFICATION END
+
+    if (isSingleThreaded)
     {
         for (auto node : preparedNode->graph->orderedNodes)
             node->process (numSamplesToProcess, referenceSampleRange);
     }
     else
     {
+        // BEATCONNECT MODIFICATION START
+        measureBusyTime.store (isAdaptive, std::memory_order_relaxed);
+        // BEATCONNECT MODIFICATION END
+
         // Reset the queue to be processed
         jassert (preparedNode->playbackNodes.size() == preparedNode->graph->orderedNodes.size());
         resetProcessQueue (*preparedNode);
@@ -121,11 +158,35 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
             if (preparedNode->graph->rootNode->hasProcessed())
                 break;
 
-            if (! processNextFreeNode (*preparedNode))
+            if (! processNextFreeNode (*preparedNode, 0))
                 threadPool->waitForFinalNode();
         }
     }
 
+    // BEATCONNECT MODIFICATION START
+    if (isAdaptive)
+    {
+        using namespace std::chrono;
+        const auto wallSeconds = duration<double> (steady_clock::now() - startTime).count();
+        auto busySeconds = wallSeconds;
+
+        if (! isSingleThreaded)
+        {
+            // The totals only grow, so time added by a worker after the root has
+            // processed is simply counted in the next block
+            int64_t totalBusyNanoseconds = 0;
+
+            for (auto& busyTime : busyTimes)
+                totalBusyNanoseconds += busyTime.nanoseconds.load (std::memory_order_relaxed);
+
+            busySeconds = (totalBusyNanoseconds - lastTotalBusyNanoseconds) * 1.0e-9;
+            lastTotalBusyNanoseconds = totalBusyNanoseconds;
+        }
+
+        updateNumActiveThreads (*preparedNode, busySeconds, wallSeconds);
+    }
+    // BEATCONNECT MODIFICATION END
+
     // Add output from graph to buffers
     {
         auto output = preparedNode->graph->rootNode->getProcessedOutput();
@@ -233,6 +294,9 @@ void LockFreeMultiThreadedNodePlayer::postNewGraph (std::unique_ptr<NodeGraph> n
     newPreparedNode.graph = std::move (newGraph);
     newPreparedNode.nodesReadyToBeProcessed = std::make_unique<LockFreeFifo<Node*>> ((int) newPreparedNode.graph->orderedNodes.size());
     buildNodesOutputLists (newPreparedNode);
+    // BEATCONNECT MODIFICATION START
+    newPreparedNode.maxNumParallelNodes = getMaxNumParallelNodes (newPreparedNode);
+    // BEATCONNECT MODIFICATION END
 
     if (useMemoryPool)
     {
@@ -377,7 +441,7 @@ Node* LockFreeMultiThreadedNodePlayer::updateProcessQueueForNode (PreparedNode&
 }
 
 //==============================================================================
-bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& preparedNode)
+bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& preparedNode, size_t busyTimeSlot)
 {
     Node* nodeToProcess = nullptr;
 
@@ -390,15 +454,20 @@ bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& prepare
     numNodesQueued.fetch_sub (1, std::memory_order_acq_rel);
 
     assert (nodeToProcess != nullptr);
-    processNode (preparedNode, *nodeToProcess);
+    processNode (preparedNode, *nodeToProcess, busyTimeSlot);
 
     return true;
 }
 
-void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, Node& node)
+void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, Node& node, size_t busyTimeSlot)
 {
     auto* nodeToProcess = &node;
 
+    // BEATCONNECT MODIFICATION START
+    const bool shouldMeasure = measureBusyTime.load (std::memory_order_relaxed);
+    const auto startTime = shouldMeasure ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    // BEATCONNECT MODIFICATION END
+
     // Attempt to process serial Node chains on this thread
     // to reduce context switches and overhead
     for (;;)
@@ -415,6 +484,67 @@ void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, N
         if (! nodeToProcess)
             break;
     }
+
+    // BEATCONNECT MODIFICATION START
+    if (shouldMeasure)
+    {
+        using namespace std::chrono;
+        busyTimes[busyTimeSlot].nanoseconds.fetch_add (duration_cast<nanoseconds> (steady_clock::now() - startTime).count(),
+                                                       std::memory_order_relaxed);
+    }
+    // BEATCONNECT MODIFICATION END
+}
+
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+size_t LockFreeMultiThreadedNodePlayer::getMaxNumParallelNodes (const PreparedNode& preparedNode)
+{
+    // The orderedNodes are topologically sorted so each Node's inputs have already been
+    // given a depth by the time it's reached. Nodes at the same depth can run in parallel
+    std::unordered_map<Node*, size_t> depths;
+    std::vector<size_t> numNodesAtDepth;
+
+    for (auto node : preparedNode.graph->orderedNodes)
+    {
+        size_t depth = 0;
+
+        for (auto input : node->getDirectInputNodes())
+            depth = std::max (depth, depths[input] + 1);
+
+        depths[node] = depth;
+
+        if (depth >= numNodesAtDepth.size())
+            numNodesAtDepth.resize (depth + 1, 0);
+
+        ++numNodesAtDepth[depth];
+    }
+
+    return numNodesAtDepth.empty() ? 0 : *std::max_element (numNodesAtDepth.begin(), numNodesAtDepth.end());
+}
+
+void LockFreeMultiThreadedNodePlayer::updateNumActiveThreads (const PreparedNode& preparedNode, double busySeconds, double wallSeconds)
+{
+    // The calling thread counts as one of the parallel Nodes
+    const auto maxNumUsefulWorkers = std::min (numThreadsToUse.load (std::memory_order_acquire),
+                                               preparedNode.maxNumParallelNodes > 0 ? preparedNode.maxNumParallelNodes - 1 : 0);
+    workerCountController.setMaxNumWorkers (maxNumUsefulWorkers);
+
+    if (shouldResetWorkerCount.exchange (false))
+        workerCountController.reset (maxNumUsefulWorkers);
+
+    const auto budgetSeconds = numSamplesToProcess / getSampleRate();
+    const auto newNumActiveThreads = workerCountController.update (busySeconds, wallSeconds, budgetSeconds);
+
+    if (numActiveThreads.exchange (newNumActiveThreads) < newNumActiveThreads)
+        threadPool->unparkThreads();
+
+    // Don't leave threads parked if adapting was disabled during the update
+    if (! adaptiveThreadCount.load())
+    {
+        numActiveThreads = std::numeric_limits<size_t>::max();
+        threadPool->unparkThreads();
+    }
 }
+// BEATCONNECT MODIFICATION END
 
 }}
@@ -76,6 +76,9 @@ private:
         std::vector<std::unique_ptr<PlaybackNode>> playbackNodes;
         std::unique_ptr<LockFreeFifo<Node*>> nodesReadyToBeProcessed;
         std::unique_ptr<AudioBufferPool> audioBufferPool;
+        // BEATCONNECT MODIFICATION START
+        size_t maxNumParallelNodes = 0;
+        // BEATCONNECT MODIFICATION END
     };
 
 public:
@@ -128,6 +131,9 @@ public:
         {
             threadsShouldExit = true;
             signalAll();
+            // BEATCONNECT MODIFICATION START
+            unparkThreads();
+            // BEATCONNECT MODIFICATION END
         }
         
         /** Signals the pool that all the threads should continue to run and not exit. */
@@ -171,11 +177,25 @@ public:
         bool process()
         {
             if (auto cpn = currentPreparedNode.load())
-                return player.processNextFreeNode (*cpn);
+                return player.processNextFreeNode (*cpn, numBusyTimeSlots - 1);
 
             return false;
         }
 
+        // BEATCONNECT MODIFICATION START
+        /** Process the next chain of Nodes on one of the pool's threads.
+            Passing the thread's index lets it record its busy time without contending
+            with the other threads. Pools that can't supply one should call process().
+        */
+        bool process (size_t threadIndex)
+        {
+            if (auto cpn = currentPreparedNode.load())
+                return player.processNextFreeNode (*cpn, std::min (threadIndex + 1, numBusyTimeSlots - 1));
+
+            return false;
+        }
+        // BEATCONNECT MODIFICATION END
+
         /** Sets the current PreparedNode in use. This should live as long as the threads are running once set. */
         void setCurrentNode (LockFreeMultiThreadedNodePlayer::PreparedNode* nodeInUse)
         {
@@ -184,11 +204,77 @@ public:
             // If a nullptr is being set, you must stop the threads first.
             assert (nodeInUse || shouldExit());
         }
+
+        // BEATCONNECT MODIFICATION START
+        /** Subclasses should call this for each thread they create to set its priority and
+            the CPUs it can run on.
+        */
+        void initialiseThread (std::thread& thread, size_t threadIndex)
+        {
+            if (player.threadInitialiser)
+                player.threadInitialiser (thread, threadIndex);
+            else
+                setThreadPriority (thread, 10);
+        }
+
+        /** Returns the number of threads the player currently wants running.
+            Threads with an index at or above this should be parked.
+        */
+        size_t getNumActiveThreads() const
+        {
+            return player.numActiveThreads.load (std::memory_order_acquire);
+        }
+
+        /** Returns the number of threads it's worth signalling out of the number created,
+            as any parked threads won't be waiting for the signal.
+        */
+        int getNumThreadsToSignal (size_t numThreadsCreated) const
+        {
+            return (int) std::min (numThreadsCreated, getNumActiveThreads());
+        }
+
+        /** Subclasses should call this from each thread's run loop before processing.
+            If the player doesn't currently need the thread, this blocks until it does
+            or the threads should exit, then returns true so the loop can check again.
+            Returns false straight away if the thread is active.
+        */
+        bool parkIfInactive (size_t threadIndex)
+        {
+            if (threadIndex < getNumActiveThreads())
+                return false;
+
+            // Register as parked before checking again so a concurrent unparkThreads
+            // call either sees this thread or this thread sees the new count
+            numThreadsParked.fetch_add (1);
+
+            if (threadIndex < player.numActiveThreads.load() || threadsShouldExit.load())
+            {
+                numThreadsParked.fetch_sub (1);
+                return false;
+            }
+
+            parkingSemaphore.wait();
+            numThreadsParked.fetch_sub (1);
+
+            return true;
+        }
+
+        /** Wakes any parked threads so they can check if they're needed. */
+        void unparkThreads()
+        {
+            if (const auto numParked = numThreadsParked.load(); numParked > 0)
+                parkingSemaphore.signal (numParked);
+        }
+        // BEATCONNECT MODIFICATION END
         
     private:
         LockFreeMultiThreadedNodePlayer& player;
         std::atomic<bool> threadsShouldExit { false };
         std::atomic<LockFreeMultiThreadedNodePlayer::PreparedNode*> currentPreparedNode { nullptr };
+        // BEATCONNECT MODIFICATION START
+        std::atomic<int> numThreadsParked { 0 };
+        LightweightSemaphore parkingSemaphore;
+        // BEATCONNECT MODIFICATION END
     };
 
     //==============================================================================
@@ -209,6 +295,40 @@ public:
         N.B. this will pause processing whilst updating the threads so there will be a gap in the audio.
     */
     void setNumThreads (size_t);
+
+    // BEATCONNECT MODIFICATION START
+    using ThreadInitialiser = std::function<void (std::thread&, size_t threadIndex)>;
+
+    /** Sets a function to call on each worker thread when it's created, which can set
+        its priority and the CPUs it runs on. Without one, workers get the highest priority.
+        This only applies to threads created afterwards so should be set before setNumThreads.
+    */
+    void setThreadInitialiser (ThreadInitialiser);
+
+    /** Enables or disables adapting the number of worker threads to the graph.
+        When enabled, the player measures how many threads each block actually keeps
+        busy and parks the workers it doesn't need, up to the number set with
+        setNumThreads. Parked workers block without using any CPU and are woken
+        without recreating them when the graph needs them again.
+        @see WorkerCountController
+    */
+    void enableAdaptiveThreadCount (bool);
+
+    /** Returns true if the number of worker threads adapts to the graph. */
+    bool isAdaptiveThreadCountEnabled() const
+    {
+        return adaptiveThreadCount.load (std::memory_order_acquire);
+    }
+
+    /** Returns the number of worker threads currently running.
+        Unless adaptive thread count is enabled, this is the number set with setNumThreads.
+    */
+    size_t getNumActiveThreads() const
+    {
+        return std::min (numActiveThreads.load (std::memory_order_acquire),
+                         numThreadsToUse.load (std::memory_order_acquire));
+    }
+    // BEATCONNECT MODIFICATION END
     
     /** Sets the Node to process. */
     void setNode (std::unique_ptr<Node>);
@@ -253,6 +373,20 @@ public:
 
 private:
     //==============================================================================
+    // BEATCONNECT MODIFICATION START
+    ThreadInitialiser threadInitialiser;
+    std::atomic<bool> adaptiveThreadCount { false }, shouldResetWorkerCount { false };
+    std::atomic<size_t> numActiveThreads { std::numeric_limits<size_t>::max() };
+    std::atomic<bool> measureBusyTime { false };
+
+    // Each thread adds the time it spends processing to its own slot, the audio thread using
+    // the first. The totals are summed once at the end of each block.
+    static constexpr size_t numBusyTimeSlots = 64;
+    struct alignas (64) BusyTime { std::atomic<int64_t> nanoseconds { 0 }; };
+    std::array<BusyTime, numBusyTimeSlots> busyTimes;
+    int64_t lastTotalBusyNanoseconds = 0;
+    WorkerCountController workerCountController;
+    // BEATCONNECT MODIFICATION END
     std::atomic<size_t> numThreadsToUse { std::max ((size_t) 0, (size_t) std::thread::hardware_concurrency() - 1) };
     juce::Range<int64_t> referenceSampleRange;
     choc::buffer::FrameCount numSamplesToProcess = 0;
@@ -289,10 +423,15 @@ private:
     static void buildNodesOutputLists (PreparedNode&);
     void resetProcessQueue (PreparedNode&);
     Node* updateProcessQueueForNode (PreparedNode&, Node&);
-    void processNode (PreparedNode&, Node&);
+    void processNode (PreparedNode&, Node&, size_t busyTimeSlot);
+
+    // BEATCONNECT MODIFICATION START
+    static size_t getMaxNumParallelNodes (const PreparedNode&);
+    void updateNumActiveThreads (const PreparedNode&, double busySeconds, double wallSeconds);
+    // BEATCONNECT MODIFICATION END
 
     //==============================================================================
-    bool processNextFreeNode (PreparedNode&);
+    bool processNextFreeNode (PreparedNode&, size_t busyTimeSlot);
 };
 
 }}
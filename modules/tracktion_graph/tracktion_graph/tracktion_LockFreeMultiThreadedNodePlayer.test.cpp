@@ -0,0 +1,294 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_BENCHMARKS
+ #include <ctime>
+ #include "../../tracktion_core/utilities/tracktion_Benchmark.h"
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+namespace adaptive_thread_count_test_utilities
+{
+    /** Creates a single chain of Nodes, which has no parallelism.
+        Each Node uses some CPU but leaves the sin wave unchanged.
+    */
+    inline std::unique_ptr<Node> createSerialGraph (int numNodes)
+    {
+        std::unique_ptr<Node> node = makeNode<SinNode> (220.0f);
+
+        for (int i = 0; i < numNodes; ++i)
+            node = makeNode<FunctionNode> (std::move (node), [] (float s) { return std::sin (std::asin (s)); });
+
+        return node;
+    }
+
+    /** Creates a number of parallel chains that are summed together at the end. */
+    inline std::unique_ptr<Node> createParallelGraph (int numChains, int numNodesPerChain)
+    {
+        std::vector<std::unique_ptr<Node>> chains;
+
+        for (int i = 0; i < numChains; ++i)
+            chains.push_back (makeGainNode (createSerialGraph (numNodesPerChain), 1.0f / numChains));
+
+        return makeNode<SummingNode> (std::move (chains));
+    }
+}
+
+#if GRAPH_UNIT_TESTS_LOCKFREEMULTITHREADEDNODEPLAYER
+
+//==============================================================================
+//==============================================================================
+class LockFreeMultiThreadedNodePlayerTests  : public juce::UnitTest
+{
+public:
+    LockFreeMultiThreadedNodePlayerTests()
+        : juce::UnitTest ("LockFreeMultiThreadedNodePlayer", "tracktion_graph")
+    {
+    }
+
+    void runTest() override
+    {
+        runWorkerCountControllerTests();
+
+        for (auto strategy : test_utilities::getThreadPoolStrategies())
+            runAdaptiveThreadCountTests (strategy);
+    }
+
+private:
+    void runWorkerCountControllerTests()
+    {
+        beginTest ("Worker count increases when threads are saturated");
+        {
+            WorkerCountController controller;
+            controller.setMaxNumWorkers (3);
+            controller.reset (0);
+
+            // A single busy thread could be hiding more parallelism
+            for (int i = 0; i < 3; ++i)
+                expectEquals (controller.update (1.0, 1.0, 10.0), (size_t) 0);
+
+            expectEquals (controller.update (1.0, 1.0, 10.0), (size_t) 1);
+
+            // Getting close to the deadline adds a worker straight away
+            expectEquals (controller.update (1.0, 8.0, 10.0), (size_t) 2);
+            expectEquals (controller.update (1.0, 8.0, 10.0), (size_t) 3);
+            expectEquals (controller.update (1.0, 8.0, 10.0), (size_t) 3);
+        }
+
+        beginTest ("Worker count decreases with hysteresis");
+        {
+            WorkerCountController controller;
+            controller.setMaxNumWorkers (3);
+            controller.reset (3);
+
+            // Only one of the four threads is ever busy
+            for (int i = 0; i < 63; ++i)
+                expectEquals (controller.update (1.0, 1.0, 10.0), (size_t) 3);
+
+            expectEquals (controller.update (1.0, 1.0, 10.0), (size_t) 2);
+
+            // A block that needs the workers restarts the count
+            for (int i = 0; i < 32; ++i)
+                controller.update (1.0, 1.0, 10.0);
+
+            controller.update (2.9, 1.0, 10.0);
+
+            for (int i = 0; i < 63; ++i)
+                expectEquals (controller.update (1.0, 1.0, 10.0), (size_t) 2);
+
+            expectEquals (controller.update (1.0, 1.0, 10.0), (size_t) 1);
+
+            // Removing the last worker would leave a single thread too busy
+            for (int i = 0; i < 200; ++i)
+                expectEquals (controller.update (1.0, 1.0, 10.0), (size_t) 1);
+        }
+
+        beginTest ("Worker count limited by graph");
+        {
+            WorkerCountController controller;
+            controller.setMaxNumWorkers (7);
+            controller.reset (7);
+            expectEquals (controller.getNumWorkers(), (size_t) 7);
+
+            controller.setMaxNumWorkers (1);
+            expectEquals (controller.getNumWorkers(), (size_t) 1);
+
+            for (int i = 0; i < 10; ++i)
+                expectEquals (controller.update (2.0, 9.0, 10.0), (size_t) 1);
+        }
+    }
+
+    void runAdaptiveThreadCountTests (ThreadPoolStrategy strategy)
+    {
+        using namespace adaptive_thread_count_test_utilities;
+        const test_utilities::TestSetup testSetup { 44100.0, 256, false, getRandom() };
+
+        auto createPlayer = [&] (std::unique_ptr<Node> node)
+        {
+            auto player = std::make_unique<LockFreeMultiThreadedNodePlayer> (getPoolCreatorFunction (strategy));
+            player->setNumThreads (3);
+            player->setNode (std::move (node), testSetup.sampleRate, testSetup.blockSize);
+            player->enableAdaptiveThreadCount (true);
+
+            return player;
+        };
+
+        beginTest ("Adaptive thread count: " + test_utilities::getName (strategy));
+        {
+            // A serial graph can't use any workers
+            {
+                test_utilities::TestProcess<LockFreeMultiThreadedNodePlayer> testContext (createPlayer (createSerialGraph (8)),
+                                                                                          testSetup, 1, 1.0, true);
+                testContext.processAll();
+                expectEquals (testContext.getNodePlayer().getNumActiveThreads(), (size_t) 0);
+                test_utilities::expectAudioBuffer (*this, testContext.getTestResult()->buffer, 0, 1.0f, 0.707f);
+            }
+
+            // Two chains can't use more than one worker
+            {
+                test_utilities::TestProcess<LockFreeMultiThreadedNodePlayer> testContext (createPlayer (createParallelGraph (2, 8)),
+                                                                                          testSetup, 1, 1.0, true);
+                testContext.processAll();
+                expect (testContext.getNodePlayer().getNumActiveThreads() <= 1);
+            }
+
+            // Workers are parked and woken as the graph changes without affecting the output
+            {
+                test_utilities::TestProcess<LockFreeMultiThreadedNodePlayer> testContext (createPlayer (createParallelGraph (8, 4)),
+                                                                                          testSetup, 1, 4.0, true);
+                auto& player = testContext.getNodePlayer();
+                const int numSamplesPerSection = juce::roundToInt (testSetup.sampleRate);
+
+                testContext.process (numSamplesPerSection);
+                expect (player.getNumActiveThreads() <= 3);
+
+                testContext.setNode (createSerialGraph (4));
+                testContext.process (numSamplesPerSection);
+                expectEquals (player.getNumActiveThreads(), (size_t) 0);
+
+                testContext.setNode (createParallelGraph (8, 4));
+                testContext.process (numSamplesPerSection);
+
+                player.enableAdaptiveThreadCount (false);
+                expectEquals (player.getNumActiveThreads(), (size_t) 3);
+                testContext.process (numSamplesPerSection);
+
+                test_utilities::expectAudioBuffer (*this, testContext.getTestResult()->buffer, 0, 1.0f, 0.707f);
+            }
+        }
+    }
+};
+
+static LockFreeMultiThreadedNodePlayerTests lockFreeMultiThreadedNodePlayerTests;
+
+#endif
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+class AdaptiveThreadCountBenchmarks : public juce::UnitTest
+{
+public:
+    AdaptiveThreadCountBenchmarks()
+        : juce::UnitTest ("Adaptive thread count", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        using namespace adaptive_thread_count_test_utilities;
+
+        for (auto strategy : { ThreadPoolStrategy::realTime, ThreadPoolStrategy::lightweightSemHybrid })
+        {
+            for (bool adaptive : { false, true })
+            {
+                runBenchmark ("serial", [] { return createSerialGraph (128); }, strategy, adaptive);
+                runBenchmark ("2 chains", [] { return createParallelGraph (2, 64); }, strategy, adaptive);
+                runBenchmark ("64 chains", [] { return createParallelGraph (64, 4); }, strategy, adaptive);
+            }
+        }
+    }
+
+private:
+    void runBenchmark (std::string graphName, std::function<std::unique_ptr<Node>()> createGraph,
+                       ThreadPoolStrategy strategy, bool adaptive)
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 256;
+        constexpr int numWarmUpBlocks = 100, numBlocks = 500;
+
+        const auto name = graphName + ", " + test_utilities::getName (strategy).toStdString()
+                            + (adaptive ? ", adaptive" : ", fixed");
+        beginTest (name);
+
+        LockFreeMultiThreadedNodePlayer player (getPoolCreatorFunction (strategy));
+        player.setNumThreads ((size_t) std::max (1, (int) std::thread::hardware_concurrency() - 1));
+        player.setNode (createGraph(), sampleRate, blockSize);
+        player.enableAdaptiveThreadCount (adaptive);
+
+        auto buffer = choc::buffer::createChannelArrayBuffer (1, (choc::buffer::FrameCount) blockSize, [] { return 0.0f; });
+        tracktion_engine::MidiMessageArray midi;
+        int64_t sampleNum = 0;
+
+        // Blocks are processed at the rate an audio device would ask for them so
+        // idle workers have to wait between blocks as they would when playing
+        const auto blockDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration> (std::chrono::duration<double> (blockSize / sampleRate));
+        auto nextBlockTime = std::chrono::steady_clock::now();
+
+        auto processBlock = [&]
+        {
+            std::this_thread::sleep_until (nextBlockTime);
+            nextBlockTime += blockDuration;
+
+            buffer.clear();
+            midi.clear();
+            const auto referenceSampleRange = juce::Range<int64_t>::withStartAndLength (sampleNum, blockSize);
+            player.process ({ (choc::buffer::FrameCount) blockSize, referenceSampleRange, { buffer.getView(), midi } });
+            sampleNum += blockSize;
+        };
+
+        for (int i = 0; i < numWarmUpBlocks; ++i)
+            processBlock();
+
+        Benchmark blockBenchmark (createBenchmarkDescription ("Graph", "Adaptive thread count: " + name, "Block time"));
+        const auto startCpuTime = std::clock();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            blockBenchmark.start();
+            processBlock();
+            blockBenchmark.stop();
+        }
+
+        const auto cpuSeconds = (std::clock() - startCpuTime) / (double) CLOCKS_PER_SEC;
+        BenchmarkList::getInstance().addResult (blockBenchmark.getResult());
+
+       #if ! JUCE_WINDOWS
+        // std::clock measures the CPU time of every thread in the process here, which
+        // includes the time workers spend spinning or waiting for work
+        BenchmarkResult cpuResult { createBenchmarkDescription ("Graph", "Adaptive thread count: " + name, "Total CPU time") };
+        cpuResult.totalSeconds = cpuSeconds;
+        cpuResult.meanSeconds = cpuSeconds / numBlocks;
+        BenchmarkList::getInstance().addResult (cpuResult);
+       #endif
+
+        logMessage (juce::String (name) + ": " + juce::String ((int) player.getNumActiveThreads()) + " active workers, "
+                    + juce::String (cpuSeconds * 1000.0 / numBlocks, 3) + " ms CPU per block");
+    }
+};
+
+static AdaptiveThreadCountBenchmarks adaptiveThreadCountBenchmarks;
+
+#endif
+
+}}
@@ -181,6 +181,124 @@ private:
             auto testContext = createBasicTestContext (std::move (node), testSetup, 1, 5.0);
             test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, 0.885f, 0.5f);
         }
+
+        // BEATCONNECT MODIFICATION START
+        beginTest ("Sin send/return with send gain");
+        {
+            // This is the same as the first test but the send has a gain, which the return applies as it sums
+            for (float sendGain : { 0.5f, 1.0f })
+            {
+                // Track 1 sends a sin tone to a send and then gets muted
+                auto sinLowerNode = std::make_unique<SinNode> (220.0f);
+                auto sendNode = std::make_unique<SendNode> (std::move (sinLowerNode), 1, [sendGain] { return sendGain; });
+                auto track1Node = std::make_unique<FunctionNode> (std::move (sendNode), [] (float) { return 0.0f; });
+
+                // Track 2 has a silent source and receives input from the send
+                auto sinUpperNode = std::make_unique<SinNode> (440.0f);
+                auto silentNode = std::make_unique<FunctionNode> (std::move (sinUpperNode), [] (float) { return 0.0f; });
+                auto track2Node = std::make_unique<ReturnNode> (std::move (silentNode), 1);
+
+                // Track 1 & 2 then get summed together
+                auto node = makeBaicSummingNode ({ track1Node.release(), track2Node.release() });
+
+                auto testContext = createBasicTestContext (std::move (node), testSetup, 1, 5.0);
+                test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, sendGain, sendGain * 0.707f);
+            }
+        }
+
+        beginTest ("Sin send/return read by several returns");
+        {
+            // Each return gets its own GainNode for the send, so the send is read by all of them
+            // whilst each of the gains is still applied by the return reading it
+            for (float sendGain : { 0.5f, 1.0f })
+            {
+                auto sinNode = std::make_unique<SinNode> (220.0f);
+                auto sendNode = std::make_unique<SendNode> (std::move (sinNode), 1, [sendGain] { return sendGain; });
+                auto track1Node = std::make_unique<FunctionNode> (std::move (sendNode), [] (float) { return 0.0f; });
+
+                auto track2Node = std::make_unique<ReturnNode> (1);
+                auto track3Node = std::make_unique<ReturnNode> (1);
+
+                auto node = makeBaicSummingNode ({ track1Node.release(), track2Node.release(), track3Node.release() });
+
+                auto testContext = createBasicTestContext (std::move (node), testSetup, 1, 5.0);
+                test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, 2.0f * sendGain, 2.0f * sendGain * 0.707f);
+            }
+        }
+
+        beginTest ("Gain applied by a GainNode with several readers");
+        {
+            // The gain can't be deferred to the SummingNode as another Node reads the GainNode too
+            auto gainNode = makeNode<GainNode> (makeNode<SinNode> (220.0f), [] { return 0.5f; });
+            auto gainNodePtr = gainNode.get();
+
+            std::vector<std::unique_ptr<Node>> inputs;
+            inputs.push_back (std::move (gainNode));
+            inputs.push_back (makeNode<GainNode> (gainNodePtr, [] { return 1.0f; }));
+
+            auto testContext = createBasicTestContext (makeNode<SummingNode> (std::move (inputs)), testSetup, 1, 5.0);
+            test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+        }
+
+        beginTest ("Deferred gain ramps across block boundaries");
+        {
+            // The gain changes every block so each block ramps from the previous gain. The
+            // SummingNode applying the ramp should match the GainNode applying it itself
+            auto createRampedGainGraph = [] (bool gainNodeHasSeveralReaders)
+            {
+                auto gainNode = makeNode<GainNode> (makeNode<SinNode> (220.0f),
+                                                    [count = 0] () mutable { return (count++ % 2) == 0 ? 1.0f : 0.25f; });
+                auto gainNodePtr = gainNode.get();
+
+                std::vector<std::unique_ptr<Node>> inputs;
+                inputs.push_back (std::move (gainNode));
+
+                if (gainNodeHasSeveralReaders)
+                    inputs.push_back (makeNode<GainNode> (gainNodePtr, [] { return 0.0f; }));
+
+                return makeNode<SummingNode> (std::move (inputs));
+            };
+
+            auto deferred = createBasicTestContext (createRampedGainGraph (false), testSetup, 1, 1.0);
+            auto applied = createBasicTestContext (createRampedGainGraph (true), testSetup, 1, 1.0);
+
+            auto& deferredBuffer = deferred->buffer;
+            auto& appliedBuffer = applied->buffer;
+            expectEquals (deferredBuffer.getNumSamples(), appliedBuffer.getNumSamples());
+            expectGreaterThan (deferredBuffer.getMagnitude (0, 0, deferredBuffer.getNumSamples()), 0.5f);
+
+            float maxDifference = 0.0f;
+
+            for (int i = 0; i < std::min (deferredBuffer.getNumSamples(), appliedBuffer.getNumSamples()); ++i)
+                maxDifference = std::max (maxDifference, std::abs (deferredBuffer.getSample (0, i) - appliedBuffer.getSample (0, i)));
+
+            expectLessThan (maxDifference, 1.0e-4f);
+        }
+
+        beginTest ("Single unity gain input passed on without copying");
+        {
+            for (float gain : { 1.0f, 0.5f })
+            {
+                auto sinNode = makeNode<SinNode> (220.0f);
+                auto sinNodePtr = sinNode.get();
+
+                std::vector<std::unique_ptr<Node>> inputs;
+                inputs.push_back (makeNode<GainNode> (std::move (sinNode), [gain] { return gain; }));
+
+                auto summingNode = makeNode<SummingNode> (std::move (inputs));
+                auto summingNodePtr = summingNode.get();
+
+                TestProcess<NodePlayer> testProcess (std::make_unique<NodePlayer> (std::move (summingNode)), testSetup, 1, 1.0, true);
+                auto testContext = testProcess.processAll();
+                test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, gain, gain * 0.707f);
+
+                // The SummingNode should output the SinNode's buffer unless it has to apply a gain
+                const bool isSinNodeBuffer = summingNodePtr->getProcessedOutput().audio.getIterator (0).sample
+                                               == sinNodePtr->getProcessedOutput().audio.getIterator (0).sample;
+                expect (isSinNodeBuffer == (gain == 1.0f));
+            }
+        }
+        // BEATCONNECT MODIFICATION END
     }
     
     void runLatencyTests (TestSetup testSetup)
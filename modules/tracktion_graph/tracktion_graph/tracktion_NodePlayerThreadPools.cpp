@@ -55,8 +55,10 @@ struct ThreadPoolCV : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
-            setThreadPriority (threads.back(), 10);
+            // BEATCONNECT MODIFICATION START
+            threads.emplace_back ([this, i] { runThread (i); });
+            initialiseThread (threads.back(), i);
+            // BEATCONNECT MODIFICATION END
         }
     }
 
@@ -87,8 +89,10 @@ struct ThreadPoolCV : public LockFreeMultiThreadedNodePlayer::ThreadPool
             triggered.store (true, std::memory_order_release);
         }
 
-        for (int i = std::min ((int) threads.size(), numToSignal); --i >= 0;)
+        // BEATCONNECT MODIFICATION START
+        for (int i = std::min (getNumThreadsToSignal (threads.size()), numToSignal); --i >= 0;)
              condition.notify_one();
+        // BEATCONNECT MODIFICATION END
     }
 
     void signalAll() override
@@ -148,17 +152,22 @@ private:
         return shouldWait();
     }
     
-    void runThread()
+    // BEATCONNECT MODIFICATION START
+    void runThread (size_t threadIndex)
     {
         for (;;)
         {
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (parkIfInactive (threadIndex))
+                continue;
+
+            if (! process (threadIndex))
                 wait();
         }
     }
+    // BEATCONNECT MODIFICATION END
 };
 
 
@@ -180,8 +189,10 @@ struct ThreadPoolRT : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
-            setThreadPriority (threads.back(), 10);
+            // BEATCONNECT MODIFICATION START
+            threads.emplace_back ([this, i] { runThread (i); });
+            initialiseThread (threads.back(), i);
+            // BEATCONNECT MODIFICATION END
         }
     }
 
@@ -242,17 +253,22 @@ struct ThreadPoolRT : public LockFreeMultiThreadedNodePlayer::ThreadPool
 private:
     std::vector<std::thread> threads;
 
-    void runThread()
+    // BEATCONNECT MODIFICATION START
+    void runThread (size_t threadIndex)
     {
         for (;;)
         {
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (parkIfInactive (threadIndex))
+                continue;
+
+            if (! process (threadIndex))
                 wait();
         }
     }
+    // BEATCONNECT MODIFICATION END
 
     inline void pause()
     {
@@ -285,8 +301,10 @@ struct ThreadPoolHybrid : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
-            setThreadPriority (threads.back(), 10);
+            // BEATCONNECT MODIFICATION START
+            threads.emplace_back ([this, i] { runThread (i); });
+            initialiseThread (threads.back(), i);
+            // BEATCONNECT MODIFICATION END
         }
     }
 
@@ -317,8 +335,10 @@ struct ThreadPoolHybrid : public LockFreeMultiThreadedNodePlayer::ThreadPool
             triggered.store (true, std::memory_order_release);
         }
 
-        for (int i = std::min ((int) threads.size(), numToSignal); --i >= 0;)
+        // BEATCONNECT MODIFICATION START
+        for (int i = std::min (getNumThreadsToSignal (threads.size()), numToSignal); --i >= 0;)
              condition.notify_one();
+        // BEATCONNECT MODIFICATION END
     }
 
     void signalAll() override
@@ -396,17 +416,22 @@ private:
         return shouldWait();
     }
     
-    void runThread()
+    // BEATCONNECT MODIFICATION START
+    void runThread (size_t threadIndex)
     {
         for (;;)
         {
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (parkIfInactive (threadIndex))
+                continue;
+
+            if (! process (threadIndex))
                 wait();
         }
     }
+    // BEATCONNECT MODIFICATION END
 };
 
 
@@ -430,8 +455,10 @@ struct ThreadPoolSem : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
-            setThreadPriority (threads.back(), 10);
+            // BEATCONNECT MODIFICATION START
+            threads.emplace_back ([this, i] { runThread (i); });
+            initialiseThread (threads.back(), i);
+            // BEATCONNECT MODIFICATION END
         }
     }
 
@@ -453,7 +480,9 @@ struct ThreadPoolSem : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
     void signal (int numToSignal) override
     {
-        if (semaphore) semaphore->signal (std::min (numToSignal, (int) threads.size()));
+        // BEATCONNECT MODIFICATION START
+        if (semaphore) semaphore->signal (std::min (numToSignal, getNumThreadsToSignal (threads.size())));
+        // BEATCONNECT MODIFICATION END
     }
 
     void signalAll() override
@@ -493,17 +522,22 @@ private:
     std::vector<std::thread> threads;
     std::unique_ptr<SemaphoreType> semaphore;
 
-    void runThread()
+    // BEATCONNECT MODIFICATION START
+    void runThread (size_t threadIndex)
     {
         for (;;)
         {
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (parkIfInactive (threadIndex))
+                continue;
+
+            if (! process (threadIndex))
                 wait();
         }
     }
+    // BEATCONNECT MODIFICATION END
 };
 
 
@@ -527,8 +561,10 @@ struct ThreadPoolSemHybrid : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
-            setThreadPriority (threads.back(), 10);
+            // BEATCONNECT MODIFICATION START
+            threads.emplace_back ([this, i] { runThread (i); });
+            initialiseThread (threads.back(), i);
+            // BEATCONNECT MODIFICATION END
         }
     }
 
@@ -550,7 +586,9 @@ struct ThreadPoolSemHybrid : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
     void signal (int numToSignal) override
     {
-        if (semaphore) semaphore->signal (std::min (numToSignal, (int) threads.size()));
+        // BEATCONNECT MODIFICATION START
+        if (semaphore) semaphore->signal (std::min (numToSignal, getNumThreadsToSignal (threads.size())));
+        // BEATCONNECT MODIFICATION END
     }
 
     void signalAll() override
@@ -615,17 +653,22 @@ private:
     std::vector<std::thread> threads;
     std::unique_ptr<SemaphoreType> semaphore;
 
-    void runThread()
+    // BEATCONNECT MODIFICATION START
+    void runThread (size_t threadIndex)
     {
         for (;;)
         {
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (parkIfInactive (threadIndex))
+                continue;
+
+            if (! process (threadIndex))
                 wait();
         }
     }
+    // BEATCONNECT MODIFICATION END
 };
 //==============================================================================
 //==============================================================================
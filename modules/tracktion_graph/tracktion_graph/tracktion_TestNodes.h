@@ -309,7 +309,10 @@ static inline std::unique_ptr<Node> makeGainNode (std::unique_ptr<Node> input, f
 
 //==============================================================================
 //==============================================================================
-class GainNode final : public Node
+// BEATCONNECT MODIFICATION START
+class GainNode final : public Node,
+                       public DeferrableGainNode
+// BEATCONNECT MODIFICATION END
 {
 public:
     /** Creates a GainNode that doesn't own its input. */
@@ -319,6 +322,11 @@ public:
         assert (input != nullptr);
         assert (gainFunction);
         lastGain = gainFunction();
+
+        // BEATCONNECT MODIFICATION START
+        setOptimisations ({ ClearBuffers::no,
+                            AllocateAudioBuffer::yes });
+        // BEATCONNECT MODIFICATION END
     }
 
     /** Creates a GainNode that owns its input. */
@@ -330,7 +338,24 @@ public:
         assert (input != nullptr);
         assert (gainFunction);
         lastGain = gainFunction();
+
+        // BEATCONNECT MODIFICATION START
+        setOptimisations ({ ClearBuffers::no,
+                            AllocateAudioBuffer::yes });
+        // BEATCONNECT MODIFICATION END
+    }
+
+    // BEATCONNECT MODIFICATION START
+    void setGainDeferred (bool shouldDeferGain) override
+    {
+        deferGain = shouldDeferGain;
+    }
+
+    std::pair<float, float> getDeferredGain() const override
+    {
+        return deferredGain;
     }
+    // BEATCONNECT MODIFICATION END
 
     NodeProperties getNodeProperties() override
     {
@@ -355,13 +380,27 @@ public:
     
     void process (ProcessContext& pc) override
     {
-        jassert (pc.buffers.audio.getNumChannels() == input->getProcessedOutput().audio.getNumChannels());
+        auto source = input->getProcessedOutput();
+        jassert (pc.buffers.audio.getNumChannels() == source.audio.getNumChannels());
 
-        // Just pass out input on to our output
-        copy (pc.buffers.audio, input->getProcessedOutput().audio);
-        pc.buffers.midi.mergeFrom (input->getProcessedOutput().midi);
+        // BEATCONNECT MODIFICATION START
+        // N.B We need to clear manually here due to optimisations
+        pc.buffers.midi.copyFrom (source.midi);
         
         float gain = gainFunction();
+
+        // If the gain is being applied by the Node reading this, or there's no gain to
+        // apply, the input can be passed on without copying it
+        if (deferGain || (gain == lastGain && gain == 1.0f))
+        {
+            setAudioOutput (input, source.audio);
+            deferredGain = { lastGain, gain };
+            lastGain = gain;
+            return;
+        }
+
+        copy (pc.buffers.audio, source.audio);
+        // BEATCONNECT MODIFICATION END
         
         if (gain == lastGain)
         {
@@ -386,6 +425,11 @@ private:
     Node* input = nullptr;
     std::function<float()> gainFunction;
     float lastGain = 0.0f;
+
+    // BEATCONNECT MODIFICATION START
+    bool deferGain = false;
+    std::pair<float, float> deferredGain { 1.0f, 1.0f };
+    // BEATCONNECT MODIFICATION END
 };
 
 //==============================================================================
@@ -174,9 +174,10 @@ private:
             constexpr int numThreads = 20;
             std::vector<std::thread> pool;
             std::atomic<bool> shouldExit { false };
+            std::atomic<int> numThreadsFinished { 0 };
 
             for (int threadNum = 0; threadNum < numThreads; ++threadNum)
-                pool.emplace_back ([&shouldExit]
+                pool.emplace_back ([&shouldExit, &numThreadsFinished]
                                    {
                                        const size_t maxSize = 100'000;
                                        juce::Random r;
@@ -206,6 +207,8 @@ private:
                                       #if LOG_RPALLOCATIONS
                                        std::cout << "num ints: " << vec.size() << "\n";
                                       #endif
+
+                                       ++numThreadsFinished;
                                    });
             
             using namespace std::literals;
@@ -215,7 +218,7 @@ private:
             for (auto& thread : pool)
                 thread.join();
             
-            expect (true);
+            expectEquals (numThreadsFinished.load(), numThreads);
         }
     }
 };
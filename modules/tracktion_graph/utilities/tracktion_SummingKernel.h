@@ -0,0 +1,164 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+// BEATCONNECT MODIFICATION START
+#if JUCE_INTEL
+ #include <xmmintrin.h>
+#elif JUCE_ARM && defined (__ARM_NEON)
+ #include <arm_neon.h>
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+/** A channel to be summed by sumChannels, with a gain that ramps linearly over the block. */
+struct SummingSource
+{
+    const float* samples = nullptr;     /**< The channel's samples. */
+    float gain = 1.0f;                  /**< The gain to apply to the first sample. */
+    float gainIncrement = 0.0f;         /**< The amount the gain changes by each sample. */
+};
+
+namespace summing_kernel
+{
+   #if JUCE_INTEL
+    using Vector = __m128;
+
+    inline Vector load (const float* p)                 { return _mm_loadu_ps (p); }
+    inline void store (float* p, Vector v)              { _mm_storeu_ps (p, v); }
+    inline Vector add (Vector a, Vector b)              { return _mm_add_ps (a, b); }
+    inline Vector multiply (Vector a, Vector b)         { return _mm_mul_ps (a, b); }
+    inline Vector broadcast (float v)                   { return _mm_set1_ps (v); }
+   #elif JUCE_ARM && defined (__ARM_NEON)
+    using Vector = float32x4_t;
+
+    inline Vector load (const float* p)                 { return vld1q_f32 (p); }
+    inline void store (float* p, Vector v)              { vst1q_f32 (p, v); }
+    inline Vector add (Vector a, Vector b)              { return vaddq_f32 (a, b); }
+    inline Vector multiply (Vector a, Vector b)         { return vmulq_f32 (a, b); }
+    inline Vector broadcast (float v)                   { return vdupq_n_f32 (v); }
+   #else
+    // Without intrinsics, fixed size loops the compiler can vectorise
+    struct Vector { float v[4]; };
+
+    inline Vector load (const float* p)                 { return { { p[0], p[1], p[2], p[3] } }; }
+    inline void store (float* p, Vector v)              { for (int i = 0; i < 4; ++i) p[i] = v.v[i]; }
+    inline Vector add (Vector a, Vector b)              { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+    inline Vector multiply (Vector a, Vector b)         { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+    inline Vector broadcast (float v)                   { return { { v, v, v, v } }; }
+   #endif
+
+    constexpr int vectorSize = 4;
+
+    /** The number of sources summed in each pass. Each pass reads and writes the
+        destination once, so more sources per pass means less memory traffic, up to
+        the point where the gains no longer fit in registers.
+    */
+    constexpr int maxNumSourcesPerPass = 4;
+
+    inline Vector ramp (float start, float increment)
+    {
+        alignas (16) const float values[vectorSize] = { start, start + increment, start + 2.0f * increment, start + 3.0f * increment };
+        return load (values);
+    }
+
+    template<int numSources, bool addToDest>
+    void sumPass (float* dest, const SummingSource* sources, choc::buffer::FrameCount numFrames)
+    {
+        Vector gains[numSources], increments[numSources];
+
+        for (int s = 0; s < numSources; ++s)
+        {
+            gains[s] = ramp (sources[s].gain, sources[s].gainIncrement);
+            increments[s] = broadcast (sources[s].gainIncrement * (float) vectorSize);
+        }
+
+        choc::buffer::FrameCount i = 0;
+
+        for (; i + vectorSize <= numFrames; i += vectorSize)
+        {
+            auto sum = addToDest ? load (dest + i) : broadcast (0.0f);
+
+            for (int s = 0; s < numSources; ++s)
+            {
+                sum = add (sum, multiply (load (sources[s].samples + i), gains[s]));
+                gains[s] = add (gains[s], increments[s]);
+            }
+
+            store (dest + i, sum);
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            auto sum = addToDest ? dest[i] : 0.0f;
+
+            for (int s = 0; s < numSources; ++s)
+                sum += sources[s].samples[i] * (sources[s].gain + sources[s].gainIncrement * (float) i);
+
+            dest[i] = sum;
+        }
+    }
+
+    template<int numSources>
+    void sumPass (float* dest, const SummingSource* sources, choc::buffer::FrameCount numFrames, bool addToDest)
+    {
+        if (addToDest)
+            sumPass<numSources, true> (dest, sources, numFrames);
+        else
+            sumPass<numSources, false> (dest, sources, numFrames);
+    }
+}
+
+//==============================================================================
+/** Sums a number of channels, each with its own gain, in to a destination channel.
+
+    The sources are summed several at a time so the destination is only read and
+    written once for every few sources, and the gains are applied in the same pass.
+    This makes it much cheaper than clearing the destination and adding each source
+    in turn when there are lots of sources.
+
+    @param dest         The channel to write to. This mustn't overlap any of the sources.
+    @param sources      The channels to sum, which must all have at least numFrames samples
+    @param numSources   The number of sources
+    @param numFrames    The number of samples to sum
+    @param addToDest    If true the sum is added to the destination, otherwise it replaces it
+*/
+inline void sumChannels (float* dest, const SummingSource* sources, size_t numSources,
+                         choc::buffer::FrameCount numFrames, bool addToDest = false)
+{
+    if (numSources == 0)
+    {
+        if (! addToDest)
+            std::fill_n (dest, numFrames, 0.0f);
+
+        return;
+    }
+
+    for (size_t start = 0; start < numSources; start += summing_kernel::maxNumSourcesPerPass)
+    {
+        const auto numThisPass = std::min (numSources - start, (size_t) summing_kernel::maxNumSourcesPerPass);
+        const bool addThisPass = addToDest || start > 0;
+        const auto passSources = sources + start;
+
+        switch (numThisPass)
+        {
+            case 1:     summing_kernel::sumPass<1> (dest, passSources, numFrames, addThisPass); break;
+            case 2:     summing_kernel::sumPass<2> (dest, passSources, numFrames, addThisPass); break;
+            case 3:     summing_kernel::sumPass<3> (dest, passSources, numFrames, addThisPass); break;
+            default:    summing_kernel::sumPass<4> (dest, passSources, numFrames, addThisPass); break;
+        }
+    }
+}
+
+}}
+// BEATCONNECT MODIFICATION END
@@ -0,0 +1,208 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2018
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_BENCHMARKS
+ #include "../../tracktion_core/utilities/tracktion_Benchmark.h"
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_SUMMINGKERNEL
+
+//==============================================================================
+//==============================================================================
+class SummingKernelTests    : public juce::UnitTest
+{
+public:
+    SummingKernelTests()
+        : juce::UnitTest ("SummingKernel", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        runKernelTests();
+        runDeferredGainTests();
+    }
+
+private:
+    void runKernelTests()
+    {
+        beginTest ("Kernel matches scalar sum");
+        {
+            auto& r = getRandom();
+            constexpr size_t maxNumSources = 9;
+            constexpr choc::buffer::FrameCount maxNumFrames = 259;
+
+            std::vector<std::vector<float>> sourceData (maxNumSources, std::vector<float> (maxNumFrames));
+
+            for (auto& data : sourceData)
+                for (auto& s : data)
+                    s = r.nextFloat() * 2.0f - 1.0f;
+
+            for (size_t numSources = 0; numSources <= maxNumSources; ++numSources)
+            {
+                for (choc::buffer::FrameCount numFrames : { 0u, 1u, 3u, 4u, 7u, 64u, 259u })
+                {
+                    for (bool addToDest : { false, true })
+                    {
+                        std::vector<SummingSource> sources;
+
+                        for (size_t i = 0; i < numSources; ++i)
+                        {
+                            // Alternate between constant and ramped gains
+                            const auto increment = (i % 2) == 0 ? 0.0f : (r.nextFloat() - 0.5f) / (float) maxNumFrames;
+                            sources.push_back ({ sourceData[i].data(), r.nextFloat() * 2.0f, increment });
+                        }
+
+                        std::vector<float> dest (numFrames, 0.5f), expected (numFrames);
+
+                        for (choc::buffer::FrameCount f = 0; f < numFrames; ++f)
+                        {
+                            double sum = addToDest ? 0.5 : 0.0;
+
+                            for (auto& source : sources)
+                                sum += source.samples[f] * (source.gain + source.gainIncrement * (double) f);
+
+                            expected[f] = (float) sum;
+                        }
+
+                        sumChannels (dest.data(), sources.data(), sources.size(), numFrames, addToDest);
+
+                        float maxError = 0.0f;
+
+                        for (choc::buffer::FrameCount f = 0; f < numFrames; ++f)
+                            maxError = std::max (maxError, std::abs (dest[f] - expected[f]));
+
+                        expectLessThan (maxError, 1.0e-4f, juce::String ((int) numSources) + " sources, "
+                                                            + juce::String ((int) numFrames) + " frames");
+                    }
+                }
+            }
+        }
+    }
+
+    void runDeferredGainTests()
+    {
+        beginTest ("Deferred gains summed in one pass");
+        {
+            const test_utilities::TestSetup testSetup { 44100.0, 512, true, getRandom() };
+
+            std::vector<std::unique_ptr<Node>> nodes;
+            nodes.push_back (makeNode<GainNode> (makeNode<SinNode> (220.0f, 2), [] { return 0.5f; }));
+            nodes.push_back (makeNode<GainNode> (makeNode<SinNode> (220.0f, 2), [] { return 0.25f; }));
+
+            auto testContext = test_utilities::createBasicTestContext (makeNode<SummingNode> (std::move (nodes)), testSetup, 2, 1.0);
+            auto& buffer = testContext->buffer;
+
+            for (int channel : { 0, 1 })
+                test_utilities::expectAudioBuffer (*this, buffer, channel, 0.75f, 0.53f);
+        }
+    }
+};
+
+static SummingKernelTests summingKernelTests;
+
+#endif
+
+#if TRACKTION_BENCHMARKS
+
+//==============================================================================
+//==============================================================================
+class SummingKernelBenchmarks   : public juce::UnitTest
+{
+public:
+    SummingKernelBenchmarks()
+        : juce::UnitTest ("SummingKernel", "tracktion_benchmarks") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        for (int numInputs : { 2, 8, 32, 200 })
+            for (int blockSize : { 64, 256, 1024 })
+                runBenchmarks (numInputs, blockSize);
+    }
+
+private:
+    void runBenchmarks (int numInputs, int blockSize)
+    {
+        constexpr choc::buffer::ChannelCount numChannels = 2;
+        const auto numFrames = (choc::buffer::FrameCount) blockSize;
+        const int numBlocks = std::max (100, 2'000'000 / (numInputs * blockSize));
+        const auto name = juce::String (numInputs) + " inputs, " + juce::String (blockSize) + " frames";
+
+        beginTest (name);
+
+        auto& r = getRandom();
+        std::vector<choc::buffer::ChannelArrayBuffer<float>> inputs;
+        std::vector<std::pair<float, float>> gains;
+
+        for (int i = 0; i < numInputs; ++i)
+        {
+            inputs.push_back (choc::buffer::createChannelArrayBuffer (numChannels, numFrames, [&] { return r.nextFloat() * 2.0f - 1.0f; }));
+            gains.push_back ({ r.nextFloat(), r.nextFloat() });
+        }
+
+        choc::buffer::ChannelArrayBuffer<float> dest (numChannels, numFrames);
+        choc::buffer::ChannelArrayBuffer<float> scratch (numChannels, numFrames);
+
+        // A separate gain pass on each input before it's added to the cleared destination
+        {
+            Benchmark b (createBenchmarkDescription ("Graph", "Summing: " + name.toStdString(), "Separate gain and add passes"));
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                b.start();
+                dest.clear();
+
+                for (size_t i = 0; i < inputs.size(); ++i)
+                {
+                    copy (scratch, inputs[i]);
+                    applyGain (scratch.getChannelRange ({ 0, 1 }), gains[i].first);
+                    applyGain (scratch.getChannelRange ({ 1, 2 }), gains[i].second);
+                    add (dest, scratch);
+                }
+
+                b.stop();
+            }
+
+            BenchmarkList::getInstance().addResult (b.getResult());
+        }
+
+        // The gains applied as each input is summed, several inputs per pass
+        {
+            Benchmark b (createBenchmarkDescription ("Graph", "Summing: " + name.toStdString(), "Fused multi-input kernel"));
+            std::vector<SummingSource> sources (inputs.size());
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                b.start();
+
+                for (choc::buffer::ChannelCount channel = 0; channel < numChannels; ++channel)
+                {
+                    for (size_t i = 0; i < inputs.size(); ++i)
+                        sources[i] = { inputs[i].getIterator (channel).sample, channel == 0 ? gains[i].first : gains[i].second, 0.0f };
+
+                    sumChannels (dest.getIterator (channel).sample, sources.data(), sources.size(), numFrames);
+                }
+
+                b.stop();
+            }
+
+            BenchmarkList::getInstance().addResult (b.getResult());
+        }
+    }
+};
+
+static SummingKernelBenchmarks summingKernelBenchmarks;
+
+#endif
+
+}}
@@ -14,6 +14,11 @@
  #include <windows.h>
 #endif
 
+// BEATCONNECT MODIFICATION START
+#include <cstring>
+#include <cerrno>
+// BEATCONNECT MODIFICATION END
+
 namespace tracktion { inline namespace graph
 {
 
@@ -60,4 +65,242 @@ bool setThreadPriority (std::thread& t, int priority)
     return setThreadPriority (t.native_handle(), priority);
 }
 
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+namespace placement
+{
+    inline void addError (ThreadPlacementResult& result, const std::string& error)
+    {
+        if (! result.error.empty())
+            result.error += "; ";
+
+        result.error += error;
+    }
+
+   #ifdef _WIN32
+    inline ThreadPlacementResult applyThreadPlacement (void* handle, const ThreadPlacement& placement)
+    {
+        assert (handle != nullptr);
+        ThreadPlacementResult result;
+
+        if (! placement.cpus.empty())
+        {
+            DWORD_PTR mask = 0;
+
+            for (auto cpu : placement.cpus)
+                if (cpu >= 0 && cpu < (int) (sizeof (DWORD_PTR) * 8))
+                    mask |= ((DWORD_PTR) 1) << cpu;
+
+            // There's no way to read back a thread's affinity so this reports what was set
+            if (SetThreadAffinityMask (handle, mask) != 0)
+                result.cpus = placement.cpus;
+            else
+                addError (result, "Couldn't set the CPU affinity (error " + std::to_string (GetLastError()) + ")");
+        }
+
+        if (placement.scheduling != ThreadScheduling::unchanged)
+        {
+            const int pri = placement.scheduling == ThreadScheduling::normal ? THREAD_PRIORITY_NORMAL
+                                                                            : THREAD_PRIORITY_TIME_CRITICAL;
+
+            if (SetThreadPriority (handle, pri) == FALSE)
+                addError (result, "Couldn't set the thread priority (error " + std::to_string (GetLastError()) + ")");
+        }
+
+        const int pri = GetThreadPriority (handle);
+
+        if (pri != THREAD_PRIORITY_ERROR_RETURN)
+        {
+            result.scheduling = pri == THREAD_PRIORITY_TIME_CRITICAL ? ThreadScheduling::fifo : ThreadScheduling::normal;
+            result.priority = pri;
+        }
+
+        return result;
+    }
+   #else
+    template<typename HandleType>
+    ThreadPlacementResult applyThreadPlacement (HandleType handle, const ThreadPlacement& placement)
+    {
+        assert (handle != HandleType());
+        ThreadPlacementResult result;
+        const auto thread = (pthread_t) handle;
+
+       #ifdef __linux__
+        if (! placement.cpus.empty())
+        {
+            cpu_set_t cpuSet;
+            CPU_ZERO (&cpuSet);
+
+            for (auto cpu : placement.cpus)
+                if (cpu >= 0 && cpu < CPU_SETSIZE)
+                    CPU_SET (cpu, &cpuSet);
+
+            if (auto err = pthread_setaffinity_np (thread, sizeof (cpuSet), &cpuSet))
+                addError (result, std::string ("Couldn't set the CPU affinity: ") + std::strerror (err));
+        }
+
+        cpu_set_t actualCpus;
+        CPU_ZERO (&actualCpus);
+
+        if (pthread_getaffinity_np (thread, sizeof (actualCpus), &actualCpus) == 0)
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                if (CPU_ISSET (cpu, &actualCpus))
+                    result.cpus.push_back (cpu);
+       #else
+        if (! placement.cpus.empty())
+            addError (result, "CPU affinity isn't supported on this platform");
+       #endif
+
+        if (placement.scheduling != ThreadScheduling::unchanged)
+        {
+            const int policy = placement.scheduling == ThreadScheduling::fifo ? SCHED_FIFO
+                             : placement.scheduling == ThreadScheduling::roundRobin ? SCHED_RR
+                                                                                     : SCHED_OTHER;
+            struct sched_param param;
+            param.sched_priority = std::max (sched_get_priority_min (policy),
+                                             std::min (sched_get_priority_max (policy), placement.priority));
+
+            if (auto err = pthread_setschedparam (thread, policy, &param))
+                addError (result, std::string ("Couldn't set the scheduling policy: ") + std::strerror (err));
+        }
+
+        struct sched_param param;
+        int policy;
+
+        if (pthread_getschedparam (thread, &policy, &param) == 0)
+        {
+            result.scheduling = policy == SCHED_FIFO ? ThreadScheduling::fifo
+                              : policy == SCHED_RR ? ThreadScheduling::roundRobin
+                                                   : ThreadScheduling::normal;
+            result.priority = param.sched_priority;
+        }
+
+        return result;
+    }
+   #endif
+}
+
+ThreadPlacementResult applyThreadPlacement (std::thread& t, const ThreadPlacement& placement)
+{
+    return placement::applyThreadPlacement (t.native_handle(), placement);
+}
+
+ThreadPlacementResult applyThreadPlacementToCurrentThread (const ThreadPlacement& placement)
+{
+   #ifdef _WIN32
+    return placement::applyThreadPlacement (GetCurrentThread(), placement);
+   #else
+    return placement::applyThreadPlacement (pthread_self(), placement);
+   #endif
+}
+
+//==============================================================================
+PreparedThreadPlacement::PreparedThreadPlacement (const ThreadPlacement& placementToUse)
+    : placement (placementToUse)
+{
+   #ifdef _WIN32
+    static_assert (sizeof (DWORD_PTR) <= sizeof (cpuSet), "The CPU mask doesn't fit");
+    DWORD_PTR mask = 0;
+
+    for (auto cpu : placement.cpus)
+        if (cpu >= 0 && cpu < (int) (sizeof (DWORD_PTR) * 8))
+            mask |= ((DWORD_PTR) 1) << cpu;
+
+    std::memcpy (cpuSet, &mask, sizeof (mask));
+    schedulingPriority = placement.scheduling == ThreadScheduling::normal ? THREAD_PRIORITY_NORMAL
+                                                                          : THREAD_PRIORITY_TIME_CRITICAL;
+   #else
+   #ifdef __linux__
+    static_assert (sizeof (cpu_set_t) <= sizeof (cpuSet), "The CPU set doesn't fit");
+    auto& set = *reinterpret_cast<cpu_set_t*> (cpuSet);
+    CPU_ZERO (&set);
+
+    for (auto cpu : placement.cpus)
+        if (cpu >= 0 && cpu < CPU_SETSIZE)
+            CPU_SET (cpu, &set);
+   #endif
+
+    schedulingPolicy = placement.scheduling == ThreadScheduling::fifo ? SCHED_FIFO
+                     : placement.scheduling == ThreadScheduling::roundRobin ? SCHED_RR
+                                                                            : SCHED_OTHER;
+    schedulingPriority = std::max (sched_get_priority_min (schedulingPolicy),
+                                   std::min (sched_get_priority_max (schedulingPolicy), placement.priority));
+   #endif
+}
+
+PreparedThreadPlacement::Status PreparedThreadPlacement::applyToCurrentThread() const noexcept
+{
+    Status status;
+
+   #ifdef _WIN32
+    auto handle = GetCurrentThread();
+
+    if (! placement.cpus.empty())
+    {
+        DWORD_PTR mask;
+        std::memcpy (&mask, cpuSet, sizeof (mask));
+
+        if (SetThreadAffinityMask (handle, mask) == 0)
+            status.affinityError = (int) GetLastError();
+    }
+
+    if (placement.scheduling != ThreadScheduling::unchanged)
+        if (SetThreadPriority (handle, schedulingPriority) == FALSE)
+            status.schedulingError = (int) GetLastError();
+   #else
+    const auto thread = pthread_self();
+
+    if (! placement.cpus.empty())
+    {
+       #ifdef __linux__
+        status.affinityError = pthread_setaffinity_np (thread, sizeof (cpu_set_t), reinterpret_cast<const cpu_set_t*> (cpuSet));
+       #else
+        status.affinityError = ENOTSUP;
+       #endif
+    }
+
+    if (placement.scheduling != ThreadScheduling::unchanged)
+    {
+        struct sched_param param;
+        param.sched_priority = schedulingPriority;
+        status.schedulingError = pthread_setschedparam (thread, schedulingPolicy, &param);
+    }
+   #endif
+
+    return status;
+}
+
+ThreadPlacementResult PreparedThreadPlacement::createResult (Status status) const
+{
+    ThreadPlacementResult result;
+
+    auto describeError = [] (int error)
+    {
+       #ifdef _WIN32
+        return "error " + std::to_string (error);
+       #else
+        return std::string (std::strerror (error));
+       #endif
+    };
+
+    // The thread may have stopped by now so this reports what was set rather than reading it back
+    if (status.affinityError != 0)
+        placement::addError (result, "Couldn't set the CPU affinity: " + describeError (status.affinityError));
+    else
+        result.cpus = placement.cpus;
+
+    if (status.schedulingError != 0)
+    {
+        placement::addError (result, "Couldn't set the scheduling policy: " + describeError (status.schedulingError));
+    }
+    else
+    {
+        result.scheduling = placement.scheduling;
+        result.priority = placement.scheduling == ThreadScheduling::unchanged ? 0 : schedulingPriority;
+    }
+
+    return result;
+}
+// BEATCONNECT MODIFICATION END
+
 }} // namespace tracktion_engine
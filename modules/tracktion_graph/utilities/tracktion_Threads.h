@@ -22,4 +22,88 @@ namespace tracktion { inline namespace graph
 */
 bool setThreadPriority (std::thread&, int priority);
 
+// BEATCONNECT MODIFICATION START
+//==============================================================================
+/** How the OS should schedule a thread. */
+enum class ThreadScheduling
+{
+    unchanged,      /**< Leaves the scheduling as it is. */
+    normal,         /**< The OS's default time-sharing scheduling. */
+    fifo,           /**< Real-time first-in first-out scheduling i.e. SCHED_FIFO. */
+    roundRobin      /**< Real-time round-robin scheduling i.e. SCHED_RR. */
+};
+
+/** Describes which CPUs a thread should run on and how it should be scheduled. */
+struct ThreadPlacement
+{
+    std::vector<int> cpus;                                      /**< The CPUs the thread may run on, or empty to leave them as they are. */
+    ThreadScheduling scheduling = ThreadScheduling::unchanged;  /**< How to schedule the thread. */
+    int priority = 0;                                           /**< The OS priority to use for fifo or roundRobin, e.g. 1-99 on Linux. */
+};
+
+/** The placement a thread actually ended up with after calling applyThreadPlacement. */
+struct ThreadPlacementResult
+{
+    std::vector<int> cpus;                                      /**< The CPUs the thread can run on, or empty if this isn't known. */
+    ThreadScheduling scheduling = ThreadScheduling::unchanged;  /**< The scheduling in use, or unchanged if this isn't known. */
+    int priority = 0;                                           /**< The OS priority in use. */
+    std::string error;                                          /**< Describes anything that couldn't be applied, or is empty. */
+};
+
+/** Sets the CPUs a thread can run on and its scheduling policy and priority.
+
+    Real-time scheduling usually needs extra permissions (e.g. an rtprio limit on Linux)
+    and CPU affinity isn't available on every platform, so check the result to see what
+    was actually applied.
+*/
+ThreadPlacementResult applyThreadPlacement (std::thread&, const ThreadPlacement&);
+
+/** Applies a ThreadPlacement to the calling thread. */
+ThreadPlacementResult applyThreadPlacementToCurrentThread (const ThreadPlacement&);
+
+//==============================================================================
+/**
+    A ThreadPlacement converted ahead of time in to the form the OS uses, so it can
+    be applied from a real-time thread without allocating or taking any locks.
+
+    Create this on another thread, then call applyToCurrentThread from the real-time
+    thread and pass the Status it returns back to createResult on another thread to
+    describe what happened.
+*/
+class PreparedThreadPlacement
+{
+public:
+    /** The OS error codes from applying a placement, which are 0 for each part that
+        succeeded or wasn't requested.
+    */
+    struct Status
+    {
+        int affinityError = 0;
+        int schedulingError = 0;
+    };
+
+    /** Creates an empty placement that doesn't change anything. */
+    PreparedThreadPlacement() = default;
+
+    /** Prepares a placement. */
+    explicit PreparedThreadPlacement (const ThreadPlacement&);
+
+    /** Applies the placement to the calling thread.
+        This only makes the system calls to set the affinity and scheduling so can be
+        called from a real-time thread.
+    */
+    Status applyToCurrentThread() const noexcept;
+
+    /** Describes the placement the thread ended up with after applyToCurrentThread
+        returned a Status. This allocates so shouldn't be called from a real-time thread.
+    */
+    ThreadPlacementResult createResult (Status) const;
+
+private:
+    ThreadPlacement placement;
+    alignas (8) unsigned char cpuSet[128] = {};
+    int schedulingPolicy = 0, schedulingPriority = 0;
+};
+// BEATCONNECT MODIFICATION END
+
 }} // namespace tracktion_engine